@@ -0,0 +1,60 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+#include <Eina.h>
+
+#include "Ecore.h"
+#include "ecore_bench.h"
+
+typedef struct _Ecore_Benchmark_Case Ecore_Benchmark_Case;
+struct _Ecore_Benchmark_Case
+{
+   const char *bench_case;
+   void (*build)(Eina_Benchmark *bench);
+};
+
+static const Ecore_Benchmark_Case etc[] = {
+   { "Con", ecore_bench_con },
+   { "Ipc", ecore_bench_ipc },
+   { "Main_Loop", ecore_bench_main_loop },
+   { "Thread", ecore_bench_thread },
+   { "Timer", ecore_bench_timer },
+   { NULL, NULL }
+};
+
+int
+main(int argc, char **argv)
+{
+   Eina_Benchmark *test;
+   unsigned int i;
+
+   if (argc < 2)
+      return -1;
+
+   ecore_init();
+
+   for (i = 0; etc[i].bench_case; ++i)
+     {
+        if (argc == 3 && strcasecmp(etc[i].bench_case, argv[2]))
+          continue;
+
+        test = eina_benchmark_new(etc[i].bench_case, argv[1]);
+        if (!test)
+           continue;
+
+        etc[i].build(test);
+
+        eina_benchmark_run(test);
+
+        eina_benchmark_free(test);
+     }
+
+   ecore_shutdown();
+
+   return 0;
+}
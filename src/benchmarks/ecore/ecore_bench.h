@@ -0,0 +1,12 @@
+#ifndef ECORE_BENCH_H_
+#define ECORE_BENCH_H_
+
+#include <Eina.h>
+
+void ecore_bench_con(Eina_Benchmark *bench);
+void ecore_bench_ipc(Eina_Benchmark *bench);
+void ecore_bench_main_loop(Eina_Benchmark *bench);
+void ecore_bench_thread(Eina_Benchmark *bench);
+void ecore_bench_timer(Eina_Benchmark *bench);
+
+#endif
@@ -0,0 +1,179 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Ecore.h"
+#include "Ecore_Con.h"
+#include "ecore_bench.h"
+
+/* Throughput of a local socket: one side keeps a few chunks of CHUNK bytes
+   in flight, the other counts the bytes of the data events until all of
+   them arrived. Both directions are measured, as the client and the server
+   side of a connection are read by different code. The chunks are either
+   copied by ecore_con_*_send() or queued as they are by
+   ecore_con_*_send_segment(). */
+
+#define CHUNK (256 * 1024)
+#define IN_FLIGHT 8
+
+static Ecore_Con_Server *_bench_conn = NULL;
+static Ecore_Con_Client *_bench_cl = NULL;
+static unsigned char *_bench_chunk = NULL;
+static long long _bench_total = 0;
+static long long _bench_sent = 0;
+static long long _bench_received = 0;
+static Eina_Bool _bench_to_client = EINA_FALSE;
+static Eina_Bool _bench_segment = EINA_FALSE;
+
+static void
+_bench_send_more(void)
+{
+   while ((_bench_sent < _bench_total) &&
+          ((_bench_sent - _bench_received) < (IN_FLIGHT * CHUNK)))
+     {
+        if (_bench_to_client && _bench_segment)
+          ecore_con_client_send_segment(_bench_cl, _bench_chunk, CHUNK,
+                                        NULL, NULL);
+        else if (_bench_to_client)
+          ecore_con_client_send(_bench_cl, _bench_chunk, CHUNK);
+        else if (_bench_segment)
+          ecore_con_server_send_segment(_bench_conn, _bench_chunk, CHUNK,
+                                        NULL, NULL);
+        else
+          ecore_con_server_send(_bench_conn, _bench_chunk, CHUNK);
+        _bench_sent += CHUNK;
+     }
+}
+
+static void
+_bench_received_add(int size)
+{
+   _bench_received += size;
+   if (_bench_received >= _bench_total)
+     ecore_main_loop_quit();
+   else
+     _bench_send_more();
+}
+
+static Eina_Bool
+_bench_client_add(void *data EINA_UNUSED, int type EINA_UNUSED, void *event)
+{
+   Ecore_Con_Event_Client_Add *ev = event;
+
+   _bench_cl = ev->client;
+   _bench_send_more();
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_bench_client_data(void *data EINA_UNUSED, int type EINA_UNUSED, void *event)
+{
+   Ecore_Con_Event_Client_Data *ev = event;
+
+   _bench_received_add(ev->size);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_bench_server_data(void *data EINA_UNUSED, int type EINA_UNUSED, void *event)
+{
+   Ecore_Con_Event_Server_Data *ev = event;
+
+   _bench_received_add(ev->size);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static void
+_bench_con_run(int request, Eina_Bool to_client, Eina_Bool segment)
+{
+   Ecore_Event_Handler *handlers[3];
+   Ecore_Con_Server *svr;
+
+   ecore_con_init();
+
+   _bench_chunk = malloc(CHUNK);
+   if (!_bench_chunk) goto on_error;
+   memset(_bench_chunk, 0x5a, CHUNK);
+
+   _bench_to_client = to_client;
+   _bench_segment = segment;
+   _bench_total = (long long)request * CHUNK;
+   _bench_sent = 0;
+   _bench_received = 0;
+   _bench_cl = NULL;
+
+   handlers[0] = ecore_event_handler_add(ECORE_CON_EVENT_CLIENT_ADD,
+                                         _bench_client_add, NULL);
+   handlers[1] = ecore_event_handler_add(ECORE_CON_EVENT_CLIENT_DATA,
+                                         _bench_client_data, NULL);
+   handlers[2] = ecore_event_handler_add(ECORE_CON_EVENT_SERVER_DATA,
+                                         _bench_server_data, NULL);
+
+   svr = ecore_con_server_add(ECORE_CON_LOCAL_USER, "ecore_bench_con", 0, NULL);
+   if (svr)
+     {
+        _bench_conn = ecore_con_server_connect(ECORE_CON_LOCAL_USER,
+                                               "ecore_bench_con", 0, NULL);
+        if (_bench_conn)
+          {
+             ecore_main_loop_begin();
+             ecore_con_server_del(_bench_conn);
+             _bench_conn = NULL;
+          }
+        ecore_con_server_del(svr);
+     }
+
+   ecore_event_handler_del(handlers[0]);
+   ecore_event_handler_del(handlers[1]);
+   ecore_event_handler_del(handlers[2]);
+
+   free(_bench_chunk);
+   _bench_chunk = NULL;
+
+ on_error:
+   ecore_con_shutdown();
+}
+
+static void
+_bench_con_to_client(int request)
+{
+   _bench_con_run(request, EINA_TRUE, EINA_FALSE);
+}
+
+static void
+_bench_con_to_server(int request)
+{
+   _bench_con_run(request, EINA_FALSE, EINA_FALSE);
+}
+
+static void
+_bench_con_segment_to_client(int request)
+{
+   _bench_con_run(request, EINA_TRUE, EINA_TRUE);
+}
+
+static void
+_bench_con_segment_to_server(int request)
+{
+   _bench_con_run(request, EINA_FALSE, EINA_TRUE);
+}
+
+void
+ecore_bench_con(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "local_to_client",
+                           EINA_BENCHMARK(_bench_con_to_client),
+                           32, 512, 32);
+   eina_benchmark_register(bench, "local_to_server",
+                           EINA_BENCHMARK(_bench_con_to_server),
+                           32, 512, 32);
+   eina_benchmark_register(bench, "local_segment_to_client",
+                           EINA_BENCHMARK(_bench_con_segment_to_client),
+                           32, 512, 32);
+   eina_benchmark_register(bench, "local_segment_to_server",
+                           EINA_BENCHMARK(_bench_con_segment_to_server),
+                           32, 512, 32);
+}
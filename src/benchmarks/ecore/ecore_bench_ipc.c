@@ -0,0 +1,147 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Ecore.h"
+#include "Ecore_Ipc.h"
+#include "ecore_bench.h"
+
+/* Messages sent over a local ipc connection, from the client to the
+   server: a window of messages is kept in flight and the server counts
+   the message events until all of them arrived. Small messages measure
+   the rate at which they are framed and delivered, large ones the
+   bandwidth, as their data is reassembled from many reads. */
+
+#define SMALL_SIZE 64
+#define SMALL_COUNT 1000
+#define SMALL_IN_FLIGHT 1024
+
+#define LARGE_SIZE (1024 * 1024)
+#define LARGE_IN_FLIGHT 4
+
+static Ecore_Ipc_Server *_bench_conn = NULL;
+static unsigned char *_bench_msg = NULL;
+static int _bench_size = 0;
+static int _bench_in_flight = 0;
+static int _bench_total = 0;
+static int _bench_sent = 0;
+static int _bench_received = 0;
+
+static void
+_bench_send_more(void)
+{
+   while ((_bench_sent < _bench_total) &&
+          ((_bench_sent - _bench_received) < _bench_in_flight))
+     {
+        ecore_ipc_server_send(_bench_conn, 1, 2, _bench_sent, 0, 0,
+                              _bench_msg, _bench_size);
+        _bench_sent++;
+     }
+}
+
+static Eina_Bool
+_bench_client_add(void *data EINA_UNUSED, int type EINA_UNUSED, void *event)
+{
+   Ecore_Ipc_Event_Client_Add *ev = event;
+
+   ecore_ipc_client_data_size_max_set(ev->client, -1);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_bench_client_data(void *data EINA_UNUSED, int type EINA_UNUSED, void *event)
+{
+   Ecore_Ipc_Event_Client_Data *ev = event;
+
+   if (ev->size != _bench_size) return ECORE_CALLBACK_RENEW;
+   _bench_received++;
+   if (_bench_received >= _bench_total)
+     ecore_main_loop_quit();
+   else
+     _bench_send_more();
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_bench_server_add(void *data EINA_UNUSED, int type EINA_UNUSED, void *event EINA_UNUSED)
+{
+   _bench_send_more();
+   return ECORE_CALLBACK_RENEW;
+}
+
+static void
+_bench_ipc_run(int count, int size, int in_flight)
+{
+   Ecore_Event_Handler *handlers[3];
+   Ecore_Ipc_Server *svr;
+
+   ecore_ipc_init();
+
+   _bench_msg = malloc(size);
+   if (!_bench_msg) goto on_error;
+   memset(_bench_msg, 0x5a, size);
+
+   _bench_size = size;
+   _bench_in_flight = in_flight;
+   _bench_total = count;
+   _bench_sent = 0;
+   _bench_received = 0;
+
+   handlers[0] = ecore_event_handler_add(ECORE_IPC_EVENT_CLIENT_ADD,
+                                         _bench_client_add, NULL);
+   handlers[1] = ecore_event_handler_add(ECORE_IPC_EVENT_CLIENT_DATA,
+                                         _bench_client_data, NULL);
+   handlers[2] = ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_ADD,
+                                         _bench_server_add, NULL);
+
+   svr = ecore_ipc_server_add(ECORE_IPC_LOCAL_USER, "ecore_bench_ipc", 0, NULL);
+   if (svr)
+     {
+        ecore_ipc_server_data_size_max_set(svr, -1);
+        _bench_conn = ecore_ipc_server_connect(ECORE_IPC_LOCAL_USER,
+                                               "ecore_bench_ipc", 0, NULL);
+        if (_bench_conn)
+          {
+             ecore_main_loop_begin();
+             ecore_ipc_server_del(_bench_conn);
+             _bench_conn = NULL;
+          }
+        ecore_ipc_server_del(svr);
+     }
+
+   ecore_event_handler_del(handlers[0]);
+   ecore_event_handler_del(handlers[1]);
+   ecore_event_handler_del(handlers[2]);
+
+   free(_bench_msg);
+   _bench_msg = NULL;
+
+ on_error:
+   ecore_ipc_shutdown();
+}
+
+static void
+_bench_ipc_small(int request)
+{
+   _bench_ipc_run(request * SMALL_COUNT, SMALL_SIZE, SMALL_IN_FLIGHT);
+}
+
+static void
+_bench_ipc_large(int request)
+{
+   _bench_ipc_run(request, LARGE_SIZE, LARGE_IN_FLIGHT);
+}
+
+void
+ecore_bench_ipc(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "small_messages",
+                           EINA_BENCHMARK(_bench_ipc_small),
+                           10, 200, 10);
+   eina_benchmark_register(bench, "large_messages",
+                           EINA_BENCHMARK(_bench_ipc_large),
+                           32, 512, 32);
+}
@@ -0,0 +1,114 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_RESOURCE_H
+# include <sys/resource.h>
+#endif
+
+#include "Ecore.h"
+#include "ecore_bench.h"
+
+/* Latency of main loop iterations while many fds are watched: a single
+   pipe wakes the loop up, its handler reads the byte and writes the next
+   one, while all the other fds stay idle. With ECORE_MAIN_LOOP_EPOLL set
+   in the environment the epoll backend is measured, otherwise the loop
+   sleeping in select(). */
+
+#define WAKEUPS 100000
+
+static int _bench_pipe[2] = { -1, -1 };
+static int _bench_left = 0;
+
+static Eina_Bool
+_bench_idle_cb(void *data EINA_UNUSED, Ecore_Fd_Handler *fdh EINA_UNUSED)
+{
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_bench_wakeup_cb(void *data EINA_UNUSED, Ecore_Fd_Handler *fdh EINA_UNUSED)
+{
+   char c;
+
+   if (read(_bench_pipe[0], &c, 1) != 1) return ECORE_CALLBACK_RENEW;
+   _bench_left--;
+   if ((_bench_left <= 0) || (write(_bench_pipe[1], &c, 1) != 1))
+     ecore_main_loop_quit();
+   return ECORE_CALLBACK_RENEW;
+}
+
+static void
+_bench_fd_limit_raise(void)
+{
+#ifdef HAVE_SYS_RESOURCE_H
+   struct rlimit rl;
+
+   /* each idle fd is the read end of a pipe, so twice as many are open */
+   if ((getrlimit(RLIMIT_NOFILE, &rl) == 0) && (rl.rlim_cur < rl.rlim_max))
+     {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+     }
+#endif
+}
+
+static void
+_bench_main_loop_idle_fds(int request)
+{
+   Ecore_Fd_Handler **handlers;
+   Ecore_Fd_Handler *wakeup;
+   int *fds;
+   int count, i;
+   char c = 0;
+
+   _bench_fd_limit_raise();
+
+   fds = malloc(request * 2 * sizeof(int));
+   handlers = malloc(request * sizeof(Ecore_Fd_Handler *));
+   if ((!fds) || (!handlers)) goto on_error;
+
+   /* stop at the fd limit, the run is then done with fewer idle fds */
+   for (count = 0; count < request; count++)
+     {
+        if (pipe(fds + (count * 2)) < 0) break;
+        handlers[count] = ecore_main_fd_handler_add(fds[count * 2],
+                                                    ECORE_FD_READ,
+                                                    _bench_idle_cb, NULL,
+                                                    NULL, NULL);
+     }
+
+   if (pipe(_bench_pipe) < 0) goto on_pipes;
+   wakeup = ecore_main_fd_handler_add(_bench_pipe[0], ECORE_FD_READ,
+                                      _bench_wakeup_cb, NULL, NULL, NULL);
+
+   _bench_left = WAKEUPS;
+   if (write(_bench_pipe[1], &c, 1) == 1)
+     ecore_main_loop_begin();
+
+   ecore_main_fd_handler_del(wakeup);
+   close(_bench_pipe[0]);
+   close(_bench_pipe[1]);
+
+ on_pipes:
+   for (i = 0; i < count; i++)
+     {
+        if (handlers[i]) ecore_main_fd_handler_del(handlers[i]);
+        close(fds[i * 2]);
+        close(fds[(i * 2) + 1]);
+     }
+
+ on_error:
+   free(handlers);
+   free(fds);
+}
+
+void
+ecore_bench_main_loop(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "idle_fds",
+                           EINA_BENCHMARK(_bench_main_loop_idle_fds),
+                           1000, 10000, 1000);
+}
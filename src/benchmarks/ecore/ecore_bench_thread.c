@@ -0,0 +1,112 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+
+#include "Ecore.h"
+#include "ecore_bench.h"
+
+/* Measure how many small jobs per second ecore_thread can dispatch when
+   allowed to use 1, 2, 4... workers. Every job does a small fixed amount
+   of work, so a scheduler that scales should see the total time drop as
+   the number of workers grows. */
+
+#define JOB_LOOPS 2000
+
+static int _bench_jobs_left = 0;
+
+static void
+_bench_job(void *data EINA_UNUSED, Ecore_Thread *thread EINA_UNUSED)
+{
+   volatile unsigned int acc = 0;
+   unsigned int i;
+
+   for (i = 0; i < JOB_LOOPS; i++)
+     acc += i * i;
+}
+
+static void
+_bench_job_end(void *data EINA_UNUSED, Ecore_Thread *thread EINA_UNUSED)
+{
+   if (--_bench_jobs_left == 0)
+     ecore_main_loop_quit();
+}
+
+static void
+_bench_thread_run(int request, int workers)
+{
+   int i;
+
+   ecore_thread_max_set(workers);
+
+   _bench_jobs_left = request;
+   for (i = 0; i < request; i++)
+     ecore_thread_run(_bench_job, _bench_job_end, _bench_job_end, NULL);
+
+   ecore_main_loop_begin();
+
+   ecore_thread_max_reset();
+}
+
+static void
+_bench_thread_feedback_run(int request, int workers)
+{
+   int i;
+
+   ecore_thread_max_set(workers);
+
+   _bench_jobs_left = request;
+   for (i = 0; i < request; i++)
+     ecore_thread_feedback_run(_bench_job, NULL, _bench_job_end, _bench_job_end,
+                               NULL, EINA_FALSE);
+
+   ecore_main_loop_begin();
+
+   ecore_thread_max_reset();
+}
+
+#define BENCH_WORKERS(N)                                                \
+  static void                                                           \
+  _bench_thread_run_##N(int request)                                    \
+  {                                                                     \
+     _bench_thread_run(request, N);                                     \
+  }                                                                     \
+  static void                                                           \
+  _bench_thread_feedback_run_##N(int request)                           \
+  {                                                                     \
+     _bench_thread_feedback_run(request, N);                            \
+  }
+
+BENCH_WORKERS(1)
+BENCH_WORKERS(2)
+BENCH_WORKERS(4)
+BENCH_WORKERS(8)
+BENCH_WORKERS(16)
+
+#undef BENCH_WORKERS
+
+void
+ecore_bench_thread(Eina_Benchmark *bench)
+{
+   int cpu = eina_cpu_count();
+
+#define BENCH_REGISTER(N)                                               \
+   if (N == 1 || N <= cpu)                                              \
+     {                                                                  \
+        eina_benchmark_register(bench, "thread_run_" #N,                \
+                                EINA_BENCHMARK(_bench_thread_run_##N),  \
+                                1000, 20000, 1000);                     \
+        eina_benchmark_register(bench, "thread_feedback_run_" #N,       \
+                                EINA_BENCHMARK(_bench_thread_feedback_run_##N), \
+                                1000, 20000, 1000);                     \
+     }
+
+   BENCH_REGISTER(1);
+   BENCH_REGISTER(2);
+   BENCH_REGISTER(4);
+   BENCH_REGISTER(8);
+   BENCH_REGISTER(16);
+
+#undef BENCH_REGISTER
+}
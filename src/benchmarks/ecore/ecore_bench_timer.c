@@ -0,0 +1,130 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Ecore.h"
+#include "ecore_bench.h"
+
+/* Measure the cost of keeping a large number of timers around, the way a
+   daemon with one idle timeout per connection does: adding and deleting
+   them, resetting them on activity and letting them all expire. */
+
+static Ecore_Timer **_bench_timers = NULL;
+static int _bench_timers_left = 0;
+
+static Eina_Bool
+_bench_timer_cb(void *data EINA_UNUSED)
+{
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_bench_timer_fire_cb(void *data EINA_UNUSED)
+{
+   if (--_bench_timers_left == 0)
+     ecore_main_loop_quit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static double
+_bench_timer_in(int i)
+{
+   /* spread timeouts between 30s and 60s, in no particular order */
+   return 30.0 + ((i * 7919) % 30000) / 1000.0;
+}
+
+static Eina_Bool
+_bench_timers_alloc(int request)
+{
+   _bench_timers = calloc(request, sizeof (Ecore_Timer *));
+   return !!_bench_timers;
+}
+
+static void
+_bench_timers_free(int request)
+{
+   int i;
+
+   for (i = 0; i < request; i++)
+     if (_bench_timers[i]) ecore_timer_del(_bench_timers[i]);
+   free(_bench_timers);
+   _bench_timers = NULL;
+}
+
+static void
+_bench_timer_add_del(int request)
+{
+   int i;
+
+   if (!_bench_timers_alloc(request)) return;
+
+   for (i = 0; i < request; i++)
+     _bench_timers[i] = ecore_timer_add(_bench_timer_in(i), _bench_timer_cb, NULL);
+
+   /* delete in an order unrelated to both creation and expiry */
+   for (i = 0; i < request; i++)
+     {
+        int j = (int)(((long long)i * 7907) % request);
+
+        if (!_bench_timers[j]) continue;
+        ecore_timer_del(_bench_timers[j]);
+        _bench_timers[j] = NULL;
+     }
+
+   /* let the main loop collect the deleted timers */
+   ecore_main_loop_iterate();
+
+   _bench_timers_free(request);
+}
+
+static void
+_bench_timer_reset(int request)
+{
+   int i, j;
+
+   if (!_bench_timers_alloc(request)) return;
+
+   for (i = 0; i < request; i++)
+     _bench_timers[i] = ecore_timer_add(_bench_timer_in(i), _bench_timer_cb, NULL);
+   ecore_main_loop_iterate();
+
+   /* every connection sees some activity and pushes its timeout back */
+   for (j = 0; j < 4; j++)
+     {
+        for (i = 0; i < request; i++)
+          ecore_timer_reset(_bench_timers[(i * 7919) % request]);
+        ecore_main_loop_iterate();
+     }
+
+   _bench_timers_free(request);
+   ecore_main_loop_iterate();
+}
+
+static void
+_bench_timer_fire(int request)
+{
+   int i;
+
+   _bench_timers_left = request;
+   for (i = 0; i < request; i++)
+     ecore_timer_add(((i * 7919) % 1000) / 100000.0, _bench_timer_fire_cb, NULL);
+
+   ecore_main_loop_begin();
+}
+
+void
+ecore_bench_timer(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "timer_add_del",
+                           EINA_BENCHMARK(_bench_timer_add_del),
+                           10000, 100001, 10000);
+   eina_benchmark_register(bench, "timer_reset",
+                           EINA_BENCHMARK(_bench_timer_reset),
+                           10000, 100001, 10000);
+   eina_benchmark_register(bench, "timer_fire",
+                           EINA_BENCHMARK(_bench_timer_fire),
+                           10000, 100001, 10000);
+}
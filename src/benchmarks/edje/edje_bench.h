@@ -0,0 +1,8 @@
+#ifndef EDJE_BENCH_H_
+#define EDJE_BENCH_H_
+
+#include <Eina.h>
+
+void edje_bench_signal(Eina_Benchmark *bench);
+
+#endif
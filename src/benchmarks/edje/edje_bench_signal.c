@@ -0,0 +1,129 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "Edje.h"
+#include "edje_bench.h"
+
+/* Emit signals on many objects sharing the same group and the same set of
+   callbacks, the way a list full of widgets does, and let edje dispatch
+   them to the programs and callbacks whose patterns match. */
+
+#define EDJE_BENCH_OBJECTS 100
+
+static const char *_bench_signals[] = {
+  "mouse,in", "mouse,clicked,1", "mouse,move", "elm,state,text,visible",
+  "elm,action,focus", "elm,state,icon,hidden", "drag,start",
+  "elm,state,selected,set", "elm,action,scroll,x", "elm,state,disabled",
+  "elm,action,press", "elm,state,unknown,signal", "mouse,out"
+};
+
+static const char *_bench_sources[] = {
+  "elm", "elm", "", "elm", "elm", "elm", "elm.dragable.vbar", "elm", "elm",
+  "elm", "elm", "elm", "elm"
+};
+
+static int _bench_calls = 0;
+
+static void
+_bench_signal_cb(void *data EINA_UNUSED, Evas_Object *obj EINA_UNUSED,
+                 const char *emission EINA_UNUSED,
+                 const char *source EINA_UNUSED)
+{
+   _bench_calls++;
+}
+
+static Evas *
+_setup_evas(void)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = malloc(sizeof (char) * 64 * 64 * 4);
+   einfo->info.dest_buffer_row_bytes = 64 * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, 64, 64);
+   evas_output_viewport_set(evas, 0, 0, 64, 64);
+
+   return evas;
+}
+
+static void
+_teardown_evas(Evas *evas)
+{
+   Evas_Engine_Info_Buffer *einfo;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   free(einfo->info.dest_buffer);
+
+   evas_free(evas);
+}
+
+static void
+_bench_signal_emit(int request)
+{
+   Evas_Object *objs[EDJE_BENCH_OBJECTS];
+   Evas *evas;
+   unsigned int n;
+   int i;
+
+   evas = _setup_evas();
+
+   for (i = 0; i < EDJE_BENCH_OBJECTS; i++)
+     {
+        objs[i] = edje_object_add(evas);
+        if (!edje_object_file_set(objs[i],
+                                  EDJE_BENCH_BUILD_DIR "/edje_bench_signal.edj",
+                                  "signal"))
+          {
+             fprintf(stderr, "edje_bench_signal.edj not found, run make benchmark\n");
+             goto on_error;
+          }
+        evas_object_resize(objs[i], 64, 64);
+
+        edje_object_signal_callback_add(objs[i], "mouse,*", "*",
+                                        _bench_signal_cb, NULL);
+        edje_object_signal_callback_add(objs[i], "elm,state,*", "elm",
+                                        _bench_signal_cb, NULL);
+        edje_object_signal_callback_add(objs[i], "*,action,[a-f]*", "*",
+                                        _bench_signal_cb, NULL);
+        edje_object_signal_callback_add(objs[i], "drag,?*", "elm.dragable.*",
+                                        _bench_signal_cb, NULL);
+     }
+   edje_message_signal_process();
+
+   n = sizeof (_bench_signals) / sizeof (_bench_signals[0]);
+   for (i = 0; i < request; i++)
+     {
+        edje_object_signal_emit(objs[i % EDJE_BENCH_OBJECTS],
+                                _bench_signals[i % n], _bench_sources[i % n]);
+        /* one batch per frame */
+        if ((i % 1000) == 999) edje_message_signal_process();
+     }
+   edje_message_signal_process();
+
+ on_error:
+   /* takes the edje objects with it */
+   _teardown_evas(evas);
+}
+
+void
+edje_bench_signal(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "emit",
+                           EINA_BENCHMARK(_bench_signal_emit),
+                           10000, 100000, 10000);
+}
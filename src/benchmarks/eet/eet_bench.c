@@ -0,0 +1,56 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+#include <Eina.h>
+
+#include "Eet.h"
+#include "eet_bench.h"
+
+typedef struct _Eet_Benchmark_Case Eet_Benchmark_Case;
+struct _Eet_Benchmark_Case
+{
+   const char *bench_case;
+   void (*build)(Eina_Benchmark *bench);
+};
+
+static const Eet_Benchmark_Case etc[] = {
+   { "Write", eet_bench_write },
+   { NULL, NULL }
+};
+
+int
+main(int argc, char **argv)
+{
+   Eina_Benchmark *test;
+   unsigned int i;
+
+   if (argc < 2)
+      return -1;
+
+   eet_init();
+
+   for (i = 0; etc[i].bench_case; ++i)
+     {
+        if (argc == 3 && strcasecmp(etc[i].bench_case, argv[2]))
+          continue;
+
+        test = eina_benchmark_new(etc[i].bench_case, argv[1]);
+        if (!test)
+           continue;
+
+        etc[i].build(test);
+
+        eina_benchmark_run(test);
+
+        eina_benchmark_free(test);
+     }
+
+   eet_shutdown();
+
+   return 0;
+}
@@ -0,0 +1,8 @@
+#ifndef EET_BENCH_H_
+#define EET_BENCH_H_
+
+#include <Eina.h>
+
+void eet_bench_write(Eina_Benchmark *bench);
+
+#endif
@@ -0,0 +1,111 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Eet.h"
+#include "eet_bench.h"
+
+/* Measure the time needed to write a file made of many compressed
+   entries, like an edje theme or an image cache, from eet_open() to the
+   end of eet_close(). */
+
+#define EET_BENCH_ENTRY_SIZE 4096
+
+static char *
+_bench_entry_new(void)
+{
+   char *data;
+   int i;
+
+   data = malloc(EET_BENCH_ENTRY_SIZE);
+   if (!data) return NULL;
+
+   /* something that compresses, but not for free */
+   for (i = 0; i < EET_BENCH_ENTRY_SIZE; i++)
+     data[i] = "abcdefgh"[(i * 7 + (i >> 5)) & 7] + ((i * 2654435761U) >> 30);
+
+   return data;
+}
+
+static void
+_bench_write(int request, int comp, Eina_Bool parallel)
+{
+   char file[] = "/tmp/eet_bench_XXXXXX";
+   char name[64];
+   Eet_File *ef;
+   char *data;
+   int fd;
+   int i;
+
+   data = _bench_entry_new();
+   if (!data) return;
+
+   fd = mkstemp(file);
+   if (fd < 0) goto on_error;
+   close(fd);
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   if (!ef) goto on_error;
+
+   eet_parallel_compression_set(ef, parallel);
+
+   for (i = 0; i < request; i++)
+     {
+        snprintf(name, sizeof (name), "entry/%i", i);
+        /* keep every entry different */
+        memcpy(data, &i, sizeof (i));
+        eet_write(ef, name, data, EET_BENCH_ENTRY_SIZE, comp);
+     }
+
+   eet_close(ef);
+
+ on_error:
+   unlink(file);
+   free(data);
+}
+
+static void
+_bench_write_zlib(int request)
+{
+   _bench_write(request, EET_COMPRESSION_DEFAULT, EINA_FALSE);
+}
+
+static void
+_bench_write_zlib_parallel(int request)
+{
+   _bench_write(request, EET_COMPRESSION_DEFAULT, EINA_TRUE);
+}
+
+static void
+_bench_write_lz4hc(int request)
+{
+   _bench_write(request, EET_COMPRESSION_VERYFAST, EINA_FALSE);
+}
+
+static void
+_bench_write_lz4hc_parallel(int request)
+{
+   _bench_write(request, EET_COMPRESSION_VERYFAST, EINA_TRUE);
+}
+
+void
+eet_bench_write(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "zlib",
+                           EINA_BENCHMARK(_bench_write_zlib),
+                           2000, 12000, 2000);
+   eina_benchmark_register(bench, "zlib (parallel)",
+                           EINA_BENCHMARK(_bench_write_zlib_parallel),
+                           2000, 12000, 2000);
+   eina_benchmark_register(bench, "lz4hc",
+                           EINA_BENCHMARK(_bench_write_lz4hc),
+                           2000, 12000, 2000);
+   eina_benchmark_register(bench, "lz4hc (parallel)",
+                           EINA_BENCHMARK(_bench_write_lz4hc_parallel),
+                           2000, 12000, 2000);
+}
@@ -273,6 +273,89 @@ eina_bench_lookup_superfast(int request)
    eina_hash_free(hash);
 }
 
+static void
+eina_bench_lookup_flat(int request)
+{
+   Eina_Hash *hash = NULL;
+   int *tmp_val;
+   unsigned int i;
+   unsigned int j;
+
+   hash = eina_hash_flat_string_new(free);
+
+   for (i = 0; i < (unsigned int)request; ++i)
+     {
+        char tmp_key[10];
+
+        tmp_val = malloc(sizeof (int));
+
+        if (!tmp_val)
+           continue;
+
+        eina_convert_itoa(i, tmp_key);
+        *tmp_val = i;
+
+        eina_hash_add(hash, tmp_key, tmp_val);
+     }
+
+   srand(time(NULL));
+
+   for (j = 0; j < 200; ++j)
+      for (i = 0; i < (unsigned int)request; ++i)
+        {
+           char tmp_key[10];
+
+           eina_convert_itoa(rand() % request, tmp_key);
+           tmp_val = eina_hash_find(hash, tmp_key);
+        }
+
+   eina_hash_free(hash);
+}
+
+static void
+eina_bench_lookup_int32(Eina_Hash *hash, int request)
+{
+   int *tmp_val;
+   int i;
+   unsigned int j;
+
+   for (i = 0; i < request; ++i)
+     {
+        tmp_val = malloc(sizeof (int));
+
+        if (!tmp_val)
+           continue;
+
+        *tmp_val = i;
+
+        eina_hash_add(hash, &i, tmp_val);
+     }
+
+   srand(time(NULL));
+
+   for (j = 0; j < 200; ++j)
+      for (i = 0; i < request; ++i)
+        {
+           int key = rand() % request;
+
+           tmp_val = eina_hash_find(hash, &key);
+        }
+
+   eina_hash_free(hash);
+}
+
+static void
+eina_bench_lookup_int32_rbtree(int request)
+{
+   eina_bench_lookup_int32(eina_hash_int32_new(free), request);
+}
+
+static void
+eina_bench_lookup_int32_flat(int request)
+{
+   eina_bench_lookup_int32(eina_hash_flat_int32_new(free), request);
+}
+
 static void
 eina_bench_lookup_djb2(int request)
 {
@@ -515,6 +598,15 @@ void eina_bench_hash(Eina_Benchmark *bench)
    eina_benchmark_register(bench, "superfast-lookup",
                            EINA_BENCHMARK(
                               eina_bench_lookup_superfast),   10, 10000, 10);
+   eina_benchmark_register(bench, "flat-lookup",
+                           EINA_BENCHMARK(
+                              eina_bench_lookup_flat),        10, 10000, 10);
+   eina_benchmark_register(bench, "int32-lookup",
+                           EINA_BENCHMARK(
+                              eina_bench_lookup_int32_rbtree), 10, 10000, 10);
+   eina_benchmark_register(bench, "flat-int32-lookup",
+                           EINA_BENCHMARK(
+                              eina_bench_lookup_int32_flat),  10, 10000, 10);
    eina_benchmark_register(bench, "djb2-lookup",
                            EINA_BENCHMARK(
                               eina_bench_lookup_djb2),        10, 10000, 10);
@@ -35,6 +35,9 @@
 #include "eina_bench.h"
 #include "eina_convert.h"
 #include "eina_main.h"
+#include "eina_thread.h"
+
+#define EINA_BENCH_STRINGSHARE_THREADS 4
 
 static void
 eina_bench_stringshare_job(int request)
@@ -69,6 +72,80 @@ eina_bench_stringshare_job(int request)
    eina_shutdown();
 }
 
+typedef struct _Eina_Bench_Stringshare_Thread Eina_Bench_Stringshare_Thread;
+struct _Eina_Bench_Stringshare_Thread
+{
+   Eina_Thread thread;
+   unsigned int seed;
+   int request;
+};
+
+static void *
+_eina_bench_stringshare_thread(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Eina_Bench_Stringshare_Thread *st = data;
+   const char *tmp;
+   unsigned int j;
+   int i;
+
+   /* every thread looks up strings that are already shared, like loaders
+      decoding the same edje/eet keys do */
+   for (j = 0; j < 200 / EINA_BENCH_STRINGSHARE_THREADS; ++j)
+      for (i = 0; i < st->request; ++i)
+        {
+           char build[64] = "string_";
+
+           eina_convert_xtoa(rand_r(&st->seed) % st->request, build + 7);
+           tmp = eina_stringshare_add(build);
+           eina_stringshare_del(tmp);
+        }
+
+   return NULL;
+}
+
+static void
+eina_bench_stringshare_threads_job(int request)
+{
+   Eina_Bench_Stringshare_Thread threads[EINA_BENCH_STRINGSHARE_THREADS];
+   const char **shared;
+   int i;
+
+   eina_init();
+   eina_threads_init();
+
+   shared = malloc(sizeof (const char *) * request);
+   if (!shared) goto on_error;
+
+   for (i = 0; i < request; ++i)
+     {
+        char build[64] = "string_";
+
+        eina_convert_xtoa(i, build + 7);
+        shared[i] = eina_stringshare_add(build);
+     }
+
+   for (i = 0; i < EINA_BENCH_STRINGSHARE_THREADS; ++i)
+     {
+        threads[i].seed = time(NULL) + i;
+        threads[i].request = request;
+        if (!eina_thread_create(&threads[i].thread, EINA_THREAD_NORMAL, -1,
+                                _eina_bench_stringshare_thread, threads + i))
+          threads[i].request = 0;
+     }
+
+   for (i = 0; i < EINA_BENCH_STRINGSHARE_THREADS; ++i)
+     if (threads[i].request)
+       eina_thread_join(threads[i].thread);
+
+   for (i = 0; i < request; ++i)
+     eina_stringshare_del(shared[i]);
+   free(shared);
+
+ on_error:
+   eina_threads_shutdown();
+   eina_shutdown();
+}
+
 #ifdef EINA_BENCH_HAVE_GLIB
 static void
 eina_bench_stringchunk_job(int request)
@@ -171,6 +248,9 @@ void eina_bench_stringshare(Eina_Benchmark *bench)
    eina_benchmark_register(bench, "stringshare",
                            EINA_BENCHMARK(
                               eina_bench_stringshare_job), 100, 20100, 500);
+   eina_benchmark_register(bench, "stringshare (threads)",
+                           EINA_BENCHMARK(
+                              eina_bench_stringshare_threads_job), 100, 20100, 500);
 #ifdef EINA_BENCH_HAVE_GLIB
    eina_benchmark_register(bench, "stringchunk (glib)",
                            EINA_BENCHMARK(
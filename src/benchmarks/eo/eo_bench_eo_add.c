@@ -2,6 +2,10 @@
 # include <config.h>
 #endif
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
 #include "Eo.h"
 #include "eo_bench.h"
 #include "class_simple.h"
@@ -38,10 +42,78 @@ bench_eo_add_jump_by_2(int request)
    free(objs);
 }
 
+/* Like the items of a scrolled list: the oldest object goes away on one
+   side while a new one comes in on the other. */
+#define EO_BENCH_SCROLL_WINDOW 1000
+
+static void
+bench_eo_add_scroll(int request)
+{
+   Eo *objs[EO_BENCH_SCROLL_WINDOW];
+   int i;
+
+   for (i = 0 ; i < EO_BENCH_SCROLL_WINDOW ; i++)
+      objs[i] = eo_add(SIMPLE_CLASS, NULL);
+
+   for (i = 0 ; i < request ; i++)
+     {
+        eo_unref(objs[i % EO_BENCH_SCROLL_WINDOW]);
+        objs[i % EO_BENCH_SCROLL_WINDOW] = eo_add(SIMPLE_CLASS, NULL);
+     }
+
+   for (i = 0 ; i < EO_BENCH_SCROLL_WINDOW ; i++)
+      eo_unref(objs[i]);
+}
+
+static long
+_rss_get(void)
+{
+#ifdef __linux__
+   long size, rss = 0;
+   FILE *f;
+
+   f = fopen("/proc/self/statm", "r");
+   if (!f) return 0;
+   if (fscanf(f, "%ld %ld", &size, &rss) != 2) rss = 0;
+   fclose(f);
+
+   return rss * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+   return 0;
+#endif
+}
+
+/* Resident memory with many objects alive and once they are all gone,
+   printed as the benchmark only keeps the times. */
+static void
+bench_eo_add_rss(int request)
+{
+   long before, alive, after;
+   int i;
+   Eo **objs = calloc(request, sizeof(Eo *));
+
+   before = _rss_get();
+   for (i = 0 ; i < request ; i++)
+      objs[i] = eo_add(SIMPLE_CLASS, NULL);
+   alive = _rss_get();
+
+   for (i = 0 ; i < request ; i++)
+      eo_unref(objs[i]);
+   after = _rss_get();
+   free(objs);
+
+   printf("eo_add_rss %i objects: %+ld kB alive, %+ld kB after deletion\n",
+          request, alive - before, after - before);
+}
+
 void eo_bench_eo_add(Eina_Benchmark *bench)
 {
    eina_benchmark_register(bench, "eo_add_linear",
          EINA_BENCHMARK(bench_eo_add_linear), 1000, 50000, 100);
    eina_benchmark_register(bench, "eo_add_jump_by_2",
          EINA_BENCHMARK(bench_eo_add_jump_by_2), 1000, 50000, 100);
+   eina_benchmark_register(bench, "eo_add_scroll",
+         EINA_BENCHMARK(bench_eo_add_scroll), 10000, 500000, 10000);
+   eina_benchmark_register(bench, "eo_add_rss",
+         EINA_BENCHMARK(bench_eo_add_rss), 100000, 500000, 100000);
 }
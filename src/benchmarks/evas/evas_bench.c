@@ -21,6 +21,12 @@ struct _Evas_Benchmark_Case
 static const Evas_Benchmark_Case etc[] = {
    { "Loader", evas_bench_loader, EINA_TRUE },
    { "Saver", evas_bench_saver, EINA_TRUE },
+   { "Render", evas_bench_render, EINA_TRUE },
+   { "Events", evas_bench_events, EINA_TRUE },
+   { "Textblock", evas_bench_textblock, EINA_TRUE },
+   { "Text", evas_bench_text, EINA_TRUE },
+   { "Ops", evas_bench_ops, EINA_TRUE },
+   { "Scale", evas_bench_scale, EINA_TRUE },
    { NULL, NULL, EINA_FALSE }
 };
 
@@ -5,6 +5,12 @@
 
 void evas_bench_loader(Eina_Benchmark *bench);
 void evas_bench_saver(Eina_Benchmark *bench);
+void evas_bench_render(Eina_Benchmark *bench);
+void evas_bench_events(Eina_Benchmark *bench);
+void evas_bench_textblock(Eina_Benchmark *bench);
+void evas_bench_text(Eina_Benchmark *bench);
+void evas_bench_ops(Eina_Benchmark *bench);
+void evas_bench_scale(Eina_Benchmark *bench);
 
 #endif
 
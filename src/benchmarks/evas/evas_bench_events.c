@@ -0,0 +1,140 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Feed mouse moves over a canvas full of objects, like a big list or an
+   icon view, to measure how long evas takes to find the objects under the
+   pointer. The objects are either all in the same layer or spread over
+   smart objects. */
+
+#define W 1920
+#define H 1080
+
+#define EVAS_BENCH_OBJECTS 20000
+#define EVAS_BENCH_CONTAINERS 200
+
+EVAS_SMART_SUBCLASS_NEW("bench_container", _bench_container, Evas_Smart_Class,
+                        Evas_Smart_Class, evas_object_smart_clipped_class_get,
+                        NULL);
+
+static void
+_bench_container_smart_set_user(Evas_Smart_Class *sc EINA_UNUSED)
+{
+}
+
+static Evas *
+_setup_evas(void)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = malloc(sizeof (char) * W * H * 4);
+   einfo->info.dest_buffer_row_bytes = W * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, W, H);
+   evas_output_viewport_set(evas, 0, 0, W, H);
+
+   return evas;
+}
+
+static void
+_teardown_evas(Evas *evas)
+{
+   Evas_Engine_Info_Buffer *einfo;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   free(einfo->info.dest_buffer);
+
+   evas_free(evas);
+}
+
+static Evas_Object *
+_rect_add(Evas *e, int i)
+{
+   Evas_Object *o;
+
+   /* 24x24 cells, with some larger objects on top of them */
+   o = evas_object_rectangle_add(e);
+   evas_object_color_set(o, 128, 0, 0, 128);
+   evas_object_move(o, (i * 24) % W, ((i * 24) / W * 24) % H);
+   if (!(i % 100))
+     evas_object_resize(o, 200, 100);
+   else
+     evas_object_resize(o, 20, 20);
+   evas_object_show(o);
+
+   return o;
+}
+
+static void
+_bench_mouse_move(Evas *e, int request)
+{
+   int i;
+
+   /* the clip of the objects is only known after a render */
+   evas_render(e);
+
+   evas_event_feed_mouse_in(e, 0, NULL);
+   for (i = 0; i < request; i++)
+     evas_event_feed_mouse_move(e, (i * 7) % W, (i * 13) % H, i, NULL);
+}
+
+static void
+evas_bench_events_flat(int request)
+{
+   Evas *e = _setup_evas();
+   int i;
+
+   for (i = 0; i < EVAS_BENCH_OBJECTS; i++)
+     _rect_add(e, i);
+
+   _bench_mouse_move(e, request);
+
+   _teardown_evas(e);
+}
+
+static void
+evas_bench_events_smart(int request)
+{
+   Evas *e = _setup_evas();
+   Evas_Object *container = NULL, *o;
+   int i;
+
+   for (i = 0; i < EVAS_BENCH_OBJECTS; i++)
+     {
+        Evas_Coord x, y;
+
+        o = _rect_add(e, i);
+        if (!(i % (EVAS_BENCH_OBJECTS / EVAS_BENCH_CONTAINERS)))
+          {
+             /* a container starts where its first object is */
+             evas_object_geometry_get(o, &x, &y, NULL, NULL);
+             container = evas_object_smart_add(e, _bench_container_smart_class_new());
+             evas_object_move(container, x, y);
+             evas_object_show(container);
+          }
+        evas_object_smart_member_add(o, container);
+     }
+
+   _bench_mouse_move(e, request);
+
+   _teardown_evas(e);
+}
+
+void evas_bench_events(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "mouse-move", EINA_BENCHMARK(evas_bench_events_flat), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "mouse-move-smart", EINA_BENCHMARK(evas_bench_events_smart), 1000, 10000, 1000);
+}
@@ -0,0 +1,248 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include "evas_common_private.h"
+#include "evas_bench.h"
+
+/* Run the span functions the software engine draws with, for each of the
+   variants of a render op and a kind of source, e.g for pixels with alpha,
+   without it or with sparse alpha, blended on a destination with or
+   without alpha. Each variant goes through request spans of W pixels. The
+   functions are those the rendering would pick, run with
+   EVAS_CPU_NO_AVX2=1, EVAS_CPU_NO_SSE3=1 or EVAS_CPU_NO_MMX=1 to compare
+   the SIMD and C code paths. */
+
+#define W 512
+#define ROWS 64
+
+typedef enum
+{
+   EVAS_BENCH_PIXEL,
+   EVAS_BENCH_COLOR,
+   EVAS_BENCH_PIXEL_COLOR,
+   EVAS_BENCH_PIXEL_MASK,
+   EVAS_BENCH_MASK_COLOR
+} Evas_Bench_Source;
+
+static DATA32 _src[SP_LAST][ROWS * W];
+static DATA32 _dst[DP_LAST][ROWS * W];
+static DATA8 _mask[ROWS * W];
+
+/* A color for each of the color flags, premultiplied */
+static const DATA32 _colors[SC_LAST] = {
+   0xffffffff, 0xa0603018, 0xff804020, 0xa0a0a0a0
+};
+
+static DATA32
+_pixel(int a, int x, int y)
+{
+   return (a << 24) | (((a * x / W) & 0xff) << 16) |
+     (((a * y / ROWS) & 0xff) << 8) | (a / 2);
+}
+
+static void
+_buffers_init(void)
+{
+   static Eina_Bool done = EINA_FALSE;
+   int x, y;
+
+   if (done) return;
+   done = EINA_TRUE;
+
+   evas_common_cpu_init();
+   evas_common_blend_init();
+
+   for (y = 0; y < ROWS; y++)
+     for (x = 0; x < W; x++)
+       {
+          int i = (y * W) + x;
+          int a = (x + (y * 7)) & 0xff;
+          /* Mostly fully transparent or opaque */
+          int as = (x & 0xf) ? ((x & 0x10) ? 0xff : 0) : a;
+
+          _src[SP][i] = _pixel(a, x, y);
+          _src[SP_AN][i] = _pixel(0xff, x, y);
+          _src[SP_AS][i] = _pixel(as, x, y);
+          _dst[DP][i] = _pixel(0xff - a, W - 1 - x, y);
+          _dst[DP_AN][i] = _pixel(0xff, W - 1 - x, y);
+          _mask[i] = as ^ (y & 0x1f);
+       }
+}
+
+static Eina_Bool
+_source_match(Evas_Bench_Source source, int s, int m, int c)
+{
+   switch (source)
+     {
+      case EVAS_BENCH_PIXEL:
+        return (s != SP_N) && (m == SM_N) && (c == SC_N);
+      case EVAS_BENCH_COLOR:
+        return (s == SP_N) && (m == SM_N) && (c != SC_N);
+      case EVAS_BENCH_PIXEL_COLOR:
+        return (s != SP_N) && (m == SM_N) && (c != SC_N);
+      case EVAS_BENCH_PIXEL_MASK:
+        return (s != SP_N) && (m != SM_N) && (c == SC_N);
+      case EVAS_BENCH_MASK_COLOR:
+        return (s == SP_N) && (m != SM_N);
+     }
+   return EINA_FALSE;
+}
+
+/* The function the compositors pick, the columns of the cpus that aren't
+   there or are disabled are empty. */
+static RGBA_Gfx_Func
+_span_func_get(int op, int s, int m, int c, int d)
+{
+   static const int cpus[] = { CPU_AVX2, CPU_SSE3, CPU_MMX, CPU_NEON, CPU_C };
+   RGBA_Gfx_Func func;
+   unsigned int i;
+
+   for (i = 0; i < sizeof(cpus) / sizeof(cpus[0]); i++)
+     {
+        func = evas_common_gfx_func_composite_span_cpu_get(op, s, m, c, d,
+                                                           cpus[i]);
+        if (func) return func;
+     }
+   return NULL;
+}
+
+static void
+_bench_op_spans(int request, int op, Evas_Bench_Source source)
+{
+   int s, m, c, d, i;
+
+   _buffers_init();
+
+   for (s = 0; s < SP_LAST; s++)
+     for (m = 0; m < SM_LAST; m++)
+       for (c = 0; c < SC_LAST; c++)
+         for (d = 0; d < DP_LAST; d++)
+           {
+              RGBA_Gfx_Func func;
+
+              if (!_source_match(source, s, m, c)) continue;
+              func = _span_func_get(op, s, m, c, d);
+              if (!func) continue;
+
+              for (i = 0; i < request; i++)
+                {
+                   int row = (i % ROWS) * W;
+
+                   func((s != SP_N) ? _src[s] + row : NULL,
+                        (m != SM_N) ? _mask + row : NULL,
+                        _colors[c], _dst[d] + row, W);
+                }
+           }
+}
+
+static void
+evas_bench_op_blend_pixel(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_BLEND, EVAS_BENCH_PIXEL);
+}
+
+static void
+evas_bench_op_blend_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_BLEND, EVAS_BENCH_COLOR);
+}
+
+static void
+evas_bench_op_blend_pixel_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_BLEND, EVAS_BENCH_PIXEL_COLOR);
+}
+
+static void
+evas_bench_op_blend_pixel_mask(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_BLEND, EVAS_BENCH_PIXEL_MASK);
+}
+
+static void
+evas_bench_op_blend_mask_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_BLEND, EVAS_BENCH_MASK_COLOR);
+}
+
+static void
+evas_bench_op_copy_pixel(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_COPY, EVAS_BENCH_PIXEL);
+}
+
+static void
+evas_bench_op_copy_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_COPY, EVAS_BENCH_COLOR);
+}
+
+static void
+evas_bench_op_copy_pixel_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_COPY, EVAS_BENCH_PIXEL_COLOR);
+}
+
+static void
+evas_bench_op_copy_pixel_mask(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_COPY, EVAS_BENCH_PIXEL_MASK);
+}
+
+static void
+evas_bench_op_copy_mask_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_COPY, EVAS_BENCH_MASK_COLOR);
+}
+
+static void
+evas_bench_op_mul_pixel(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_MUL, EVAS_BENCH_PIXEL);
+}
+
+static void
+evas_bench_op_mul_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_MUL, EVAS_BENCH_COLOR);
+}
+
+static void
+evas_bench_op_mul_pixel_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_MUL, EVAS_BENCH_PIXEL_COLOR);
+}
+
+static void
+evas_bench_op_mul_pixel_mask(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_MUL, EVAS_BENCH_PIXEL_MASK);
+}
+
+static void
+evas_bench_op_mul_mask_color(int request)
+{
+   _bench_op_spans(request, _EVAS_RENDER_MUL, EVAS_BENCH_MASK_COLOR);
+}
+
+void evas_bench_ops(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "op-blend-pixel", EINA_BENCHMARK(evas_bench_op_blend_pixel), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-blend-color", EINA_BENCHMARK(evas_bench_op_blend_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-blend-pixel-color", EINA_BENCHMARK(evas_bench_op_blend_pixel_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-blend-pixel-mask", EINA_BENCHMARK(evas_bench_op_blend_pixel_mask), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-blend-mask-color", EINA_BENCHMARK(evas_bench_op_blend_mask_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-copy-pixel", EINA_BENCHMARK(evas_bench_op_copy_pixel), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-copy-color", EINA_BENCHMARK(evas_bench_op_copy_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-copy-pixel-color", EINA_BENCHMARK(evas_bench_op_copy_pixel_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-copy-pixel-mask", EINA_BENCHMARK(evas_bench_op_copy_pixel_mask), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-copy-mask-color", EINA_BENCHMARK(evas_bench_op_copy_mask_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-mul-pixel", EINA_BENCHMARK(evas_bench_op_mul_pixel), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-mul-color", EINA_BENCHMARK(evas_bench_op_mul_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-mul-pixel-color", EINA_BENCHMARK(evas_bench_op_mul_pixel_color), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-mul-pixel-mask", EINA_BENCHMARK(evas_bench_op_mul_pixel_mask), 1000, 10000, 1000);
+   eina_benchmark_register(bench, "op-mul-mask-color", EINA_BENCHMARK(evas_bench_op_mul_mask_color), 1000, 10000, 1000);
+}
@@ -0,0 +1,118 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Full redraws of a 4K canvas through the asynchronous software renderer.
+   The number of threads sharing the draw commands is taken from the
+   EVAS_RENDER_THREADS environment variable, run this benchmark with
+   different values to see how rendering scales with cores. */
+
+#define W 3840
+#define H 2160
+
+static Evas *
+_setup_evas(void)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = malloc(sizeof (char) * W * H * 4);
+   einfo->info.dest_buffer_row_bytes = W * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, W, H);
+   evas_output_viewport_set(evas, 0, 0, W, H);
+
+   return evas;
+}
+
+static void
+_teardown_evas(Evas *evas)
+{
+   Evas_Engine_Info_Buffer *einfo;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   free(einfo->info.dest_buffer);
+
+   evas_free(evas);
+}
+
+static Evas_Object *
+_image_add(Evas *e, int w, int h)
+{
+   Evas_Object *o;
+   unsigned int *data;
+   int x, y;
+
+   o = evas_object_image_filled_add(e);
+   evas_object_image_size_set(o, w, h);
+   evas_object_image_alpha_set(o, EINA_TRUE);
+
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   for (y = 0; y < h; y++)
+     for (x = 0; x < w; x++)
+       data[(y * w) + x] = ((x ^ y) & 0x20) ? 0x80402010 : 0xff204080;
+   evas_object_image_data_set(o, data);
+   evas_object_image_data_update_add(o, 0, 0, w, h);
+
+   return o;
+}
+
+static void
+evas_bench_render_4k(int request)
+{
+   Evas *e = _setup_evas();
+   Evas_Object *o;
+   int i;
+
+   o = evas_object_rectangle_add(e);
+   evas_object_color_set(o, 255, 255, 255, 255);
+   evas_object_resize(o, W, H);
+   evas_object_show(o);
+
+   /* a grid of alpha images scaled up from small sources */
+   for (i = 0; i < 64; i++)
+     {
+        o = _image_add(e, 128, 128);
+        evas_object_image_smooth_scale_set(o, i & 1);
+        evas_object_move(o, (i % 8) * (W / 8), (i / 8) * (H / 8));
+        evas_object_resize(o, W / 6, H / 6);
+        evas_object_show(o);
+     }
+
+   /* and translucent rectangles on top of everything */
+   for (i = 0; i < 64; i++)
+     {
+        o = evas_object_rectangle_add(e);
+        evas_object_color_set(o, 32, 0, 0, 32);
+        evas_object_move(o, (i * 37) % W, (i * 53) % H);
+        evas_object_resize(o, W / 3, H / 3);
+        evas_object_show(o);
+     }
+
+   for (i = 0; i < request; i++)
+     {
+        evas_damage_rectangle_add(e, 0, 0, W, H);
+        if (!evas_render_async(e)) break;
+        evas_sync(e);
+        evas_async_events_process();
+     }
+
+   _teardown_evas(e);
+}
+
+void evas_bench_render(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "render-4k", EINA_BENCHMARK(evas_bench_render_4k), 1, 21, 4);
+}
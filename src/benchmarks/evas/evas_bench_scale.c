@@ -0,0 +1,141 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Smooth scaling of a large photo to a full HD canvas, at a few common
+   ratios. The size changes by a pixel every frame, as when zooming, so
+   the scale cache never serves the frame. The number of threads used by
+   the scaler is taken from the EVAS_SCALE_THREADS environment variable,
+   engines can also set it in their info's scale_threads. */
+
+#define W 1920
+#define H 1080
+
+#define SRC_W 4000
+#define SRC_H 3000
+
+static Evas *
+_setup_evas(void)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = malloc(sizeof (char) * W * H * 4);
+   einfo->info.dest_buffer_row_bytes = W * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, W, H);
+   evas_output_viewport_set(evas, 0, 0, W, H);
+
+   return evas;
+}
+
+static void
+_teardown_evas(Evas *evas)
+{
+   Evas_Engine_Info_Buffer *einfo;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   free(einfo->info.dest_buffer);
+
+   evas_free(evas);
+}
+
+static Evas_Object *
+_photo_add(Evas *e)
+{
+   Evas_Object *o;
+   unsigned int *data;
+   int x, y;
+
+   o = evas_object_image_filled_add(e);
+   evas_object_image_size_set(o, SRC_W, SRC_H);
+   evas_object_image_smooth_scale_set(o, EINA_TRUE);
+
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   for (y = 0; y < SRC_H; y++)
+     for (x = 0; x < SRC_W; x++)
+       data[(y * SRC_W) + x] = 0xff000000 | ((x * 255 / SRC_W) << 16) |
+         ((y * 255 / SRC_H) << 8) | (((x ^ y) & 0x10) ? 0xc0 : 0x40);
+   evas_object_image_data_set(o, data);
+   evas_object_image_data_update_add(o, 0, 0, SRC_W, SRC_H);
+
+   return o;
+}
+
+/* num / den of the source size, centered on the canvas */
+static void
+_bench_scale(int request, int num, int den)
+{
+   Evas *e = _setup_evas();
+   Evas_Object *o;
+   int i;
+
+   o = _photo_add(e);
+   evas_object_show(o);
+
+   for (i = 0; i < request; i++)
+     {
+        int w, h;
+
+        w = ((SRC_W * num) / den) + (i % 32);
+        h = ((SRC_H * num) / den) + (i % 32);
+        evas_object_move(o, (W - w) / 2, (H - h) / 2);
+        evas_object_resize(o, w, h);
+        evas_render(e);
+     }
+
+   _teardown_evas(e);
+}
+
+static void
+evas_bench_scale_down_1_8(int request)
+{
+   _bench_scale(request, 1, 8);
+}
+
+static void
+evas_bench_scale_down_1_4(int request)
+{
+   _bench_scale(request, 1, 4);
+}
+
+static void
+evas_bench_scale_down_1_2(int request)
+{
+   _bench_scale(request, 1, 2);
+}
+
+static void
+evas_bench_scale_down_3_4(int request)
+{
+   _bench_scale(request, 3, 4);
+}
+
+static void
+evas_bench_scale_up_2(int request)
+{
+   _bench_scale(request, 2, 1);
+}
+
+void evas_bench_scale(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "scale-down-1/8", EINA_BENCHMARK(evas_bench_scale_down_1_8), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-down-1/4", EINA_BENCHMARK(evas_bench_scale_down_1_4), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-down-1/2", EINA_BENCHMARK(evas_bench_scale_down_1_2), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-down-3/4", EINA_BENCHMARK(evas_bench_scale_down_3_4), 10, 100, 10);
+   eina_benchmark_register(bench, "scale-up-2", EINA_BENCHMARK(evas_bench_scale_up_2), 10, 100, 10);
+}
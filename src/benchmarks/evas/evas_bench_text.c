@@ -0,0 +1,107 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Redraw a canvas full of text, to measure how fast glyphs are blended.
+   Every frame draws EVAS_BENCH_LINES lines of EVAS_BENCH_CHARS glyphs, so
+   the glyphs/sec are EVAS_BENCH_LINES * EVAS_BENCH_CHARS * request divided
+   by the time taken. The text is laid out once and the canvas is just as
+   large as the text, so that most of the time goes to drawing the glyphs.
+   Run with EVAS_CPU_NO_SSE3=1 or EVAS_CPU_NO_MMX=1 to compare the SIMD and
+   C code paths. */
+
+#define EVAS_BENCH_LINES 40
+#define EVAS_BENCH_CHARS 100
+
+static Evas *
+_setup_evas(int W, int H)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = malloc(sizeof (char) * W * H * 4);
+   einfo->info.dest_buffer_row_bytes = W * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, W, H);
+   evas_output_viewport_set(evas, 0, 0, W, H);
+
+   return evas;
+}
+
+static void
+_teardown_evas(Evas *evas)
+{
+   Evas_Engine_Info_Buffer *einfo;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   free(einfo->info.dest_buffer);
+
+   evas_free(evas);
+}
+
+static void
+_bench_text_draw(int request, int size)
+{
+   int W = (EVAS_BENCH_CHARS * size * 2) / 3;
+   int H = (EVAS_BENCH_LINES * size * 5) / 4;
+   Evas *e = _setup_evas(W, H);
+   Evas_Object *o;
+   char buf[EVAS_BENCH_CHARS + 1];
+   int i, j;
+
+   for (i = 0; i < EVAS_BENCH_LINES; i++)
+     {
+        for (j = 0; j < EVAS_BENCH_CHARS; j++)
+          buf[j] = '!' + ((i + j * 7) % 94);
+        buf[EVAS_BENCH_CHARS] = 0;
+
+        o = evas_object_text_add(e);
+        evas_object_text_font_source_set(o, TESTS_SRC_DIR "/TestFont.eet");
+        evas_object_text_font_set(o, "DejaVuSans", size);
+        evas_object_text_text_set(o, buf);
+        evas_object_color_set(o, 0, 0, 0, 255);
+        evas_object_move(o, 0, (i * H) / EVAS_BENCH_LINES);
+        evas_object_show(o);
+     }
+   evas_render(e);
+
+   for (i = 0; i < request; i++)
+     {
+        evas_damage_rectangle_add(e, 0, 0, W, H);
+        evas_render(e);
+     }
+
+   _teardown_evas(e);
+}
+
+static void
+evas_bench_text_small(int request)
+{
+   _bench_text_draw(request, 10);
+}
+
+static void
+evas_bench_text_large(int request)
+{
+   _bench_text_draw(request, 24);
+}
+
+void evas_bench_text(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "text-draw-small", EINA_BENCHMARK(evas_bench_text_small), 10, 100, 10);
+   eina_benchmark_register(bench, "text-draw-large", EINA_BENCHMARK(evas_bench_text_large), 10, 100, 10);
+}
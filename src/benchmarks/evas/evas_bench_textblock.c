@@ -0,0 +1,266 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Evas.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_bench.h"
+
+/* Edit and resize a textblock holding a long document, the way a log
+   viewer does, and measure how long the relayout that follows takes. Only
+   the edited paragraphs and the visible part of the document should have
+   to be laid out again. */
+
+#define W 800
+#define H 600
+
+#define EVAS_BENCH_PARAGRAPHS 50000
+
+static const char *_bench_style =
+   "DEFAULT='font=DejaVuSans font_source=" TESTS_SRC_DIR "/TestFont.eet "
+   "font_size=10 color=#000 wrap=word'"
+   "br='\n'"
+   "ps='ps'"
+   "tab='\t'"
+   "warn='+ color=#f80'";
+
+static Evas *
+_setup_evas(void)
+{
+   Evas *evas;
+   Evas_Engine_Info_Buffer *einfo;
+
+   evas = evas_new();
+
+   evas_output_method_set(evas, evas_render_method_lookup("buffer"));
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = malloc(sizeof (char) * W * H * 4);
+   einfo->info.dest_buffer_row_bytes = W * sizeof (char) * 4;
+
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   evas_output_size_set(evas, W, H);
+   evas_output_viewport_set(evas, 0, 0, W, H);
+
+   return evas;
+}
+
+static void
+_teardown_evas(Evas *evas)
+{
+   Evas_Engine_Info_Buffer *einfo;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   free(einfo->info.dest_buffer);
+
+   evas_free(evas);
+}
+
+static void
+_bench_line_append(Evas_Textblock_Cursor *cur, int i)
+{
+   char buf[128];
+
+   evas_textblock_cursor_paragraph_last(cur);
+   evas_textblock_cursor_paragraph_char_last(cur);
+   if (!(i % 10))
+     snprintf(buf, sizeof(buf),
+              "<ps/><warn>%06d</warn> warning: something odd happened here", i);
+   else
+     snprintf(buf, sizeof(buf),
+              "<ps/>%06d info: a line of the log, as long as most of them", i);
+   evas_object_textblock_text_markup_prepend(cur, buf);
+}
+
+/* Creates a textblock showing the top of a long document, laid out once. */
+static Evas_Object *
+_textblock_add(Evas *e, Evas_Textblock_Style **st, Evas_Textblock_Cursor **cur)
+{
+   Evas_Object *tb;
+   Evas_Coord w, h;
+   int i;
+
+   tb = evas_object_textblock_add(e);
+   *st = evas_textblock_style_new();
+   evas_textblock_style_set(*st, _bench_style);
+   evas_object_textblock_style_set(tb, *st);
+   evas_object_move(tb, 0, 0);
+   evas_object_resize(tb, W, H);
+   evas_object_show(tb);
+
+   *cur = evas_object_textblock_cursor_new(tb);
+   for (i = 0; i < EVAS_BENCH_PARAGRAPHS; i++)
+     _bench_line_append(*cur, i);
+
+   evas_object_textblock_size_formatted_get(tb, &w, &h);
+   evas_render(e);
+
+   return tb;
+}
+
+static void
+_textblock_del(Evas *e, Evas_Object *tb,
+               Evas_Textblock_Style *st, Evas_Textblock_Cursor *cur)
+{
+   evas_textblock_cursor_free(cur);
+   evas_object_del(tb);
+   evas_textblock_style_free(st);
+   _teardown_evas(e);
+}
+
+static void
+evas_bench_textblock_append(int request)
+{
+   Evas_Textblock_Style *st;
+   Evas_Textblock_Cursor *cur;
+   Evas_Object *tb;
+   Evas_Coord w, h;
+   Evas *e;
+   int i;
+
+   e = _setup_evas();
+   tb = _textblock_add(e, &st, &cur);
+
+   /* a new line comes in every frame */
+   for (i = 0; i < request; i++)
+     {
+        _bench_line_append(cur, EVAS_BENCH_PARAGRAPHS + i);
+        evas_object_textblock_size_formatted_get(tb, &w, &h);
+        evas_render(e);
+     }
+
+   _textblock_del(e, tb, st, cur);
+}
+
+static void
+evas_bench_textblock_type(int request)
+{
+   Evas_Textblock_Style *st;
+   Evas_Textblock_Cursor *cur;
+   Evas_Object *tb;
+   Evas_Coord w, h;
+   Evas *e;
+   int i;
+
+   e = _setup_evas();
+   tb = _textblock_add(e, &st, &cur);
+
+   /* type at the start of a paragraph in the middle of the document */
+   evas_textblock_cursor_paragraph_first(cur);
+   for (i = 0; i < EVAS_BENCH_PARAGRAPHS / 2; i++)
+     evas_textblock_cursor_paragraph_next(cur);
+
+   for (i = 0; i < request; i++)
+     {
+        evas_textblock_cursor_text_prepend(cur, "x");
+        evas_object_textblock_size_formatted_get(tb, &w, &h);
+        evas_render(e);
+     }
+
+   _textblock_del(e, tb, st, cur);
+}
+
+static void
+evas_bench_textblock_resize(int request)
+{
+   Evas_Textblock_Style *st;
+   Evas_Textblock_Cursor *cur;
+   Evas_Object *tb;
+   Evas *e;
+   int i;
+
+   e = _setup_evas();
+   tb = _textblock_add(e, &st, &cur);
+
+   /* the window gets resized narrow enough for the lines to wrap */
+   for (i = 0; i < request; i++)
+     {
+        evas_object_resize(tb, W / 4 + (i % 100), H);
+        evas_render(e);
+     }
+
+   _textblock_del(e, tb, st, cur);
+}
+
+/* Open documents one after the other, each in its own textblock, the way a
+   viewer does, and render the first frame of each. Laid out synchronously,
+   all of a document is laid out before its first frame: it's the first
+   layout, the paragraphs it could leave out aren't known yet. With the
+   layout done in a thread, only the part that is shown is laid out on the
+   main loop and the rest of the document in the thread, while the main loop
+   goes on with the next one. The documents are only waited for when they
+   are deleted, at the end: with a core or more to spare for the threads,
+   the time is about the one the main loop spends. */
+static void
+_textblock_load(int request, Eina_Bool async)
+{
+   Evas_Textblock_Style *st;
+   Evas_Object **tbs;
+   Eina_Strbuf *buf;
+   Evas *e;
+   int i;
+
+   e = _setup_evas();
+   st = evas_textblock_style_new();
+   evas_textblock_style_set(st, _bench_style);
+
+   buf = eina_strbuf_new();
+   for (i = 0; i < EVAS_BENCH_PARAGRAPHS / 10; i++)
+     {
+        if (!(i % 10))
+          eina_strbuf_append_printf(buf, "<warn>%06d</warn> warning: something "
+                                    "odd happened here<ps/>", i);
+        else
+          eina_strbuf_append_printf(buf, "%06d info: a line of the log, as "
+                                    "long as most of them<ps/>", i);
+     }
+
+   tbs = calloc(request, sizeof(Evas_Object *));
+   for (i = 0; i < request; i++)
+     {
+        tbs[i] = evas_object_textblock_add(e);
+        evas_object_textblock_style_set(tbs[i], st);
+        evas_object_textblock_async_layout_set(tbs[i], async);
+        evas_object_move(tbs[i], 0, 0);
+        evas_object_resize(tbs[i], W, H);
+        evas_object_show(tbs[i]);
+        evas_object_textblock_text_markup_set(tbs[i],
+                                              eina_strbuf_string_get(buf));
+        evas_render(e);
+        /* the next one opens in its place */
+        evas_object_hide(tbs[i]);
+     }
+
+   for (i = 0; i < request; i++)
+     evas_object_del(tbs[i]);
+   free(tbs);
+   eina_strbuf_free(buf);
+   evas_textblock_style_free(st);
+   _teardown_evas(e);
+}
+
+static void
+evas_bench_textblock_load(int request)
+{
+   _textblock_load(request, EINA_FALSE);
+}
+
+static void
+evas_bench_textblock_load_async(int request)
+{
+   _textblock_load(request, EINA_TRUE);
+}
+
+void evas_bench_textblock(Eina_Benchmark *bench)
+{
+   eina_benchmark_register(bench, "textblock-append", EINA_BENCHMARK(evas_bench_textblock_append), 10, 100, 10);
+   eina_benchmark_register(bench, "textblock-type", EINA_BENCHMARK(evas_bench_textblock_type), 10, 100, 10);
+   eina_benchmark_register(bench, "textblock-resize", EINA_BENCHMARK(evas_bench_textblock_resize), 10, 100, 10);
+   eina_benchmark_register(bench, "textblock-load", EINA_BENCHMARK(evas_bench_textblock_load), 1, 10, 1);
+   eina_benchmark_register(bench, "textblock-load-async", EINA_BENCHMARK(evas_bench_textblock_load_async), 1, 10, 1);
+}
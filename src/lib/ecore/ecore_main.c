@@ -159,6 +159,9 @@ timerfd_settime(int                      fd EINA_UNUSED,
 
 #define NS_PER_SEC (1000.0 * 1000.0 * 1000.0)
 
+/* events fetched by one epoll_wait() call */
+#define EPOLL_EVENTS_MAX 256
+
 struct _Ecore_Fd_Handler
 {
    EINA_INLIST;
@@ -213,6 +216,11 @@ static int  _ecore_main_fd_handlers_buf_call(void);
 #ifndef USE_G_MAIN_LOOP
 static void _ecore_main_loop_iterate_internal(int once_only);
 #endif
+#if defined(HAVE_SYS_EPOLL_H) && !defined(USE_G_MAIN_LOOP)
+static void _ecore_main_epoll_backend_init(void);
+static void _ecore_main_epoll_backend_shutdown(void);
+static int  _ecore_main_epoll_select(double timeout);
+#endif
 
 #ifdef _WIN32
 static int _ecore_main_win32_select(int             nfds,
@@ -262,6 +270,14 @@ static int timer_fd = -1;
 static int epoll_fd = -1;
 static pid_t epoll_pid;
 
+#if defined(HAVE_SYS_EPOLL_H) && !defined(USE_G_MAIN_LOOP)
+/* with ECORE_MAIN_LOOP_EPOLL set the main loop sleeps in epoll_wait()
+ * alone: timer_fd wakes it for the next timer, signal_fd for signals */
+static Eina_Bool epoll_backend = EINA_FALSE;
+static Eina_Bool timer_fd_armed = EINA_FALSE;
+static int signal_fd = -1;
+#endif
+
 #ifdef USE_G_MAIN_LOOP
 static GPollFD ecore_epoll_fd;
 static GPollFD ecore_timer_fd;
@@ -469,26 +485,34 @@ _ecore_main_fdh_poll_modify(Ecore_Fd_Handler *fdh)
    return r;
 }
 
-static inline int
-_ecore_main_fdh_epoll_mark_active(void)
+static inline void
+_ecore_main_fdh_epoll_events_mark(struct epoll_event *ev,
+                                  int                 count)
 {
-   struct epoll_event ev[32];
-   int i, ret;
-   int efd = _ecore_get_epoll_fd();
+   int i;
 
-   memset(&ev, 0, sizeof (ev));
-   ret = epoll_wait(efd, ev, sizeof(ev) / sizeof(struct epoll_event), 0);
-   if (ret < 0)
-     {
-        if (errno == EINTR) return -1;
-        ERR("epoll_wait failed %d", errno);
-        return -1;
-     }
-
-   for (i = 0; i < ret; i++)
+   for (i = 0; i < count; i++)
      {
         Ecore_Fd_Handler *fdh;
 
+#if defined(HAVE_SYS_EPOLL_H) && !defined(USE_G_MAIN_LOOP)
+        if (ev[i].data.ptr == &timer_fd)
+          {
+             uint64_t expired;
+
+             /* the wakeup was all it was there for */
+             if ((read(timer_fd, &expired, sizeof(expired)) < 0) &&
+                 (errno != EAGAIN))
+               ERR("timer read failed (errno=%d)", errno);
+             continue;
+          }
+        if (ev[i].data.ptr == &signal_fd)
+          {
+             _ecore_signal_fd_read();
+             continue;
+          }
+#endif
+
         fdh = ev[i].data.ptr;
         if (!ECORE_MAGIC_CHECK(fdh, ECORE_MAGIC_FD_HANDLER))
           {
@@ -511,6 +535,25 @@ _ecore_main_fdh_epoll_mark_active(void)
 
         _ecore_try_add_to_call_list(fdh);
      }
+}
+
+static inline int
+_ecore_main_fdh_epoll_mark_active(void)
+{
+   struct epoll_event ev[EPOLL_EVENTS_MAX];
+   int ret;
+   int efd = _ecore_get_epoll_fd();
+
+   memset(&ev, 0, sizeof (ev));
+   ret = epoll_wait(efd, ev, EPOLL_EVENTS_MAX, 0);
+   if (ret < 0)
+     {
+        if (errno == EINTR) return -1;
+        ERR("epoll_wait failed %d", errno);
+        return -1;
+     }
+
+   _ecore_main_fdh_epoll_events_mark(ev, ret);
 
    return ret;
 }
@@ -894,6 +937,11 @@ _ecore_main_loop_init(void)
      }
 #endif
 
+#if defined(HAVE_SYS_EPOLL_H) && !defined(USE_G_MAIN_LOOP)
+   if ((epoll_fd >= 0) && (getenv("ECORE_MAIN_LOOP_EPOLL")))
+     _ecore_main_epoll_backend_init();
+#endif
+
    detect_time_changes_start();
 }
 
@@ -910,6 +958,10 @@ _ecore_main_loop_shutdown(void)
 
    detect_time_changes_stop();
 
+#if defined(HAVE_SYS_EPOLL_H) && !defined(USE_G_MAIN_LOOP)
+   _ecore_main_epoll_backend_shutdown();
+#endif
+
    if (epoll_fd >= 0)
      {
         close(epoll_fd);
@@ -1098,6 +1150,9 @@ ecore_main_loop_animator_ticked_get(void)
  *
  * @warning you don't know how to use, don't even try to use it.
  *
+ * @note When ECORE_MAIN_LOOP_EPOLL is set in the environment, the main loop
+ * sleeps in epoll_wait() instead, unless a function was set here.
+ *
  * @param func The function to be used.
  */
 EAPI void
@@ -1523,6 +1578,12 @@ _ecore_main_select(double timeout)
    if (fd_handlers_with_prep)
      _ecore_main_prepare_handlers();
 
+#ifdef HAVE_SYS_EPOLL_H
+   /* regular files can't be polled by epoll, they still need select() */
+   if ((epoll_backend) && (main_loop_select == select) && (!file_fd_handlers))
+     return _ecore_main_epoll_select(timeout);
+#endif
+
    if (!HAVE_EPOLL || epoll_fd < 0)
      {
         EINA_INLIST_FOREACH(fd_handlers, fdh)
@@ -1632,6 +1693,125 @@ _ecore_main_select(double timeout)
 
 #endif
 
+#if defined(HAVE_SYS_EPOLL_H) && !defined(USE_G_MAIN_LOOP)
+static void
+_ecore_main_epoll_backend_init(void)
+{
+   timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+   if (timer_fd >= 0)
+     {
+        _ecore_fd_close_on_exec(timer_fd);
+        /* timer_fd and signal_fd are drained whenever they wake us up, so
+         * unlike the fd handlers they are safe to watch edge triggered */
+        if (_ecore_epoll_add(epoll_fd, timer_fd, EPOLLIN | EPOLLET,
+                             &timer_fd) < 0)
+          {
+             close(timer_fd);
+             timer_fd = -1;
+          }
+     }
+   if (timer_fd < 0)
+     WRN("No timer fd, timers will only be millisecond accurate");
+
+   signal_fd = _ecore_signal_fd_init();
+   if ((signal_fd >= 0) &&
+       (_ecore_epoll_add(epoll_fd, signal_fd, EPOLLIN | EPOLLET,
+                         &signal_fd) < 0))
+     {
+        _ecore_signal_fd_shutdown();
+        signal_fd = -1;
+     }
+   if (signal_fd < 0)
+     WRN("No signal pipe, signals may wait for the next wakeup");
+
+   timer_fd_armed = EINA_FALSE;
+   epoll_backend = EINA_TRUE;
+   INF("main loop waits on epoll only");
+}
+
+static void
+_ecore_main_epoll_backend_shutdown(void)
+{
+   if (!epoll_backend) return;
+
+   if (signal_fd >= 0)
+     {
+        _ecore_signal_fd_shutdown();
+        signal_fd = -1;
+     }
+   /* timer_fd itself is closed by _ecore_main_loop_shutdown() */
+   timer_fd_armed = EINA_FALSE;
+   epoll_backend = EINA_FALSE;
+}
+
+static int
+_ecore_main_epoll_timeout_set(double timeout)
+{
+   struct itimerspec ts;
+
+   /* same meaning as in _ecore_main_select(): negative waits forever,
+    * zero and non finite values only poll */
+   if ((!ECORE_FINITE(timeout)) || (timeout == 0.0)) return 0;
+
+   memset(&ts, 0, sizeof(ts));
+   if (timeout < 0.0)
+     {
+        /* an expiry left from an earlier timeout must not wake us up */
+        if ((timer_fd >= 0) && (timer_fd_armed))
+          {
+             timerfd_settime(timer_fd, 0, &ts, NULL);
+             timer_fd_armed = EINA_FALSE;
+          }
+        return -1;
+     }
+
+   if (timer_fd >= 0)
+     {
+        ts.it_value.tv_sec = timeout;
+        ts.it_value.tv_nsec = fmod(timeout * NS_PER_SEC, NS_PER_SEC);
+        /* timerfd cannot sleep for 0 time */
+        if ((!ts.it_value.tv_sec) && (!ts.it_value.tv_nsec)) return 0;
+        if (timerfd_settime(timer_fd, 0, &ts, NULL) == 0)
+          {
+             timer_fd_armed = EINA_TRUE;
+             return -1;
+          }
+        ERR("timer set failed (errno=%d)", errno);
+     }
+   return ceil(timeout * 1000.0);
+}
+
+static int
+_ecore_main_epoll_select(double timeout)
+{
+   struct epoll_event ev[EPOLL_EVENTS_MAX];
+   int efd, ms, ret;
+
+   efd = _ecore_get_epoll_fd();
+   ms = _ecore_main_epoll_timeout_set(timeout);
+   if (_ecore_signal_count_get()) return -1;
+
+   _ecore_unlock();
+   ret = epoll_wait(efd, ev, EPOLL_EVENTS_MAX, ms);
+   _ecore_lock();
+
+   _ecore_time_loop_time = ecore_time_get();
+   if (ret < 0)
+     {
+        if (errno != EINTR)
+          ERR("epoll_wait failed %d", errno);
+        return -1;
+     }
+   if (ret > 0)
+     {
+        _ecore_main_fdh_epoll_events_mark(ev, ret);
+        _ecore_main_fd_handlers_cleanup();
+        return 1;
+     }
+   return 0;
+}
+#endif
+
 #ifndef _WIN32
 # ifndef USE_G_MAIN_LOOP
 static void
@@ -201,12 +201,21 @@ static inline int _ecore_signal_count_get(void) { return 0; }
 
 static inline void _ecore_signal_call(void) { }
 
+static inline int _ecore_signal_fd_init(void) { return -1; }
+
+static inline void _ecore_signal_fd_shutdown(void) { }
+
+static inline void _ecore_signal_fd_read(void) { }
+
 #else
 void _ecore_signal_shutdown(void);
 void _ecore_signal_init(void);
 void _ecore_signal_received_process(void);
 int  _ecore_signal_count_get(void);
 void _ecore_signal_call(void);
+int  _ecore_signal_fd_init(void);
+void _ecore_signal_fd_shutdown(void);
+void _ecore_signal_fd_read(void);
 #endif
 
 void       _ecore_exe_init(void);
@@ -3,6 +3,8 @@
 #endif
 
 #include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <signal.h>
@@ -51,6 +53,7 @@ static void _ecore_signal_callback_sigpwr(int        sig,
 #endif
 
 static Eina_Bool _ecore_signal_exe_exit_delay(void *data);
+static void _ecore_signal_wakeup(void);
 
 //#define MAXSIGQ 256 // 32k
 #define MAXSIGQ 64 // 8k
@@ -78,6 +81,12 @@ static volatile siginfo_t sigterm_info[MAXSIGQ];
 static volatile siginfo_t sigpwr_info[MAXSIGQ];
 #endif
 
+/* when the main loop waits on epoll alone, the signal handlers write a
+ * byte to this pipe so a signal caught right before it goes to sleep
+ * still wakes it up. No signal is ever blocked for it, so children, even
+ * those started without the fork handlers, inherit the usual mask. */
+static int sig_pipe[2] = { -1, -1 };
+
 void
 _ecore_signal_shutdown(void)
 {
@@ -410,6 +419,69 @@ _ecore_signal_call(void)
    sigprocmask(SIG_SETMASK, &oldset, NULL);
 }
 
+int
+_ecore_signal_fd_init(void)
+{
+   int i;
+
+   if (sig_pipe[0] >= 0) return sig_pipe[0];
+
+   if (pipe(sig_pipe) < 0)
+     {
+        WRN("Failed to create signal pipe! (errno=%d)", errno);
+        sig_pipe[0] = sig_pipe[1] = -1;
+        return -1;
+     }
+   for (i = 0; i < 2; i++)
+     {
+        _ecore_fd_close_on_exec(sig_pipe[i]);
+        fcntl(sig_pipe[i], F_SETFL, O_NONBLOCK);
+     }
+   return sig_pipe[0];
+}
+
+void
+_ecore_signal_fd_shutdown(void)
+{
+   int fd;
+
+   if (sig_pipe[0] < 0) return;
+
+   /* a handler running now must not write to a closed, or reused, fd */
+   fd = sig_pipe[1];
+   sig_pipe[1] = -1;
+   close(fd);
+   close(sig_pipe[0]);
+   sig_pipe[0] = -1;
+}
+
+void
+_ecore_signal_fd_read(void)
+{
+   char buf[64];
+
+   if (sig_pipe[0] < 0) return;
+
+   /* the handlers already counted the signals, the wakeup was all it was
+    * there for */
+   while (read(sig_pipe[0], buf, sizeof(buf)) == sizeof(buf)) ;
+}
+
+static void
+_ecore_signal_wakeup(void)
+{
+   int fd = sig_pipe[1];
+   int err;
+
+   if (fd < 0) return;
+   err = errno;
+   if (write(fd, "", 1) < 0)
+     {
+        /* a full pipe is already enough to wake the main loop */
+     }
+   errno = err;
+}
+
 static void
 _ecore_signal_callback_set(int            sig,
                            Signal_Handler func)
@@ -446,6 +518,7 @@ _ecore_signal_callback_sigchld(int        sig EINA_UNUSED,
 
    sigchld_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 static void
@@ -464,6 +537,7 @@ _ecore_signal_callback_sigusr1(int        sig EINA_UNUSED,
      }
    sigusr1_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 static void
@@ -482,6 +556,7 @@ _ecore_signal_callback_sigusr2(int        sig EINA_UNUSED,
      }
    sigusr2_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 static void
@@ -500,6 +575,7 @@ _ecore_signal_callback_sighup(int        sig EINA_UNUSED,
      }
    sighup_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 static void
@@ -518,6 +594,7 @@ _ecore_signal_callback_sigquit(int        sig EINA_UNUSED,
      }
    sigquit_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 static void
@@ -536,6 +613,7 @@ _ecore_signal_callback_sigint(int        sig EINA_UNUSED,
      }
    sigint_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 static void
@@ -554,6 +632,7 @@ _ecore_signal_callback_sigterm(int        sig EINA_UNUSED,
      }
    sigterm_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 #ifdef SIGPWR
@@ -573,6 +652,7 @@ _ecore_signal_callback_sigpwr(int        sig EINA_UNUSED,
      }
    sigpwr_count++;
    sig_count++;
+   _ecore_signal_wakeup();
 }
 
 #endif
@@ -100,10 +100,12 @@ struct _Ecore_Pthread_Worker
 
    SLK(cancel_mutex);
 
+   /* set and cleared by the worker, out of the bits the main loop reads */
+   Eina_Bool reschedule;
+
    Eina_Bool message_run : 1;
    Eina_Bool feedback_run : 1;
    Eina_Bool kill : 1;
-   Eina_Bool reschedule : 1;
    Eina_Bool no_queue : 1;
 };
 
@@ -138,11 +140,32 @@ static void _ecore_thread_handler(void *data);
 
 static int _ecore_thread_count = 0;
 
-static Eina_List *_ecore_running_job = NULL;
-static Eina_List *_ecore_pending_job_threads = NULL;
-static Eina_List *_ecore_pending_job_threads_feedback = NULL;
+/* Every worker thread owns one of these queues. The main loop pushes new
+ * jobs at the tail of a queue, the owner pops from the head and idle
+ * workers steal from the tail of the other queues. Jobs are stored in a
+ * ring buffer, so queuing a job doesn't allocate anything. */
+typedef struct _Ecore_Thread_Queue Ecore_Thread_Queue;
+struct _Ecore_Thread_Queue
+{
+   Ecore_Pthread_Worker **jobs;
+   Ecore_Pthread_Worker *running;
+
+   unsigned int size;
+   unsigned int head;
+   unsigned int count;
+   unsigned int feedback_count;
+
+   SLK(lock);
+
+   Eina_Bool used : 1;
+};
+
+static Ecore_Thread_Queue *_ecore_thread_queues = NULL;
+static int _ecore_thread_queues_count = 0;
+static int _ecore_thread_queue_next = 0;
+
+/* protect thread creation/destruction and the used flag of the queues */
 static SLK(_ecore_pending_job_threads_mutex);
-static SLK(_ecore_running_job_mutex);
 
 static Eina_Hash *_ecore_thread_global_hash = NULL;
 static LRWK(_ecore_thread_global_hash_lock);
@@ -319,99 +342,166 @@ _ecore_message_notify_handler(void *data)
    free(notify);
 }
 
-static void
-_ecore_short_job(PH(thread))
+static Eina_Bool
+_ecore_thread_queue_push(Ecore_Thread_Queue *q, Ecore_Pthread_Worker *work)
+{
+   if (q->count == q->size)
+     {
+        Ecore_Pthread_Worker **tmp;
+        unsigned int size;
+        unsigned int i;
+
+        size = q->size ? q->size * 2 : 16;
+        tmp = malloc(size * sizeof (Ecore_Pthread_Worker *));
+        if (!tmp) return EINA_FALSE;
+
+        for (i = 0; i < q->count; i++)
+          tmp[i] = q->jobs[(q->head + i) & (q->size - 1)];
+
+        free(q->jobs);
+        q->jobs = tmp;
+        q->size = size;
+        q->head = 0;
+     }
+
+   q->jobs[(q->head + q->count) & (q->size - 1)] = work;
+   q->count++;
+   if (work->feedback_run) q->feedback_count++;
+
+   return EINA_TRUE;
+}
+
+static Ecore_Pthread_Worker *
+_ecore_thread_queue_pop(Ecore_Thread_Queue *q, Eina_Bool steal)
 {
    Ecore_Pthread_Worker *work;
-   int cancel;
 
-   SLKL(_ecore_pending_job_threads_mutex);
-   
-   if (!_ecore_pending_job_threads)
+   if (!q->count) return NULL;
+
+   if (steal)
      {
-        SLKU(_ecore_pending_job_threads_mutex);
-        return;
+        work = q->jobs[(q->head + q->count - 1) & (q->size - 1)];
      }
-   
-   work = eina_list_data_get(_ecore_pending_job_threads);
-   _ecore_pending_job_threads = eina_list_remove_list(_ecore_pending_job_threads,
-                                                      _ecore_pending_job_threads);
-   SLKU(_ecore_pending_job_threads_mutex);
+   else
+     {
+        work = q->jobs[q->head];
+        q->head = (q->head + 1) & (q->size - 1);
+     }
+   q->count--;
+   if (work->feedback_run) q->feedback_count--;
 
-   SLKL(_ecore_running_job_mutex);
-   _ecore_running_job = eina_list_append(_ecore_running_job, work);
-   SLKU(_ecore_running_job_mutex);
-   
-   SLKL(work->cancel_mutex);
-   cancel = work->cancel;
-   SLKU(work->cancel_mutex);
-   work->self = thread;
-   if (!cancel)
-     work->u.short_run.func_blocking((void *) work->data, (Ecore_Thread*) work);
+   return work;
+}
 
-   SLKL(_ecore_running_job_mutex);
-   _ecore_running_job = eina_list_remove(_ecore_running_job, work);
-   SLKU(_ecore_running_job_mutex);
-   
-   if (work->reschedule)
+static Eina_Bool
+_ecore_thread_queue_remove(Ecore_Thread_Queue *q, Ecore_Pthread_Worker *work)
+{
+   unsigned int i;
+
+   for (i = 0; i < q->count; i++)
      {
-        work->reschedule = EINA_FALSE;
-        
-        SLKL(_ecore_pending_job_threads_mutex);
-        _ecore_pending_job_threads = eina_list_append(_ecore_pending_job_threads, work);
-        SLKU(_ecore_pending_job_threads_mutex);
+        if (q->jobs[(q->head + i) & (q->size - 1)] != work) continue;
+
+        for (; i + 1 < q->count; i++)
+          q->jobs[(q->head + i) & (q->size - 1)] = q->jobs[(q->head + i + 1) & (q->size - 1)];
+        q->count--;
+        if (work->feedback_run) q->feedback_count--;
+
+        return EINA_TRUE;
      }
-   else
+
+   return EINA_FALSE;
+}
+
+static int
+_ecore_thread_queues_pending(Eina_Bool feedback)
+{
+   int ret = 0;
+   int i;
+
+   for (i = 0; i < _ecore_thread_queues_count; i++)
      {
-        ecore_main_loop_thread_safe_call_async(_ecore_thread_handler, work);
+        Ecore_Thread_Queue *q = _ecore_thread_queues + i;
+
+        SLKL(q->lock);
+        ret += feedback ? q->feedback_count : q->count - q->feedback_count;
+        SLKU(q->lock);
      }
+
+   return ret;
 }
 
-static void
-_ecore_feedback_job(PH(thread))
+static Ecore_Pthread_Worker *
+_ecore_thread_job_get(int slot)
 {
+   Ecore_Thread_Queue *own = _ecore_thread_queues + slot;
    Ecore_Pthread_Worker *work;
-   int cancel;
-   
-   SLKL(_ecore_pending_job_threads_mutex);
-   
-   if (!_ecore_pending_job_threads_feedback)
+   int i;
+
+   SLKL(own->lock);
+   work = _ecore_thread_queue_pop(own, EINA_FALSE);
+   own->running = work;
+   SLKU(own->lock);
+
+   if (work) return work;
+
+   /* Nothing left in our own queue, try to steal the most recently queued
+      job of another worker. Don't wait on a busy queue, just move on. Its
+      count is only read with its lock held. */
+   for (i = 1; i < _ecore_thread_queues_count; i++)
      {
-        SLKU(_ecore_pending_job_threads_mutex);
-        return;
+        Ecore_Thread_Queue *q;
+
+        q = _ecore_thread_queues + ((slot + i) % _ecore_thread_queues_count);
+        if (!eina_spinlock_take_try(&q->lock)) continue;
+        work = _ecore_thread_queue_pop(q, EINA_TRUE);
+        SLKU(q->lock);
+
+        if (work)
+          {
+             SLKL(own->lock);
+             own->running = work;
+             SLKU(own->lock);
+             return work;
+          }
      }
-   
-   work = eina_list_data_get(_ecore_pending_job_threads_feedback);
-   _ecore_pending_job_threads_feedback = eina_list_remove_list(_ecore_pending_job_threads_feedback,
-                                                               _ecore_pending_job_threads_feedback);
-   SLKU(_ecore_pending_job_threads_mutex);
-   SLKL(_ecore_running_job_mutex);
-   _ecore_running_job = eina_list_append(_ecore_running_job, work);
-   SLKU(_ecore_running_job_mutex);
-   
+
+   return NULL;
+}
+
+static void
+_ecore_thread_job_run(int slot, Ecore_Pthread_Worker *work, PH(thread))
+{
+   Ecore_Thread_Queue *own = _ecore_thread_queues + slot;
+   int cancel;
+
    SLKL(work->cancel_mutex);
    cancel = work->cancel;
    SLKU(work->cancel_mutex);
    work->self = thread;
    if (!cancel)
-     work->u.feedback_run.func_heavy((void *) work->data, (Ecore_Thread *) work);
-
-   SLKL(_ecore_running_job_mutex);
-   _ecore_running_job = eina_list_remove(_ecore_running_job, work);
-   SLKU(_ecore_running_job_mutex);
+     {
+        if (work->feedback_run)
+          work->u.feedback_run.func_heavy((void *) work->data, (Ecore_Thread *) work);
+        else
+          work->u.short_run.func_blocking((void *) work->data, (Ecore_Thread *) work);
+     }
 
+   SLKL(own->lock);
+   own->running = NULL;
    if (work->reschedule)
      {
         work->reschedule = EINA_FALSE;
-        
-        SLKL(_ecore_pending_job_threads_mutex);
-        _ecore_pending_job_threads_feedback = eina_list_append(_ecore_pending_job_threads_feedback, work);
-        SLKU(_ecore_pending_job_threads_mutex);
-     }
-   else
-     {
-        ecore_main_loop_thread_safe_call_async(_ecore_thread_handler, work);
+        if (_ecore_thread_queue_push(own, work))
+          {
+             SLKU(own->lock);
+             return;
+          }
+        ERR("Could not reschedule thread %p, ending it.", work);
      }
+   SLKU(own->lock);
+
+   ecore_main_loop_thread_safe_call_async(_ecore_thread_handler, work);
 }
 
 static void *
@@ -432,21 +522,14 @@ _ecore_direct_worker(Ecore_Pthread_Worker *work)
 }
 
 static void *
-_ecore_thread_worker(void *data EINA_UNUSED)
+_ecore_thread_worker(void *data)
 {
-restart:
-   _ecore_short_job(PHS());
-   _ecore_feedback_job(PHS());
-
-   /* FIXME: Check if there is feedback running task todo, and switch to feedback run handler. */
+   Ecore_Pthread_Worker *work;
+   int slot = (int)(intptr_t) data;
 
-   SLKL(_ecore_pending_job_threads_mutex);
-   if (_ecore_pending_job_threads || _ecore_pending_job_threads_feedback)
-     {
-        SLKU(_ecore_pending_job_threads_mutex);
-        goto restart;
-     }
-   SLKU(_ecore_pending_job_threads_mutex);
+restart:
+   while ((work = _ecore_thread_job_get(slot)))
+     _ecore_thread_job_run(slot, work, PHS());
 
    /* Sleep a little to prevent premature death */
 #ifdef _WIN32
@@ -456,12 +539,14 @@ restart:
 #endif
 
    SLKL(_ecore_pending_job_threads_mutex);
-   if (_ecore_pending_job_threads || _ecore_pending_job_threads_feedback)
+   if (_ecore_thread_queues_pending(EINA_FALSE) ||
+       _ecore_thread_queues_pending(EINA_TRUE))
      {
         SLKU(_ecore_pending_job_threads_mutex);
         goto restart;
      }
    _ecore_thread_count--;
+   _ecore_thread_queues[slot].used = EINA_FALSE;
 
    ecore_main_loop_thread_safe_call_async((Ecore_Cb) _ecore_thread_join,
 					  (void*)(intptr_t)PHS());
@@ -470,6 +555,86 @@ restart:
    return NULL;
 }
 
+/* Must be called from the main loop with _ecore_pending_job_threads_mutex
+   held. Queue work and start a new worker thread if we are allowed to. */
+static Eina_Bool
+_ecore_thread_schedule(Ecore_Pthread_Worker *work)
+{
+   Ecore_Thread_Queue *q = NULL;
+   Eina_Bool tried = EINA_FALSE;
+   PH(thread);
+   int slot = 0;
+   int i;
+
+   if (_ecore_thread_count < _ecore_thread_count_max)
+     {
+        for (i = 0; i < _ecore_thread_queues_count; i++)
+          if (!_ecore_thread_queues[i].used)
+            break;
+        if (i < _ecore_thread_queues_count)
+          {
+             slot = i;
+             q = _ecore_thread_queues + slot;
+
+             SLKL(q->lock);
+             if (!_ecore_thread_queue_push(q, work))
+               {
+                  SLKU(q->lock);
+                  return EINA_FALSE;
+               }
+             SLKU(q->lock);
+
+             /* One more thread could be created. */
+             eina_threads_init();
+
+          retry:
+             if (PHC(thread, _ecore_thread_worker, (void *)(intptr_t) slot))
+               {
+                  q->used = EINA_TRUE;
+                  _ecore_thread_count++;
+                  return EINA_TRUE;
+               }
+             if (!tried)
+               {
+                  _ecore_main_call_flush();
+                  tried = EINA_TRUE;
+                  goto retry;
+               }
+
+             eina_threads_shutdown();
+
+             /* The job stays in an orphan queue, running workers will
+                steal it. If there is none, nobody will ever run it. */
+             if (_ecore_thread_count > 0) return EINA_TRUE;
+
+             SLKL(q->lock);
+             _ecore_thread_queue_remove(q, work);
+             SLKU(q->lock);
+             return EINA_FALSE;
+          }
+     }
+
+   /* Spread the job on the queue of the running workers. */
+   for (i = 0; i < _ecore_thread_queues_count; i++)
+     {
+        slot = (_ecore_thread_queue_next + i) % _ecore_thread_queues_count;
+        if (_ecore_thread_queues[slot].used) break;
+     }
+   if (i == _ecore_thread_queues_count) return EINA_FALSE;
+   _ecore_thread_queue_next = slot + 1;
+
+   q = _ecore_thread_queues + slot;
+   SLKL(q->lock);
+   if (!_ecore_thread_queue_push(q, work))
+     {
+        SLKU(q->lock);
+        return EINA_FALSE;
+     }
+   SLKU(q->lock);
+
+   return EINA_TRUE;
+}
+
 static Ecore_Pthread_Worker *
 _ecore_thread_worker_new(void)
 {
@@ -493,14 +658,29 @@ _ecore_thread_worker_new(void)
 void
 _ecore_thread_init(void)
 {
+   int i;
+
    _ecore_thread_count_max = eina_cpu_count();
    if (_ecore_thread_count_max <= 0)
      _ecore_thread_count_max = 1;
 
+   /* ecore_thread_max_set() will never allow more thread than that */
+   _ecore_thread_queues_count = 16 * eina_cpu_count();
+   if (_ecore_thread_queues_count <= 0)
+     _ecore_thread_queues_count = 16;
+   _ecore_thread_queues = calloc(_ecore_thread_queues_count,
+                                 sizeof (Ecore_Thread_Queue));
+   if (!_ecore_thread_queues)
+     {
+        ERR("Could not allocate the thread queues.");
+        _ecore_thread_queues_count = 0;
+     }
+   for (i = 0; i < _ecore_thread_queues_count; i++)
+     SLKI(_ecore_thread_queues[i].lock);
+
    SLKI(_ecore_pending_job_threads_mutex);
    LRWKI(_ecore_thread_global_hash_lock);
    LKI(_ecore_thread_global_hash_mutex);
-   SLKI(_ecore_running_job_mutex);
    CDI(_ecore_thread_global_hash_cond, _ecore_thread_global_hash_mutex);
 }
 
@@ -509,34 +689,28 @@ _ecore_thread_shutdown(void)
 {
    /* FIXME: If function are still running in the background, should we kill them ? */
     Ecore_Pthread_Worker *work;
-    Eina_List *l;
     Eina_Bool test;
     int iteration = 0;
+    int i;
 
-    SLKL(_ecore_pending_job_threads_mutex);
-
-    EINA_LIST_FREE(_ecore_pending_job_threads, work)
+    for (i = 0; i < _ecore_thread_queues_count; i++)
       {
-         if (work->func_cancel)
-           work->func_cancel((void *)work->data, (Ecore_Thread *) work);
-         free(work);
+         Ecore_Thread_Queue *q = _ecore_thread_queues + i;
+
+         SLKL(q->lock);
+         while ((work = _ecore_thread_queue_pop(q, EINA_FALSE)))
+           {
+              if (work->func_cancel)
+                work->func_cancel((void *)work->data, (Ecore_Thread *) work);
+              free(work);
+           }
+         work = q->running;
+         SLKU(q->lock);
+
+         if (work)
+           ecore_thread_cancel((Ecore_Thread*) work);
       }
 
-    EINA_LIST_FREE(_ecore_pending_job_threads_feedback, work)
-      {
-         if (work->func_cancel)
-           work->func_cancel((void *)work->data, (Ecore_Thread *) work);
-         free(work);
-      }
-
-    SLKU(_ecore_pending_job_threads_mutex);
-    SLKL(_ecore_running_job_mutex);
-
-    EINA_LIST_FOREACH(_ecore_running_job, l, work)
-      ecore_thread_cancel((Ecore_Thread*) work);
-
-    SLKU(_ecore_running_job_mutex);
-
     do
       {
 	 SLKL(_ecore_pending_job_threads_mutex);
@@ -568,10 +742,18 @@ _ecore_thread_shutdown(void)
          free(work);
       }
 
+    for (i = 0; i < _ecore_thread_queues_count; i++)
+      {
+         SLKD(_ecore_thread_queues[i].lock);
+         free(_ecore_thread_queues[i].jobs);
+      }
+    free(_ecore_thread_queues);
+    _ecore_thread_queues = NULL;
+    _ecore_thread_queues_count = 0;
+
     SLKD(_ecore_pending_job_threads_mutex);
     LRWKD(_ecore_thread_global_hash_lock);
     LKD(_ecore_thread_global_hash_mutex);
-    SLKD(_ecore_running_job_mutex);
     CDD(_ecore_thread_global_hash_cond);
 }
 
@@ -582,8 +764,6 @@ ecore_thread_run(Ecore_Thread_Cb func_blocking,
                  const void     *data)
 {
    Ecore_Pthread_Worker *work;
-   Eina_Bool tried = EINA_FALSE;
-   PH(thread);
 
    EINA_MAIN_LOOP_CHECK_RETURN_VAL(NULL);
 
@@ -612,39 +792,8 @@ ecore_thread_run(Ecore_Thread_Cb func_blocking,
    work->hash = NULL;
 
    SLKL(_ecore_pending_job_threads_mutex);
-   _ecore_pending_job_threads = eina_list_append(_ecore_pending_job_threads, work);
-
-   if (_ecore_thread_count == _ecore_thread_count_max)
-     {
-        SLKU(_ecore_pending_job_threads_mutex);
-        return (Ecore_Thread *)work;
-     }
-
-   SLKU(_ecore_pending_job_threads_mutex);
-
-   /* One more thread could be created. */
-   eina_threads_init();
-
-   SLKL(_ecore_pending_job_threads_mutex);
-
- retry:
-   if (PHC(thread, _ecore_thread_worker, NULL))
+   if (!_ecore_thread_schedule(work))
      {
-        _ecore_thread_count++;
-	SLKU(_ecore_pending_job_threads_mutex);
-        return (Ecore_Thread *)work;
-     }
-   if (!tried)
-     {
-       _ecore_main_call_flush();
-       tried = EINA_TRUE;
-       goto retry;
-     }
-
-   if (_ecore_thread_count == 0)
-     {
-        _ecore_pending_job_threads = eina_list_remove(_ecore_pending_job_threads, work);
-
         if (work->func_cancel)
           work->func_cancel((void *) work->data, (Ecore_Thread *) work);
 
@@ -653,8 +802,6 @@ ecore_thread_run(Ecore_Thread_Cb func_blocking,
      }
    SLKU(_ecore_pending_job_threads_mutex);
 
-   eina_threads_shutdown();
-
    return (Ecore_Thread *)work;
 }
 
@@ -662,7 +809,6 @@ EAPI Eina_Bool
 ecore_thread_cancel(Ecore_Thread *thread)
 {
    Ecore_Pthread_Worker *volatile work = (Ecore_Pthread_Worker *)thread;
-   Eina_List *l;
    int cancel;
 
    if (!work)
@@ -681,46 +827,30 @@ ecore_thread_cancel(Ecore_Thread *thread)
           goto on_exit;
      }
 
-   SLKL(_ecore_pending_job_threads_mutex);
-
    if ((have_main_loop_thread) &&
        (PHE(get_main_loop_thread(), PHS())))
      {
-        if (!work->feedback_run)
-          EINA_LIST_FOREACH(_ecore_pending_job_threads, l, work)
-            {
-               if ((void *)work == (void *)thread)
-                 {
-                    _ecore_pending_job_threads = eina_list_remove_list(_ecore_pending_job_threads, l);
-
-                    SLKU(_ecore_pending_job_threads_mutex);
-
-                    if (work->func_cancel)
-                      work->func_cancel((void *)work->data, (Ecore_Thread *)work);
-                    free(work);
-
-                    return EINA_TRUE;
-                 }
-            }
-        else
-          EINA_LIST_FOREACH(_ecore_pending_job_threads_feedback, l, work)
-            {
-               if ((void *)work == (void *)thread)
-                 {
-                    _ecore_pending_job_threads_feedback = eina_list_remove_list(_ecore_pending_job_threads_feedback, l);
+        int i;
 
-                    SLKU(_ecore_pending_job_threads_mutex);
+        for (i = 0; i < _ecore_thread_queues_count; i++)
+          {
+             Ecore_Thread_Queue *q = _ecore_thread_queues + i;
+             Eina_Bool found;
 
-                    if (work->func_cancel)
-                      work->func_cancel((void *)work->data, (Ecore_Thread *)work);
-                    free(work);
+             SLKL(q->lock);
+             found = _ecore_thread_queue_remove(q, work);
+             SLKU(q->lock);
 
-                    return EINA_TRUE;
-                 }
-            }
-     }
+             if (found)
+               {
+                  if (work->func_cancel)
+                    work->func_cancel((void *)work->data, (Ecore_Thread *)work);
+                  free(work);
 
-   SLKU(_ecore_pending_job_threads_mutex);
+                  return EINA_TRUE;
+               }
+          }
+     }
 
    work = (Ecore_Pthread_Worker *)thread;
 
@@ -762,7 +892,6 @@ ecore_thread_feedback_run(Ecore_Thread_Cb        func_heavy,
 {
    Ecore_Pthread_Worker *worker;
    Eina_Bool tried = EINA_FALSE;
-   PH(thread);
 
    EINA_MAIN_LOOP_CHECK_RETURN_VAL(NULL);
 
@@ -820,55 +949,23 @@ ecore_thread_feedback_run(Ecore_Thread_Cb        func_heavy,
    worker->no_queue = EINA_FALSE;
 
    SLKL(_ecore_pending_job_threads_mutex);
-   _ecore_pending_job_threads_feedback = eina_list_append(_ecore_pending_job_threads_feedback, worker);
-
-   if (_ecore_thread_count == _ecore_thread_count_max)
+   if (_ecore_thread_schedule(worker))
      {
         SLKU(_ecore_pending_job_threads_mutex);
         return (Ecore_Thread *)worker;
      }
-
    SLKU(_ecore_pending_job_threads_mutex);
 
-   /* One more thread could be created. */
-   eina_threads_init();
-
-   SLKL(_ecore_pending_job_threads_mutex);
- retry:
-   if (PHC(thread, _ecore_thread_worker, NULL))
-     {
-        _ecore_thread_count++;
-	SLKU(_ecore_pending_job_threads_mutex);
-        return (Ecore_Thread *)worker;
-     }
-   if (!tried)
-     {
-        _ecore_main_call_flush();
-	tried = EINA_TRUE;
-	goto retry;
-     }
-   SLKU(_ecore_pending_job_threads_mutex);
-
-   eina_threads_shutdown();
-
 on_error:
-   SLKL(_ecore_pending_job_threads_mutex);
-   if (_ecore_thread_count == 0)
-     {
-        _ecore_pending_job_threads_feedback = eina_list_remove(_ecore_pending_job_threads_feedback,
-                                                               worker);
+   if (func_cancel) func_cancel((void *)data, NULL);
 
-        if (func_cancel) func_cancel((void *)data, NULL);
-
-        if (worker)
-          {
-             CDD(worker->cond);
-             LKD(worker->mutex);
-             free(worker);
-             worker = NULL;
-          }
+   if (worker)
+     {
+        CDD(worker->cond);
+        LKD(worker->mutex);
+        free(worker);
+        worker = NULL;
      }
-   SLKU(_ecore_pending_job_threads_mutex);
 
    return (Ecore_Thread *)worker;
 }
@@ -1007,37 +1104,23 @@ ecore_thread_active_get(void)
 EAPI int
 ecore_thread_pending_get(void)
 {
-   int ret;
-
    EINA_MAIN_LOOP_CHECK_RETURN_VAL(0);
-   SLKL(_ecore_pending_job_threads_mutex);
-   ret = eina_list_count(_ecore_pending_job_threads);
-   SLKU(_ecore_pending_job_threads_mutex);
-   return ret;
+   return _ecore_thread_queues_pending(EINA_FALSE);
 }
 
 EAPI int
 ecore_thread_pending_feedback_get(void)
 {
-   int ret;
-
    EINA_MAIN_LOOP_CHECK_RETURN_VAL(0);
-   SLKL(_ecore_pending_job_threads_mutex);
-   ret = eina_list_count(_ecore_pending_job_threads_feedback);
-   SLKU(_ecore_pending_job_threads_mutex);
-   return ret;
+   return _ecore_thread_queues_pending(EINA_TRUE);
 }
 
 EAPI int
 ecore_thread_pending_total_get(void)
 {
-   int ret;
-
    EINA_MAIN_LOOP_CHECK_RETURN_VAL(0);
-   SLKL(_ecore_pending_job_threads_mutex);
-   ret = eina_list_count(_ecore_pending_job_threads) + eina_list_count(_ecore_pending_job_threads_feedback);
-   SLKU(_ecore_pending_job_threads_mutex);
-   return ret;
+   return _ecore_thread_queues_pending(EINA_FALSE) +
+     _ecore_thread_queues_pending(EINA_TRUE);
 }
 
 EAPI int
@@ -39,10 +39,13 @@ struct _Ecore_Timer_Data
    int                 timer_bt_num;
 #endif
 
+   unsigned long long  seq;
+   unsigned int        heap_index; /* 1-based, 0 when not in the heap */
    int                 references;
    unsigned char       delete_me : 1;
    unsigned char       just_added : 1;
    unsigned char       frozen : 1;
+   unsigned char       tracked : 1;
 };
 
 typedef struct _Ecore_Timer_Data Ecore_Timer_Data;
@@ -52,19 +55,124 @@ static void _ecore_timer_set(Ecore_Timer *timer,
                              double        in,
                              Ecore_Task_Cb func,
                              void         *data);
+static void _ecore_timer_unlink(Ecore_Timer_Data *timer);
+static void _ecore_timer_delete_mark(Ecore_Timer_Data *timer);
 #ifdef WANT_ECORE_TIMER_DUMP
 static int _ecore_timer_cmp(const void *d1,
                             const void *d2);
 #endif
 
-static int timers_added = 0;
+/* Active timers live in a binary min-heap ordered by expiry time, so
+ * adding, deleting and finding the next timer to expire are O(log n).
+ *
+ * Timers added or rescheduled during an iteration are kept in
+ * timers_new and only enter the heap on _ecore_timer_enable_new(), so
+ * they can not fire in the iteration they were added in. Deleted
+ * timers are moved to timers_deleted until _ecore_timer_cleanup() can
+ * free them. */
+static Ecore_Timer_Data **timers = NULL;
+static unsigned int timers_count = 0;
+static unsigned int timers_alloc = 0;
+static unsigned long long timers_seq = 0;
 static int timers_delete_me = 0;
-static Ecore_Timer_Data *timers = NULL;
+static Ecore_Timer_Data *timers_new = NULL;
+static Ecore_Timer_Data *timers_deleted = NULL;
 static Ecore_Timer_Data *timer_current = NULL;
 static Ecore_Timer_Data *suspended = NULL;
 static double last_check = 0.0;
 static double precision = 10.0 / 1000000.0;
 
+static inline Eina_Bool
+_ecore_timer_heap_less(const Ecore_Timer_Data *t1,
+                       const Ecore_Timer_Data *t2)
+{
+   if (t1->at < t2->at) return EINA_TRUE;
+   if (t1->at > t2->at) return EINA_FALSE;
+   /* the most recently set timer goes first, as it always did */
+   return t1->seq > t2->seq;
+}
+
+static void
+_ecore_timer_heap_up(unsigned int i)
+{
+   Ecore_Timer_Data *timer = timers[i];
+
+   while (i > 0)
+     {
+        unsigned int parent = (i - 1) / 2;
+
+        if (!_ecore_timer_heap_less(timer, timers[parent])) break;
+        timers[i] = timers[parent];
+        timers[i]->heap_index = i + 1;
+        i = parent;
+     }
+   timers[i] = timer;
+   timer->heap_index = i + 1;
+}
+
+static void
+_ecore_timer_heap_down(unsigned int i)
+{
+   Ecore_Timer_Data *timer = timers[i];
+
+   for (;;)
+     {
+        unsigned int child = 2 * i + 1;
+
+        if (child >= timers_count) break;
+        if ((child + 1 < timers_count) &&
+            (_ecore_timer_heap_less(timers[child + 1], timers[child])))
+          child++;
+        if (!_ecore_timer_heap_less(timers[child], timer)) break;
+        timers[i] = timers[child];
+        timers[i]->heap_index = i + 1;
+        i = child;
+     }
+   timers[i] = timer;
+   timer->heap_index = i + 1;
+}
+
+static Eina_Bool
+_ecore_timer_heap_insert(Ecore_Timer_Data *timer)
+{
+   if (timers_count == timers_alloc)
+     {
+        Ecore_Timer_Data **tmp;
+        unsigned int alloc = timers_alloc ? timers_alloc * 2 : 64;
+
+        tmp = realloc(timers, alloc * sizeof (Ecore_Timer_Data *));
+        if (!tmp)
+          {
+             ERR("Could not grow the timer heap to %u entries", alloc);
+             return EINA_FALSE;
+          }
+        timers = tmp;
+        timers_alloc = alloc;
+     }
+
+   timers[timers_count++] = timer;
+   _ecore_timer_heap_up(timers_count - 1);
+   return EINA_TRUE;
+}
+
+static void
+_ecore_timer_heap_remove(Ecore_Timer_Data *timer)
+{
+   unsigned int i = timer->heap_index - 1;
+   Ecore_Timer_Data *last;
+
+   timer->heap_index = 0;
+   last = timers[--timers_count];
+   if (last == timer) return;
+
+   timers[i] = last;
+   last->heap_index = i + 1;
+   if ((i > 0) && (_ecore_timer_heap_less(last, timers[(i - 1) / 2])))
+     _ecore_timer_heap_up(i);
+   else
+     _ecore_timer_heap_down(i);
+}
+
 /**
  * @addtogroup Ecore_Timer_Group
  *
@@ -410,11 +518,11 @@ _ecore_timer_eo_base_event_freeze(Eo *obj EINA_UNUSED, Ecore_Timer_Data *timer)
 
    _ecore_lock();
 
-   /* Timer already frozen */
-   if (timer->frozen)
+   /* Timer already frozen or deleted */
+   if ((timer->frozen) || (timer->delete_me))
      goto unlock;
 
-   timers = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers), EINA_INLIST_GET(timer));
+   _ecore_timer_unlink(timer);
    suspended = (Ecore_Timer_Data *)eina_inlist_prepend(EINA_INLIST_GET(suspended), EINA_INLIST_GET(timer));
 
    now = ecore_time_get();
@@ -472,8 +580,8 @@ _ecore_timer_eo_base_event_thaw(Eo *obj, Ecore_Timer_Data *timer)
 
    _ecore_lock();
 
-   /* Timer not frozen */
-   if (!timer->frozen)
+   /* Timer not frozen, or deleted and waiting for cleanup */
+   if ((!timer->frozen) || (timer->delete_me))
      goto unlock;
 
    suspended = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(suspended), EINA_INLIST_GET(timer));
@@ -492,6 +600,7 @@ ecore_timer_dump(void)
    char *out;
    Ecore_Timer_Data *tm;
    Eina_List *tmp = NULL;
+   unsigned int i;
    int living_timer = 0;
    int unknow_timer = 0;
 
@@ -499,7 +608,9 @@ ecore_timer_dump(void)
    _ecore_lock();
    result = eina_strbuf_new();
 
-   EINA_INLIST_FOREACH(timers, tm)
+   for (i = 0; i < timers_count; i++)
+     tmp = eina_list_sorted_insert(tmp, _ecore_timer_cmp, timers[i]);
+   EINA_INLIST_FOREACH(timers_new, tm)
      tmp = eina_list_sorted_insert(tmp, _ecore_timer_cmp, tm);
 
    EINA_LIST_FREE(tmp, tm)
@@ -566,9 +677,13 @@ _ecore_timer_util_delay(Ecore_Timer *obj,
      {
         timer->pending += add;
      }
+   else if (timer->delete_me)
+     {
+        timer->at += add;
+     }
    else
      {
-        timers = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers), EINA_INLIST_GET(timer));
+        _ecore_timer_unlink(timer);
         eo_data_unref(obj, timer);
         _ecore_timer_set(obj, timer->at + add, timer->in, timer->func, timer->data);
      }
@@ -584,10 +699,14 @@ _ecore_timer_del(Ecore_Timer *obj)
         void *data = timer->data;
 
         eo_data_unref(obj, timer);
-        suspended = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(suspended), EINA_INLIST_GET(timer));
-
         if (timer->delete_me)
-          timers_delete_me--;
+          {
+             timers_deleted = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers_deleted), EINA_INLIST_GET(timer));
+             timers_delete_me--;
+          }
+        else
+          suspended = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(suspended), EINA_INLIST_GET(timer));
+        timer->tracked = 0;
 
         eo_do(obj, eo_parent_set(NULL));
 
@@ -599,8 +718,7 @@ _ecore_timer_del(Ecore_Timer *obj)
      }
 
    EINA_SAFETY_ON_TRUE_RETURN_VAL(timer->delete_me, NULL);
-   timer->delete_me = 1;
-   timers_delete_me++;
+   _ecore_timer_delete_mark(timer);
    return timer->data;
 }
 
@@ -608,43 +726,64 @@ EOLIAN static void
 _ecore_timer_eo_base_destructor(Eo *obj, Ecore_Timer_Data *pd)
 {
    if (!pd->delete_me)
-   {
-     pd->delete_me = 1;
-     timers_delete_me++;
-   }
+     _ecore_timer_delete_mark(pd);
 
    eo_do_super(obj, MY_CLASS, eo_destructor());
 }
 
+static inline void
+_ecore_timer_free(Ecore_Timer_Data *timer)
+{
+   /* already unlinked, the destructor must not link it again */
+   timer->tracked = 0;
+   eo_data_unref(timer->obj, timer);
+   eo_do(timer->obj, eo_parent_set(NULL));
+   if (eo_destructed_is(timer->obj))
+     eo_manual_free(timer->obj);
+   else
+     eo_manual_free_set(timer->obj, EINA_FALSE);
+}
+
 void
 _ecore_timer_shutdown(void)
 {
    Ecore_Timer_Data *timer;
 
-   while ((timer = timers))
+   while (timers_count)
      {
-        timers = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers), EINA_INLIST_GET(timers));
+        timer = timers[timers_count - 1];
+        timer->heap_index = 0;
+        timers_count--;
 
-        eo_data_unref(timer->obj, timer);
-        eo_do(timer->obj, eo_parent_set(NULL));
-        if (eo_destructed_is(timer->obj))
-          eo_manual_free(timer->obj);
-        else
-          eo_manual_free_set(timer->obj, EINA_FALSE);
+        _ecore_timer_free(timer);
+     }
+   free(timers);
+   timers = NULL;
+   timers_alloc = 0;
+
+   while ((timer = timers_new))
+     {
+        timers_new = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers_new), EINA_INLIST_GET(timers_new));
+        timer->just_added = 0;
+
+        _ecore_timer_free(timer);
+     }
+
+   while ((timer = timers_deleted))
+     {
+        timers_deleted = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers_deleted), EINA_INLIST_GET(timers_deleted));
+
+        _ecore_timer_free(timer);
      }
 
    while ((timer = suspended))
      {
         suspended = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(suspended), EINA_INLIST_GET(suspended));
 
-        eo_data_unref(timer->obj, timer);
-        eo_do(timer->obj, eo_parent_set(NULL));
-        if (eo_destructed_is(timer->obj))
-          eo_manual_free(timer->obj);
-        else
-          eo_manual_free_set(timer->obj, EINA_FALSE);
+        _ecore_timer_free(timer);
      }
 
+   timers_delete_me = 0;
    timer_current = NULL;
 }
 
@@ -655,55 +794,22 @@ _ecore_timer_cleanup(void)
    int in_use = 0, todo = timers_delete_me, done = 0;
 
    if (!timers_delete_me) return;
-   for (l = timers; l; )
+   for (l = timers_deleted; l; )
      {
         Ecore_Timer_Data *timer = l;
 
         l = (Ecore_Timer_Data *)EINA_INLIST_GET(l)->next;
-        if (timer->delete_me)
+        if (timer->references)
           {
-             if (timer->references)
-               {
-                  in_use++;
-                  continue;
-               }
-             timers = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers), EINA_INLIST_GET(timer));
-
-             eo_data_unref(timer->obj, timer);
-             eo_do(timer->obj, eo_parent_set(NULL));
-             if (eo_destructed_is(timer->obj))
-               eo_manual_free(timer->obj);
-             else
-               eo_manual_free_set(timer->obj, EINA_FALSE);
-             timers_delete_me--;
-             done++;
-             if (timers_delete_me == 0) return;
+             in_use++;
+             continue;
           }
-     }
-   for (l = suspended; l; )
-     {
-        Ecore_Timer_Data *timer = l;
+        timers_deleted = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers_deleted), EINA_INLIST_GET(timer));
 
-        l = (Ecore_Timer_Data *)EINA_INLIST_GET(l)->next;
-        if (timer->delete_me)
-          {
-             if (timer->references)
-               {
-                  in_use++;
-                  continue;
-               }
-             suspended = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(suspended), EINA_INLIST_GET(timer));
-
-             eo_data_unref(timer->obj, timer);
-             eo_do(timer->obj, eo_parent_set(NULL));
-             if (eo_destructed_is(timer->obj))
-                eo_manual_free(timer->obj);
-             else
-                eo_manual_free_set(timer->obj, EINA_FALSE);
-             timers_delete_me--;
-             done++;
-             if (timers_delete_me == 0) return;
-          }
+        _ecore_timer_free(timer);
+        timers_delete_me--;
+        done++;
+        if (timers_delete_me == 0) return;
      }
 
    if ((!in_use) && (timers_delete_me))
@@ -721,56 +827,35 @@ _ecore_timer_enable_new(void)
 {
    Ecore_Timer_Data *timer;
 
-   if (!timers_added) return;
-   timers_added = 0;
-   EINA_INLIST_FOREACH(timers, timer) timer->just_added = 0;
+   while ((timer = timers_new))
+     {
+        if (!_ecore_timer_heap_insert(timer)) return;
+        timers_new = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers_new), EINA_INLIST_GET(timer));
+        timer->just_added = 0;
+     }
 }
 
 int
 _ecore_timers_exists(void)
 {
-   Ecore_Timer_Data *timer = timers;
-
-   while ((timer) && (timer->delete_me))
-     timer = (Ecore_Timer_Data *)EINA_INLIST_GET(timer)->next;
-
-   return !!timer;
+   return (timers_count) || (timers_new) || (timer_current);
 }
 
-static inline Ecore_Timer *
-_ecore_timer_first_get(void)
+static Ecore_Timer_Data *
+_ecore_timer_after_get(unsigned int i, double maxtime, Ecore_Timer_Data *last)
 {
-   Ecore_Timer *ret = NULL;
-   Ecore_Timer_Data *timer = timers;
-
-   while ((timer) && ((timer->delete_me) || (timer->just_added)))
-     timer = (Ecore_Timer_Data *)EINA_INLIST_GET(timer)->next;
-
-   if (timer)
-     ret = timer->obj;
-   return ret;
-}
-
-static inline Ecore_Timer *
-_ecore_timer_after_get(Ecore_Timer *obj)
-{
-   Ecore_Timer *ret = NULL;
-   Ecore_Timer_Data *base = eo_data_scope_get(obj, MY_CLASS);
+   Ecore_Timer_Data *timer;
 
-   Ecore_Timer_Data *timer = (Ecore_Timer_Data *)EINA_INLIST_GET(base)->next;
-   Ecore_Timer_Data *valid_timer = NULL;
-   double maxtime = base->at + precision;
+   /* children expire no sooner than their parent, so only walk the
+    * part of the heap expiring before maxtime */
+   if (i >= timers_count) return last;
+   timer = timers[i];
+   if (timer->at >= maxtime) return last;
+   if ((!last) || (_ecore_timer_heap_less(last, timer)))
+     last = timer;
 
-   while ((timer) && (timer->at < maxtime))
-     {
-        if (!((timer->delete_me) || (timer->just_added)))
-          valid_timer = timer;
-        timer = (Ecore_Timer_Data *)EINA_INLIST_GET(timer)->next;
-     }
-
-   if (valid_timer)
-     ret = valid_timer->obj;
-   return ret;
+   last = _ecore_timer_after_get(2 * i + 1, maxtime, last);
+   return _ecore_timer_after_get(2 * i + 2, maxtime, last);
 }
 
 double
@@ -778,16 +863,14 @@ _ecore_timer_next_get(void)
 {
    double now;
    double in;
-   Ecore_Timer *first_obj, *second_obj;
    Ecore_Timer_Data *first;
 
-   first_obj = _ecore_timer_first_get();
-   if (!first_obj) return -1;
-
-   second_obj = _ecore_timer_after_get(first_obj);
-   if (second_obj) first_obj = second_obj;
+   if (!timers_count) return -1;
 
-   first = eo_data_scope_get(first_obj, MY_CLASS);
+   /* wake up for the last timer within precision of the first one, so
+    * they all get called in the same iteration */
+   first = timers[0];
+   first = _ecore_timer_after_get(0, first->at + precision, first);
 
    now = ecore_loop_time_get();
    in = first->at - now;
@@ -802,7 +885,7 @@ _ecore_timer_reschedule(Ecore_Timer *obj,
    Ecore_Timer_Data *timer = eo_data_scope_get(obj, MY_CLASS);
    if ((timer->delete_me) || (timer->frozen)) return;
 
-   timers = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers), EINA_INLIST_GET(timer));
+   _ecore_timer_unlink(timer);
    eo_data_unref(obj, timer);
 
    /* if the timer would have gone off more than 15 seconds ago,
@@ -832,43 +915,37 @@ _ecore_timer_expired_timers_call(double when)
 int
 _ecore_timer_expired_call(double when)
 {
-   if (!timers) return 0;
+   if ((!timers_count) && (!timer_current)) return 0;
    if (last_check > when)
      {
         Ecore_Timer_Data *timer;
-        /* User set time backwards */
-        EINA_INLIST_FOREACH(timers, timer) timer->at -= (last_check - when);
+        unsigned int i;
+
+        /* User set time backwards, shifting every timer keeps the heap
+         * ordered */
+        for (i = 0; i < timers_count; i++)
+          timers[i]->at -= (last_check - when);
+        EINA_INLIST_FOREACH(timers_new, timer) timer->at -= (last_check - when);
      }
    last_check = when;
 
-   if (!timer_current)
-     {
-        /* regular main loop, start from head */
-        timer_current = timers;
-     }
-   else
+   if (timer_current)
      {
-        /* recursive main loop, continue from where we were */
+        /* recursive main loop, reschedule the timer being called */
         Ecore_Timer_Data *timer_old = timer_current;
-        timer_current = (Ecore_Timer_Data *)EINA_INLIST_GET(timer_current)->next;
+        timer_current = NULL;
         _ecore_timer_reschedule(timer_old->obj, when);
      }
 
-   while (timer_current)
+   while (timers_count)
      {
-        Ecore_Timer_Data *timer = timer_current;
+        Ecore_Timer_Data *timer = timers[0];
 
-        if (timer->at > when)
-          {
-             timer_current = NULL; /* ended walk, next should restart. */
-             return 0;
-          }
+        if (timer->at > when) return 0;
 
-        if ((timer->just_added) || (timer->delete_me))
-          {
-             timer_current = (Ecore_Timer_Data *)EINA_INLIST_GET(timer_current)->next;
-             continue;
-          }
+        /* the heap only holds live timers enabled before this iteration */
+        _ecore_timer_heap_remove(timer);
+        timer_current = timer;
 
         timer->references++;
         if (!_ecore_call_task_cb(timer->func, timer->data))
@@ -877,10 +954,12 @@ _ecore_timer_expired_call(double when)
           }
         timer->references--;
 
-        if (timer_current) /* may have changed in recursive main loops */
-          timer_current = (Ecore_Timer_Data *)EINA_INLIST_GET(timer_current)->next;
-
-        _ecore_timer_reschedule(timer->obj, when);
+        /* may have been rescheduled already by a recursive main loop */
+        if (timer_current == timer)
+          {
+             timer_current = NULL;
+             _ecore_timer_reschedule(timer->obj, when);
+          }
      }
    return 0;
 }
@@ -892,30 +971,47 @@ _ecore_timer_set(Ecore_Timer  *obj,
                  Ecore_Task_Cb func,
                  void         *data)
 {
-   Ecore_Timer_Data *t2;
-
    Ecore_Timer_Data *timer = eo_data_ref(obj, MY_CLASS);
 
-   timers_added = 1;
    timer->at = at;
    timer->in = in;
    timer->func = func;
    timer->data = data;
+   timer->seq = timers_seq++;
    timer->just_added = 1;
    timer->frozen = 0;
+   timer->tracked = 1;
    timer->pending = 0.0;
-   if (timers)
+   timers_new = (Ecore_Timer_Data *)eina_inlist_append(EINA_INLIST_GET(timers_new), EINA_INLIST_GET(timer));
+}
+
+/* remove a timer from the heap or the list of timers to enable */
+static void
+_ecore_timer_unlink(Ecore_Timer_Data *timer)
+{
+   if (timer->heap_index)
+     _ecore_timer_heap_remove(timer);
+   else if (timer->just_added)
      {
-        EINA_INLIST_REVERSE_FOREACH(EINA_INLIST_GET(timers), t2)
-          {
-             if (timer->at > t2->at)
-               {
-                  timers = (Ecore_Timer_Data *)eina_inlist_append_relative(EINA_INLIST_GET(timers), EINA_INLIST_GET(timer), EINA_INLIST_GET(t2));
-                  return;
-               }
-          }
+        timers_new = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(timers_new), EINA_INLIST_GET(timer));
+        timer->just_added = 0;
      }
-   timers = (Ecore_Timer_Data *)eina_inlist_prepend(EINA_INLIST_GET(timers), EINA_INLIST_GET(timer));
+}
+
+static void
+_ecore_timer_delete_mark(Ecore_Timer_Data *timer)
+{
+   timer->delete_me = 1;
+   timers_delete_me++;
+
+   /* timers that never got scheduled hold no data reference to drop */
+   if (!timer->tracked) return;
+
+   if (timer->frozen)
+     suspended = (Ecore_Timer_Data *)eina_inlist_remove(EINA_INLIST_GET(suspended), EINA_INLIST_GET(timer));
+   else
+     _ecore_timer_unlink(timer);
+   timers_deleted = (Ecore_Timer_Data *)eina_inlist_append(EINA_INLIST_GET(timers_deleted), EINA_INLIST_GET(timer));
 }
 
 #ifdef WANT_ECORE_TIMER_DUMP
@@ -992,6 +992,43 @@ EAPI double            ecore_con_server_uptime_get(Ecore_Con_Server *svr);
 EAPI int               ecore_con_server_send(Ecore_Con_Server *svr,
                                              const void *data,
                                              int size);
+/**
+ * @typedef Ecore_Con_Send_Free_Cb
+ * A callback releasing the data given to ecore_con_server_send_segment() or
+ * ecore_con_client_send_segment(), @p buf is that data.
+ * @since 1.10
+ */
+typedef void (*Ecore_Con_Send_Free_Cb)(void *data, const void *buf);
+/**
+ * Sends the given data to the given server without copying it.
+ *
+ * @param   svr       The given server.
+ * @param   data      The given data.
+ * @param   size      Length of the data, in bytes, to send.
+ * @param   free_cb   Called with @p free_data and @p data once the data is
+ *                    no longer needed, may be @c NULL.
+ * @param   free_data Data given to @p free_cb.
+ * @return  The number of bytes sent.  @c 0 will be returned if there is an
+ *          error, @p data then still belongs to the caller and @p free_cb
+ *          is not called.
+ *
+ * This function works like ecore_con_server_send(), in the same order, but
+ * only keeps a reference to @p data: it must stay valid and unchanged until
+ * @p free_cb is called, once the data was written or the server is deleted.
+ * All that is queued is written with a single writev() call, so large
+ * buffers are sent without being copied into the connection. Small ones
+ * are copied anyway, @p free_cb is then called before this function
+ * returns.
+ *
+ * @see ecore_con_server_send()
+ * @see ecore_con_client_send_segment()
+ * @since 1.10
+ */
+EAPI int               ecore_con_server_send_segment(Ecore_Con_Server *svr,
+                                                     const void *data,
+                                                     int size,
+                                                     Ecore_Con_Send_Free_Cb free_cb,
+                                                     const void *free_data);
 /**
  * Sets a limit on the number of clients that can be handled concurrently
  * by the given server, and a policy on what to do if excess clients try to
@@ -1142,6 +1179,32 @@ EAPI int               ecore_con_client_fd_get(Ecore_Con_Client *cl);
 EAPI int               ecore_con_client_send(Ecore_Con_Client *cl,
                                              const void *data,
                                              int size);
+/**
+ * Sends the given data to the given client without copying it.
+ *
+ * @param   cl        The given client.
+ * @param   data      The given data.
+ * @param   size      Length of the data, in bytes, to send.
+ * @param   free_cb   Called with @p free_data and @p data once the data is
+ *                    no longer needed, may be @c NULL.
+ * @param   free_data Data given to @p free_cb.
+ * @return  The number of bytes sent.  @c 0 will be returned if there is an
+ *          error, @p data then still belongs to the caller and @p free_cb
+ *          is not called.
+ *
+ * This is the client side of ecore_con_server_send_segment(), see it for
+ * details. Sending the same buffer to many clients only costs a reference
+ * per client, @p free_cb is called once for each of them.
+ *
+ * @see ecore_con_client_send()
+ * @see ecore_con_server_send_segment()
+ * @since 1.10
+ */
+EAPI int               ecore_con_client_send_segment(Ecore_Con_Client *cl,
+                                                     const void *data,
+                                                     int size,
+                                                     Ecore_Con_Send_Free_Cb free_cb,
+                                                     const void *free_data);
 /**
  * Retrieves the server representing the socket the client has
  * connected to.
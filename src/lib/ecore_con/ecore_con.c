@@ -30,6 +30,17 @@
 #include <sys/un.h>
 #endif
 
+#ifdef HAVE_SYS_UIO_H
+# include <sys/uio.h>
+typedef struct iovec Ecore_Con_Iovec;
+#else
+typedef struct
+{
+   void *iov_base;
+   size_t iov_len;
+} Ecore_Con_Iovec;
+#endif
+
 #ifdef HAVE_SYSTEMD
 # include <systemd/sd-daemon.h>
 #endif
@@ -80,6 +91,14 @@ static Eina_Bool   _ecore_con_svr_cl_handler(void *data,
 
 static void        _ecore_con_server_flush(Ecore_Con_Server *svr);
 static void        _ecore_con_client_flush(Ecore_Con_Client *cl);
+static Eina_Bool   _ecore_con_send_segment_append(Eina_Inlist **segs,
+                                                  Eina_Binbuf **buf,
+                                                  size_t *buf_offset,
+                                                  const void *data,
+                                                  size_t size,
+                                                  Ecore_Con_Send_Free_Cb free_cb,
+                                                  const void *free_data);
+static void        _ecore_con_send_segments_free(Eina_Inlist **segs);
 
 static void        _ecore_con_event_client_add_free(Ecore_Con_Server *svr,
                                                     void *ev);
@@ -120,7 +139,7 @@ _ecore_con_client_kill(Ecore_Con_Client *cl)
    else
      {
         ecore_con_event_client_del(cl);
-        if (cl->buf) return;
+        if ((cl->buf) || (cl->send_segs)) return;
      }
    INF("Lost client %s", (cl->ip) ? cl->ip : "");
    if (cl->fd_handler)
@@ -708,6 +727,43 @@ ecore_con_server_send(Ecore_Con_Server *svr,
    return size;
 }
 
+EAPI int
+ecore_con_server_send_segment(Ecore_Con_Server *svr,
+                              const void *data,
+                              int size,
+                              Ecore_Con_Send_Free_Cb free_cb,
+                              const void *free_data)
+{
+   if (!ECORE_MAGIC_CHECK(svr, ECORE_MAGIC_CON_SERVER))
+     {
+        ECORE_MAGIC_FAIL(svr, ECORE_MAGIC_CON_SERVER, "ecore_con_server_send_segment");
+        return 0;
+     }
+
+   EINA_SAFETY_ON_TRUE_RETURN_VAL(svr->delete_me, 0);
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(data, 0);
+
+   EINA_SAFETY_ON_TRUE_RETURN_VAL(size < 1, 0);
+
+#ifndef _WIN32
+   if (size >= SEND_SEGMENT_MIN)
+     {
+        if (!_ecore_con_send_segment_append(&svr->send_segs, &svr->buf,
+                                            &svr->write_buf_offset,
+                                            data, size, free_cb, free_data))
+          return 0;
+        if (svr->fd_handler)
+          ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_READ | ECORE_FD_WRITE);
+        return size;
+     }
+#endif
+
+   size = ecore_con_server_send(svr, data, size);
+   if ((size) && (free_cb)) free_cb((void *)free_data, data);
+   return size;
+}
+
 EAPI void
 ecore_con_server_client_limit_set(Ecore_Con_Server *svr,
                                   int client_limit,
@@ -822,6 +878,44 @@ ecore_con_client_send(Ecore_Con_Client *cl,
    return size;
 }
 
+EAPI int
+ecore_con_client_send_segment(Ecore_Con_Client *cl,
+                              const void *data,
+                              int size,
+                              Ecore_Con_Send_Free_Cb free_cb,
+                              const void *free_data)
+{
+   if (!ECORE_MAGIC_CHECK(cl, ECORE_MAGIC_CON_CLIENT))
+     {
+        ECORE_MAGIC_FAIL(cl, ECORE_MAGIC_CON_CLIENT, "ecore_con_client_send_segment");
+        return 0;
+     }
+
+   EINA_SAFETY_ON_TRUE_RETURN_VAL(cl->delete_me, 0);
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(data, 0);
+
+   EINA_SAFETY_ON_TRUE_RETURN_VAL(size < 1, 0);
+
+#ifndef _WIN32
+   if ((size >= SEND_SEGMENT_MIN) &&
+       (!(cl->host_server && ((cl->host_server->type & ECORE_CON_TYPE) == ECORE_CON_REMOTE_UDP))))
+     {
+        if (!_ecore_con_send_segment_append(&cl->send_segs, &cl->buf,
+                                            &cl->buf_offset,
+                                            data, size, free_cb, free_data))
+          return 0;
+        if (cl->fd_handler)
+          ecore_main_fd_handler_active_set(cl->fd_handler, ECORE_FD_READ | ECORE_FD_WRITE);
+        return size;
+     }
+#endif
+
+   size = ecore_con_client_send(cl, data, size);
+   if ((size) && (free_cb)) free_cb((void *)free_data, data);
+   return size;
+}
+
 EAPI Ecore_Con_Server *
 ecore_con_client_server_get(Ecore_Con_Client *cl)
 {
@@ -1085,7 +1179,12 @@ ecore_con_event_server_data(Ecore_Con_Server *svr, unsigned char *buf, int num,
    Ecore_Con_Event_Server_Data *e;
 
    e = ecore_con_event_server_data_alloc();
-   EINA_SAFETY_ON_NULL_RETURN(e);
+   if (!e)
+     {
+        ERR("server data event allocation failure !");
+        if (!duplicate) free(buf);
+        return;
+     }
 
    svr->event_count = eina_list_append(svr->event_count, e);
    _ecore_con_server_timer_update(svr);
@@ -1172,7 +1271,12 @@ ecore_con_event_client_data(Ecore_Con_Client *cl, unsigned char *buf, int num, E
    Ecore_Con_Event_Client_Data *e;
 
    e = ecore_con_event_client_data_alloc();
-   EINA_SAFETY_ON_NULL_RETURN(e);
+   if (!e)
+     {
+        ERR("client data event allocation failure !");
+        if (!duplicate) free(buf);
+        return;
+     }
 
    cl->event_count = eina_list_append(cl->event_count, e);
    cl->host_server->event_count = eina_list_append(cl->host_server->event_count, e);
@@ -1251,7 +1355,7 @@ _ecore_con_server_free(Ecore_Con_Server *svr)
      }
 
    t_start = ecore_time_get();
-   while (svr->buf && (!svr->delete_me))
+   while ((svr->buf || svr->send_segs) && (!svr->delete_me))
      {
         _ecore_con_server_flush(svr);
         t = ecore_time_get();
@@ -1273,6 +1377,7 @@ _ecore_con_server_free(Ecore_Con_Server *svr)
 
    if (svr->buf)
      eina_binbuf_free(svr->buf);
+   _ecore_con_send_segments_free(&svr->send_segs);
 
    EINA_LIST_FREE(svr->clients, cl)
      {
@@ -1321,7 +1426,7 @@ _ecore_con_client_free(Ecore_Con_Client *cl)
    if (cl->event_count) return;
 
    t_start = ecore_time_get();
-   while ((cl->buf) && (!cl->delete_me))
+   while ((cl->buf || cl->send_segs) && (!cl->delete_me))
      {
         _ecore_con_client_flush(cl);
         t = ecore_time_get();
@@ -1345,6 +1450,7 @@ _ecore_con_client_free(Ecore_Con_Client *cl)
    ECORE_MAGIC_SET(cl, ECORE_MAGIC_NONE);
 
    if (cl->buf) eina_binbuf_free(cl->buf);
+   _ecore_con_send_segments_free(&cl->send_segs);
 
    if (cl->host_server->type & ECORE_CON_SSL)
      ecore_con_ssl_client_shutdown(cl);
@@ -1862,7 +1968,7 @@ svr_try_connect_plain(Ecore_Con_Server *svr)
 
    if (svr->fd_handler)
      {
-        if (svr->buf)
+        if ((svr->buf) || (svr->send_segs))
           ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_WRITE);
         else
           ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_READ);
@@ -2002,12 +2108,34 @@ error:
    return ECORE_CALLBACK_RENEW;
 }
 
+/* Stream data is read straight into the buffer given to the data event,
+ * which takes it over, so it is never copied. The buffers grow while reads
+ * fill them and shrink back when they do not, and a socket is read until
+ * it is drained, up to READ_DRAIN_MAX times per wake up. */
+static int
+_ecore_con_read_size_next(int size, int num)
+{
+   if ((num == size) && (size < READBUFSIZ_MAX)) return size * 2;
+   if ((num < size / 4) && (size > READBUFSIZ)) return size / 2;
+   return size;
+}
+
+static unsigned char *
+_ecore_con_read_buf_trim(unsigned char *buf, int size, int num)
+{
+   unsigned char *tmp;
+
+   if (num >= size / 2) return buf;
+   tmp = realloc(buf, num);
+   return tmp ? tmp : buf;
+}
+
 static void
 _ecore_con_cl_read(Ecore_Con_Server *svr)
 {
-   int num = 0;
+   int num = 0, size, reads = 0;
    Eina_Bool lost_server = EINA_TRUE;
-   unsigned char buf[READBUFSIZ];
+   unsigned char *buf;
 
    DBG("svr=%p", svr);
 
@@ -2023,31 +2151,52 @@ _ecore_con_cl_read(Ecore_Con_Server *svr)
         _ecore_con_server_timer_update(svr);
      }
 
-   if (svr->ecs_state || !(svr->type & ECORE_CON_SSL))
-     {
-        errno = 0;
-        num = read(svr->fd, buf, sizeof(buf));
-        /* 0 is not a valid return value for a tcp socket */
-        if ((num > 0) || ((num < 0) && (errno == EAGAIN)))
-          lost_server = EINA_FALSE;
-        else if (num < 0)
-          ecore_con_event_server_error(svr, strerror(errno));
-     }
-   else
+   if (!svr->read_size) svr->read_size = READBUFSIZ;
+   do
      {
-        num = ecore_con_ssl_server_read(svr, buf, sizeof(buf));
-        /* this is not an actual 0 return, 0 here just means non-fatal error such as EAGAIN */
-        if (num >= 0)
-          lost_server = EINA_FALSE;
-     }
+        if (reads) lost_server = EINA_TRUE;
+        size = svr->read_size;
+        buf = malloc(size);
+        if (!buf)
+          {
+             ERR("server data allocation failure !");
+             return;
+          }
 
-   if ((!svr->delete_me) && (num > 0))
-     {
-        if (svr->ecs_state)
-          ecore_con_socks_read(svr, buf, num);
+        if (svr->ecs_state || !(svr->type & ECORE_CON_SSL))
+          {
+             errno = 0;
+             num = read(svr->fd, buf, size);
+             /* 0 is not a valid return value for a tcp socket */
+             if ((num > 0) || ((num < 0) && (errno == EAGAIN)))
+               lost_server = EINA_FALSE;
+             else if (num < 0)
+               ecore_con_event_server_error(svr, strerror(errno));
+          }
+        else
+          {
+             num = ecore_con_ssl_server_read(svr, buf, size);
+             /* this is not an actual 0 return, 0 here just means non-fatal error such as EAGAIN */
+             if (num >= 0)
+               lost_server = EINA_FALSE;
+          }
+
+        if ((!svr->delete_me) && (num > 0))
+          {
+             if (svr->ecs_state)
+               {
+                  ecore_con_socks_read(svr, buf, num);
+                  free(buf);
+               }
+             else
+               ecore_con_event_server_data(svr, _ecore_con_read_buf_trim(buf, size, num), num, EINA_FALSE);
+             svr->read_size = _ecore_con_read_size_next(size, num);
+          }
         else
-          ecore_con_event_server_data(svr, buf, num, EINA_TRUE);
+          free(buf);
      }
+   while ((!lost_server) && (num == size) && (!svr->ecs_state) &&
+          (!svr->delete_me) && (++reads < READ_DRAIN_MAX));
 
    if (lost_server)
      _ecore_con_server_kill(svr);
@@ -2220,9 +2369,9 @@ _ecore_con_svr_udp_handler(void *data,
 static void
 _ecore_con_svr_cl_read(Ecore_Con_Client *cl)
 {
-   int num = 0;
+   int num = 0, size, reads = 0;
    Eina_Bool lost_client = EINA_TRUE;
-   unsigned char buf[READBUFSIZ];
+   unsigned char *buf;
 
    DBG("cl=%p", cl);
 
@@ -2237,25 +2386,45 @@ _ecore_con_svr_cl_read(Ecore_Con_Client *cl)
         _ecore_con_cl_timer_update(cl);
      }
 
-   if (!(cl->host_server->type & ECORE_CON_SSL) && (!cl->upgrade))
-     {
-        num = read(cl->fd, buf, sizeof(buf));
-        /* 0 is not a valid return value for a tcp socket */
-        if ((num > 0) || ((num < 0) && ((errno == EAGAIN) || (errno == EINTR))))
-          lost_client = EINA_FALSE;
-        else if (num < 0)
-          ecore_con_event_client_error(cl, strerror(errno));
-     }
-   else
+   if (!cl->read_size) cl->read_size = READBUFSIZ;
+   do
      {
-        num = ecore_con_ssl_client_read(cl, buf, sizeof(buf));
-        /* this is not an actual 0 return, 0 here just means non-fatal error such as EAGAIN */
-        if (num >= 0)
-          lost_client = EINA_FALSE;
-     }
+        if (reads) lost_client = EINA_TRUE;
+        size = cl->read_size;
+        buf = malloc(size);
+        if (!buf)
+          {
+             ERR("client data allocation failure !");
+             return;
+          }
 
-   if ((!cl->delete_me) && (num > 0))
-     ecore_con_event_client_data(cl, buf, num, EINA_TRUE);
+        if (!(cl->host_server->type & ECORE_CON_SSL) && (!cl->upgrade))
+          {
+             num = read(cl->fd, buf, size);
+             /* 0 is not a valid return value for a tcp socket */
+             if ((num > 0) || ((num < 0) && ((errno == EAGAIN) || (errno == EINTR))))
+               lost_client = EINA_FALSE;
+             else if (num < 0)
+               ecore_con_event_client_error(cl, strerror(errno));
+          }
+        else
+          {
+             num = ecore_con_ssl_client_read(cl, buf, size);
+             /* this is not an actual 0 return, 0 here just means non-fatal error such as EAGAIN */
+             if (num >= 0)
+               lost_client = EINA_FALSE;
+          }
+
+        if ((!cl->delete_me) && (num > 0))
+          {
+             ecore_con_event_client_data(cl, _ecore_con_read_buf_trim(buf, size, num), num, EINA_FALSE);
+             cl->read_size = _ecore_con_read_size_next(size, num);
+          }
+        else
+          free(buf);
+     }
+   while ((!lost_client) && (num == size) && (!cl->delete_me) &&
+          (++reads < READ_DRAIN_MAX));
 
    if (lost_client) _ecore_con_client_kill(cl);
 }
@@ -2290,15 +2459,168 @@ _ecore_con_svr_cl_handler(void *data,
    return ECORE_CALLBACK_RENEW;
 }
 
+/* What is sent is queued as a list of segments followed by the buffer the
+ * data given to ecore_con_*_send() is copied to. Segments are the data of
+ * ecore_con_*_send_segment(), or a copy buffer that was closed because a
+ * segment was queued after it, and as much of the queue as possible is
+ * written with a single writev(). */
+static void
+_ecore_con_send_segment_buf_free(void *data EINA_UNUSED, const void *buf)
+{
+   free((void *)buf);
+}
+
+static Eina_Bool
+_ecore_con_send_segment_append(Eina_Inlist **segs,
+                               Eina_Binbuf **buf,
+                               size_t *buf_offset,
+                               const void *data,
+                               size_t size,
+                               Ecore_Con_Send_Free_Cb free_cb,
+                               const void *free_data)
+{
+   Ecore_Con_Send_Segment *seg, *copy = NULL;
+
+   if ((*buf) && (*buf_offset < eina_binbuf_length_get(*buf)))
+     {
+        copy = calloc(1, sizeof(Ecore_Con_Send_Segment));
+        if (!copy) return EINA_FALSE;
+     }
+   seg = calloc(1, sizeof(Ecore_Con_Send_Segment));
+   if (!seg)
+     {
+        free(copy);
+        return EINA_FALSE;
+     }
+
+   if (copy)
+     {
+        copy->size = eina_binbuf_length_get(*buf);
+        copy->offset = *buf_offset;
+        copy->data = eina_binbuf_string_steal(*buf);
+        copy->free_cb = _ecore_con_send_segment_buf_free;
+        *segs = eina_inlist_append(*segs, EINA_INLIST_GET(copy));
+     }
+   if (*buf)
+     {
+        eina_binbuf_free(*buf);
+        *buf = NULL;
+        *buf_offset = 0;
+     }
+
+   seg->data = data;
+   seg->size = size;
+   seg->free_cb = free_cb;
+   seg->free_data = free_data;
+   *segs = eina_inlist_append(*segs, EINA_INLIST_GET(seg));
+   return EINA_TRUE;
+}
+
+static void
+_ecore_con_send_segments_free(Eina_Inlist **segs)
+{
+   Ecore_Con_Send_Segment *seg;
+
+   while (*segs)
+     {
+        seg = EINA_INLIST_CONTAINER_GET(*segs, Ecore_Con_Send_Segment);
+        *segs = eina_inlist_remove(*segs, *segs);
+        if (seg->free_cb) seg->free_cb((void *)seg->free_data, seg->data);
+        free(seg);
+     }
+}
+
+static int
+_ecore_con_send_iov_get(Eina_Inlist *segs,
+                        Eina_Binbuf *buf,
+                        size_t buf_offset,
+                        Ecore_Con_Iovec *iov,
+                        size_t *num)
+{
+   Ecore_Con_Send_Segment *seg;
+   int n = 0;
+
+   *num = 0;
+   EINA_INLIST_FOREACH(segs, seg)
+     {
+        if (n == SEND_IOV_MAX) return n;
+        iov[n].iov_base = (void *)(seg->data + seg->offset);
+        iov[n].iov_len = seg->size - seg->offset;
+        *num += iov[n].iov_len;
+        n++;
+     }
+   if ((buf) && (n < SEND_IOV_MAX))
+     {
+        iov[n].iov_base = (void *)(eina_binbuf_string_get(buf) + buf_offset);
+        iov[n].iov_len = eina_binbuf_length_get(buf) - buf_offset;
+        *num += iov[n].iov_len;
+        n++;
+     }
+   return n;
+}
+
+static int
+_ecore_con_send_writev(int fd, const Ecore_Con_Iovec *iov, int n)
+{
+#ifdef HAVE_SYS_UIO_H
+   if (n > 1) return writev(fd, iov, n);
+#endif
+   return write(fd, iov[0].iov_base, iov[0].iov_len);
+}
+
+/* drops what was written from the queue, returns EINA_TRUE once it is
+ * empty. The segments are released last, as their free callback may well
+ * queue more data. */
+static Eina_Bool
+_ecore_con_send_consume(Eina_Inlist **segs,
+                        Eina_Binbuf **buf,
+                        size_t *buf_offset,
+                        size_t count)
+{
+   Ecore_Con_Send_Segment *seg;
+   Eina_Inlist *done = NULL;
+
+   while (*segs)
+     {
+        seg = EINA_INLIST_CONTAINER_GET(*segs, Ecore_Con_Send_Segment);
+        if (count < seg->size - seg->offset)
+          {
+             seg->offset += count;
+             count = 0;
+             break;
+          }
+        count -= seg->size - seg->offset;
+        *segs = eina_inlist_remove(*segs, *segs);
+        done = eina_inlist_append(done, EINA_INLIST_GET(seg));
+     }
+
+   if ((!*segs) && (*buf))
+     {
+        *buf_offset += count;
+        if (*buf_offset >= eina_binbuf_length_get(*buf))
+          {
+             eina_binbuf_free(*buf);
+             *buf = NULL;
+             *buf_offset = 0;
+          }
+        /* do not keep what was written of a buffer still appended to */
+        else if ((*buf_offset > eina_binbuf_length_get(*buf) / 2) &&
+                 (eina_binbuf_remove(*buf, 0, *buf_offset)))
+          *buf_offset = 0;
+     }
+
+   _ecore_con_send_segments_free(&done);
+   /* what the callbacks queued is to be written too */
+   return (!*segs) && (!*buf);
+}
+
 static void
 _ecore_con_server_flush(Ecore_Con_Server *svr)
 {
-   int count;
+   Ecore_Con_Iovec iov[SEND_IOV_MAX];
+   int count, n;
    size_t num;
-   size_t buf_len;
-   size_t *buf_offset;
-   const unsigned char *buf;
-   Eina_Binbuf *buf_p;
+   Eina_Bool ecs;
 
    DBG("(svr=%p,buf=%p)", svr, svr->buf);
    if (!svr->fd_handler) return;
@@ -2307,25 +2629,23 @@ _ecore_con_server_flush(Ecore_Con_Server *svr)
      return;
 #endif
 
-   if ((!svr->buf) && (!svr->ecs_buf))
+   if ((!svr->buf) && (!svr->send_segs) && (!svr->ecs_buf))
      {
         ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_READ);
         return;
      }
 
-   if (svr->buf)
-     {
-        buf_p = svr->buf;
-        buf_offset = &(svr->write_buf_offset);
-     }
+   ecs = (!svr->buf) && (!svr->send_segs);
+   if (!ecs)
+     n = _ecore_con_send_iov_get(svr->send_segs, svr->buf,
+                                 svr->write_buf_offset, iov, &num);
    else
      {
-        buf_p = svr->ecs_buf;
-        buf_offset = &(svr->ecs_buf_offset);
+        iov[0].iov_base = (void *)(eina_binbuf_string_get(svr->ecs_buf) + svr->ecs_buf_offset);
+        iov[0].iov_len = eina_binbuf_length_get(svr->ecs_buf) - svr->ecs_buf_offset;
+        num = iov[0].iov_len;
+        n = 1;
      }
-   buf = eina_binbuf_string_get(buf_p);
-   buf_len = eina_binbuf_length_get(buf_p);
-   num = buf_len - *buf_offset;
 
    /* check whether we need to write anything at all.
     * we must not write zero bytes with SSL_write() since it
@@ -2346,9 +2666,9 @@ _ecore_con_server_flush(Ecore_Con_Server *svr)
      }
 
    if (svr->ecs_state || (!(svr->type & ECORE_CON_SSL)))
-     count = write(svr->fd, buf + *buf_offset, num);
+     count = _ecore_con_send_writev(svr->fd, iov, n);
    else
-     count = ecore_con_ssl_server_write(svr, buf + *buf_offset, num);
+     count = ecore_con_ssl_server_write(svr, iov[0].iov_base, iov[0].iov_len);
 
    if (count < 0)
      {
@@ -2362,48 +2682,49 @@ _ecore_con_server_flush(Ecore_Con_Server *svr)
 
    if (count && (!svr->ecs_state)) ecore_con_event_server_write(svr, count);
 
-   if (!eina_binbuf_remove(buf_p, 0, count))
-     *buf_offset += count;
-   else
+   if (ecs)
      {
-        *buf_offset = 0;
-        buf_len -= count;
+        svr->ecs_buf_offset += count;
+        if (svr->ecs_buf_offset < eina_binbuf_length_get(svr->ecs_buf))
+          {
+             if (svr->fd_handler)
+               ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_WRITE);
+             return;
+          }
+        svr->ecs_buf_offset = 0;
+        eina_binbuf_free(svr->ecs_buf);
+        svr->ecs_buf = NULL;
+        INF("PROXY STATE++");
+        svr->ecs_state++;
      }
-   if (*buf_offset >= buf_len)
+   else
      {
-        *buf_offset = 0;
-        eina_binbuf_free(buf_p);
-
-        if (svr->ecs_buf)
+        if (!_ecore_con_send_consume(&svr->send_segs, &svr->buf,
+                                     &svr->write_buf_offset, count))
           {
-             svr->ecs_buf = NULL;
-             INF("PROXY STATE++");
-             svr->ecs_state++;
+             if (svr->fd_handler)
+               ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_WRITE);
+             return;
           }
-        else
-          {
-             svr->buf = NULL;
 #ifdef TCP_CORK
-             if ((svr->type & ECORE_CON_TYPE) == ECORE_CON_REMOTE_CORK)
-               {
-                  int state = 0;
-                  if (setsockopt(svr->fd, IPPROTO_TCP, TCP_CORK, (char *)&state, sizeof(int)) < 0)
-                    /* realistically this isn't anything serious so we can just log and continue */
-                    ERR("uncorking failed! %s", strerror(errno));
-               }
-#endif
+        if ((svr->type & ECORE_CON_TYPE) == ECORE_CON_REMOTE_CORK)
+          {
+             int state = 0;
+             if (setsockopt(svr->fd, IPPROTO_TCP, TCP_CORK, (char *)&state, sizeof(int)) < 0)
+               /* realistically this isn't anything serious so we can just log and continue */
+               ERR("uncorking failed! %s", strerror(errno));
           }
-        if (svr->fd_handler)
-          ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_READ);
+#endif
      }
-   else if (((unsigned int)count < num) && svr->fd_handler)
-     ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_WRITE);
+   if (svr->fd_handler)
+     ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_READ);
 }
 
 static void
 _ecore_con_client_flush(Ecore_Con_Client *cl)
 {
-   int count = 0;
+   Ecore_Con_Iovec iov[SEND_IOV_MAX];
+   int count = 0, n;
    size_t num = 0;
 
    if (!cl->fd_handler) return;
@@ -2412,7 +2733,7 @@ _ecore_con_client_flush(Ecore_Con_Client *cl)
      return;
 #endif
 
-   if (!cl->buf)
+   if ((!cl->buf) && (!cl->send_segs))
      {
         ecore_main_fd_handler_active_set(cl->fd_handler, ECORE_FD_READ);
         return;
@@ -2428,13 +2749,14 @@ _ecore_con_client_flush(Ecore_Con_Client *cl)
 
    if (!count)
      {
-        if (!cl->buf) return;
-        num = eina_binbuf_length_get(cl->buf) - cl->buf_offset;
+        if ((!cl->buf) && (!cl->send_segs)) return;
+        n = _ecore_con_send_iov_get(cl->send_segs, cl->buf, cl->buf_offset,
+                                    iov, &num);
         if (num <= 0) return;
         if (!(cl->host_server->type & ECORE_CON_SSL) && (!cl->upgrade))
-          count = write(cl->fd, eina_binbuf_string_get(cl->buf) + cl->buf_offset, num);
+          count = _ecore_con_send_writev(cl->fd, iov, n);
         else
-          count = ecore_con_ssl_client_write(cl, eina_binbuf_string_get(cl->buf) + cl->buf_offset, num);
+          count = ecore_con_ssl_client_write(cl, iov[0].iov_base, iov[0].iov_len);
      }
 
    if (count < 0)
@@ -2449,12 +2771,8 @@ _ecore_con_client_flush(Ecore_Con_Client *cl)
      }
 
    if (count) ecore_con_event_client_write(cl, count);
-   cl->buf_offset += count, num -= count;
-   if (cl->buf_offset >= eina_binbuf_length_get(cl->buf))
+   if (_ecore_con_send_consume(&cl->send_segs, &cl->buf, &cl->buf_offset, count))
      {
-        cl->buf_offset = 0;
-        eina_binbuf_free(cl->buf);
-        cl->buf = NULL;
 #ifdef TCP_CORK
         if ((cl->host_server->type & ECORE_CON_TYPE) == ECORE_CON_REMOTE_CORK)
           {
@@ -19,6 +19,10 @@
 #endif
 
 #define READBUFSIZ 65536
+#define READBUFSIZ_MAX (1024 * 1024)
+#define READ_DRAIN_MAX 16
+#define SEND_SEGMENT_MIN 4096
+#define SEND_IOV_MAX 64
 
 extern int _ecore_con_log_dom;
 
@@ -94,6 +98,18 @@ typedef enum Ecore_Con_Proxy_State
    ECORE_CON_PROXY_STATE_CONFIRM,
 } Ecore_Con_Proxy_State;
 
+typedef struct _Ecore_Con_Send_Segment Ecore_Con_Send_Segment;
+
+struct _Ecore_Con_Send_Segment
+{
+   EINA_INLIST;
+   const unsigned char *data;
+   size_t size;
+   size_t offset; /* already written */
+   Ecore_Con_Send_Free_Cb free_cb;
+   const void *free_data;
+};
+
 struct _Ecore_Con_Client
 {
    ECORE_MAGIC;
@@ -103,6 +119,7 @@ struct _Ecore_Con_Client
    Ecore_Fd_Handler *fd_handler;
    size_t buf_offset;
    Eina_Binbuf *buf;
+   Eina_Inlist *send_segs; /* queued before buf */
    const char *ip;
    Eina_List *event_count;
    struct sockaddr *client_addr;
@@ -110,6 +127,7 @@ struct _Ecore_Con_Client
    double start_time;
    Ecore_Timer *until_deletion;
    double disconnect_time;
+   int read_size; /* size of the next read buffer */
 #if HAVE_GNUTLS
    gnutls_datum_t session_ticket;
    gnutls_session_t session;
@@ -137,6 +155,7 @@ struct _Ecore_Con_Server
    unsigned int client_count;
    Eina_Binbuf *buf;
    size_t write_buf_offset;
+   Eina_Inlist *send_segs; /* queued before buf */
    Eina_List *infos;
    Eina_List *event_count;
    int client_limit;
@@ -172,6 +191,7 @@ struct _Ecore_Con_Server
    double disconnect_time;
    double client_disconnect_time;
    const char *ip;
+   int read_size; /* size of the next read buffer */
    Eina_Bool created : 1; /* @c EINA_TRUE if server is our listening server */
    Eina_Bool connecting : 1; /* @c EINA_FALSE if just initialized or connected */
    Eina_Bool handshaking : 1; /* @c EINA_TRUE if server is ssl handshaking */
@@ -276,7 +276,8 @@ _ecore_con_socks_read_v4(Ecore_Con_Server *svr, Ecore_Con_Socks_v4 *v4 EINA_UNUS
    memset(svr->ecs_addr, 0, sizeof(svr->ecs_addr));
    if (!svr->ssl_state)
      ecore_con_event_server_add(svr);
-   if (svr->ssl_state || (svr->buf && eina_binbuf_length_get(svr->buf)))
+   if (svr->ssl_state || svr->send_segs ||
+       (svr->buf && eina_binbuf_length_get(svr->buf)))
      ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_READ | ECORE_FD_WRITE);
    return;
 error:
@@ -506,7 +507,8 @@ _ecore_con_socks_read_v5(Ecore_Con_Server *svr, Ecore_Con_Socks_v5 *v5, const un
          memset(svr->ecs_addr, 0, sizeof(svr->ecs_addr));
          if (!svr->ssl_state)
            ecore_con_event_server_add(svr);
-         if (svr->ssl_state || (svr->buf && eina_binbuf_length_get(svr->buf)))
+         if (svr->ssl_state || svr->send_segs ||
+             (svr->buf && eina_binbuf_length_get(svr->buf)))
            ecore_main_fd_handler_active_set(svr->fd_handler, ECORE_FD_READ | ECORE_FD_WRITE);
          svr->ecs_buf_offset = svr->ecs_addrlen = 0;
          svr->ecs_state = ECORE_CON_PROXY_STATE_DONE;
@@ -41,6 +41,14 @@ extern "C" {
 typedef struct _Ecore_Ipc_Server Ecore_Ipc_Server; /**< An IPC connection handle */
 typedef struct _Ecore_Ipc_Client Ecore_Ipc_Client; /**< An IPC connection handle */
 
+/**
+ * @typedef Ecore_Ipc_Send_Free_Cb
+ * Called when the data given to ecore_ipc_server_send_segment() or
+ * ecore_ipc_client_send_segment() is no longer used.
+ * @since 1.10
+ */
+typedef void (*Ecore_Ipc_Send_Free_Cb)(void *data, const void *buf);
+
 EAPI unsigned short     _ecore_ipc_swap_16(unsigned short v) EINA_DEPRECATED;
 EAPI unsigned int       _ecore_ipc_swap_32(unsigned int v) EINA_DEPRECATED;
 EAPI unsigned long long _ecore_ipc_swap_64(unsigned long long v) EINA_DEPRECATED;
@@ -300,6 +308,7 @@ EAPI Eina_Bool         ecore_ipc_server_connected_get(Ecore_Ipc_Server *svr);
 EAPI Eina_List        *ecore_ipc_server_clients_get(Ecore_Ipc_Server *svr);
 /* FIXME: this needs to become an ipc message */
 EAPI int               ecore_ipc_server_send(Ecore_Ipc_Server *svr, int major, int minor, int ref, int ref_to, int response, const void *data, int size);
+EAPI int               ecore_ipc_server_send_segment(Ecore_Ipc_Server *svr, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data);
 EAPI void              ecore_ipc_server_client_limit_set(Ecore_Ipc_Server *svr, int client_limit, char reject_excess_clients);
 EAPI void              ecore_ipc_server_data_size_max_set(Ecore_Ipc_Server *srv, int size);
 EAPI int               ecore_ipc_server_data_size_max_get(Ecore_Ipc_Server *srv);
@@ -308,6 +317,7 @@ EAPI void              ecore_ipc_server_flush(Ecore_Ipc_Server *svr);
     
 /* FIXME: this needs to become an ipc message */
 EAPI int               ecore_ipc_client_send(Ecore_Ipc_Client *cl, int major, int minor, int ref, int ref_to, int response, const void *data, int size);
+EAPI int               ecore_ipc_client_send_segment(Ecore_Ipc_Client *cl, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data);
 EAPI Ecore_Ipc_Server *ecore_ipc_client_server_get(Ecore_Ipc_Client *cl);
 EAPI void             *ecore_ipc_client_del(Ecore_Ipc_Client *cl);
 EAPI void              ecore_ipc_client_data_set(Ecore_Ipc_Client *cl, const void *data);
@@ -20,23 +20,6 @@
 #include "Ecore_Ipc.h"
 #include "ecore_ipc_private.h"
 
-#define DLT_ZERO   0
-#define DLT_ONE    1
-#define DLT_SAME   2
-#define DLT_SHL    3
-#define DLT_SHR    4
-#define DLT_ADD8   5
-#define DLT_DEL8   6
-#define DLT_ADDU8  7
-#define DLT_DELU8  8
-#define DLT_ADD16  9
-#define DLT_DEL16  10
-#define DLT_ADDU16 11
-#define DLT_DELU16 12
-#define DLT_SET    13
-#define DLT_R1     14
-#define DLT_R2     15
-
 int _ecore_ipc_log_dom = -1;
 
 /****** This swap function are around just for backward compatibility do not remove *******/
@@ -219,6 +202,8 @@ static void _ecore_ipc_event_client_data_free(void *data, void *ev);
 static void _ecore_ipc_event_server_add_free(void *data, void *ev);
 static void _ecore_ipc_event_server_del_free(void *data, void *ev);
 static void _ecore_ipc_event_server_data_free(void *data, void *ev);
+static int _ecore_ipc_server_send(Ecore_Ipc_Server *svr, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data, Eina_Bool segment);
+static int _ecore_ipc_client_send(Ecore_Ipc_Client *cl, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data, Eina_Bool segment);
 
 EAPI int ECORE_IPC_EVENT_CLIENT_ADD = 0;
 EAPI int ECORE_IPC_EVENT_CLIENT_DEL = 0;
@@ -465,7 +450,7 @@ ecore_ipc_server_del(Ecore_Ipc_Server *svr)
         if (svr->server) ecore_con_server_del(svr->server);
         servers = eina_list_remove(servers, svr);
 
-        if (svr->buf) free(svr->buf);
+        free(svr->reader.data);
         ECORE_MAGIC_SET(svr, ECORE_MAGIC_NONE);
         free(svr);
      }
@@ -580,17 +565,63 @@ ecore_ipc_server_clients_get(Ecore_Ipc_Server *svr)
 EAPI int
 ecore_ipc_server_send(Ecore_Ipc_Server *svr, int major, int minor, int ref, int ref_to, int response, const void *data, int size)
 {
-   Ecore_Ipc_Msg_Head msg;
-   int ret;
-   int *head, md = 0, d, s;
-   unsigned char dat[sizeof(Ecore_Ipc_Msg_Head)];
-
    if (!ECORE_MAGIC_CHECK(svr, ECORE_MAGIC_IPC_SERVER))
      {
         ECORE_MAGIC_FAIL(svr, ECORE_MAGIC_IPC_SERVER,
                          "ecore_ipc_server_send");
         return 0;
      }
+   return _ecore_ipc_server_send(svr, major, minor, ref, ref_to, response,
+                                 data, size, NULL, NULL, EINA_FALSE);
+}
+
+/**
+ * Sends a message to the given IPC server, without copying its data.
+ *
+ * This works like ecore_ipc_server_send(), but @p data is queued as it is
+ * and written from there, @p free_cb is called with @p free_data once it
+ * was sent or the connection is closed. Only the header of the message is
+ * copied, and it is written along with the data. Small messages are copied
+ * anyway, @p free_cb is then called before this function returns.
+ *
+ * @param   svr       The given IPC server.
+ * @param   major     Major opcode of the message.
+ * @param   minor     Minor opcode of the message.
+ * @param   ref       Message reference number.
+ * @param   ref_to    Reference number of the message this message refers to.
+ * @param   response  Requires response.
+ * @param   data      The data to send as part of the message.
+ * @param   size      Length of the data, in bytes, to send.
+ * @param   free_cb   The function called when @p data is no longer used,
+ *                    or @c NULL.
+ * @param   free_data The data given to @p free_cb.
+ * @return  Number of bytes sent.  @c 0 is returned if there is an error,
+ *          @p data then still belongs to the caller and @p free_cb is
+ *          not called.
+ * @ingroup Ecore_IPC_Server_Group
+ * @since 1.10
+ */
+EAPI int
+ecore_ipc_server_send_segment(Ecore_Ipc_Server *svr, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data)
+{
+   if (!ECORE_MAGIC_CHECK(svr, ECORE_MAGIC_IPC_SERVER))
+     {
+        ECORE_MAGIC_FAIL(svr, ECORE_MAGIC_IPC_SERVER,
+                         "ecore_ipc_server_send_segment");
+        return 0;
+     }
+   return _ecore_ipc_server_send(svr, major, minor, ref, ref_to, response,
+                                 data, size, free_cb, free_data, EINA_TRUE);
+}
+
+static int
+_ecore_ipc_server_send(Ecore_Ipc_Server *svr, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data, Eina_Bool segment)
+{
+   Ecore_Ipc_Msg_Head msg;
+   int ret, sent;
+   int *head, md = 0, d, s;
+   unsigned char dat[sizeof(Ecore_Ipc_Msg_Head)];
+
    if (size < 0) size = 0;
    msg.major    = major;
    msg.minor    = minor;
@@ -613,10 +644,27 @@ ecore_ipc_server_send(Ecore_Ipc_Server *svr, int major, int minor, int ref, int
    SVENC(size);
    *head |= md << (4 * 5);
    *head = htonl(*head);
-   svr->prev.o = msg;
    ret = ecore_con_server_send(svr->server, dat, s);
-   if (size > 0) ret += ecore_con_server_send(svr->server, data, size);
-   return ret;
+   if (!ret) return 0;
+   /* the header is queued, the next one is encoded against it */
+   svr->prev.o = msg;
+   if (size <= 0)
+     {
+        if ((segment) && (free_cb)) free_cb((void *)free_data, data);
+        return ret;
+     }
+   sent = 0;
+   if (segment)
+     sent = ecore_con_server_send_segment(svr->server, data, size,
+                                          free_cb, free_data);
+   /* the header can't be taken back, the data has to follow it */
+   if (!sent)
+     {
+        sent = ecore_con_server_send(svr->server, data, size);
+        if ((sent) && (segment) && (free_cb))
+          free_cb((void *)free_data, data);
+     }
+   return ret + sent;
 }
 
 /**
@@ -789,17 +837,63 @@ ecore_ipc_server_flush(Ecore_Ipc_Server *svr)
 EAPI int
 ecore_ipc_client_send(Ecore_Ipc_Client *cl, int major, int minor, int ref, int ref_to, int response, const void *data, int size)
 {
-   Ecore_Ipc_Msg_Head msg;
-   int ret;
-   int *head, md = 0, d, s;
-   unsigned char dat[sizeof(Ecore_Ipc_Msg_Head)];
-
    if (!ECORE_MAGIC_CHECK(cl, ECORE_MAGIC_IPC_CLIENT))
      {
         ECORE_MAGIC_FAIL(cl, ECORE_MAGIC_IPC_CLIENT,
                          "ecore_ipc_client_send");
         return 0;
      }
+   return _ecore_ipc_client_send(cl, major, minor, ref, ref_to, response,
+                                 data, size, NULL, NULL, EINA_FALSE);
+}
+
+/**
+ * Sends a message to the given IPC client, without copying its data.
+ *
+ * This works like ecore_ipc_client_send(), but @p data is queued as it is
+ * and written from there, @p free_cb is called with @p free_data once it
+ * was sent or the connection is closed. When the same data is sent to
+ * several clients, @p free_cb is called once for each of them.
+ *
+ * @param   cl        The given IPC client.
+ * @param   major     Major opcode of the message.
+ * @param   minor     Minor opcode of the message.
+ * @param   ref       Reference number of the message.
+ * @param   ref_to    Reference number of the message this message refers to.
+ * @param   response  Requires response.
+ * @param   data      The data to send as part of the message.
+ * @param   size      Length of the data, in bytes, to send.
+ * @param   free_cb   The function called when @p data is no longer used,
+ *                    or @c NULL.
+ * @param   free_data The data given to @p free_cb.
+ * @return  The number of bytes sent.  @c 0 will be returned if there is
+ *          an error, @p data then still belongs to the caller and
+ *          @p free_cb is not called.
+ * @ingroup Ecore_IPC_Client_Group
+ * @see ecore_ipc_server_send_segment()
+ * @since 1.10
+ */
+EAPI int
+ecore_ipc_client_send_segment(Ecore_Ipc_Client *cl, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data)
+{
+   if (!ECORE_MAGIC_CHECK(cl, ECORE_MAGIC_IPC_CLIENT))
+     {
+        ECORE_MAGIC_FAIL(cl, ECORE_MAGIC_IPC_CLIENT,
+                         "ecore_ipc_client_send_segment");
+        return 0;
+     }
+   return _ecore_ipc_client_send(cl, major, minor, ref, ref_to, response,
+                                 data, size, free_cb, free_data, EINA_TRUE);
+}
+
+static int
+_ecore_ipc_client_send(Ecore_Ipc_Client *cl, int major, int minor, int ref, int ref_to, int response, const void *data, int size, Ecore_Ipc_Send_Free_Cb free_cb, const void *free_data, Eina_Bool segment)
+{
+   Ecore_Ipc_Msg_Head msg;
+   int ret, sent;
+   int *head, md = 0, d, s;
+   unsigned char dat[sizeof(Ecore_Ipc_Msg_Head)];
+
    EINA_SAFETY_ON_TRUE_RETURN_VAL(!cl->client, 0);
    EINA_SAFETY_ON_TRUE_RETURN_VAL(!ecore_con_client_connected_get(cl->client), 0);
    if (size < 0) size = 0;
@@ -824,10 +918,27 @@ ecore_ipc_client_send(Ecore_Ipc_Client *cl, int major, int minor, int ref, int r
    CLENC(size);
    *head |= md << (4 * 5);
    *head = htonl(*head);
-   cl->prev.o = msg;
    ret = ecore_con_client_send(cl->client, dat, s);
-   if (size > 0) ret += ecore_con_client_send(cl->client, data, size);
-   return ret;
+   if (!ret) return 0;
+   /* the header is queued, the next one is encoded against it */
+   cl->prev.o = msg;
+   if (size <= 0)
+     {
+        if ((segment) && (free_cb)) free_cb((void *)free_data, data);
+        return ret;
+     }
+   sent = 0;
+   if (segment)
+     sent = ecore_con_client_send_segment(cl->client, data, size,
+                                          free_cb, free_data);
+   /* the header can't be taken back, the data has to follow it */
+   if (!sent)
+     {
+        sent = ecore_con_client_send(cl->client, data, size);
+        if ((sent) && (segment) && (free_cb))
+          free_cb((void *)free_data, data);
+     }
+   return ret + sent;
 }
 
 /**
@@ -876,7 +987,7 @@ ecore_ipc_client_del(Ecore_Ipc_Client *cl)
         svr = cl->svr;
         if (cl->client) ecore_con_client_del(cl->client);
         svr->clients = eina_list_remove(svr->clients, cl);
-        if (cl->buf) free(cl->buf);
+        free(cl->reader.data);
         ECORE_MAGIC_SET(cl, ECORE_MAGIC_NONE);
         free(cl);
      }
@@ -1142,46 +1253,152 @@ _ecore_ipc_event_server_del(void *data EINA_UNUSED, int ev_type EINA_UNUSED, voi
    return ECORE_CALLBACK_CANCEL;
 }
 
-#define CLSZ(_n) \
-   md = ((head >> (4 * _n)) & 0xf); \
-   if (md >= DLT_SET) s += 4; \
-   else if (md >= DLT_ADD16) s += 2; \
-   else if (md >= DLT_ADD8) s += 1;
+/* returns the size of the header at p, or 0 if n is too small to tell */
+static int
+_ecore_ipc_head_size(const unsigned char *p, int n)
+{
+   unsigned int head;
+   int s = 4, md, i;
 
-#define CLDEC(_n, _member) \
-   md = ((head >> (4 * _n)) & 0xf); \
-   if (md >= DLT_SET) \
-     { \
-        unsigned int v; \
-        unsigned char *dv; \
-        dv = (unsigned char *)&v; \
-        dv[0] = *(cl->buf + offset + s + 0); \
-        dv[1] = *(cl->buf + offset + s + 1); \
-        dv[2] = *(cl->buf + offset + s + 2); \
-        dv[3] = *(cl->buf + offset + s + 3); \
-        d = (int)ntohl(v); \
-        s += 4; \
-     } \
-   else if (md >= DLT_ADD16) \
-     { \
-        unsigned short v; \
-        unsigned char *dv; \
-        dv = (unsigned char *)&v; \
-        dv[0] = *(cl->buf + offset + s + 0); \
-        dv[1] = *(cl->buf + offset + s + 1); \
-        d = (int)ntohs(v); \
-        s += 2; \
-     } \
-   else if (md >= DLT_ADD8) \
-     { \
-        unsigned char v; \
-        unsigned char *dv; \
-        dv = (unsigned char *)&v; \
-        dv[0] = *(cl->buf + offset + s + 0); \
-        d = (int)v; \
-        s += 1; \
-     } \
-   msg._member = _ecore_ipc_ddlt_int(d, cl->prev.i._member, md);
+   if (n < 4) return 0;
+   memcpy(&head, p, 4);
+   head = ntohl(head);
+   for (i = 0; i < 6; i++)
+     {
+        md = (head >> (4 * i)) & 0xf;
+        if (md >= DLT_SET) s += 4;
+        else if (md >= DLT_ADD16) s += 2;
+        else if (md >= DLT_ADD8) s += 1;
+     }
+   return s;
+}
+
+static void
+_ecore_ipc_head_decode(const unsigned char *p, const Ecore_Ipc_Msg_Head *prev, Ecore_Ipc_Msg_Head *msg)
+{
+   unsigned int head, v;
+   unsigned short v16;
+   int in[6], out[6];
+   int s = 4, md, d, i;
+
+   in[0] = prev->major;
+   in[1] = prev->minor;
+   in[2] = prev->ref;
+   in[3] = prev->ref_to;
+   in[4] = prev->response;
+   in[5] = prev->size;
+   memcpy(&head, p, 4);
+   head = ntohl(head);
+   for (i = 0; i < 6; i++)
+     {
+        md = (head >> (4 * i)) & 0xf;
+        d = 0;
+        if (md >= DLT_SET)
+          {
+             memcpy(&v, p + s, 4);
+             d = (int)ntohl(v);
+             s += 4;
+          }
+        else if (md >= DLT_ADD16)
+          {
+             memcpy(&v16, p + s, 2);
+             d = (int)ntohs(v16);
+             s += 2;
+          }
+        else if (md >= DLT_ADD8)
+          {
+             d = (int)p[s];
+             s += 1;
+          }
+        out[i] = _ecore_ipc_ddlt_int(d, in[i], md);
+     }
+   msg->major    = out[0];
+   msg->minor    = out[1];
+   msg->ref      = out[2];
+   msg->ref_to   = out[3];
+   msg->response = out[4];
+   msg->size     = out[5];
+}
+
+/* Takes what it can of the size bytes at *p, advancing them, until a
+ * message is complete: it is then returned in msg with its data, which is
+ * the caller's. Messages larger than max are read through and skipped.
+ * Returns EINA_FALSE once all the bytes were used. */
+Eina_Bool
+_ecore_ipc_reader_next(Ecore_Ipc_Reader *rd, Ecore_Ipc_Msg_Head *prev, int max, const unsigned char **p, int *size, Ecore_Ipc_Msg_Head *msg, unsigned char **data)
+{
+   const unsigned char *head;
+   int s, n;
+
+   while ((*size > 0) || (rd->in_data))
+     {
+        if (!rd->in_data)
+          {
+             head = *p;
+             s = _ecore_ipc_head_size(*p, *size);
+             if ((rd->head_size > 0) || (!s) || (s > *size))
+               {
+                  /* the header is split between two events */
+                  if (rd->head_size < 4)
+                    {
+                       n = MIN(4 - rd->head_size, *size);
+                       memcpy(rd->head + rd->head_size, *p, n);
+                       rd->head_size += n;
+                       *p += n;
+                       *size -= n;
+                       if (rd->head_size < 4) return EINA_FALSE;
+                    }
+                  s = _ecore_ipc_head_size(rd->head, rd->head_size);
+                  n = MIN(s - rd->head_size, *size);
+                  memcpy(rd->head + rd->head_size, *p, n);
+                  rd->head_size += n;
+                  *p += n;
+                  *size -= n;
+                  if (rd->head_size < s) return EINA_FALSE;
+                  head = rd->head;
+                  rd->head_size = 0;
+               }
+             else
+               {
+                  *p += s;
+                  *size -= s;
+               }
+             _ecore_ipc_head_decode(head, prev, &rd->msg);
+             if (rd->msg.size < 0) rd->msg.size = 0;
+             *prev = rd->msg;
+
+             rd->in_data = EINA_TRUE;
+             rd->skip = ((max >= 0) && (rd->msg.size > max));
+             rd->data = NULL;
+             rd->data_size = 0;
+             if ((rd->msg.size > 0) && (!rd->skip))
+               {
+                  rd->data = malloc(rd->msg.size);
+                  if (!rd->data)
+                    {
+                       ERR("could not allocate %i bytes for a message",
+                           rd->msg.size);
+                       rd->skip = EINA_TRUE;
+                    }
+               }
+          }
+
+        n = MIN(rd->msg.size - rd->data_size, *size);
+        if (rd->data) memcpy(rd->data + rd->data_size, *p, n);
+        rd->data_size += n;
+        *p += n;
+        *size -= n;
+        if (rd->data_size < rd->msg.size) return EINA_FALSE;
+
+        rd->in_data = EINA_FALSE;
+        if (rd->skip) continue;
+        *msg = rd->msg;
+        *data = rd->data;
+        rd->data = NULL;
+        return EINA_TRUE;
+     }
+   return EINA_FALSE;
+}
 
 static Eina_Bool
 _ecore_ipc_event_client_data(void *data EINA_UNUSED, int ev_type EINA_UNUSED, void *ev)
@@ -1196,185 +1413,57 @@ _ecore_ipc_event_client_data(void *data EINA_UNUSED, int ev_type EINA_UNUSED, vo
      {
         Ecore_Ipc_Client *cl;
         Ecore_Ipc_Msg_Head msg;
-        int offset = 0;
+        const unsigned char *p = e->data;
+        int size = e->size;
         unsigned char *buf;
+        int max, max2;
 
         cl = ecore_con_client_data_get(e->client);
 
-        if (!cl->buf)
+        max = svr->max_buf_size;
+        max2 = cl->max_buf_size;
+        if ((max >= 0) && (max2 >= 0))
           {
-             cl->buf_size = e->size;
-             cl->buf = e->data;
-             e->data = NULL; /* take it out of the old event */
+             if (max2 < max) max = max2;
           }
         else
           {
-             buf = realloc(cl->buf, cl->buf_size + e->size);
-             if (!buf)
-               {
-                  free(cl->buf);
-                  cl->buf = 0;
-                  cl->buf_size  = 0;
-                  return ECORE_CALLBACK_CANCEL;
-               }
-             cl->buf = buf;
-             memcpy(cl->buf + cl->buf_size, e->data, e->size);
-             cl->buf_size += e->size;
+             if (max < 0) max = max2;
           }
-        /* examine header */
-        redo:
-        if ((cl->buf_size - offset) >= (int)sizeof(int))
+
+        while (_ecore_ipc_reader_next(&cl->reader, &cl->prev.i, max,
+                                      &p, &size, &msg, &buf))
           {
-             int s, md, d = 0, head;
-             unsigned char *dd;
-
-             dd = (unsigned char *)&head;
-             dd[0] = *(cl->buf + offset + 0);
-             dd[1] = *(cl->buf + offset + 1);
-             dd[2] = *(cl->buf + offset + 2);
-             dd[3] = *(cl->buf + offset + 3);
-             head = ntohl(head);
-             dd = (unsigned char *)&d;
-             s = 4;
-             CLSZ(0);
-             CLSZ(1);
-             CLSZ(2);
-             CLSZ(3);
-             CLSZ(4);
-             CLSZ(5);
-             if ((cl->buf_size - offset) < s)
-               {
-                  if (offset > 0) goto scroll;
-                  return ECORE_CALLBACK_CANCEL;
-               }
+             Ecore_Ipc_Event_Client_Data *e2;
 
-             s = 4;
-             CLDEC(0, major);
-             CLDEC(1, minor);
-             CLDEC(2, ref);
-             CLDEC(3, ref_to);
-             CLDEC(4, response);
-             CLDEC(5, size);
-             if (msg.size < 0) msg.size = 0;
-             /* there is enough data in the buffer for a full message */
-             if ((cl->buf_size - offset) >= (s + msg.size))
+             if (cl->delete_me)
                {
-                  Ecore_Ipc_Event_Client_Data *e2;
-                  int max, max2;
-
-                  buf = NULL;
-                  max = svr->max_buf_size;
-                  max2 = cl->max_buf_size;
-                  if ((max >= 0) && (max2 >= 0))
-                    {
-                       if (max2 < max) max = max2;
-                    }
-                  else
-                    {
-                       if (max < 0) max = max2;
-                    }
-                  if ((max < 0) || (msg.size <= max))
-                    {
-                       if (msg.size > 0)
-                         {
-                            buf = malloc(msg.size);
-                            if (!buf) return ECORE_CALLBACK_CANCEL;
-                            memcpy(buf, cl->buf + offset + s, msg.size);
-                         }
-                       if (!cl->delete_me)
-                         {
-                            e2 = calloc(1, sizeof(Ecore_Ipc_Event_Client_Data));
-                            if (e2)
-                              {
-                                 cl->event_count++;
-                                 e2->client   = cl;
-                                 e2->major    = msg.major;
-                                 e2->minor    = msg.minor;
-                                 e2->ref      = msg.ref;
-                                 e2->ref_to   = msg.ref_to;
-                                 e2->response = msg.response;
-                                 e2->size     = msg.size;
-                                 e2->data     = buf;
-                                 ecore_event_add(ECORE_IPC_EVENT_CLIENT_DATA, e2,
-                                                 _ecore_ipc_event_client_data_free,
-                                                 NULL);
-                              }
-                         }
-                    }
-                  cl->prev.i = msg;
-                  offset += (s + msg.size);
-                  if (cl->buf_size == offset)
-                    {
-                       free(cl->buf);
-                       cl->buf = NULL;
-                       cl->buf_size = 0;
-                       return ECORE_CALLBACK_CANCEL;
-                    }
-                  goto redo;
+                  free(buf);
+                  continue;
                }
-             else goto scroll;
-          }
-        else
-          {
-             scroll:
-             buf = malloc(cl->buf_size - offset);
-             if (!buf)
+             e2 = calloc(1, sizeof(Ecore_Ipc_Event_Client_Data));
+             if (!e2)
                {
-                  free(cl->buf);
-                  cl->buf = NULL;
-                  cl->buf_size = 0;
-                  return ECORE_CALLBACK_CANCEL;
+                  free(buf);
+                  continue;
                }
-             memcpy(buf, cl->buf + offset, cl->buf_size - offset);
-             free(cl->buf);
-             cl->buf = buf;
-             cl->buf_size -= offset;
+             cl->event_count++;
+             e2->client   = cl;
+             e2->major    = msg.major;
+             e2->minor    = msg.minor;
+             e2->ref      = msg.ref;
+             e2->ref_to   = msg.ref_to;
+             e2->response = msg.response;
+             e2->size     = msg.size;
+             e2->data     = buf;
+             ecore_event_add(ECORE_IPC_EVENT_CLIENT_DATA, e2,
+                             _ecore_ipc_event_client_data_free,
+                             NULL);
           }
      }
    return ECORE_CALLBACK_CANCEL;
 }
 
-#define SVSZ(_n) \
-   md = ((head >> (4 * _n)) & 0xf); \
-   if (md >= DLT_SET) s += 4; \
-   else if (md >= DLT_ADD16) s += 2; \
-   else if (md >= DLT_ADD8) s += 1;
-
-#define SVDEC(_n, _member) \
-   md = ((head >> (4 * _n)) & 0xf); \
-   if (md >= DLT_SET) \
-     { \
-        unsigned int v; \
-        unsigned char *dv; \
-        dv = (unsigned char *)&v; \
-        dv[0] = *(svr->buf + offset + s + 0); \
-        dv[1] = *(svr->buf + offset + s + 1); \
-        dv[2] = *(svr->buf + offset + s + 2); \
-        dv[3] = *(svr->buf + offset + s + 3); \
-        d = (int)ntohl(v); \
-        s += 4; \
-     } \
-   else if (md >= DLT_ADD16) \
-     { \
-        unsigned short v; \
-        unsigned char *dv; \
-        dv = (unsigned char *)&v; \
-        dv[0] = *(svr->buf + offset + s + 0); \
-        dv[1] = *(svr->buf + offset + s + 1); \
-        d = (int)ntohs(v); \
-        s += 2; \
-     } \
-   else if (md >= DLT_ADD8) \
-     { \
-        unsigned char v; \
-        unsigned char *dv; \
-        dv = (unsigned char *)&v; \
-        dv[0] = *(svr->buf + offset + s + 0); \
-        d = (int)v; \
-        s += 1; \
-     } \
-   msg._member = _ecore_ipc_ddlt_int(d, svr->prev.i._member, md);
-
 static Eina_Bool
 _ecore_ipc_event_server_data(void *data EINA_UNUSED, int ev_type EINA_UNUSED, void *ev)
 {
@@ -1387,149 +1476,41 @@ _ecore_ipc_event_server_data(void *data EINA_UNUSED, int ev_type EINA_UNUSED, vo
      {
         Ecore_Ipc_Server *svr;
         Ecore_Ipc_Msg_Head msg;
-        int offset = 0;
-        unsigned char *buf = NULL;
+        const unsigned char *p = e->data;
+        int size = e->size;
+        unsigned char *buf;
 
         svr = ecore_con_server_data_get(e->server);
 
-        if (!svr->buf)
-          {
-             svr->buf_size = e->size;
-             svr->buf = e->data;
-             e->data = NULL; /* take it out of the old event */
-          }
-        else
-          {
-             buf = realloc(svr->buf, svr->buf_size + e->size);
-             if (!buf)
-               {
-                  free(svr->buf);
-                  svr->buf = 0;
-                  svr->buf_size  = 0;
-                  return ECORE_CALLBACK_CANCEL;
-               }
-             svr->buf = buf;
-             memcpy(svr->buf + svr->buf_size, e->data, e->size);
-             svr->buf_size += e->size;
-          }
-        /* examine header */
-        redo:
-        if ((svr->buf_size - offset) >= (int)sizeof(int))
+        while (_ecore_ipc_reader_next(&svr->reader, &svr->prev.i,
+                                      svr->max_buf_size,
+                                      &p, &size, &msg, &buf))
           {
-             int s, md, d = 0, head;
-             unsigned char *dd;
-
-             dd = (unsigned char *)&head;
-             dd[0] = *(svr->buf + offset + 0);
-             dd[1] = *(svr->buf + offset + 1);
-             dd[2] = *(svr->buf + offset + 2);
-             dd[3] = *(svr->buf + offset + 3);
-             head = ntohl(head);
-             dd = (unsigned char *)&d;
-             s = 4;
-             SVSZ(0);
-             SVSZ(1);
-             SVSZ(2);
-             SVSZ(3);
-             SVSZ(4);
-             SVSZ(5);
-             if ((svr->buf_size - offset) < s)
-               {
-                  if (offset > 0) goto scroll;
-                  return ECORE_CALLBACK_CANCEL;
-               }
+             Ecore_Ipc_Event_Server_Data *e2;
 
-             s = 4;
-             SVDEC(0, major);
-             SVDEC(1, minor);
-             SVDEC(2, ref);
-             SVDEC(3, ref_to);
-             SVDEC(4, response);
-             SVDEC(5, size);
-             if (msg.size < 0) msg.size = 0;
-             /* there is enough data in the buffer for a full message */
-             if ((svr->buf_size - offset) >= (s + msg.size))
+             if (svr->delete_me)
                {
-                  Ecore_Ipc_Event_Server_Data *e2;
-                  int max;
-
-                  if (buf != svr->buf) free(buf);
-                  buf = NULL;
-                  max = svr->max_buf_size;
-                  if ((max < 0) || (msg.size <= max))
-                    {
-                       if (msg.size > 0)
-                         {
-                            buf = malloc(msg.size);
-                            if (!buf) return ECORE_CALLBACK_CANCEL;
-                            memcpy(buf, svr->buf + offset + s, msg.size);
-                         }
-                       if (!svr->delete_me)
-                         {
-                            e2 = calloc(1, sizeof(Ecore_Ipc_Event_Server_Data));
-                            if (e2)
-                              {
-                                 svr->event_count++;
-                                 e2->server   = svr;
-                                 e2->major    = msg.major;
-                                 e2->minor    = msg.minor;
-                                 e2->ref      = msg.ref;
-                                 e2->ref_to   = msg.ref_to;
-                                 e2->response = msg.response;
-                                 e2->size     = msg.size;
-                                 e2->data     = buf;
-                                 if (buf == svr->buf)
-                                   {
-                                      svr->buf = NULL;
-                                      svr->buf_size = 0;
-                                   }
-                                 buf = NULL;
-                                 ecore_event_add(ECORE_IPC_EVENT_SERVER_DATA, e2,
-                                                 _ecore_ipc_event_server_data_free,
-                                                 NULL);
-                              }
-                            else
-                              {
-                                 free(buf);
-                                 buf = NULL;
-                              }
-                         }
-                       else
-                         {
-                            free(buf);
-                            buf = NULL;
-                         }
-                    }
-                  svr->prev.i = msg;
-                  offset += (s + msg.size);
-                  if ((svr->buf_size == offset) && ((svr->buf) || (buf)))
-                    {
-                       if (svr->buf) free(svr->buf);
-                       svr->buf = NULL;
-                       svr->buf_size = 0;
-                       if (buf) free(buf);
-                       return ECORE_CALLBACK_CANCEL;
-                    }
-                  goto redo;
+                  free(buf);
+                  continue;
                }
-             else goto scroll;
-          }
-        else
-          {
-             scroll:
-             if (buf != svr->buf) free(buf);
-             buf = malloc(svr->buf_size - offset);
-             if (!buf)
+             e2 = calloc(1, sizeof(Ecore_Ipc_Event_Server_Data));
+             if (!e2)
                {
-                  free(svr->buf);
-                  svr->buf = NULL;
-                  svr->buf_size = 0;
-                  return ECORE_CALLBACK_CANCEL;
+                  free(buf);
+                  continue;
                }
-             memcpy(buf, svr->buf + offset, svr->buf_size - offset);
-             free(svr->buf);
-             svr->buf = buf;
-             svr->buf_size -= offset;
+             svr->event_count++;
+             e2->server   = svr;
+             e2->major    = msg.major;
+             e2->minor    = msg.minor;
+             e2->ref      = msg.ref;
+             e2->ref_to   = msg.ref_to;
+             e2->response = msg.response;
+             e2->size     = msg.size;
+             e2->data     = buf;
+             ecore_event_add(ECORE_IPC_EVENT_SERVER_DATA, e2,
+                             _ecore_ipc_event_server_data_free,
+                             NULL);
           }
      }
    return ECORE_CALLBACK_CANCEL;
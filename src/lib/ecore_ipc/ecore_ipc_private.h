@@ -41,6 +41,24 @@ typedef struct _Ecore_Ipc_Msg_Head Ecore_Ipc_Msg_Head;
 #define ECORE_IPC_TYPE 0x0f
 #define ECORE_IPC_SSL  0xf0
 
+/* how each value of a message header is sent, from the previous one */
+#define DLT_ZERO   0
+#define DLT_ONE    1
+#define DLT_SAME   2
+#define DLT_SHL    3
+#define DLT_SHR    4
+#define DLT_ADD8   5
+#define DLT_DEL8   6
+#define DLT_ADDU8  7
+#define DLT_DELU8  8
+#define DLT_ADD16  9
+#define DLT_DEL16  10
+#define DLT_ADDU16 11
+#define DLT_DELU16 12
+#define DLT_SET    13
+#define DLT_R1     14
+#define DLT_R2     15
+
 #if defined (_MSC_VER) || (defined (__SUNPRO_C) && __SUNPRO_C < 0x5100)
 # pragma pack(1)
 # define ECORE_IPC_STRUCT_PACKED
@@ -66,14 +84,35 @@ struct _Ecore_Ipc_Msg_Head
 #pragma pack 0
 #endif
 
+/* the flags word and the 6 values, all sent as 32 bits */
+#define ECORE_IPC_HEAD_MAX (4 + (6 * 4))
+
+typedef struct _Ecore_Ipc_Reader Ecore_Ipc_Reader;
+
+/* Reassembles the messages from the data events of a connection: headers
+ * are decoded where they were received, and data goes straight to the
+ * buffer handed to the message event. Only what is split between two
+ * events is kept here. */
+struct _Ecore_Ipc_Reader
+{
+   unsigned char      head[ECORE_IPC_HEAD_MAX]; /* partial header */
+   int                head_size;
+   Ecore_Ipc_Msg_Head msg; /* message whose data is being read */
+   unsigned char     *data;
+   int                data_size; /* what was read of it */
+   Eina_Bool          in_data : 1;
+   Eina_Bool          skip : 1; /* larger than allowed, not kept */
+};
+
+Eina_Bool _ecore_ipc_reader_next(Ecore_Ipc_Reader *rd, Ecore_Ipc_Msg_Head *prev, int max, const unsigned char **p, int *size, Ecore_Ipc_Msg_Head *msg, unsigned char **data);
+
 struct _Ecore_Ipc_Client
 {
    ECORE_MAGIC;
    Ecore_Con_Client  *client;
    Ecore_Ipc_Server  *svr;
    void              *data;
-   unsigned char     *buf;
-   int                buf_size;
+   Ecore_Ipc_Reader   reader;
    int                max_buf_size;
    
    struct {
@@ -90,8 +129,7 @@ struct _Ecore_Ipc_Server
    Ecore_Con_Server *server;
    Eina_List        *clients;
    void              *data;
-   unsigned char     *buf;
-   int                buf_size;
+   Ecore_Ipc_Reader   reader;
    int                max_buf_size;
 
    struct {
@@ -245,6 +245,383 @@ _edje_match_patterns_exec_init_states(Edje_States *states,
      }
 }
 
+/* Lazily built DFA.
+ *
+ * Matching the same signals again and again against the same patterns is
+ * what edje spends its time on, so every set of patterns carries a DFA
+ * shared by all the objects using it. A DFA state is the list of NFA states
+ * (pattern index, position in the pattern) _edje_match_fn would hold at that
+ * point of the string, in the same order. Transitions are computed by
+ * running one step of the NFA the first time they are needed, and then
+ * reused. Bytes no pattern can tell apart are folded in a single class to
+ * keep the transition tables small. */
+
+#define EDJE_MATCH_DFA_STATES_MAX 256
+
+typedef struct _Edje_Match_Dfa_State Edje_Match_Dfa_State;
+struct _Edje_Match_Dfa_State
+{
+   Edje_Match_Dfa_State **next;     /* one per class, NULL until computed */
+   unsigned int          *key;      /* NFA states count, then (idx, pos) */
+   unsigned int          *finals;   /* matching patterns, in NFA order */
+   unsigned char         *accepted; /* same as a bitmap */
+   unsigned int           finals_count;
+   Eina_Bool              error : 1;
+};
+
+struct _Edje_Match_Dfa
+{
+   Eina_Hash            *states;
+   Edje_Match_Dfa_State *start;
+   Edje_Match_Dfa_State *error;
+
+   /* scratch space to compute a transition */
+   unsigned int         *cur;
+   unsigned int         *nxt;
+   unsigned char        *mark;
+
+   unsigned int          count;
+   unsigned int          classes_count;
+   unsigned char         classes[256];
+   char                  chars[256];
+};
+
+static unsigned int
+_edje_match_dfa_key_length(const unsigned int *key)
+{
+   return (1 + key[0] * 2) * sizeof (unsigned int);
+}
+
+static int
+_edje_match_dfa_key_cmp(const unsigned int *key1, int key1_length,
+                        const unsigned int *key2, int key2_length)
+{
+   if (key1_length != key2_length) return key1_length - key2_length;
+   return memcmp(key1, key2, key1_length);
+}
+
+static int
+_edje_match_dfa_key_hash(const unsigned int *key, int key_length)
+{
+   return eina_hash_superfast((const char *)key, key_length);
+}
+
+static Edje_Match_Dfa_State *
+_edje_match_dfa_state_new(const Edje_Patterns *ppat,
+                          Edje_Match_Dfa *dfa,
+                          const unsigned int *key)
+{
+   Edje_Match_Dfa_State *s;
+   unsigned int count = key[0];
+   unsigned int accepted_size;
+   unsigned int i;
+
+   accepted_size = (ppat->patterns_size + 7) / 8;
+   s = calloc(1, sizeof (Edje_Match_Dfa_State)
+              + dfa->classes_count * sizeof (Edje_Match_Dfa_State *)
+              + (1 + count * 2) * sizeof (unsigned int)
+              + count * sizeof (unsigned int)
+              + accepted_size);
+   if (!s) return NULL;
+
+   s->next = (Edje_Match_Dfa_State **)(s + 1);
+   s->key = (unsigned int *)(s->next + dfa->classes_count);
+   s->finals = s->key + 1 + count * 2;
+   s->accepted = (unsigned char *)(s->finals + count);
+
+   memcpy(s->key, key, (1 + count * 2) * sizeof (unsigned int));
+
+   for (i = 0; i < count; ++i)
+     {
+        const unsigned int idx = key[1 + i * 2];
+        const unsigned int pos = key[2 + i * 2];
+
+        if (pos < ppat->finals[idx]) continue;
+        if (s->accepted[idx >> 3] & (1 << (idx & 7))) continue;
+
+        s->accepted[idx >> 3] |= 1 << (idx & 7);
+        s->finals[s->finals_count++] = idx;
+     }
+
+   return s;
+}
+
+static Edje_Match_Dfa_State *
+_edje_match_dfa_state_get(const Edje_Patterns *ppat,
+                          Edje_Match_Dfa *dfa,
+                          const unsigned int *key)
+{
+   Edje_Match_Dfa_State *s;
+
+   s = eina_hash_find(dfa->states, key);
+   if (s) return s;
+
+   /* the NFA takes over when there are too many states to remember */
+   if (dfa->count >= EDJE_MATCH_DFA_STATES_MAX) return NULL;
+
+   s = _edje_match_dfa_state_new(ppat, dfa, key);
+   if (!s) return NULL;
+
+   if (!eina_hash_direct_add(dfa->states, s->key, s))
+     {
+        free(s);
+        return NULL;
+     }
+   dfa->count++;
+
+   return s;
+}
+
+static void
+_edje_match_dfa_push(unsigned int *list,
+                     unsigned char *mark,
+                     unsigned char bit,
+                     unsigned int stride,
+                     unsigned int idx,
+                     unsigned int pos)
+{
+   unsigned int i = idx * stride + pos;
+
+   if (mark[i] & bit) return;
+   mark[i] |= bit;
+
+   list[1 + list[0] * 2] = idx;
+   list[2 + list[0] * 2] = pos;
+   list[0]++;
+}
+
+/* One step of _edje_match_fn, from the states of from on c. */
+static Edje_Match_Dfa_State *
+_edje_match_dfa_step(const Edje_Patterns *ppat,
+                     Edje_Match_Dfa *dfa,
+                     const Edje_Match_Dfa_State *from,
+                     char c)
+{
+   const unsigned int stride = ppat->max_length + 1;
+   unsigned int *cur = dfa->cur;
+   unsigned int *nxt = dfa->nxt;
+   Eina_Bool error = EINA_FALSE;
+   unsigned int i;
+
+   cur[0] = 0;
+   nxt[0] = 0;
+   for (i = 0; i < from->key[0]; ++i)
+     _edje_match_dfa_push(cur, dfa->mark, 1, stride,
+                          from->key[1 + i * 2], from->key[2 + i * 2]);
+
+   for (i = 0; i < cur[0]; ++i)
+     {
+        const unsigned int idx = cur[1 + i * 2];
+        const unsigned int pos = cur[2 + i * 2];
+        const char *tok = ppat->patterns[idx] + pos;
+        unsigned int m;
+
+        if (!*tok)
+          continue;
+        else if (*tok == '*')
+          {
+             _edje_match_dfa_push(cur, dfa->mark, 1, stride, idx, pos + 1);
+             _edje_match_dfa_push(nxt, dfa->mark, 2, stride, idx, pos);
+          }
+        else
+          {
+             if (_edje_match_patterns_exec_token(tok, c, &m) != EDJE_MATCH_OK)
+               {
+                  error = EINA_TRUE;
+                  break;
+               }
+
+             if (m)
+               _edje_match_dfa_push(nxt, dfa->mark, 2, stride, idx, pos + m);
+          }
+     }
+
+   for (i = 0; i < cur[0]; ++i)
+     dfa->mark[cur[1 + i * 2] * stride + cur[2 + i * 2]] = 0;
+   for (i = 0; i < nxt[0]; ++i)
+     dfa->mark[nxt[1 + i * 2] * stride + nxt[2 + i * 2]] = 0;
+
+   if (error) return dfa->error;
+
+   return _edje_match_dfa_state_get(ppat, dfa, nxt);
+}
+
+static void
+_edje_match_dfa_cut(unsigned char *cuts, char lo, char hi)
+{
+   /* Patterns compare plain chars, signed or not depending on the
+    * platform. Either way the bytes from lo to hi are a run of the byte
+    * values taken in a circle, so cutting where it starts and after where
+    * it ends is enough. */
+   if (lo > hi) return;
+   cuts[(unsigned char)lo] = 1;
+   cuts[(unsigned int)(unsigned char)hi + 1] = 1;
+}
+
+/* Split the bytes in ranges that all the patterns handle the same way,
+ * returns EINA_FALSE on anything unexpected. */
+static Eina_Bool
+_edje_match_dfa_classes_cut(const char *str, unsigned char *cuts)
+{
+   while (*str)
+     {
+        switch (*str)
+          {
+           case '*':
+           case '?':
+              str++;
+              break;
+
+           case '\\':
+              if (!str[1]) return EINA_FALSE;
+              _edje_match_dfa_cut(cuts, str[1], str[1]);
+              str += 2;
+              break;
+
+           case '[':
+              str++;
+              if (*str == '!') str++;
+              do
+                {
+                   if (!*str) return EINA_FALSE;
+                   if (str[1] == '-' && str[2] != ']')
+                     {
+                        if (!str[2]) return EINA_FALSE;
+                        _edje_match_dfa_cut(cuts, str[0], str[2]);
+                        str += 3;
+                     }
+                   else
+                     {
+                        _edje_match_dfa_cut(cuts, str[0], str[0]);
+                        str++;
+                     }
+                }
+              while (*str && *str != ']');
+              if (!*str) return EINA_FALSE;
+              str++;
+              break;
+
+           default:
+              _edje_match_dfa_cut(cuts, *str, *str);
+              str++;
+          }
+     }
+
+   return EINA_TRUE;
+}
+
+static void
+_edje_match_dfa_classes_build(const Edje_Patterns *ppat, Edje_Match_Dfa *dfa)
+{
+   unsigned char cuts[257];
+   unsigned int i;
+   int v;
+
+   memset(cuts, 0, sizeof (cuts));
+   for (i = 0; i < ppat->patterns_size; ++i)
+     if (!_edje_match_dfa_classes_cut(ppat->patterns[i], cuts))
+       {
+          memset(cuts, 1, sizeof (cuts));
+          break;
+       }
+
+   dfa->classes_count = 0;
+   for (v = 0; v < 256; ++v)
+     {
+        if (v > 0 && cuts[v]) dfa->classes_count++;
+        if (v == 0 || cuts[v]) dfa->chars[dfa->classes_count] = (char)v;
+        dfa->classes[v] = dfa->classes_count;
+     }
+   dfa->classes_count++;
+}
+
+static void
+_edje_match_dfa_free(Edje_Match_Dfa *dfa)
+{
+   if (!dfa) return;
+
+   eina_hash_free(dfa->states);
+   free(dfa->error);
+   free(dfa->cur);
+   free(dfa->nxt);
+   free(dfa->mark);
+   free(dfa);
+}
+
+static Edje_Match_Dfa *
+_edje_match_dfa_new(const Edje_Patterns *ppat)
+{
+   Edje_Match_Dfa *dfa;
+   const unsigned int array_len = (ppat->max_length + 1) * ppat->patterns_size;
+   unsigned int i;
+
+   dfa = calloc(1, sizeof (Edje_Match_Dfa));
+   if (!dfa) return NULL;
+
+   _edje_match_dfa_classes_build(ppat, dfa);
+
+   dfa->states = eina_hash_new(EINA_KEY_LENGTH(_edje_match_dfa_key_length),
+                               EINA_KEY_CMP(_edje_match_dfa_key_cmp),
+                               EINA_KEY_HASH(_edje_match_dfa_key_hash),
+                               EINA_FREE_CB(free),
+                               6);
+   dfa->cur = malloc((1 + array_len * 2) * sizeof (unsigned int));
+   dfa->nxt = malloc((1 + array_len * 2) * sizeof (unsigned int));
+   dfa->mark = calloc(array_len, sizeof (unsigned char));
+   if (!dfa->states || !dfa->cur || !dfa->nxt || !dfa->mark)
+     goto on_error;
+
+   /* a syntax error in a pattern makes the whole match fail */
+   dfa->error = calloc(1, sizeof (Edje_Match_Dfa_State) + sizeof (unsigned int));
+   if (!dfa->error) goto on_error;
+   dfa->error->key = (unsigned int *)(dfa->error + 1);
+   dfa->error->error = EINA_TRUE;
+
+   dfa->nxt[0] = ppat->patterns_size;
+   for (i = 0; i < ppat->patterns_size; ++i)
+     {
+        dfa->nxt[1 + i * 2] = i;
+        dfa->nxt[2 + i * 2] = 0;
+     }
+   dfa->start = _edje_match_dfa_state_get(ppat, dfa, dfa->nxt);
+   if (!dfa->start) goto on_error;
+
+   return dfa;
+
+ on_error:
+   _edje_match_dfa_free(dfa);
+   return NULL;
+}
+
+/* Returns NULL when the NFA has to be used instead. */
+static const Edje_Match_Dfa_State *
+_edje_match_dfa_exec(const Edje_Patterns *ppat, const char *string)
+{
+   Edje_Match_Dfa *dfa = ppat->dfa;
+   Edje_Match_Dfa_State *s;
+   const char *c;
+
+   if (!dfa) return NULL;
+
+   s = dfa->start;
+   for (c = string; *c && s->key[0]; ++c)
+     {
+        const unsigned char k = dfa->classes[(unsigned char)*c];
+        Edje_Match_Dfa_State *next;
+
+        next = s->next[k];
+        if (!next)
+          {
+             next = _edje_match_dfa_step(ppat, dfa, s, dfa->chars[k]);
+             if (!next) return NULL;
+             s->next[k] = next;
+          }
+        s = next;
+     }
+
+   return s;
+}
+
 /* Exported function. */
 
 #define EDJE_MATCH_INIT_LIST(Func, Type, Source, Show)		\
@@ -311,6 +688,8 @@ _edje_match_patterns_exec_init_states(Edje_States *states,
           return NULL;                                          \
        }                                                        \
                                                                 \
+     r->dfa = _edje_match_dfa_new(r);                           \
+                                                                \
      return r;                                                  \
   }
 
@@ -374,6 +753,8 @@ _edje_match_patterns_exec_init_states(Edje_States *states,
           return NULL;                                          \
        }                                                        \
                                                                 \
+     r->dfa = _edje_match_dfa_new(r);                           \
+                                                                \
      return r;                                                  \
   }
 
@@ -434,6 +815,8 @@ _edje_match_patterns_exec_init_states(Edje_States *states,
           return NULL;                                                  \
        }                                                                \
                                                                         \
+     r->dfa = _edje_match_dfa_new(r);                                   \
+                                                                        \
      return r;                                                          \
   }
 
@@ -506,6 +889,103 @@ edje_match_programs_exec_check_finals(const unsigned int *signal_finals,
    return EINA_TRUE;
 }
 
+static Eina_Bool
+edje_match_programs_exec_check_dfa_finals(const Edje_Match_Dfa_State *signal_state,
+                                          const Edje_Match_Dfa_State *source_state,
+                                          Edje_Program              **programs,
+                                          Eina_Bool (*func)(Edje_Program *pr, void *data),
+                                          void                       *data)
+{
+   unsigned int i;
+
+   for (i = 0; i < signal_state->finals_count; ++i)
+     {
+        const unsigned int idx = signal_state->finals[i];
+        Edje_Program *pr;
+
+        if (!(source_state->accepted[idx >> 3] & (1 << (idx & 7))))
+          continue;
+
+        pr = programs[idx];
+        if (pr)
+          {
+             if (func(pr, data))
+                return EINA_FALSE;
+          }
+     }
+
+   return EINA_TRUE;
+}
+
+static int
+edje_match_callback_exec_run(const Edje_Signals_Sources_Patterns *ssp,
+                             const Edje_Signal_Callback_Match    *matches,
+                             Eina_Array        *run,
+                             const char        *sig,
+                             const char        *source,
+                             Edje              *ed,
+                             int                r)
+{
+   const Edje_Signal_Callback_Match *cb;
+
+   while ((cb = eina_array_pop(run)))
+     {
+        int idx = cb - matches;
+
+	if (ed->callbacks->flags[idx].delete_me) continue;
+
+        cb->func((void*) ed->callbacks->custom_data[idx], ed->obj, sig, source);
+        if (_edje_block_break(ed))
+	  {
+             r = 0;
+             break;
+          }
+        if ((ssp->signals_patterns->delete_me) || (ssp->sources_patterns->delete_me))
+          {
+             r = 0;
+             break;
+          }
+     }
+
+   eina_array_flush(run);
+
+   return r;
+}
+
+static int
+edje_match_callback_exec_check_dfa_finals(const Edje_Signals_Sources_Patterns *ssp,
+                                          const Edje_Signal_Callback_Match    *matches,
+                                          const Edje_Match_Dfa_State *signal_state,
+                                          const Edje_Match_Dfa_State *source_state,
+                                          const char        *sig,
+                                          const char        *source,
+                                          Edje              *ed,
+                                          Eina_Bool          prop)
+{
+   Eina_Array   run;
+   unsigned int i;
+   int          r = 1;
+
+   eina_array_step_set(&run, sizeof (Eina_Array), 4);
+
+   for (i = 0; i < signal_state->finals_count; ++i)
+     {
+        const unsigned int idx = signal_state->finals[i];
+        int *e;
+
+        if (!(source_state->accepted[idx >> 3] & (1 << (idx & 7))))
+          continue;
+
+        e = eina_inarray_nth(&ssp->u.callbacks.globing, idx);
+
+        if ((prop) && ed->callbacks->flags[*e].propagate) continue;
+        eina_array_push(&run, &matches[*e]);
+        r = 2;
+     }
+
+   return edje_match_callback_exec_run(ssp, matches, &run, sig, source, ed, r);
+}
+
 static int
 edje_match_callback_exec_check_finals(const Edje_Signals_Sources_Patterns *ssp,
                                       const Edje_Signal_Callback_Match    *matches,
@@ -547,28 +1027,7 @@ edje_match_callback_exec_check_finals(const Edje_Signals_Sources_Patterns *ssp,
             }
        }
 
-   while ((cb = eina_array_pop(&run)))
-     {
-        int idx = cb - matches;
-
-	if (ed->callbacks->flags[idx].delete_me) continue;
-
-        cb->func((void*) ed->callbacks->custom_data[idx], ed->obj, sig, source);
-        if (_edje_block_break(ed))
-	  {
-             r = 0;
-             break;
-          }
-        if ((ssp->signals_patterns->delete_me) || (ssp->sources_patterns->delete_me))
-          {
-             r = 0;
-             break;
-          }
-     }
-
-   eina_array_flush(&run);
-
-   return r;
+   return edje_match_callback_exec_run(ssp, matches, &run, sig, source, ed, r);
 }
 
 
@@ -626,12 +1085,16 @@ Eina_Bool
 edje_match_collection_dir_exec(const Edje_Patterns      *ppat,
                                const char               *string)
 {
+   const Edje_Match_Dfa_State *state;
    Edje_States  *result;
    Eina_Bool     r = EINA_FALSE;
 
    /* under high memory presure, it could be NULL */
    if (!ppat) return EINA_FALSE;
 
+   state = _edje_match_dfa_exec(ppat, string);
+   if (state) return state->finals_count > 0;
+
    _edje_match_patterns_exec_init_states(ppat->states, ppat->patterns_size, ppat->max_length);
 
    result = _edje_match_fn(ppat, string, ppat->states);
@@ -652,6 +1115,8 @@ edje_match_programs_exec(const Edje_Patterns    *ppat_signal,
                          void                   *data,
                          Eina_Bool               prop)
 {
+   const Edje_Match_Dfa_State *signal_state;
+   const Edje_Match_Dfa_State *source_state;
    Edje_States  *signal_result;
    Edje_States  *source_result;
    Eina_Bool     r = EINA_FALSE;
@@ -659,6 +1124,18 @@ edje_match_programs_exec(const Edje_Patterns    *ppat_signal,
    /* under high memory presure, they could be NULL */
    if (!ppat_source || !ppat_signal) return EINA_FALSE;
 
+   signal_state = _edje_match_dfa_exec(ppat_signal, sig);
+   source_state = signal_state ? _edje_match_dfa_exec(ppat_source, source) : NULL;
+   if (signal_state && source_state)
+     {
+        if (signal_state->error || source_state->error) return EINA_FALSE;
+        return edje_match_programs_exec_check_dfa_finals(signal_state,
+                                                         source_state,
+                                                         programs,
+                                                         func,
+                                                         data);
+     }
+
    _edje_match_patterns_exec_init_states(ppat_signal->states,
                                          ppat_signal->patterns_size,
                                          ppat_signal->max_length);
@@ -689,6 +1166,8 @@ edje_match_callback_exec(const Edje_Signals_Sources_Patterns *ssp,
                          Edje *ed,
                          Eina_Bool prop)
 {
+   const Edje_Match_Dfa_State *signal_state;
+   const Edje_Match_Dfa_State *source_state;
    Edje_States  *signal_result;
    Edje_States  *source_result;
    int           r = 0;
@@ -698,25 +1177,43 @@ edje_match_callback_exec(const Edje_Signals_Sources_Patterns *ssp,
 
    ssp->signals_patterns->ref++;
    ssp->sources_patterns->ref++;
-   _edje_match_patterns_exec_init_states(ssp->signals_patterns->states,
-                                         ssp->signals_patterns->patterns_size,
-                                         ssp->signals_patterns->max_length);
-   _edje_match_patterns_exec_init_states(ssp->sources_patterns->states,
-                                         ssp->sources_patterns->patterns_size,
-                                         ssp->sources_patterns->max_length);
-
-   signal_result = _edje_match_fn(ssp->signals_patterns, sig, ssp->signals_patterns->states);
-   source_result = _edje_match_fn(ssp->sources_patterns, source, ssp->sources_patterns->states);
 
-   if (signal_result && source_result)
-     r = edje_match_callback_exec_check_finals(ssp,
-					       matches,
-                                               signal_result,
-                                               source_result,
-                                               sig,
-                                               source,
-                                               ed,
-                                               prop);
+   signal_state = _edje_match_dfa_exec(ssp->signals_patterns, sig);
+   source_state = signal_state ? _edje_match_dfa_exec(ssp->sources_patterns, source) : NULL;
+   if (signal_state && source_state)
+     {
+        if (!signal_state->error && !source_state->error)
+          r = edje_match_callback_exec_check_dfa_finals(ssp,
+                                                        matches,
+                                                        signal_state,
+                                                        source_state,
+                                                        sig,
+                                                        source,
+                                                        ed,
+                                                        prop);
+     }
+   else
+     {
+        _edje_match_patterns_exec_init_states(ssp->signals_patterns->states,
+                                              ssp->signals_patterns->patterns_size,
+                                              ssp->signals_patterns->max_length);
+        _edje_match_patterns_exec_init_states(ssp->sources_patterns->states,
+                                              ssp->sources_patterns->patterns_size,
+                                              ssp->sources_patterns->max_length);
+
+        signal_result = _edje_match_fn(ssp->signals_patterns, sig, ssp->signals_patterns->states);
+        source_result = _edje_match_fn(ssp->sources_patterns, source, ssp->sources_patterns->states);
+
+        if (signal_result && source_result)
+          r = edje_match_callback_exec_check_finals(ssp,
+                                                    matches,
+                                                    signal_result,
+                                                    source_result,
+                                                    sig,
+                                                    source,
+                                                    ed,
+                                                    prop);
+     }
    ssp->signals_patterns->ref--;
    ssp->sources_patterns->ref--;
    if (ssp->signals_patterns->ref <= 0) edje_match_patterns_free(ssp->signals_patterns);
@@ -732,6 +1229,7 @@ edje_match_patterns_free(Edje_Patterns *ppat)
    ppat->delete_me = EINA_TRUE;
    ppat->ref--;
    if (ppat->ref > 0) return;
+   _edje_match_dfa_free(ppat->dfa);
    _edje_match_states_free(ppat->states, 2);
    free(ppat);
 }
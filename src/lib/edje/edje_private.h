@@ -1811,11 +1811,13 @@ typedef enum _Edje_Match_Error
 } Edje_Match_Error;
 
 typedef struct _Edje_States     Edje_States;
+typedef struct _Edje_Match_Dfa  Edje_Match_Dfa;
 struct _Edje_Patterns
 {
    const char    **patterns;
 
    Edje_States    *states;
+   Edje_Match_Dfa *dfa;
 
    int             ref;
    Eina_Bool       delete_me : 1;
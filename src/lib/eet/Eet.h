@@ -631,6 +631,41 @@ eet_memopen_read(const void *data,
 EAPI Eet_File_Mode
 eet_mode_get(Eet_File *ef);
 
+/**
+ * Defer compression of written entries to the next flush of the file.
+ * @param ef A valid eet file handle opened for writing.
+ * @param parallel EINA_TRUE to compress at flush time, EINA_FALSE to
+ *        compress in eet_write().
+ *
+ * When enabled, eet_write() only copies the data and returns its
+ * uncompressed size. All entries written since the last flush are then
+ * compressed by eet_sync() or eet_close(), spread over as many threads as
+ * there are cpus. The resulting file is identical to the one produced
+ * without this option. Entries written with a cipher key are still
+ * compressed immediately.
+ *
+ * @see eet_parallel_compression_get()
+ *
+ * @since 1.10
+ * @ingroup Eet_File_Group
+ */
+EAPI void
+eet_parallel_compression_set(Eet_File *ef,
+                             Eina_Bool parallel);
+
+/**
+ * Get whether compression of written entries is deferred to the next flush.
+ * @param ef A valid eet file handle.
+ * @return EINA_TRUE if compression is done at flush time.
+ *
+ * @see eet_parallel_compression_set()
+ *
+ * @since 1.10
+ * @ingroup Eet_File_Group
+ */
+EAPI Eina_Bool
+eet_parallel_compression_get(Eet_File *ef);
+
 /**
  * Close an eet file handle and flush pending writes.
  * @param ef A valid eet file handle.
@@ -2905,6 +2940,41 @@ eet_data_descriptor_free(Eet_Data_Descriptor *edd);
  */
 EAPI const char *eet_data_descriptor_name_get(const Eet_Data_Descriptor *edd);
 
+/**
+ * Decode strings without copying them when reading from an Eet_File.
+ * @param edd The data descriptor used with eet_data_read().
+ * @param direct #EINA_TRUE to enable direct mode, #EINA_FALSE to disable it.
+ *
+ * In direct mode, eet_data_read() on a file opened with #EET_FILE_MODE_READ
+ * does not allocate any string of the decoded data: every #EET_T_STRING and
+ * #EET_T_INLINED_STRING member, including the ones of sub structures, lists,
+ * arrays and hashes, points directly into the mapped file. For a compressed
+ * entry, it is uncompressed once and kept by the Eet_File, so reading it
+ * again is free. Those strings must not be freed by the caller and stay
+ * valid until the Eet_File is closed.
+ *
+ * Reading with a cipher key, or from a file not opened with
+ * #EET_FILE_MODE_READ, ignores this mode and allocates strings as usual.
+ *
+ * Only the descriptor given to eet_data_read() is checked.
+ *
+ * @see eet_data_descriptor_direct_get()
+ * @since 1.10
+ * @ingroup Eet_Data_Group
+ */
+EAPI void eet_data_descriptor_direct_set(Eet_Data_Descriptor *edd, Eina_Bool direct);
+
+/**
+ * Tell if a data descriptor decodes strings in direct mode.
+ * @param edd The data descriptor.
+ * @return #EINA_TRUE if direct mode is enabled.
+ *
+ * @see eet_data_descriptor_direct_set()
+ * @since 1.10
+ * @ingroup Eet_Data_Group
+ */
+EAPI Eina_Bool eet_data_descriptor_direct_get(const Eet_Data_Descriptor *edd);
+
 /**
  * This function is an internal used by macros.
  *
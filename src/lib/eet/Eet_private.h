@@ -97,6 +97,7 @@ struct _Eet_File
    unsigned char        writes_pending : 1;
    unsigned char        delete_me_now : 1;
    unsigned char        readfp_owned : 1;
+   unsigned char        parallel_compression : 1;
 };
 
 struct _Eet_File_Header
@@ -115,6 +116,7 @@ struct _Eet_File_Node
 {
    char             *name;
    void             *data;
+   void             *data_direct; /* uncompressed copy kept until eet_close */
    Eet_File_Node    *next; /* FIXME: make buckets linked lists */
 
    unsigned int      offset;
@@ -128,6 +130,7 @@ struct _Eet_File_Node
    unsigned char     compression : 1;
    unsigned char     ciphered : 1;
    unsigned char     alias : 1;
+   unsigned char     compress_pending : 1; /* compressed by the next flush */
 };
 
 #if 0
@@ -253,6 +256,11 @@ eet_dictionary_string_get_hash(const Eet_Dictionary *ed,
 int _eet_hash_gen(const char *key,
                   int hash_size);
 
+const void *
+eet_read_direct_keep(Eet_File *ef,
+                     const char *name,
+                     int *size_ret);
+
 const void *
 eet_identity_check(const void *data_base,
                    unsigned int data_length,
@@ -176,6 +176,7 @@ struct _Eet_Data_Descriptor
    } elements;
 
    Eina_Bool unified_type : 1;
+   Eina_Bool direct : 1;
 //   char *strings;
 //   int   strings_len;
 };
@@ -215,6 +216,7 @@ struct _Eet_Free_Context
    Eet_Free freelist_hash;
    Eet_Free freelist_str;
    Eet_Free freelist_direct_str;
+   Eina_Bool direct; /* strings can point into the Eet_File */
 };
 
 struct _Eet_Variant_Unknow
@@ -2092,6 +2094,23 @@ eet_data_descriptor_file_new(const Eet_Data_Descriptor_Class *eddc)
    return _eet_data_descriptor_new(eddc, 2);
 }
 
+EAPI void
+eet_data_descriptor_direct_set(Eet_Data_Descriptor *edd,
+                               Eina_Bool            direct)
+{
+   EINA_SAFETY_ON_NULL_RETURN(edd);
+
+   edd->direct = !!direct;
+}
+
+EAPI Eina_Bool
+eet_data_descriptor_direct_get(const Eet_Data_Descriptor *edd)
+{
+   EINA_SAFETY_ON_NULL_RETURN_VAL(edd, EINA_FALSE);
+
+   return edd->direct;
+}
+
 EAPI const char *
 eet_data_descriptor_name_get(const Eet_Data_Descriptor *edd)
 {
@@ -2258,12 +2277,19 @@ eet_data_read_cipher(Eet_File            *ef,
    const void *data = NULL;
    void *data_dec;
    Eet_Free_Context context;
+   Eina_Bool direct = EINA_FALSE;
    int required_free = 0;
    int size;
 
    ed = eet_dictionary_get(ef);
 
-   if (!cipher_key)
+   if ((!cipher_key) && (edd) && (edd->direct))
+     {
+        data = eet_read_direct_keep(ef, name, &size);
+        direct = !!data;
+     }
+
+   if ((!cipher_key) && (!data))
      data = eet_read_direct(ef, name, &size);
 
    if (!data)
@@ -2275,6 +2301,7 @@ eet_data_read_cipher(Eet_File            *ef,
      }
 
    eet_free_context_init(&context);
+   context.direct = direct;
    data_dec = _eet_data_descriptor_decode(&context, ed, edd, data, size, NULL, 0);
    eet_free_context_shutdown(&context);
 
@@ -2296,12 +2323,19 @@ eet_data_read_cipher_buffer(Eet_File            *ef,
    const void *data = NULL;
    void *data_dec;
    Eet_Free_Context context;
+   Eina_Bool direct = EINA_FALSE;
    int required_free = 0;
    int size;
 
    ed = eet_dictionary_get(ef);
 
-   if (!cipher_key)
+   if ((!cipher_key) && (edd) && (edd->direct))
+     {
+        data = eet_read_direct_keep(ef, name, &size);
+        direct = !!data;
+     }
+
+   if ((!cipher_key) && (!data))
      data = eet_read_direct(ef, name, &size);
 
    if (!data)
@@ -2313,6 +2347,7 @@ eet_data_read_cipher_buffer(Eet_File            *ef,
      }
 
    eet_free_context_init(&context);
+   context.direct = direct;
    data_dec = _eet_data_descriptor_decode(&context, ed, edd, data, size, buffer, buffer_size);
    eet_free_context_shutdown(&context);
 
@@ -4610,7 +4645,8 @@ eet_data_get_unknown(Eet_Free_Context     *context,
                   char **str;
 
                   str = (char **)(((char *)data));
-                  if (*str)
+                  /* in direct mode it points into the Eet_File already */
+                  if ((*str) && (!context->direct))
                     {
                        if ((!ed) || (!edd->func.str_direct_alloc))
                          {
@@ -4629,7 +4665,7 @@ eet_data_get_unknown(Eet_Free_Context     *context,
                   char **str;
 
                   str = (char **)(((char *)data));
-                  if (*str)
+                  if ((*str) && (!context->direct))
                     {
                        *str = edd->func.str_alloc(*str);
                        _eet_freelist_str_add(context, *str);
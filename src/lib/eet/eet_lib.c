@@ -315,6 +315,178 @@ eet_string_match(const char *s1,
     return !strcmp(s1, s2);
 }
 
+/* compress size bytes of data, return 1 and the new buffer in out if it
+ * shrank, 0 if it is not worth it and -1 on error */
+static int
+eet_compress(const void *data,
+             int         size,
+             int         comp,
+             void      **out,
+             int        *out_size)
+{
+   void *data2, *data3;
+   int data_size, ret;
+
+   data_size = 12 + ((size * 101) / 100);
+   ret = LZ4_compressBound(size);
+   if ((ret > 0) && (ret > data_size)) data_size = ret;
+
+   data2 = malloc(data_size);
+   if (!data2)
+     return -1;
+
+   switch (comp)
+     {
+      case EET_COMPRESSION_VERYFAST:
+        ret = LZ4_compressHC((const char *)data, (char *)data2, size);
+        break;
+      case EET_COMPRESSION_SUPERFAST:
+        ret = LZ4_compress((const char *)data, (char *)data2, size);
+        break;
+      default:
+          {
+             uLongf buflen;
+
+             /* compress the data with max compression */
+             buflen = (uLongf)data_size;
+             if (compress2((Bytef *)data2, &buflen, (Bytef *)data,
+                           (uLong)size, Z_BEST_COMPRESSION) != Z_OK)
+               ret = -1;
+             else
+               ret = (int)buflen;
+          }
+     }
+
+   if (ret <= 0)
+     {
+        free(data2);
+        return -1;
+     }
+
+   if (ret >= size)
+     {
+        free(data2);
+        return 0;
+     }
+
+   data3 = realloc(data2, ret);
+   if (data3)
+     data2 = data3;
+
+   *out = data2;
+   *out_size = ret;
+   return 1;
+}
+
+typedef struct _Eet_Compress_Job Eet_Compress_Job;
+struct _Eet_Compress_Job
+{
+   Eet_File_Node **nodes;
+   unsigned int    count;
+   unsigned int    next;
+   Eina_Spinlock   lock;
+};
+
+static void
+eet_node_compress(Eet_File_Node *efn)
+{
+   void *data2;
+   int data_size;
+
+   /* data not shrinking or failing to compress is stored as is */
+   if (eet_compress(efn->data, efn->data_size, efn->compression_type,
+                    &data2, &data_size) > 0)
+     {
+        free(efn->data);
+        efn->data = data2;
+        efn->size = data_size;
+        efn->compression = 1;
+     }
+   else
+     efn->compression_type = 0;
+
+   efn->compress_pending = 0;
+}
+
+static void *
+eet_compress_worker(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Eet_Compress_Job *job = data;
+   unsigned int i;
+
+   for (;;)
+     {
+        eina_spinlock_take(&job->lock);
+        i = job->next++;
+        eina_spinlock_release(&job->lock);
+
+        if (i >= job->count) break;
+        eet_node_compress(job->nodes[i]);
+     }
+
+   return NULL;
+}
+
+/* compress every entry written since the last flush, each entry is
+ * compressed on its own so the output does not depend on the scheduling */
+static void
+eet_flush_compress(Eet_File *ef)
+{
+   Eet_Compress_Job job;
+   Eet_File_Node *efn;
+   Eina_Thread *threads;
+   unsigned int nthreads, started;
+   unsigned int i;
+   int num, j;
+
+   job.count = 0;
+   num = (1 << ef->header->directory->size);
+   for (j = 0; j < num; j++)
+     for (efn = ef->header->directory->nodes[j]; efn; efn = efn->next)
+       if (efn->compress_pending) job.count++;
+
+   if (!job.count) return;
+
+   job.nodes = malloc(job.count * sizeof (Eet_File_Node *));
+   if (!job.nodes)
+     {
+        for (j = 0; j < num; j++)
+          for (efn = ef->header->directory->nodes[j]; efn; efn = efn->next)
+            if (efn->compress_pending) eet_node_compress(efn);
+        return;
+     }
+
+   i = 0;
+   for (j = 0; j < num; j++)
+     for (efn = ef->header->directory->nodes[j]; efn; efn = efn->next)
+       if (efn->compress_pending) job.nodes[i++] = efn;
+
+   job.next = 0;
+   eina_spinlock_new(&job.lock);
+
+   nthreads = eina_cpu_count();
+   if (nthreads > job.count) nthreads = job.count;
+   if (nthreads > 16) nthreads = 16;
+
+   /* the calling thread is one of the workers */
+   started = 0;
+   threads = nthreads > 1 ? malloc((nthreads - 1) * sizeof (Eina_Thread)) : NULL;
+   if (threads)
+     for (; started < nthreads - 1; started++)
+       if (!eina_thread_create(&threads[started], EINA_THREAD_NORMAL, -1,
+                               eet_compress_worker, &job))
+         break;
+
+   eet_compress_worker(&job, eina_thread_self());
+
+   for (i = 0; i < started; i++)
+     eina_thread_join(threads[i]);
+
+   free(threads);
+   eina_spinlock_free(&job.lock);
+   free(job.nodes);
+}
+
 /* flush out writes to a v2 eet file */
 static Eet_Error
 eet_flush2(Eet_File *ef)
@@ -363,6 +535,8 @@ eet_flush2(Eet_File *ef)
    else
      return EET_ERROR_NOT_WRITABLE;
 
+   eet_flush_compress(ef);
+
    /* calculate string base offset and data base offset */
    num = (1 << ef->header->directory->size);
    for (i = 0; i < num; ++i)
@@ -859,6 +1033,9 @@ eet_internal_read2(Eet_File *ef)
              return NULL;
           }
 
+        efn->data_direct = NULL;
+        efn->compress_pending = 0;
+
         /* get entrie header */
         GET_INT(efn->offset, data, idx);
         GET_INT(efn->size, data, idx);
@@ -1147,6 +1324,9 @@ eet_internal_read1(Eet_File *ef)
              return NULL;
           }
 
+        efn->data_direct = NULL;
+        efn->compress_pending = 0;
+
         /* get entrie header */
         EXTRACT_INT(efn->offset, p, indexn);
         EXTRACT_INT(efn->compression, p, indexn);
@@ -1333,6 +1513,7 @@ eet_internal_close(Eet_File *ef,
                          {
                             if (efn->data)
                               free(efn->data);
+                            free(efn->data_direct);
 
                             ef->header->directory->nodes[i] = efn->next;
 
@@ -1407,6 +1588,7 @@ eet_memopen_read(const void *data,
    ef->sha1 = NULL;
    ef->sha1_length = 0;
    ef->readfp_owned = EINA_FALSE;
+   ef->parallel_compression = 0;
 
    /* eet_internal_read expects the cache lock to be held when it is called */
    LOCK_CACHE;
@@ -1468,6 +1650,7 @@ eet_mmap(const Eina_File *file)
    ef->sha1 = NULL;
    ef->sha1_length = 0;
    ef->readfp_owned = EINA_TRUE;
+   ef->parallel_compression = 0;
 
    ef->data_size = eina_file_size_get(ef->readfp);
    ef->data = eina_file_map_all(ef->readfp, EINA_FILE_SEQUENTIAL);
@@ -1615,6 +1798,7 @@ open_error:
    ef->sha1 = NULL;
    ef->sha1_length = 0;
    ef->readfp_owned = EINA_TRUE;
+   ef->parallel_compression = 0;
 
    ef->ed = (mode == EET_FILE_MODE_WRITE)
      || (!ef->readfp && mode == EET_FILE_MODE_READ_WRITE) ?
@@ -1670,6 +1854,27 @@ eet_mode_get(Eet_File *ef)
       return ef->mode;
 }
 
+EAPI void
+eet_parallel_compression_set(Eet_File *ef,
+                             Eina_Bool parallel)
+{
+   if (eet_check_pointer(ef))
+     return;
+
+   LOCK_FILE(ef);
+   ef->parallel_compression = !!parallel;
+   UNLOCK_FILE(ef);
+}
+
+EAPI Eina_Bool
+eet_parallel_compression_get(Eet_File *ef)
+{
+   if (eet_check_pointer(ef))
+     return EINA_FALSE;
+
+   return ef->parallel_compression;
+}
+
 EAPI const void *
 eet_identity_x509(Eet_File *ef,
                   int      *der_length)
@@ -2060,6 +2265,64 @@ on_error:
    return NULL;
 }
 
+const void *
+eet_read_direct_keep(Eet_File   *ef,
+                     const char *name,
+                     int        *size_ret)
+{
+   Eet_File_Node *efn;
+   const void *data;
+   void *tmp;
+   int size;
+
+   if (size_ret)
+     *size_ret = 0;
+
+   /* only a read-only file is guaranteed to not change until eet_close */
+   if (eet_check_pointer(ef) || (ef->mode != EET_FILE_MODE_READ))
+     return NULL;
+
+   data = eet_read_direct(ef, name, size_ret);
+   if (data)
+     return data;
+
+   if ((!name) || eet_check_header(ef))
+     return NULL;
+
+   LOCK_FILE(ef);
+
+   efn = find_node_by_name(ef, name);
+   if ((!efn) || (efn->ciphered) || (efn->alias))
+     goto on_error;
+
+   if (!efn->data_direct)
+     {
+        /* compressed entry, uncompress it once and keep it around */
+        UNLOCK_FILE(ef);
+        tmp = eet_read_cipher(ef, name, &size, NULL);
+        if (!tmp)
+          return NULL;
+        LOCK_FILE(ef);
+
+        if (efn->data_direct)
+          free(tmp);
+        else
+          efn->data_direct = tmp;
+     }
+
+   data = efn->data_direct;
+   if (size_ret)
+     *size_ret = efn->data_size;
+
+   UNLOCK_FILE(ef);
+
+   return data;
+
+on_error:
+   UNLOCK_FILE(ef);
+   return NULL;
+}
+
 EAPI const char *
 eet_alias_get(Eet_File   *ef,
               const char *name)
@@ -2302,6 +2565,7 @@ eet_alias(Eet_File   *ef,
               efn->ciphered = 0;
               efn->compression = !!comp;
               efn->compression_type = comp;
+              efn->compress_pending = 0;
               efn->size = data_size;
               efn->data_size = strlen(destination) + 1;
               efn->data = data2;
@@ -2323,6 +2587,8 @@ eet_alias(Eet_File   *ef,
         efn->name = strdup(name);
         efn->name_size = strlen(efn->name) + 1;
         efn->free_name = 1;
+        efn->data_direct = NULL;
+        efn->compress_pending = 0;
 
         efn->next = ef->header->directory->nodes[hash];
         ef->header->directory->nodes[hash] = efn;
@@ -2359,6 +2625,7 @@ eet_write_cipher(Eet_File   *ef,
    Eet_File_Node *efn;
    void *data2 = NULL;
    int exists_already = 0, data_size, hash, ret;
+   int pending = 0;
 
    /* check to see its' an eet file pointer */
    if (eet_check_pointer(ef))
@@ -2407,77 +2674,25 @@ eet_write_cipher(Eet_File   *ef,
    /* figure hash bucket */
    hash = _eet_hash_gen(name, ef->header->directory->size);
 
+   /* leave compression to the next flush, where it runs in parallel */
+   if ((comp) && (!cipher_key) && (ef->parallel_compression))
+     pending = 1;
+
    UNLOCK_FILE(ef);
-   
-   data_size = comp ? 12 + ((size * 101) / 100) : size;
-   if (comp)
-     {
-        ret = LZ4_compressBound(size);
-        if ((ret > 0) && (ret > data_size)) data_size = ret;
-     }
-   
-   if (comp || !cipher_key)
-     {
-        data2 = malloc(data_size);
-        if (!data2)
-          goto on_error;
-     }
+
+   data_size = size;
 
    /* if we want to compress */
-   if (comp)
+   if ((comp) && (!pending))
      {
-        switch (comp)
-          {
-           case EET_COMPRESSION_VERYFAST:
-             ret = LZ4_compressHC((const char *)data, (char *)data2, size);
-             if (ret <= 0)
-               {
-                  free(data2);
-                  LOCK_FILE(ef);
-                  goto on_error;
-               }
-             data_size = ret;
-             break;
-           case EET_COMPRESSION_SUPERFAST:
-             ret = LZ4_compress((const char *)data, (char *)data2, size);
-             if (ret <= 0)
-               {
-                  free(data2);
-                  LOCK_FILE(ef);
-                  goto on_error;
-               }
-             data_size = ret;
-             break;
-           default:
-               {
-                  uLongf buflen;
-
-                  /* compress the data with max compression */
-                  buflen = (uLongf)data_size;
-                  if (compress2((Bytef *)data2, &buflen, (Bytef *)data,
-                                (uLong)size, Z_BEST_COMPRESSION) != Z_OK)
-                    {
-                       free(data2);
-                       LOCK_FILE(ef);
-                       goto on_error;
-                    }
-                  /* record compressed chunk size */
-                  data_size = (int)buflen;
-               }
-          }
-        if ((data_size < 0) || (data_size >= size))
-          {
-             comp = 0;
-             data_size = size;
-          }
-        else
+        ret = eet_compress(data, size, comp, &data2, &data_size);
+        if (ret < 0)
           {
-             void *data3;
-
-             data3 = realloc(data2, data_size);
-             if (data3)
-               data2 = data3;
+             LOCK_FILE(ef);
+             goto on_error;
           }
+        if (ret == 0)
+          comp = 0;
      }
 
    if (cipher_key)
@@ -2504,9 +2719,17 @@ eet_write_cipher(Eet_File   *ef,
              cipher_key = NULL;
           }
      }
-   else
-   if (!comp)
-     memcpy(data2, data, size);
+
+   if (!data2)
+     {
+        data2 = malloc(size);
+        if (!data2)
+          {
+             LOCK_FILE(ef);
+             goto on_error;
+          }
+        memcpy(data2, data, size);
+     }
 
    LOCK_FILE(ef);
    /* Does this node already exist? */
@@ -2518,8 +2741,9 @@ eet_write_cipher(Eet_File   *ef,
               free(efn->data);
               efn->alias = 0;
               efn->ciphered = cipher_key ? 1 : 0;
-              efn->compression = !!comp;
+              efn->compression = comp && !pending;
               efn->compression_type = comp;
+              efn->compress_pending = pending;
               efn->size = data_size;
               efn->data_size = size;
               efn->data = data2;
@@ -2541,6 +2765,7 @@ eet_write_cipher(Eet_File   *ef,
         efn->name = strdup(name);
         efn->name_size = strlen(efn->name) + 1;
         efn->free_name = 1;
+        efn->data_direct = NULL;
 
         efn->next = ef->header->directory->nodes[hash];
         ef->header->directory->nodes[hash] = efn;
@@ -2548,8 +2773,9 @@ eet_write_cipher(Eet_File   *ef,
         efn->offset = ef->data_size + 1;
         efn->alias = 0;
         efn->ciphered = cipher_key ? 1 : 0;
-        efn->compression = !!comp;
+        efn->compression = comp && !pending;
         efn->compression_type = comp;
+        efn->compress_pending = pending;
         efn->size = data_size;
         efn->data_size = size;
         efn->data = data2;
@@ -76,10 +76,22 @@ static inline void _x86_cpuid(int op, int *a, int *b, int *c, int *d)
       "popl %%ebx       \n\t" /* restore the old %ebx */
 #endif
       : "=a" (*a), "=r" (*b), "=c" (*c), "=d" (*d)
-      : "a" (op)
+      : "a" (op), "c" (0)
       : "cc");
 }
 
+/* the low half of xcr0, the register states saved by the OS */
+static inline int _x86_xgetbv(void)
+{
+   int a, d;
+
+   __asm__ volatile (
+      ".byte 0x0f, 0x01, 0xd0 \n\t" /* xgetbv, not known by old assemblers */
+      : "=a" (a), "=d" (d)
+      : "c" (0));
+   return a;
+}
+
 static
 void _x86_simd(Eina_Cpu_Features *features)
 {
@@ -120,6 +132,23 @@ void _x86_simd(Eina_Cpu_Features *features)
 
    if ((c >> 20) & 1)
       *features |= EINA_CPU_SSE42;
+
+   /*
+    * avx2 is only usable when the OS saves the sse and avx states:
+    * ecx 27 = OSXSAVE, then xcr0 bits 1 and 2
+    * leaf 7 ebx
+    * 5 = AVX2
+    */
+   if (!((c >> 27) & 1) || ((_x86_xgetbv() & 6) != 6))
+      return;
+
+   _x86_cpuid(0, &a, &b, &c, &d);
+   if (a < 7)
+      return;
+
+   _x86_cpuid(7, &a, &b, &c, &d);
+   if ((b >> 5) & 1)
+      *features |= EINA_CPU_AVX2;
 }
 #endif
 
@@ -33,7 +33,8 @@ typedef enum _Eina_Cpu_Features
    EINA_CPU_NEON = 0x00000040,
    EINA_CPU_SSSE3 = 0x00000080,
    EINA_CPU_SSE41 = 0x00000100,
-   EINA_CPU_SSE42 = 0x00000200
+   EINA_CPU_SSE42 = 0x00000200,
+   EINA_CPU_AVX2 = 0x00000400 /**< @since 1.10 */
 } Eina_Cpu_Features;
 
 EAPI extern Eina_Cpu_Features eina_cpu_features;
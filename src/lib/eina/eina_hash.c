@@ -30,6 +30,10 @@
 # include <Evil.h>
 #endif
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 #include "eina_config.h"
 #include "eina_private.h"
 #include "eina_rbtree.h"
@@ -66,8 +70,15 @@
 
 #define EINA_HASH_RBTREE_MASK       0xFFFF
 
+#define EINA_HASH_FLAT_GROUP        16
+#define EINA_HASH_FLAT_INLINE_KEY   16
+#define EINA_HASH_FLAT_EMPTY        0x80
+#define EINA_HASH_FLAT_DELETED      0xFE
+
 typedef struct _Eina_Hash_Head         Eina_Hash_Head;
 typedef struct _Eina_Hash_Element      Eina_Hash_Element;
+typedef struct _Eina_Hash_Flat         Eina_Hash_Flat;
+typedef struct _Eina_Hash_Flat_Slot    Eina_Hash_Flat_Slot;
 typedef struct _Eina_Hash_Foreach_Data Eina_Hash_Foreach_Data;
 typedef struct _Eina_Iterator_Hash     Eina_Iterator_Hash;
 typedef struct _Eina_Hash_Each         Eina_Hash_Each;
@@ -87,9 +98,30 @@ struct _Eina_Hash
 
    int             buckets_power_size;
 
+   Eina_Hash_Flat *flat; /* open addressing table instead of buckets */
+
    EINA_MAGIC
 };
 
+struct _Eina_Hash_Flat
+{
+   unsigned char       *ctrl; /* EMPTY, DELETED or 7 bits of the slot hash */
+   Eina_Hash_Flat_Slot *slots;
+   unsigned int         size;
+   unsigned int         growth_left; /* EMPTY slots we can still fill */
+};
+
+struct _Eina_Hash_Flat_Slot
+{
+   Eina_Hash_Tuple tuple;
+   unsigned int    hash;
+   Eina_Bool       key_alloc;
+   union {
+      uint64_t     align;
+      char         key[EINA_HASH_FLAT_INLINE_KEY];
+   } inline_key;
+};
+
 struct _Eina_Hash_Head
 {
    EINA_RBTREE;
@@ -126,6 +158,7 @@ struct _Eina_Iterator_Hash
    Eina_Iterator                     *list;
    Eina_Hash_Head                    *hash_head;
    Eina_Hash_Element                 *hash_element;
+   Eina_Hash_Tuple                   *tuple;
    int                                bucket;
 
    int                                index;
@@ -206,6 +239,316 @@ _eina_hash_key_rbtree_cmp_node(const Eina_Hash_Element *left,
    return EINA_RBTREE_RIGHT;
 }
 
+/* Open addressing variant, see eina_hash_flat_new().
+ *
+ * Slots are split in groups of EINA_HASH_FLAT_GROUP, each slot having a
+ * control byte holding either EMPTY, DELETED or the low 7 bits of its
+ * hash. A lookup compares a whole group of control bytes at once and
+ * only looks at the slots whose control byte matches, stopping at the
+ * first group that still has an EMPTY slot. Groups are probed
+ * quadratically, which visits all of them as their number is a power
+ * of 2. Keys that fit in a slot are stored inline, so most insertions
+ * don't allocate anything. */
+static inline unsigned int
+_eina_hash_flat_match(const unsigned char *ctrl, unsigned char c)
+{
+#ifdef __SSE2__
+   __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)c)));
+#else
+   unsigned int mask = 0;
+   unsigned int i;
+
+   for (i = 0; i < EINA_HASH_FLAT_GROUP; i++)
+     if (ctrl[i] == c) mask |= 1 << i;
+   return mask;
+#endif
+}
+
+/* EMPTY and DELETED are the only control bytes with the high bit set */
+static inline unsigned int
+_eina_hash_flat_match_free(const unsigned char *ctrl)
+{
+#ifdef __SSE2__
+   return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+   unsigned int mask = 0;
+   unsigned int i;
+
+   for (i = 0; i < EINA_HASH_FLAT_GROUP; i++)
+     if (ctrl[i] & 0x80) mask |= 1 << i;
+   return mask;
+#endif
+}
+
+static inline unsigned int
+_eina_hash_flat_first(unsigned int mask)
+{
+#ifdef __GNUC__
+   return __builtin_ctz(mask);
+#else
+   unsigned int i = 0;
+
+   while (!(mask & 1))
+     {
+        mask >>= 1;
+        i++;
+     }
+   return i;
+#endif
+}
+
+static Eina_Hash_Flat_Slot *
+_eina_hash_flat_find(const Eina_Hash *hash,
+                     const void *key, int key_length,
+                     unsigned int key_hash,
+                     const void *data)
+{
+   const Eina_Hash_Flat *flat = hash->flat;
+   unsigned int groups_mask;
+   unsigned int group;
+   unsigned int step;
+
+   if (!flat->ctrl) return NULL;
+
+   groups_mask = flat->size / EINA_HASH_FLAT_GROUP - 1;
+   group = (key_hash >> 7) & groups_mask;
+   for (step = 1; step <= groups_mask + 1; step++)
+     {
+        const unsigned char *ctrl = flat->ctrl + group * EINA_HASH_FLAT_GROUP;
+        unsigned int match;
+
+        match = _eina_hash_flat_match(ctrl, key_hash & 0x7F);
+        while (match)
+          {
+             Eina_Hash_Flat_Slot *slot;
+
+             slot = flat->slots + group * EINA_HASH_FLAT_GROUP
+               + _eina_hash_flat_first(match);
+             if ((slot->hash == key_hash) &&
+                 (!hash->key_cmp_cb(slot->tuple.key, slot->tuple.key_length,
+                                    key, key_length)) &&
+                 ((!data) || (slot->tuple.data == data)))
+               return slot;
+             match &= match - 1;
+          }
+
+        if (_eina_hash_flat_match(ctrl, EINA_HASH_FLAT_EMPTY))
+          return NULL;
+
+        group = (group + step) & groups_mask;
+     }
+
+   return NULL;
+}
+
+static Eina_Hash_Flat_Slot *
+_eina_hash_flat_find_by_data(const Eina_Hash *hash, const void *data)
+{
+   const Eina_Hash_Flat *flat = hash->flat;
+   unsigned int i;
+
+   for (i = 0; i < flat->size; i++)
+     if (!(flat->ctrl[i] & 0x80) && (flat->slots[i].tuple.data == data))
+       return flat->slots + i;
+
+   return NULL;
+}
+
+/* first EMPTY or DELETED slot on the probe sequence of key_hash */
+static unsigned int
+_eina_hash_flat_free_find(const Eina_Hash_Flat *flat, unsigned int key_hash)
+{
+   unsigned int groups_mask = flat->size / EINA_HASH_FLAT_GROUP - 1;
+   unsigned int group = (key_hash >> 7) & groups_mask;
+   unsigned int step = 1;
+   unsigned int match;
+
+   /* there is always an EMPTY slot left, see growth_left */
+   while (!(match = _eina_hash_flat_match_free(flat->ctrl + group * EINA_HASH_FLAT_GROUP)))
+     group = (group + step++) & groups_mask;
+
+   return group * EINA_HASH_FLAT_GROUP + _eina_hash_flat_first(match);
+}
+
+static Eina_Bool
+_eina_hash_flat_rehash(Eina_Hash *hash, unsigned int population)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   Eina_Hash_Flat_Slot *slots;
+   unsigned char *ctrl;
+   unsigned int size = EINA_HASH_FLAT_GROUP;
+   unsigned int i;
+
+   /* keep at least 1/8 of the slots EMPTY so probing always ends, and
+      leave a quarter of the usable slots free so that tombstones can't
+      make us rehash at every insertion */
+   while (population > (size - size / 8) * 3 / 4)
+     size <<= 1;
+
+   slots = malloc(size * (sizeof (Eina_Hash_Flat_Slot) + 1));
+   if (!slots) return EINA_FALSE;
+   ctrl = (unsigned char *)(slots + size);
+   memset(ctrl, EINA_HASH_FLAT_EMPTY, size);
+
+   if (flat->ctrl)
+     {
+        Eina_Hash_Flat old = *flat;
+
+        flat->ctrl = ctrl;
+        flat->slots = slots;
+        flat->size = size;
+
+        for (i = 0; i < old.size; i++)
+          {
+             Eina_Hash_Flat_Slot *slot;
+             unsigned int index;
+
+             if (old.ctrl[i] & 0x80) continue;
+
+             index = _eina_hash_flat_free_find(flat, old.slots[i].hash);
+             slot = slots + index;
+             *slot = old.slots[i];
+             if (old.slots[i].tuple.key == old.slots[i].inline_key.key)
+               slot->tuple.key = slot->inline_key.key;
+             ctrl[index] = old.ctrl[i];
+          }
+
+        free(old.slots);
+     }
+   else
+     {
+        flat->ctrl = ctrl;
+        flat->slots = slots;
+        flat->size = size;
+     }
+
+   flat->growth_left = size - size / 8 - hash->population;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_eina_hash_flat_add(Eina_Hash *hash,
+                    const void *key, int key_length, int alloc_length,
+                    int key_hash,
+                    const void *data)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   Eina_Hash_Flat_Slot *slot;
+   unsigned int h = _fmix32(key_hash);
+   unsigned int index;
+   char *copy = NULL;
+
+   if (alloc_length > EINA_HASH_FLAT_INLINE_KEY)
+     {
+        copy = malloc(alloc_length);
+        if (!copy) return EINA_FALSE;
+        memcpy(copy, key, alloc_length);
+     }
+
+   if ((!flat->growth_left) &&
+       (!_eina_hash_flat_rehash(hash, hash->population + 1)))
+     {
+        free(copy);
+        return EINA_FALSE;
+     }
+
+   index = _eina_hash_flat_free_find(flat, h);
+   if (flat->ctrl[index] == EINA_HASH_FLAT_EMPTY)
+     flat->growth_left--;
+
+   slot = flat->slots + index;
+   slot->hash = h;
+   slot->tuple.key_length = key_length;
+   slot->tuple.data = (void *)data;
+   slot->key_alloc = !!copy;
+   if (copy)
+     slot->tuple.key = copy;
+   else if (alloc_length > 0)
+     {
+        memcpy(slot->inline_key.key, key, alloc_length);
+        slot->tuple.key = slot->inline_key.key;
+     }
+   else
+     slot->tuple.key = key;
+
+   flat->ctrl[index] = h & 0x7F;
+   hash->population++;
+   return EINA_TRUE;
+}
+
+static void
+_eina_hash_flat_del(Eina_Hash *hash, Eina_Hash_Flat_Slot *slot)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   unsigned int index = slot - flat->slots;
+   void *data = slot->tuple.data;
+
+   if (slot->key_alloc)
+     free((void *)slot->tuple.key);
+
+   /* a group that still has an EMPTY slot never made a probe go further,
+      so the slot can become EMPTY again instead of a tombstone */
+   if (_eina_hash_flat_match(flat->ctrl + (index & ~(EINA_HASH_FLAT_GROUP - 1)),
+                             EINA_HASH_FLAT_EMPTY))
+     {
+        flat->ctrl[index] = EINA_HASH_FLAT_EMPTY;
+        flat->growth_left++;
+     }
+   else
+     flat->ctrl[index] = EINA_HASH_FLAT_DELETED;
+
+   hash->population--;
+
+   if (hash->data_free_cb)
+     hash->data_free_cb(data);
+}
+
+static void
+_eina_hash_flat_free_buckets(Eina_Hash *hash)
+{
+   Eina_Hash_Flat *flat = hash->flat;
+   Eina_Hash_Flat old = *flat;
+   unsigned int i;
+
+   if (!old.ctrl) return;
+
+   /* detach the table first, data_free_cb could look into the hash */
+   flat->ctrl = NULL;
+   flat->slots = NULL;
+   flat->size = 0;
+   flat->growth_left = 0;
+   hash->population = 0;
+
+   for (i = 0; i < old.size; i++)
+     {
+        if (old.ctrl[i] & 0x80) continue;
+
+        if (old.slots[i].key_alloc)
+          free((void *)old.slots[i].tuple.key);
+        if (hash->data_free_cb)
+          hash->data_free_cb(old.slots[i].tuple.data);
+     }
+
+   free(old.slots);
+}
+
+static int
+_eina_stringshared_key_hash(const char *key, EINA_UNUSED int key_length)
+{
+   /* stringshared keys are unique, their address is a fine key */
+#ifdef EFL64
+   unsigned long long int k = (uintptr_t)key;
+
+   return eina_hash_int64(&k, sizeof (k));
+#else
+   unsigned int k = (uintptr_t)key;
+
+   return eina_hash_int32(&k, sizeof (k));
+#endif
+}
+
 static inline Eina_Bool
 eina_hash_add_alloc_by_hash(Eina_Hash *hash,
                             const void *key, int key_length, int alloc_length,
@@ -221,6 +564,10 @@ eina_hash_add_alloc_by_hash(Eina_Hash *hash,
    EINA_SAFETY_ON_NULL_RETURN_VAL(data, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
+   if (hash->flat)
+     return _eina_hash_flat_add(hash, key, key_length, alloc_length,
+                                key_hash, data);
+
    /* Apply eina mask to hash. */
    hash_num = key_hash & hash->mask;
    key_hash >>= hash->buckets_power_size;
@@ -452,6 +799,19 @@ _eina_hash_del_by_key_hash(Eina_Hash *hash,
    EINA_SAFETY_ON_NULL_RETURN_VAL(key, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
+   if (hash->flat)
+     {
+        Eina_Hash_Flat_Slot *slot;
+
+        slot = _eina_hash_flat_find(hash, key, key_length,
+                                    _fmix32(key_hash), data);
+        if (!slot)
+          return EINA_FALSE;
+
+        _eina_hash_flat_del(hash, slot);
+        return EINA_TRUE;
+     }
+
    if (!hash->buckets)
      return EINA_FALSE;
 
@@ -475,7 +835,7 @@ _eina_hash_del_by_key(Eina_Hash *hash, const void *key, const void *data)
    EINA_SAFETY_ON_NULL_RETURN_VAL(key, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
-   if (!hash->buckets)
+   if ((!hash->buckets) && (!hash->flat))
      return EINA_FALSE;
 
    key_length = hash->key_length_cb ? hash->key_length_cb(key) : 0;
@@ -550,46 +910,39 @@ _eina_foreach_cb(const Eina_Hash *hash,
 static void *
 _eina_hash_iterator_data_get_content(Eina_Iterator_Hash *it)
 {
-   Eina_Hash_Element *stuff;
+   Eina_Hash_Tuple *stuff;
 
    EINA_MAGIC_CHECK_HASH_ITERATOR(it, NULL);
 
-   stuff = it->hash_element;
+   stuff = it->tuple;
 
    if (!stuff)
      return NULL;
 
-   return stuff->tuple.data;
+   return stuff->data;
 }
 
 static void *
 _eina_hash_iterator_key_get_content(Eina_Iterator_Hash *it)
 {
-   Eina_Hash_Element *stuff;
+   Eina_Hash_Tuple *stuff;
 
    EINA_MAGIC_CHECK_HASH_ITERATOR(it, NULL);
 
-   stuff = it->hash_element;
+   stuff = it->tuple;
 
    if (!stuff)
      return NULL;
 
-   return (void *)stuff->tuple.key;
+   return (void *)stuff->key;
 }
 
 static Eina_Hash_Tuple *
 _eina_hash_iterator_tuple_get_content(Eina_Iterator_Hash *it)
 {
-   Eina_Hash_Element *stuff;
-
    EINA_MAGIC_CHECK_HASH_ITERATOR(it, NULL);
 
-   stuff = it->hash_element;
-
-   if (!stuff)
-     return NULL;
-
-   return &stuff->tuple;
+   return it->tuple;
 }
 
 static Eina_Bool
@@ -663,11 +1016,34 @@ _eina_hash_iterator_next(Eina_Iterator_Hash *it, void **data)
    it->bucket = bucket;
 
    if (ok)
-     *data = it->get_content(it);
+     {
+        it->tuple = &it->hash_element->tuple;
+        *data = it->get_content(it);
+     }
 
    return ok;
 }
 
+static Eina_Bool
+_eina_hash_flat_iterator_next(Eina_Iterator_Hash *it, void **data)
+{
+   const Eina_Hash_Flat *flat = it->hash->flat;
+
+   /* bucket is the next slot to look at */
+   while ((unsigned int)it->bucket < flat->size)
+     {
+        unsigned int i = it->bucket++;
+
+        if (flat->ctrl[i] & 0x80) continue;
+
+        it->tuple = &flat->slots[i].tuple;
+        *data = it->get_content(it);
+        return EINA_TRUE;
+     }
+
+   return EINA_FALSE;
+}
+
 static void *
 _eina_hash_iterator_get_container(Eina_Iterator_Hash *it)
 {
@@ -735,6 +1111,7 @@ eina_hash_new(Eina_Key_Length key_length_cb,
    new->key_hash_cb = key_hash_cb;
    new->data_free_cb = data_free_cb;
    new->buckets = NULL;
+   new->flat = NULL;
    new->population = 0;
 
    new->size = 1 << buckets_power_size;
@@ -825,6 +1202,79 @@ eina_hash_stringshared_new(Eina_Free_Cb data_free_cb)
                         EINA_HASH_BUCKET_SIZE);
 }
 
+EAPI Eina_Hash *
+eina_hash_flat_new(Eina_Key_Length key_length_cb,
+                   Eina_Key_Cmp key_cmp_cb,
+                   Eina_Key_Hash key_hash_cb,
+                   Eina_Free_Cb data_free_cb)
+{
+   Eina_Hash *new;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(key_cmp_cb, NULL);
+   EINA_SAFETY_ON_NULL_RETURN_VAL(key_hash_cb, NULL);
+
+   /* the table itself is only allocated on first add */
+   new = calloc(1, sizeof (Eina_Hash) + sizeof (Eina_Hash_Flat));
+   if (!new)
+     return NULL;
+
+   EINA_MAGIC_SET(new, EINA_MAGIC_HASH);
+
+   new->key_length_cb = key_length_cb;
+   new->key_cmp_cb = key_cmp_cb;
+   new->key_hash_cb = key_hash_cb;
+   new->data_free_cb = data_free_cb;
+   new->flat = (Eina_Hash_Flat *)(new + 1);
+
+   return new;
+}
+
+EAPI Eina_Hash *
+eina_hash_flat_string_new(Eina_Free_Cb data_free_cb)
+{
+   return eina_hash_flat_new(EINA_KEY_LENGTH(_eina_string_key_length),
+                             EINA_KEY_CMP(_eina_string_key_cmp),
+                             EINA_KEY_HASH(eina_hash_superfast),
+                             data_free_cb);
+}
+
+EAPI Eina_Hash *
+eina_hash_flat_stringshared_new(Eina_Free_Cb data_free_cb)
+{
+   return eina_hash_flat_new(NULL,
+                             EINA_KEY_CMP(_eina_stringshared_key_cmp),
+                             EINA_KEY_HASH(_eina_stringshared_key_hash),
+                             data_free_cb);
+}
+
+EAPI Eina_Hash *
+eina_hash_flat_int32_new(Eina_Free_Cb data_free_cb)
+{
+   return eina_hash_flat_new(EINA_KEY_LENGTH(_eina_int32_key_length),
+                             EINA_KEY_CMP(_eina_int32_key_cmp),
+                             EINA_KEY_HASH(eina_hash_int32),
+                             data_free_cb);
+}
+
+EAPI Eina_Hash *
+eina_hash_flat_int64_new(Eina_Free_Cb data_free_cb)
+{
+   return eina_hash_flat_new(EINA_KEY_LENGTH(_eina_int64_key_length),
+                             EINA_KEY_CMP(_eina_int64_key_cmp),
+                             EINA_KEY_HASH(eina_hash_int64),
+                             data_free_cb);
+}
+
+EAPI Eina_Hash *
+eina_hash_flat_pointer_new(Eina_Free_Cb data_free_cb)
+{
+#ifdef EFL64
+   return eina_hash_flat_int64_new(data_free_cb);
+#else
+   return eina_hash_flat_int32_new(data_free_cb);
+#endif
+}
+
 EAPI int
 eina_hash_population(const Eina_Hash *hash)
 {
@@ -844,7 +1294,9 @@ eina_hash_free(Eina_Hash *hash)
 
    EINA_MAGIC_CHECK_HASH(hash);
 
-   if (hash->buckets)
+   if (hash->flat)
+     _eina_hash_flat_free_buckets(hash);
+   else if (hash->buckets)
      {
         for (i = 0; i < hash->size; i++)
           eina_rbtree_delete(hash->buckets[i], EINA_RBTREE_FREE_CB(_eina_hash_head_free), hash);
@@ -862,7 +1314,9 @@ eina_hash_free_buckets(Eina_Hash *hash)
 
    EINA_MAGIC_CHECK_HASH(hash);
 
-   if (hash->buckets)
+   if (hash->flat)
+     _eina_hash_flat_free_buckets(hash);
+   else if (hash->buckets)
      {
         for (i = 0; i < hash->size; i++)
           eina_rbtree_delete(hash->buckets[i],
@@ -966,6 +1420,18 @@ eina_hash_del_by_data(Eina_Hash *hash, const void *data)
    EINA_SAFETY_ON_NULL_RETURN_VAL(data, EINA_FALSE);
    EINA_MAGIC_CHECK_HASH(hash);
 
+   if (hash->flat)
+     {
+        Eina_Hash_Flat_Slot *slot;
+
+        slot = _eina_hash_flat_find_by_data(hash, data);
+        if (!slot)
+          goto error;
+
+        _eina_hash_flat_del(hash, slot);
+        return EINA_TRUE;
+     }
+
    hash_element = _eina_hash_find_by_data(hash, data, &key_hash, &hash_head);
    if (!hash_element)
      goto error;
@@ -1027,6 +1493,15 @@ eina_hash_find_by_hash(const Eina_Hash *hash,
    EINA_SAFETY_ON_NULL_RETURN_VAL(key, NULL);
    EINA_MAGIC_CHECK_HASH(hash);
 
+   if (hash->flat)
+     {
+        Eina_Hash_Flat_Slot *slot;
+
+        slot = _eina_hash_flat_find(hash, key, key_length,
+                                    _fmix32(key_hash), NULL);
+        return slot ? slot->tuple.data : NULL;
+     }
+
    tuple.key = key;
    tuple.key_length = key_length;
    tuple.data = NULL;
@@ -1074,6 +1549,20 @@ eina_hash_modify_by_hash(Eina_Hash *hash,
    EINA_SAFETY_ON_NULL_RETURN_VAL(data, NULL);
    EINA_MAGIC_CHECK_HASH(hash);
 
+   if (hash->flat)
+     {
+        Eina_Hash_Flat_Slot *slot;
+
+        slot = _eina_hash_flat_find(hash, key, key_length,
+                                    _fmix32(key_hash), NULL);
+        if (slot)
+          {
+             old_data = slot->tuple.data;
+             slot->tuple.data = (void *)data;
+          }
+        return old_data;
+     }
+
    tuple.key = key;
    tuple.key_length = key_length;
    tuple.data = NULL;
@@ -1093,7 +1582,7 @@ eina_hash_set(Eina_Hash *hash, const void *key, const void *data)
 {
    Eina_Hash_Tuple tuple;
    Eina_Hash_Head *hash_head;
-   Eina_Hash_Element *hash_element;
+   Eina_Hash_Element *hash_element = NULL;
    int key_length;
    int key_hash;
 
@@ -1105,11 +1594,38 @@ eina_hash_set(Eina_Hash *hash, const void *key, const void *data)
    key_length = hash->key_length_cb ? hash->key_length_cb(key) : 0;
    key_hash = hash->key_hash_cb(key, key_length);
 
-   tuple.key = key;
-   tuple.key_length = key_length;
-   tuple.data = NULL;
+   if (hash->flat)
+     {
+        Eina_Hash_Flat_Slot *slot;
+
+        slot = _eina_hash_flat_find(hash, key, key_length,
+                                    _fmix32(key_hash), NULL);
+        if (slot)
+          {
+             void *old_data = slot->tuple.data;
+
+             if (data)
+               slot->tuple.data = (void *)data;
+             else
+               {
+                  Eina_Free_Cb cb = hash->data_free_cb;
+                  hash->data_free_cb = NULL;
+                  _eina_hash_flat_del(hash, slot);
+                  hash->data_free_cb = cb;
+               }
+
+             return old_data;
+          }
+     }
+   else
+     {
+        tuple.key = key;
+        tuple.key_length = key_length;
+        tuple.data = NULL;
+
+        hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
+     }
 
-   hash_element = _eina_hash_find_by_hash(hash, &tuple, key_hash, &hash_head);
    if (hash_element)
      {
         void *old_data = NULL;
@@ -1230,7 +1746,10 @@ eina_hash_iterator_data_new(const Eina_Hash *hash)
    it->get_content = FUNC_ITERATOR_GET_CONTENT(_eina_hash_iterator_data_get_content);
 
    it->iterator.version = EINA_ITERATOR_VERSION;
-   it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_iterator_next);
+   if (hash->flat)
+     it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_flat_iterator_next);
+   else
+     it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_iterator_next);
    it->iterator.get_container = FUNC_ITERATOR_GET_CONTAINER(
        _eina_hash_iterator_get_container);
    it->iterator.free = FUNC_ITERATOR_FREE(_eina_hash_iterator_free);
@@ -1257,7 +1776,10 @@ eina_hash_iterator_key_new(const Eina_Hash *hash)
        _eina_hash_iterator_key_get_content);
 
    it->iterator.version = EINA_ITERATOR_VERSION;
-   it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_iterator_next);
+   if (hash->flat)
+     it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_flat_iterator_next);
+   else
+     it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_iterator_next);
    it->iterator.get_container = FUNC_ITERATOR_GET_CONTAINER(
        _eina_hash_iterator_get_container);
    it->iterator.free = FUNC_ITERATOR_FREE(_eina_hash_iterator_free);
@@ -1284,7 +1806,10 @@ eina_hash_iterator_tuple_new(const Eina_Hash *hash)
        _eina_hash_iterator_tuple_get_content);
 
    it->iterator.version = EINA_ITERATOR_VERSION;
-   it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_iterator_next);
+   if (hash->flat)
+     it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_flat_iterator_next);
+   else
+     it->iterator.next = FUNC_ITERATOR_NEXT(_eina_hash_iterator_next);
    it->iterator.get_container = FUNC_ITERATOR_GET_CONTAINER(
        _eina_hash_iterator_get_container);
    it->iterator.free = FUNC_ITERATOR_FREE(_eina_hash_iterator_free);
@@ -528,6 +528,110 @@ EAPI Eina_Hash *eina_hash_pointer_new(Eina_Free_Cb data_free_cb);
  */
 EAPI Eina_Hash *eina_hash_stringshared_new(Eina_Free_Cb data_free_cb);
 
+/**
+ * @brief Create a new hash table using open addressing.
+ *
+ * @param key_length_cb The function called when getting the size of the key.
+ * @param key_cmp_cb The function called when comparing the keys.
+ * @param key_hash_cb The function called when getting the values.
+ * @param data_free_cb The function called on each value when the hash table is
+ * freed, or when an item is deleted from it. @c NULL can be passed as
+ * callback.
+ * @return The new hash table.
+ *
+ * This function creates a new hash table that is used exactly like one
+ * returned by eina_hash_new(), but that stores its items in a single
+ * array of slots instead of trees of buckets. Lookups compare a group
+ * of slots at once and keys of up to 16 bytes are copied inside their
+ * slot, so finding, adding and removing items touches far less memory
+ * and adding most items doesn't allocate anything. The array grows as
+ * needed, so there is no bucket size to choose.
+ *
+ * As items move when the array grows, keys and tuples returned by the
+ * iterators, as well as keys copied by the hash, are only valid until
+ * the next item is added. Deleting items while iterating is fine.
+ * On failure, this function returns @c NULL.
+ *
+ * @since 1.10
+ */
+EAPI Eina_Hash *eina_hash_flat_new(Eina_Key_Length key_length_cb,
+                                   Eina_Key_Cmp    key_cmp_cb,
+                                   Eina_Key_Hash   key_hash_cb,
+                                   Eina_Free_Cb    data_free_cb) EINA_MALLOC EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(2, 3);
+
+/**
+ * @brief Create a new open addressing hash table for use with strings.
+ *
+ * @param data_free_cb The function called on each value when the hash table
+ * is freed, or when an item is deleted from it. @c NULL can be passed as
+ * callback.
+ * @return The new hash table.
+ *
+ * Same as eina_hash_string_superfast_new(), but using
+ * eina_hash_flat_new().
+ *
+ * @since 1.10
+ */
+EAPI Eina_Hash *eina_hash_flat_string_new(Eina_Free_Cb data_free_cb);
+
+/**
+ * @brief Create a new open addressing hash table for stringshared keys.
+ *
+ * @param data_free_cb The function called on each value when the hash table
+ * is freed, or when an item is deleted from it. @c NULL can be passed as
+ * callback.
+ * @return The new hash table.
+ *
+ * Same as eina_hash_stringshared_new(), but using eina_hash_flat_new().
+ * Keys are hashed by address, so values CAN NOT be looked up with
+ * pointers not equal to the original key pointer.
+ *
+ * @since 1.10
+ */
+EAPI Eina_Hash *eina_hash_flat_stringshared_new(Eina_Free_Cb data_free_cb);
+
+/**
+ * @brief Create a new open addressing hash table for 32bit integers.
+ *
+ * @param data_free_cb The function called on each value when the hash table
+ * is freed, or when an item is deleted from it. @c NULL can be passed as
+ * callback.
+ * @return The new hash table.
+ *
+ * Same as eina_hash_int32_new(), but using eina_hash_flat_new().
+ *
+ * @since 1.10
+ */
+EAPI Eina_Hash *eina_hash_flat_int32_new(Eina_Free_Cb data_free_cb);
+
+/**
+ * @brief Create a new open addressing hash table for 64bit integers.
+ *
+ * @param data_free_cb The function called on each value when the hash table
+ * is freed, or when an item is deleted from it. @c NULL can be passed as
+ * callback.
+ * @return The new hash table.
+ *
+ * Same as eina_hash_int64_new(), but using eina_hash_flat_new().
+ *
+ * @since 1.10
+ */
+EAPI Eina_Hash *eina_hash_flat_int64_new(Eina_Free_Cb data_free_cb);
+
+/**
+ * @brief Create a new open addressing hash table for use with pointers.
+ *
+ * @param data_free_cb The function called on each value when the hash table
+ * is freed, or when an item is deleted from it. @c NULL can be passed as
+ * callback.
+ * @return The new hash table.
+ *
+ * Same as eina_hash_pointer_new(), but using eina_hash_flat_new().
+ *
+ * @since 1.10
+ */
+EAPI Eina_Hash *eina_hash_flat_pointer_new(Eina_Free_Cb data_free_cb);
+
 /**
  * @brief Add an entry to the given hash table.
  *
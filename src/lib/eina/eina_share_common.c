@@ -70,7 +70,6 @@
 #include "eina_config.h"
 #include "eina_private.h"
 #include "eina_hash.h"
-#include "eina_rbtree.h"
 #include "eina_lock.h"
 
 /* undefs EINA_ARG_NONULL() so NULL checks are not compiled out! */
@@ -85,26 +84,31 @@
  * @cond LOCAL
  */
 
+
 #define EINA_SHARE_COMMON_BUCKETS 256
 #define EINA_SHARE_COMMON_MASK 0xFF
 #define EINA_SHARE_COMMON_BUCKET_IDX(h) ((h >> 8) & EINA_SHARE_COMMON_MASK)
 #define EINA_SHARE_COMMON_NODE_HASH(h) (h & EINA_SHARE_COMMON_MASK)
 
+/*
+ * Looking up a string that is already shared never takes a lock. Chains
+ * are only modified with the lock of their bucket held and new nodes are
+ * published with release semantic, so a reader always walks a consistent
+ * chain. A node is only freed once every reader that could still see it
+ * left its bucket, see _eina_share_common_bucket_synchronize().
+ */
+#define EINA_SHARE_COMMON_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define EINA_SHARE_COMMON_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define EINA_SHARE_COMMON_CAS(p, old, new)                              \
+   __atomic_compare_exchange_n((p), &(old), (new), EINA_FALSE,          \
+                               __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)
+#define EINA_SHARE_COMMON_INC(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define EINA_SHARE_COMMON_DEC(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+
 static const char EINA_MAGIC_SHARE_STR[] = "Eina Share";
-static const char EINA_MAGIC_SHARE_HEAD_STR[] = "Eina Share Head";
 
 static int _eina_share_common_count = 0;
 
-#define EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(d, unlock, ...)      \
-   do {                                                          \
-        if (!EINA_MAGIC_CHECK((d), EINA_MAGIC_SHARE_HEAD))  \
-          {                                                           \
-             EINA_MAGIC_FAIL((d), EINA_MAGIC_SHARE_HEAD);    \
-             unlock;                                                 \
-             return __VA_ARGS__;                                     \
-          }                                                           \
-     } while (0)
-
 #define EINA_MAGIC_CHECK_SHARE_COMMON_NODE(d, _node_magic, unlock)              \
    do {                                                          \
         if (!EINA_MAGIC_CHECK((d), _node_magic))    \
@@ -124,8 +128,8 @@ struct _Eina_Share_Common_Population
 #endif
 
 typedef struct _Eina_Share_Common Eina_Share_Common;
+typedef struct _Eina_Share_Common_Bucket Eina_Share_Common_Bucket;
 typedef struct _Eina_Share_Common_Node Eina_Share_Common_Node;
-typedef struct _Eina_Share_Common_Head Eina_Share_Common_Head;
 
 struct _Eina_Share
 {
@@ -138,9 +142,23 @@ struct _Eina_Share
 #endif
 };
 
+struct _Eina_Share_Common_Bucket
+{
+   Eina_Spinlock lock; /* serialize writers of this bucket */
+
+   /* EINA_SHARE_COMMON_BUCKETS chains, allocated on first insertion */
+   Eina_Share_Common_Node **nodes;
+
+   int epoch;
+   int readers[2];
+
+   /* readers write to the bucket, keep them away from their neighbours */
+   char padding[64];
+};
+
 struct _Eina_Share_Common
 {
-   Eina_Share_Common_Head *buckets[EINA_SHARE_COMMON_BUCKETS];
+   Eina_Share_Common_Bucket buckets[EINA_SHARE_COMMON_BUCKETS];
 
    EINA_MAGIC
 };
@@ -151,26 +169,12 @@ struct _Eina_Share_Common_Node
 
    EINA_MAGIC
 
+   int hash;
    unsigned int length;
    unsigned int references;
    char str[];
 };
 
-struct _Eina_Share_Common_Head
-{
-   EINA_RBTREE;
-   EINA_MAGIC
-
-   int hash;
-
-#ifdef EINA_STRINGSHARE_USAGE
-   int population;
-#endif
-
-   Eina_Share_Common_Node *head;
-   Eina_Share_Common_Node builtin_node;
-};
-
 Eina_Bool _share_common_threads_activated = EINA_FALSE;
 
 static Eina_Spinlock _mutex_big;
@@ -235,9 +239,10 @@ _eina_share_common_population_stats(Eina_Share *share)
               share->population_group[i].max);
 }
 
-static void
-eina_share_common_population_nolock_add(Eina_Share *share, int slen)
+void
+eina_share_common_population_add(Eina_Share *share, int slen)
 {
+   eina_spinlock_take(&_mutex_big);
    share->population.count++;
    if (share->population.count > share->population.max)
       share->population.max = share->population.count;
@@ -250,53 +255,32 @@ eina_share_common_population_nolock_add(Eina_Share *share, int slen)
            share->population_group[slen].max =
               share->population_group[slen].count;
      }
+   eina_spinlock_release(&_mutex_big);
 }
 
 void
-eina_share_common_population_add(Eina_Share *share, int slen)
+eina_share_common_population_del(Eina_Share *share, int slen)
 {
    eina_spinlock_take(&_mutex_big);
-   eina_share_common_population_nolock_add(share, slen);
-   eina_spinlock_release(&_mutex_big);
-}
-
-static void
-eina_share_common_population_nolock_del(Eina_Share *share, int slen)
-{
    share->population.count--;
    if (slen < 4)
       share->population_group[slen].count--;
-}
-
-void
-eina_share_common_population_del(Eina_Share *share, int slen)
-{
-   eina_spinlock_take(&_mutex_big);
-   eina_share_common_population_nolock_del(share, slen);
    eina_spinlock_release(&_mutex_big);
 }
 
 static void
-_eina_share_common_population_head_init(EINA_UNUSED Eina_Share *share,
-                                        Eina_Share_Common_Head *head)
+_eina_share_common_population_chain(Eina_Share *share,
+                                    const Eina_Share_Common_Node *node)
 {
-   head->population = 1;
-}
+   int population = 0;
 
-static void
-_eina_share_common_population_head_add(Eina_Share *share,
-                                       Eina_Share_Common_Head *head)
-{
-   head->population++;
-   if (head->population > share->max_node_population)
-      share->max_node_population = head->population;
-}
+   for (; node; node = node->next)
+     population++;
 
-static void
-_eina_share_common_population_head_del(EINA_UNUSED Eina_Share *share,
-                                       Eina_Share_Common_Head *head)
-{
-   head->population--;
+   eina_spinlock_take(&_mutex_big);
+   if (population > share->max_node_population)
+      share->max_node_population = population;
+   eina_spinlock_release(&_mutex_big);
 }
 
 #else /* EINA_STRINGSHARE_USAGE undefined */
@@ -308,73 +292,54 @@ static void _eina_share_common_population_shutdown(EINA_UNUSED Eina_Share *share
 }
 static void _eina_share_common_population_stats(EINA_UNUSED Eina_Share *share) {
 }
-static void eina_share_common_population_nolock_add(EINA_UNUSED Eina_Share *share,
-                                                    EINA_UNUSED int slen) {
-}
 void eina_share_common_population_add(EINA_UNUSED Eina_Share *share,
                                       EINA_UNUSED int slen) {
 }
-static void eina_share_common_population_nolock_del(EINA_UNUSED Eina_Share *share,
-                                                    EINA_UNUSED int slen) {
-}
 void eina_share_common_population_del(EINA_UNUSED Eina_Share *share,
                                       EINA_UNUSED int slen) {
 }
-static void _eina_share_common_population_head_init(
-   EINA_UNUSED Eina_Share *share,
-   EINA_UNUSED Eina_Share_Common_Head *head) {
-}
-static void _eina_share_common_population_head_add(
+static void _eina_share_common_population_chain(
    EINA_UNUSED Eina_Share *share,
-   EINA_UNUSED
-   Eina_Share_Common_Head *head) {
-}
-static void _eina_share_common_population_head_del(
-   EINA_UNUSED Eina_Share *share,
-   EINA_UNUSED
-   Eina_Share_Common_Head *head) {
+   EINA_UNUSED const Eina_Share_Common_Node *node) {
 }
 #endif
 
-static int
-_eina_share_common_cmp(const Eina_Share_Common_Head *ed,
-                       const int *hash,
-                       EINA_UNUSED int length,
-                       EINA_UNUSED void *data)
+static inline int
+_eina_share_common_read_begin(Eina_Share_Common_Bucket *bucket)
 {
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, , 0);
+   int epoch;
 
-   return EINA_SHARE_COMMON_NODE_HASH(ed->hash) - *hash;
+   /* register in the current epoch, retry if a writer flipped it meanwhile */
+   for (;;)
+     {
+        epoch = __atomic_load_n(&bucket->epoch, __ATOMIC_SEQ_CST);
+        EINA_SHARE_COMMON_INC(&bucket->readers[epoch]);
+        if (__atomic_load_n(&bucket->epoch, __ATOMIC_SEQ_CST) == epoch)
+          return epoch;
+        EINA_SHARE_COMMON_DEC(&bucket->readers[epoch]);
+     }
 }
 
-static Eina_Rbtree_Direction
-_eina_share_common_node(const Eina_Share_Common_Head *left,
-                        const Eina_Share_Common_Head *right,
-                        EINA_UNUSED void *data)
+static inline void
+_eina_share_common_read_end(Eina_Share_Common_Bucket *bucket, int epoch)
 {
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(left,  , 0);
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(right, , 0);
-
-   if (EINA_SHARE_COMMON_NODE_HASH(left->hash) - EINA_SHARE_COMMON_NODE_HASH(right->hash) < 0)
-      return EINA_RBTREE_LEFT;
-
-   return EINA_RBTREE_RIGHT;
+   __atomic_sub_fetch(&bucket->readers[epoch], 1, __ATOMIC_RELEASE);
 }
 
+/* Must be called with the bucket lock held, after unlinking a node. Once it
+ * returns, no reader can still reference the unlinked node. */
 static void
-_eina_share_common_head_free(Eina_Share_Common_Head *ed, EINA_UNUSED void *data)
+_eina_share_common_bucket_synchronize(Eina_Share_Common_Bucket *bucket)
 {
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, );
+   int epoch = bucket->epoch;
 
-   while (ed->head)
+   __atomic_store_n(&bucket->epoch, !epoch, __ATOMIC_SEQ_CST);
+   while (__atomic_load_n(&bucket->readers[epoch], __ATOMIC_SEQ_CST))
      {
-        Eina_Share_Common_Node *el = ed->head;
-
-        ed->head = ed->head->next;
-        if (el != &ed->builtin_node)
-           MAGIC_FREE(el);
+#ifndef _WIN32
+        sched_yield();
+#endif
      }
-           MAGIC_FREE(ed);
 }
 
 static void
@@ -382,9 +347,11 @@ _eina_share_common_node_init(Eina_Share_Common_Node *node,
                              const char *str,
                              int slen,
                              unsigned int null_size,
+                             int hash,
                              Eina_Magic node_magic)
 {
    EINA_MAGIC_SET(node, node_magic);
+   node->hash = hash;
    node->references = 1;
    node->length = slen;
    memcpy(node->str, str, slen);
@@ -393,146 +360,36 @@ _eina_share_common_node_init(Eina_Share_Common_Node *node,
    (void) node_magic; /* When magic are disable, node_magic is unused, this remove a warning. */
 }
 
-static Eina_Share_Common_Head *
-_eina_share_common_head_alloc(int slen)
-{
-   Eina_Share_Common_Head *head;
-   const size_t head_size = offsetof(Eina_Share_Common_Head, builtin_node.str);
-
-   head = malloc(head_size + slen);
-   return head;
-}
-
-static const char *
-_eina_share_common_add_head(Eina_Share *share,
-                            Eina_Share_Common_Head **p_bucket,
-                            int hash,
-                            const char *str,
-                            unsigned int slen,
-                            unsigned int null_size)
-{
-   Eina_Rbtree **p_tree = (Eina_Rbtree **)p_bucket;
-   Eina_Share_Common_Head *head;
-
-   head = _eina_share_common_head_alloc(slen + null_size);
-   if (!head)
-      return NULL;
-
-   EINA_MAGIC_SET(head, EINA_MAGIC_SHARE_HEAD);
-   head->hash = hash;
-   head->head = &head->builtin_node;
-   _eina_share_common_node_init(head->head,
-                                str,
-                                slen,
-                                null_size,
-                                share->node_magic);
-   head->head->next = NULL;
-
-   _eina_share_common_population_head_init(share, head);
-
-   *p_tree = eina_rbtree_inline_insert
-         (*p_tree, EINA_RBTREE_GET(head),
-         EINA_RBTREE_CMP_NODE_CB(_eina_share_common_node), NULL);
-
-   return head->head->str;
-}
-
-static void
-_eina_share_common_del_head(Eina_Share_Common_Head **p_bucket,
-                            Eina_Share_Common_Head *head)
-{
-   Eina_Rbtree **p_tree = (Eina_Rbtree **)p_bucket;
-
-   *p_tree = eina_rbtree_inline_remove
-         (*p_tree, EINA_RBTREE_GET(head),
-         EINA_RBTREE_CMP_NODE_CB(_eina_share_common_node), NULL);
-
-         MAGIC_FREE(head);
-}
-
-
-static inline Eina_Bool
-_eina_share_common_node_eq(const Eina_Share_Common_Node *node,
-                           const char *str,
-                           unsigned int slen)
-{
-   return ((node->length == slen) &&
-           (memcmp(node->str, str, slen) == 0));
-}
-
 static Eina_Share_Common_Node *
-_eina_share_common_head_find(Eina_Share_Common_Head *head,
+_eina_share_common_node_find(Eina_Share_Common_Node *node,
+                             int hash,
                              const char *str,
                              unsigned int slen)
 {
-   Eina_Share_Common_Node *node, *prev;
-
-   node = head->head;
-   if (_eina_share_common_node_eq(node, str, slen))
-      return node;
-
-   prev = node;
-   node = node->next;
-   for (; node; prev = node, node = node->next)
-      if (_eina_share_common_node_eq(node, str, slen))
-        {
-           /* promote node except builtin_node, make hot items be at the beginning */
-           if (node->next)
-             {
-                prev->next = node->next;
-                node->next = head->head;
-                head->head = node;
-             }
-           return node;
-        }
+   for (; node; node = EINA_SHARE_COMMON_LOAD(&node->next))
+     if ((node->hash == hash) &&
+         (node->length == slen) &&
+         (memcmp(node->str, str, slen) == 0))
+       return node;
 
    return NULL;
 }
 
+/* Take a reference on a node found without the bucket lock, fails if the
+ * last reference is being dropped concurrently. */
 static Eina_Bool
-_eina_share_common_head_remove_node(Eina_Share_Common_Head *head,
-                                    const Eina_Share_Common_Node *node)
+_eina_share_common_node_ref(Eina_Share_Common_Node *node)
 {
-   Eina_Share_Common_Node *cur, *prev;
+   unsigned int references;
 
-   if (head->head == node)
+   references = __atomic_load_n(&node->references, __ATOMIC_RELAXED);
+   do
      {
-        head->head = node->next;
-        return 1;
+        if (!references) return EINA_FALSE;
      }
+   while (!EINA_SHARE_COMMON_CAS(&node->references, references, references + 1));
 
-   prev = head->head;
-   cur = head->head->next;
-   for (; cur; prev = cur, cur = cur->next)
-      if (cur == node)
-        {
-           prev->next = cur->next;
-           return 1;
-        }
-
-   return 0;
-}
-
-static Eina_Share_Common_Head *
-_eina_share_common_find_hash(Eina_Share_Common_Head *bucket, int hash)
-{
-   return (Eina_Share_Common_Head *)eina_rbtree_inline_lookup
-             (EINA_RBTREE_GET(bucket), &hash, 0,
-             EINA_RBTREE_CMP_KEY_CB(_eina_share_common_cmp), NULL);
-}
-
-static Eina_Share_Common_Head *
-_eina_share_common_head_from_node(Eina_Share_Common_Node *node)
-{
-   Eina_Share_Common_Head *head;
-   const size_t offset = offsetof(Eina_Share_Common_Head, builtin_node);
-
-   while (node->next)
-     node = node->next;
-   head = (Eina_Share_Common_Head *)((char*)node - offset);
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(head, , 0);
-
-   return head;
+   return EINA_TRUE;
 }
 
 static Eina_Share_Common_Node *
@@ -558,26 +415,20 @@ _eina_share_common_node_from_str(const char *str, Eina_Magic node_magic)
    (void) node_magic; /* When magic are disable, node_magic is unused, this remove a warning. */
 }
 
-static Eina_Bool
-eina_iterator_array_check(const Eina_Rbtree *rbtree EINA_UNUSED,
-                          Eina_Share_Common_Head *head,
-                          struct dumpinfo *fdata)
+static void
+_eina_share_common_node_dump(Eina_Share_Common_Node *node,
+                             struct dumpinfo *fdata)
 {
-   Eina_Share_Common_Node *node;
-
-   fdata->used += sizeof(Eina_Share_Common_Head);
-   for (node = head->head; node; node = node->next)
+   for (; node; node = node->next)
      {
         printf("DDD: %5i %5i ", node->length, node->references);
-        printf("'%.*s'\n", node->length, ((char *)node) + sizeof(Eina_Share_Common_Node));
+        printf("'%.*s'\n", node->length, node->str);
         fdata->used += sizeof(Eina_Share_Common_Node);
         fdata->used += node->length;
         fdata->saved += (node->references - 1) * node->length;
         fdata->dups += node->references - 1;
         fdata->unique++;
      }
-
-   return EINA_TRUE;
 }
 
 /**
@@ -606,6 +457,7 @@ eina_share_common_init(Eina_Share **_share,
                        const char *node_magic_STR)
 {
    Eina_Share *share;
+   unsigned int i;
 
    share = *_share = calloc(sizeof(Eina_Share), 1);
    if (!share) goto on_error;
@@ -613,10 +465,12 @@ eina_share_common_init(Eina_Share **_share,
    share->share = calloc(1, sizeof(Eina_Share_Common));
    if (!share->share) goto on_error;
 
+   for (i = 0; i < EINA_SHARE_COMMON_BUCKETS; i++)
+     eina_spinlock_new(&share->share->buckets[i].lock);
+
    share->node_magic = node_magic;
 #define EMS(n) eina_magic_string_static_set(n, n ## _STR)
    EMS(EINA_MAGIC_SHARE);
-   EMS(EINA_MAGIC_SHARE_HEAD);
    EMS(node_magic);
 #undef EMS
    EINA_MAGIC_SET(share->share, EINA_MAGIC_SHARE);
@@ -649,7 +503,7 @@ eina_share_common_init(Eina_Share **_share,
 Eina_Bool
 eina_share_common_shutdown(Eina_Share **_share)
 {
-   unsigned int i;
+   unsigned int i, j;
    Eina_Share *share = *_share;
 
    eina_spinlock_take(&_mutex_big);
@@ -659,11 +513,22 @@ eina_share_common_shutdown(Eina_Share **_share)
    /* remove any string still in the table */
    for (i = 0; i < EINA_SHARE_COMMON_BUCKETS; i++)
      {
-        eina_rbtree_delete(EINA_RBTREE_GET(
-                              share->share->buckets[i]),
-                           EINA_RBTREE_FREE_CB(
-                              _eina_share_common_head_free), NULL);
-        share->share->buckets[i] = NULL;
+        Eina_Share_Common_Bucket *bucket = share->share->buckets + i;
+
+        if (bucket->nodes)
+          {
+             for (j = 0; j < EINA_SHARE_COMMON_BUCKETS; j++)
+               while (bucket->nodes[j])
+                 {
+                    Eina_Share_Common_Node *node = bucket->nodes[j];
+
+                    bucket->nodes[j] = node->next;
+                    MAGIC_FREE(node);
+                 }
+             free(bucket->nodes);
+             bucket->nodes = NULL;
+          }
+        eina_spinlock_free(&bucket->lock);
      }
    MAGIC_FREE(share->share);
 
@@ -731,9 +596,11 @@ eina_share_common_add_length(Eina_Share *share,
                              unsigned int slen,
                              unsigned int null_size)
 {
-   Eina_Share_Common_Head **p_bucket, *ed;
+   Eina_Share_Common_Bucket *bucket;
+   Eina_Share_Common_Node **nodes, **p_chain;
    Eina_Share_Common_Node *el;
    int hash;
+   int epoch;
 
    if (!str)
       return NULL;
@@ -744,49 +611,61 @@ eina_share_common_add_length(Eina_Share *share,
       return NULL;
 
    hash = eina_hash_superfast(str, slen);
+   bucket = share->share->buckets + EINA_SHARE_COMMON_BUCKET_IDX(hash);
 
-   eina_spinlock_take(&_mutex_big);
-   p_bucket = share->share->buckets + EINA_SHARE_COMMON_BUCKET_IDX(hash);
-
-   ed = _eina_share_common_find_hash(*p_bucket, EINA_SHARE_COMMON_NODE_HASH(hash));
-   if (!ed)
+   /* fast path, the string is already shared */
+   epoch = _eina_share_common_read_begin(bucket);
+   nodes = EINA_SHARE_COMMON_LOAD(&bucket->nodes);
+   if (nodes)
      {
-        const char *s = _eina_share_common_add_head(share,
-                                                    p_bucket,
-                                                    hash,
-                                                    str,
-                                                    slen,
-                                                    null_size);
-        eina_spinlock_release(&_mutex_big);
-        return s;
+        el = _eina_share_common_node_find
+          (EINA_SHARE_COMMON_LOAD(nodes + EINA_SHARE_COMMON_NODE_HASH(hash)),
+           hash, str, slen);
+        if (el && _eina_share_common_node_ref(el))
+          {
+             _eina_share_common_read_end(bucket, epoch);
+             return el->str;
+          }
      }
+   _eina_share_common_read_end(bucket, epoch);
 
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, eina_spinlock_release(&_mutex_big), NULL);
+   eina_spinlock_take(&bucket->lock);
+   if (!bucket->nodes)
+     {
+        nodes = calloc(EINA_SHARE_COMMON_BUCKETS, sizeof (Eina_Share_Common_Node *));
+        if (!nodes)
+          {
+             eina_spinlock_release(&bucket->lock);
+             return NULL;
+          }
+        EINA_SHARE_COMMON_STORE(&bucket->nodes, nodes);
+     }
 
-   el = _eina_share_common_head_find(ed, str, slen);
+   /* the last reference of a node is only dropped with the lock held, so
+    * anything found here is alive */
+   p_chain = bucket->nodes + EINA_SHARE_COMMON_NODE_HASH(hash);
+   el = _eina_share_common_node_find(*p_chain, hash, str, slen);
    if (el)
      {
-        EINA_MAGIC_CHECK_SHARE_COMMON_NODE(el,
-                                           share->node_magic,
-                                           eina_spinlock_release(&_mutex_big));
-        el->references++;
-                                           eina_spinlock_release(&_mutex_big);
+        EINA_SHARE_COMMON_INC(&el->references);
+        eina_spinlock_release(&bucket->lock);
         return el->str;
      }
 
    el = _eina_share_common_node_alloc(slen, null_size);
    if (!el)
      {
-                                           eina_spinlock_release(&_mutex_big);
+        eina_spinlock_release(&bucket->lock);
         return NULL;
      }
 
-   _eina_share_common_node_init(el, str, slen, null_size, share->node_magic);
-   el->next = ed->head;
-   ed->head = el;
-   _eina_share_common_population_head_add(share, ed);
+   _eina_share_common_node_init(el, str, slen, null_size, hash,
+                                share->node_magic);
+   el->next = *p_chain;
+   EINA_SHARE_COMMON_STORE(p_chain, el);
+   _eina_share_common_population_chain(share, el);
 
-   eina_spinlock_release(&_mutex_big);
+   eina_spinlock_release(&bucket->lock);
 
    return el->str;
 }
@@ -799,18 +678,13 @@ eina_share_common_ref(Eina_Share *share, const char *str)
    if (!str)
       return NULL;
 
-   eina_spinlock_take(&_mutex_big);
    node = _eina_share_common_node_from_str(str, share->node_magic);
    if (!node)
-     {
-        eina_spinlock_release(&_mutex_big);
-        return str;
-     }
-   node->references++;
+      return str;
 
-   eina_share_common_population_nolock_add(share, node->length);
+   EINA_SHARE_COMMON_INC(&node->references);
 
-   eina_spinlock_release(&_mutex_big);
+   eina_share_common_population_add(share, node->length);
 
    return str;
 }
@@ -819,58 +693,52 @@ eina_share_common_ref(Eina_Share *share, const char *str)
 Eina_Bool
 eina_share_common_del(Eina_Share *share, const char *str)
 {
-   unsigned int slen;
-   Eina_Share_Common_Head *ed;
-   Eina_Share_Common_Head **p_bucket;
+   Eina_Share_Common_Bucket *bucket;
+   Eina_Share_Common_Node **p_node;
    Eina_Share_Common_Node *node;
+   unsigned int references;
 
    if (!str)
       return EINA_TRUE;
 
-   eina_spinlock_take(&_mutex_big);
-
    node = _eina_share_common_node_from_str(str, share->node_magic);
    if (!node)
-      goto on_error;
-
-   slen = node->length;
-   eina_share_common_population_nolock_del(share, slen);
-   if (node->references > 1)
-     {
-        node->references--;
-        eina_spinlock_release(&_mutex_big);
-        return EINA_TRUE;
-     }
+      return EINA_FALSE;
 
-   node->references = 0;
+   eina_share_common_population_del(share, node->length);
 
-   ed = _eina_share_common_head_from_node(node);
-   if (!ed)
-      goto on_error;
+   references = __atomic_load_n(&node->references, __ATOMIC_RELAXED);
+   while (references > 1)
+     if (EINA_SHARE_COMMON_CAS(&node->references, references, references - 1))
+       return EINA_TRUE;
 
-   EINA_MAGIC_CHECK_SHARE_COMMON_HEAD(ed, eina_spinlock_release(&_mutex_big), EINA_FALSE);
+   /* maybe the last reference, settle it with the bucket lock held */
+   bucket = share->share->buckets + EINA_SHARE_COMMON_BUCKET_IDX(node->hash);
+   eina_spinlock_take(&bucket->lock);
 
-   if (node != &ed->builtin_node)
+   if (EINA_SHARE_COMMON_DEC(&node->references) != 0)
      {
-        if (!_eina_share_common_head_remove_node(ed, node))
-          goto on_error;
-        MAGIC_FREE(node);
+        eina_spinlock_release(&bucket->lock);
+        return EINA_TRUE;
      }
 
-   if (!ed->head || ed->head->references == 0)
-     {
-        p_bucket = share->share->buckets + EINA_SHARE_COMMON_BUCKET_IDX(ed->hash);
-        _eina_share_common_del_head(p_bucket, ed);
-     }
-   else
-      _eina_share_common_population_head_del(share, ed);
+   p_node = bucket->nodes + EINA_SHARE_COMMON_NODE_HASH(node->hash);
+   while (*p_node && *p_node != node)
+     p_node = &(*p_node)->next;
+   if (!*p_node)
+     goto on_error;
 
-   eina_spinlock_release(&_mutex_big);
+   EINA_SHARE_COMMON_STORE(p_node, node->next);
+   _eina_share_common_bucket_synchronize(bucket);
+
+   eina_spinlock_release(&bucket->lock);
+
+   MAGIC_FREE(node);
 
    return EINA_TRUE;
 
 on_error:
-   eina_spinlock_release(&_mutex_big);
+   eina_spinlock_release(&bucket->lock);
    /* possible segfault happened before here, but... */
    return EINA_FALSE;
 }
@@ -892,8 +760,7 @@ void
 eina_share_common_dump(Eina_Share *share, void (*additional_dump)(
                           struct dumpinfo *), int used)
 {
-   Eina_Iterator *it;
-   unsigned int i;
+   unsigned int i, j;
    struct dumpinfo di;
 
    if (!share)
@@ -906,24 +773,23 @@ eina_share_common_dump(Eina_Share *share, void (*additional_dump)(
    printf("DDD:   len   ref string\n");
    printf("DDD:-------------------\n");
 
-   eina_spinlock_take(&_mutex_big);
    for (i = 0; i < EINA_SHARE_COMMON_BUCKETS; i++)
      {
-        if (!share->share->buckets[i])
-          {
-             continue; //	printf("DDD: BUCKET # %i (HEAD=%i, NODE=%i)\n", i,
+        Eina_Share_Common_Bucket *bucket = share->share->buckets + i;
 
+        eina_spinlock_take(&bucket->lock);
+        if (bucket->nodes)
+          {
+             di.used += EINA_SHARE_COMMON_BUCKETS * sizeof (Eina_Share_Common_Node *);
+             for (j = 0; j < EINA_SHARE_COMMON_BUCKETS; j++)
+               _eina_share_common_node_dump(bucket->nodes[j], &di);
           }
-
-//	       sizeof(Eina_Share_Common_Head), sizeof(Eina_Share_Common_Node));
-        it = eina_rbtree_iterator_prefix(
-              (Eina_Rbtree *)share->share->buckets[i]);
-        eina_iterator_foreach(it, EINA_EACH_CB(eina_iterator_array_check), &di);
-        eina_iterator_free(it);
+        eina_spinlock_release(&bucket->lock);
      }
    if (additional_dump)
       additional_dump(&di);
 
+   eina_spinlock_take(&_mutex_big);
 #ifdef EINA_STRINGSHARE_USAGE
    /* One character strings are not counted in the hash. */
    di.saved += share->population_group[0].count * sizeof(char);
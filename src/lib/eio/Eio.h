@@ -757,6 +757,13 @@ EAPI Eio_File *eio_file_xattr_string_get(const char *path,
 /**
  * @brief Initialize eio and all it's required submodule.
  * @return the current number of eio users.
+ *
+ * @note When EIO_IO_URING is set in the environment and the kernel
+ * supports it, eio_file_direct_stat(), eio_file_direct_lstat(),
+ * eio_file_unlink(), eio_file_mkdir() and eio_file_move() are queued on
+ * an io_uring and completed from the main loop instead of a thread.
+ * Other operations, and any of those the ring can't take, still run in
+ * a thread. Available since 1.10.
  */
 EAPI int eio_init(void);
 
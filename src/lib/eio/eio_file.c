@@ -601,6 +601,7 @@ eio_file_cancel(Eio_File *ls)
 {
    if (!ls) return EINA_FALSE;
    EINA_SAFETY_ON_NULL_RETURN_VAL(ls, EINA_FALSE);
+   if (ls->uring) return eio_uring_cancel(ls);
    return ecore_thread_cancel(ls->thread);
 }
 
@@ -608,6 +609,7 @@ EAPI Eina_Bool
 eio_file_check(Eio_File *ls)
 {
    EINA_SAFETY_ON_NULL_RETURN_VAL(ls, EINA_TRUE);
+   if (ls->uring) return eio_uring_check(ls);
    return ecore_thread_check(ls->thread);
 }
 
@@ -725,6 +727,16 @@ eio_file_move(const char *source,
    move->progress.dest = eina_stringshare_add(dest);
    move->copy = NULL;
 
+   /* a rename across file systems still ends up copying in a thread */
+   if (eio_uring_file_set(&move->progress.common,
+			  done_cb,
+			  error_cb,
+			  data,
+			  EIO_URING_OP_MOVE,
+			  _eio_file_move_end,
+			  _eio_file_move_error))
+     return &move->progress.common;
+
    if (!eio_long_file_set(&move->progress.common,
 			  done_cb,
 			  error_cb,
@@ -153,7 +153,11 @@ eio_progress_send(Ecore_Thread *thread, Eio_File_Progress *op, long long current
    progress->source = eina_stringshare_ref(op->source);
    progress->dest = eina_stringshare_ref(op->dest);
 
-   ecore_thread_feedback(thread, progress);
+   /* operations done by the io_uring complete in the main loop already */
+   if (!thread)
+     eio_progress_cb(progress, op);
+   else
+     ecore_thread_feedback(thread, progress);
 }
 
 Eio_File_Direct_Info *
@@ -286,6 +290,7 @@ eio_init(void)
    eina_condition_new(&(memory_pool_cond), &(memory_pool_mutex));
 
    eio_monitor_init();
+   eio_uring_init();
 
    eina_log_timing(_eio_log_dom_global,
 		   EINA_LOG_STATE_STOP,
@@ -321,6 +326,7 @@ eio_shutdown(void)
 		   EINA_LOG_STATE_START,
 		   EINA_LOG_STATE_SHUTDOWN);
 
+   eio_uring_shutdown();
    eio_monitor_shutdown();
 
    eina_condition_free(&(memory_pool_cond));
@@ -133,6 +133,8 @@ typedef struct _Eio_File_Char Eio_File_Char;
 
 typedef struct _Eio_File_Associate Eio_File_Associate;
 
+typedef struct _Eio_Uring_Request Eio_Uring_Request;
+
 struct _Eio_File_Associate
 {
    void *data;
@@ -157,6 +159,8 @@ struct _Eio_File_Char
 struct _Eio_File
 {
    Ecore_Thread *thread;
+   /* set while the operation is queued on the io_uring instead */
+   Eio_Uring_Request *uring;
    const void *data;
    void *container;
 
@@ -339,6 +343,15 @@ typedef enum {
   EIO_XATTR_INT
 } Eio_File_Xattr_Op;
 
+typedef enum {
+  EIO_URING_OP_STAT,
+  EIO_URING_OP_LSTAT,
+  EIO_URING_OP_UNLINK,
+  EIO_URING_OP_MKDIR,
+  EIO_URING_OP_MOVE,
+  EIO_URING_OP_LAST
+} Eio_Uring_Op;
+
 struct _Eio_File_Xattr
 {
    Eio_File common;
@@ -476,6 +489,18 @@ void eio_progress_cb(Eio_Progress *progress, Eio_File_Progress *op);
 
 Eina_Bool eio_file_copy_do(Ecore_Thread *thread, Eio_File_Progress *copy);
 
+void eio_uring_init(void);
+void eio_uring_shutdown(void);
+Eina_Bool eio_uring_file_set(Eio_File *common,
+                             Eio_Done_Cb done_cb,
+                             Eio_Error_Cb error_cb,
+                             const void *data,
+                             Eio_Uring_Op op,
+                             Ecore_Thread_Cb end_cb,
+                             Ecore_Thread_Cb cancel_cb);
+Eina_Bool eio_uring_cancel(Eio_File *common);
+Eina_Bool eio_uring_check(Eio_File *common);
+
 void eio_monitor_init(void);
 void eio_monitor_backend_init(void);
 void eio_monitor_fallback_init(void);
@@ -346,6 +346,7 @@ eio_long_file_set(Eio_File *common,
    common->data = data;
    common->error = 0;
    common->thread = NULL;
+   common->uring = NULL;
    common->container = NULL;
    common->worker.associated = NULL;
    common->main.associated = NULL;
@@ -379,6 +380,7 @@ eio_file_set(Eio_File *common,
    common->data = data;
    common->error = 0;
    common->thread = NULL;
+   common->uring = NULL;
    common->container = NULL;
    common->worker.associated = NULL;
    common->main.associated = NULL;
@@ -425,6 +427,15 @@ eio_file_direct_stat(const char *path,
    s->path = eina_stringshare_add(path);
    s->done_cb = done_cb;
 
+   if (eio_uring_file_set(&s->common,
+			  NULL,
+			  error_cb,
+			  data,
+			  EIO_URING_OP_STAT,
+			  _eio_file_stat_done,
+			  _eio_file_stat_error))
+     return &s->common;
+
    if (!eio_file_set(&s->common,
 		      NULL,
 		      error_cb,
@@ -457,6 +468,15 @@ eio_file_direct_lstat(const char *path,
    s->path = eina_stringshare_add(path);
    s->done_cb = done_cb;
 
+   if (eio_uring_file_set(&s->common,
+			  NULL,
+			  error_cb,
+			  data,
+			  EIO_URING_OP_LSTAT,
+			  _eio_file_stat_done,
+			  _eio_file_stat_error))
+     return &s->common;
+
    if (!eio_file_set(&s->common,
 		      NULL,
 		      error_cb,
@@ -486,6 +506,15 @@ eio_file_unlink(const char *path,
 
    l->path = eina_stringshare_add(path);
 
+   if (eio_uring_file_set(&l->common,
+			  done_cb,
+			  error_cb,
+			  data,
+			  EIO_URING_OP_UNLINK,
+			  _eio_file_unlink_done,
+			  _eio_file_unlink_error))
+     return &l->common;
+
    if (!eio_file_set(&l->common,
 		      done_cb,
 		      error_cb,
@@ -517,6 +546,15 @@ eio_file_mkdir(const char *path,
    r->path = eina_stringshare_add(path);
    r->mode = mode;
 
+   if (eio_uring_file_set(&r->common,
+			  done_cb,
+			  error_cb,
+			  data,
+			  EIO_URING_OP_MKDIR,
+			  _eio_file_mkdir_done,
+			  _eio_file_mkdir_error))
+     return &r->common;
+
    if (!eio_file_set(&r->common,
 		     done_cb,
 		     error_cb,
@@ -0,0 +1,605 @@
+/* EIO - EFL data type library
+ * Copyright (C) 2014 Enlightenment Developers:
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library;
+ * if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "eio_private.h"
+#include "Eio.h"
+
+#ifdef HAVE_EIO_URING
+# include <stdint.h>
+# include <sys/syscall.h>
+# include <sys/sysmacros.h>
+# include <linux/io_uring.h>
+#endif
+
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+
+/**
+ * @cond LOCAL
+ */
+
+#ifdef HAVE_EIO_URING
+
+/* Operations that are a single system call each are queued on an io_uring
+ * instead of being run by a thread. They are submitted all at once right
+ * before the main loop goes to sleep, and their completions are reaped by
+ * an fd handler on the ring, then reported through the same end and cancel
+ * callbacks as the threaded version. Whenever the ring can't take an
+ * operation, eio_uring_file_set() fails and the caller runs it in a
+ * thread. */
+
+/* submissions are flushed once per loop iteration, but a burst of them
+   completes over several, so keep room for more completions */
+#define EIO_URING_ENTRIES 256
+#define EIO_URING_CQ_ENTRIES 4096
+
+struct _Eio_Uring_Request
+{
+   Eio_File *common;
+   Eio_Uring_Op op;
+
+   Ecore_Thread_Cb end_cb;
+   Ecore_Thread_Cb cancel_cb;
+
+   struct statx buffer;
+
+   Eina_Bool cancel : 1;
+};
+
+typedef struct _Eio_Uring Eio_Uring;
+
+struct _Eio_Uring
+{
+   int fd;
+   Ecore_Fd_Handler *fdh;
+
+   void *sq_ring;
+   size_t sq_ring_size;
+   void *cq_ring;
+   size_t cq_ring_size;
+   struct io_uring_sqe *sqes;
+   size_t sqes_size;
+
+   unsigned int *sq_head;
+   unsigned int *sq_tail;
+   unsigned int *sq_mask;
+   unsigned int *sq_array;
+   unsigned int sq_entries;
+
+   unsigned int *cq_head;
+   unsigned int *cq_tail;
+   unsigned int *cq_mask;
+   struct io_uring_cqe *cqes;
+   unsigned int cq_entries;
+
+   /* sqes filled in, but not handed to the kernel yet */
+   unsigned int queued;
+   /* requests waiting for their completion */
+   unsigned int inflight;
+
+   Eina_Bool supported[EIO_URING_OP_LAST];
+   Eina_Bool shutdown : 1;
+};
+
+/* only usable once the ring is watched by the main loop */
+static Eio_Uring _eio_uring;
+
+static const int _eio_uring_opcodes[EIO_URING_OP_LAST] = {
+  IORING_OP_STATX,
+  IORING_OP_STATX,
+  IORING_OP_UNLINKAT,
+  IORING_OP_MKDIRAT,
+  IORING_OP_RENAMEAT
+};
+
+static int
+_eio_uring_setup(unsigned int entries, struct io_uring_params *p)
+{
+   return syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int
+_eio_uring_enter(unsigned int to_submit, unsigned int min_complete,
+                 unsigned int flags)
+{
+   return syscall(__NR_io_uring_enter, _eio_uring.fd, to_submit,
+                  min_complete, flags, NULL, 0);
+}
+
+static int
+_eio_uring_register(unsigned int opcode, void *arg, unsigned int nr_args)
+{
+   return syscall(__NR_io_uring_register, _eio_uring.fd, opcode,
+                  arg, nr_args);
+}
+
+static void
+_eio_uring_probe(void)
+{
+   struct io_uring_probe *probe;
+   size_t size;
+   int i;
+
+   size = sizeof (struct io_uring_probe) +
+     (IORING_OP_LAST * sizeof (struct io_uring_probe_op));
+   probe = calloc(1, size);
+   if (!probe) return;
+
+   /* kernels older than the probe lack most of the operations anyway */
+   if (_eio_uring_register(IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == 0)
+     {
+        for (i = 0; i < EIO_URING_OP_LAST; i++)
+          {
+             int opcode = _eio_uring_opcodes[i];
+
+             _eio_uring.supported[i] =
+               (opcode <= probe->last_op) &&
+               (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+          }
+     }
+
+   free(probe);
+}
+
+static void
+_eio_uring_flush(void)
+{
+   int r;
+
+   while (_eio_uring.queued)
+     {
+        r = _eio_uring_enter(_eio_uring.queued, 0, 0);
+        if (r < 0)
+          {
+             if (errno == EINTR) continue;
+             /* the kernel is out of resources, try again next time */
+             if ((errno != EAGAIN) && (errno != EBUSY))
+               ERR("io_uring submission failed (errno=%d)", errno);
+             return;
+          }
+        if (r == 0) return;
+        _eio_uring.queued -= r;
+     }
+}
+
+static struct io_uring_sqe *
+_eio_uring_sqe_get(void)
+{
+   unsigned int head, tail;
+   struct io_uring_sqe *sqe;
+
+   /* every request must find room for its completion */
+   if (_eio_uring.inflight >= _eio_uring.cq_entries) return NULL;
+
+   tail = *_eio_uring.sq_tail;
+   head = __atomic_load_n(_eio_uring.sq_head, __ATOMIC_ACQUIRE);
+   if (tail - head >= _eio_uring.sq_entries)
+     {
+        _eio_uring_flush();
+        head = __atomic_load_n(_eio_uring.sq_head, __ATOMIC_ACQUIRE);
+        if (tail - head >= _eio_uring.sq_entries) return NULL;
+     }
+
+   sqe = &_eio_uring.sqes[tail & *_eio_uring.sq_mask];
+   memset(sqe, 0, sizeof (struct io_uring_sqe));
+   return sqe;
+}
+
+static void
+_eio_uring_sqe_commit(struct io_uring_sqe *sqe)
+{
+   unsigned int tail;
+   unsigned int index;
+
+   tail = *_eio_uring.sq_tail;
+   index = tail & *_eio_uring.sq_mask;
+   _eio_uring.sq_array[index] = sqe - _eio_uring.sqes;
+   __atomic_store_n(_eio_uring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+   _eio_uring.queued++;
+   _eio_uring.inflight++;
+}
+
+static void
+_eio_uring_stat_2_eina(Eina_Stat *es, const struct statx *stx)
+{
+   es->dev = makedev(stx->stx_dev_major, stx->stx_dev_minor);
+   es->ino = stx->stx_ino;
+   es->mode = stx->stx_mode;
+   es->nlink = stx->stx_nlink;
+   es->uid = stx->stx_uid;
+   es->gid = stx->stx_gid;
+   es->rdev = makedev(stx->stx_rdev_major, stx->stx_rdev_minor);
+   es->size = stx->stx_size;
+   es->blksize = stx->stx_blksize;
+   es->blocks = stx->stx_blocks;
+   es->atime = stx->stx_atime.tv_sec;
+   es->atimensec = stx->stx_atime.tv_nsec;
+   es->mtime = stx->stx_mtime.tv_sec;
+   es->mtimensec = stx->stx_mtime.tv_nsec;
+   es->ctime = stx->stx_ctime.tv_sec;
+   es->ctimensec = stx->stx_ctime.tv_nsec;
+}
+
+static void
+_eio_uring_request_done(Eio_Uring_Request *req, int res)
+{
+   Eio_File *common = req->common;
+
+   _eio_uring.inflight--;
+
+   /* from now on the operation is only waiting for its callbacks */
+   common->uring = NULL;
+
+   if (req->cancel)
+     {
+        req->cancel_cb(common, NULL);
+     }
+   else if (res < 0)
+     {
+        common->error = -res;
+        req->cancel_cb(common, NULL);
+     }
+   else
+     {
+        switch (req->op)
+          {
+           case EIO_URING_OP_STAT:
+           case EIO_URING_OP_LSTAT:
+             _eio_uring_stat_2_eina(&((Eio_File_Stat *)common)->buffer,
+                                    &req->buffer);
+             break;
+           case EIO_URING_OP_MOVE:
+             eio_progress_send(NULL, (Eio_File_Progress *)common, 1, 1);
+             break;
+           default:
+             break;
+          }
+        req->end_cb(common, NULL);
+     }
+
+   free(req);
+}
+
+static Eina_Bool
+_eio_uring_handler(void *data EINA_UNUSED, Ecore_Fd_Handler *fdh EINA_UNUSED)
+{
+   for (;;)
+     {
+        struct io_uring_cqe *cqe;
+        Eio_Uring_Request *req;
+        unsigned int head;
+        int res;
+
+        /* callbacks may iterate the main loop and reap behind our back */
+        head = *_eio_uring.cq_head;
+        if (head == __atomic_load_n(_eio_uring.cq_tail, __ATOMIC_ACQUIRE))
+          break;
+
+        cqe = &_eio_uring.cqes[head & *_eio_uring.cq_mask];
+        req = (Eio_Uring_Request *)(uintptr_t)cqe->user_data;
+        res = cqe->res;
+        __atomic_store_n(_eio_uring.cq_head, head + 1, __ATOMIC_RELEASE);
+
+        _eio_uring_request_done(req, res);
+     }
+
+   return ECORE_CALLBACK_RENEW;
+}
+
+static void
+_eio_uring_prepare(void *data EINA_UNUSED, Ecore_Fd_Handler *fdh EINA_UNUSED)
+{
+   if (_eio_uring.queued) _eio_uring_flush();
+}
+
+static void
+_eio_uring_unmap(void)
+{
+   if (_eio_uring.sqes)
+     munmap(_eio_uring.sqes, _eio_uring.sqes_size);
+   if (_eio_uring.cq_ring && (_eio_uring.cq_ring != _eio_uring.sq_ring))
+     munmap(_eio_uring.cq_ring, _eio_uring.cq_ring_size);
+   if (_eio_uring.sq_ring)
+     munmap(_eio_uring.sq_ring, _eio_uring.sq_ring_size);
+   _eio_uring.sqes = NULL;
+   _eio_uring.cq_ring = NULL;
+   _eio_uring.sq_ring = NULL;
+}
+
+static Eina_Bool
+_eio_uring_map(const struct io_uring_params *p)
+{
+   char *sq, *cq;
+
+   _eio_uring.sq_ring_size = p->sq_off.array +
+     (p->sq_entries * sizeof (unsigned int));
+   _eio_uring.cq_ring_size = p->cq_off.cqes +
+     (p->cq_entries * sizeof (struct io_uring_cqe));
+   if (p->features & IORING_FEAT_SINGLE_MMAP)
+     {
+        if (_eio_uring.cq_ring_size > _eio_uring.sq_ring_size)
+          _eio_uring.sq_ring_size = _eio_uring.cq_ring_size;
+        _eio_uring.cq_ring_size = _eio_uring.sq_ring_size;
+     }
+
+   _eio_uring.sq_ring = mmap(NULL, _eio_uring.sq_ring_size,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             _eio_uring.fd, IORING_OFF_SQ_RING);
+   if (_eio_uring.sq_ring == MAP_FAILED) goto on_error;
+
+   if (p->features & IORING_FEAT_SINGLE_MMAP)
+     {
+        _eio_uring.cq_ring = _eio_uring.sq_ring;
+     }
+   else
+     {
+        _eio_uring.cq_ring = mmap(NULL, _eio_uring.cq_ring_size,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE,
+                                  _eio_uring.fd, IORING_OFF_CQ_RING);
+        if (_eio_uring.cq_ring == MAP_FAILED) goto on_error;
+     }
+
+   _eio_uring.sqes_size = p->sq_entries * sizeof (struct io_uring_sqe);
+   _eio_uring.sqes = mmap(NULL, _eio_uring.sqes_size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          _eio_uring.fd, IORING_OFF_SQES);
+   if (_eio_uring.sqes == MAP_FAILED) goto on_error;
+
+   sq = _eio_uring.sq_ring;
+   _eio_uring.sq_head = (unsigned int *)(sq + p->sq_off.head);
+   _eio_uring.sq_tail = (unsigned int *)(sq + p->sq_off.tail);
+   _eio_uring.sq_mask = (unsigned int *)(sq + p->sq_off.ring_mask);
+   _eio_uring.sq_array = (unsigned int *)(sq + p->sq_off.array);
+   _eio_uring.sq_entries = p->sq_entries;
+
+   cq = _eio_uring.cq_ring;
+   _eio_uring.cq_head = (unsigned int *)(cq + p->cq_off.head);
+   _eio_uring.cq_tail = (unsigned int *)(cq + p->cq_off.tail);
+   _eio_uring.cq_mask = (unsigned int *)(cq + p->cq_off.ring_mask);
+   _eio_uring.cqes = (struct io_uring_cqe *)(cq + p->cq_off.cqes);
+   _eio_uring.cq_entries = p->cq_entries;
+
+   return EINA_TRUE;
+
+ on_error:
+   if (_eio_uring.sq_ring == MAP_FAILED) _eio_uring.sq_ring = NULL;
+   if (_eio_uring.cq_ring == MAP_FAILED) _eio_uring.cq_ring = NULL;
+   if (_eio_uring.sqes == MAP_FAILED) _eio_uring.sqes = NULL;
+   _eio_uring_unmap();
+   return EINA_FALSE;
+}
+
+#endif
+
+/**
+ * @endcond
+ */
+
+
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+
+/**
+ * @cond LOCAL
+ */
+
+void
+eio_uring_init(void)
+{
+#ifdef HAVE_EIO_URING
+   struct io_uring_params p;
+   int i;
+
+   if (!getenv("EIO_IO_URING")) return;
+
+   memset(&p, 0, sizeof (p));
+   p.flags = IORING_SETUP_CQSIZE;
+   p.cq_entries = EIO_URING_CQ_ENTRIES;
+   _eio_uring.fd = _eio_uring_setup(EIO_URING_ENTRIES, &p);
+   if ((_eio_uring.fd < 0) && (errno == EINVAL))
+     {
+        /* older kernel, the completion queue is twice the submission one */
+        memset(&p, 0, sizeof (p));
+        _eio_uring.fd = _eio_uring_setup(EIO_URING_ENTRIES, &p);
+     }
+   if (_eio_uring.fd < 0)
+     {
+        /* no kernel support or disabled by the administrator */
+        INF("io_uring unavailable (errno=%d), using threads", errno);
+        return;
+     }
+   /* the ring fd is always created close on exec */
+
+   if (!_eio_uring_map(&p)) goto on_error;
+
+   _eio_uring_probe();
+   for (i = 0; i < EIO_URING_OP_LAST; i++)
+     if (_eio_uring.supported[i]) break;
+   if (i == EIO_URING_OP_LAST) goto on_unmap;
+
+   _eio_uring.fdh = ecore_main_fd_handler_add(_eio_uring.fd, ECORE_FD_READ,
+                                              _eio_uring_handler, NULL,
+                                              NULL, NULL);
+   if (!_eio_uring.fdh) goto on_unmap;
+   ecore_main_fd_handler_prepare_callback_set(_eio_uring.fdh,
+                                              _eio_uring_prepare, NULL);
+
+   _eio_uring.queued = 0;
+   _eio_uring.inflight = 0;
+   _eio_uring.shutdown = EINA_FALSE;
+   return;
+
+ on_unmap:
+   _eio_uring_unmap();
+ on_error:
+   WRN("io_uring can't be used, using threads");
+   memset(_eio_uring.supported, 0, sizeof (_eio_uring.supported));
+   close(_eio_uring.fd);
+#endif
+}
+
+void
+eio_uring_shutdown(void)
+{
+#ifdef HAVE_EIO_URING
+   if (!_eio_uring.fdh) return;
+
+   /* nothing new goes to the ring, what is in it still completes */
+   _eio_uring.shutdown = EINA_TRUE;
+   _eio_uring_flush();
+   while (_eio_uring.inflight)
+     {
+        if ((_eio_uring_enter(0, 1, IORING_ENTER_GETEVENTS) < 0) &&
+            (errno != EINTR))
+          {
+             ERR("%u io_uring requests lost (errno=%d)",
+                 _eio_uring.inflight, errno);
+             break;
+          }
+        _eio_uring_handler(NULL, NULL);
+     }
+
+   ecore_main_fd_handler_del(_eio_uring.fdh);
+   _eio_uring.fdh = NULL;
+   _eio_uring_unmap();
+   close(_eio_uring.fd);
+   memset(_eio_uring.supported, 0, sizeof (_eio_uring.supported));
+#endif
+}
+
+Eina_Bool
+eio_uring_file_set(Eio_File *common,
+                   Eio_Done_Cb done_cb,
+                   Eio_Error_Cb error_cb,
+                   const void *data,
+                   Eio_Uring_Op op,
+                   Ecore_Thread_Cb end_cb,
+                   Ecore_Thread_Cb cancel_cb)
+{
+#ifdef HAVE_EIO_URING
+   struct io_uring_sqe *sqe;
+   Eio_Uring_Request *req;
+
+   if ((!_eio_uring.fdh) || (_eio_uring.shutdown)) return EINA_FALSE;
+   if (!_eio_uring.supported[op]) return EINA_FALSE;
+
+   req = malloc(sizeof (Eio_Uring_Request));
+   if (!req) return EINA_FALSE;
+
+   sqe = _eio_uring_sqe_get();
+   if (!sqe)
+     {
+        free(req);
+        return EINA_FALSE;
+     }
+
+   req->common = common;
+   req->op = op;
+   req->end_cb = end_cb;
+   req->cancel_cb = cancel_cb;
+   req->cancel = EINA_FALSE;
+
+   sqe->opcode = _eio_uring_opcodes[op];
+   sqe->fd = AT_FDCWD;
+   sqe->user_data = (uintptr_t)req;
+
+   switch (op)
+     {
+      case EIO_URING_OP_STAT:
+      case EIO_URING_OP_LSTAT:
+        sqe->addr = (uintptr_t)((Eio_File_Stat *)common)->path;
+        sqe->off = (uintptr_t)&req->buffer;
+        sqe->len = STATX_BASIC_STATS;
+        sqe->statx_flags = AT_STATX_SYNC_AS_STAT;
+        if (op == EIO_URING_OP_LSTAT)
+          sqe->statx_flags |= AT_SYMLINK_NOFOLLOW;
+        break;
+      case EIO_URING_OP_UNLINK:
+        sqe->addr = (uintptr_t)((Eio_File_Unlink *)common)->path;
+        break;
+      case EIO_URING_OP_MKDIR:
+        sqe->addr = (uintptr_t)((Eio_File_Mkdir *)common)->path;
+        sqe->len = ((Eio_File_Mkdir *)common)->mode;
+        break;
+      case EIO_URING_OP_MOVE:
+        sqe->addr = (uintptr_t)((Eio_File_Progress *)common)->source;
+        sqe->len = AT_FDCWD;
+        sqe->addr2 = (uintptr_t)((Eio_File_Progress *)common)->dest;
+        break;
+      default:
+        break;
+     }
+
+   common->done_cb = done_cb;
+   common->error_cb = error_cb;
+   common->data = data;
+   common->error = 0;
+   common->thread = NULL;
+   common->container = NULL;
+   common->worker.associated = NULL;
+   common->main.associated = NULL;
+   common->uring = req;
+
+   _eio_uring_sqe_commit(sqe);
+   if (_eio_uring.queued >= _eio_uring.sq_entries) _eio_uring_flush();
+
+   return EINA_TRUE;
+#else
+   (void) common;
+   (void) done_cb;
+   (void) error_cb;
+   (void) data;
+   (void) op;
+   (void) end_cb;
+   (void) cancel_cb;
+   return EINA_FALSE;
+#endif
+}
+
+Eina_Bool
+eio_uring_cancel(Eio_File *common)
+{
+#ifdef HAVE_EIO_URING
+   /* the request can't be pulled back, its completion reports the cancel */
+   common->uring->cancel = EINA_TRUE;
+#else
+   (void) common;
+#endif
+   return EINA_FALSE;
+}
+
+Eina_Bool
+eio_uring_check(Eio_File *common)
+{
+#ifdef HAVE_EIO_URING
+   return common->uring->cancel;
+#else
+   (void) common;
+   return EINA_FALSE;
+#endif
+}
+
+/**
+ * @endcond
+ */
@@ -486,13 +486,34 @@ EAPI extern Eo_Hook_Call eo_hook_call_post;
      if (Hook)                                                          \
        Hook(call.klass, call.obj, call.func, __VA_ARGS__);
 
-// cache OP id, get real fct and object data then do the call
+// number of classes remembered by each call site
+#define EO_CALL_CACHE_SIZE 4
+
+// the function resolved for a given class at a call site
+typedef struct _Eo_Call_Cache_Entry
+{
+   const void *klass;      // class of the object, NULL when unused
+   const void *cur_klass;  // class the super call comes from, or NULL
+   void       *func;
+   Eo_Class   *func_klass;
+   int         off;        // of the data from the object, -1 for none
+} Eo_Call_Cache_Entry;
+
+// per call site cache, zeroed by being static, shared by all the threads
+typedef struct _Eo_Call_Cache
+{
+   Eo_Call_Cache_Entry entry[EO_CALL_CACHE_SIZE];
+   unsigned int        next_slot;
+   unsigned int        seq;         // odd while the entries are written
+   unsigned int        generation;
+   Eo_Op               op;
+} Eo_Call_Cache;
+
+// cache OP id and the resolved functions, get real fct and object data then do the call
 #define EO_FUNC_COMMON_OP(Name, DefRet)                                \
      Eo_Op_Call_Data call;                                             \
-     static Eo_Op op = EO_NOOP;                                         \
-     if (op == EO_NOOP)                                                 \
-        op = _eo_api_op_id_get((void*) Name, __FILE__, __LINE__);      \
-     if (!_eo_call_resolve(#Name, op, &call, __FILE__, __LINE__)) return DefRet; \
+     static Eo_Call_Cache ___cache;                                     \
+     if (!_eo_call_resolve(#Name, (void*) Name, &___cache, &call, __FILE__, __LINE__)) return DefRet; \
      _Eo_##Name##_func _func_ = (_Eo_##Name##_func) call.func;        \
 
 // to define an EAPI function
@@ -556,8 +577,8 @@ EAPI extern Eo_Hook_Call eo_hook_call_post;
 // returns the OP id corresponding to the given api_func
 EAPI Eo_Op _eo_api_op_id_get(const void *api_func, const char *file, int line);
 
-// gets the real function pointer and the object data
-EAPI Eina_Bool _eo_call_resolve(const char *func_name, const Eo_Op op, Eo_Op_Call_Data *call, const char *file, int line);
+// gets the real function pointer and the object data, from the cache when possible
+EAPI Eina_Bool _eo_call_resolve(const char *func_name, const void *api_func, Eo_Call_Cache *cache, Eo_Op_Call_Data *call, const char *file, int line);
 
 // start of eo_do barrier, gets the object pointer and ref it, put it on the stask
 EAPI Eina_Bool _eo_do_start(const Eo *obj, const Eo_Class *cur_klass, Eina_Bool is_super, const char *file, const char *func, int line);
@@ -252,6 +252,9 @@ _eo_kls_itr_next(const _Eo_Class *orig_kls, const _Eo_Class *cur_klass, Eo_Op op
 EAPI Eo_Hook_Call eo_hook_call_pre = NULL;
 EAPI Eo_Hook_Call eo_hook_call_post = NULL;
 
+/* Starts at 1 so the zeroed call site caches are invalid. */
+static unsigned int _eo_init_generation = 1;
+
 // FIXME: Thread Local Storage
 #define EO_INVALID_DATA (void *) -1
 // 1024 entries == 8k or 16k (32 or 64bit) for eo call stack. that's 1024
@@ -553,12 +556,130 @@ _eo_do_end(const Eo **eo_id EINA_UNUSED)
      _eo_call_stack_resize(stack, EINA_FALSE);
 }
 
+/* Call site caches are shared by all the threads. Their entries are only
+ * written by the thread that managed to make seq odd, the others just don't
+ * cache what they resolved meanwhile. Readers take an entry only if seq was
+ * even and did not change while they copied it. */
+#define EO_CALL_CACHE_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define EO_CALL_CACHE_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+static inline Eina_Bool
+_eo_call_cache_write_begin(Eo_Call_Cache *cache, unsigned int *seq)
+{
+   *seq = EO_CALL_CACHE_LOAD(&cache->seq);
+   if (*seq & 1) return EINA_FALSE;
+   if (!__atomic_compare_exchange_n(&cache->seq, seq, *seq + 1, EINA_FALSE,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+     return EINA_FALSE;
+   /* entries must not be seen changing before seq does */
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+   return EINA_TRUE;
+}
+
+static inline void
+_eo_call_cache_write_end(Eo_Call_Cache *cache, unsigned int seq)
+{
+   __atomic_store_n(&cache->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/* Returns the op of the call site, cache is set to NULL when its entries
+ * are left from before the last eo_init() and could not be reset. */
+static Eo_Op
+_eo_call_cache_op_get(Eo_Call_Cache **cache, const void *api_func, const char *file, int line)
+{
+   Eo_Call_Cache *c = *cache;
+   unsigned int seq;
+   unsigned int i;
+   Eo_Op op;
+
+   if (EINA_LIKELY(__atomic_load_n(&c->generation, __ATOMIC_ACQUIRE) == _eo_init_generation))
+     return EO_CALL_CACHE_LOAD(&c->op);
+
+   *cache = NULL;
+   op = _eo_api_op_id_get(api_func, file, line);
+   /* retry on the next call, as it was unresolved */
+   if (op == EO_NOOP) return op;
+
+   if (_eo_call_cache_write_begin(c, &seq))
+     {
+        for (i = 0; i < EO_CALL_CACHE_SIZE; i++)
+          EO_CALL_CACHE_STORE(&c->entry[i].klass, NULL);
+        c->next_slot = 0;
+        EO_CALL_CACHE_STORE(&c->op, op);
+        __atomic_store_n(&c->generation, _eo_init_generation, __ATOMIC_RELEASE);
+        _eo_call_cache_write_end(c, seq);
+        *cache = c;
+     }
+
+   return op;
+}
+
+static inline Eina_Bool
+_eo_call_cache_find(Eo_Call_Cache *cache, const _Eo_Class *klass,
+                    const _Eo_Class *cur_klass, const _Eo_Object *obj,
+                    Eo_Op_Call_Data *call)
+{
+   unsigned int seq;
+   unsigned int i;
+
+   seq = __atomic_load_n(&cache->seq, __ATOMIC_ACQUIRE);
+   if (seq & 1) return EINA_FALSE;
+
+   for (i = 0; i < EO_CALL_CACHE_SIZE; i++)
+     {
+        Eo_Call_Cache_Entry *entry = &cache->entry[i];
+        int off;
+
+        if ((EO_CALL_CACHE_LOAD(&entry->klass) != klass) ||
+            (EO_CALL_CACHE_LOAD(&entry->cur_klass) != cur_klass))
+          continue;
+
+        call->func = EO_CALL_CACHE_LOAD(&entry->func);
+        call->klass = EO_CALL_CACHE_LOAD(&entry->func_klass);
+        off = EO_CALL_CACHE_LOAD(&entry->off);
+
+        /* the entry is only valid if nobody wrote it meanwhile */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (EO_CALL_CACHE_LOAD(&cache->seq) != seq) return EINA_FALSE;
+
+        call->data = (off >= 0) ? ((char *) obj) + off : NULL;
+        return EINA_TRUE;
+     }
+
+   return EINA_FALSE;
+}
+
+static inline void
+_eo_call_cache_store(Eo_Call_Cache *cache, const _Eo_Class *klass,
+                     const _Eo_Class *cur_klass, const _Eo_Object *obj,
+                     const Eo_Op_Call_Data *call)
+{
+   Eo_Call_Cache_Entry *entry;
+   unsigned int seq;
+
+   if (!_eo_call_cache_write_begin(cache, &seq)) return;
+
+   entry = &cache->entry[cache->next_slot];
+   cache->next_slot = (cache->next_slot + 1) % EO_CALL_CACHE_SIZE;
+
+   EO_CALL_CACHE_STORE(&entry->klass, klass);
+   EO_CALL_CACHE_STORE(&entry->cur_klass, cur_klass);
+   EO_CALL_CACHE_STORE(&entry->func, call->func);
+   EO_CALL_CACHE_STORE(&entry->func_klass, call->klass);
+   /* the data of a class is at the same place in all its objects */
+   EO_CALL_CACHE_STORE(&entry->off, call->data ?
+                       (int) ((char *) call->data - (char *) obj) : -1);
+
+   _eo_call_cache_write_end(cache, seq);
+}
+
 EAPI Eina_Bool
-_eo_call_resolve(const char *func_name, const Eo_Op op, Eo_Op_Call_Data *call, const char *file, int line)
+_eo_call_resolve(const char *func_name, const void *api_func, Eo_Call_Cache *cache, Eo_Op_Call_Data *call, const char *file, int line)
 {
    Eo_Stack_Frame *fptr;
    const _Eo_Class *klass;
    const op_type_funcs *func;
+   const Eo_Op op = _eo_call_cache_op_get(&cache, api_func, file, line);
    Eina_Bool is_obj;
 
    if (op == EO_NOOP) return EINA_FALSE;
@@ -572,6 +693,14 @@ _eo_call_resolve(const char *func_name, const Eo_Op op, Eo_Op_Call_Data *call, c
 
    klass = (is_obj) ? fptr->o.obj->klass : fptr->o.kls;
 
+   /* Same class as a previous call from here, skip the lookup. */
+   if (EINA_LIKELY(is_obj && cache) &&
+       _eo_call_cache_find(cache, klass, fptr->cur_klass, fptr->o.obj, call))
+     {
+        call->obj = (Eo *)fptr->eo_id;
+        return EINA_TRUE;
+     }
+
    /* If we have a current class, we need to itr to the next. */
    if (fptr->cur_klass)
      {
@@ -611,6 +740,10 @@ _eo_call_resolve(const char *func_name, const Eo_Op op, Eo_Op_Call_Data *call, c
                }
              else
                call->data = _eo_data_scope_get(fptr->o.obj, func->src);
+
+             if (cache)
+               _eo_call_cache_store(cache, fptr->o.obj->klass,
+                                    fptr->cur_klass, fptr->o.obj, call);
           }
         else
           {
@@ -850,18 +983,12 @@ _eo_add_internal_start(const char *file, int line, const Eo_Class *klass_id, Eo
         return NULL;
      }
 
-   eina_spinlock_take(&klass->objects.trash_lock);
-   obj = eina_trash_pop(&klass->objects.trash);
-   if (obj)
+   obj = _eo_slab_alloc(&klass->objects);
+   if (!obj)
      {
-        memset(obj, 0, klass->obj_size);
-        klass->objects.trash_count--;
-     }
-   else
-     {
-        obj = calloc(1, klass->obj_size);
+        ERR("in %s:%d: Could not allocate an object of class '%s'.", file, line, klass->desc->name);
+        return NULL;
      }
-   eina_spinlock_release(&klass->objects.trash_lock);
 
    obj->refcount++;
    obj->klass = klass;
@@ -1127,13 +1254,11 @@ eo_class_free(_Eo_Class *klass)
         _dich_func_clean_all(klass);
      }
 
-   EINA_TRASH_CLEAN(&klass->objects.trash, data)
-      free(data);
+   _eo_slab_pool_shutdown(&klass->objects);
 
    EINA_TRASH_CLEAN(&klass->iterators.trash, data)
       free(data);
 
-   eina_spinlock_free(&klass->objects.trash_lock);
    eina_spinlock_free(&klass->iterators.trash_lock);
 
    free(klass);
@@ -1278,7 +1403,6 @@ eo_class_new(const Eo_Class_Description *desc, const Eo_Class *parent_id, ...)
 #ifndef HAVE_EO_ID
    EINA_MAGIC_SET((Eo_Base *) klass, EO_CLASS_EINA_MAGIC);
 #endif
-   eina_spinlock_new(&klass->objects.trash_lock);
    eina_spinlock_new(&klass->iterators.trash_lock);
    klass->parent = parent;
    klass->desc = desc;
@@ -1396,7 +1520,6 @@ eo_class_new(const Eo_Class_Description *desc, const Eo_Class *parent_id, ...)
 
    if (!_eo_class_funcs_set(klass))
      {
-        eina_spinlock_free(&klass->objects.trash_lock);
         eina_spinlock_free(&klass->iterators.trash_lock);
         _dich_func_clean_all(klass);
         free(klass);
@@ -1418,6 +1541,7 @@ eo_class_new(const Eo_Class_Description *desc, const Eo_Class *parent_id, ...)
         _eo_classes = tmp;
         _eo_classes[klass->header.id - 1] = klass;
      }
+   _eo_slab_pool_init(&klass->objects, _eo_classes_last_id - 1, klass->obj_size);
    eina_spinlock_release(&_eo_class_creation_lock);
 
    _eo_class_constructor(klass);
@@ -1761,6 +1885,12 @@ eo_init(void)
                    EINA_LOG_STATE_STOP,
                    EINA_LOG_STATE_INIT);
 
+   if (!_eo_slab_init())
+     {
+        EINA_LOG_ERR("Could not create TLS key for object caches.");
+        return EINA_FALSE;
+     }
+
    /* bootstrap EO_CLASS_CLASS */
    (void) eo_class_class_get();
 
@@ -1792,6 +1922,9 @@ eo_shutdown(void)
                    EINA_LOG_STATE_START,
                    EINA_LOG_STATE_SHUTDOWN);
 
+   /* the magazines point into the pools of the classes */
+   _eo_slab_shutdown();
+
    for (i = 0 ; i < _eo_classes_last_id ; i++, cls_itr++)
      {
         if (*cls_itr)
@@ -1801,6 +1934,9 @@ eo_shutdown(void)
    if (_eo_classes)
      free(_eo_classes);
 
+   /* classes and ops may be different after the next eo_init() */
+   _eo_init_generation++;
+
    eina_spinlock_free(&_eo_class_creation_lock);
 
    if (_eo_call_stack_key != 0)
@@ -16,6 +16,7 @@ typedef struct
 {
    Eina_List *children;
    Eo *parent;
+   Eina_List *parent_list; /* our node in the parent's children list */
 
    Eina_Inlist *generic_data;
    Eo ***wrefs;
@@ -124,8 +125,12 @@ _parent_set(Eo *obj, void *class_data, Eo *parent_id)
         old_parent_pd = eo_data_scope_get(pd->parent, EO_CLASS);
         if (old_parent_pd)
           {
-             old_parent_pd->children = eina_list_remove(old_parent_pd->children,
-                                                        obj);
+             /* cleared when the parent is destructing and freeing its
+              * children list itself */
+             if (pd->parent_list)
+               old_parent_pd->children = eina_list_remove_list(old_parent_pd->children,
+                                                               pd->parent_list);
+             pd->parent_list = NULL;
           }
         else
           {
@@ -147,6 +152,7 @@ _parent_set(Eo *obj, void *class_data, Eo *parent_id)
              pd->parent = parent_id;
              parent_pd->children = eina_list_append(parent_pd->children,
                    obj);
+             pd->parent_list = eina_list_last(parent_pd->children);
              eo_xref(obj, pd->parent);
           }
         else
@@ -937,7 +943,12 @@ _destructor(Eo *obj, void *class_data)
    DBG("%p - %s.", obj, eo_class_name_get(MY_CLASS));
 
    EINA_LIST_FREE(pd->children, child)
-      eo_do(child, eo_parent_set(NULL));
+     {
+        Private_Data *child_pd = eo_data_scope_get(child, EO_CLASS);
+
+        if (child_pd) child_pd->parent_list = NULL;
+        eo_do(child, eo_parent_set(NULL));
+     }
 
    _eo_generic_data_del_all(class_data);
    _wref_destruct(class_data);
@@ -75,6 +75,27 @@ static inline void _eo_free_ids_tables(void);
 
 void _eo_condtor_done(Eo *obj);
 
+typedef struct _Eo_Slab Eo_Slab;
+
+/* Per class pool of objects, see eo_slab.c */
+typedef struct
+{
+   Eina_Inlist  *slabs;  /* the ones with free objects first */
+   Eo_Slab      *spare;
+   Eina_Spinlock lock;
+   unsigned int  obj_size;
+   unsigned int  slab_size;
+   unsigned int  slab_count; /* objects per slab */
+   unsigned int  id; /* of the magazine in the thread caches */
+} Eo_Slab_Pool;
+
+void _eo_slab_pool_init(Eo_Slab_Pool *pool, unsigned int id, unsigned int obj_size);
+void _eo_slab_pool_shutdown(Eo_Slab_Pool *pool);
+void *_eo_slab_alloc(Eo_Slab_Pool *pool);
+void _eo_slab_free(Eo_Slab_Pool *pool, void *ptr);
+Eina_Bool _eo_slab_init(void);
+void _eo_slab_shutdown(void);
+
 struct _Eo_Base
 {
 #ifndef HAVE_EO_ID
@@ -143,12 +164,8 @@ struct _Eo_Class
 
    const _Eo_Class **mro;
 
-   /* cached object for faster allocation */
-   struct {
-      Eina_Trash  *trash;
-      Eina_Spinlock    trash_lock;
-      unsigned int trash_count;
-   } objects;
+   /* slabs the objects are allocated from */
+   Eo_Slab_Pool objects;
 
    /* cached iterator for faster allocation cycle */
    struct {
@@ -252,17 +269,7 @@ _eo_free(_Eo_Object *obj)
 #endif
    _eo_id_release((Eo_Id) _eo_id_get(obj));
 
-   eina_spinlock_take(&klass->objects.trash_lock);
-   if (klass->objects.trash_count <= 8)
-     {
-        eina_trash_push(&klass->objects.trash, obj);
-        klass->objects.trash_count++;
-     }
-   else
-     {
-        free(obj);
-     }
-   eina_spinlock_release(&klass->objects.trash_lock);
+   _eo_slab_free(&klass->objects, obj);
 }
 
 static inline _Eo_Object *
@@ -0,0 +1,406 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(HAVE_SYS_MMAN_H) && !defined(_WIN32)
+# include <sys/mman.h>
+# define EO_SLAB_MMAP 1
+# ifndef MAP_ANONYMOUS
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+#endif
+
+#include <Eina.h>
+
+#include "Eo.h"
+#include "eo_ptr_indirection.h"
+#include "eo_private.h"
+
+/* Objects of a class are carved out of slabs, blocks of slab_size bytes
+ * aligned on slab_size, so the slab of an object is found by masking its
+ * address. Slabs with free room are kept at the head of the pool list and
+ * the full ones at its tail. A slab that gets empty goes back to the system,
+ * except for one kept as spare by each pool.
+ *
+ * On top of that each thread keeps a small magazine of freed objects per
+ * class, so deleting and adding objects of the same class, as a scrolled
+ * list does all the time, doesn't even take the pool lock. The magazines
+ * of all the threads are also listed globally, so eo_shutdown() can give
+ * them back while other threads are still alive.
+ *
+ * The id of an object is released before its memory gets back to a
+ * magazine or a slab, so an id kept past the deletion is refused by the
+ * generation check of the ids table even though the memory is reused
+ * very soon.
+ */
+
+#define EO_SLAB_SIZE_MIN      (64 * 1024)
+#define EO_SLAB_OBJECTS_MIN   16
+#define EO_SLAB_MAGAZINE_SIZE 32
+
+struct _Eo_Slab
+{
+   EINA_INLIST;
+#ifndef EO_SLAB_MMAP
+   void *base;           /* what malloc returned */
+#endif
+   Eina_Trash *trash;    /* freed objects */
+   unsigned char *last;  /* first never used object */
+   unsigned int used;
+};
+
+typedef struct
+{
+   Eo_Slab_Pool *pool;
+   Eina_Trash *trash;
+   unsigned int count;
+} Eo_Slab_Magazine;
+
+typedef struct
+{
+   EINA_INLIST;
+   Eo_Slab_Magazine *magazines; /* indexed by pool id */
+   unsigned int count;
+} Eo_Slab_Cache;
+
+static Eina_TLS _eo_slab_cache_key = 0;
+/* the caches of all the threads, protected by the lock */
+static Eina_Inlist *_eo_slab_caches = NULL;
+static Eina_Spinlock _eo_slab_caches_lock;
+
+#define EO_SLAB_HEADER_SIZE eina_mempool_alignof(sizeof(Eo_Slab))
+
+static Eo_Slab *
+_eo_slab_new(Eo_Slab_Pool *pool)
+{
+   unsigned char *ptr, *aligned;
+   Eo_Slab *slab;
+   size_t size = pool->slab_size;
+
+#ifdef EO_SLAB_MMAP
+   size_t head;
+
+   /* map twice the size to find an aligned block, then unmap around it */
+   ptr = mmap(NULL, size * 2, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (ptr == MAP_FAILED)
+     {
+        ERR("mmap of an eo slab failed!");
+        return NULL;
+     }
+   aligned = (unsigned char *) (((uintptr_t) ptr + size - 1) & ~((uintptr_t) size - 1));
+   head = aligned - ptr;
+   if (head) munmap(ptr, head);
+   munmap(aligned + size, size - head);
+   slab = (Eo_Slab *) aligned;
+#else
+   ptr = malloc(size * 2);
+   if (!ptr)
+     {
+        ERR("allocation of an eo slab failed!");
+        return NULL;
+     }
+   aligned = (unsigned char *) (((uintptr_t) ptr + size - 1) & ~((uintptr_t) size - 1));
+   slab = (Eo_Slab *) aligned;
+   slab->base = ptr;
+#endif
+
+   EINA_INLIST_GET(slab)->next = NULL;
+   EINA_INLIST_GET(slab)->prev = NULL;
+   EINA_INLIST_GET(slab)->last = NULL;
+   slab->trash = NULL;
+   slab->last = aligned + EO_SLAB_HEADER_SIZE;
+   slab->used = 0;
+
+   return slab;
+}
+
+static void
+_eo_slab_del(Eo_Slab_Pool *pool, Eo_Slab *slab)
+{
+#ifdef EO_SLAB_MMAP
+   munmap(slab, pool->slab_size);
+#else
+   (void) pool;
+   free(slab->base);
+#endif
+}
+
+static inline Eo_Slab *
+_eo_slab_get(const Eo_Slab_Pool *pool, const void *ptr)
+{
+   return (Eo_Slab *) ((uintptr_t) ptr & ~((uintptr_t) pool->slab_size - 1));
+}
+
+static void *
+_eo_slab_pool_alloc(Eo_Slab_Pool *pool)
+{
+   Eo_Slab *slab = NULL;
+   void *ptr;
+
+   eina_spinlock_take(&pool->lock);
+
+   if (pool->slabs)
+     slab = EINA_INLIST_CONTAINER_GET(pool->slabs, Eo_Slab);
+
+   /* the head is full only when all of them are */
+   if (!slab || (slab->used == pool->slab_count))
+     {
+        if (pool->spare)
+          {
+             slab = pool->spare;
+             pool->spare = NULL;
+          }
+        else
+          {
+             slab = _eo_slab_new(pool);
+             if (!slab)
+               {
+                  eina_spinlock_release(&pool->lock);
+                  return NULL;
+               }
+          }
+        pool->slabs = eina_inlist_prepend(pool->slabs, EINA_INLIST_GET(slab));
+     }
+
+   ptr = eina_trash_pop(&slab->trash);
+   if (!ptr)
+     {
+        ptr = slab->last;
+        slab->last += pool->obj_size;
+     }
+   slab->used++;
+
+   if ((slab->used == pool->slab_count) && (EINA_INLIST_GET(slab)->next))
+     pool->slabs = eina_inlist_demote(pool->slabs, EINA_INLIST_GET(slab));
+
+   eina_spinlock_release(&pool->lock);
+
+   return ptr;
+}
+
+static void
+_eo_slab_pool_free(Eo_Slab_Pool *pool, void *ptr)
+{
+   Eo_Slab *slab = _eo_slab_get(pool, ptr);
+   Eina_Bool was_full;
+
+   eina_spinlock_take(&pool->lock);
+
+   was_full = (slab->used == pool->slab_count);
+   eina_trash_push(&slab->trash, ptr);
+   slab->used--;
+
+   if (!slab->used)
+     {
+        pool->slabs = eina_inlist_remove(pool->slabs, EINA_INLIST_GET(slab));
+        if (pool->spare)
+          {
+             _eo_slab_del(pool, slab);
+          }
+        else
+          {
+             slab->trash = NULL;
+             slab->last = ((unsigned char *) slab) + EO_SLAB_HEADER_SIZE;
+             pool->spare = slab;
+          }
+     }
+   else if (was_full)
+     {
+        pool->slabs = eina_inlist_promote(pool->slabs, EINA_INLIST_GET(slab));
+     }
+
+   eina_spinlock_release(&pool->lock);
+}
+
+static Eo_Slab_Magazine *
+_eo_slab_magazine_get(const Eo_Slab_Pool *pool, Eina_Bool create)
+{
+   Eo_Slab_Cache *cache = eina_tls_get(_eo_slab_cache_key);
+   Eo_Slab_Magazine *tmp;
+
+   if (cache && (pool->id < cache->count))
+     return &cache->magazines[pool->id];
+
+   if (!create) return NULL;
+
+   if (!cache)
+     {
+        cache = calloc(1, sizeof(Eo_Slab_Cache));
+        if (!cache) return NULL;
+
+        if (!eina_tls_set(_eo_slab_cache_key, cache))
+          {
+             free(cache);
+             return NULL;
+          }
+
+        eina_spinlock_take(&_eo_slab_caches_lock);
+        _eo_slab_caches = eina_inlist_append(_eo_slab_caches, EINA_INLIST_GET(cache));
+        eina_spinlock_release(&_eo_slab_caches_lock);
+     }
+
+   tmp = realloc(cache->magazines, (pool->id + 1) * sizeof(Eo_Slab_Magazine));
+   if (!tmp) return NULL;
+
+   memset(tmp + cache->count, 0,
+          (pool->id + 1 - cache->count) * sizeof(Eo_Slab_Magazine));
+   cache->magazines = tmp;
+   cache->count = pool->id + 1;
+
+   return &cache->magazines[pool->id];
+}
+
+/* Gives the objects of a cache back to their slabs, the caches lock is held. */
+static void
+_eo_slab_cache_release(Eo_Slab_Cache *cache)
+{
+   unsigned int i;
+   void *ptr;
+
+   _eo_slab_caches = eina_inlist_remove(_eo_slab_caches, EINA_INLIST_GET(cache));
+
+   for (i = 0; i < cache->count; i++)
+     {
+        Eo_Slab_Magazine *mag = &cache->magazines[i];
+
+        while ((ptr = eina_trash_pop(&mag->trash)))
+          _eo_slab_pool_free(mag->pool, ptr);
+     }
+
+   free(cache->magazines);
+   free(cache);
+}
+
+/* Called when a thread exits. The cache may have been released by
+ * eo_shutdown() meanwhile, so it is only touched if still listed. */
+static void
+_eo_slab_cache_free(void *data)
+{
+   Eo_Slab_Cache *cache = data;
+   Eina_Inlist *l;
+
+   if (!cache) return;
+
+   eina_spinlock_take(&_eo_slab_caches_lock);
+   for (l = _eo_slab_caches; l; l = l->next)
+     {
+        if (l == EINA_INLIST_GET(cache))
+          {
+             _eo_slab_cache_release(cache);
+             break;
+          }
+     }
+   eina_spinlock_release(&_eo_slab_caches_lock);
+}
+
+void
+_eo_slab_pool_init(Eo_Slab_Pool *pool, unsigned int id, unsigned int obj_size)
+{
+   pool->slabs = NULL;
+   pool->spare = NULL;
+   pool->id = id;
+   pool->obj_size = eina_mempool_alignof(obj_size);
+
+   pool->slab_size = EO_SLAB_SIZE_MIN;
+   while (pool->slab_size < EO_SLAB_HEADER_SIZE + EO_SLAB_OBJECTS_MIN * pool->obj_size)
+     pool->slab_size <<= 1;
+   pool->slab_count = (pool->slab_size - EO_SLAB_HEADER_SIZE) / pool->obj_size;
+
+   eina_spinlock_new(&pool->lock);
+}
+
+void
+_eo_slab_pool_shutdown(Eo_Slab_Pool *pool)
+{
+   Eo_Slab *slab;
+
+   while (pool->slabs)
+     {
+        slab = EINA_INLIST_CONTAINER_GET(pool->slabs, Eo_Slab);
+        pool->slabs = eina_inlist_remove(pool->slabs, pool->slabs);
+        _eo_slab_del(pool, slab);
+     }
+
+   if (pool->spare)
+     _eo_slab_del(pool, pool->spare);
+   pool->spare = NULL;
+
+   eina_spinlock_free(&pool->lock);
+}
+
+void *
+_eo_slab_alloc(Eo_Slab_Pool *pool)
+{
+   Eo_Slab_Magazine *mag;
+   void *ptr;
+
+   mag = _eo_slab_magazine_get(pool, EINA_FALSE);
+   if (mag && mag->count)
+     {
+        ptr = eina_trash_pop(&mag->trash);
+        mag->count--;
+     }
+   else
+     {
+        ptr = _eo_slab_pool_alloc(pool);
+        if (!ptr) return NULL;
+     }
+
+   memset(ptr, 0, pool->obj_size);
+
+   return ptr;
+}
+
+void
+_eo_slab_free(Eo_Slab_Pool *pool, void *ptr)
+{
+   Eo_Slab_Magazine *mag;
+
+   mag = _eo_slab_magazine_get(pool, EINA_TRUE);
+   if (mag && (mag->count < EO_SLAB_MAGAZINE_SIZE))
+     {
+        mag->pool = pool;
+        eina_trash_push(&mag->trash, ptr);
+        mag->count++;
+        return;
+     }
+
+   _eo_slab_pool_free(pool, ptr);
+}
+
+Eina_Bool
+_eo_slab_init(void)
+{
+   if (!eina_spinlock_new(&_eo_slab_caches_lock))
+     return EINA_FALSE;
+
+   if (!eina_tls_cb_new(&_eo_slab_cache_key, _eo_slab_cache_free))
+     {
+        eina_spinlock_free(&_eo_slab_caches_lock);
+        return EINA_FALSE;
+     }
+
+   return EINA_TRUE;
+}
+
+/* Must be called before the classes, and so the pools, are freed. The
+ * magazines of all the threads are emptied, not only the calling one's,
+ * since the thread exit callback isn't called anymore once the key is
+ * gone. */
+void
+_eo_slab_shutdown(void)
+{
+   eina_spinlock_take(&_eo_slab_caches_lock);
+   while (_eo_slab_caches)
+     _eo_slab_cache_release(EINA_INLIST_CONTAINER_GET(_eo_slab_caches, Eo_Slab_Cache));
+   eina_spinlock_release(&_eo_slab_caches_lock);
+
+   eina_tls_free(_eo_slab_cache_key);
+   _eo_slab_cache_key = 0;
+
+   eina_spinlock_free(&_eo_slab_caches_lock);
+}
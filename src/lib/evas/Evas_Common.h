@@ -1539,6 +1539,93 @@ EAPI const Evas_Device *evas_device_emulation_source_get(const Evas_Device *dev)
  * @ingroup Evas_Canvas
  */
 
+/**
+ * @addtogroup Evas_Image_Group
+ *
+ * @{
+ */
+
+typedef struct _Evas_Image_Scale_Cache_Stats Evas_Image_Scale_Cache_Stats; /**< Statistics of the scaled image cache @since 1.10 */
+
+/**
+ * Statistics of the cache of scaled images used by the software engines.
+ *
+ * Counters add up from evas_init(), or from the last call to
+ * evas_image_scale_cache_stats_reset().
+ *
+ * @since 1.10
+ */
+struct _Evas_Image_Scale_Cache_Stats
+{
+   unsigned long long hits; /**< draws done from a cached scaled copy */
+   unsigned long long misses; /**< draws that scaled the original image */
+   unsigned long long populates; /**< scaled copies added to the cache */
+   unsigned long long evictions; /**< scaled copies dropped to make room for new ones, not those dropped by a flush or a smaller limit */
+   unsigned int size; /**< memory held by the cache, in bytes */
+   unsigned int max_size; /**< limit of the memory held by the cache, in bytes */
+   unsigned int items; /**< number of scaled copies in the cache */
+   unsigned int min_uses; /**< uses of a scale needed before it is cached */
+   double scale_time; /**< time spent scaling, in seconds */
+};
+
+/**
+ * Get the statistics of the scaled image cache.
+ *
+ * The cache is shared by all canvases using a software engine. Scale
+ * time is only counted for synchronous rendering, as scaling done by
+ * the render thread is not measured.
+ *
+ * @param stats Where to store the statistics.
+ * @return @c EINA_TRUE if @p stats was filled, @c EINA_FALSE otherwise.
+ *
+ * @see evas_image_scale_cache_stats_reset()
+ * @since 1.10
+ */
+EAPI Eina_Bool   evas_image_scale_cache_stats_get(Evas_Image_Scale_Cache_Stats *stats);
+
+/**
+ * Reset the counters of the scaled image cache statistics to zero.
+ *
+ * @see evas_image_scale_cache_stats_get()
+ * @since 1.10
+ */
+EAPI void        evas_image_scale_cache_stats_reset(void);
+
+/**
+ * Set whether the scaled image cache adapts to how copies are reused.
+ *
+ * A scale is only cached once it was drawn a few times. When adaptive,
+ * a new copy makes room by evicting the least recently used ones, and
+ * that number of draws goes up when most copies get evicted before they
+ * were reused, and down when nearly all of them are reused. Otherwise a
+ * copy is only added if it fits, and the number of draws stays as given
+ * by the EVAS_SCALECACHE_MIN_USES environment variable.
+ *
+ * Adaptation is off by default, EVAS_SCALECACHE_ADAPTIVE=1 turns it on.
+ * The number of draws then starts from EVAS_SCALECACHE_MIN_USES.
+ *
+ * @param adaptive @c EINA_TRUE to adapt, @c EINA_FALSE to use a fixed
+ * number of uses.
+ *
+ * @see Evas_Image_Scale_Cache_Stats
+ * @since 1.10
+ */
+EAPI void        evas_image_scale_cache_adaptive_set(Eina_Bool adaptive);
+
+/**
+ * Get whether the scaled image cache adapts to how copies are reused.
+ *
+ * @return @c EINA_TRUE if it adapts, @c EINA_FALSE otherwise.
+ *
+ * @see evas_image_scale_cache_adaptive_set()
+ * @since 1.10
+ */
+EAPI Eina_Bool   evas_image_scale_cache_adaptive_get(void);
+
+/**
+ * @}
+ */
+
 /**
  * @defgroup Evas_Font_Group Font Functions
  *
@@ -237,6 +237,15 @@ struct _Evas_Image_Load_Func
 EAPI Eina_Bool    evas_module_register   (const Evas_Module_Api *module, Evas_Module_Type type);
 EAPI Eina_Bool    evas_module_unregister (const Evas_Module_Api *module, Evas_Module_Type type);
 
+typedef void (*Evas_Module_Task_Split_Cb) (void *data, unsigned int part);
+typedef void (*Evas_Module_Task_Split_Run) (Evas_Module_Task_Split_Cb func, void *data, unsigned int count);
+
+/* A loader can cut a large decode in parts run at the same time. _max
+ * tells how many parts are worth making (1 if there is nobody to help),
+ * _run calls func once for each part and returns when all are done. */
+EAPI unsigned int evas_module_task_split_max (void);
+EAPI void         evas_module_task_split_run (Evas_Module_Task_Split_Cb func, void *data, unsigned int count);
+
 #define EVAS_MODULE_DEFINE(Type, Tn, Name)		\
   Eina_Bool evas_##Tn##_##Name##_init(void)		\
   {							\
@@ -39,6 +39,35 @@ static Evas_Preload_Pthread_Worker *_workers = NULL;
 
 static LK(_mutex);
 
+/* A loader can split the decode of a large image in parts (see
+ * evas_module_task_split_run()). The parts are run by helper threads, next
+ * to the thread that asked for them, and not queued behind other images,
+ * so one big file is not decoded by a single core. The helpers are started
+ * the first time they are needed. */
+typedef struct _Evas_Preload_Split Evas_Preload_Split;
+
+struct _Evas_Preload_Split
+{
+   EINA_INLIST;
+
+   Evas_Module_Task_Split_Cb func;
+   void *data;
+   unsigned int count;
+   unsigned int next;
+   unsigned int done;
+};
+
+static Eina_Inlist *_splits = NULL;
+static Eina_Thread *_split_threads = NULL;
+static int _split_threads_count = 0;
+static Eina_Bool _split_started = EINA_FALSE;
+static Eina_Bool _split_quit = EINA_FALSE;
+static LK(_split_mutex);
+static Eina_Condition _split_cond;
+static Eina_Condition _split_done_cond;
+/* parts run so far, the test suite checks large files were really split */
+static unsigned int _split_parts = 0;
+
 static void
 _evas_preload_thread_end(void *data)
 {
@@ -111,13 +140,138 @@ on_error:
    return pth;
 }
 
+/* called with _split_mutex held, returns with it held */
+static void
+_evas_preload_split_part_run(Evas_Preload_Split *split)
+{
+   unsigned int part;
+
+   part = split->next++;
+   if (split->next == split->count)
+     _splits = eina_inlist_remove(_splits, EINA_INLIST_GET(split));
+   LKU(_split_mutex);
+
+   split->func(split->data, part);
+
+   LKL(_split_mutex);
+   split->done++;
+   _split_parts++;
+   if (split->done == split->count)
+     eina_condition_broadcast(&_split_done_cond);
+}
+
+static void *
+_evas_preload_split_worker(void *data EINA_UNUSED, Eina_Thread thread EINA_UNUSED)
+{
+   LKL(_split_mutex);
+   for (;;)
+     {
+        while ((!_splits) && (!_split_quit))
+          eina_condition_wait(&_split_cond);
+        if (_split_quit) break;
+        _evas_preload_split_part_run(EINA_INLIST_CONTAINER_GET(_splits, Evas_Preload_Split));
+     }
+   LKU(_split_mutex);
+   return NULL;
+}
+
+static void
+_evas_preload_split_run(Evas_Module_Task_Split_Cb func, void *data, unsigned int count)
+{
+   Evas_Preload_Split split;
+
+   split.func = func;
+   split.data = data;
+   split.count = count;
+   split.next = 0;
+   split.done = 0;
+
+   LKL(_split_mutex);
+   if (!_split_started)
+     {
+        _split_started = EINA_TRUE;
+        eina_threads_init();
+        while (_split_threads_count < _threads_max - 1)
+          {
+             if (!eina_thread_create(&_split_threads[_split_threads_count],
+                                     EINA_THREAD_BACKGROUND, -1,
+                                     _evas_preload_split_worker, NULL))
+               break;
+             _split_threads_count++;
+          }
+     }
+   _splits = eina_inlist_append(_splits, EINA_INLIST_GET(&split));
+   eina_condition_broadcast(&_split_cond);
+
+   /* the caller takes its share of the parts, then waits for the others */
+   while (split.next < split.count)
+     _evas_preload_split_part_run(&split);
+   while (split.done < split.count)
+     eina_condition_wait(&_split_done_cond);
+   LKU(_split_mutex);
+}
+
+EAPI unsigned int
+_evas_preload_split_parts_get(void)
+{
+   unsigned int parts;
+
+   if (!_split_threads) return 0;
+   LKL(_split_mutex);
+   parts = _split_parts;
+   LKU(_split_mutex);
+   return parts;
+}
+
 void
 _evas_preload_thread_init(void)
 {
+   const char *s;
+
    _threads_max = eina_cpu_count();
+   s = getenv("EVAS_PRELOAD_THREADS");
+   if (s) _threads_max = atoi(s);
    if (_threads_max < 1) _threads_max = 1;
 
    LKI(_mutex);
+
+   if (_threads_max > 1)
+     {
+        _split_threads = calloc(_threads_max - 1, sizeof (Eina_Thread));
+        if (!_split_threads) return;
+        LKI(_split_mutex);
+        eina_condition_new(&_split_cond, &_split_mutex);
+        eina_condition_new(&_split_done_cond, &_split_mutex);
+        evas_module_task_split_set(_evas_preload_split_run, _threads_max);
+     }
+}
+
+static void
+_evas_preload_split_shutdown(void)
+{
+   int i;
+
+   if (!_split_threads) return;
+   evas_module_task_split_set(NULL, 1);
+
+   LKL(_split_mutex);
+   _split_quit = EINA_TRUE;
+   eina_condition_broadcast(&_split_cond);
+   LKU(_split_mutex);
+
+   for (i = 0; i < _split_threads_count; i++)
+     eina_thread_join(_split_threads[i]);
+   if (_split_started) eina_threads_shutdown();
+
+   eina_condition_free(&_split_done_cond);
+   eina_condition_free(&_split_cond);
+   LKD(_split_mutex);
+   free(_split_threads);
+   _split_threads = NULL;
+   _split_threads_count = 0;
+   _split_started = EINA_FALSE;
+   _split_quit = EINA_FALSE;
+   _split_parts = 0;
 }
 
 void
@@ -139,6 +293,8 @@ _evas_preload_thread_shutdown(void)
    LKU(_mutex);
 
    LKD(_mutex);
+
+   _evas_preload_split_shutdown();
 }
 
 Evas_Preload_Pthread *
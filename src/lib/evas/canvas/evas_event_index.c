@@ -0,0 +1,474 @@
+#include "evas_common_private.h"
+#include "evas_private.h"
+
+/* Spatial index of the objects of a layer or of the members of a smart
+ * object, so pointer events only look at the objects that may be under the
+ * pointer instead of walking the whole stack.
+ *
+ * Each object keeps its position in the stack and the region where it can
+ * get events: its clip for a normal or mapped object, its bounding box and
+ * geometry for a smart object. Regions are put in the cells of a grid, and
+ * the cells keep the positions sorted, so the candidates come out in
+ * stacking order. Smart objects with a mapped child and objects covering
+ * too many cells go in a list looked at for every point instead.
+ *
+ * Any change of an object marks it dirty and its region is computed again
+ * on the next query. Adding, removing or restacking an object just throws
+ * the whole index away, it is built again on the next query too. Short
+ * lists are not indexed at all, walking them is as fast. */
+
+#define EVAS_EVENT_INDEX_MIN        32   /* objects in a list to index it */
+#define EVAS_EVENT_INDEX_CELL_SHIFT 7    /* 128 pixels wide cells */
+#define EVAS_EVENT_INDEX_CELLS_MAX  64   /* cells of an object in the grid */
+
+/* no need to track changes as long as nothing is indexed */
+static int _evas_event_indexes = 0;
+
+/* queries are answered by walking the lists when off, tests compare both */
+static Eina_Bool _evas_event_index_enabled = EINA_TRUE;
+
+typedef enum
+{
+   EVAS_EVENT_INDEX_NONE,      /* can't get any event */
+   EVAS_EVENT_INDEX_CELLS,     /* in the cells covered by its region */
+   EVAS_EVENT_INDEX_ALWAYS     /* looked at for every point */
+} Evas_Event_Index_Where;
+
+typedef struct _Evas_Event_Index_Entry Evas_Event_Index_Entry;
+
+struct _Evas_Event_Index_Entry
+{
+   Evas_Object_Protected_Data *obj;
+   Eina_Rectangle              region;
+   unsigned char               where;
+   Eina_Bool                   dirty : 1;
+};
+
+struct _Evas_Event_Index
+{
+   Evas_Event_Index_Entry *entries; /* bottom first */
+   unsigned int            count;
+   unsigned int            size;
+
+   Eina_Hash              *cells;   /* cell key -> Eina_Inarray of positions */
+   Eina_Inarray            always;  /* positions */
+   Eina_Inarray            dirty;   /* positions */
+
+   Eina_Bool               rebuild : 1;
+};
+
+static int
+_evas_event_index_pos_cmp(const void *a, const void *b)
+{
+   unsigned int pa = *(const unsigned int *)a;
+   unsigned int pb = *(const unsigned int *)b;
+
+   if (pa < pb) return -1;
+   if (pa > pb) return 1;
+   return 0;
+}
+
+static void
+_evas_event_index_cell_free(void *data)
+{
+   eina_inarray_free(data);
+}
+
+static inline int
+_evas_event_index_cell_key(int cx, int cy)
+{
+   return ((cx & 0xffff) << 16) | (cy & 0xffff);
+}
+
+static Evas_Event_Index **
+_evas_event_index_owner_get(Evas_Object_Protected_Data *obj)
+{
+   if (obj->smart.parent)
+     {
+        Evas_Object_Protected_Data *smart;
+
+        smart = eo_data_scope_get(obj->smart.parent, EVAS_OBJ_CLASS);
+        if (!smart) return NULL;
+        return &smart->event_index;
+     }
+   if ((obj->in_layer) && (obj->layer))
+     return &obj->layer->event_index;
+   return NULL;
+}
+
+static void
+_evas_event_index_region_get(Evas_Object_Protected_Data *obj,
+                             Evas_Event_Index_Entry *entry)
+{
+   Eina_Rectangle *r = &entry->region;
+
+   if ((!obj->is_smart) ||
+       ((obj->map->cur.usemap) && (obj->map->cur.map) &&
+        (obj->map->cur.map->count == 4)))
+     {
+        /* what evas_object_is_in_output_rect() looks at */
+        EINA_RECTANGLE_SET(r,
+                           obj->cur->cache.clip.x, obj->cur->cache.clip.y,
+                           obj->cur->cache.clip.w, obj->cur->cache.clip.h);
+        if ((r->w <= 0) || (r->h <= 0))
+          entry->where = EVAS_EVENT_INDEX_NONE;
+        else
+          entry->where = EVAS_EVENT_INDEX_CELLS;
+     }
+   else if (obj->child_has_map)
+     {
+        /* the children can be anywhere */
+        EINA_RECTANGLE_SET(r, 0, 0, 0, 0);
+        entry->where = EVAS_EVENT_INDEX_ALWAYS;
+     }
+   else
+     {
+        Evas_Coord_Rectangle bbox = { 0, 0, 0, 0 };
+        int x1, y1, x2, y2;
+
+        evas_object_smart_bounding_box_update(obj->object, obj);
+        evas_object_smart_bounding_box_get(obj->object, &bbox, NULL);
+
+        /* both boxes include their right and bottom edges for events */
+        x1 = MIN(bbox.x, obj->cur->geometry.x);
+        y1 = MIN(bbox.y, obj->cur->geometry.y);
+        x2 = MAX(bbox.x + bbox.w, obj->cur->geometry.x + obj->cur->geometry.w);
+        y2 = MAX(bbox.y + bbox.h, obj->cur->geometry.y + obj->cur->geometry.h);
+        EINA_RECTANGLE_SET(r, x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+        entry->where = EVAS_EVENT_INDEX_CELLS;
+     }
+
+   if (entry->where == EVAS_EVENT_INDEX_CELLS)
+     {
+        long long cw, ch;
+
+        cw = (((long long)r->x + r->w - 1) >> EVAS_EVENT_INDEX_CELL_SHIFT) -
+          (r->x >> EVAS_EVENT_INDEX_CELL_SHIFT) + 1;
+        ch = (((long long)r->y + r->h - 1) >> EVAS_EVENT_INDEX_CELL_SHIFT) -
+          (r->y >> EVAS_EVENT_INDEX_CELL_SHIFT) + 1;
+        if (cw * ch > EVAS_EVENT_INDEX_CELLS_MAX)
+          entry->where = EVAS_EVENT_INDEX_ALWAYS;
+     }
+}
+
+static Eina_Bool
+_evas_event_index_place(Evas_Event_Index *index, unsigned int pos,
+                        Eina_Bool add)
+{
+   Evas_Event_Index_Entry *entry = &index->entries[pos];
+   const Eina_Rectangle *r = &entry->region;
+   int cx, cy, cx1, cy1, cx2, cy2;
+
+   if (entry->where == EVAS_EVENT_INDEX_NONE) return EINA_TRUE;
+
+   if (entry->where == EVAS_EVENT_INDEX_ALWAYS)
+     {
+        int i;
+
+        if (add)
+          return eina_inarray_insert_sorted(&index->always, &pos,
+                                            _evas_event_index_pos_cmp) >= 0;
+        i = eina_inarray_search_sorted(&index->always, &pos,
+                                       _evas_event_index_pos_cmp);
+        if (i >= 0) eina_inarray_remove_at(&index->always, i);
+        return EINA_TRUE;
+     }
+
+   cx1 = r->x >> EVAS_EVENT_INDEX_CELL_SHIFT;
+   cy1 = r->y >> EVAS_EVENT_INDEX_CELL_SHIFT;
+   cx2 = (r->x + r->w - 1) >> EVAS_EVENT_INDEX_CELL_SHIFT;
+   cy2 = (r->y + r->h - 1) >> EVAS_EVENT_INDEX_CELL_SHIFT;
+
+   for (cy = cy1; cy <= cy2; cy++)
+     for (cx = cx1; cx <= cx2; cx++)
+       {
+          Eina_Inarray *cell;
+          int key = _evas_event_index_cell_key(cx, cy);
+
+          cell = eina_hash_find(index->cells, &key);
+          if (add)
+            {
+               if (!cell)
+                 {
+                    cell = eina_inarray_new(sizeof(unsigned int), 8);
+                    if (!cell) return EINA_FALSE;
+                    if (!eina_hash_add(index->cells, &key, cell))
+                      {
+                         eina_inarray_free(cell);
+                         return EINA_FALSE;
+                      }
+                 }
+               if (eina_inarray_insert_sorted(cell, &pos,
+                                              _evas_event_index_pos_cmp) < 0)
+                 return EINA_FALSE;
+            }
+          else if (cell)
+            {
+               int i;
+
+               i = eina_inarray_search_sorted(cell, &pos,
+                                              _evas_event_index_pos_cmp);
+               if (i >= 0) eina_inarray_remove_at(cell, i);
+            }
+       }
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_evas_event_index_build(Evas_Event_Index *index, const Eina_Inlist *list)
+{
+   Evas_Object_Protected_Data *obj;
+   unsigned int count, pos;
+
+   eina_hash_free_buckets(index->cells);
+   eina_inarray_flush(&index->always);
+   eina_inarray_flush(&index->dirty);
+
+   count = eina_inlist_count(list);
+   if (count > index->size)
+     {
+        Evas_Event_Index_Entry *tmp;
+
+        tmp = realloc(index->entries, count * sizeof(Evas_Event_Index_Entry));
+        if (!tmp) return EINA_FALSE;
+        index->entries = tmp;
+        index->size = count;
+     }
+
+   pos = 0;
+   EINA_INLIST_FOREACH(list, obj)
+     {
+        Evas_Event_Index_Entry *entry = &index->entries[pos];
+
+        entry->obj = obj;
+        entry->dirty = EINA_FALSE;
+        obj->event_index_pos = pos;
+        _evas_event_index_region_get(obj, entry);
+        pos++;
+     }
+   index->count = count;
+
+   for (pos = 0; pos < count; pos++)
+     if (!_evas_event_index_place(index, pos, EINA_TRUE))
+       return EINA_FALSE;
+
+   index->rebuild = EINA_FALSE;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_evas_event_index_update(Evas_Event_Index *index)
+{
+   unsigned int *pos;
+
+   EINA_INARRAY_FOREACH(&index->dirty, pos)
+     {
+        Evas_Event_Index_Entry *entry = &index->entries[*pos];
+        Evas_Event_Index_Entry old = *entry, cur;
+
+        _evas_event_index_region_get(entry->obj, entry);
+        entry->dirty = EINA_FALSE;
+        if ((old.where == entry->where) &&
+            (old.region.x == entry->region.x) &&
+            (old.region.y == entry->region.y) &&
+            (old.region.w == entry->region.w) &&
+            (old.region.h == entry->region.h))
+          continue;
+
+        /* take it out of the cells of its old region first */
+        cur = *entry;
+        *entry = old;
+        _evas_event_index_place(index, *pos, EINA_FALSE);
+        *entry = cur;
+        if (!_evas_event_index_place(index, *pos, EINA_TRUE))
+          return EINA_FALSE;
+     }
+   eina_inarray_flush(&index->dirty);
+
+   return EINA_TRUE;
+}
+
+static Evas_Event_Index *
+_evas_event_index_new(void)
+{
+   Evas_Event_Index *index;
+
+   index = calloc(1, sizeof(Evas_Event_Index));
+   if (!index) return NULL;
+
+   index->cells = eina_hash_int32_new(_evas_event_index_cell_free);
+   if (!index->cells)
+     {
+        free(index);
+        return NULL;
+     }
+   eina_inarray_step_set(&index->always, sizeof(Eina_Inarray),
+                         sizeof(unsigned int), 8);
+   eina_inarray_step_set(&index->dirty, sizeof(Eina_Inarray),
+                         sizeof(unsigned int), 32);
+   index->rebuild = EINA_TRUE;
+   _evas_event_indexes++;
+
+   return index;
+}
+
+void
+evas_event_index_free(Evas_Event_Index *index)
+{
+   if (!index) return;
+
+   eina_hash_free(index->cells);
+   eina_inarray_flush(&index->always);
+   eina_inarray_flush(&index->dirty);
+   free(index->entries);
+   free(index);
+   _evas_event_indexes--;
+}
+
+static void
+_evas_event_index_dirty(Evas_Event_Index *index,
+                        Evas_Object_Protected_Data *obj)
+{
+   unsigned int pos;
+
+   if (index->rebuild) return;
+
+   pos = obj->event_index_pos;
+   if ((pos >= index->count) || (index->entries[pos].obj != obj))
+     {
+        index->rebuild = EINA_TRUE;
+        return;
+     }
+   if (index->entries[pos].dirty) return;
+
+   if (eina_inarray_push(&index->dirty, &pos) < 0)
+     index->rebuild = EINA_TRUE;
+   else
+     index->entries[pos].dirty = EINA_TRUE;
+}
+
+void
+evas_event_index_object_changed(Evas_Object_Protected_Data *obj)
+{
+   if (!_evas_event_indexes) return;
+
+   /* the bounding box of the smart parents follows their members */
+   while (obj)
+     {
+        Evas_Object_Protected_Data *smart = NULL;
+        Evas_Event_Index *index = NULL;
+
+        if (obj->smart.parent)
+          {
+             smart = eo_data_scope_get(obj->smart.parent, EVAS_OBJ_CLASS);
+             if (!smart) return;
+             index = smart->event_index;
+          }
+        else if ((obj->in_layer) && (obj->layer))
+          index = obj->layer->event_index;
+
+        if (index) _evas_event_index_dirty(index, obj);
+        obj = smart;
+     }
+}
+
+void
+evas_event_index_object_clip_changed(Evas_Object_Protected_Data *obj)
+{
+   Evas_Event_Index **owner;
+
+   if (!_evas_event_indexes) return;
+
+   owner = _evas_event_index_owner_get(obj);
+   if ((owner) && (*owner)) _evas_event_index_dirty(*owner, obj);
+}
+
+void
+evas_event_index_list_changed(Evas_Object_Protected_Data *obj)
+{
+   Evas_Event_Index **owner;
+
+   owner = _evas_event_index_owner_get(obj);
+   if ((owner) && (*owner)) (*owner)->rebuild = EINA_TRUE;
+}
+
+EAPI void
+evas_event_index_enabled_set(Eina_Bool enabled)
+{
+   _evas_event_index_enabled = !!enabled;
+}
+
+Eina_Bool
+evas_event_index_query(const Eina_Inlist *list, int x, int y,
+                       Eina_Inarray *result)
+{
+   Evas_Event_Index_Entry *entries;
+   Evas_Event_Index **owner;
+   Evas_Event_Index *index;
+   Eina_Inarray *cell;
+   unsigned int *cpos = NULL, *apos;
+   int key, ci, ai;
+
+   if ((!list) || (!_evas_event_index_enabled)) return EINA_FALSE;
+   owner = _evas_event_index_owner_get(EINA_INLIST_CONTAINER_GET(list, Evas_Object_Protected_Data));
+   if (!owner) return EINA_FALSE;
+
+   index = *owner;
+   if (!index)
+     {
+        const Eina_Inlist *l;
+        unsigned int count = 0;
+
+        for (l = list; (l) && (count < EVAS_EVENT_INDEX_MIN); l = l->next)
+          count++;
+        if (count < EVAS_EVENT_INDEX_MIN) return EINA_FALSE;
+
+        index = _evas_event_index_new();
+        if (!index) return EINA_FALSE;
+        *owner = index;
+     }
+
+   if (index->rebuild)
+     {
+        if (!_evas_event_index_build(index, list))
+          {
+             index->rebuild = EINA_TRUE;
+             return EINA_FALSE;
+          }
+     }
+   else if (!_evas_event_index_update(index))
+     {
+        index->rebuild = EINA_TRUE;
+        return EINA_FALSE;
+     }
+
+   key = _evas_event_index_cell_key(x >> EVAS_EVENT_INDEX_CELL_SHIFT,
+                                    y >> EVAS_EVENT_INDEX_CELL_SHIFT);
+   cell = eina_hash_find(index->cells, &key);
+   ci = cell ? (int)eina_inarray_count(cell) - 1 : -1;
+   if (cell) cpos = cell->members;
+   ai = (int)eina_inarray_count(&index->always) - 1;
+   apos = index->always.members;
+   entries = index->entries;
+
+   /* merge both lists from the top of the stack */
+   while ((ci >= 0) || (ai >= 0))
+     {
+        Evas_Event_Index_Entry *entry;
+
+        if ((ai < 0) || ((ci >= 0) && (cpos[ci] > apos[ai])))
+          {
+             entry = &entries[cpos[ci--]];
+             if (!eina_rectangle_coords_inside(&entry->region, x, y))
+               continue;
+          }
+        else
+          entry = &entries[apos[ai--]];
+
+        if (eina_inarray_push(result, &entry->obj) < 0)
+          return EINA_FALSE;
+     }
+
+   return EINA_TRUE;
+}
@@ -32,129 +32,168 @@ _evas_event_havemap_adjust(Evas_Object *eo_obj EINA_UNUSED, Evas_Object_Protecte
      }
 }
 
-static Eina_List *
-_evas_event_object_list_raw_in_get(Evas *eo_e, Eina_List *in,
-                                   const Eina_Inlist *list, Evas_Object *stop,
-                                   int x, int y, int *no_rep, Eina_Bool source)
+/* Adds obj to in if it is under x, y, or its members under x, y for a smart
+ * object. Returns EINA_TRUE when the objects below obj don't get the event. */
+static Eina_Bool
+_evas_event_object_in_get(Evas *eo_e, Eina_List **in,
+                          Evas_Object_Protected_Data *obj, Evas_Object *stop,
+                          int x, int y, Eina_Bool source)
 {
    Evas_Object *eo_obj;
-   Evas_Object_Protected_Data *obj = NULL;
    int inside;
 
-   if (!list) return in;
-   for (obj = _EINA_INLIST_CONTAINER(obj, list); 
-        obj; 
-        obj = _EINA_INLIST_CONTAINER(obj, EINA_INLIST_GET(obj)->prev))
+   eo_obj = obj->object;
+   if (eo_obj == stop) return EINA_TRUE;
+   if (!source)
      {
-        eo_obj = obj->object;
-        if (eo_obj == stop)
-          {
-             *no_rep = 1;
-             return in;
-          }
-        if (!source)
-          {
-             if (evas_event_passes_through(eo_obj, obj)) continue;
-             if (evas_object_is_source_invisible(eo_obj, obj)) continue;
-          }
-        if ((obj->delete_me == 0) &&
-            ((source) || ((obj->cur->visible) && (!obj->clip.clipees) &&
-             evas_object_clippers_is_visible(eo_obj, obj))))
+        if (evas_event_passes_through(eo_obj, obj)) return EINA_FALSE;
+        if (evas_object_is_source_invisible(eo_obj, obj)) return EINA_FALSE;
+     }
+   if ((obj->delete_me == 0) &&
+       ((source) || ((obj->cur->visible) && (!obj->clip.clipees) &&
+        evas_object_clippers_is_visible(eo_obj, obj))))
+     {
+        if (obj->is_smart)
           {
-             if (obj->is_smart)
-               {
-                  int norep = 0;
+             int norep = 0;
 
-                  if ((obj->map->cur.usemap) && (obj->map->cur.map) &&
-                      (obj->map->cur.map->count == 4))
+             if ((obj->map->cur.usemap) && (obj->map->cur.map) &&
+                 (obj->map->cur.map->count == 4))
+               {
+                  inside = evas_object_is_in_output_rect(eo_obj, obj, x, y, 1, 1);
+                  if (inside)
                     {
-                       inside = evas_object_is_in_output_rect(eo_obj, obj, x, y, 1, 1);
-                       if (inside)
+                       if (!evas_map_coords_get(obj->map->cur.map, x, y,
+                                                &(obj->map->cur.map->mx),
+                                                &(obj->map->cur.map->my), 0))
                          {
-                            if (!evas_map_coords_get(obj->map->cur.map, x, y,
-                                                     &(obj->map->cur.map->mx),
-                                                     &(obj->map->cur.map->my), 0))
-                              {
-                                 inside = 0;
-                              }
-                            else
-                              {
-                                 in = _evas_event_object_list_in_get
-                                    (eo_e, in,
-                                     evas_object_smart_members_get_direct(eo_obj),
-                                     stop,
-                                     obj->cur->geometry.x + obj->map->cur.map->mx,
-                                     obj->cur->geometry.y + obj->map->cur.map->my,
-                                     &norep, source);
-                              }
+                            inside = 0;
                          }
-                    }
-                  else
-                    {
-		       Evas_Coord_Rectangle bounding_box = { 0, 0, 0, 0 };
-
-                       if (!obj->child_has_map)
-                         evas_object_smart_bounding_box_update(eo_obj, obj);
-
-		       evas_object_smart_bounding_box_get(eo_obj, &bounding_box, NULL);
-
-                       if (obj->child_has_map ||
-                           (bounding_box.x <= x &&
-                            bounding_box.x + bounding_box.w >= x &&
-                            bounding_box.y <= y &&
-                            bounding_box.y + bounding_box.h >= y) ||
-                           (obj->cur->geometry.x <= x &&
-                            obj->cur->geometry.x + obj->cur->geometry.w >= x &&
-                            obj->cur->geometry.y <= y &&
-                            obj->cur->geometry.y + obj->cur->geometry.h >= y))
-                         in = _evas_event_object_list_in_get
-                            (eo_e, in, evas_object_smart_members_get_direct(eo_obj),
-                            stop, x, y, &norep, source);
-                    }
-                  if (norep)
-                    {
-                       if (!obj->repeat_events)
+                       else
                          {
-                            *no_rep = 1;
-                            return in;
+                            *in = _evas_event_object_list_in_get
+                               (eo_e, *in,
+                                evas_object_smart_members_get_direct(eo_obj),
+                                stop,
+                                obj->cur->geometry.x + obj->map->cur.map->mx,
+                                obj->cur->geometry.y + obj->map->cur.map->my,
+                                &norep, source);
                          }
                     }
                }
              else
                {
-                  inside = evas_object_is_in_output_rect(eo_obj, obj, x, y, 1, 1);
+                  Evas_Coord_Rectangle bounding_box = { 0, 0, 0, 0 };
+
+                  if (!obj->child_has_map)
+                    evas_object_smart_bounding_box_update(eo_obj, obj);
+
+                  evas_object_smart_bounding_box_get(eo_obj, &bounding_box, NULL);
+
+                  if (obj->child_has_map ||
+                      (bounding_box.x <= x &&
+                       bounding_box.x + bounding_box.w >= x &&
+                       bounding_box.y <= y &&
+                       bounding_box.y + bounding_box.h >= y) ||
+                      (obj->cur->geometry.x <= x &&
+                       obj->cur->geometry.x + obj->cur->geometry.w >= x &&
+                       obj->cur->geometry.y <= y &&
+                       obj->cur->geometry.y + obj->cur->geometry.h >= y))
+                    *in = _evas_event_object_list_in_get
+                       (eo_e, *in, evas_object_smart_members_get_direct(eo_obj),
+                        stop, x, y, &norep, source);
+               }
+             if (norep)
+               {
+                  if (!obj->repeat_events) return EINA_TRUE;
+               }
+          }
+        else
+          {
+             inside = evas_object_is_in_output_rect(eo_obj, obj, x, y, 1, 1);
 
-                  if (inside)
-                    {
-                       if ((obj->map->cur.usemap) && (obj->map->cur.map) &&
-                           (obj->map->cur.map->count == 4))
-                         {
-                            if (!evas_map_coords_get(obj->map->cur.map, x, y,
-                                                     &(obj->map->cur.map->mx),
-                                                     &(obj->map->cur.map->my), 0))
-                              {
-                                 inside = 0;
-                              }
-                         }
-                    }
-                  if (inside && ((!obj->precise_is_inside) ||
-                                 (evas_object_is_inside(eo_obj, obj, x, y))))
+             if (inside)
+               {
+                  if ((obj->map->cur.usemap) && (obj->map->cur.map) &&
+                      (obj->map->cur.map->count == 4))
                     {
-                       if (!evas_event_freezes_through(eo_obj, obj))
-                         in = eina_list_append(in, eo_obj);
-                       if (!obj->repeat_events)
+                       if (!evas_map_coords_get(obj->map->cur.map, x, y,
+                                                &(obj->map->cur.map->mx),
+                                                &(obj->map->cur.map->my), 0))
                          {
-                            *no_rep = 1;
-                            return in;
+                            inside = 0;
                          }
                     }
                }
+             if (inside && ((!obj->precise_is_inside) ||
+                            (evas_object_is_inside(eo_obj, obj, x, y))))
+               {
+                  if (!evas_event_freezes_through(eo_obj, obj))
+                    *in = eina_list_append(*in, eo_obj);
+                  if (!obj->repeat_events) return EINA_TRUE;
+               }
+          }
+     }
+   return EINA_FALSE;
+}
+
+static Eina_List *
+_evas_event_object_list_raw_in_get(Evas *eo_e, Eina_List *in,
+                                   const Eina_Inlist *list, Evas_Object *stop,
+                                   int x, int y, int *no_rep, Eina_Bool source)
+{
+   Evas_Object_Protected_Data *obj = NULL;
+
+   if (!list) return in;
+   for (obj = _EINA_INLIST_CONTAINER(obj, list);
+        obj;
+        obj = _EINA_INLIST_CONTAINER(obj, EINA_INLIST_GET(obj)->prev))
+     {
+        if (_evas_event_object_in_get(eo_e, &in, obj, stop, x, y, source))
+          {
+             *no_rep = 1;
+             return in;
           }
      }
    *no_rep = 0;
    return in;
 }
 
+/* Same as the walk above, but only over the objects the spatial index of
+ * the list gives for x, y. Returns EINA_FALSE if the list isn't indexed. */
+static Eina_Bool
+_evas_event_object_list_index_in_get(Evas *eo_e, Eina_List **in,
+                                     const Eina_Inlist *list,
+                                     int x, int y, int *no_rep)
+{
+   Evas_Object_Protected_Data **objs;
+   Eina_Inarray candidates;
+   unsigned int i;
+
+   eina_inarray_step_set(&candidates, sizeof(candidates),
+                         sizeof(Evas_Object_Protected_Data *), 16);
+   if (!evas_event_index_query(list, x, y, &candidates))
+     {
+        eina_inarray_flush(&candidates);
+        return EINA_FALSE;
+     }
+
+   *no_rep = 0;
+   objs = candidates.members;
+   for (i = 0; i < candidates.len; i++)
+     {
+        if (_evas_event_object_in_get(eo_e, in, objs[i], NULL,
+                                      x, y, EINA_FALSE))
+          {
+             *no_rep = 1;
+             break;
+          }
+     }
+
+   eina_inarray_flush(&candidates);
+   return EINA_TRUE;
+}
+
 static void
 _transform_to_src_space(Evas_Object_Protected_Data *obj, Evas_Object_Protected_Data *src, Evas_Coord *x, Evas_Coord *y)
 {
@@ -857,6 +896,9 @@ _evas_event_object_list_in_get(Evas *eo_e, Eina_List *in,
                                int x, int y, int *no_rep, Eina_Bool source)
 {
    if (!list) return NULL;
+   if ((!stop) && (!source) &&
+       (_evas_event_object_list_index_in_get(eo_e, &in, list, x, y, no_rep)))
+     return in;
    return _evas_event_object_list_raw_in_get(eo_e, in, list->last, stop, x, y,
                                              no_rep, source);
 }
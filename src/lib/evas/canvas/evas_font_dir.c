@@ -825,7 +825,11 @@ evas_font_load(Evas *eo_evas, Evas_Font_Description *fdesc, const char *source,
 #if FC_MAJOR >= 2 && FC_MINOR >= 11
 	FcResult res;
 
-        FT_Face face = evas_common_font_freetype_face_get((RGBA_Font *) font);
+        FT_Face face;
+
+        evas_common_font_cache_lock();
+        face = evas_common_font_freetype_face_get((RGBA_Font *) font);
+        evas_common_font_cache_unlock();
 
         if (face)
           {
@@ -23,12 +23,14 @@ evas_object_inject(Evas_Object *eo_obj, Evas_Object_Protected_Data *obj, Evas *e
    lay->usage++;
    obj->layer = lay;
    obj->in_layer = 1;
+   evas_event_index_list_changed(obj);
 }
 
 void
 evas_object_release(Evas_Object *eo_obj, Evas_Object_Protected_Data *obj, int clean_layer)
 {
    if (!obj->in_layer) return;
+   evas_event_index_list_changed(obj);
    obj->layer->objects = (Evas_Object_Protected_Data *)eina_inlist_remove(EINA_INLIST_GET(obj->layer->objects), EINA_INLIST_GET(obj));
    eo_data_unref(eo_obj, obj);
    obj->layer->usage--;
@@ -59,6 +61,7 @@ evas_layer_new(Evas *eo_e)
 static void
 _evas_layer_free(Evas_Layer *lay)
 {
+   evas_event_index_free(lay->event_index);
    free(lay);
 }
 
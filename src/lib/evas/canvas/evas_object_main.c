@@ -206,6 +206,7 @@ evas_object_change(Evas_Object *eo_obj, Evas_Object_Protected_Data *obj)
    Eina_Bool movch = EINA_FALSE;
 
    if (!obj->layer) return;
+   evas_event_index_object_changed(obj);
    if (obj->layer->evas->nochange) return;
    obj->layer->evas->changed = EINA_TRUE;
 
@@ -253,6 +253,7 @@ _evas_smart_member_add(Eo *smart_obj, Evas_Smart_Data *o, Evas_Object *eo_obj)
    obj->layer->usage++;
    obj->smart.parent = smart_obj;
    o->contained = eina_inlist_append(o->contained, EINA_INLIST_GET(obj));
+   evas_event_index_list_changed(obj);
    eo_data_ref(eo_obj, NULL);
    evas_object_smart_member_cache_invalidate(eo_obj, EINA_TRUE, EINA_TRUE,
                                              EINA_TRUE);
@@ -290,6 +291,7 @@ _evas_smart_member_del(Eo *smart_obj, Evas_Smart_Data *_pd EINA_UNUSED, Evas_Obj
      smart->smart.smart->smart_class->member_del(smart_obj, eo_obj);
 
    Evas_Smart_Data *o = eo_data_scope_get(smart_obj, MY_CLASS);
+   evas_event_index_list_changed(obj);
    o->contained = eina_inlist_remove(o->contained, EINA_INLIST_GET(obj));
    eo_data_unref(eo_obj, obj);
    o->member_count--;
@@ -1223,6 +1225,9 @@ evas_object_smart_cleanup(Evas_Object *eo_obj)
 
         evas_smart_cb_descriptions_resize(&o->callbacks_descriptions, 0);
         eo_do(eo_obj, evas_obj_smart_data_set(NULL));
+
+        evas_event_index_free(obj->event_index);
+        obj->event_index = NULL;
      }
 
    obj->smart.parent = NULL;
@@ -1267,6 +1272,7 @@ evas_object_smart_member_raise(Evas_Object *eo_member)
    Evas_Object_Protected_Data *member = eo_data_scope_get(eo_member, EVAS_OBJ_CLASS);
    o = eo_data_scope_get(member->smart.parent, MY_CLASS);
    o->contained = eina_inlist_demote(o->contained, EINA_INLIST_GET(member));
+   evas_event_index_list_changed(member);
 }
 
 void
@@ -1276,6 +1282,7 @@ evas_object_smart_member_lower(Evas_Object *eo_member)
    Evas_Object_Protected_Data *member = eo_data_scope_get(eo_member, EVAS_OBJ_CLASS);
    o = eo_data_scope_get(member->smart.parent, MY_CLASS);
    o->contained = eina_inlist_promote(o->contained, EINA_INLIST_GET(member));
+   evas_event_index_list_changed(member);
 }
 
 void
@@ -1287,6 +1294,7 @@ evas_object_smart_member_stack_above(Evas_Object *eo_member, Evas_Object *eo_oth
    o = eo_data_scope_get(member->smart.parent, MY_CLASS);
    o->contained = eina_inlist_remove(o->contained, EINA_INLIST_GET(member));
    o->contained = eina_inlist_append_relative(o->contained, EINA_INLIST_GET(member), EINA_INLIST_GET(other));
+   evas_event_index_list_changed(member);
 }
 
 void
@@ -1298,6 +1306,7 @@ evas_object_smart_member_stack_below(Evas_Object *eo_member, Evas_Object *eo_oth
    o = eo_data_scope_get(member->smart.parent, MY_CLASS);
    o->contained = eina_inlist_remove(o->contained, EINA_INLIST_GET(member));
    o->contained = eina_inlist_prepend_relative(o->contained, EINA_INLIST_GET(member), EINA_INLIST_GET(other));
+   evas_event_index_list_changed(member);
 }
 
 void
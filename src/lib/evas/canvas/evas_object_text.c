@@ -173,7 +173,9 @@ _evas_object_text_char_coords_get(const Evas_Object *eo_obj,
 static void
 _evas_object_text_item_clean(Evas_Object_Text_Item *it)
 {
+   evas_common_font_cache_lock();
    evas_common_text_props_content_unref(&it->text_props);
+   evas_common_font_cache_unlock();
 }
 
 static void
@@ -643,6 +645,7 @@ _layout_text_item_trim(Evas_Object_Protected_Data *obj, Evas_Text_Data *o, Evas_
 
    memset(&new_text_props, 0, sizeof (new_text_props));
 
+   evas_common_font_cache_lock();
    while (!evas_common_text_props_split(&ti->text_props, &new_text_props, idx))
      idx--;
    if (want_start)
@@ -656,6 +659,7 @@ _layout_text_item_trim(Evas_Object_Protected_Data *obj, Evas_Text_Data *o, Evas_
         ti->text_pos += idx;
         ti->visual_pos += idx;
      }
+   evas_common_font_cache_unlock();
    _evas_object_text_item_update_sizes(obj, o, ti);
 
    return EINA_TRUE;
@@ -2227,6 +2231,7 @@ _evas_object_text_recalc(Evas_Object *eo_obj, Eina_Unicode *text)
      {
         Evas_Object_Text_Item *item;
 
+        evas_common_font_cache_lock();
         for (item = o->items ; item ;
               item = EINA_INLIST_CONTAINER_GET(
                  EINA_INLIST_GET(item)->next, Evas_Object_Text_Item))
@@ -2246,6 +2251,7 @@ _evas_object_text_recalc(Evas_Object *eo_obj, Eina_Unicode *text)
              if (asc > o->max_ascent) o->max_ascent = asc;
              if (desc > o->max_descent) o->max_descent = desc;
           }
+        evas_common_font_cache_unlock();
      }
    else if (o->font)
      {
@@ -202,6 +202,12 @@ typedef struct _Evas_Object_Textblock_Format_Item Evas_Object_Textblock_Format_I
  * A textblock format.
  */
 typedef struct _Evas_Object_Textblock_Format      Evas_Object_Textblock_Format;
+/**
+ * @internal
+ * @typedef Evas_Object_Textblock_Layout_Job
+ * A layout running in a thread.
+ */
+typedef struct _Evas_Object_Textblock_Layout_Job  Evas_Object_Textblock_Layout_Job;
 
 /**
  * @internal
@@ -349,10 +355,16 @@ struct _Evas_Object_Textblock_Paragraph
    Evas_BiDi_Paragraph_Props         *bidi_props; /* Only valid during layout */
    Evas_BiDi_Direction                direction;
    Evas_Coord                         y, w, h;
+   Evas_Coord                         last_w; /* The width the lines were laid out for */
+   Evas_Coord                         last_fw; /* Last calculated formatted width */
    int                                line_no;
+   struct {
+      int                             l, r, t, b;
+   } style_pad; /* The style pads of the formats of the paragraph */
    Eina_Bool                          is_bidi : 1;
    Eina_Bool                          visible : 1;
    Eina_Bool                          rendered : 1;
+   Eina_Bool                          format_neutral : 1; /* Its formats leave the format stack as they found it */
 };
 
 struct _Evas_Object_Textblock_Line
@@ -475,6 +487,9 @@ struct _Evas_Textblock_Cursor
 
 /* Size of the index array */
 #define TEXTBLOCK_PAR_INDEX_SIZE 10
+/* Number of paragraphs from which only the visible ones are laid out for
+ * rendering */
+#define TEXTBLOCK_PAR_VISIBLE_MIN 64
 struct _Evas_Object_Textblock
 {
    DATA32                              magic;
@@ -488,6 +503,8 @@ struct _Evas_Object_Textblock
    int                                 num_paragraphs;
    Evas_Object_Textblock_Paragraph    *paragraphs;
    Evas_Object_Textblock_Paragraph    *par_index[TEXTBLOCK_PAR_INDEX_SIZE];
+   Evas_Object_Textblock_Paragraph    *par_deferred; /* The first paragraph the last layout left out */
+   Evas_Object_Textblock_Layout_Job   *layout_job; /* The layout running in a thread, if any */
 
    Evas_Object_Textblock_Text_Item    *ellip_ti;
    Eina_List                          *anchors_a;
@@ -511,6 +528,7 @@ struct _Evas_Object_Textblock
    Eina_Bool                           format_changed : 1;
    Eina_Bool                           have_ellipsis : 1;
    Eina_Bool                           legacy_newline : 1;
+   Eina_Bool                           async_layout : 1;
 };
 
 /* private methods for textblock objects */
@@ -528,6 +546,7 @@ static void evas_object_textblock_render_post(Evas_Object *eo_obj,
 					      Evas_Object_Protected_Data *obj,
 					      void *type_private_data);
 static Evas_Object_Textblock_Node_Text *_evas_textblock_node_text_new(void);
+static void _layout_async_wait(Evas_Textblock_Data *o);
 
 static unsigned int evas_object_textblock_id_get(Evas_Object *eo_obj);
 static unsigned int evas_object_textblock_visual_id_get(Evas_Object *eo_obj);
@@ -689,6 +708,8 @@ static void
 _nodes_clear(const Evas_Object *eo_obj)
 {
    Evas_Textblock_Data *o = eo_data_scope_get(eo_obj, MY_CLASS);
+
+   _layout_async_wait(o);
    while (o->text_nodes)
      {
 	Evas_Object_Textblock_Node_Text *n;
@@ -740,7 +761,9 @@ _item_free(const Evas_Object *eo_obj, Evas_Object_Textblock_Line *ln, Evas_Objec
      {
         Evas_Object_Textblock_Text_Item *ti = _ITEM_TEXT(it);
 
+        evas_common_font_cache_lock();
         evas_common_text_props_content_unref(&ti->text_props);
+        evas_common_font_cache_unlock();
      }
    else
      {
@@ -2449,9 +2472,17 @@ struct _Ctxt
 
    Eina_List *format_stack;
    Evas_Object_Textblock_Format *fmt;
+   unsigned int format_stack_min;
+
+   Eina_Inarray *shapes; /* Text items left to shape, NULL to shape them now */
+   unsigned int shape_pos; /* The first one of them not shaped yet */
+
+   Evas_Object_Textblock_Paragraph **par_index; /* The index to fill */
+   int par_index_step, par_index_count, par_index_pos;
 
    int x, y;
    int w, h;
+   int stop_y;
    int wmax, hmax;
    int ascent, descent;
    int maxascent, maxdescent;
@@ -2462,7 +2493,7 @@ struct _Ctxt
    double align, valign;
    Textblock_Position position;
    Eina_Bool align_auto : 1;
-   Eina_Bool width_changed : 1;
+   Eina_Bool have_ellipsis : 1; /* The object's, copied for the layout thread */
 };
 
 static void _layout_text_add_logical_item(Ctxt *c, Evas_Object_Textblock_Text_Item *ti, Eina_List *rel);
@@ -2543,7 +2574,9 @@ _layout_item_max_ascent_descent_calc(const Evas_Object *eo_obj,
 
         if (fi)
           {
+             evas_common_font_cache_lock();
              asc = evas_common_font_instance_max_ascent_get(fi);
+             evas_common_font_cache_unlock();
           }
         else
           {
@@ -2565,7 +2598,9 @@ _layout_item_max_ascent_descent_calc(const Evas_Object *eo_obj,
 
         if (fi)
           {
+             evas_common_font_cache_lock();
              desc = evas_common_font_instance_max_descent_get(fi);
+             evas_common_font_cache_unlock();
           }
         else
           {
@@ -2615,8 +2650,10 @@ _layout_item_ascent_descent_adjust(const Evas_Object *eo_obj,
 
    if (fi)
      {
+        evas_common_font_cache_lock();
         asc = evas_common_font_instance_ascent_get(fi);
         desc = evas_common_font_instance_descent_get(fi);
+        evas_common_font_cache_unlock();
      }
    else
      {
@@ -2829,6 +2866,9 @@ _paragraph_free(const Evas_Object *eo_obj, Evas_Object_Textblock_Paragraph *par)
    if (par->text_node && (par->text_node->par == par))
       par->text_node->par = NULL;
 
+   if (o->par_deferred == par)
+      o->par_deferred = NULL;
+
    o->num_paragraphs--;
 
    free(par);
@@ -2951,9 +2991,13 @@ _layout_format_pop(Ctxt *c, const char *format)
              /* Remove only the matching format. */
              EINA_LIST_FOREACH_SAFE(c->format_stack, i, i_next, fmt)
                {
-                  /* Stop when we reach the base item */
+                  /* Stop when we reach the base item, what this pop does
+                   * then depends on all of the stack. */
                   if (!i_next)
-                     break;
+                    {
+                       c->format_stack_min = 0;
+                       break;
+                    }
 
                   c->format_stack =
                      eina_list_remove_list(c->format_stack, c->format_stack);
@@ -2976,6 +3020,10 @@ _layout_format_pop(Ctxt *c, const char *format)
                }
           }
 
+        /* Remember how deep we popped, see _layout_pre() */
+        if (eina_list_count(c->format_stack) < c->format_stack_min)
+          c->format_stack_min = eina_list_count(c->format_stack);
+
         /* Redo all the nodes needed to be redone */
           {
              Evas_Object_Textblock_Node_Format *fnode;
@@ -2997,6 +3045,11 @@ _layout_format_pop(Ctxt *c, const char *format)
 
         fmt = eina_list_data_get(c->format_stack);
      }
+   else
+     {
+        /* Nothing to pop, which depends on all of the stack as well. */
+        c->format_stack_min = 0;
+     }
    return fmt;
 }
 
@@ -3408,6 +3461,8 @@ loop_advance:
      {
         Evas_Coord new_wmax = c->ln->w +
            c->marginl + c->marginr - (c->o->style_pad.l + c->o->style_pad.r);
+        if (new_wmax > c->par->last_fw)
+           c->par->last_fw = new_wmax;
         if (new_wmax > c->wmax)
            c->wmax = new_wmax;
      }
@@ -3506,8 +3561,10 @@ _layout_item_text_split_strip_white(Ctxt *c,
         new_ti->parent.text_pos = ti->parent.text_pos + cut;
         new_ti->parent.merge = EINA_TRUE;
 
+        evas_common_font_cache_lock();
         evas_common_text_props_split(&ti->text_props,
                                      &new_ti->text_props, cut);
+        evas_common_font_cache_unlock();
         _layout_text_add_logical_item(c, new_ti, lti);
      }
 
@@ -3523,8 +3580,10 @@ _layout_item_text_split_strip_white(Ctxt *c,
              white_ti->parent.merge = EINA_TRUE;
              white_ti->parent.visually_deleted = EINA_TRUE;
 
+             evas_common_font_cache_lock();
              evas_common_text_props_split(&ti->text_props,
                    &white_ti->text_props, white_cut);
+             evas_common_font_cache_unlock();
              _layout_text_add_logical_item(c, white_ti, lti);
           }
         else
@@ -3686,9 +3745,11 @@ _layout_text_add_logical_item(Ctxt *c, Evas_Object_Textblock_Text_Item *ti,
 
 static void
 _layout_text_append_add_logical_item(Ctxt *c, Evas_Object_Textblock_Text_Item *ti,
-      Eina_List *rel)
+      Eina_List *rel, Eina_Bool shaped)
 {
-   _text_item_update_sizes(c, ti);
+   /* The sizes of the items left to shape are set once they are shaped */
+   if (shaped)
+     _text_item_update_sizes(c, ti);
 
    if (rel)
      {
@@ -3709,6 +3770,18 @@ typedef struct {
      int off;
 } Layout_Text_Append_Queue;
 
+/* A text item left to shape until its paragraph is broken into lines. The
+ * items split from the one before them because of a format change have no
+ * font instance, they get their part of its text props. */
+typedef struct {
+     Evas_Object_Textblock_Paragraph *par;
+     Evas_Object_Textblock_Text_Item *ti;
+     Evas_Font_Instance *fi;
+     const Eina_Unicode *str;
+     Evas_BiDi_Paragraph_Props *bidi_props;
+     int len;
+} Layout_Text_Shape;
+
 /**
  * @internal
  * Appends the text from node n starting at start ending at off to the layout.
@@ -3791,7 +3864,7 @@ skip:
         ti = _layout_text_item_new(c, queue->format);
         ti->parent.text_node = NULL;
         ti->parent.text_pos = 0;
-        _layout_text_append_add_logical_item(c, ti, rel);
+        _layout_text_append_add_logical_item(c, ti, rel, EINA_TRUE);
 
         return;
      }
@@ -3818,6 +3891,7 @@ skip:
         while (script_len > 0)
           {
              Evas_Font_Instance *cur_fi = NULL;
+             Eina_Bool shaped = EINA_TRUE;
              size_t run_start;
              int run_len = script_len;
              ti = _layout_text_item_new(c, queue->format);
@@ -3835,7 +3909,26 @@ skip:
                    c->par->bidi_props, ti->parent.text_pos);
              evas_common_text_props_script_set(&ti->text_props, script);
 
-             if (cur_fi)
+             /* Leave the shaping for later if asked to, unless the string
+              * is the replacement one, which doesn't last. */
+             if (cur_fi && c->shapes && !urepch)
+               {
+                  Layout_Text_Shape sh;
+
+                  sh.par = c->par;
+                  sh.ti = ti;
+                  sh.fi = cur_fi;
+                  sh.str = str;
+                  sh.bidi_props = NULL;
+#ifdef BIDI_SUPPORT
+                  if (c->par->bidi_props)
+                    sh.bidi_props = evas_bidi_paragraph_props_ref(c->par->bidi_props);
+#endif
+                  sh.len = run_len;
+                  eina_inarray_push(c->shapes, &sh);
+                  shaped = EINA_FALSE;
+               }
+             else if (cur_fi)
                {
                   ENFN->font_text_props_info_create(ENDT,
                         cur_fi, str, &ti->text_props, c->par->bidi_props,
@@ -3854,19 +3947,37 @@ skip:
                   new_ti->parent.text_node = ti->parent.text_node;
                   new_ti->parent.text_pos = queue->start;
 
-                  evas_common_text_props_split(&ti->text_props, &new_ti->text_props,
-                        new_ti->parent.text_pos - ti->parent.text_pos);
+                  if (shaped)
+                    {
+                       evas_common_font_cache_lock();
+                       evas_common_text_props_split(&ti->text_props,
+                             &new_ti->text_props,
+                             new_ti->parent.text_pos - ti->parent.text_pos);
+                       evas_common_font_cache_unlock();
+                    }
+                  else
+                    {
+                       Layout_Text_Shape sh;
+
+                       sh.par = c->par;
+                       sh.ti = new_ti;
+                       sh.fi = NULL;
+                       sh.str = NULL;
+                       sh.bidi_props = NULL;
+                       sh.len = 0;
+                       eina_inarray_push(c->shapes, &sh);
+                    }
 
                   if (ti)
                     {
-                       _layout_text_append_add_logical_item(c, ti, rel);
+                       _layout_text_append_add_logical_item(c, ti, rel, shaped);
                        ti = new_ti;
                     }
                }
 
              if (ti)
                {
-                  _layout_text_append_add_logical_item(c, ti, rel);
+                  _layout_text_append_add_logical_item(c, ti, rel, shaped);
                }
 
              str += run_len;
@@ -4498,19 +4609,26 @@ _layout_par(Ctxt *c)
 
    if (c->par->text_node)
      {
-        /* Skip this paragraph if width is the same, there is no ellipsis
-         * and we aren't just calculating. */
+        /* Skip this paragraph if it was already laid out for this width,
+         * there is no ellipsis and we aren't just calculating. */
         if (!c->par->text_node->is_new && !c->par->text_node->dirty &&
-              !c->width_changed && c->par->lines &&
-              !c->o->have_ellipsis)
+              (c->par->last_w == c->w) && c->par->lines &&
+              !c->have_ellipsis)
           {
              Evas_Object_Textblock_Line *ln;
-             /* Update c->line_no */
+             /* Update c->line_no, the last line may be an empty one that
+              * was never finalized and doesn't count. */
              ln = (Evas_Object_Textblock_Line *)
                 EINA_INLIST_GET(c->par->lines)->last;
+             while (ln && (ln->line_no < 0))
+                ln = (Evas_Object_Textblock_Line *)
+                   EINA_INLIST_GET(ln)->prev;
              if (ln)
                 c->line_no = c->par->line_no + ln->line_no + 1;
 
+             if (c->par->last_fw > c->wmax)
+                c->wmax = c->par->last_fw;
+
              /* After this par we are no longer at the beginning, as there
               * must be some text in the par. */
              if (c->position == TEXTBLOCK_POSITION_START)
@@ -4521,6 +4639,8 @@ _layout_par(Ctxt *c)
         c->par->text_node->dirty = EINA_FALSE;
         c->par->text_node->is_new = EINA_FALSE;
         c->par->rendered = EINA_FALSE;
+        c->par->last_w = c->w;
+        c->par->last_fw = 0;
 
         /* Merge back and clear the paragraph */
           {
@@ -4978,12 +5098,17 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
    if (o->content_changed)
      {
         Evas_Object_Textblock_Node_Text *n;
+        /* Whether the format stack may differ from the previous layout
+         * from here on, the recorded pads are then stale. */
+        Eina_Bool stack_changed = EINA_FALSE;
         c->o->have_ellipsis = 0;
         c->par = c->paragraphs = o->paragraphs;
         /* Go through all the text nodes to create the logical layout */
         EINA_INLIST_FOREACH(c->o->text_nodes, n)
           {
              Evas_Object_Textblock_Node_Format *fnode;
+             Eina_Bool was_neutral = EINA_TRUE;
+             unsigned int depth;
              size_t start;
              int off;
 
@@ -4998,6 +5123,8 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
                           (Evas_Object_Textblock_Paragraph *)
                           EINA_INLIST_GET(c->par)->next;
 
+                       if (!c->par->format_neutral)
+                         stack_changed = EINA_TRUE;
                        c->paragraphs = (Evas_Object_Textblock_Paragraph *)
                           eina_inlist_remove(EINA_INLIST_GET(c->paragraphs),
                                 EINA_INLIST_GET(c->par));
@@ -5012,6 +5139,7 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
                     {
                        Evas_Object_Textblock_Paragraph *prev_par = c->par;
 
+                       was_neutral = prev_par->format_neutral;
                        _layout_paragraph_new(c, n, EINA_TRUE);
 
                        c->paragraphs = (Evas_Object_Textblock_Paragraph *)
@@ -5021,9 +5149,30 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
                     }
                   else
                     {
+                       Evas_Object_Textblock_Paragraph *par = c->par;
+
                        c->par = (Evas_Object_Textblock_Paragraph *)
                           EINA_INLIST_GET(c->par)->next;
 
+                       /* If the formats of the node were found to leave
+                        * the format stack as it was, there's no need to
+                        * go through them again, only their pads count.
+                        * Their pads depend on the formats they inherit
+                        * though, so not if those may have changed. */
+                       if (par->format_neutral && !stack_changed)
+                         {
+                            if (par->style_pad.l > *style_pad_l) *style_pad_l = par->style_pad.l;
+                            if (par->style_pad.r > *style_pad_r) *style_pad_r = par->style_pad.r;
+                            if (par->style_pad.t > *style_pad_t) *style_pad_t = par->style_pad.t;
+                            if (par->style_pad.b > *style_pad_b) *style_pad_b = par->style_pad.b;
+                            continue;
+                         }
+
+                       depth = eina_list_count(c->format_stack);
+                       c->format_stack_min = depth;
+                       par->style_pad.l = par->style_pad.r = 0;
+                       par->style_pad.t = par->style_pad.b = 0;
+
                        /* Update the format stack according to the node's
                         * formats */
                        fnode = n->format_node;
@@ -5040,12 +5189,22 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
                                  fnode->pad.t = pt;
                                  fnode->pad.b = pb;
                               }
-                            if (fnode->pad.l > *style_pad_l) *style_pad_l = fnode->pad.l;
-                            if (fnode->pad.r > *style_pad_r) *style_pad_r = fnode->pad.r;
-                            if (fnode->pad.t > *style_pad_t) *style_pad_t = fnode->pad.t;
-                            if (fnode->pad.b > *style_pad_b) *style_pad_b = fnode->pad.b;
+                            if (fnode->pad.l > par->style_pad.l) par->style_pad.l = fnode->pad.l;
+                            if (fnode->pad.r > par->style_pad.r) par->style_pad.r = fnode->pad.r;
+                            if (fnode->pad.t > par->style_pad.t) par->style_pad.t = fnode->pad.t;
+                            if (fnode->pad.b > par->style_pad.b) par->style_pad.b = fnode->pad.b;
                             fnode = _NODE_FORMAT(EINA_INLIST_GET(fnode)->next);
                          }
+                       if (par->style_pad.l > *style_pad_l) *style_pad_l = par->style_pad.l;
+                       if (par->style_pad.r > *style_pad_r) *style_pad_r = par->style_pad.r;
+                       if (par->style_pad.t > *style_pad_t) *style_pad_t = par->style_pad.t;
+                       if (par->style_pad.b > *style_pad_b) *style_pad_b = par->style_pad.b;
+
+                       /* Nothing below the stack it found was touched and
+                        * what the node pushed it popped as well. */
+                       par->format_neutral =
+                          (c->format_stack_min >= depth) &&
+                          (eina_list_count(c->format_stack) == depth);
                        continue;
                     }
                }
@@ -5066,6 +5225,10 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
               * Skip the unicode replacement chars when there are because
               * we don't want to print them. */
              Layout_Text_Append_Queue *queue = NULL;
+             depth = eina_list_count(c->format_stack);
+             c->format_stack_min = depth;
+             c->par->style_pad.l = c->par->style_pad.r = 0;
+             c->par->style_pad.t = c->par->style_pad.b = 0;
              fnode = n->format_node;
              start = off = 0;
              while (fnode && (fnode->text_node == n))
@@ -5077,8 +5240,9 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
                   off += fnode->offset;
                   /* No need to skip on the first run, or a non-visible one */
                   queue = _layout_text_append_queue_item_append(queue, c->fmt, start, off);
-                  fi = _layout_do_format(eo_obj, c, &c->fmt, fnode, style_pad_l,
-                        style_pad_r, style_pad_t, style_pad_b, EINA_TRUE);
+                  fi = _layout_do_format(eo_obj, c, &c->fmt, fnode,
+                        &c->par->style_pad.l, &c->par->style_pad.r,
+                        &c->par->style_pad.t, &c->par->style_pad.b, EINA_TRUE);
 
                   if (fi || _layout_split_text_because_format(pfmt, c->fmt))
                     {
@@ -5095,8 +5259,8 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
 
                   if ((c->have_underline2) || (c->have_underline))
                     {
-                       if (*style_pad_b < c->underline_extend)
-                         *style_pad_b = c->underline_extend;
+                       if (c->par->style_pad.b < c->underline_extend)
+                         c->par->style_pad.b = c->underline_extend;
                        c->have_underline = 0;
                        c->have_underline2 = 0;
                        c->underline_extend = 0;
@@ -5117,6 +5281,20 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
              queue = _layout_text_append_queue_item_append(queue, c->fmt, start,
                    eina_ustrbuf_length_get(n->unicode) - start);
              _layout_text_append_commit(c, &queue, n, NULL);
+
+             if (c->par->style_pad.l > *style_pad_l) *style_pad_l = c->par->style_pad.l;
+             if (c->par->style_pad.r > *style_pad_r) *style_pad_r = c->par->style_pad.r;
+             if (c->par->style_pad.t > *style_pad_t) *style_pad_t = c->par->style_pad.t;
+             if (c->par->style_pad.b > *style_pad_b) *style_pad_b = c->par->style_pad.b;
+
+             /* The paragraphs after a new or changed one inherit other
+              * formats unless it leaves the stack as it found it, like
+              * the paragraph it replaces did. */
+             c->par->format_neutral =
+                (c->format_stack_min >= depth) &&
+                (eina_list_count(c->format_stack) == depth);
+             if (!was_neutral || !c->par->format_neutral)
+               stack_changed = EINA_TRUE;
 #ifdef BIDI_SUPPORT
              /* Clear the bidi props because we don't need them anymore. */
              if (c->par->bidi_props)
@@ -5157,34 +5335,33 @@ _layout_pre(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
 
 /**
  * @internal
- * Create the layout from the nodes.
+ * Setup the context of a layout and the default format.
  *
+ * @param c the context to setup - NOT NULL.
  * @param obj the evas object - NOT NULL.
- * @param calc_only true if should only calc sizes false if should also create the layout.. It assumes native size is being calculated, doesn't support formatted size atm.
+ * @param o the textblock data of the object - NOT NULL.
  * @param w the object's w, -1 means no wrapping (i.e infinite size)
  * @param h the object's h, -1 means inifinte size.
- * @param w_ret the object's calculated w.
- * @param h_ret the object's calculated h.
+ * @param stop_y the y below which the paragraphs are left out, -1 to layout
+ * them all.
+ * @return EINA_FALSE if there's no default format, so nothing to layout.
  */
-static void
-_layout(const Evas_Object *eo_obj, int w, int h, int *w_ret, int *h_ret)
+static Eina_Bool
+_layout_setup(Ctxt *c, const Evas_Object *eo_obj, Evas_Textblock_Data *o,
+      int w, int h, int stop_y)
 {
-   Evas_Object_Protected_Data *obj = eo_data_scope_get(eo_obj, EVAS_OBJ_CLASS);
-   Evas_Textblock_Data *o = eo_data_ref(eo_obj, MY_CLASS);
-   Ctxt ctxt, *c;
-   int style_pad_l = 0, style_pad_r = 0, style_pad_t = 0, style_pad_b = 0;
-
-   LYDBG("ZZ: layout %p %4ix%4i | w=%4i | last_w=%4i --- '%s'\n", eo_obj, w, h, obj->cur->geometry.w, o->last_w, o->markup_text);
-   /* setup context */
-   c = &ctxt;
    c->obj = (Evas_Object *)eo_obj;
    c->o = o;
    c->paragraphs = c->par = NULL;
    c->format_stack = NULL;
+   c->format_stack_min = 0;
    c->fmt = NULL;
+   c->shapes = NULL;
+   c->shape_pos = 0;
    c->x = c->y = 0;
    c->w = w;
    c->h = h;
+   c->stop_y = stop_y;
    c->wmax = c->hmax = 0;
    c->ascent = c->descent = 0;
    c->maxascent = c->maxdescent = 0;
@@ -5196,9 +5373,8 @@ _layout(const Evas_Object *eo_obj, int w, int h, int *w_ret, int *h_ret)
    c->align = 0.0;
    c->align_auto = EINA_TRUE;
    c->ln = NULL;
-   c->width_changed = (obj->cur->geometry.w != o->last_w);
+   o->par_deferred = NULL;
 
-   /* Start of logical layout creation */
    /* setup default base style */
      {
         Eina_Bool finalize = EINA_FALSE;
@@ -5222,14 +5398,23 @@ _layout(const Evas_Object *eo_obj, int w, int h, int *w_ret, int *h_ret)
         if (finalize)
            _format_finalize(c->obj, c->fmt);
      }
-   if (!c->fmt)
-     {
-        if (w_ret) *w_ret = 0;
-        if (h_ret) *h_ret = 0;
-        return;
-     }
 
-   _layout_pre(c, &style_pad_l, &style_pad_r, &style_pad_t, &style_pad_b);
+   return !!c->fmt;
+}
+
+/**
+ * @internal
+ * Create the logical layout, i.e the paragraphs and their items.
+ *
+ * @param c the context - NOT NULL.
+ */
+static void
+_layout_logical(Ctxt *c, int *style_pad_l, int *style_pad_r, int *style_pad_t,
+      int *style_pad_b)
+{
+   Evas_Textblock_Data *o = c->o;
+
+   _layout_pre(c, style_pad_l, style_pad_r, style_pad_t, style_pad_b);
    c->paragraphs = o->paragraphs;
 
    /* If there are no paragraphs, create the minimum needed,
@@ -5249,66 +5434,176 @@ _layout(const Evas_Object *eo_obj, int w, int h, int *w_ret, int *h_ret)
         ti->parent.text_pos = 0;
         _layout_text_add_logical_item(c, ti, NULL);
      }
+}
 
-   /* End of logical layout creation */
+/**
+ * @internal
+ * Shape the text items of the paragraph par that were left to shape, or all
+ * of the remaining ones if par is NULL, and set their sizes.
+ *
+ * @param c the context - NOT NULL.
+ * @param par the paragraph, NULL for all.
+ */
+static void
+_layout_par_shape(Ctxt *c, const Evas_Object_Textblock_Paragraph *par)
+{
+   Evas_Object_Protected_Data *obj;
+   Layout_Text_Shape *sh;
+   unsigned int i, first = c->shape_pos;
 
-   /* Start of visual layout creation */
-   {
-      Evas_Object_Textblock_Paragraph *last_vis_par = NULL;
-      int par_index_step = o->num_paragraphs / TEXTBLOCK_PAR_INDEX_SIZE;
-      int par_count = 1; /* Force it to take the first one */
-      int par_index_pos = 0;
+   if (!c->shapes) return;
 
-      c->position = TEXTBLOCK_POSITION_START;
+   obj = eo_data_scope_get(c->obj, EVAS_OBJ_CLASS);
+   for ( ; c->shape_pos < eina_inarray_count(c->shapes); c->shape_pos++)
+     {
+        sh = eina_inarray_nth(c->shapes, c->shape_pos);
+        if (par && (sh->par != par)) break;
 
-      if (par_index_step == 0) par_index_step = 1;
+        if (sh->fi)
+          {
+             ENFN->font_text_props_info_create(ENDT,
+                   sh->fi, sh->str, &sh->ti->text_props, sh->bidi_props,
+                   sh->ti->parent.text_pos, sh->len, EVAS_TEXT_PROPS_MODE_SHAPE);
+          }
+        else
+          {
+             Layout_Text_Shape *prev = sh - 1;
 
-      /* Clear all of the index */
-      memset(o->par_index, 0, sizeof(o->par_index));
+             evas_common_font_cache_lock();
+             evas_common_text_props_split(&prev->ti->text_props,
+                   &sh->ti->text_props,
+                   sh->ti->parent.text_pos - prev->ti->parent.text_pos);
+             evas_common_font_cache_unlock();
+          }
+     }
+   /* The text props of an item are only final once the items after it
+    * were split from it. */
+   for (i = first; i < c->shape_pos; i++)
+     {
+        sh = eina_inarray_nth(c->shapes, i);
+        _text_item_update_sizes(c, sh->ti);
+     }
+}
 
-      EINA_INLIST_FOREACH(c->paragraphs, c->par)
-        {
-           _layout_update_par(c);
+/**
+ * @internal
+ * Break the paragraphs from par on into lines, down to the stop y of the
+ * context, and add them to its index.
+ *
+ * @param c the context - NOT NULL.
+ * @param par the first paragraph to break - NOT NULL.
+ * @param resume EINA_TRUE if the position of par is known already, i.e if
+ * it's the one the layout left out before.
+ * @return the first paragraph left out, if any.
+ */
+static Evas_Object_Textblock_Paragraph *
+_layout_visual_pars(Ctxt *c, Evas_Object_Textblock_Paragraph *par,
+      Eina_Bool resume)
+{
+   Evas_Object_Textblock_Paragraph *last_vis_par = NULL, *deferred = NULL;
 
-           /* Break if we should stop here. */
-           if (_layout_par(c))
-             {
-                last_vis_par = c->par;
-                break;
-             }
+   for (c->par = par; c->par; c->par = (Evas_Object_Textblock_Paragraph *)
+        EINA_INLIST_GET(c->par)->next)
+     {
+        if (!resume || (c->par != par))
+          _layout_update_par(c);
 
-           if ((par_index_pos < TEXTBLOCK_PAR_INDEX_SIZE) && (--par_count == 0))
-             {
-                par_count = par_index_step;
+        /* Leave the rest for later, their lines and positions are
+         * updated by the next layout that doesn't stop. */
+        if ((c->stop_y >= 0) && (c->par->y > c->stop_y))
+          {
+             deferred = c->par;
+             break;
+          }
 
-                o->par_index[par_index_pos++] = c->par;
-             }
-        }
+        _layout_par_shape(c, c->par);
+        /* Break if we should stop here. */
+        if (_layout_par(c))
+          {
+             last_vis_par = c->par;
+             break;
+          }
 
-      /* Mark all the rest of the paragraphs as invisible */
-      if (c->par)
-        {
-           c->par = (Evas_Object_Textblock_Paragraph *)
-              EINA_INLIST_GET(c->par)->next;
-           while (c->par)
-             {
-                c->par->visible = 0;
-                c->par = (Evas_Object_Textblock_Paragraph *)
-                   EINA_INLIST_GET(c->par)->next;
-             }
-        }
+        if ((c->par_index_pos < TEXTBLOCK_PAR_INDEX_SIZE) &&
+            (--c->par_index_count == 0))
+          {
+             c->par_index_count = c->par_index_step;
 
-      /* Get the last visible paragraph in the layout */
-      if (!last_vis_par && c->paragraphs)
-         last_vis_par = (Evas_Object_Textblock_Paragraph *)
-            EINA_INLIST_GET(c->paragraphs)->last;
+             c->par_index[c->par_index_pos++] = c->par;
+          }
+     }
 
-      if (last_vis_par)
-        {
-           c->hmax = last_vis_par->y + last_vis_par->h +
-              _layout_last_line_max_descent_adjust_calc(c, last_vis_par);
-        }
-   }
+   /* Mark all the rest of the paragraphs as invisible */
+   if (c->par && !deferred)
+     {
+        c->par = (Evas_Object_Textblock_Paragraph *)
+           EINA_INLIST_GET(c->par)->next;
+        while (c->par)
+          {
+             c->par->visible = 0;
+             c->par = (Evas_Object_Textblock_Paragraph *)
+                EINA_INLIST_GET(c->par)->next;
+          }
+     }
+
+   /* Get the last visible paragraph in the layout */
+   if (deferred)
+      last_vis_par = (Evas_Object_Textblock_Paragraph *)
+         EINA_INLIST_GET(deferred)->prev;
+   else if (!last_vis_par && c->paragraphs)
+      last_vis_par = (Evas_Object_Textblock_Paragraph *)
+         EINA_INLIST_GET(c->paragraphs)->last;
+
+   if (last_vis_par)
+     {
+        c->hmax = last_vis_par->y + last_vis_par->h +
+           _layout_last_line_max_descent_adjust_calc(c, last_vis_par);
+     }
+
+   return deferred;
+}
+
+/**
+ * @internal
+ * Create the visual layout, i.e break the paragraphs into lines.
+ *
+ * @param c the context - NOT NULL.
+ */
+static void
+_layout_visual(Ctxt *c)
+{
+   Evas_Textblock_Data *o = c->o;
+
+   c->position = TEXTBLOCK_POSITION_START;
+   c->have_ellipsis = o->have_ellipsis;
+
+   c->par_index = o->par_index;
+   c->par_index_step = o->num_paragraphs / TEXTBLOCK_PAR_INDEX_SIZE;
+   if (c->par_index_step == 0) c->par_index_step = 1;
+   c->par_index_count = 1; /* Force it to take the first one */
+   c->par_index_pos = 0;
+
+   /* Clear all of the index */
+   memset(o->par_index, 0, sizeof(o->par_index));
+
+   o->par_deferred = _layout_visual_pars(c, c->paragraphs, EINA_FALSE);
+}
+
+/**
+ * @internal
+ * Finish a layout: free the context and align the paragraphs.
+ *
+ * @param c the context - NOT NULL.
+ * @param w_ret the object's calculated w.
+ * @param h_ret the object's calculated h.
+ * @return EINA_TRUE if the style pads changed, in which case the lines were
+ * cleared and the layout has to be done again.
+ */
+static Eina_Bool
+_layout_done(Ctxt *c, int style_pad_l, int style_pad_r, int style_pad_t,
+      int style_pad_b, int *w_ret, int *h_ret)
+{
+   Evas_Textblock_Data *o = c->o;
 
    /* Clean the rest of the format stack */
    while (c->format_stack)
@@ -5339,43 +5634,457 @@ _layout(const Evas_Object *eo_obj, int w, int h, int *w_ret, int *h_ret)
         o->style_pad.r = style_pad_r;
         o->style_pad.t = style_pad_t;
         o->style_pad.b = style_pad_b;
-        _paragraphs_clear(eo_obj, c->paragraphs);
-        LYDBG("ZZ: ... layout #2\n");
-        _layout(eo_obj, w, h, w_ret, h_ret);
+        _paragraphs_clear(c->obj, c->paragraphs);
+        return EINA_TRUE;
      }
+
+   return EINA_FALSE;
 }
 
-/*
+/**
  * @internal
- * Relayout the object according to current object size.
+ * Create the layout from the nodes.
  *
  * @param obj the evas object - NOT NULL.
+ * @param w the object's w, -1 means no wrapping (i.e infinite size)
+ * @param h the object's h, -1 means inifinte size.
+ * @param stop_y the y below which the paragraphs are left out, -1 to layout
+ * them all.
+ * @param w_ret the object's calculated w.
+ * @param h_ret the object's calculated h.
  */
 static void
-_relayout(const Evas_Object *eo_obj)
+_layout(const Evas_Object *eo_obj, int w, int h, int stop_y,
+      int *w_ret, int *h_ret)
+{
+   Evas_Textblock_Data *o = eo_data_ref(eo_obj, MY_CLASS);
+   Ctxt ctxt, *c;
+   int style_pad_l = 0, style_pad_r = 0, style_pad_t = 0, style_pad_b = 0;
+
+   LYDBG("ZZ: layout %p %4ix%4i | stop=%4i | last_w=%4i --- '%s'\n", eo_obj, w, h, stop_y, o->last_w, o->markup_text);
+   /* setup context */
+   c = &ctxt;
+   if (!_layout_setup(c, eo_obj, o, w, h, stop_y))
+     {
+        if (w_ret) *w_ret = 0;
+        if (h_ret) *h_ret = 0;
+        return;
+     }
+
+   _layout_logical(c, &style_pad_l, &style_pad_r, &style_pad_t, &style_pad_b);
+   _layout_visual(c);
+
+   if (_layout_done(c, style_pad_l, style_pad_r, style_pad_t, style_pad_b,
+            w_ret, h_ret))
+     {
+        LYDBG("ZZ: ... layout #2\n");
+        _layout(eo_obj, w, h, stop_y, w_ret, h_ret);
+     }
+}
+
+/*
+ * @internal
+ * Update the object after a layout of it at lw x lh that gave w x h.
+ */
+static void
+_relayout_done(const Evas_Object *eo_obj, Evas_Coord lw, Evas_Coord lh,
+      int w, int h)
 {
-   Evas_Object_Protected_Data *obj = eo_data_scope_get(eo_obj, EVAS_OBJ_CLASS);
    Evas_Textblock_Data *o = eo_data_scope_get(eo_obj, MY_CLASS);
-   _layout(eo_obj, obj->cur->geometry.w, obj->cur->geometry.h,
-         &o->formatted.w, &o->formatted.h);
+
+   o->last_w = lw;
+   o->last_h = lh;
+   o->changed = 0;
+   o->content_changed = 0;
+   o->format_changed = EINA_FALSE;
+   o->redraw = 1;
+   /* The formatted size is only known once all the paragraphs are laid
+    * out, the next one asking for it will layout the rest. */
+   if (o->par_deferred)
+     {
+        LYDBG("ZZ: --------- layout %p @ %ix%i stopped\n", eo_obj, lw, lh);
+        o->formatted.valid = 0;
+        o->formatted.oneline_h = 0;
+        return;
+     }
+
+   o->formatted.w = w;
+   o->formatted.h = h;
    o->formatted.valid = 1;
    o->formatted.oneline_h = 0;
-   o->last_w = obj->cur->geometry.w;
-   LYDBG("ZZ: --------- layout %p @ %ix%i = %ix%i\n", eo_obj, obj->cur->geometry.w, obj->cur->geometry.h, o->formatted.w, o->formatted.h);
-   o->last_h = obj->cur->geometry.h;
+   LYDBG("ZZ: --------- layout %p @ %ix%i = %ix%i\n", eo_obj, lw, lh, o->formatted.w, o->formatted.h);
    if ((o->paragraphs) && (!EINA_INLIST_GET(o->paragraphs)->next) &&
        (o->paragraphs->lines) && (!EINA_INLIST_GET(o->paragraphs->lines)->next))
      {
-        if (obj->cur->geometry.h < o->formatted.h)
+        if (lh < o->formatted.h)
           {
              LYDBG("ZZ: 1 line only... lasth == formatted h (%i)\n", o->formatted.h);
              o->formatted.oneline_h = o->formatted.h;
           }
      }
-   o->changed = 0;
-   o->content_changed = 0;
-   o->format_changed = EINA_FALSE;
-   o->redraw = 1;
+}
+
+/*
+ * @internal
+ * Relayout the object according to current object size.
+ *
+ * @param obj the evas object - NOT NULL.
+ * @param stop_y the y below which the paragraphs are left out, -1 to layout
+ * them all.
+ */
+static void
+_relayout_stop(const Evas_Object *eo_obj, int stop_y)
+{
+   Evas_Object_Protected_Data *obj = eo_data_scope_get(eo_obj, EVAS_OBJ_CLASS);
+   Evas_Textblock_Data *o = eo_data_scope_get(eo_obj, MY_CLASS);
+   int w, h;
+
+   _layout_async_wait(o);
+   _layout(eo_obj, obj->cur->geometry.w, obj->cur->geometry.h, stop_y,
+         &w, &h);
+   _relayout_done(eo_obj, obj->cur->geometry.w, obj->cur->geometry.h, w, h);
+}
+
+static void
+_relayout(const Evas_Object *eo_obj)
+{
+   _relayout_stop(eo_obj, -1);
+}
+
+typedef enum
+{
+   TEXTBLOCK_LAYOUT_JOB_QUEUED,
+   TEXTBLOCK_LAYOUT_JOB_RUNNING,
+   TEXTBLOCK_LAYOUT_JOB_DONE
+} Textblock_Layout_Job_State;
+
+/* A layout of which the paragraphs below the visible part of the object are
+ * laid out in a thread. The text of these is shaped there as well, the font
+ * cache is locked by the engine font functions and around the calls to the
+ * font code the layout makes directly. The main loop draws the paragraphs
+ * laid out before the job was started meanwhile, and waits for the job
+ * before anything else touches the layout or the text. */
+struct _Evas_Object_Textblock_Layout_Job
+{
+   Ctxt                        ctxt;
+   Eina_Inarray                shapes;
+   Evas_Object_Textblock_Paragraph *par; /* The first paragraph to lay out */
+   Evas_Object_Textblock_Paragraph *par_index[TEXTBLOCK_PAR_INDEX_SIZE];
+   Evas_Object                *obj; /* Weak reference, NULL once it's gone */
+   LK(lock);
+   Eina_Condition              cond;
+   struct {
+      int                      l, r, t, b;
+   } style_pad;
+   Textblock_Layout_Job_State  state;
+};
+
+/*
+ * @internal
+ * Run the layout job unless it was already taken by the thread or the main
+ * loop. Returns EINA_FALSE if it was.
+ */
+static Eina_Bool
+_layout_job_take(Evas_Object_Textblock_Layout_Job *job)
+{
+   Eina_Bool queued;
+
+   LKL(job->lock);
+   queued = (job->state == TEXTBLOCK_LAYOUT_JOB_QUEUED);
+   if (queued) job->state = TEXTBLOCK_LAYOUT_JOB_RUNNING;
+   LKU(job->lock);
+   if (!queued) return EINA_FALSE;
+
+   _layout_visual_pars(&job->ctxt, job->par, EINA_TRUE);
+
+   LKL(job->lock);
+   job->state = TEXTBLOCK_LAYOUT_JOB_DONE;
+   eina_condition_broadcast(&job->cond);
+   LKU(job->lock);
+   return EINA_TRUE;
+}
+
+/*
+ * @internal
+ * Update the object with the layout done by the job, which is detached from
+ * it.
+ */
+static void
+_layout_job_finish(Evas_Textblock_Data *o,
+      Evas_Object_Textblock_Layout_Job *job)
+{
+   Ctxt *c = &job->ctxt;
+   Layout_Text_Shape *sh;
+   int w, h;
+
+   o->layout_job = NULL;
+   /* In case a paragraph with text left to shape was skipped */
+   _layout_par_shape(c, NULL);
+   if (c->par_index != o->par_index)
+     memcpy(o->par_index, job->par_index, sizeof(o->par_index));
+   o->par_deferred = NULL;
+
+   EINA_INARRAY_FOREACH(&job->shapes, sh)
+     {
+#ifdef BIDI_SUPPORT
+        if (sh->bidi_props)
+          evas_bidi_paragraph_props_unref(sh->bidi_props);
+#endif
+     }
+   eina_inarray_flush(&job->shapes);
+
+   /* The pads were already updated before the lines were laid out */
+   if (_layout_done(c, job->style_pad.l, job->style_pad.r, job->style_pad.t,
+            job->style_pad.b, &w, &h))
+     {
+        LYDBG("ZZ: ... async layout #2\n");
+        _relayout(c->obj);
+        return;
+     }
+
+   _relayout_done(c->obj, c->w, c->h, w, h);
+}
+
+static void
+_layout_job_free(Evas_Object_Textblock_Layout_Job *job)
+{
+   eina_inarray_flush(&job->shapes);
+   eo_weak_unref(&job->obj);
+   eina_condition_free(&job->cond);
+   LKD(job->lock);
+   free(job);
+}
+
+/*
+ * @internal
+ * Wait for the layout job of the object to be done and update the object
+ * with it. The job is run right away if the thread didn't take it yet.
+ */
+static void
+_layout_job_join(Evas_Textblock_Data *o, Evas_Object_Textblock_Layout_Job *job)
+{
+   if (!_layout_job_take(job))
+     {
+        LKL(job->lock);
+        while (job->state != TEXTBLOCK_LAYOUT_JOB_DONE)
+          eina_condition_wait(&job->cond);
+        LKU(job->lock);
+     }
+
+   _layout_job_finish(o, job);
+}
+
+/*
+ * @internal
+ * Wait for the layout of the object running in a thread, if any.
+ */
+static void
+_layout_async_wait(Evas_Textblock_Data *o)
+{
+   Evas_Object_Protected_Data *obj;
+   Evas_Object *eo_obj;
+
+   if (!o->layout_job) return;
+
+   eo_obj = o->layout_job->ctxt.obj;
+   _layout_job_join(o, o->layout_job);
+   /* Only the paragraphs laid out before were drawn */
+   obj = eo_data_scope_get(eo_obj, EVAS_OBJ_CLASS);
+   evas_object_change(eo_obj, obj);
+}
+
+static void
+_layout_job_heavy(void *data)
+{
+   _layout_job_take(data);
+}
+
+static void
+_layout_job_end(void *data)
+{
+   Evas_Object_Textblock_Layout_Job *job = data;
+   Evas_Object_Protected_Data *obj;
+   Evas_Textblock_Data *o;
+
+   if (!job->obj) goto end;
+
+   o = eo_data_scope_get(job->obj, MY_CLASS);
+   obj = eo_data_scope_get(job->obj, EVAS_OBJ_CLASS);
+   if (o->layout_job == job)
+     {
+        _layout_job_finish(o, job);
+        evas_object_change(job->obj, obj);
+     }
+
+   /* A newer layout tells when it's done */
+   if (!o->layout_job && !obj->delete_me)
+     eo_do(job->obj, eo_event_callback_call(EVAS_TEXTBLOCK_EVENT_LAYOUT_READY, NULL));
+
+end:
+   _layout_job_free(job);
+}
+
+static void
+_layout_job_cancel(void *data)
+{
+   Evas_Object_Textblock_Layout_Job *job = data;
+
+   if (job->obj)
+     {
+        Evas_Textblock_Data *o = eo_data_scope_get(job->obj, MY_CLASS);
+
+        if (o->layout_job == job)
+          _layout_job_join(o, job);
+     }
+   _layout_job_free(job);
+}
+
+/*
+ * @internal
+ * Get the part of the object that may get rendered, relative to the object.
+ * Returns EINA_FALSE if all of it may, e.g when it's mapped or the source
+ * of a proxy, or if it's not worth finding out.
+ */
+static Eina_Bool
+_layout_visible_get(Evas_Object_Protected_Data *obj,
+      const Evas_Textblock_Data *o, Evas_Coord *y, Evas_Coord *h)
+{
+   Evas_Object_Protected_Data *p;
+
+   if ((o->num_paragraphs < TEXTBLOCK_PAR_VISIBLE_MIN) ||
+       (o->valign != 0.0) || (o->have_ellipsis))
+     return EINA_FALSE;
+
+   /* Maps and proxies don't care about the clip of the object */
+   for (p = obj; p;
+        p = p->smart.parent ?
+        eo_data_scope_get(p->smart.parent, EVAS_OBJ_CLASS) : NULL)
+     {
+        if ((p->map->cur.usemap) || (p->proxy->proxies))
+          return EINA_FALSE;
+     }
+
+   if (obj->cur->cache.clip.dirty)
+     evas_object_clip_recalc(obj);
+
+   *y = obj->cur->cache.clip.y - obj->cur->geometry.y;
+   *h = obj->cur->cache.clip.h;
+   if (*y < 0)
+     {
+        *h += *y;
+        *y = 0;
+     }
+   if (*h < 0) *h = 0;
+
+   return EINA_TRUE;
+}
+
+/*
+ * @internal
+ * Relayout the object before rendering it. Only the paragraphs down to one
+ * screen below the visible part of the object are laid out, the others are
+ * left for later.
+ */
+static void
+_relayout_visible(const Evas_Object *eo_obj, Evas_Object_Protected_Data *obj,
+      const Evas_Textblock_Data *o)
+{
+   Evas_Coord y, h;
+
+   if (!_layout_visible_get(obj, o, &y, &h))
+     {
+        _relayout(eo_obj);
+        return;
+     }
+
+   /* 20 is the margin the rendering uses */
+   _relayout_stop(eo_obj, y + h + h + 20);
+}
+
+/*
+ * @internal
+ * Relayout the object for rendering, the paragraphs down to one screen below
+ * the visible part of the object right away and the others in a thread. The
+ * text of the paragraphs is only shaped when they are broken into lines. The
+ * object is updated and "layout,ready" is emitted on it from the main loop
+ * once the layout is done, even when it was done right away.
+ */
+static void
+_layout_async_start(const Evas_Object *eo_obj, Evas_Object_Protected_Data *obj,
+      Evas_Textblock_Data *o)
+{
+   Evas_Object_Textblock_Layout_Job *job;
+   Evas_Coord y, h;
+   Ctxt *c;
+
+   if (o->layout_job) _layout_job_join(o, o->layout_job);
+
+   job = calloc(1, sizeof(Evas_Object_Textblock_Layout_Job));
+   if (!job)
+     {
+        _relayout(eo_obj);
+        return;
+     }
+
+   eina_inarray_step_set(&job->shapes, sizeof(job->shapes),
+         sizeof(Layout_Text_Shape), 64);
+   LKI(job->lock);
+   eina_condition_new(&job->cond, &job->lock);
+   job->state = TEXTBLOCK_LAYOUT_JOB_DONE;
+   job->obj = (Evas_Object *)eo_obj;
+   eo_weak_ref(&job->obj);
+
+   LYDBG("ZZ: async layout %p %4ix%4i\n", eo_obj, obj->cur->geometry.w, obj->cur->geometry.h);
+   c = &job->ctxt;
+   if (!_layout_setup(c, eo_obj, o, obj->cur->geometry.w,
+            obj->cur->geometry.h, -1))
+     {
+        _relayout(eo_obj);
+        goto end;
+     }
+
+   c->shapes = &job->shapes;
+   _layout_logical(c, &job->style_pad.l, &job->style_pad.r,
+         &job->style_pad.t, &job->style_pad.b);
+   /* Set the pads before the lines are laid out with them, instead of
+    * laying them out again as _layout() does when the pads changed. */
+   if ((o->style_pad.l != job->style_pad.l) ||
+       (o->style_pad.r != job->style_pad.r) ||
+       (o->style_pad.t != job->style_pad.t) ||
+       (o->style_pad.b != job->style_pad.b))
+     {
+        o->style_pad.l = job->style_pad.l;
+        o->style_pad.r = job->style_pad.r;
+        o->style_pad.t = job->style_pad.t;
+        o->style_pad.b = job->style_pad.b;
+        _paragraphs_clear(c->obj, c->paragraphs);
+     }
+   /* The paragraphs are only known now, the layout stops below the visible
+    * part if it's worth it. 20 is the margin the rendering uses. */
+   if (_layout_visible_get(obj, o, &y, &h))
+     c->stop_y = y + h + h + 20;
+   _layout_visual(c);
+
+   o->layout_job = job;
+   if (!o->par_deferred)
+     {
+        _layout_job_finish(o, job);
+     }
+   else
+     {
+        /* The object is drawn with what's laid out so far */
+        job->par = o->par_deferred;
+        memcpy(job->par_index, o->par_index, sizeof(job->par_index));
+        c->par_index = job->par_index;
+        c->stop_y = -1;
+        job->state = TEXTBLOCK_LAYOUT_JOB_QUEUED;
+        _relayout_done(eo_obj, c->w, c->h, c->wmax, c->hmax);
+     }
+
+end:
+   /* The job may be done already, the thread then only tells it */
+   evas_preload_thread_run(_layout_job_heavy, _layout_job_end,
+         _layout_job_cancel, job);
 }
 
 /*
@@ -5387,6 +6096,7 @@ _relayout_if_needed(Evas_Object *eo_obj, const Evas_Textblock_Data *o)
 {
    Evas_Object_Protected_Data *obj = eo_data_scope_get(eo_obj, EVAS_OBJ_CLASS);
 
+   _layout_async_wait((Evas_Textblock_Data *)o);
    evas_object_textblock_coords_recalc(eo_obj, obj, obj->private_data);
    if (!o->formatted.valid)
      {
@@ -5836,6 +6546,21 @@ _evas_textblock_legacy_newline_get(Eo *eo_obj EINA_UNUSED, Evas_Textblock_Data *
    return o->legacy_newline;
 }
 
+EOLIAN static void
+_evas_textblock_async_layout_set(Eo *eo_obj EINA_UNUSED, Evas_Textblock_Data *o, Eina_Bool async)
+{
+   async = !!async;
+   if (o->async_layout == async) return;
+   if (!async) _layout_async_wait(o);
+   o->async_layout = async;
+}
+
+EOLIAN static Eina_Bool
+_evas_textblock_async_layout_get(Eo *eo_obj EINA_UNUSED, Evas_Textblock_Data *o)
+{
+   return o->async_layout;
+}
+
 EOLIAN static void
 _evas_textblock_valign_set(Eo *eo_obj, Evas_Textblock_Data *o, double align)
 {
@@ -6904,6 +7629,7 @@ _evas_textblock_node_format_remove_pair(Eo *eo_obj, Evas_Textblock_Data *o, Evas
    Eina_List *fstack = NULL;
 
    if (!n) return;
+   _layout_async_wait(o);
 
    fmt = n;
 
@@ -6978,6 +7704,8 @@ found:
      }
    tnode1 = n->text_node;
    _evas_textblock_node_format_remove(o, n, 0);
+   /* Its paragraph lost a format even when no closer was found */
+   tnode1->dirty = EINA_TRUE;
    if (found_node && (found_node != n))
      {
         Evas_Object_Textblock_Node_Text *tnode2;
@@ -8180,6 +8908,7 @@ _evas_textblock_changed(Evas_Textblock_Data *o, Evas_Object *eo_obj)
 {
    Evas_Object_Protected_Data *obj = eo_data_scope_get(eo_obj, EVAS_OBJ_CLASS);
    LYDBG("ZZ: invalidate 1 %p\n", eo_obj);
+   _layout_async_wait(o);
    o->formatted.valid = 0;
    o->native.valid = 0;
    o->content_changed = 1;
@@ -8197,6 +8926,7 @@ _evas_textblock_invalidate_all(Evas_Textblock_Data *o)
 {
    Evas_Object_Textblock_Node_Text *n;
 
+   _layout_async_wait(o);
    EINA_INLIST_FOREACH(o->text_nodes, n)
      {
         n->dirty = EINA_TRUE;
@@ -8214,6 +8944,7 @@ evas_textblock_cursor_text_append(Evas_Textblock_Cursor *cur, const char *_text)
    if (!cur) return 0;
    text = eina_unicode_utf8_to_unicode(_text, &len);
    Evas_Textblock_Data *o = eo_data_scope_get(cur->obj, MY_CLASS);
+   _layout_async_wait(o);
 
    n = cur->node;
    if (n)
@@ -8435,6 +9166,7 @@ evas_textblock_cursor_format_append(Evas_Textblock_Cursor *cur, const char *form
    if (!cur) return EINA_FALSE;
    if ((!format) || (format[0] == 0)) return EINA_FALSE;
    Evas_Textblock_Data *o = eo_data_scope_get(cur->obj, MY_CLASS);
+   _layout_async_wait(o);
    /* We should always have at least one text node */
    if (!o->text_nodes)
      {
@@ -8583,6 +9315,7 @@ evas_textblock_cursor_char_delete(Evas_Textblock_Cursor *cur)
 
    if (!cur || !cur->node) return;
    Evas_Textblock_Data *o = eo_data_scope_get(cur->obj, MY_CLASS);
+   _layout_async_wait(o);
    n = cur->node;
 
    text = eina_ustrbuf_string_get(n->unicode);
@@ -8660,6 +9393,7 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
    if (!cur2 || !cur2->node) return;
    if (cur1->obj != cur2->obj) return;
    Evas_Textblock_Data *o = eo_data_scope_get(cur1->obj, MY_CLASS);
+   _layout_async_wait(o);
    if (evas_textblock_cursor_compare(cur1, cur2) > 0)
      {
 	Evas_Textblock_Cursor *tc;
@@ -10224,6 +10958,7 @@ _evas_textblock_clear(Eo *eo_obj, Evas_Textblock_Data *o)
    Eina_List *l;
    Evas_Textblock_Cursor *cur;
 
+   _layout_async_wait(o);
    if (o->paragraphs)
      {
 	_paragraphs_free(eo_obj, o->paragraphs);
@@ -10533,6 +11268,7 @@ evas_object_textblock_free(Evas_Object *eo_obj)
 {
    Evas_Textblock_Data *o = eo_data_scope_get(eo_obj, MY_CLASS);
 
+   if (o->layout_job) _layout_job_join(o, o->layout_job);
    _evas_object_textblock_clear_all(eo_obj);
    evas_object_textblock_style_set(eo_obj, NULL);
    while (evas_object_textblock_style_user_peek(eo_obj))
@@ -10603,6 +11339,7 @@ evas_object_textblock_render(Evas_Object *eo_obj EINA_UNUSED,
 #define ITEM_WALK() \
    EINA_INLIST_FOREACH(start, par) \
      { \
+        if (par == o->par_deferred) break; \
         if (!par->visible) continue; \
         if (clip) \
           { \
@@ -10633,7 +11370,11 @@ evas_object_textblock_render(Evas_Object *eo_obj EINA_UNUSED,
                               (Evas_Object_Textblock_Text_Item *)itr; \
                             int ascent = 0; \
                             if (titr->text_props.font_instance) \
-                              ascent = evas_common_font_instance_max_ascent_get(titr->text_props.font_instance); \
+                              { \
+                                 evas_common_font_cache_lock(); \
+                                 ascent = evas_common_font_instance_max_ascent_get(titr->text_props.font_instance); \
+                                 evas_common_font_cache_unlock(); \
+                              } \
                             yoff = ascent + \
                               (itr->format->valign * (ln->h - itr->h)); \
                          } \
@@ -11015,10 +11756,12 @@ evas_object_textblock_render(Evas_Object *eo_obj EINA_UNUSED,
              void *fi = _ITEM_TEXT(itr)->text_props.font_instance;
              COLOR_SET(normal);
              DRAW_TEXT(0, 0);
+             evas_common_font_cache_lock();
              line_thickness =
                 evas_common_font_instance_underline_thickness_get(fi);
              line_position =
                 evas_common_font_instance_underline_position_get(fi);
+             evas_common_font_cache_unlock();
           }
 
         /* STRIKETHROUGH */
@@ -11091,10 +11834,26 @@ evas_object_textblock_render_pre(Evas_Object *eo_obj,
    /* if so what and where and add the appropriate redraw textblocks */
 
    evas_object_textblock_coords_recalc(eo_obj, obj, obj->private_data);
+   /* The last layout may have left out paragraphs that are now visible. If
+    * it's running in a thread, it lays them out already. */
+   if (!o->changed && o->par_deferred)
+     {
+        Evas_Coord y, h;
+
+        if (!_layout_visible_get(obj, o, &y, &h) ||
+            (o->par_deferred->y <= y + h + 20))
+          {
+             if (o->layout_job) _layout_job_join(o, o->layout_job);
+             else o->changed = 1;
+          }
+     }
    if (o->changed)
      {
         LYDBG("ZZ: relayout 16\n");
-        _relayout(eo_obj);
+        if (o->async_layout)
+          _layout_async_start(eo_obj, obj, o);
+        else
+          _relayout_visible(eo_obj, obj, o);
         o->redraw = 0;
         evas_object_render_pre_prev_cur_add(&obj->layer->evas->clip_changes,
                                             eo_obj, obj);
@@ -11261,6 +12020,7 @@ _evas_object_textblock_rehint(Evas_Object *eo_obj)
    Evas_Object_Textblock_Paragraph *par;
    Evas_Object_Textblock_Line *ln;
 
+   _layout_async_wait(o);
    EINA_INLIST_FOREACH(o->paragraphs, par)
      {
         EINA_INLIST_FOREACH(par->lines, ln)
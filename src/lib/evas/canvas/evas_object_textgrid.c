@@ -195,7 +195,9 @@ evas_object_textgrid_textprop_get(Evas_Object *eo_obj, Evas_Textgrid_Data *o, Ei
      }
    else
      {
+        evas_common_font_cache_lock();
         evas_common_text_props_content_ref(&(glyph->props[idx]));
+        evas_common_font_cache_unlock();
      }
    
    return glyphs_index << 8 | (unsigned int) idx;
@@ -345,7 +347,9 @@ evas_object_textgrid_textprop_unref(Evas_Textgrid_Data *o, unsigned int props_in
                           (void *)((uintptr_t)props_index));
         else
           {
+             evas_common_font_cache_lock();
              evas_common_text_props_content_nofree_unref(props);
+             evas_common_font_cache_unlock();
           }
      }
 }
@@ -452,7 +456,9 @@ evas_object_textgrid_free(Evas_Object *eo_obj, Evas_Object_Protected_Data *obj)
         props_index = (unsigned int) (intptr_t) eina_array_pop(&o->glyphs_cleanup);
         prop = &(o->glyphs[props_index >> 8].props[props_index & 0xFF]);
 
+        evas_common_font_cache_lock();
         evas_common_text_props_content_nofree_unref(prop);
+        evas_common_font_cache_unlock();
         if (!prop->info)
           {
              o->glyphs_used[props_index >> 8]--;
@@ -569,7 +575,9 @@ _drop_glyphs_ref(const void *container EINA_UNUSED, void *data, void *fdata)
    Evas_Font_Array_Data *fad = data;
    Evas_Public_Data     *pd = fdata;
 
+   evas_common_font_cache_lock();
    evas_common_font_glyphs_unref(fad->glyphs);
+   evas_common_font_cache_unlock();
    eina_array_pop(&pd->glyph_unref_queue);
 
    return EINA_TRUE;
@@ -730,7 +738,9 @@ evas_object_textgrid_render(Evas_Object *eo_obj,
                          evas_object_textgrid_textprop_int_to
                          (o, row->texts[xx].text_props);
 
+                       evas_common_font_cache_lock();
                        evas_common_font_draw_prepare(props);
+                       evas_common_font_cache_unlock();
 
                        evas_common_font_glyphs_ref(props->glyphs);
                        evas_unref_queue_glyph_put(obj->layer->evas,
@@ -970,7 +980,9 @@ evas_object_textgrid_render_post(Evas_Object *eo_obj,
         props_index = (unsigned int) (intptr_t) eina_array_pop(&o->glyphs_cleanup);
         prop = &(o->glyphs[props_index >> 8].props[props_index & 0xFF]);
         
+        evas_common_font_cache_lock();
         evas_common_text_props_content_nofree_unref(prop);
+        evas_common_font_cache_unlock();
         if (!prop->info)
           {
              o->glyphs_used[props_index >> 8]--;
@@ -1222,7 +1234,9 @@ _evas_textgrid_font_set(Eo *eo_obj, Evas_Textgrid_Data *o, const char *font_name
         o->cur.char_width = advance;
         o->cur.char_height = vadvance;
         o->ascent = ENFN->font_ascent_get(ENDT, o->font);;
+        evas_common_font_cache_lock();
         evas_common_text_props_content_unref(&text_props);
+        evas_common_font_cache_unlock();
      }
    else
      {
@@ -1271,7 +1285,9 @@ _evas_textgrid_font_set(Eo *eo_obj, Evas_Textgrid_Data *o, const char *font_name
         props_index = (unsigned int) (intptr_t) eina_array_pop(&o->glyphs_cleanup);
         prop = &(o->glyphs[props_index >> 8].props[props_index & 0xFF]);
         
+        evas_common_font_cache_lock();
         evas_common_text_props_content_nofree_unref(prop);
+        evas_common_font_cache_unlock();
         if (!prop->info)
           {
              o->glyphs_used[props_index >> 8]--;
@@ -2221,7 +2221,9 @@ evas_render_wakeup(Evas *eo_e)
    eina_array_foreach(&e->image_unref_queue, _drop_image_cache_ref, NULL);
    eina_array_clean(&e->image_unref_queue);
 
+   evas_common_font_cache_lock();
    eina_array_foreach(&e->glyph_unref_queue, _drop_glyph_ref, NULL);
+   evas_common_font_cache_unlock();
    eina_array_clean(&e->glyph_unref_queue);
 
    eina_array_foreach(&e->texts_unref_queue, _drop_texts_ref, NULL);
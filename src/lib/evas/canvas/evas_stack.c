@@ -52,7 +52,10 @@ _evas_object_raise(Eo *eo_obj, Evas_Object_Protected_Data *obj)
    else
      {
         if (obj->in_layer)
-          obj->layer->objects = (Evas_Object_Protected_Data *)eina_inlist_demote(EINA_INLIST_GET(obj->layer->objects), EINA_INLIST_GET(obj));
+          {
+             obj->layer->objects = (Evas_Object_Protected_Data *)eina_inlist_demote(EINA_INLIST_GET(obj->layer->objects), EINA_INLIST_GET(obj));
+             evas_event_index_list_changed(obj);
+          }
      }
    if (obj->clip.clipees)
      {
@@ -98,8 +101,11 @@ _evas_object_lower(Eo *eo_obj, Evas_Object_Protected_Data *obj)
    else
      {
         if (obj->in_layer)
-          obj->layer->objects = (Evas_Object_Protected_Data *)eina_inlist_promote(EINA_INLIST_GET(obj->layer->objects),
-                                                                                 EINA_INLIST_GET(obj));
+          {
+             obj->layer->objects = (Evas_Object_Protected_Data *)eina_inlist_promote(EINA_INLIST_GET(obj->layer->objects),
+                                                                                    EINA_INLIST_GET(obj));
+             evas_event_index_list_changed(obj);
+          }
      }
    if (obj->clip.clipees)
      {
@@ -174,6 +180,7 @@ _evas_object_stack_above(Eo *eo_obj, Evas_Object_Protected_Data *obj, Evas_Objec
              obj->layer->objects = (Evas_Object_Protected_Data *)eina_inlist_append_relative(EINA_INLIST_GET(obj->layer->objects),
                                                                                             EINA_INLIST_GET(obj),
                                                                                             EINA_INLIST_GET(above));
+             evas_event_index_list_changed(obj);
           }
      }
    if (obj->clip.clipees)
@@ -249,6 +256,7 @@ _evas_object_stack_below(Eo *eo_obj, Evas_Object_Protected_Data *obj, Evas_Objec
              obj->layer->objects = (Evas_Object_Protected_Data *)eina_inlist_prepend_relative(EINA_INLIST_GET(obj->layer->objects),
                                                                                EINA_INLIST_GET(obj),
                                                                                EINA_INLIST_GET(below));
+             evas_event_index_list_changed(obj);
           }
      }
    if (obj->clip.clipees)
@@ -47,3 +47,28 @@ EAPI void
 evas_cserve_disconnect(void)
 {
 }
+
+EAPI Eina_Bool
+evas_image_scale_cache_stats_get(Evas_Image_Scale_Cache_Stats *stats)
+{
+   if (!stats) return EINA_FALSE;
+   return evas_common_rgba_image_scalecache_stats_get(stats);
+}
+
+EAPI void
+evas_image_scale_cache_stats_reset(void)
+{
+   evas_common_rgba_image_scalecache_stats_reset();
+}
+
+EAPI void
+evas_image_scale_cache_adaptive_set(Eina_Bool adaptive)
+{
+   evas_common_rgba_image_scalecache_adaptive_set(adaptive);
+}
+
+EAPI Eina_Bool
+evas_image_scale_cache_adaptive_get(void)
+{
+   return evas_common_rgba_image_scalecache_adaptive_get();
+}
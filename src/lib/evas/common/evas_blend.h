@@ -4,5 +4,10 @@
 
 EAPI void evas_common_blend_init (void);
 
+/* The span function of one cpu column of the blend, copy or mul tables,
+ * NULL if that cpu has none. For the tests and the benchmarks, rendering
+ * goes through the compositors. */
+EAPI RGBA_Gfx_Func evas_common_gfx_func_composite_span_cpu_get (int op, int s, int m, int c, int d, int cpu);
+
 
 #endif /* _EVAS_BLEND_H */
@@ -5,6 +5,10 @@
 #include "evas_mmx.h"
 #endif
 
+extern RGBA_Gfx_Func     op_blend_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+extern RGBA_Gfx_Func     op_copy_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+extern RGBA_Gfx_Func     op_mul_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+
 const DATA32 ALPHA_255 = 255;
 const DATA32 ALPHA_256 = 256;
 
@@ -137,6 +141,32 @@ evas_common_blend_shutdown(void)
    if (comp) comp->shutdown();
 }
 
+EAPI RGBA_Gfx_Func
+evas_common_gfx_func_composite_span_cpu_get(int op, int s, int m, int c, int d, int cpu)
+{
+   RGBA_Gfx_Func (*funcs)[SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+
+   if ((s < 0) || (s >= SP_LAST) || (m < 0) || (m >= SM_LAST) ||
+       (c < 0) || (c >= SC_LAST) || (d < 0) || (d >= DP_LAST) ||
+       (cpu < 0) || (cpu >= CPU_LAST))
+     return NULL;
+
+   switch (op)
+      {
+	case _EVAS_RENDER_BLEND:
+	   funcs = op_blend_span_funcs;
+	   break;
+	case _EVAS_RENDER_COPY:
+	   funcs = op_copy_span_funcs;
+	   break;
+	case _EVAS_RENDER_MUL:
+	   funcs = op_mul_span_funcs;
+	   break;
+	default:
+	   return NULL;
+      }
+   return funcs[s][m][c][d][cpu];
+}
 
 RGBA_Gfx_Func
 evas_common_gfx_func_composite_pixel_span_get(RGBA_Image *src, RGBA_Image *dst, int pixels, int op)
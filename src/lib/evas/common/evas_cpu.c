@@ -73,6 +73,16 @@ evas_common_cpu_sse3_test(void)
 #endif
 }
 
+void evas_common_op_avx2_test(void);
+
+void
+evas_common_cpu_avx2_test(void)
+{
+#ifdef BUILD_AVX2
+   evas_common_op_avx2_test();
+#endif
+}
+
 #ifdef BUILD_ALTIVEC
 void
 evas_common_cpu_altivec_test(void)
@@ -151,6 +161,8 @@ evas_common_cpu_feature_test(void (*feature)(void))
      return (f & EINA_CPU_SSE) == EINA_CPU_SSE;
    if (feature == evas_common_cpu_sse3_test)
      return (f & EINA_CPU_SSE3) == EINA_CPU_SSE3;
+   if (feature == evas_common_cpu_avx2_test)
+     return (f & EINA_CPU_AVX2) == EINA_CPU_AVX2;
    return 0;
 #endif
 }
@@ -197,6 +209,13 @@ evas_common_cpu_init(void)
         evas_common_cpu_end_opt();
      }
 # endif /* BUILD_SSE3 */
+# ifdef BUILD_AVX2
+   if (getenv("EVAS_CPU_NO_AVX2"))
+     cpu_feature_mask &= ~CPU_FEATURE_AVX2;
+   else
+     cpu_feature_mask |= CPU_FEATURE_AVX2 *
+       evas_common_cpu_feature_test(evas_common_cpu_avx2_test);
+# endif /* BUILD_AVX2 */
 #endif /* BUILD_MMX */
 #ifdef BUILD_ALTIVEC
 # ifdef __POWERPC__
@@ -9,6 +9,8 @@
 EAPI void              evas_common_font_init                 (void);
 EAPI void              evas_common_font_shutdown             (void);
 EAPI void              evas_common_font_font_all_unload      (void);
+EAPI void              evas_common_font_cache_lock           (void);
+EAPI void              evas_common_font_cache_unlock         (void);
 
 EAPI int               evas_common_font_ascent_get           (RGBA_Font *fn);
 EAPI int               evas_common_font_descent_get          (RGBA_Font *fn);
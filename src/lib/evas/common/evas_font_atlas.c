@@ -0,0 +1,337 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "evas_common_private.h"
+#include "evas_private.h"
+
+#include "evas_font_private.h"
+
+/* The compressed glyph bitmaps of all the font instances are packed into
+ * shared pages instead of being allocated one by one. A compressed bitmap
+ * is a string of bytes, so it is appended to the open row of a page, or
+ * takes whole rows when it is longer than a row. A row is reused once all
+ * the bitmaps in it are gone, and a page is freed once all its rows are.
+ * Bitmaps larger than a page are kept in their own allocation but count
+ * in the budget all the same.
+ *
+ * The glyphs not drawn from any glyph array are kept in an LRU, and the
+ * least recently drawn ones are dropped when the atlas goes over budget.
+ * They are rendered again the next time they are drawn. The glyphs in use
+ * are never dropped, so the budget can be exceeded when all of them are,
+ * the next bitmap stored once some are released brings it back under. */
+
+#define ATLAS_PAGE_PITCH 512
+#define ATLAS_PAGE_ROWS 128
+#define ATLAS_PAGE_SIZE (ATLAS_PAGE_PITCH * ATLAS_PAGE_ROWS)
+
+typedef struct _Glyph_Atlas_Page Glyph_Atlas_Page;
+
+struct _Glyph_Atlas_Page
+{
+   DATA8         *data;
+   int            row; /* row the small bitmaps are appended to, -1 if none */
+   int            top; /* rows from there on were never used */
+   int            free_rows;
+   int            count; /* bitmaps in the page */
+   unsigned short used[ATLAS_PAGE_ROWS]; /* bytes taken, 0 if the row is free */
+   unsigned short live[ATLAS_PAGE_ROWS]; /* bitmaps in the row */
+};
+
+static LK(atlas_lock);
+static Eina_List   *atlas_pages = NULL;
+static Eina_Inlist *atlas_lru = NULL; /* least recently drawn first */
+static int          atlas_usage = 0;
+static int          atlas_size = 4 * 1024 * 1024;
+static int          atlas_init = 0;
+static Evas_Glyph_Atlas_Stats atlas_stats;
+
+static Glyph_Atlas_Page *
+_atlas_page_new(void)
+{
+   Glyph_Atlas_Page *page;
+
+   page = calloc(1, sizeof(Glyph_Atlas_Page) + ATLAS_PAGE_SIZE);
+   if (!page) return NULL;
+   page->data = (DATA8 *)(page + 1);
+   page->row = -1;
+   page->free_rows = ATLAS_PAGE_ROWS;
+   atlas_pages = eina_list_prepend(atlas_pages, page);
+   atlas_usage += ATLAS_PAGE_SIZE;
+   atlas_stats.pages_added++;
+   return page;
+}
+
+static void
+_atlas_page_free(Glyph_Atlas_Page *page)
+{
+   atlas_pages = eina_list_remove(atlas_pages, page);
+   atlas_usage -= ATLAS_PAGE_SIZE;
+   atlas_stats.pages_freed++;
+   free(page);
+}
+
+/* Finds a run of free rows, returns the first one or -1. */
+static int
+_atlas_page_rows_find(Glyph_Atlas_Page *page, int rows)
+{
+   int i, n = 0;
+
+   if (page->free_rows < rows) return -1;
+   for (i = 0; i < ATLAS_PAGE_ROWS; i++)
+     {
+        if (page->used[i]) n = 0;
+        else if (++n == rows)
+          {
+             i = i - rows + 1;
+             if (i < page->top)
+               atlas_stats.rows_reused += MIN(page->top - i, rows);
+             page->top = MAX(page->top, i + rows);
+             return i;
+          }
+     }
+   return -1;
+}
+
+static DATA8 *
+_atlas_page_request(Glyph_Atlas_Page *page, int size)
+{
+   int row, rows, i;
+
+   /* keep the bitmaps int aligned, they start with an int header */
+   size = (size + 3) & ~3;
+   if (size <= ATLAS_PAGE_PITCH)
+     {
+        row = page->row;
+        if ((row < 0) || ((page->used[row] + size) > ATLAS_PAGE_PITCH))
+          {
+             row = _atlas_page_rows_find(page, 1);
+             if (row < 0) return NULL;
+             page->row = row;
+             page->free_rows--;
+          }
+        page->used[row] += size;
+        page->live[row]++;
+        page->count++;
+        return page->data + (row * ATLAS_PAGE_PITCH) + page->used[row] - size;
+     }
+
+   rows = (size + ATLAS_PAGE_PITCH - 1) / ATLAS_PAGE_PITCH;
+   row = _atlas_page_rows_find(page, rows);
+   if (row < 0) return NULL;
+   for (i = row; i < (row + rows); i++)
+     {
+        page->used[i] = ATLAS_PAGE_PITCH;
+        page->live[i] = 1;
+     }
+   page->free_rows -= rows;
+   page->count++;
+   return page->data + (row * ATLAS_PAGE_PITCH);
+}
+
+/* Returns EINA_TRUE if the page is still there. */
+static Eina_Bool
+_atlas_page_release(Glyph_Atlas_Page *page, DATA8 *data, int size)
+{
+   int row, rows, i;
+
+   row = (data - page->data) / ATLAS_PAGE_PITCH;
+   rows = (size + ATLAS_PAGE_PITCH - 1) / ATLAS_PAGE_PITCH;
+   for (i = row; i < (row + rows); i++)
+     {
+        if (--page->live[i]) continue;
+        page->used[i] = 0;
+        page->free_rows++;
+        if (page->row == i) page->row = -1;
+     }
+   if (--page->count) return EINA_TRUE;
+   _atlas_page_free(page);
+   return EINA_FALSE;
+}
+
+/* Returns the page the glyph was in if it was in one and the page is still
+ * there. */
+static Glyph_Atlas_Page *
+_atlas_glyph_drop(RGBA_Font_Glyph *fg)
+{
+   Glyph_Atlas_Page *page = fg->atlas_page;
+
+   if (!fg->atlas_size) return NULL;
+   if (!fg->atlas_refs)
+     atlas_lru = eina_inlist_remove(atlas_lru, EINA_INLIST_GET(fg));
+   if (page)
+     {
+        if (!_atlas_page_release(page, fg->glyph_out->rle, fg->atlas_size))
+          page = NULL;
+        fg->atlas_page = NULL;
+     }
+   else
+     {
+        free(fg->glyph_out->rle);
+        atlas_usage -= fg->atlas_size;
+     }
+   fg->glyph_out->rle = NULL;
+   fg->atlas_size = 0;
+   return page;
+}
+
+static DATA8 *
+_atlas_request(int size, Glyph_Atlas_Page **ret)
+{
+   Glyph_Atlas_Page *page;
+   DATA8 *data;
+   Eina_List *l;
+
+   /* the glyphs in use held it over budget, go back under it now that some
+    * were released */
+   while ((atlas_lru) && (atlas_usage > atlas_size))
+     {
+        _atlas_glyph_drop(EINA_INLIST_CONTAINER_GET(atlas_lru,
+                                                    RGBA_Font_Glyph));
+        atlas_stats.drops++;
+     }
+
+   EINA_LIST_FOREACH(atlas_pages, l, page)
+     {
+        data = _atlas_page_request(page, size);
+        if (data)
+          {
+             /* look in the page that had room first next time */
+             if (l != atlas_pages)
+               atlas_pages = eina_list_promote_list(atlas_pages, l);
+             *ret = page;
+             return data;
+          }
+     }
+
+   /* make room in the pages before adding one over budget */
+   while ((atlas_lru) && ((atlas_usage + ATLAS_PAGE_SIZE) > atlas_size))
+     {
+        page = _atlas_glyph_drop(EINA_INLIST_CONTAINER_GET(atlas_lru,
+                                                           RGBA_Font_Glyph));
+        atlas_stats.drops++;
+        if (!page) continue;
+        data = _atlas_page_request(page, size);
+        if (data)
+          {
+             *ret = page;
+             return data;
+          }
+     }
+
+   page = _atlas_page_new();
+   if (!page) return NULL;
+   *ret = page;
+   return _atlas_page_request(page, size);
+}
+
+void
+evas_common_font_glyph_atlas_init(void)
+{
+   const char *s;
+
+   atlas_init++;
+   if (atlas_init != 1) return;
+   s = getenv("EVAS_GLYPH_CACHE_SIZE");
+   if (s) atlas_size = atoi(s) * 1024;
+   memset(&atlas_stats, 0, sizeof(atlas_stats));
+   LKI(atlas_lock);
+}
+
+void
+evas_common_font_glyph_atlas_shutdown(void)
+{
+   Glyph_Atlas_Page *page;
+
+   if (atlas_init < 1) return;
+   atlas_init--;
+   if (atlas_init != 0) return;
+
+   /* the glyphs should all be gone with their fonts by now */
+   EINA_LIST_FREE(atlas_pages, page)
+     free(page);
+   atlas_lru = NULL;
+   atlas_usage = 0;
+   LKD(atlas_lock);
+}
+
+/* Takes the compressed bitmap of the glyph, allocated with malloc(), and
+ * moves it to the atlas. */
+void
+evas_common_font_glyph_atlas_store(RGBA_Font_Glyph *fg, DATA8 *rle, int size)
+{
+   Glyph_Atlas_Page *page = NULL;
+   DATA8 *data = NULL;
+
+   LKL(atlas_lock);
+   _atlas_glyph_drop(fg);
+   if (size <= ATLAS_PAGE_SIZE) data = _atlas_request(size, &page);
+   if (data)
+     {
+        memcpy(data, rle, size);
+        fg->glyph_out->rle = data;
+        fg->glyph_out->bitmap.rle_alloc = EINA_FALSE;
+        free(rle);
+     }
+   else
+     {
+        while ((atlas_lru) && ((atlas_usage + size) > atlas_size))
+          {
+             _atlas_glyph_drop(EINA_INLIST_CONTAINER_GET(atlas_lru,
+                                                         RGBA_Font_Glyph));
+             atlas_stats.drops++;
+          }
+        fg->glyph_out->rle = rle;
+        fg->glyph_out->bitmap.rle_alloc = EINA_FALSE;
+        atlas_usage += size;
+     }
+   fg->atlas_page = data ? page : NULL;
+   fg->atlas_size = size;
+   atlas_stats.stores++;
+   if (!fg->atlas_refs)
+     atlas_lru = eina_inlist_append(atlas_lru, EINA_INLIST_GET(fg));
+   LKU(atlas_lock);
+}
+
+/* Drops the bitmap of the glyph, if it has one in the atlas. */
+void
+evas_common_font_glyph_atlas_free(RGBA_Font_Glyph *fg)
+{
+   if (!fg->atlas_size) return;
+   LKL(atlas_lock);
+   _atlas_glyph_drop(fg);
+   LKU(atlas_lock);
+}
+
+/* A glyph in use by a glyph array keeps its bitmap until it's released. */
+void
+evas_common_font_glyph_atlas_ref(RGBA_Font_Glyph *fg)
+{
+   LKL(atlas_lock);
+   if ((!fg->atlas_refs) && (fg->atlas_size))
+     atlas_lru = eina_inlist_remove(atlas_lru, EINA_INLIST_GET(fg));
+   fg->atlas_refs++;
+   LKU(atlas_lock);
+}
+
+void
+evas_common_font_glyph_atlas_unref(RGBA_Font_Glyph *fg)
+{
+   LKL(atlas_lock);
+   fg->atlas_refs--;
+   if ((!fg->atlas_refs) && (fg->atlas_size))
+     atlas_lru = eina_inlist_append(atlas_lru, EINA_INLIST_GET(fg));
+   LKU(atlas_lock);
+}
+
+EAPI void
+evas_common_font_glyph_atlas_stats_get(Evas_Glyph_Atlas_Stats *stats)
+{
+   LKL(atlas_lock);
+   *stats = atlas_stats;
+   stats->usage = atlas_usage;
+   stats->size = atlas_size;
+   stats->pages = eina_list_count(atlas_pages);
+   stats->lru = eina_inlist_count(atlas_lru);
+   LKU(atlas_lock);
+}
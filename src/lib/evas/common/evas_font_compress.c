@@ -462,6 +462,115 @@ evas_common_font_glyph_uncompress(RGBA_Font_Glyph *fg, int *wret, int *hret)
    return buf;
 }
 
+// the expanders built here, with the same code as the sse3 and avx2 ones
+// built on their own. the glyph is already clipped when they are called
+#define GLYPH_DRAW_FUNC(_extn) \
+static void \
+_glyph_draw##_extn(RGBA_Font_Glyph_Out *fgo, const Evas_Glyph_Color *gc, \
+                   DATA32 *dst, int dst_pitch, int x, int y, \
+                   int x1, int y1, int x2, int y2)
+
+GLYPH_DRAW_FUNC(_c)
+{
+   int w, h, *iptr;
+   const DATA32 *coltab = gc->coltab;
+   const DATA16 *mtab = gc->mtab;
+   DATA16 v;
+
+   w = fgo->bitmap.width; h = fgo->bitmap.rows;
+#include "evas_font_compress_draw.c"
+}
+
+#ifdef BUILD_MMX
+GLYPH_DRAW_FUNC(_mmx)
+{
+   int w, h, *iptr;
+   const DATA32 *coltab = gc->coltab;
+   const DATA16 *mtab = gc->mtab;
+   DATA16 v;
+
+   w = fgo->bitmap.width; h = fgo->bitmap.rows;
+#define MMX 1
+#include "evas_font_compress_draw.c"
+#undef MMX
+}
+#endif
+
+#ifdef BUILD_NEON
+GLYPH_DRAW_FUNC(_neon)
+{
+   int w, h, *iptr;
+   const DATA32 *coltab = gc->coltab;
+   const DATA16 *mtab = gc->mtab;
+   DATA16 v;
+
+   w = fgo->bitmap.width; h = fgo->bitmap.rows;
+#define NEON 1
+#include "evas_font_compress_draw.c"
+#undef NEON
+}
+#endif
+
+#undef GLYPH_DRAW_FUNC
+
+// the glyph expander for a given cpu (CPU_C, CPU_MMX...), NULL if it isn't
+// built or the cpu can't run it
+EAPI Evas_Glyph_Draw_Func
+evas_common_font_glyph_draw_cpu_get(int cpu)
+{
+   switch (cpu)
+     {
+      case CPU_C:
+        return _glyph_draw_c;
+#ifdef BUILD_MMX
+      case CPU_MMX:
+        if (evas_common_cpu_has_feature(CPU_FEATURE_MMX))
+          return _glyph_draw_mmx;
+        break;
+#endif
+#ifdef BUILD_SSE3
+      case CPU_SSE3:
+        if (evas_common_cpu_has_feature(CPU_FEATURE_SSE3))
+          return evas_common_font_glyph_draw_sse3;
+        break;
+#endif
+#ifdef BUILD_AVX2
+      case CPU_AVX2:
+        if (evas_common_cpu_has_feature(CPU_FEATURE_AVX2))
+          return evas_common_font_glyph_draw_avx2;
+        break;
+#endif
+#ifdef BUILD_NEON
+      case CPU_NEON:
+        if (evas_common_cpu_has_feature(CPU_FEATURE_NEON))
+          return _glyph_draw_neon;
+        break;
+#endif
+      default:
+        break;
+     }
+   return NULL;
+}
+
+// build fast multiply + mask color tables to avoid compute. this works
+// because of our very limited 4bit range of alpha values. a run of glyphs
+// is drawn in the same color, so this only needs doing once per run
+EAPI void
+evas_common_font_glyph_color_set(Evas_Glyph_Color *gc, DATA32 col)
+{
+   DATA16 v;
+   DATA8 tmp;
+   int i;
+
+   for (i = 0; i <= 0xf; i++)
+     {
+        v = (i << 4) | i;
+        gc->coltab[i] = MUL_SYM(v, col);
+        tmp = (gc->coltab[i] >> 24);
+        gc->mtab[i] = 256 - (tmp + (tmp >> 7));
+     }
+}
+
 // this draws a compressed font glyph and decompresses on the fly as it
 // draws, saving memory bandwidth and providing speedups
 EAPI void
@@ -469,13 +578,25 @@ evas_common_font_glyph_draw(RGBA_Font_Glyph *fg,
                             RGBA_Draw_Context *dc,
                             RGBA_Image *dst_image, int dst_pitch,
                             int x, int y, int cx, int cy, int cw, int ch)
+{
+   Evas_Glyph_Color gc;
+
+   if (dst_image->cache_entry.space != EVAS_COLORSPACE_GRY8)
+     evas_common_font_glyph_color_set(&gc, dc->col.col);
+   evas_common_font_glyph_color_draw(fg, &gc, dc, dst_image, dst_pitch,
+                                     x, y, cx, cy, cw, ch);
+}
+
+void
+evas_common_font_glyph_color_draw(RGBA_Font_Glyph *fg,
+                                  const Evas_Glyph_Color *gc,
+                                  RGBA_Draw_Context *dc,
+                                  RGBA_Image *dst_image, int dst_pitch,
+                                  int x, int y, int cx, int cy, int cw, int ch)
 {
    RGBA_Font_Glyph_Out *fgo = fg->glyph_out;
-   int w, h, x1, x2, y1, y2, i, *iptr;
+   int w, h, x1, x2, y1, y2;
    DATA32 *dst = dst_image->image.data;
-   DATA32 coltab[16], col;
-   DATA16 mtab[16], v;
-   DATA8 tmp;
 
    w = fgo->bitmap.width; h = fgo->bitmap.rows;
    // skip if totally clipped out
@@ -489,7 +610,6 @@ evas_common_font_glyph_draw(RGBA_Font_Glyph *fg,
    x1 = 0; x2 = w;
    if ((x + x1) < cx) x1 = cx - x;
    if ((x + x2) > (cx + cw)) x2 = cx + cw - x;
-   col = dc->col.col;
    if (dst_image->cache_entry.space == EVAS_COLORSPACE_GRY8)
      {
         // FIXME: Font draw not optimized for Alpha targets! SLOW!
@@ -514,38 +634,14 @@ evas_common_font_glyph_draw(RGBA_Font_Glyph *fg,
      }
    else
      {
-        // build fast multiply + mask color tables to avoid compute. this works
-        // because of our very limited 4bit range of alpha values
-        for (i = 0; i <= 0xf; i++)
-          {
-             v = (i << 4) | i;
-             coltab[i] = MUL_SYM(v, col);
-             tmp = (coltab[i] >> 24);
-             mtab[i] = 256 - (tmp + (tmp >> 7));
-          }
-#ifdef BUILD_MMX
-        if (evas_common_cpu_has_feature(CPU_FEATURE_MMX))
-          {
-#define MMX 1
-#include "evas_font_compress_draw.c"
-#undef MMX
-          }
-        else
-#endif
-
-#ifdef BUILD_NEON
-        if (evas_common_cpu_has_feature(CPU_FEATURE_NEON))
-          {
-#define NEON 1
-#include "evas_font_compress_draw.c"
-#undef NEON
-          }
-        else
-#endif
-
-          // Plain C
-          {
-#include "evas_font_compress_draw.c"
-          }
+        Evas_Glyph_Draw_Func draw;
+
+        // the fastest expander this cpu runs
+        draw = evas_common_font_glyph_draw_cpu_get(CPU_AVX2);
+        if (!draw) draw = evas_common_font_glyph_draw_cpu_get(CPU_SSE3);
+        if (!draw) draw = evas_common_font_glyph_draw_cpu_get(CPU_MMX);
+        if (!draw) draw = evas_common_font_glyph_draw_cpu_get(CPU_NEON);
+        if (!draw) draw = evas_common_font_glyph_draw_cpu_get(CPU_C);
+        draw(fgo, gc, dst, dst_pitch, x, y, x1, y1, x2, y2);
      }
 }
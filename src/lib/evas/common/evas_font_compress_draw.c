@@ -1,9 +1,9 @@
 // inherited from parent func
 //   RGBA_Font_Glyph_Out *fgo;
-//   int w, h, x1, x2, y1, y2, i, *iptr;
-//   DATA32 coltab[16], col;
-//   DATA16 mtab[16], v;
-//   DATA8 tmp;
+//   int w, h, x1, x2, y1, y2, *iptr;
+//   const DATA32 *coltab;
+//   const DATA16 *mtab;
+//   DATA16 v;
 
 // blend a pixel using pre-computed multiplied col and inverse mul value
 #define MMX_BLEND(_dst, _col, _mul) \
@@ -31,6 +31,58 @@
         } \
    }
 
+// with sse3 a whole run of pixels of the same value is copied or blended
+// 4 pixels at a time, the pixels left over are done one by one after it
+#define SSE3_COPY4LOOP(_dst, _len, _col) \
+   if (_len >= 4) \
+   { \
+      __m128i c4 = _mm_set1_epi32(_col); \
+      while (_len > 3) \
+        { \
+           _mm_storeu_si128((__m128i *)_dst, c4); \
+           _dst += 4; _len -= 4; \
+        } \
+   }
+
+#define SSE3_BLEND4LOOP(_dst, _len, _col, _mul) \
+   if (_len >= 4) \
+   { \
+      __m128i c4 = _mm_set1_epi32(_col), m4 = _mm_set1_epi16(_mul); \
+      while (_len > 3) \
+        { \
+           __m128i d4 = _mm_loadu_si128((__m128i *)_dst); \
+           d4 = _mm_add_epi32(c4, glyph_mul_256_sse3(m4, d4)); \
+           _mm_storeu_si128((__m128i *)_dst, d4); \
+           _dst += 4; _len -= 4; \
+        } \
+   }
+
+// with avx2 it is the same, 8 pixels at a time, and then 4 at a time with
+// the sse3 loops
+#define AVX2_COPY8LOOP(_dst, _len, _col) \
+   if (_len >= 8) \
+   { \
+      __m256i c8 = _mm256_set1_epi32(_col); \
+      while (_len > 7) \
+        { \
+           _mm256_storeu_si256((__m256i *)_dst, c8); \
+           _dst += 8; _len -= 8; \
+        } \
+   }
+
+#define AVX2_BLEND8LOOP(_dst, _len, _col, _mul) \
+   if (_len >= 8) \
+   { \
+      __m256i c8 = _mm256_set1_epi32(_col), m8 = _mm256_set1_epi32(_mul); \
+      while (_len > 7) \
+        { \
+           __m256i d8 = _mm256_loadu_si256((__m256i *)_dst); \
+           d8 = _mm256_add_epi32(c8, mul_256_avx2(m8, d8)); \
+           _mm256_storeu_si256((__m256i *)_dst, d8); \
+           _dst += 8; _len -= 8; \
+        } \
+   }
+
 // if we build for mmx optimizations, we need to set up a few things in advance
 // like the mm0 register is always all 0'd to fill in 0 padding when
 // unpacking values to registers. also mm7 is reserved to hold an unpacked
@@ -58,7 +110,7 @@ if (*iptr > 0) // rle4
 // this, but this is for speed reasons, so we can generate slightly different
 // versions of the same blob of code logic that hold different optimizations
 // inside (eg mmx/sse/neon asm etc.)
-#define EXPAND_RLE(_donelabel, _extn, _2copy, _blend) \
+#define EXPAND_RLE(_donelabel, _extn, _2copy, _nblend, _blend) \
    if ((x1 == 0) && (x2 == w)) /* unclipped  horizontally */ \
    { \
       d0 += x1; \
@@ -99,6 +151,8 @@ if (*iptr > 0) // rle4
                 /* have to actually blend it to each dest pixel */ \
                 else \
                   { \
+                     /* blend many pixels at once if we can, eg sse3 */ \
+                     _nblend; \
                      while (len > 0) \
                        { \
                           /* do blend using op provided by params */ \
@@ -200,14 +254,24 @@ _donelabel##_extn: \
      {
         DATA8 *jumptab = p;
         p += (h * sizeof(DATA8));
-#ifdef MMX
-        EXPAND_RLE(done_8_clipped, _mmx, MMX_COPY64LOOP(d, len),
+#ifdef AVX2
+        EXPAND_RLE(done_8_clipped, _avx2,
+                   AVX2_COPY8LOOP(d, len, t) SSE3_COPY4LOOP(d, len, t),
+                   AVX2_BLEND8LOOP(d, len, coltab[v], mtab[v])
+                   SSE3_BLEND4LOOP(d, len, coltab[v], mtab[v]),
+                   C_BLEND(d[0], coltab[v], mtab[v]))
+#elif defined(SSE3)
+        EXPAND_RLE(done_8_clipped, _sse3, SSE3_COPY4LOOP(d, len, t),
+                   SSE3_BLEND4LOOP(d, len, coltab[v], mtab[v]),
+                   C_BLEND(d[0], coltab[v], mtab[v]))
+#elif defined(MMX)
+        EXPAND_RLE(done_8_clipped, _mmx, MMX_COPY64LOOP(d, len), ,
                    MMX_BLEND(d[0], coltab[v], mtab[v]))
 #elif defined(NEON)
-        EXPAND_RLE(done_8_clipped, _neon, ,
+        EXPAND_RLE(done_8_clipped, _neon, , ,
                    C_BLEND(d[0], coltab[v], mtab[v]))
 #else
-        EXPAND_RLE(done_8_clipped, _c, ,
+        EXPAND_RLE(done_8_clipped, _c, , ,
                    C_BLEND(d[0], coltab[v], mtab[v]))
 #endif
      }
@@ -215,14 +279,24 @@ _donelabel##_extn: \
      {
         unsigned short *jumptab = (unsigned short *)p;
         p += (h * sizeof(unsigned short));
-#ifdef MMX
-        EXPAND_RLE(done_16_clipped, _mmx, MMX_COPY64LOOP(d, len),
+#ifdef AVX2
+        EXPAND_RLE(done_16_clipped, _avx2,
+                   AVX2_COPY8LOOP(d, len, t) SSE3_COPY4LOOP(d, len, t),
+                   AVX2_BLEND8LOOP(d, len, coltab[v], mtab[v])
+                   SSE3_BLEND4LOOP(d, len, coltab[v], mtab[v]),
+                   C_BLEND(d[0], coltab[v], mtab[v]))
+#elif defined(SSE3)
+        EXPAND_RLE(done_16_clipped, _sse3, SSE3_COPY4LOOP(d, len, t),
+                   SSE3_BLEND4LOOP(d, len, coltab[v], mtab[v]),
+                   C_BLEND(d[0], coltab[v], mtab[v]))
+#elif defined(MMX)
+        EXPAND_RLE(done_16_clipped, _mmx, MMX_COPY64LOOP(d, len), ,
                    MMX_BLEND(d[0], coltab[v], mtab[v]))
 #elif defined(NEON)
-        EXPAND_RLE(done_16_clipped, _neon, ,
+        EXPAND_RLE(done_16_clipped, _neon, , ,
                    C_BLEND(d[0], coltab[v], mtab[v]))
 #else
-        EXPAND_RLE(done_16_clipped, _c, ,
+        EXPAND_RLE(done_16_clipped, _c, , ,
                    C_BLEND(d[0], coltab[v], mtab[v]))
 #endif
      }
@@ -230,14 +304,24 @@ _donelabel##_extn: \
      {
         int *jumptab = (int *)p;
         p += (h * sizeof(int));
-#ifdef MMX
-        EXPAND_RLE(done_32_clipped, _mmx, MMX_COPY64LOOP(d, len),
+#ifdef AVX2
+        EXPAND_RLE(done_32_clipped, _avx2,
+                   AVX2_COPY8LOOP(d, len, t) SSE3_COPY4LOOP(d, len, t),
+                   AVX2_BLEND8LOOP(d, len, coltab[v], mtab[v])
+                   SSE3_BLEND4LOOP(d, len, coltab[v], mtab[v]),
+                   C_BLEND(d[0], coltab[v], mtab[v]))
+#elif defined(SSE3)
+        EXPAND_RLE(done_32_clipped, _sse3, SSE3_COPY4LOOP(d, len, t),
+                   SSE3_BLEND4LOOP(d, len, coltab[v], mtab[v]),
+                   C_BLEND(d[0], coltab[v], mtab[v]))
+#elif defined(MMX)
+        EXPAND_RLE(done_32_clipped, _mmx, MMX_COPY64LOOP(d, len), ,
                    MMX_BLEND(d[0], coltab[v], mtab[v]))
 #elif defined(NEON)
-        EXPAND_RLE(done_32_clipped, _neon, ,
+        EXPAND_RLE(done_32_clipped, _neon, , ,
                    C_BLEND(d[0], coltab[v], mtab[v]))
 #else
-        EXPAND_RLE(done_32_clipped, _c, ,
+        EXPAND_RLE(done_32_clipped, _c, , ,
                    C_BLEND(d[0], coltab[v], mtab[v]))
 #endif
      }
@@ -277,6 +361,32 @@ else // bpp4
                }
              s++; d++; xx++;
           }
+#if defined(SSE3) || defined(AVX2)
+        // walk along 4 pixels at a time, looking their colors up. avx2
+        // uses the sse3 loop too, looking up 8 colors costs more than it
+        // saves on glyphs this small
+        for (; xx < (x2 - 3); xx += 4)
+          {
+             DATA8 v1;
+
+             v0 = s[0]; v1 = s[1];
+             if (v0 | v1)
+               {
+                  __m128i c4, m4, d4;
+
+                  c4 = _mm_set_epi32(coltab[v1 & 0xf], coltab[v1 >> 4],
+                                     coltab[v0 & 0xf], coltab[v0 >> 4]);
+                  m4 = _mm_set_epi16(mtab[v1 & 0xf], mtab[v1 & 0xf],
+                                     mtab[v1 >> 4], mtab[v1 >> 4],
+                                     mtab[v0 & 0xf], mtab[v0 & 0xf],
+                                     mtab[v0 >> 4], mtab[v0 >> 4]);
+                  d4 = _mm_loadu_si128((__m128i *)d);
+                  d4 = _mm_add_epi32(c4, glyph_mul_256_sse3(m4, d4));
+                  _mm_storeu_si128((__m128i *)d, d4);
+               }
+             s += 2; d += 4;
+          }
+#endif
         // walk along 2 pixels at a time (1 src pixel is 4 bits packed)
         for (; xx < (x2 - 1); xx += 2)
           {
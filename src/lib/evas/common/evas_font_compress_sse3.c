@@ -0,0 +1,27 @@
+#define NEED_SSE3 1
+
+#include "evas_common_private.h"
+#include "evas_font_private.h"
+
+#ifdef BUILD_SSE3
+
+// the sse3 version of evas_common_font_glyph_color_draw(), built on its own
+// as it needs the sse3 compiler flags. the glyph is already clipped here
+void
+evas_common_font_glyph_draw_sse3(RGBA_Font_Glyph_Out *fgo,
+                                 const Evas_Glyph_Color *gc,
+                                 DATA32 *dst, int dst_pitch, int x, int y,
+                                 int x1, int y1, int x2, int y2)
+{
+   int w, h, *iptr;
+   const DATA32 *coltab = gc->coltab;
+   const DATA16 *mtab = gc->mtab;
+   DATA16 v;
+
+   w = fgo->bitmap.width; h = fgo->bitmap.rows;
+#define SSE3 1
+#include "evas_font_compress_draw.c"
+#undef SSE3
+}
+
+#endif
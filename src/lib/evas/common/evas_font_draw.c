@@ -34,11 +34,15 @@ evas_common_font_rgba_draw(RGBA_Image *dst, RGBA_Draw_Context *dc, int x, int y,
                            Evas_Glyph_Array *glyphs, RGBA_Gfx_Func func EINA_UNUSED, int ext_x, int ext_y, int ext_w,
                            int ext_h, int im_w, int im_h EINA_UNUSED)
 {
+   Evas_Glyph_Color gc;
    Evas_Glyph *glyph;
 
    if (!glyphs) return EINA_FALSE;
    if (!glyphs->array) return EINA_FALSE;
 
+   if (dst->cache_entry.space != EVAS_COLORSPACE_GRY8)
+     evas_common_font_glyph_color_set(&gc, dc->col.col);
+
    EINA_INARRAY_FOREACH(glyphs->array, glyph)
      {
         RGBA_Font_Glyph *fg;
@@ -62,9 +66,10 @@ evas_common_font_rgba_draw(RGBA_Image *dst, RGBA_Draw_Context *dc, int x, int y,
                     dc->font_ext.func.gl_draw(dc->font_ext.data, (void *)dst,
                                               dc, fg, chr_x, y - (chr_y - y));
                   else if (fg->glyph_out->rle)
-                    evas_common_font_glyph_draw(fg, dc, dst, im_w,
-                                                chr_x, y - (chr_y - y),
-                                                ext_x, ext_y, ext_w, ext_h);
+                    evas_common_font_glyph_color_draw(fg, &gc, dc, dst, im_w,
+                                                      chr_x, y - (chr_y - y),
+                                                      ext_x, ext_y,
+                                                      ext_w, ext_h);
                }
           }
         else
@@ -96,6 +101,8 @@ evas_common_font_glyphs_ref(Evas_Glyph_Array *array)
 void
 evas_common_font_glyphs_unref(Evas_Glyph_Array *array)
 {
+   Evas_Glyph *glyph;
+
    if (--array->refcount) return;
 
 #ifdef EVAS_CSERVE2
@@ -111,6 +118,8 @@ evas_common_font_glyphs_unref(Evas_Glyph_Array *array)
      }
 #endif
 
+   EINA_INARRAY_FOREACH(array->array, glyph)
+     evas_common_font_glyph_atlas_unref(glyph->fg);
    eina_inarray_free(array->array);
    evas_common_font_int_unref(array->fi);
    free(array);
@@ -137,6 +146,7 @@ evas_common_font_draw_prepare(Evas_Text_Props *text_props)
    RGBA_Font_Int *fi;
    RGBA_Font_Glyph *fg = NULL;
    Eina_Inarray *glyphs;
+   Evas_Glyph *glyph;
    size_t unit = 32;
    Eina_Bool reused_glyphs;
    EVAS_FONT_WALK_TEXT_INIT();
@@ -163,6 +173,8 @@ evas_common_font_draw_prepare(Evas_Text_Props *text_props)
           }
 #endif
         glyphs = text_props->glyphs->array;
+        EINA_INARRAY_FOREACH(glyphs, glyph)
+          evas_common_font_glyph_atlas_unref(glyph->fg);
         glyphs->len = 0;
         reused_glyphs = EINA_TRUE;
      }
@@ -184,7 +196,6 @@ evas_common_font_draw_prepare(Evas_Text_Props *text_props)
 
    EVAS_FONT_WALK_TEXT_START()
      {
-        Evas_Glyph *glyph;
         FT_UInt idx;
 
         if (!EVAS_FONT_WALK_IS_VISIBLE) continue;
@@ -192,6 +203,9 @@ evas_common_font_draw_prepare(Evas_Text_Props *text_props)
 
         fg = evas_common_font_int_cache_glyph_get(fi, idx);
         if (!fg) continue;
+        /* hold the glyph in the atlas before rendering it, so that it can't
+         * be dropped again before it's drawn */
+        evas_common_font_glyph_atlas_ref(fg);
         if (!evas_common_font_int_cache_glyph_render(fg))
           {
              fg = NULL;
@@ -204,7 +218,11 @@ evas_common_font_draw_prepare(Evas_Text_Props *text_props)
 #endif
 	
 	glyph = eina_inarray_grow(glyphs, 1);
-	if (!glyph) goto error;
+	if (!glyph)
+          {
+             evas_common_font_glyph_atlas_unref(fg);
+             goto error;
+          }
 
         glyph->fg = fg;
         glyph->idx = idx;
@@ -235,7 +253,10 @@ evas_common_font_draw_prepare(Evas_Text_Props *text_props)
    return;
 
 error:
-   eina_inarray_free(glyphs);
+   EINA_INARRAY_FOREACH(glyphs, glyph)
+     evas_common_font_glyph_atlas_unref(glyph->fg);
+   if (reused_glyphs) glyphs->len = 0;
+   else eina_inarray_free(glyphs);
 }
 
 EAPI Eina_Bool
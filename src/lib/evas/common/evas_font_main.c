@@ -23,6 +23,7 @@ static int      initialised = 0;
 LK(lock_font_draw); // for freetype2 API calls
 LK(lock_bidi); // for evas bidi internal usage.
 LK(lock_ot); // for evas bidi internal usage.
+LK(lock_font_cache); // for the fonts, glyphs and sizes used out of the main loop
 
 EAPI void
 evas_common_font_init(void)
@@ -32,10 +33,12 @@ evas_common_font_init(void)
 
    initialised++;
    if (initialised != 1) return;
+   LKI(lock_font_cache);
    error = FT_Init_FreeType(&evas_ft_lib);
    if (error) return;
    evas_common_font_load_init();
    evas_common_font_draw_init();
+   evas_common_font_glyph_atlas_init();
    s = getenv("EVAS_FONT_DPI");
    if (s)
      {
@@ -58,6 +61,7 @@ evas_common_font_shutdown(void)
    evas_common_font_load_shutdown();
    evas_common_font_cache_set(0);
    evas_common_font_flush();
+   evas_common_font_glyph_atlas_shutdown();
 
    FT_Done_FreeType(evas_ft_lib);
    evas_ft_lib = 0;
@@ -65,12 +69,35 @@ evas_common_font_shutdown(void)
    LKD(lock_font_draw);
    LKD(lock_bidi);
    LKD(lock_ot);
+   LKD(lock_font_cache);
+}
+
+/* The font cache, i.e the fonts and their references, the glyphs and the
+ * size freetype is set to for each face, is shared by the canvas and the
+ * textblock layout threads. The engine font functions take this lock, the
+ * canvas code calling the font code directly has to take it itself. It's
+ * not recursive, and it's never taken by the render threads, which only
+ * draw the glyphs the main loop prepared. */
+EAPI void
+evas_common_font_cache_lock(void)
+{
+   if (initialised < 1) return;
+   LKL(lock_font_cache);
+}
+
+EAPI void
+evas_common_font_cache_unlock(void)
+{
+   if (initialised < 1) return;
+   LKU(lock_font_cache);
 }
 
 EAPI void
 evas_common_font_font_all_unload(void)
 {
+   evas_common_font_cache_lock();
    evas_common_font_all_clear();
+   evas_common_font_cache_unlock();
 }
 
 /* FIXME: This function should not be used. It's a short-cut fix that is meant
@@ -371,6 +398,7 @@ _glyph_free(RGBA_Font_Glyph *fg)
 
    if (fg->glyph_out)
      {
+        evas_common_font_glyph_atlas_free(fg);
         if ((fg->glyph_out->rle) && (fg->glyph_out->bitmap.rle_alloc))
           free(fg->glyph_out->rle);
         fg->glyph_out->rle = NULL;
@@ -460,16 +488,43 @@ _fash_gl_add(Fash_Glyph *fash, int item, RGBA_Font_Glyph *glyph)
    fash->bucket[grp]->bucket[maj]->item[min] = glyph;
 }
 
-EAPI RGBA_Font_Glyph *
-evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt idx)
+static FT_Error
+_glyph_load(RGBA_Font_Int *fi, FT_UInt idx, FT_Glyph *glyph)
 {
-   RGBA_Font_Glyph *fg;
    FT_Error error;
    const FT_Int32 hintflags[3] =
      { FT_LOAD_NO_HINTING, FT_LOAD_FORCE_AUTOHINT, FT_LOAD_NO_AUTOHINT };
    static FT_Matrix transform = {0x10000, _EVAS_FONT_SLANT_TAN * 0x10000,
         0x00000, 0x10000};
 
+   evas_common_font_int_reload(fi);
+   FTLOCK();
+   error = FT_Load_Glyph(fi->src->ft.face, idx,
+                         FT_LOAD_DEFAULT | FT_LOAD_NO_BITMAP |
+                         hintflags[fi->hinting]);
+   FTUNLOCK();
+   if (error) return error;
+
+   /* Transform the outline of Glyph according to runtime_rend. */
+   if (fi->runtime_rend & FONT_REND_SLANT)
+      FT_Outline_Transform(&fi->src->ft.face->glyph->outline, &transform);
+   /* Embolden the outline of Glyph according to rundtime_rend. */
+   if (fi->runtime_rend & FONT_REND_WEIGHT)
+      FT_GlyphSlot_Embolden(fi->src->ft.face->glyph);
+
+   FTLOCK();
+   error = FT_Get_Glyph(fi->src->ft.face->glyph, glyph);
+   FTUNLOCK();
+   return error;
+}
+
+EAPI RGBA_Font_Glyph *
+evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt idx)
+{
+   RGBA_Font_Glyph *fg;
+   FT_Glyph glyph;
+   FT_Error error;
+
    evas_common_font_int_promote(fi);
    if (fi->fash)
      {
@@ -498,12 +553,7 @@ evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt idx)
 //   fg = eina_hash_find(fi->glyphs, &hindex);
 //   if (fg) return fg;
 
-   evas_common_font_int_reload(fi);
-   FTLOCK();
-   error = FT_Load_Glyph(fi->src->ft.face, idx,
-                         FT_LOAD_DEFAULT | FT_LOAD_NO_BITMAP |
-                         hintflags[fi->hinting]);
-   FTUNLOCK();
+   error = _glyph_load(fi, idx, &glyph);
    if (error)
      {
         if (!fi->fash) fi->fash = _fash_gl_new();
@@ -511,26 +561,15 @@ evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt idx)
         return NULL;
      }
 
-   /* Transform the outline of Glyph according to runtime_rend. */
-   if (fi->runtime_rend & FONT_REND_SLANT)
-      FT_Outline_Transform(&fi->src->ft.face->glyph->outline, &transform);
-   /* Embolden the outline of Glyph according to rundtime_rend. */
-   if (fi->runtime_rend & FONT_REND_WEIGHT)
-      FT_GlyphSlot_Embolden(fi->src->ft.face->glyph);
-
    fg = calloc(1, sizeof(RGBA_Font_Glyph));
-   if (!fg) return NULL;
-
-   FTLOCK();
-   error = FT_Get_Glyph(fi->src->ft.face->glyph, &(fg->glyph));
-   FTUNLOCK();
-   if (error)
+   if (!fg)
      {
-        free(fg);
-        if (!fi->fash) fi->fash = _fash_gl_new();
-        if (fi->fash) _fash_gl_add(fi->fash, idx, (void *)(-1));
+        FTLOCK();
+        FT_Done_Glyph(glyph);
+        FTUNLOCK();
         return NULL;
      }
+   fg->glyph = glyph;
 
      {
         FT_BBox outbox;
@@ -558,6 +597,24 @@ evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt idx)
    return fg;
 }
 
+/* Compresses the bitmap into the glyph atlas and frees it. */
+static void
+_glyph_bitmap_store(RGBA_Font_Glyph *fg, FT_BitmapGlyph fbg)
+{
+   DATA8 *rle;
+   int size = 0;
+
+   rle = evas_common_font_glyph_compress
+   (fbg->bitmap.buffer, fbg->bitmap.num_grays, fbg->bitmap.pixel_mode,
+    fbg->bitmap.pitch, fbg->bitmap.width, fbg->bitmap.rows, &size);
+   fg->glyph_out->rle_size = size;
+   if (rle) evas_common_font_glyph_atlas_store(fg, rle, size);
+
+   // this may be technically incorrect as we go and free a bitmap buffer
+   // behind the ftglyph's back...
+   FT_Bitmap_Done(evas_ft_lib, &(fbg->bitmap));
+}
+
 EAPI Eina_Bool
 evas_common_font_int_cache_glyph_render(RGBA_Font_Glyph *fg)
 {
@@ -585,7 +642,35 @@ evas_common_font_int_cache_glyph_render(RGBA_Font_Glyph *fg)
 
    /* no cserve2 case */
    if (fg->glyph_out)
-     return EINA_TRUE;
+     {
+        FT_Glyph glyph;
+
+        if ((fg->glyph_out->rle) || (!fg->glyph_out->rle_size))
+          return EINA_TRUE;
+
+        /* the bitmap was dropped from the glyph atlas, render it again */
+        if (_glyph_load(fi, fg->index, &glyph)) goto on_error;
+        FTLOCK();
+        error = FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1);
+        if (error)
+          {
+             FT_Done_Glyph(glyph);
+             FTUNLOCK();
+             goto on_error;
+          }
+        FTUNLOCK();
+        _glyph_bitmap_store(fg, (FT_BitmapGlyph)glyph);
+        FTLOCK();
+        FT_Done_Glyph(glyph);
+        FTUNLOCK();
+        return EINA_TRUE;
+
+on_error:
+        if (!fi->fash) fi->fash = _fash_gl_new();
+        if (fi->fash) _fash_gl_add(fi->fash, fg->index, (void *)(-1));
+        _glyph_free(fg);
+        return EINA_FALSE;
+     }
 
    FTLOCK();
    error = FT_Glyph_To_Bitmap(&(fg->glyph), FT_RENDER_MODE_NORMAL, 0, 1);
@@ -606,8 +691,6 @@ evas_common_font_int_cache_glyph_render(RGBA_Font_Glyph *fg)
    fg->glyph_out->bitmap.rows = fbg->bitmap.rows;
    fg->glyph_out->bitmap.width = fbg->bitmap.width;
    fg->glyph_out->bitmap.pitch = fbg->bitmap.pitch;
-   fg->glyph_out->bitmap.buffer = fbg->bitmap.buffer;
-   fg->glyph_out->bitmap.rle_alloc = EINA_TRUE;
    
    /* This '+ 100' is just an estimation of how much memory freetype will use
     * on it's size. This value is not really used anywhere in code - it's
@@ -617,17 +700,8 @@ evas_common_font_int_cache_glyph_render(RGBA_Font_Glyph *fg)
    fi->usage += size;
    if (fi->inuse) evas_common_font_int_use_increase(size);
 
-   fg->glyph_out->rle = evas_common_font_glyph_compress
-   (fbg->bitmap.buffer, fbg->bitmap.num_grays, fbg->bitmap.pixel_mode,
-    fbg->bitmap.pitch, fbg->bitmap.width, fbg->bitmap.rows,
-    &(fg->glyph_out->rle_size));
+   _glyph_bitmap_store(fg, fbg);
 
-   fg->glyph_out->bitmap.buffer = NULL;
-
-   // this may be technically incorrect as we go and free a bitmap buffer
-   // behind the ftglyph's back...
-   FT_Bitmap_Done(evas_ft_lib, &(fbg->bitmap));
-   
    return EINA_TRUE;
 }
 
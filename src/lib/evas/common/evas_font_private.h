@@ -24,6 +24,72 @@ void evas_common_font_int_use_trim(void);
 void evas_common_font_int_unload(RGBA_Font_Int *fi);
 void evas_common_font_int_reload(RGBA_Font_Int *fi);
 
+void evas_common_font_glyph_atlas_init(void);
+void evas_common_font_glyph_atlas_shutdown(void);
+void evas_common_font_glyph_atlas_store(RGBA_Font_Glyph *fg, DATA8 *rle, int size);
+void evas_common_font_glyph_atlas_free(RGBA_Font_Glyph *fg);
+void evas_common_font_glyph_atlas_ref(RGBA_Font_Glyph *fg);
+void evas_common_font_glyph_atlas_unref(RGBA_Font_Glyph *fg);
+
+/* What the glyph atlas holds, and did since it was set up */
+typedef struct _Evas_Glyph_Atlas_Stats Evas_Glyph_Atlas_Stats;
+struct _Evas_Glyph_Atlas_Stats
+{
+   int usage; /* bytes held */
+   int size; /* budget in bytes */
+   int pages;
+   int lru; /* glyphs not drawn from any glyph array */
+   int stores; /* bitmaps rendered into it, the first time or again */
+   int drops; /* bitmaps dropped to stay in budget */
+   int pages_added;
+   int pages_freed;
+   int rows_reused; /* rows taken again after their bitmaps were gone */
+};
+
+EAPI void evas_common_font_glyph_atlas_stats_get(Evas_Glyph_Atlas_Stats *stats);
+
+/* The color of a run of glyphs multiplied by each of the 16 values of the
+ * compressed glyph masks, and the inverse alpha of each. */
+typedef struct _Evas_Glyph_Color Evas_Glyph_Color;
+struct _Evas_Glyph_Color
+{
+   DATA32 coltab[16];
+   DATA16 mtab[16];
+};
+
+/* Draws a compressed glyph at x, y, the part of it between x1, y1 and
+ * x2, y2 (relative to the glyph) */
+typedef void (*Evas_Glyph_Draw_Func)(RGBA_Font_Glyph_Out *fgo, const Evas_Glyph_Color *gc, DATA32 *dst, int dst_pitch, int x, int y, int x1, int y1, int x2, int y2);
+
+EAPI void evas_common_font_glyph_color_set(Evas_Glyph_Color *gc, DATA32 col);
+EAPI Evas_Glyph_Draw_Func evas_common_font_glyph_draw_cpu_get(int cpu);
+void evas_common_font_glyph_color_draw(RGBA_Font_Glyph *fg, const Evas_Glyph_Color *gc, RGBA_Draw_Context *dc, RGBA_Image *dst, int dst_pitch, int x, int y, int cx, int cy, int cw, int ch);
+
+#if defined(NEED_SSE3) && defined(BUILD_SSE3)
+/* Same as MUL_256() on 4 pixels, with the multipliers in 16bit words: 2
+ * per pixel, 1 for the rb and 1 for the ga channels. The avx2 expander
+ * uses it for the runs too short for 8 pixels. */
+static EFL_ALWAYS_INLINE __m128i
+glyph_mul_256_sse3(__m128i a, __m128i c)
+{
+   const __m128i rb_mask = _mm_set1_epi32(0x00ff00ff);
+   __m128i rb, ga;
+
+   rb = _mm_mullo_epi16(a, _mm_and_si128(c, rb_mask));
+   rb = _mm_srli_epi16(rb, 8);
+   ga = _mm_mullo_epi16(a, _mm_and_si128(_mm_srli_epi16(c, 8), rb_mask));
+   ga = _mm_andnot_si128(rb_mask, ga);
+   return _mm_or_si128(rb, ga);
+}
+#endif
+
+#ifdef BUILD_SSE3
+void evas_common_font_glyph_draw_sse3(RGBA_Font_Glyph_Out *fgo, const Evas_Glyph_Color *gc, DATA32 *dst, int dst_pitch, int x, int y, int x1, int y1, int x2, int y2);
+#endif
+#ifdef BUILD_AVX2
+void evas_common_font_glyph_draw_avx2(RGBA_Font_Glyph_Out *fgo, const Evas_Glyph_Color *gc, DATA32 *dst, int dst_pitch, int x, int y, int x1, int y1, int x2, int y2);
+#endif
+
 /* 6th bit is on is the same as frac part >= 0.5 */
 # define EVAS_FONT_ROUND_26_6_TO_INT(x) \
    (((x + 0x20) & -0x40) >> 6)
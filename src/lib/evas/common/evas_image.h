@@ -43,6 +43,10 @@ EAPI unsigned int evas_common_rgba_image_scalecache_size_get(void);
 EAPI void evas_common_rgba_image_scalecache_flush(void);
 EAPI void evas_common_rgba_image_scalecache_dump(void);
 EAPI void evas_common_rgba_image_scalecache_prune(void);
+EAPI Eina_Bool evas_common_rgba_image_scalecache_stats_get(Evas_Image_Scale_Cache_Stats *stats);
+EAPI void evas_common_rgba_image_scalecache_stats_reset(void);
+EAPI void evas_common_rgba_image_scalecache_adaptive_set(Eina_Bool adaptive);
+EAPI Eina_Bool evas_common_rgba_image_scalecache_adaptive_get(void);
 EAPI void
   evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst,
                                             RGBA_Draw_Context *dc, int smooth,
@@ -6,10 +6,26 @@ int             evas_common_rgba_image_from_copied_data      (Image_Entry* dst,
 int             evas_common_rgba_image_from_data             (Image_Entry* dst, unsigned int w, unsigned int h, DATA32 *image_data, int alpha, Evas_Colorspace cspace);
 int             evas_common_rgba_image_colorspace_set        (Image_Entry* dst, Evas_Colorspace cspace);
 
+typedef struct _ScaleitemKey ScaleitemKey;
+
+struct _ScaleitemKey
+{
+   int src_x, src_y;
+   unsigned int src_w, src_h;
+   unsigned int dst_w, dst_h;
+   Eina_Bool smooth : 1;
+};
+
 void evas_common_scalecache_init(void);
 void evas_common_scalecache_shutdown(void);
 void evas_common_rgba_image_scalecache_dirty(Image_Entry *ie);
 void evas_common_rgba_image_scalecache_orig_use(Image_Entry *ie);
 int evas_common_rgba_image_scalecache_usage_get(Image_Entry *ie);
 
+EAPI void evas_common_scalecache_disk_init(void);
+EAPI void evas_common_scalecache_disk_shutdown(void);
+EAPI Eina_Bool evas_common_scalecache_disk_enabled(void);
+EAPI RGBA_Image *evas_common_scalecache_disk_load(Image_Entry *ie, const ScaleitemKey *key);
+EAPI void evas_common_scalecache_disk_save(Image_Entry *ie, const ScaleitemKey *key, RGBA_Image *scaled);
+
 #endif /* _EVAS_IMAGE_PRIVATE_H */
@@ -7,6 +7,7 @@
 #endif
 
 #include <assert.h>
+#include <sys/time.h>
 
 #ifdef EVAS_CSERVE2
 #include "evas_cs2_private.h"
@@ -19,6 +20,7 @@
 
 #define MAX_SCALEITEMS 32
 #define MIN_SCALE_USES 3
+#define MAX_SCALE_USES 12
 //#define MIN_SCALE_AGE_GAP 5000
 #define MAX_SCALECACHE_DIM 3200
 #define FLOP_ADD 4
@@ -26,18 +28,13 @@
 #define FLOP_DEL 1
 #define SCALE_CACHE_SIZE 4 * 1024 * 1024
 //#define SCALE_CACHE_SIZE 0
+/* a copy has paid off once drawn that many times, and the number of uses
+ * needed to cache a scale is adapted after that many copies are judged */
+#define ADAPT_USEFUL_HITS 4
+#define ADAPT_WINDOW 32
 
-typedef struct _ScaleitemKey ScaleitemKey;
 typedef struct _Scaleitem Scaleitem;
 
-struct _ScaleitemKey
-{
-   int src_x, src_y;
-   unsigned int src_w, src_h;
-   unsigned int dst_w, dst_h;
-   Eina_Bool smooth : 1;   
-};
-
 struct _Scaleitem
 {
    EINA_INLIST;
@@ -47,11 +44,14 @@ struct _Scaleitem
    Eina_List *item;
    unsigned int flop;
    unsigned int size_adjust;
+   unsigned int hits;
 
    ScaleitemKey key;
 
    Eina_Bool forced_unload : 1;
    Eina_Bool populate_me : 1;
+   Eina_Bool disk_tried : 1;
+   Eina_Bool disk_save : 1;
 };
 
 #ifdef SCALECACHE
@@ -67,6 +67,13 @@ static unsigned int max_dimension = MAX_SCALECACHE_DIM;
 static unsigned int max_flop_count = MAX_FLOP_COUNT;
 static unsigned int max_scale_items = MAX_SCALEITEMS;
 static unsigned int min_scale_uses = MIN_SCALE_USES;
+
+static Evas_Image_Scale_Cache_Stats cache_stats;
+static Eina_Bool stats_print = EINA_FALSE;
+static Eina_Bool adaptive = EINA_FALSE;
+static unsigned int scale_uses = MIN_SCALE_USES;
+static unsigned int adapt_useful = 0;
+static unsigned int adapt_wasted = 0;
 #endif
 
 static int
@@ -132,6 +139,15 @@ evas_common_scalecache_init(void)
    if (s) max_scale_items = atoi(s);
    s = getenv("EVAS_SCALECACHE_MIN_USES");
    if (s) min_scale_uses = atoi(s);
+   s = getenv("EVAS_SCALECACHE_ADAPTIVE");
+   if (s) adaptive = !!atoi(s);
+   s = getenv("EVAS_SCALECACHE_STATS");
+   if (s) stats_print = !!atoi(s);
+   scale_uses = min_scale_uses;
+   adapt_useful = 0;
+   adapt_wasted = 0;
+   memset(&cache_stats, 0, sizeof(cache_stats));
+   evas_common_scalecache_disk_init();
 #endif
 }
 
@@ -141,7 +157,16 @@ evas_common_scalecache_shutdown(void)
 #ifdef SCALECACHE
    init--;
    if (init ==0)
-      SLKD(cache_lock);
+     {
+        if (stats_print)
+          INF("scalecache: %llu hits, %llu misses, %llu populates, "
+              "%llu evictions, %u bytes, %u min uses, %.3fs scaling",
+              cache_stats.hits, cache_stats.misses,
+              cache_stats.populates, cache_stats.evictions,
+              cache_size, scale_uses, cache_stats.scale_time);
+        evas_common_scalecache_disk_shutdown();
+        SLKD(cache_lock);
+     }
 #endif
 }
 
@@ -273,6 +298,48 @@ evas_common_rgba_image_scalecache_item_unref(Image_Entry *scie)
 }
 
 #ifdef SCALECACHE
+static double
+_scale_time_get(void)
+{
+   struct timeval tv;
+
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + (tv.tv_usec / 1000000.0);
+}
+
+/* called with cache_lock held, once per copy: when it was drawn enough
+ * to pay off, or when it is evicted before that. If most copies are
+ * wasted, scales must be used more before being cached, if nearly none
+ * is, they can be cached sooner. */
+static void
+_adapt_outcome(Eina_Bool useful)
+{
+   if (!adaptive) return;
+   if (useful) adapt_useful++;
+   else adapt_wasted++;
+   if ((adapt_useful + adapt_wasted) < ADAPT_WINDOW) return;
+
+   if (adapt_wasted > adapt_useful)
+     {
+        if (scale_uses < MAX_SCALE_USES) scale_uses++;
+     }
+   else if ((adapt_wasted * 8) < ADAPT_WINDOW)
+     {
+        if (scale_uses > 1) scale_uses--;
+     }
+   adapt_useful = 0;
+   adapt_wasted = 0;
+}
+
+/* called with cache_lock held when a copy is dropped to make room for a
+ * new one */
+static void
+_sci_evicted(Scaleitem *sci)
+{
+   cache_stats.evictions++;
+   if (sci->hits < ADAPT_USEFUL_HITS) _adapt_outcome(EINA_FALSE);
+}
+
 static void
 _sci_fix_newest(RGBA_Image *im)
 {
@@ -343,6 +410,7 @@ _sci_find(RGBA_Image *im,
                cache_size -= sci->key.dst_w * sci->key.dst_h * 4;
              else
                cache_size -= sci->size_adjust;
+             _sci_evicted(sci);
 //             INF(" 1- %i", sci->dst_w * sci->dst_h * 4);
              cache_list = eina_inlist_remove(cache_list, (Eina_Inlist *)sci);
           }
@@ -360,7 +428,10 @@ try_alloc:
      }
    sci->usage = 0;
    sci->usage_count = 0;
+   sci->hits = 0;
    sci->populate_me = 0;
+   sci->disk_tried = 0;
+   sci->disk_save = 0;
    sci->key.smooth = smooth;
    sci->forced_unload = 0;
    sci->flop = 0;
@@ -383,8 +454,10 @@ try_alloc:
    return sci;
 }
 
+/* admit is set when making room for a new copy, the copies dropped then
+ * count as evictions, unlike those dropped by a flush or a smaller limit */
 static void
-_cache_prune(Scaleitem *notsci, Eina_Bool copies_only)
+_cache_prune(Scaleitem *notsci, Eina_Bool copies_only, Eina_Bool admit)
 {
    Eina_Inlist *next;
 
@@ -424,6 +497,7 @@ _cache_prune(Scaleitem *notsci, Eina_Bool copies_only)
           cache_size -= sci->key.dst_w * sci->key.dst_h * 4;
         else
           cache_size -= sci->size_adjust;
+        if (admit) _sci_evicted(sci);
 
         cache_list = eina_inlist_remove(cache_list, EINA_INLIST_GET(sci));
         memset(sci, 0, sizeof(Eina_Inlist));
@@ -439,7 +513,7 @@ evas_common_rgba_image_scalecache_size_set(unsigned int size)
    if (size != max_cache_size)
      {
         max_cache_size = size;
-        _cache_prune(NULL, 1);
+        _cache_prune(NULL, 1, EINA_FALSE);
      }
    SLKU(cache_lock);
 #endif   
@@ -464,7 +538,7 @@ evas_common_rgba_image_scalecache_prune(void)
 {
 #ifdef SCALECACHE
    SLKL(cache_lock);
-   _cache_prune(NULL, 0);
+   _cache_prune(NULL, 0, EINA_FALSE);
    SLKU(cache_lock);
 #endif
 }
@@ -477,7 +551,7 @@ evas_common_rgba_image_scalecache_dump(void)
    SLKL(cache_lock);
    t = max_cache_size;
    max_cache_size = 0;
-   _cache_prune(NULL, 0);
+   _cache_prune(NULL, 0, EINA_FALSE);
    max_cache_size = t;
    SLKU(cache_lock);
 #endif   
@@ -491,12 +565,69 @@ evas_common_rgba_image_scalecache_flush(void)
    SLKL(cache_lock);
    t = max_cache_size;
    max_cache_size = 0;
-   _cache_prune(NULL, 1);
+   _cache_prune(NULL, 1, EINA_FALSE);
    max_cache_size = t;
    SLKU(cache_lock);
 #endif   
 }
 
+EAPI Eina_Bool
+evas_common_rgba_image_scalecache_stats_get(Evas_Image_Scale_Cache_Stats *stats)
+{
+#ifdef SCALECACHE
+   if (!init) return EINA_FALSE;
+   SLKL(cache_lock);
+   *stats = cache_stats;
+   stats->size = cache_size;
+   stats->max_size = max_cache_size;
+   stats->items = eina_inlist_count(cache_list);
+   stats->min_uses = scale_uses;
+   SLKU(cache_lock);
+   return EINA_TRUE;
+#else
+   return EINA_FALSE;
+#endif
+}
+
+EAPI void
+evas_common_rgba_image_scalecache_stats_reset(void)
+{
+#ifdef SCALECACHE
+   if (!init) return;
+   SLKL(cache_lock);
+   memset(&cache_stats, 0, sizeof(cache_stats));
+   SLKU(cache_lock);
+#endif
+}
+
+EAPI void
+evas_common_rgba_image_scalecache_adaptive_set(Eina_Bool on)
+{
+#ifdef SCALECACHE
+   if (!init)
+     {
+        adaptive = !!on;
+        return;
+     }
+   SLKL(cache_lock);
+   adaptive = !!on;
+   if (!adaptive) scale_uses = min_scale_uses;
+   adapt_useful = 0;
+   adapt_wasted = 0;
+   SLKU(cache_lock);
+#endif
+}
+
+EAPI Eina_Bool
+evas_common_rgba_image_scalecache_adaptive_get(void)
+{
+#ifdef SCALECACHE
+   return adaptive;
+#else
+   return EINA_FALSE;
+#endif
+}
+
 EAPI void
 evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst EINA_UNUSED,
                                           RGBA_Draw_Context *dc, int smooth,
@@ -589,7 +720,7 @@ evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst EINA_
 //          src_region_x, src_region_y, src_region_w, src_region_h,
 //          dst_region_x, dst_region_y, dst_region_w, dst_region_h,
 //          smooth);
-   if ((sci->usage >= min_scale_uses)
+   if ((sci->usage >= scale_uses)
        && (ie->scale_hint != EVAS_IMAGE_SCALE_HINT_DYNAMIC)
 //       && (sci->usage_count > (use_counter - MIN_SCALE_AGE_GAP))
        )
@@ -629,15 +760,18 @@ evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst EINA_
 //static int noscales = 0;
 #endif
 
-EAPI Eina_Bool
-evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
-                                         RGBA_Draw_Context *dc, int smooth,
-                                         int src_region_x, int src_region_y,
-                                         int src_region_w, int src_region_h,
-                                         int dst_region_x, int dst_region_y,
-                                         int dst_region_w, int dst_region_h,
-                                         Evas_Common_Scale_In_To_Out_Clip_Cb cb_sample,
-                                         Evas_Common_Scale_In_To_Out_Clip_Cb cb_smooth)
+/* sync is set when the callbacks draw right away, and not from the render
+ * thread later on */
+static Eina_Bool
+_evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
+                                          RGBA_Draw_Context *dc, int smooth,
+                                          int src_region_x, int src_region_y,
+                                          int src_region_w, int src_region_h,
+                                          int dst_region_x, int dst_region_y,
+                                          int dst_region_w, int dst_region_h,
+                                          Evas_Common_Scale_In_To_Out_Clip_Cb cb_sample,
+                                          Evas_Common_Scale_In_To_Out_Clip_Cb cb_smooth,
+                                          Eina_Bool sync)
 {
 #ifdef SCALECACHE
    RGBA_Image *im = (RGBA_Image *)ie;
@@ -686,6 +820,7 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
    sci = _sci_find(im, dc, smooth,
                    src_region_x, src_region_y, src_region_w, src_region_h,
                    dst_region_w, dst_region_h);
+   if (!sci) cache_stats.misses++;
    SLKU(cache_lock);
    if (!sci)
      {
@@ -719,6 +854,31 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
         return EINA_FALSE;
      }
    SLKL(im->cache.lock);
+   /* a copy scaled by an earlier run saves scaling the image again, the
+    * engine has loaded its original pixels already */
+   if ((!sci->im) && (!sci->populate_me) && (!sci->disk_tried) &&
+       (evas_common_scalecache_disk_enabled()) &&
+       (ie->scale_hint != EVAS_IMAGE_SCALE_HINT_DYNAMIC) &&
+       (sci->key.dst_w < max_dimension) &&
+       (sci->key.dst_h < max_dimension) &&
+       ((cache_size + (sci->key.dst_w * sci->key.dst_h * 4)) <= max_cache_size))
+     {
+        RGBA_Image *im2;
+
+        sci->disk_tried = 1;
+        im2 = evas_common_scalecache_disk_load(ie, &sci->key);
+        if (im2)
+          {
+             SLKL(cache_lock);
+             sci->im = im2;
+             sci->hits = 0;
+             cache_stats.populates++;
+             cache_size += sci->key.dst_w * sci->key.dst_h * 4;
+             cache_list = eina_inlist_append(cache_list, (Eina_Inlist *)sci);
+             SLKU(cache_lock);
+             didpop = 1;
+          }
+     }
    if (sci->populate_me)
      {
         int size, osize, used;
@@ -752,6 +912,20 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
         else
           {
              size *= sizeof(DATA32);
+             /* when adaptive, make room from the least recently used
+              * copies, how many of them were wasted tells how picky to be */
+             if ((adaptive) && ((cache_size + size) > max_cache_size) &&
+                 ((unsigned int)size <= max_cache_size))
+               {
+                  unsigned int t;
+
+                  SLKL(cache_lock);
+                  t = max_cache_size;
+                  max_cache_size -= size;
+                  _cache_prune(sci, 0, EINA_TRUE);
+                  max_cache_size = t;
+                  SLKU(cache_lock);
+               }
              if ((cache_size + size) > max_cache_size)
                {
                   sci->populate_me = 0;
@@ -814,6 +988,9 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
              evas_common_image_colorspace_normalize(im);
              if (im->image.data)
                {
+                  double t = 0.0;
+
+                  if (sync) t = _scale_time_get();
                   if (smooth)
                     ret = cb_smooth(im, sci->im, ct,
                                     src_region_x, src_region_y,
@@ -826,7 +1003,9 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
                                     src_region_w, src_region_h,
                                     0, 0,
                                     dst_region_w, dst_region_h);
+                  if (sync) cache_stats.scale_time += _scale_time_get() - t;
                   sci->populate_me = 0;
+                  sci->disk_save = evas_common_scalecache_disk_enabled();
 #if 0 // visual debug of cached images
                     {
                        int xx, yy;
@@ -861,6 +1040,8 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
                {
                   cache_size += sci->key.dst_w * sci->key.dst_h * 4;
                }
+             sci->hits = 0;
+             cache_stats.populates++;
 //             INF(" + %i @ flop: %i (%ix%i)",
 //                    sci->dst_w * sci->dst_h * 4, sci->flop,
 //                    sci->dst_w, sci->dst_h);
@@ -876,12 +1057,23 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
 	     SLKL(cache_lock);
              cache_list = eina_inlist_remove(cache_list, (Eina_Inlist *)sci);
              cache_list = eina_inlist_append(cache_list, (Eina_Inlist *)sci);
+             cache_stats.hits++;
+             if (++sci->hits == ADAPT_USEFUL_HITS) _adapt_outcome(EINA_TRUE);
 	     SLKU(cache_lock);
           }
         else
           {
              if (sci->flop >= FLOP_DEL) sci->flop -= FLOP_DEL;
           }
+        /* when drawing from the render thread, a copy just populated is
+         * only filled once that thread gets to it, so it is written on its
+         * next use. Only the pixels are copied here, the file is written
+         * by a preload thread. */
+        if ((sci->disk_save) && ((sync) || (!didpop)))
+          {
+             sci->disk_save = 0;
+             evas_common_scalecache_disk_save(ie, &sci->key, sci->im);
+          }
 //        INF("use cached!");
         SLKU(im->cache.lock);
         ret |= cb_sample(sci->im, dst, dc,
@@ -943,6 +1135,9 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
 //        misses++;
         if (im->image.data)
           {
+             double t = 0.0;
+
+             if (sync) t = _scale_time_get();
              if (smooth)
                ret |= cb_smooth(im, dst, dc,
                                 src_region_x, src_region_y,
@@ -955,6 +1150,11 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
                                src_region_w, src_region_h,
                                dst_region_x, dst_region_y,
                                dst_region_w, dst_region_h);
+             if (sync) t = _scale_time_get() - t;
+             SLKL(cache_lock);
+             cache_stats.misses++;
+             cache_stats.scale_time += t;
+             SLKU(cache_lock);
           }
      }
 
@@ -995,6 +1195,23 @@ evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
 }
 
 
+EAPI Eina_Bool
+evas_common_rgba_image_scalecache_do_cbs(Image_Entry *ie, RGBA_Image *dst,
+                                         RGBA_Draw_Context *dc, int smooth,
+                                         int src_region_x, int src_region_y,
+                                         int src_region_w, int src_region_h,
+                                         int dst_region_x, int dst_region_y,
+                                         int dst_region_w, int dst_region_h,
+                                         Evas_Common_Scale_In_To_Out_Clip_Cb cb_sample,
+                                         Evas_Common_Scale_In_To_Out_Clip_Cb cb_smooth)
+{
+   return _evas_common_rgba_image_scalecache_do_cbs(
+     ie, dst, dc, smooth,
+     src_region_x, src_region_y, src_region_w, src_region_h,
+     dst_region_x, dst_region_y, dst_region_w, dst_region_h,
+     cb_sample, cb_smooth, EINA_FALSE);
+}
+
 EAPI void
 evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
                                      RGBA_Draw_Context *dc, int smooth,
@@ -1003,11 +1220,12 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
                                      int dst_region_x, int dst_region_y,
                                      int dst_region_w, int dst_region_h)
 {
-   evas_common_rgba_image_scalecache_do_cbs(
+   _evas_common_rgba_image_scalecache_do_cbs(
      ie, dst, dc, smooth,
      src_region_x, src_region_y, src_region_w, src_region_h,
      dst_region_x, dst_region_y, dst_region_w, dst_region_h,
      evas_common_scale_rgba_in_to_out_clip_sample,
-     evas_common_scale_rgba_in_to_out_clip_smooth);
+     evas_common_scale_rgba_in_to_out_clip_smooth,
+     EINA_TRUE);
    evas_common_rgba_image_scalecache_prune();
 }
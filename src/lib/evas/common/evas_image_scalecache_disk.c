@@ -0,0 +1,397 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#ifdef HAVE_EVIL
+# include <Evil.h>
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "evas_common_private.h"
+#include "evas_private.h"
+#include "evas_image_private.h"
+
+/* Scaled copies of images loaded from files can also be kept on disk, so
+ * that they survive a restart. Each one is a small eet file in the cache
+ * directory, named after a hash of its description: the source image
+ * (file, key and load options, size and modification time) and the scale
+ * (source region, destination size, smooth or not). The file holds that
+ * description, to tell hash collisions apart, and the scaled pixels stored
+ * uncompressed, so reading them back is a copy out of the mapped file.
+ *
+ * The modification time of a file is the time it was last used. When the
+ * directory grows over its size limit, the least recently used files are
+ * removed until it is back under 3/4 of the limit. Writes go through a
+ * temporary file renamed into place, so several processes can share the
+ * same directory. They are done by the preload threads, on a copy of the
+ * pixels, so the drawing never waits for the disk nor for a scan of the
+ * directory.
+ *
+ * The cache is off unless EVAS_SCALECACHE_DISK_DIR is set, its size in KB
+ * is taken from EVAS_SCALECACHE_DISK_SIZE. */
+
+#define DISK_CACHE_SIZE (64 * 1024)
+
+typedef struct _Disk_Entry Disk_Entry;
+struct _Disk_Entry
+{
+   char *path;
+   off_t size;
+   time_t mtime;
+};
+
+typedef struct _Disk_Save Disk_Save;
+struct _Disk_Save
+{
+   Eina_Strbuf *key;
+   char *path;
+   DATA32 *pixels;
+   unsigned int w, h;
+   Eina_Bool alpha : 1;
+};
+
+static Eina_Lock disk_lock;
+static Eina_Condition disk_cond;
+static unsigned int disk_pending = 0;
+static char *disk_dir = NULL;
+static unsigned long long disk_size = 0;
+static unsigned long long disk_max_size = DISK_CACHE_SIZE * 1024ULL;
+static unsigned int disk_tmp_count = 0;
+static int disk_init = 0;
+
+static int
+_disk_entry_cmp(const void *a, const void *b)
+{
+   const Disk_Entry *e1 = a;
+   const Disk_Entry *e2 = b;
+
+   if (e1->mtime < e2->mtime) return -1;
+   if (e1->mtime > e2->mtime) return 1;
+   return 0;
+}
+
+/* called with disk_lock held, scans the directory to know its real size
+ * (other processes may share it) and removes the oldest entries if needed */
+static void
+_disk_evict(void)
+{
+   Eina_Inarray entries;
+   Eina_Iterator *it;
+   const Eina_File_Direct_Info *info;
+   Disk_Entry *e;
+   unsigned long long total = 0;
+   struct stat st;
+
+   it = eina_file_direct_ls(disk_dir);
+   if (!it) return;
+
+   eina_inarray_step_set(&entries, sizeof (Eina_Inarray), sizeof (Disk_Entry), 64);
+   EINA_ITERATOR_FOREACH(it, info)
+     {
+        Disk_Entry de;
+
+        if (info->type != EINA_FILE_REG) continue;
+        if (!eina_str_has_extension(info->path, ".eet")) continue;
+        if (stat(info->path, &st) < 0) continue;
+
+        de.path = strdup(info->path);
+        de.size = st.st_size;
+        de.mtime = st.st_mtime;
+        if (!de.path) continue;
+        if (eina_inarray_push(&entries, &de) < 0)
+          {
+             free(de.path);
+             continue;
+          }
+        total += st.st_size;
+     }
+   eina_iterator_free(it);
+
+   if (total > disk_max_size)
+     {
+        eina_inarray_sort(&entries, _disk_entry_cmp);
+        EINA_INARRAY_FOREACH(&entries, e)
+          {
+             if (total <= (disk_max_size / 4) * 3) break;
+             if (unlink(e->path) < 0) continue;
+             total -= e->size;
+          }
+     }
+
+   EINA_INARRAY_FOREACH(&entries, e)
+     free(e->path);
+   eina_inarray_flush(&entries);
+
+   disk_size = total;
+}
+
+static Eina_Strbuf *
+_disk_key_get(Image_Entry *ie, const ScaleitemKey *key)
+{
+   Eina_Strbuf *buf;
+
+   if ((!ie->file) || (!ie->cache_key)) return NULL;
+   if ((ie->flags.dirty) || (ie->animated.animated)) return NULL;
+   if (ie->space != EVAS_COLORSPACE_ARGB8888) return NULL;
+
+   buf = eina_strbuf_new();
+   if (!buf) return NULL;
+
+   eina_strbuf_append_printf(buf, "%s\n%lli:%lli:%ux%u:%i\n%i,%i %ux%u -> %ux%u:%i",
+                             ie->cache_key,
+                             (long long)ie->tstamp.mtime,
+                             (long long)ie->tstamp.size,
+                             ie->w, ie->h, !!ie->flags.alpha,
+                             key->src_x, key->src_y, key->src_w, key->src_h,
+                             key->dst_w, key->dst_h, !!key->smooth);
+   return buf;
+}
+
+static char *
+_disk_path_get(const Eina_Strbuf *key)
+{
+   const char *s = eina_strbuf_string_get(key);
+   int len = eina_strbuf_length_get(key);
+   char *path;
+
+   /* the names must be the same from one run to the next, so the seeded
+    * hashes are of no use here */
+   path = malloc(strlen(disk_dir) + 1 + 16 + 4 + 1);
+   if (!path) return NULL;
+   sprintf(path, "%s/%08x%08x.eet", disk_dir,
+           (unsigned int)eina_hash_superfast(s, len),
+           (unsigned int)eina_hash_superfast(s + (len / 2), len - (len / 2)));
+   return path;
+}
+
+EAPI void
+evas_common_scalecache_disk_init(void)
+{
+   const char *s;
+
+   if (disk_init++) return;
+
+   s = getenv("EVAS_SCALECACHE_DISK_DIR");
+   if ((!s) || (!s[0])) return;
+
+   if ((mkdir(s, S_IRWXU) < 0) && (errno != EEXIST))
+     {
+        ERR("Could not create the scale cache directory '%s': %s",
+            s, strerror(errno));
+        return;
+     }
+
+   eina_lock_new(&disk_lock);
+   eina_condition_new(&disk_cond, &disk_lock);
+   disk_dir = strdup(s);
+   s = getenv("EVAS_SCALECACHE_DISK_SIZE");
+   if (s) disk_max_size = atoi(s) * 1024ULL;
+
+   eina_lock_take(&disk_lock);
+   _disk_evict();
+   eina_lock_release(&disk_lock);
+}
+
+EAPI void
+evas_common_scalecache_disk_shutdown(void)
+{
+   if (--disk_init) return;
+   if (!disk_dir) return;
+
+   /* the writes still queued or running use the directory */
+   eina_lock_take(&disk_lock);
+   while (disk_pending)
+     eina_condition_wait(&disk_cond);
+   eina_lock_release(&disk_lock);
+
+   free(disk_dir);
+   disk_dir = NULL;
+   disk_size = 0;
+   disk_max_size = DISK_CACHE_SIZE * 1024ULL;
+   eina_condition_free(&disk_cond);
+   eina_lock_free(&disk_lock);
+}
+
+EAPI Eina_Bool
+evas_common_scalecache_disk_enabled(void)
+{
+   return !!disk_dir;
+}
+
+EAPI RGBA_Image *
+evas_common_scalecache_disk_load(Image_Entry *ie, const ScaleitemKey *key)
+{
+   RGBA_Image *im = NULL;
+   Eina_Strbuf *buf;
+   Eet_File *ef;
+   char *path = NULL;
+   const char *stored;
+   unsigned int w, h;
+   int alpha, compress, quality, size;
+   Eet_Image_Encoding lossy;
+
+   if (!disk_dir) return NULL;
+
+   buf = _disk_key_get(ie, key);
+   if (!buf) return NULL;
+   path = _disk_path_get(buf);
+   if (!path) goto on_error;
+
+   ef = eet_open(path, EET_FILE_MODE_READ);
+   if (!ef) goto on_error;
+
+   stored = eet_read_direct(ef, "key", &size);
+   if ((!stored) || (size != (int)eina_strbuf_length_get(buf) + 1) ||
+       (memcmp(stored, eina_strbuf_string_get(buf), size)))
+     goto on_close;
+
+   if (!eet_data_image_header_read(ef, "image", &w, &h,
+                                   &alpha, &compress, &quality, &lossy))
+     goto on_close;
+   if ((w != key->dst_w) || (h != key->dst_h) ||
+       (!alpha != !ie->flags.alpha))
+     goto on_close;
+
+   im = evas_common_image_new(w, h, alpha);
+   if (!im) goto on_close;
+   if (!eet_data_image_read_to_surface(ef, "image", 0, 0,
+                                       im->image.data, w, h, w * 4,
+                                       &alpha, &compress, &quality, &lossy))
+     {
+        evas_common_rgba_image_free(&im->cache_entry);
+        im = NULL;
+        goto on_close;
+     }
+
+   /* the last use of an entry is the modification time of its file */
+   utime(path, NULL);
+
+ on_close:
+   eet_close(ef);
+ on_error:
+   free(path);
+   eina_strbuf_free(buf);
+   return im;
+}
+
+/* the job is over once written or dropped, whatever is left to run for
+ * it on the main loop may never be */
+static void
+_disk_save_done(Disk_Save *ds)
+{
+   eina_lock_take(&disk_lock);
+   disk_pending--;
+   eina_condition_broadcast(&disk_cond);
+   eina_lock_release(&disk_lock);
+
+   eina_strbuf_free(ds->key);
+   free(ds->path);
+   free(ds->pixels);
+   free(ds);
+}
+
+/* run by a preload thread */
+static void
+_disk_save_heavy(void *data)
+{
+   Disk_Save *ds = data;
+   Eet_File *ef;
+   char *tmp;
+   struct stat st;
+   unsigned int n;
+
+   eina_lock_take(&disk_lock);
+   n = disk_tmp_count++;
+   eina_lock_release(&disk_lock);
+
+   tmp = malloc(strlen(ds->path) + 32);
+   if (!tmp) goto on_error;
+   sprintf(tmp, "%s.%i.%u.tmp", ds->path, (int)getpid(), n);
+
+   ef = eet_open(tmp, EET_FILE_MODE_WRITE);
+   if (!ef) goto on_error;
+
+   eet_write(ef, "key", eina_strbuf_string_get(ds->key),
+             eina_strbuf_length_get(ds->key) + 1, 0);
+   if (!eet_data_image_write(ef, "image", ds->pixels, ds->w, ds->h,
+                             ds->alpha, 0, 0, EET_IMAGE_LOSSLESS))
+     {
+        eet_close(ef);
+        unlink(tmp);
+        goto on_error;
+     }
+   if ((eet_close(ef) != EET_ERROR_NONE) ||
+       (stat(tmp, &st) < 0) ||
+       (rename(tmp, ds->path) < 0))
+     {
+        unlink(tmp);
+        goto on_error;
+     }
+
+   eina_lock_take(&disk_lock);
+   disk_size += st.st_size;
+   if (disk_size > disk_max_size) _disk_evict();
+   eina_lock_release(&disk_lock);
+
+ on_error:
+   free(tmp);
+   _disk_save_done(ds);
+}
+
+static void
+_disk_save_end(void *data EINA_UNUSED)
+{
+}
+
+static void
+_disk_save_cancel(void *data)
+{
+   /* not run, dropped by the preload shutdown */
+   _disk_save_done(data);
+}
+
+EAPI void
+evas_common_scalecache_disk_save(Image_Entry *ie, const ScaleitemKey *key, RGBA_Image *scaled)
+{
+   Disk_Save *ds;
+   size_t size;
+
+   if (!disk_dir) return;
+   if (!scaled->image.data) return;
+   size = (size_t)key->dst_w * key->dst_h * sizeof (DATA32);
+   /* an entry that would not fit alone is not worth writing */
+   if (size > (disk_max_size / 4) * 3) return;
+
+   ds = calloc(1, sizeof (Disk_Save));
+   if (!ds) return;
+   ds->key = _disk_key_get(ie, key);
+   if (!ds->key) goto on_error;
+   ds->path = _disk_path_get(ds->key);
+   if (!ds->path) goto on_error;
+   /* the scaled copy can be dropped from the cache before it is written */
+   ds->pixels = malloc(size);
+   if (!ds->pixels) goto on_error;
+   memcpy(ds->pixels, scaled->image.data, size);
+   ds->w = key->dst_w;
+   ds->h = key->dst_h;
+   ds->alpha = !!scaled->cache_entry.flags.alpha;
+
+   eina_lock_take(&disk_lock);
+   disk_pending++;
+   eina_lock_release(&disk_lock);
+
+   evas_preload_thread_run(_disk_save_heavy, _disk_save_end,
+                           _disk_save_cancel, ds);
+   return;
+
+ on_error:
+   if (ds->key) eina_strbuf_free(ds->key);
+   free(ds->path);
+   free(ds);
+}
@@ -0,0 +1,128 @@
+/* blend mask x color -> dst */
+
+#ifdef BUILD_AVX2
+
+static void
+_op_blend_mas_c_dp_avx2(DATA32 *s EINA_UNUSED, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(c);
+   int alpha = 256 - (c >> 24);
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         DATA32 a = *m;
+         switch(a)
+           {
+           case 0:
+              break;
+           case 255:
+              *d = c + MUL_256(alpha, *d);
+              break;
+           default:
+                {
+                   DATA32 mc = MUL_SYM(a, c);
+                   a = 256 - (mc >> 24);
+                   *d = mc + MUL_256(a, *d);
+                }
+              break;
+           }
+         m++; d++; l--;
+      },
+      { /* A8OP */
+
+         /* the whole span is often left untouched by the mask */
+         __m128i m8 = _mm_loadl_epi64((__m128i *)m);
+
+         if (_mm_testz_si128(m8, m8))
+           {
+              m += 8; d += 8; l -= 8;
+              continue;
+           }
+
+         __m256i m0 = _mm256_cvtepu8_epi32(m8);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         /* exact for all mask values, 0 leaves d as it is */
+         m0 = mul_sym_avx2(m0, c0);
+         d0 = _mm256_add_epi32(m0, mul_256_avx2(sub4_alpha_avx2(m0), d0));
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         m += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_blend_mas_can_dp_avx2(DATA32 *s EINA_UNUSED, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(c);
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i one = _mm256_set1_epi32(1);
+   int alpha;
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         alpha = *m;
+         switch(alpha)
+           {
+           case 0:
+              break;
+           case 255:
+              *d = c;
+              break;
+           default:
+              alpha++;
+              *d = INTERP_256(alpha, c, *d);
+              break;
+           }
+         m++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m128i m8 = _mm_loadl_epi64((__m128i *)m);
+
+         if (_mm_testz_si128(m8, m8))
+           {
+              m += 8; d += 8; l -= 8;
+              continue;
+           }
+
+         __m256i m0 = _mm256_cvtepu8_epi32(m8);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+         __m256i zmask0 = _mm256_cmpeq_epi32(m0, zero);
+
+         /* a mask of 255 gives c, keep d where the mask is 0 */
+         m0 = interp_256_avx2(_mm256_add_epi32(m0, one), c0, d0);
+         d0 = _mm256_blendv_epi8(m0, d0, zmask0);
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         m += 8; d += 8; l -= 8;
+      })
+}
+
+#define _op_blend_mas_cn_dp_avx2 _op_blend_mas_can_dp_avx2
+#define _op_blend_mas_caa_dp_avx2 _op_blend_mas_c_dp_avx2
+
+#define _op_blend_mas_c_dpan_avx2 _op_blend_mas_c_dp_avx2
+#define _op_blend_mas_cn_dpan_avx2 _op_blend_mas_cn_dp_avx2
+#define _op_blend_mas_can_dpan_avx2 _op_blend_mas_can_dp_avx2
+#define _op_blend_mas_caa_dpan_avx2 _op_blend_mas_caa_dp_avx2
+
+static void
+init_blend_mask_color_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP][CPU_AVX2] = _op_blend_mas_c_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_mas_cn_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AN][DP][CPU_AVX2] = _op_blend_mas_can_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP][CPU_AVX2] = _op_blend_mas_caa_dp_avx2;
+
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP_AN][CPU_AVX2] = _op_blend_mas_c_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_mas_cn_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AN][DP_AN][CPU_AVX2] = _op_blend_mas_can_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP_AN][CPU_AVX2] = _op_blend_mas_caa_dpan_avx2;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#define NEED_AVX2 1
+
+#include "evas_common_private.h"
+
+extern RGBA_Gfx_Func     op_blend_span_funcs[SP_LAST][SM_LAST][SC_LAST][DP_LAST][CPU_LAST];
+
+# include "op_blend_pixel_avx2.c"
+# include "op_blend_color_avx2.c"
+# include "op_blend_pixel_color_avx2.c"
+# include "op_blend_pixel_mask_avx2.c"
+# include "op_blend_mask_color_avx2.c"
+
+void
+evas_common_op_blend_init_avx2(void)
+{
+#ifdef BUILD_AVX2
+   init_blend_pixel_span_funcs_avx2();
+   init_blend_pixel_color_span_funcs_avx2();
+   init_blend_pixel_mask_span_funcs_avx2();
+   init_blend_color_span_funcs_avx2();
+   init_blend_mask_color_span_funcs_avx2();
+#endif
+}
+
+void
+evas_common_op_avx2_test(void)
+{
+#ifdef BUILD_AVX2
+   DATA32 s[64] = {0x11883399}, d[64] = {0xff88cc33};
+
+   s[0] = rand(); d[1] = rand();
+   _op_blend_pas_dp_avx2(s, NULL, 0, d, 64);
+#endif
+}
@@ -0,0 +1,207 @@
+/* blend pixel x color --> dst */
+
+#ifdef BUILD_AVX2
+
+static void
+_op_blend_p_c_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(c);
+   int alpha;
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         DATA32 sc = MUL4_SYM(c, *s);
+         alpha = 256 - (sc >> 24);
+         *d = sc + MUL_256(alpha, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         s0 = mul4_sym_avx2(c0, s0);
+         d0 = _mm256_add_epi32(s0, mul_256_avx2(sub4_alpha_avx2(s0), d0));
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_blend_pan_c_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   int alpha = 256 - (c >> 24);
+   const __m256i c0 = _mm256_set1_epi32(c);
+   const __m256i ca0 = _mm256_set1_epi32(c & 0xff000000);
+   const __m256i a0 = _mm256_set1_epi32(alpha);
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         *d = ((c & 0xff000000) + MUL3_SYM(c, *s)) + MUL_256(alpha, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         s0 = _mm256_add_epi32(ca0, mul3_sym_avx2(c0, s0));
+         d0 = _mm256_add_epi32(s0, mul_256_avx2(a0, d0));
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_blend_p_can_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(c);
+   const __m256i a_mask = _mm256_set1_epi32(0xff000000);
+   int alpha;
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         alpha = 256 - (*s >> 24);
+         *d = ((*s & 0xff000000) + MUL3_SYM(c, *s)) + MUL_256(alpha, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+         __m256i a0 = sub4_alpha_avx2(s0);
+
+         s0 = _mm256_add_epi32(_mm256_and_si256(s0, a_mask),
+                               mul3_sym_avx2(c0, s0));
+         d0 = _mm256_add_epi32(s0, mul_256_avx2(a0, d0));
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_blend_pan_can_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(c);
+   const __m256i a_mask = _mm256_set1_epi32(0xff000000);
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         *d = 0xff000000 + MUL3_SYM(c, *s);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+
+         s0 = _mm256_or_si256(a_mask, mul3_sym_avx2(c0, s0));
+
+         _mm256_store_si256((__m256i *)d, s0);
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_blend_p_caa_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(1 + (c & 0xff));
+   int alpha;
+
+   c = 1 + (c & 0xff);
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         DATA32 sc = MUL_256(c, *s);
+         alpha = 256 - (sc >> 24);
+         *d = sc + MUL_256(alpha, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         s0 = mul_256_avx2(c0, s0);
+         d0 = _mm256_add_epi32(s0, mul_256_avx2(sub4_alpha_avx2(s0), d0));
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_blend_pan_caa_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(1 + (c & 0xff));
+
+   c = 1 + (c & 0xff);
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         *d = INTERP_256(c, *s, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         d0 = interp_256_avx2(c0, s0, d0);
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+#define _op_blend_pas_c_dp_avx2 _op_blend_p_c_dp_avx2
+#define _op_blend_pas_can_dp_avx2 _op_blend_p_can_dp_avx2
+#define _op_blend_pas_caa_dp_avx2 _op_blend_p_caa_dp_avx2
+
+#define _op_blend_p_c_dpan_avx2 _op_blend_p_c_dp_avx2
+#define _op_blend_pas_c_dpan_avx2 _op_blend_pas_c_dp_avx2
+#define _op_blend_pan_c_dpan_avx2 _op_blend_pan_c_dp_avx2
+#define _op_blend_p_can_dpan_avx2 _op_blend_p_can_dp_avx2
+#define _op_blend_pas_can_dpan_avx2 _op_blend_pas_can_dp_avx2
+#define _op_blend_pan_can_dpan_avx2 _op_blend_pan_can_dp_avx2
+#define _op_blend_p_caa_dpan_avx2 _op_blend_p_caa_dp_avx2
+#define _op_blend_pas_caa_dpan_avx2 _op_blend_pas_caa_dp_avx2
+#define _op_blend_pan_caa_dpan_avx2 _op_blend_pan_caa_dp_avx2
+
+static void
+init_blend_pixel_color_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP][SM_N][SC][DP][CPU_AVX2] = _op_blend_p_c_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC][DP][CPU_AVX2] = _op_blend_pas_c_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC][DP][CPU_AVX2] = _op_blend_pan_c_dp_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AN][DP][CPU_AVX2] = _op_blend_p_can_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AN][DP][CPU_AVX2] = _op_blend_pas_can_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AN][DP][CPU_AVX2] = _op_blend_pan_can_dp_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AA][DP][CPU_AVX2] = _op_blend_p_caa_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AA][DP][CPU_AVX2] = _op_blend_pas_caa_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AA][DP][CPU_AVX2] = _op_blend_pan_caa_dp_avx2;
+
+   op_blend_span_funcs[SP][SM_N][SC][DP_AN][CPU_AVX2] = _op_blend_p_c_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC][DP_AN][CPU_AVX2] = _op_blend_pas_c_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC][DP_AN][CPU_AVX2] = _op_blend_pan_c_dpan_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_blend_p_can_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_blend_pas_can_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_blend_pan_can_dpan_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_blend_p_caa_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_blend_pas_caa_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_blend_pan_caa_dpan_avx2;
+}
+
+#endif
@@ -0,0 +1,122 @@
+/* blend pixel x mask --> dst */
+
+#ifdef BUILD_AVX2
+
+static void
+_op_blend_p_mas_dp_avx2(DATA32 *s, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+
+   int alpha;
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         alpha = *m;
+         switch(alpha)
+           {
+           case 0:
+              break;
+           case 255:
+              alpha = 256 - (*s >> 24);
+              *d = *s + MUL_256(alpha, *d);
+              break;
+           default:
+              c = MUL_SYM(alpha, *s);
+              alpha = 256 - (c >> 24);
+              *d = c + MUL_256(alpha, *d);
+              break;
+           }
+         m++; s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m128i m8 = _mm_loadl_epi64((__m128i *)m);
+
+         if (_mm_testz_si128(m8, m8))
+           {
+              m += 8; s += 8; d += 8; l -= 8;
+              continue;
+           }
+
+         __m256i m0 = _mm256_cvtepu8_epi32(m8);
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         /* exact for all mask values, 0 leaves d as it is */
+         s0 = mul_sym_avx2(m0, s0);
+         d0 = _mm256_add_epi32(s0, mul_256_avx2(sub4_alpha_avx2(s0), d0));
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         m += 8; s += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_blend_pas_mas_dp_avx2(DATA32 *s, DATA8 *m, DATA32 c EINA_UNUSED, DATA32 *d, int l) {
+
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i one = _mm256_set1_epi32(1);
+   int alpha;
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         alpha = *m;
+         switch(alpha)
+           {
+           case 0:
+              break;
+           case 255:
+              *d = *s;
+              break;
+           default:
+              alpha++;
+              *d = INTERP_256(alpha, *s, *d);
+              break;
+           }
+         m++; s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m128i m8 = _mm_loadl_epi64((__m128i *)m);
+
+         if (_mm_testz_si128(m8, m8))
+           {
+              m += 8; s += 8; d += 8; l -= 8;
+              continue;
+           }
+
+         __m256i m0 = _mm256_cvtepu8_epi32(m8);
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+         __m256i zmask0 = _mm256_cmpeq_epi32(m0, zero);
+
+         /* a mask of 255 gives s, keep d where the mask is 0 */
+         s0 = interp_256_avx2(_mm256_add_epi32(m0, one), s0, d0);
+         d0 = _mm256_blendv_epi8(s0, d0, zmask0);
+
+         _mm256_store_si256((__m256i *)d, d0);
+
+         m += 8; s += 8; d += 8; l -= 8;
+      })
+}
+
+#define _op_blend_pan_mas_dp_avx2 _op_blend_pas_mas_dp_avx2
+
+#define _op_blend_p_mas_dpan_avx2 _op_blend_p_mas_dp_avx2
+#define _op_blend_pas_mas_dpan_avx2 _op_blend_pas_mas_dp_avx2
+#define _op_blend_pan_mas_dpan_avx2 _op_blend_pan_mas_dp_avx2
+
+static void
+init_blend_pixel_mask_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_p_mas_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_pas_mas_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_pan_mas_dp_avx2;
+
+   op_blend_span_funcs[SP][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_p_mas_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_pas_mas_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_pan_mas_dpan_avx2;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/* copy pixel --> dst */
+
+#ifdef BUILD_AVX2
+
+static void
+_op_copy_p_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c EINA_UNUSED, DATA32 *d, int l) {
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         *d = *s;
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         _mm256_store_si256((__m256i *)d, _mm256_loadu_si256((__m256i *)s));
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+#define _op_copy_pan_dp_avx2 _op_copy_p_dp_avx2
+#define _op_copy_pas_dp_avx2 _op_copy_p_dp_avx2
+
+#define _op_copy_p_dpan_avx2 _op_copy_p_dp_avx2
+#define _op_copy_pan_dpan_avx2 _op_copy_pan_dp_avx2
+#define _op_copy_pas_dpan_avx2 _op_copy_pas_dp_avx2
+
+static void
+init_copy_pixel_span_funcs_avx2(void)
+{
+   op_copy_span_funcs[SP][SM_N][SC_N][DP][CPU_AVX2] = _op_copy_p_dp_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_N][DP][CPU_AVX2] = _op_copy_pan_dp_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_N][DP][CPU_AVX2] = _op_copy_pas_dp_avx2;
+
+   op_copy_span_funcs[SP][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_copy_p_dpan_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_copy_pan_dpan_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_copy_pas_dpan_avx2;
+}
+
+#endif
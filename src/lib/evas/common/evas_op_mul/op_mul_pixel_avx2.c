@@ -0,0 +1,44 @@
+/* mul pixel --> dst */
+
+#ifdef BUILD_AVX2
+
+static void
+_op_mul_p_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c EINA_UNUSED, DATA32 *d, int l) {
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         *d = MUL4_SYM(*s, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         _mm256_store_si256((__m256i *)d, mul4_sym_avx2(s0, d0));
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+#define _op_mul_pas_dp_avx2 _op_mul_p_dp_avx2
+#define _op_mul_pan_dp_avx2 _op_mul_p_dp_avx2
+
+#define _op_mul_p_dpan_avx2 _op_mul_p_dp_avx2
+#define _op_mul_pas_dpan_avx2 _op_mul_pas_dp_avx2
+#define _op_mul_pan_dpan_avx2 _op_mul_pan_dp_avx2
+
+static void
+init_mul_pixel_span_funcs_avx2(void)
+{
+   op_mul_span_funcs[SP][SM_N][SC_N][DP][CPU_AVX2] = _op_mul_p_dp_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_N][DP][CPU_AVX2] = _op_mul_pas_dp_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_N][DP][CPU_AVX2] = _op_mul_pan_dp_avx2;
+
+   op_mul_span_funcs[SP][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_mul_p_dpan_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_mul_pas_dpan_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_mul_pan_dpan_avx2;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/* mul pixel x color --> dst */
+
+#ifdef BUILD_AVX2
+
+static void
+_op_mul_p_c_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(c);
+
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         DATA32 cs = MUL4_SYM(c, *s);
+         *d = MUL4_SYM(cs, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         s0 = mul4_sym_avx2(c0, s0);
+         _mm256_store_si256((__m256i *)d, mul4_sym_avx2(s0, d0));
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+static void
+_op_mul_p_caa_dp_avx2(DATA32 *s, DATA8 *m EINA_UNUSED, DATA32 c, DATA32 *d, int l) {
+
+   const __m256i c0 = _mm256_set1_epi32(1 + (c >> 24));
+
+   c = 1 + (c >> 24);
+   LOOP_ALIGNED_U1_A8(d, l,
+      { /* UOP */
+
+         DATA32 cs = MUL_256(c, *s);
+         *d = MUL4_SYM(cs, *d);
+         s++; d++; l--;
+      },
+      { /* A8OP */
+
+         __m256i s0 = _mm256_loadu_si256((__m256i *)s);
+         __m256i d0 = _mm256_load_si256((__m256i *)d);
+
+         s0 = mul_256_avx2(c0, s0);
+         _mm256_store_si256((__m256i *)d, mul4_sym_avx2(s0, d0));
+
+         s += 8; d += 8; l -= 8;
+      })
+}
+
+#define _op_mul_pas_c_dp_avx2 _op_mul_p_c_dp_avx2
+#define _op_mul_pan_c_dp_avx2 _op_mul_p_c_dp_avx2
+#define _op_mul_p_can_dp_avx2 _op_mul_p_c_dp_avx2
+#define _op_mul_pas_can_dp_avx2 _op_mul_p_c_dp_avx2
+#define _op_mul_pan_can_dp_avx2 _op_mul_p_c_dp_avx2
+#define _op_mul_pas_caa_dp_avx2 _op_mul_p_caa_dp_avx2
+#define _op_mul_pan_caa_dp_avx2 _op_mul_p_caa_dp_avx2
+
+#define _op_mul_p_c_dpan_avx2 _op_mul_p_c_dp_avx2
+#define _op_mul_pas_c_dpan_avx2 _op_mul_pas_c_dp_avx2
+#define _op_mul_pan_c_dpan_avx2 _op_mul_pan_c_dp_avx2
+#define _op_mul_p_can_dpan_avx2 _op_mul_p_can_dp_avx2
+#define _op_mul_pas_can_dpan_avx2 _op_mul_pas_can_dp_avx2
+#define _op_mul_pan_can_dpan_avx2 _op_mul_pan_can_dp_avx2
+#define _op_mul_p_caa_dpan_avx2 _op_mul_p_caa_dp_avx2
+#define _op_mul_pas_caa_dpan_avx2 _op_mul_pas_caa_dp_avx2
+#define _op_mul_pan_caa_dpan_avx2 _op_mul_pan_caa_dp_avx2
+
+static void
+init_mul_pixel_color_span_funcs_avx2(void)
+{
+   op_mul_span_funcs[SP][SM_N][SC][DP][CPU_AVX2] = _op_mul_p_c_dp_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC][DP][CPU_AVX2] = _op_mul_pas_c_dp_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC][DP][CPU_AVX2] = _op_mul_pan_c_dp_avx2;
+   op_mul_span_funcs[SP][SM_N][SC_AN][DP][CPU_AVX2] = _op_mul_p_can_dp_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_AN][DP][CPU_AVX2] = _op_mul_pas_can_dp_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_AN][DP][CPU_AVX2] = _op_mul_pan_can_dp_avx2;
+   op_mul_span_funcs[SP][SM_N][SC_AA][DP][CPU_AVX2] = _op_mul_p_caa_dp_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_AA][DP][CPU_AVX2] = _op_mul_pas_caa_dp_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_AA][DP][CPU_AVX2] = _op_mul_pan_caa_dp_avx2;
+
+   op_mul_span_funcs[SP][SM_N][SC][DP_AN][CPU_AVX2] = _op_mul_p_c_dpan_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC][DP_AN][CPU_AVX2] = _op_mul_pas_c_dpan_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC][DP_AN][CPU_AVX2] = _op_mul_pan_c_dpan_avx2;
+   op_mul_span_funcs[SP][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_mul_p_can_dpan_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_mul_pas_can_dpan_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_mul_pan_can_dpan_avx2;
+   op_mul_span_funcs[SP][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_mul_p_caa_dpan_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_mul_pas_caa_dpan_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_mul_pan_caa_dpan_avx2;
+}
+
+#endif
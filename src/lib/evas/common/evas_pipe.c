@@ -421,7 +421,9 @@ evas_common_pipe_poly_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
 static void
 evas_common_pipe_op_text_free(RGBA_Pipe_Op *op)
 {
+   evas_common_font_cache_lock();
    evas_common_text_props_content_unref(op->op.text.intl_props);
+   evas_common_font_cache_unlock();
    evas_common_pipe_op_free(op);
 }
 
@@ -729,6 +731,7 @@ evas_common_pipe_load(void *data, Eina_Thread t EINA_UNUSED)
 
            if (fi)
              {
+                evas_common_font_cache_lock();
                 LKL(fi->ft_mutex);
                 EINA_LIST_FREE(fi->task, text_props)
 		  {
@@ -737,6 +740,7 @@ evas_common_pipe_load(void *data, Eina_Thread t EINA_UNUSED)
 		     text_props->prepare = EINA_FALSE;
 		  }
                 LKU(fi->ft_mutex);
+                evas_common_font_cache_unlock();
              }
 	}
 
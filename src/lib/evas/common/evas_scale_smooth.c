@@ -2,6 +2,10 @@
 #include "evas_scale_smooth.h"
 #include "evas_blend_private.h"
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 #define SCALE_CALC_X_POINTS(P, SW, DW, CX, CW) \
   P = alloca((CW + 1) * sizeof (int));         \
   scale_calc_x_points(P, SW, DW, CX, CW);
@@ -89,12 +93,74 @@ scale_calc_a_points(int *p, int s, int d, int c, int cc)
      }
 }
 
+#ifdef __SSE2__
+/* Box filter one source row for a down scaled pixel, the four channels at
+ * once. The weights are at most 1 << 14 and the channels fit in the low 16
+ * bits of each lane, so madd gives the exact 32 bits products. */
+static inline __m128i
+_scale_down_row_sse2(const DATA32 *pix, int xap, int Cx)
+{
+   const __m128i zero = _mm_setzero_si128();
+   __m128i p, acc;
+   int i;
+
+   p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(*pix), zero), zero);
+   acc = _mm_srli_epi32(_mm_madd_epi16(p, _mm_set1_epi32(xap)), 9);
+   pix++;
+   for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+     {
+        p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(*pix), zero), zero);
+        acc = _mm_add_epi32(acc, _mm_srli_epi32(_mm_madd_epi16(p, _mm_set1_epi32(Cx)), 9));
+        pix++;
+     }
+   if (i > 0)
+     {
+        p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(*pix), zero), zero);
+        acc = _mm_add_epi32(acc, _mm_srli_epi32(_mm_madd_epi16(p, _mm_set1_epi32(i)), 9));
+     }
+
+   return acc;
+}
+
+/* Same as the C loops of evas_scale_smooth_scaler_downx_downy.c, a row
+ * sum is at most 255 << 5 so it still fits the 16 bits madd operand. */
+static inline DATA32
+_scale_down_xy_sse2(const DATA32 *sptr, int src_w, int xap, int Cx, int yap, int Cy)
+{
+   __m128i acc;
+   int j;
+
+   acc = _mm_srli_epi32(_mm_madd_epi16(_scale_down_row_sse2(sptr, xap, Cx),
+                                       _mm_set1_epi32(yap)), 14);
+   sptr += src_w;
+   for (j = (1 << 14) - yap; j > Cy; j -= Cy)
+     {
+        acc = _mm_add_epi32(acc, _mm_srli_epi32(_mm_madd_epi16(_scale_down_row_sse2(sptr, xap, Cx),
+                                                               _mm_set1_epi32(Cy)), 14));
+        sptr += src_w;
+     }
+   if (j > 0)
+     acc = _mm_add_epi32(acc, _mm_srli_epi32(_mm_madd_epi16(_scale_down_row_sse2(sptr, xap, Cx),
+                                                            _mm_set1_epi32(j)), 14));
+
+   acc = _mm_srli_epi32(_mm_add_epi32(acc, _mm_set1_epi32(1 << 4)), 5);
+   acc = _mm_packs_epi32(acc, acc);
+   acc = _mm_packus_epi16(acc, acc);
+
+   return _mm_cvtsi128_si32(acc);
+}
+#endif
+
 #ifdef BUILD_MMX
 # undef SCALE_FUNC
 # define SCALE_FUNC _evas_common_scale_rgba_in_to_out_clip_smooth_mmx
 # undef SCALE_USING_MMX
 # define SCALE_USING_MMX
+# ifdef __SSE2__
+#  define SCALE_USING_SSE2
+# endif
 # include "evas_scale_smooth_scaler.c"
+# undef SCALE_USING_SSE2
 #endif
 
 #ifdef BUILD_NEON
@@ -111,6 +177,252 @@ scale_calc_a_points(int *p, int s, int d, int c, int cc)
 #undef SCALE_USING_MMX
 #include "evas_scale_smooth_scaler.c"
 
+/* Large smooth scales can be split in horizontal bands of the destination
+ * clip, each band being scaled by one thread of a small pool. Every output
+ * row only depends on its own position in the destination region, so the
+ * result is the same as scaling the whole clip at once. */
+typedef void (*Evas_Scale_Smooth_Func)(RGBA_Image *src, RGBA_Image *dst, int dst_clip_x, int dst_clip_y, int dst_clip_w, int dst_clip_h, DATA32 mul_col, int render_op, int src_region_x, int src_region_y, int src_region_w, int src_region_h, int dst_region_x, int dst_region_y, int dst_region_w, int dst_region_h);
+
+typedef struct _Evas_Scale_Smooth_Job Evas_Scale_Smooth_Job;
+struct _Evas_Scale_Smooth_Job
+{
+   Evas_Scale_Smooth_Func func;
+   RGBA_Image *src, *dst;
+   Eina_Rectangle clip;
+   Eina_Rectangle src_region, dst_region;
+   DATA32 mul_col;
+   int render_op;
+   unsigned int bands;
+};
+
+typedef struct _Evas_Scale_Smooth_Thread Evas_Scale_Smooth_Thread;
+struct _Evas_Scale_Smooth_Thread
+{
+   Eina_Thread thread_id;
+   unsigned int band;
+};
+
+/* below this many destination pixels per band, waking up the pool costs
+ * more than it saves */
+#define SCALE_THREAD_MIN_PIXELS (128 * 128)
+#define SCALE_THREAD_MIN_ROWS 8
+
+static Evas_Scale_Smooth_Thread scale_threads[TH_MAX];
+static unsigned int scale_thread_count = 1;
+static Eina_Barrier scale_thread_barrier[2];
+static Evas_Scale_Smooth_Job scale_thread_job;
+static Eina_Bool scale_thread_exit = EINA_FALSE;
+
+/* The threads wait here until all of them are started, so that they never
+ * touch the barriers when one of them could not be created. */
+static Eina_Lock scale_thread_start_lock;
+static Eina_Condition scale_thread_start_cond;
+static Eina_Bool scale_thread_started = EINA_FALSE;
+static Eina_Bool scale_thread_start_failed = EINA_FALSE;
+
+static void
+_evas_common_scale_smooth_band_run(const Evas_Scale_Smooth_Job *job, unsigned int band)
+{
+   int y1, y2;
+
+   y1 = job->clip.y + (int)(((long long)job->clip.h * band) / job->bands);
+   y2 = job->clip.y + (int)(((long long)job->clip.h * (band + 1)) / job->bands);
+   if (y2 <= y1) return;
+
+   job->func(job->src, job->dst,
+             job->clip.x, y1, job->clip.w, y2 - y1,
+             job->mul_col, job->render_op,
+             job->src_region.x, job->src_region.y,
+             job->src_region.w, job->src_region.h,
+             job->dst_region.x, job->dst_region.y,
+             job->dst_region.w, job->dst_region.h);
+}
+
+static void *
+_evas_common_scale_smooth_thread_func(void *data, Eina_Thread thread EINA_UNUSED)
+{
+   Evas_Scale_Smooth_Thread *th = data;
+   Eina_Bool failed;
+
+   eina_lock_take(&scale_thread_start_lock);
+   while (!scale_thread_started)
+     eina_condition_wait(&scale_thread_start_cond);
+   failed = scale_thread_start_failed;
+   eina_lock_release(&scale_thread_start_lock);
+
+   /* one of the other threads could not be started */
+   if (failed) return NULL;
+
+   while (1)
+     {
+        eina_barrier_wait(&scale_thread_barrier[0]);
+        if (scale_thread_exit) break;
+
+        if (th->band < scale_thread_job.bands)
+          {
+             _evas_common_scale_smooth_band_run(&scale_thread_job, th->band);
+             evas_common_cpu_end_opt();
+          }
+
+        eina_barrier_wait(&scale_thread_barrier[1]);
+     }
+
+   return NULL;
+}
+
+static void
+_evas_common_scale_smooth_run(Evas_Scale_Smooth_Func func,
+                              RGBA_Image *src, RGBA_Image *dst,
+                              int dst_clip_x, int dst_clip_y,
+                              int dst_clip_w, int dst_clip_h,
+                              DATA32 mul_col, int render_op,
+                              int src_region_x, int src_region_y,
+                              int src_region_w, int src_region_h,
+                              int dst_region_x, int dst_region_y,
+                              int dst_region_w, int dst_region_h)
+{
+   Eina_Rectangle clip, area;
+   unsigned int bands = 0;
+
+   /* only the main loop uses the pool, draws done by the render threads
+    * are already split in bands */
+   if ((scale_thread_count > 1) && eina_main_loop_is())
+     {
+        EINA_RECTANGLE_SET(&clip, dst_clip_x, dst_clip_y, dst_clip_w, dst_clip_h);
+        EINA_RECTANGLE_SET(&area, dst_region_x, dst_region_y, dst_region_w, dst_region_h);
+        if (eina_rectangle_intersection(&clip, &area))
+          {
+             EINA_RECTANGLE_SET(&area, 0, 0, dst->cache_entry.w, dst->cache_entry.h);
+             if (eina_rectangle_intersection(&clip, &area))
+               {
+                  bands = ((long long)clip.w * clip.h) / SCALE_THREAD_MIN_PIXELS;
+                  if (bands > (unsigned int)clip.h / SCALE_THREAD_MIN_ROWS)
+                    bands = clip.h / SCALE_THREAD_MIN_ROWS;
+                  if (bands > scale_thread_count) bands = scale_thread_count;
+               }
+          }
+
+        if (bands > 1)
+          {
+             scale_thread_job.func = func;
+             scale_thread_job.src = src;
+             scale_thread_job.dst = dst;
+             scale_thread_job.clip = clip;
+             EINA_RECTANGLE_SET(&scale_thread_job.src_region,
+                                src_region_x, src_region_y,
+                                src_region_w, src_region_h);
+             EINA_RECTANGLE_SET(&scale_thread_job.dst_region,
+                                dst_region_x, dst_region_y,
+                                dst_region_w, dst_region_h);
+             scale_thread_job.mul_col = mul_col;
+             scale_thread_job.render_op = render_op;
+             scale_thread_job.bands = bands;
+
+             /* band 0 is scaled by the calling thread */
+             eina_barrier_wait(&scale_thread_barrier[0]);
+             _evas_common_scale_smooth_band_run(&scale_thread_job, 0);
+             eina_barrier_wait(&scale_thread_barrier[1]);
+             return;
+          }
+     }
+
+   func(src, dst,
+        dst_clip_x, dst_clip_y, dst_clip_w, dst_clip_h,
+        mul_col, render_op,
+        src_region_x, src_region_y, src_region_w, src_region_h,
+        dst_region_x, dst_region_y, dst_region_w, dst_region_h);
+}
+
+static void
+_evas_common_scale_smooth_threads_shutdown(void)
+{
+   unsigned int i;
+
+   if (scale_thread_count == 1) return;
+
+   scale_thread_exit = EINA_TRUE;
+   eina_barrier_wait(&scale_thread_barrier[0]);
+
+   for (i = 1; i < scale_thread_count; i++)
+     eina_thread_join(scale_threads[i].thread_id);
+
+   eina_barrier_free(&scale_thread_barrier[0]);
+   eina_barrier_free(&scale_thread_barrier[1]);
+   eina_condition_free(&scale_thread_start_cond);
+   eina_lock_free(&scale_thread_start_lock);
+
+   scale_thread_exit = EINA_FALSE;
+   scale_thread_count = 1;
+}
+
+EAPI void
+evas_common_scale_smooth_threads_set(unsigned int threads)
+{
+   unsigned int i;
+
+   if (threads < 1) threads = 1;
+   if (threads > TH_MAX) threads = TH_MAX;
+   if (threads == scale_thread_count) return;
+
+   _evas_common_scale_smooth_threads_shutdown();
+   if (threads == 1) return;
+
+   if (!eina_lock_new(&scale_thread_start_lock))
+     return;
+   if (!eina_condition_new(&scale_thread_start_cond,
+                           &scale_thread_start_lock))
+     {
+        eina_lock_free(&scale_thread_start_lock);
+        return;
+     }
+   scale_thread_started = EINA_FALSE;
+   scale_thread_start_failed = EINA_FALSE;
+
+   /* band 0 is scaled by the calling thread */
+   for (i = 1; i < threads; i++)
+     {
+        scale_threads[i].band = i;
+        if (!eina_thread_create(&scale_threads[i].thread_id,
+                                EINA_THREAD_NORMAL, -1,
+                                _evas_common_scale_smooth_thread_func,
+                                &scale_threads[i]))
+          break;
+     }
+
+   if (i < threads)
+     scale_thread_start_failed = EINA_TRUE;
+   else
+     {
+        eina_barrier_new(&scale_thread_barrier[0], threads);
+        eina_barrier_new(&scale_thread_barrier[1], threads);
+     }
+
+   eina_lock_take(&scale_thread_start_lock);
+   scale_thread_started = EINA_TRUE;
+   eina_condition_broadcast(&scale_thread_start_cond);
+   eina_lock_release(&scale_thread_start_lock);
+
+   if (scale_thread_start_failed)
+     {
+        unsigned int started = i;
+
+        CRI("Could not create smooth scale thread %u, scaling on one thread.", i);
+        for (i = 1; i < started; i++)
+          eina_thread_join(scale_threads[i].thread_id);
+        eina_condition_free(&scale_thread_start_cond);
+        eina_lock_free(&scale_thread_start_lock);
+        return;
+     }
+
+   scale_thread_count = threads;
+}
+
+EAPI unsigned int
+evas_common_scale_smooth_threads_get(void)
+{
+   return scale_thread_count;
+}
+
 #ifdef BUILD_MMX
 Eina_Bool
 evas_common_scale_rgba_in_to_out_clip_smooth_mmx(RGBA_Image *src, RGBA_Image *dst,
@@ -140,8 +452,9 @@ evas_common_scale_rgba_in_to_out_clip_smooth_mmx(RGBA_Image *src, RGBA_Image *ds
 
    mul_col = dc->mul.use ? dc->mul.col : 0xffffffff;
 
-   _evas_common_scale_rgba_in_to_out_clip_smooth_mmx
-     (src, dst,
+   _evas_common_scale_smooth_run
+     (_evas_common_scale_rgba_in_to_out_clip_smooth_mmx,
+      src, dst,
       clip_x, clip_y, clip_w, clip_h,
       mul_col, dc->render_op,
       src_region_x, src_region_y, src_region_w, src_region_h,
@@ -180,8 +493,9 @@ evas_common_scale_rgba_in_to_out_clip_smooth_neon(RGBA_Image *src, RGBA_Image *d
 
    mul_col = dc->mul.use ? dc->mul.col : 0xffffffff;
 
-   _evas_common_scale_rgba_in_to_out_clip_smooth_neon
-     (src, dst,
+   _evas_common_scale_smooth_run
+     (_evas_common_scale_rgba_in_to_out_clip_smooth_neon,
+      src, dst,
       clip_x, clip_y, clip_w, clip_h,
       mul_col, dc->render_op,
       src_region_x, src_region_y, src_region_w, src_region_h,
@@ -219,8 +533,9 @@ evas_common_scale_rgba_in_to_out_clip_smooth_c(RGBA_Image *src, RGBA_Image *dst,
 
    mul_col = dc->mul.use ? dc->mul.col : 0xffffffff;
 
-   _evas_common_scale_rgba_in_to_out_clip_smooth_c
-     (src, dst,
+   _evas_common_scale_smooth_run
+     (_evas_common_scale_rgba_in_to_out_clip_smooth_c,
+      src, dst,
       clip_x, clip_y, clip_w, clip_h,
       mul_col, dc->render_op,
       src_region_x, src_region_y, src_region_w, src_region_h,
@@ -264,35 +579,27 @@ evas_common_scale_rgba_in_to_out_clip_smooth(RGBA_Image *src, RGBA_Image *dst,
 EAPI void
 evas_common_scale_rgba_smooth_draw(RGBA_Image *src, RGBA_Image *dst, int dst_clip_x, int dst_clip_y, int dst_clip_w, int dst_clip_h, DATA32 mul_col, int render_op, int src_region_x, int src_region_y, int src_region_w, int src_region_h, int dst_region_x, int dst_region_y, int dst_region_w, int dst_region_h)
 {
+   Evas_Scale_Smooth_Func func;
 #ifdef BUILD_MMX
    int mmx, sse, sse2;
 
    evas_common_cpu_can_do(&mmx, &sse, &sse2);
    if (mmx)
-     _evas_common_scale_rgba_in_to_out_clip_smooth_mmx
-       (src, dst,
-        dst_clip_x, dst_clip_y, dst_clip_w, dst_clip_h,
-        mul_col, render_op,
-        src_region_x, src_region_y, src_region_w, src_region_h,
-        dst_region_x, dst_region_y, dst_region_w, dst_region_h);
+     func = _evas_common_scale_rgba_in_to_out_clip_smooth_mmx;
    else
 #endif
 #ifdef BUILD_NEON
      if (evas_common_cpu_has_feature(CPU_FEATURE_NEON))
-       _evas_common_scale_rgba_in_to_out_clip_smooth_neon
-     (src, dst,
-         dst_clip_x, dst_clip_y, dst_clip_w, dst_clip_h,
-         mul_col, render_op,
-         src_region_x, src_region_y, src_region_w, src_region_h,
-         dst_region_x, dst_region_y, dst_region_w, dst_region_h);
+       func = _evas_common_scale_rgba_in_to_out_clip_smooth_neon;
    else
 #endif
-     _evas_common_scale_rgba_in_to_out_clip_smooth_c
-       (src, dst,
-        dst_clip_x, dst_clip_y, dst_clip_w, dst_clip_h,
-        mul_col, render_op,
-        src_region_x, src_region_y, src_region_w, src_region_h,
-        dst_region_x, dst_region_y, dst_region_w, dst_region_h);
+     func = _evas_common_scale_rgba_in_to_out_clip_smooth_c;
+
+   _evas_common_scale_smooth_run(func, src, dst,
+                                 dst_clip_x, dst_clip_y, dst_clip_w, dst_clip_h,
+                                 mul_col, render_op,
+                                 src_region_x, src_region_y, src_region_w, src_region_h,
+                                 dst_region_x, dst_region_y, dst_region_w, dst_region_h);
 }
 
 EAPI void
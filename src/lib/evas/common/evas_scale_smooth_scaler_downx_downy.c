@@ -1,7 +1,11 @@
 {
-   int Cx, Cy, i, j;
-   DATA32 *dptr, *sptr, *pix, *pbuf;
+   int Cx, Cy;
+   DATA32 *dptr, *pbuf;
+#ifndef SCALE_USING_SSE2
+   int i, j;
+   DATA32 *sptr, *pix;
    int a, r, g, b, rx, gx, bx, ax;
+#endif
    int xap, yap, pos;
    //int dyy, dxx;
 
@@ -34,6 +38,10 @@
 		Cx = *xapp >> 16;
 		xap = *xapp & 0xffff;
 
+#ifdef SCALE_USING_SSE2
+		*pbuf++ = _scale_down_xy_sse2(*yp + *xp + pos, src_w,
+		                              xap, Cx, yap, Cy);
+#else
 		sptr = *yp + *xp + pos;
 		pix = sptr;
 		sptr += src_w;
@@ -128,6 +136,7 @@
 				    ((r + (1 << 4)) >> 5),
 				    ((g + (1 << 4)) >> 5),
 				    ((b + (1 << 4)) >> 5));
+#endif
 		xp++;  xapp++;
 	      }
 
@@ -158,6 +167,10 @@
 		     Cx = *xapp >> 16;
 		     xap = *xapp & 0xffff;
 
+#ifdef SCALE_USING_SSE2
+		     *pbuf++ = _scale_down_xy_sse2(*yp + *xp + pos, src_w,
+		                                   xap, Cx, yap, Cy) | 0xff000000;
+#else
 		     sptr = *yp + *xp + pos;
 		     pix = sptr;
 		     sptr += src_w;
@@ -240,6 +253,7 @@
 					 ((r + (1 << 4)) >> 5),
 					 ((g + (1 << 4)) >> 5),
 					 ((b + (1 << 4)) >> 5));
+#endif
 		     xp++;  xapp++;
 		   }
 
@@ -262,6 +276,10 @@
 		     Cx = *xapp >> 16;
 		     xap = *xapp & 0xffff;
 
+#ifdef SCALE_USING_SSE2
+		     *pbuf++ = _scale_down_xy_sse2(*yp + *xp + pos, src_w,
+		                                   xap, Cx, yap, Cy) | 0xff000000;
+#else
 		     sptr = *yp + *xp + pos;
 		     pix = sptr;
 		     sptr += src_w;
@@ -344,6 +362,7 @@
 					 ((r + (1 << 4)) >> 5),
 					 ((g + (1 << 4)) >> 5),
 					 ((b + (1 << 4)) >> 5));
+#endif
 		     xp++;  xapp++;
 		   }
 
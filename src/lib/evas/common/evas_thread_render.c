@@ -14,8 +14,33 @@ static volatile int evas_thread_exited = 0;
 static Eina_Bool exit_thread = EINA_FALSE;
 static int init_count = 0;
 
+/* Helpers of the render thread. Tileable commands are run by all of them
+ * at the same time, each one only touching its own horizontal band of the
+ * destination surface, so the draw order inside a band is preserved. */
+typedef struct _Evas_Thread_Tiler Evas_Thread_Tiler;
+struct _Evas_Thread_Tiler
+{
+   Eina_Thread thread_id;
+   unsigned int band;
+};
+
+static Evas_Thread_Tiler evas_thread_tilers[TH_MAX];
+static unsigned int evas_thread_bands = 1;
+static Eina_Bool evas_thread_tilers_tried = EINA_FALSE;
+static Eina_Barrier evas_thread_tile_barrier[2];
+static const Evas_Thread_Command *evas_thread_tile_cmds = NULL;
+static unsigned int evas_thread_tile_len = 0;
+static Eina_Bool evas_thread_tile_exit = EINA_FALSE;
+
+/* The helpers wait here until all of them are started, so that they never
+ * touch the barriers when one of them could not be created. */
+static Eina_Lock evas_thread_tile_start_lock;
+static Eina_Condition evas_thread_tile_start_cond;
+static Eina_Bool evas_thread_tile_started = EINA_FALSE;
+static Eina_Bool evas_thread_tile_start_failed = EINA_FALSE;
+
 static void
-evas_thread_queue_append(Evas_Thread_Command_Cb cb, void *data, Eina_Bool do_flush)
+evas_thread_queue_append(Evas_Thread_Command_Tile_Cb tile, Evas_Thread_Command_Cb cb, void *data, Eina_Bool do_flush)
 {
    Evas_Thread_Command *cmd;
 
@@ -24,6 +49,7 @@ evas_thread_queue_append(Evas_Thread_Command_Cb cb, void *data, Eina_Bool do_flu
    cmd = eina_inarray_grow(&evas_thread_queue, 1);
    if (cmd)
      {
+        cmd->tile = tile;
         cmd->cb = cb;
         cmd->data = data;
      }
@@ -46,13 +72,103 @@ out:
 EAPI void
 evas_thread_cmd_enqueue(Evas_Thread_Command_Cb cb, void *data)
 {
-    evas_thread_queue_append(cb, data, EINA_FALSE);
+    evas_thread_queue_append(NULL, cb, data, EINA_FALSE);
+}
+
+/* tile is called once per band, possibly from several threads at the same
+ * time, then cb is called once from the render thread to release data. */
+EAPI void
+evas_thread_cmd_tile_enqueue(Evas_Thread_Command_Tile_Cb tile, Evas_Thread_Command_Cb cb, void *data)
+{
+    evas_thread_queue_append(tile, cb, data, EINA_FALSE);
 }
 
 EAPI void
 evas_thread_queue_flush(Evas_Thread_Command_Cb cb, void *data)
 {
-    evas_thread_queue_append(cb, data, EINA_TRUE);
+    evas_thread_queue_append(NULL, cb, data, EINA_TRUE);
+}
+
+EAPI void
+evas_thread_tile_band_get(const RGBA_Image *dst, unsigned int band, unsigned int bands, Eina_Rectangle *r)
+{
+    int y1, y2;
+
+    y1 = (int)(((long long)dst->cache_entry.h * band) / bands);
+    y2 = (int)(((long long)dst->cache_entry.h * (band + 1)) / bands);
+    EINA_RECTANGLE_SET(r, 0, y1, dst->cache_entry.w, y2 - y1);
+}
+
+static void
+evas_thread_tile_run(const Evas_Thread_Command *cmd, unsigned int len, unsigned int band)
+{
+    while (len)
+      {
+         cmd->tile(cmd->data, band, evas_thread_bands);
+
+         cmd++;
+         len--;
+      }
+}
+
+static void *
+evas_thread_tiler_func(void *data, Eina_Thread thread EINA_UNUSED)
+{
+    Evas_Thread_Tiler *tiler = data;
+    Eina_Bool failed;
+
+    eina_lock_take(&evas_thread_tile_start_lock);
+    while (!evas_thread_tile_started)
+      eina_condition_wait(&evas_thread_tile_start_cond);
+    failed = evas_thread_tile_start_failed;
+    eina_lock_release(&evas_thread_tile_start_lock);
+
+    /* one of the other helpers could not be started */
+    if (failed) return NULL;
+
+    while (1)
+      {
+         eina_barrier_wait(&evas_thread_tile_barrier[0]);
+         if (evas_thread_tile_exit) break;
+
+         evas_thread_tile_run(evas_thread_tile_cmds, evas_thread_tile_len,
+                              tiler->band);
+
+         eina_barrier_wait(&evas_thread_tile_barrier[1]);
+      }
+
+    return NULL;
+}
+
+static void evas_thread_tilers_init(void);
+
+static void
+evas_thread_tile_dispatch(Evas_Thread_Command *cmd, unsigned int len)
+{
+    unsigned int i;
+
+    /* the helpers are only started once something is actually tiled */
+    if (!evas_thread_tilers_tried) evas_thread_tilers_init();
+
+    if (evas_thread_bands > 1)
+      {
+         evas_thread_tile_cmds = cmd;
+         evas_thread_tile_len = len;
+
+         eina_barrier_wait(&evas_thread_tile_barrier[0]);
+         evas_thread_tile_run(cmd, len, 0);
+         eina_barrier_wait(&evas_thread_tile_barrier[1]);
+
+         evas_thread_tile_cmds = NULL;
+         evas_thread_tile_len = 0;
+      }
+    else
+      {
+         evas_thread_tile_run(cmd, len, 0);
+      }
+
+    for (i = 0; i < len; i++)
+      if (cmd[i].cb) cmd[i].cb(cmd[i].data);
 }
 
 static void*
@@ -102,6 +218,20 @@ evas_thread_worker_func(void *data EINA_UNUSED, Eina_Thread thread EINA_UNUSED)
 
          while (len)
            {
+              unsigned int n;
+
+              if (cmd->tile)
+                {
+                   for (n = 1; (n < len) && (cmd[n].tile); n++)
+                     ;
+
+                   evas_thread_tile_dispatch(cmd, n);
+
+                   cmd += n;
+                   len -= n;
+                   continue;
+                }
+
               assert(cmd->cb);
 
               cmd->cb(cmd->data);
@@ -117,6 +247,95 @@ out:
     return NULL;
 }
 
+static void
+evas_thread_tilers_init(void)
+{
+    const char *s;
+    unsigned int i, bands;
+    int n;
+
+    evas_thread_tilers_tried = EINA_TRUE;
+
+    s = getenv("EVAS_RENDER_THREADS");
+    if (s) n = atoi(s);
+    else n = eina_cpu_count();
+    if (n < 1) n = 1;
+    if (n > TH_MAX) n = TH_MAX;
+    bands = n;
+    if (bands == 1) return;
+
+    if (!eina_lock_new(&evas_thread_tile_start_lock))
+      return;
+    if (!eina_condition_new(&evas_thread_tile_start_cond,
+                            &evas_thread_tile_start_lock))
+      {
+         eina_lock_free(&evas_thread_tile_start_lock);
+         return;
+      }
+    evas_thread_tile_started = EINA_FALSE;
+    evas_thread_tile_start_failed = EINA_FALSE;
+
+    /* band 0 is drawn by the render thread itself */
+    for (i = 1; i < bands; i++)
+      {
+         evas_thread_tilers[i].band = i;
+         if (!eina_thread_create(&evas_thread_tilers[i].thread_id,
+                                 EINA_THREAD_NORMAL, -1,
+                                 evas_thread_tiler_func, &evas_thread_tilers[i]))
+           break;
+      }
+
+    if (i < bands)
+      evas_thread_tile_start_failed = EINA_TRUE;
+    else
+      {
+         eina_barrier_new(&evas_thread_tile_barrier[0], bands);
+         eina_barrier_new(&evas_thread_tile_barrier[1], bands);
+      }
+
+    eina_lock_take(&evas_thread_tile_start_lock);
+    evas_thread_tile_started = EINA_TRUE;
+    eina_condition_broadcast(&evas_thread_tile_start_cond);
+    eina_lock_release(&evas_thread_tile_start_lock);
+
+    if (evas_thread_tile_start_failed)
+      {
+         unsigned int started = i;
+
+         CRI("Could not create render tile thread %u, disabling tiled rendering.", i);
+         for (i = 1; i < started; i++)
+           eina_thread_join(evas_thread_tilers[i].thread_id);
+         eina_condition_free(&evas_thread_tile_start_cond);
+         eina_lock_free(&evas_thread_tile_start_lock);
+         return;
+      }
+
+    evas_thread_bands = bands;
+}
+
+static void
+evas_thread_tilers_shutdown(void)
+{
+    unsigned int i;
+
+    evas_thread_tilers_tried = EINA_FALSE;
+    if (evas_thread_bands == 1) return;
+
+    evas_thread_tile_exit = EINA_TRUE;
+    eina_barrier_wait(&evas_thread_tile_barrier[0]);
+
+    for (i = 1; i < evas_thread_bands; i++)
+      eina_thread_join(evas_thread_tilers[i].thread_id);
+
+    eina_barrier_free(&evas_thread_tile_barrier[0]);
+    eina_barrier_free(&evas_thread_tile_barrier[1]);
+    eina_condition_free(&evas_thread_tile_start_cond);
+    eina_lock_free(&evas_thread_tile_start_lock);
+
+    evas_thread_tile_exit = EINA_FALSE;
+    evas_thread_bands = 1;
+}
+
 void
 evas_thread_init(void)
 {
@@ -154,6 +373,7 @@ evas_thread_shutdown(void)
       evas_async_events_process();
 
     eina_thread_join(evas_thread_worker);
+    evas_thread_tilers_shutdown();
     eina_lock_free(&evas_thread_queue_lock);
     eina_condition_free(&evas_thread_queue_condition);
 
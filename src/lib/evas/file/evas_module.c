@@ -32,6 +32,9 @@ static Eina_List *eina_evas_modules = NULL;
 static Eina_List *evas_module_paths = NULL;
 static Eina_Array *evas_engines = NULL;
 
+static Evas_Module_Task_Split_Run evas_module_split_run = NULL;
+static unsigned int evas_module_split_max = 1;
+
 static Eina_List *
 _evas_module_append(Eina_List *list, char *path)
 {
@@ -704,3 +707,32 @@ evas_cserve_path_get(void)
      }
    return buf;
 }
+
+/* the preload threads register here to help loaders, so that loaders do
+ * not depend on them and also work where they do not exist */
+void
+evas_module_task_split_set(Evas_Module_Task_Split_Run run, unsigned int max)
+{
+   evas_module_split_run = run;
+   evas_module_split_max = ((run) && (max > 1)) ? max : 1;
+}
+
+EAPI unsigned int
+evas_module_task_split_max(void)
+{
+   return evas_module_split_max;
+}
+
+EAPI void
+evas_module_task_split_run(Evas_Module_Task_Split_Cb func, void *data, unsigned int count)
+{
+   unsigned int i;
+
+   if ((evas_module_split_run) && (count > 1))
+     {
+        evas_module_split_run(func, data, count);
+        return;
+     }
+   for (i = 0; i < count; i++)
+     func(data, i);
+}
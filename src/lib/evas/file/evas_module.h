@@ -22,5 +22,6 @@ void         evas_module_unref      (Evas_Module *em);
 void         evas_module_use        (Evas_Module *em);
 void         evas_module_clean      (void);
 void         evas_module_shutdown   (void);
+void         evas_module_task_split_set(Evas_Module_Task_Split_Run run, unsigned int max);
 
 #endif /* _EVAS_MODULE_H */
@@ -1744,8 +1744,10 @@ evas_filter_font_draw(Evas_Filter_Context *ctx, void *draw_context, int bufid,
         // Copied from eng_font_draw in the software engine.
 
         if (do_async) WRN("Async flag is ignored here!");
+        evas_common_font_cache_lock();
         evas_common_font_draw_prepare(text_props);
         evas_common_font_draw(surface, draw_context, x, y, text_props->glyphs);
+        evas_common_font_cache_unlock();
         evas_common_cpu_end_opt();
      }
 
@@ -13,6 +13,12 @@
 # endif
 #endif
 
+#ifdef NEED_AVX2
+# if defined BUILD_AVX2
+#  include <immintrin.h>
+# endif
+#endif
+
 /* src pixel flags: */
 
 /* pixels none */
@@ -77,8 +83,10 @@
 #define CPU_NEON 5
 /* CPU SSE3 */
 #define CPU_SSE3 6
+/* CPU AVX2 */
+#define CPU_AVX2 7
 /* cpu flags count */
-#define CPU_LAST 7
+#define CPU_LAST 8
 
 
 /* some useful constants */
@@ -409,6 +417,107 @@ mul3_sym_sse3(__m128i x, __m128i y) {
 #endif
 #endif
 
+/* some useful AVX2 inline functions, they work on 8 pixels at once and
+ * give the same results as the C macros above */
+
+#ifdef NEED_AVX2
+#ifdef BUILD_AVX2
+
+/* MUL_256(), with a multiplier (up to 256) per pixel */
+static EFL_ALWAYS_INLINE __m256i
+mul_256_avx2(__m256i a, __m256i c)
+{
+   const __m256i rb_mask = _mm256_set1_epi32(0x00ff00ff);
+   __m256i rb, ga;
+
+   /* the multiplier in both 16 bit halves of each pixel */
+   a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+   rb = _mm256_mullo_epi16(a, _mm256_and_si256(c, rb_mask));
+   rb = _mm256_srli_epi16(rb, 8);
+   ga = _mm256_mullo_epi16(a, _mm256_srli_epi16(c, 8));
+   ga = _mm256_andnot_si256(rb_mask, ga);
+   return _mm256_or_si256(rb, ga);
+}
+
+/* MUL_SYM(), with a multiplier (up to 255) per pixel */
+static EFL_ALWAYS_INLINE __m256i
+mul_sym_avx2(__m256i a, __m256i c)
+{
+   const __m256i rb_mask = _mm256_set1_epi32(0x00ff00ff);
+   __m256i rb, ga;
+
+   a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+   rb = _mm256_mullo_epi16(a, _mm256_and_si256(c, rb_mask));
+   rb = _mm256_srli_epi16(_mm256_add_epi16(rb, rb_mask), 8);
+   ga = _mm256_mullo_epi16(a, _mm256_srli_epi16(c, 8));
+   ga = _mm256_andnot_si256(rb_mask, _mm256_add_epi16(ga, rb_mask));
+   return _mm256_or_si256(rb, ga);
+}
+
+/* MUL4_SYM() */
+static EFL_ALWAYS_INLINE __m256i
+mul4_sym_avx2(__m256i x, __m256i y)
+{
+   const __m256i rb_mask = _mm256_set1_epi32(0x00ff00ff);
+   __m256i rb, ga;
+
+   rb = _mm256_mullo_epi16(_mm256_and_si256(x, rb_mask),
+                           _mm256_and_si256(y, rb_mask));
+   rb = _mm256_srli_epi16(_mm256_add_epi16(rb, rb_mask), 8);
+   ga = _mm256_mullo_epi16(_mm256_srli_epi16(x, 8), _mm256_srli_epi16(y, 8));
+   ga = _mm256_andnot_si256(rb_mask, _mm256_add_epi16(ga, rb_mask));
+   return _mm256_or_si256(rb, ga);
+}
+
+/* MUL3_SYM(), which doesn't round the green channel */
+static EFL_ALWAYS_INLINE __m256i
+mul3_sym_avx2(__m256i x, __m256i y)
+{
+   const __m256i rb_mask = _mm256_set1_epi32(0x00ff00ff);
+   const __m256i g_mask = _mm256_set1_epi32(0x0000ff00);
+   __m256i rb, g;
+
+   rb = _mm256_mullo_epi16(_mm256_and_si256(x, rb_mask),
+                           _mm256_and_si256(y, rb_mask));
+   rb = _mm256_srli_epi16(_mm256_add_epi16(rb, rb_mask), 8);
+   g = _mm256_mullo_epi16(_mm256_srli_epi16(x, 8), _mm256_srli_epi16(y, 8));
+   g = _mm256_and_si256(g, g_mask);
+   return _mm256_or_si256(rb, g);
+}
+
+/* 256 - alpha of each pixel */
+static EFL_ALWAYS_INLINE __m256i
+sub4_alpha_avx2(__m256i c)
+{
+   const __m256i alpha = _mm256_set1_epi32(256);
+
+   return _mm256_sub_epi32(alpha, _mm256_srli_epi32(c, 24));
+}
+
+/* INTERP_256(), done on 32 bit words like the C macro, so that it rounds
+ * the same way */
+static EFL_ALWAYS_INLINE __m256i
+interp_256_avx2(__m256i a, __m256i c0, __m256i c1)
+{
+   const __m256i rb_mask = _mm256_set1_epi32(0x00ff00ff);
+   __m256i rb, ga;
+
+   rb = _mm256_sub_epi32(_mm256_and_si256(c0, rb_mask),
+                         _mm256_and_si256(c1, rb_mask));
+   rb = _mm256_srli_epi32(_mm256_mullo_epi32(rb, a), 8);
+   rb = _mm256_add_epi32(rb, _mm256_and_si256(c1, rb_mask));
+   rb = _mm256_and_si256(rb, rb_mask);
+   ga = _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(c0, 8), rb_mask),
+                         _mm256_and_si256(_mm256_srli_epi32(c1, 8), rb_mask));
+   ga = _mm256_mullo_epi32(ga, a);
+   ga = _mm256_add_epi32(ga, _mm256_andnot_si256(rb_mask, c1));
+   ga = _mm256_andnot_si256(rb_mask, ga);
+   return _mm256_or_si256(rb, ga);
+}
+
+#endif
+#endif
+
 #define LOOP_ALIGNED_U1_A48(DEST, LENGTH, UOP, A4OP, A8OP) \
    { \
       while((uintptr_t)DEST & 0xF && LENGTH) UOP \
@@ -432,4 +541,13 @@ mul3_sym_sse3(__m128i x, __m128i y) {
       } \
    }
 
+#define LOOP_ALIGNED_U1_A8(DEST, LENGTH, UOP, A8OP) \
+   { \
+      while((uintptr_t)DEST & 0x1F && LENGTH) UOP \
+   \
+      while(LENGTH >= 8) A8OP \
+   \
+      while(LENGTH) UOP \
+   }
+
 #endif
@@ -438,10 +438,12 @@ typedef void (*Evas_Engine_Thread_Task_Cb)(void *engine_data, Image_Entry *ie, v
 /*****************************************************************************/
 
 typedef void (*Evas_Thread_Command_Cb)(void *data);
+typedef void (*Evas_Thread_Command_Tile_Cb)(void *data, unsigned int band, unsigned int bands);
 typedef struct _Evas_Thread_Command Evas_Thread_Command;
 
 struct _Evas_Thread_Command
 {
+   Evas_Thread_Command_Tile_Cb tile;
    Evas_Thread_Command_Cb cb;
    void *data;
 };
@@ -490,7 +492,8 @@ typedef enum _CPU_Features
    CPU_FEATURE_VIS     = (1 << 4),
    CPU_FEATURE_VIS2    = (1 << 5),
    CPU_FEATURE_NEON    = (1 << 6),
-   CPU_FEATURE_SSE3    = (1 << 7)
+   CPU_FEATURE_SSE3    = (1 << 7),
+   CPU_FEATURE_AVX2    = (1 << 8)
 } CPU_Features;
 
 typedef enum _Font_Hint_Flags
@@ -986,6 +989,7 @@ struct _RGBA_Font_Glyph_Out
 
 struct _RGBA_Font_Glyph
 {
+   EINA_INLIST; /* in the glyph atlas LRU while not drawn from */
    FT_UInt         index;
    Evas_Coord      width;
    Evas_Coord      x_bear;
@@ -996,6 +1000,9 @@ struct _RGBA_Font_Glyph
    void           *ext_dat;
    void           (*ext_dat_free) (void *ext_dat);
    RGBA_Font_Int   *fi;
+   void            *atlas_page; /* NULL if the bitmap is not in an atlas page */
+   int              atlas_size; /* bytes of the glyph atlas held, 0 if none */
+   int              atlas_refs; /* glyph arrays drawing it */
 };
 
 struct _RGBA_Gfx_Compositor
@@ -1270,6 +1277,8 @@ void              evas_all_sync(void);
 void              evas_thread_init(void);
 void              evas_thread_shutdown(void);
 EAPI void         evas_thread_cmd_enqueue(Evas_Thread_Command_Cb cb, void *data);
+EAPI void         evas_thread_cmd_tile_enqueue(Evas_Thread_Command_Tile_Cb tile, Evas_Thread_Command_Cb cb, void *data);
+EAPI void         evas_thread_tile_band_get(const RGBA_Image *dst, unsigned int band, unsigned int bands, Eina_Rectangle *r);
 EAPI void         evas_thread_queue_flush(Evas_Thread_Command_Cb cb, void *data);
 
 typedef enum _Evas_Render_Mode
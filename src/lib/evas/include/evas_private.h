@@ -22,6 +22,7 @@
 /* #define REND_DBG 1 */
 
 typedef struct _Evas_Layer                  Evas_Layer;
+typedef struct _Evas_Event_Index            Evas_Event_Index;
 typedef struct _Evas_Size                   Evas_Size;
 typedef struct _Evas_Aspect                 Evas_Aspect;
 typedef struct _Evas_Border                 Evas_Border;
@@ -452,6 +453,7 @@ struct _Evas_Layer
    Evas_Public_Data *evas;
 
    void             *engine_data;
+   Evas_Event_Index *event_index; /* spatial index of objects for events */
    int               usage;
    unsigned char     delete_me : 1;
 };
@@ -624,6 +626,11 @@ struct _Evas_Object_Protected_Data
 
    unsigned int                ref;
 
+   // Spatial index of the members of a smart object, and position of the
+   // object in the index of its smart parent or layer
+   Evas_Event_Index           *event_index;
+   unsigned int                event_index_pos;
+
    unsigned char               delete_me;
 
    struct  {
@@ -978,6 +985,12 @@ void evas_object_mapped_clip_across_mark(Evas_Object *obj, Evas_Object_Protected
 void evas_event_callback_call(Evas *e, Evas_Callback_Type type, void *event_info);
 void evas_object_event_callback_call(Evas_Object *obj, Evas_Object_Protected_Data *pd, Evas_Callback_Type type, void *event_info, int event_id);
 Eina_List *evas_event_objects_event_list(Evas *e, Evas_Object *stop, int x, int y);
+Eina_Bool evas_event_index_query(const Eina_Inlist *list, int x, int y, Eina_Inarray *result);
+void evas_event_index_object_changed(Evas_Object_Protected_Data *obj);
+void evas_event_index_object_clip_changed(Evas_Object_Protected_Data *obj);
+void evas_event_index_list_changed(Evas_Object_Protected_Data *obj);
+void evas_event_index_free(Evas_Event_Index *index);
+EAPI void evas_event_index_enabled_set(Eina_Bool enabled);
 int evas_mem_free(int mem_required);
 int evas_mem_degrade(int mem_required);
 void evas_debug_error(void);
@@ -1240,6 +1253,7 @@ EAPI int evas_thread_main_loop_end(void);
 
 void _evas_preload_thread_init(void);
 void _evas_preload_thread_shutdown(void);
+EAPI unsigned int _evas_preload_split_parts_get(void);
 Evas_Preload_Pthread *evas_preload_thread_run(void (*func_heavy)(void *data),
                                               void (*func_end)(void *data),
                                               void (*func_cancel)(void *data),
@@ -171,6 +171,8 @@ eng_setup(Evas *eo_e, void *in)
    if (!e->engine.data.output) return 0;
    if (!e->engine.data.context)
      e->engine.data.context = e->engine.func->context_new(e->engine.data.output);
+   if (info->scale_threads > 0)
+     evas_common_scale_smooth_threads_set(info->scale_threads);
    return 1;
 }
 
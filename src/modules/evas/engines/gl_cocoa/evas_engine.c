@@ -1064,8 +1064,10 @@ eng_font_draw(void *data, void *context, void *surface, Evas_Font_Set *font, int
    					      evas_gl_font_texture_new,
    					      evas_gl_font_texture_free,
    					      evas_gl_font_texture_draw);
+	evas_common_font_cache_lock();
 	evas_common_font_draw_prepare(intl_props);
 	evas_common_font_draw(im, context, x, y, intl_props);
+	evas_common_font_cache_unlock();
 	evas_common_draw_context_font_ext_set(context,
 					      NULL,
 					      NULL,
@@ -512,15 +512,24 @@ eng_context_render_op_get(void *data EINA_UNUSED, void *context)
 }
 
 static void
-_draw_thread_rectangle_draw(void *data)
+_draw_thread_rectangle_draw(void *data, unsigned int band, unsigned int bands)
 {
     Evas_Thread_Command_Rect *rect = data;
+    Eina_Rectangle r;
+
+    evas_thread_tile_band_get(rect->surface, band, bands, &r);
+    RECTS_CLIP_TO_RECT(r.x, r.y, r.w, r.h, rect->x, rect->y, rect->w, rect->h);
+    if ((r.w <= 0) || (r.h <= 0)) return;
 
     evas_common_rectangle_rgba_draw(rect->surface,
                                     rect->color, rect->render_op,
-                                    rect->x, rect->y, rect->w, rect->h);
+                                    r.x, r.y, r.w, r.h);
+}
 
-    eina_mempool_free(_mp_command_rect, rect);
+static void
+_draw_thread_rectangle_free(void *data)
+{
+    eina_mempool_free(_mp_command_rect, data);
 }
 
 static void
@@ -542,7 +551,8 @@ _draw_rectangle_thread_cmd(RGBA_Image *dst, RGBA_Draw_Context *dc, int x, int y,
    cr->w = w;
    cr->h = h;
 
-   evas_thread_cmd_enqueue(_draw_thread_rectangle_draw, cr);
+   evas_thread_cmd_tile_enqueue(_draw_thread_rectangle_draw,
+                                _draw_thread_rectangle_free, cr);
 }
 
 static void
@@ -1222,26 +1232,34 @@ eng_image_data_preload_cancel(void *data EINA_UNUSED, void *image, const Eo *tar
 }
 
 static void
-_draw_thread_image_draw(void *data)
+_draw_thread_image_draw(void *data, unsigned int band, unsigned int bands)
 {
    Evas_Thread_Command_Image *image = data;
+   Eina_Rectangle clip;
+
+   evas_thread_tile_band_get(image->surface, band, bands, &clip);
+   if (!eina_rectangle_intersection(&clip, &image->clip)) return;
 
    if (image->smooth)
      evas_common_scale_rgba_smooth_draw
        (image->image, image->surface,
-        image->clip.x, image->clip.y, image->clip.w, image->clip.h,
+        clip.x, clip.y, clip.w, clip.h,
         image->mul_col, image->render_op,
         image->src.x, image->src.y, image->src.w, image->src.h,
         image->dst.x, image->dst.y, image->dst.w, image->dst.h);
    else
      evas_common_scale_rgba_sample_draw
        (image->image, image->surface,
-        image->clip.x, image->clip.y, image->clip.w, image->clip.h,
+        clip.x, clip.y, clip.w, clip.h,
         image->mul_col, image->render_op,
         image->src.x, image->src.y, image->src.w, image->src.h,
         image->dst.x, image->dst.y, image->dst.w, image->dst.h);
+}
 
-   eina_mempool_free(_mp_command_image, image);
+static void
+_draw_thread_image_free(void *data)
+{
+   eina_mempool_free(_mp_command_image, data);
 }
 
 static Eina_Bool
@@ -1283,7 +1301,8 @@ _image_draw_thread_cmd(RGBA_Image *src, RGBA_Image *dst, RGBA_Draw_Context *dc,
    cr->render_op = dc->render_op;
    cr->smooth = smooth;
 
-   evas_thread_cmd_enqueue(_draw_thread_image_draw, cr);
+   evas_thread_cmd_tile_enqueue(_draw_thread_image_draw,
+                                _draw_thread_image_free, cr);
 
    return EINA_TRUE;
 }
@@ -1998,76 +2017,130 @@ static Evas_Font_Set *
 eng_font_load(void *data EINA_UNUSED, const char *name, int size,
       Font_Rend_Flags wanted_rend)
 {
-   return (Evas_Font_Set *) evas_common_font_load(name, size, wanted_rend);
+   Evas_Font_Set *ret;
+
+   evas_common_font_cache_lock();
+   ret = (Evas_Font_Set *) evas_common_font_load(name, size, wanted_rend);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static Evas_Font_Set *
 eng_font_memory_load(void *data EINA_UNUSED, const char *source, const char *name, int size, const void *fdata, int fdata_size, Font_Rend_Flags wanted_rend)
 {
-   return (Evas_Font_Set *) evas_common_font_memory_load(source, name, size,
+   Evas_Font_Set *ret;
+
+   evas_common_font_cache_lock();
+   ret = (Evas_Font_Set *) evas_common_font_memory_load(source, name, size,
          fdata, fdata_size, wanted_rend);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static Evas_Font_Set *
 eng_font_add(void *data EINA_UNUSED, Evas_Font_Set *font, const char *name, int size, Font_Rend_Flags wanted_rend)
 {
-   return (Evas_Font_Set *) evas_common_font_add((RGBA_Font *) font, name,
+   Evas_Font_Set *ret;
+
+   evas_common_font_cache_lock();
+   ret = (Evas_Font_Set *) evas_common_font_add((RGBA_Font *) font, name,
          size, wanted_rend);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static Evas_Font_Set *
 eng_font_memory_add(void *data EINA_UNUSED, Evas_Font_Set *font, const char *source, const char *name, int size, const void *fdata, int fdata_size, Font_Rend_Flags wanted_rend)
 {
-   return (Evas_Font_Set *) evas_common_font_memory_add((RGBA_Font *) font,
+   Evas_Font_Set *ret;
+
+   evas_common_font_cache_lock();
+   ret = (Evas_Font_Set *) evas_common_font_memory_add((RGBA_Font *) font,
          source, name, size, fdata, fdata_size, wanted_rend);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static void
 eng_font_free(void *data EINA_UNUSED, Evas_Font_Set *font)
 {
+   evas_common_font_cache_lock();
    evas_common_font_free((RGBA_Font *) font);
+   evas_common_font_cache_unlock();
 }
 
 static int
 eng_font_ascent_get(void *data EINA_UNUSED, Evas_Font_Set *font)
 {
-   return evas_common_font_ascent_get((RGBA_Font *) font);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_ascent_get((RGBA_Font *) font);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_descent_get(void *data EINA_UNUSED, Evas_Font_Set *font)
 {
-   return evas_common_font_descent_get((RGBA_Font *) font);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_descent_get((RGBA_Font *) font);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_max_ascent_get(void *data EINA_UNUSED, Evas_Font_Set *font)
 {
-   return evas_common_font_max_ascent_get((RGBA_Font *) font);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_max_ascent_get((RGBA_Font *) font);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_max_descent_get(void *data EINA_UNUSED, Evas_Font_Set *font)
 {
-   return evas_common_font_max_descent_get((RGBA_Font *) font);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_max_descent_get((RGBA_Font *) font);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static void
 eng_font_string_size_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_Text_Props *text_props, int *w, int *h)
 {
+   evas_common_font_cache_lock();
    evas_common_font_query_size((RGBA_Font *) font, text_props, w, h);
+   evas_common_font_cache_unlock();
 }
 
 static int
 eng_font_inset_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_Text_Props *text_props)
 {
-   return evas_common_font_query_inset((RGBA_Font *) font, text_props);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_query_inset((RGBA_Font *) font, text_props);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_right_inset_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_Text_Props *text_props)
 {
-   return evas_common_font_query_right_inset((RGBA_Font *) font, text_props);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_query_right_inset((RGBA_Font *) font, text_props);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
@@ -2075,7 +2148,9 @@ eng_font_h_advance_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_T
 {
    int h, v;
 
+   evas_common_font_cache_lock();
    evas_common_font_query_advance((RGBA_Font *) font, text_props, &h, &v);
+   evas_common_font_cache_unlock();
    return h;
 }
 
@@ -2084,47 +2159,79 @@ eng_font_v_advance_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_T
 {
    int h, v;
 
+   evas_common_font_cache_lock();
    evas_common_font_query_advance((RGBA_Font *) font, text_props, &h, &v);
+   evas_common_font_cache_unlock();
    return v;
 }
 
 static int
 eng_font_pen_coords_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_Text_Props *text_props, int pos, int *cpen_x, int *cy, int *cadv, int *ch)
 {
-   return evas_common_font_query_pen_coords((RGBA_Font *) font, text_props, pos, cpen_x, cy, cadv, ch);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_query_pen_coords((RGBA_Font *) font, text_props, pos, cpen_x, cy, cadv, ch);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static Eina_Bool
 eng_font_text_props_info_create(void *data EINA_UNUSED, Evas_Font_Instance *fi, const Eina_Unicode *text, Evas_Text_Props *text_props, const Evas_BiDi_Paragraph_Props *par_props, size_t par_pos, size_t len, Evas_Text_Props_Mode mode)
 {
-   return evas_common_text_props_content_create((RGBA_Font_Int *) fi, text,
+   Eina_Bool ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_text_props_content_create((RGBA_Font_Int *) fi, text,
          text_props, par_props, par_pos, len, mode);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_char_coords_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_Text_Props *text_props, int pos, int *cx, int *cy, int *cw, int *ch)
 {
-   return evas_common_font_query_char_coords((RGBA_Font *) font, text_props, pos, cx, cy, cw, ch);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_query_char_coords((RGBA_Font *) font, text_props, pos, cx, cy, cw, ch);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_char_at_coords_get(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_Text_Props *text_props, int x, int y, int *cx, int *cy, int *cw, int *ch)
 {
-   return evas_common_font_query_char_at_coords((RGBA_Font *) font, text_props, x, y, cx, cy, cw, ch);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_query_char_at_coords((RGBA_Font *) font, text_props, x, y, cx, cy, cw, ch);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_last_up_to_pos(void *data EINA_UNUSED, Evas_Font_Set *font, const Evas_Text_Props *text_props, int x, int y)
 {
-   return evas_common_font_query_last_up_to_pos((RGBA_Font *) font, text_props, x, y);
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_query_last_up_to_pos((RGBA_Font *) font, text_props, x, y);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static int
 eng_font_run_font_end_get(void *data EINA_UNUSED, Evas_Font_Set *font, Evas_Font_Instance **script_fi, Evas_Font_Instance **cur_fi, Evas_Script_Type script, const Eina_Unicode *text, int run_len)
 {
-   return evas_common_font_query_run_font_end_get((RGBA_Font *) font,
+   int ret;
+
+   evas_common_font_cache_lock();
+   ret = evas_common_font_query_run_font_end_get((RGBA_Font *) font,
          (RGBA_Font_Int **) script_fi, (RGBA_Font_Int **) cur_fi,
          script, text, run_len);
+   evas_common_font_cache_unlock();
+   return ret;
 }
 
 static void
@@ -2154,6 +2261,41 @@ _draw_thread_font_draw(void *data)
    eina_mempool_free(_mp_command_font, font);
 }
 
+static void
+_draw_thread_font_tile_draw(void *data, unsigned int band, unsigned int bands)
+{
+   Evas_Thread_Command_Font *font = data;
+   RGBA_Draw_Context dc;
+   Eina_Rectangle clip, ext;
+
+   evas_thread_tile_band_get(font->dst, band, bands, &clip);
+   if (font->clip_use &&
+       !eina_rectangle_intersection(&clip, &font->clip_rect))
+     return;
+   ext = font->ext;
+   if (!eina_rectangle_intersection(&ext, &clip)) return;
+
+   memset(&dc, 0, sizeof(dc));
+   dc.col.col = font->col;
+   dc.clip.use = EINA_TRUE;
+   dc.clip.x = clip.x;
+   dc.clip.y = clip.y;
+   dc.clip.w = clip.w;
+   dc.clip.h = clip.h;
+
+   evas_common_font_rgba_draw
+     (font->dst, &dc,
+      font->x, font->y, font->glyphs, font->func,
+      ext.x, ext.y, ext.w, ext.h,
+      font->im_w, font->im_h);
+}
+
+static void
+_draw_thread_font_free(void *data)
+{
+   eina_mempool_free(_mp_command_font, data);
+}
+
 static Eina_Bool
 _font_draw_thread_cmd(RGBA_Image *dst, RGBA_Draw_Context *dc, int x, int y, Evas_Glyph_Array *glyphs, RGBA_Gfx_Func func, int ext_x, int ext_y, int ext_w, int ext_h, int im_w, int im_h)
 {
@@ -2179,7 +2321,13 @@ _font_draw_thread_cmd(RGBA_Image *dst, RGBA_Draw_Context *dc, int x, int y, Evas
    cf->im_w = im_w;
    cf->im_h = im_h;
 
-   evas_thread_cmd_enqueue(_draw_thread_font_draw, cf);
+   /* Glyphs of an engine extension are created lazily while drawing, they
+      can't be split across the tile threads. */
+   if (cf->gl_new)
+     evas_thread_cmd_enqueue(_draw_thread_font_draw, cf);
+   else
+     evas_thread_cmd_tile_enqueue(_draw_thread_font_tile_draw,
+                                  _draw_thread_font_free, cf);
 
    return EINA_TRUE;
 }
@@ -2187,13 +2335,16 @@ _font_draw_thread_cmd(RGBA_Image *dst, RGBA_Draw_Context *dc, int x, int y, Evas
 static Eina_Bool
 eng_font_draw(void *data EINA_UNUSED, void *context, void *surface, Evas_Font_Set *font EINA_UNUSED, int x, int y, int w EINA_UNUSED, int h EINA_UNUSED, int ow EINA_UNUSED, int oh EINA_UNUSED, Evas_Text_Props *text_props, Eina_Bool do_async)
 {
+   Eina_Bool ret = EINA_FALSE;
+
+   evas_common_font_cache_lock();
    if (do_async)
      {
         evas_common_font_draw_prepare(text_props);
-        if (!text_props->glyphs) return EINA_FALSE;
-
-        return evas_common_font_draw_cb(surface, context, x, y, text_props->glyphs,
-                                        _font_draw_thread_cmd);
+        if (text_props->glyphs)
+          ret = evas_common_font_draw_cb(surface, context, x, y,
+                                         text_props->glyphs,
+                                         _font_draw_thread_cmd);
      }
 #ifdef BUILD_PIPE_RENDER
    else if ((cpunum > 1))
@@ -2205,8 +2356,9 @@ eng_font_draw(void *data EINA_UNUSED, void *context, void *surface, Evas_Font_Se
         evas_common_font_draw(surface, context, x, y, text_props->glyphs);
         evas_common_cpu_end_opt();
      }
+   evas_common_font_cache_unlock();
 
-   return EINA_FALSE;
+   return ret;
 }
 
 static void
@@ -2214,16 +2366,20 @@ eng_font_cache_flush(void *data EINA_UNUSED)
 {
    int tmp_size;
 
+   evas_common_font_cache_lock();
    tmp_size = evas_common_font_cache_get();
    evas_common_font_cache_set(0);
    evas_common_font_flush();
    evas_common_font_cache_set(tmp_size);
+   evas_common_font_cache_unlock();
 }
 
 static void
 eng_font_cache_set(void *data EINA_UNUSED, int bytes)
 {
+   evas_common_font_cache_lock();
    evas_common_font_cache_set(bytes);
+   evas_common_font_cache_unlock();
 }
 
 static int
@@ -2235,7 +2391,9 @@ eng_font_cache_get(void *data EINA_UNUSED)
 static void
 eng_font_hinting_set(void *data EINA_UNUSED, Evas_Font_Set *font, int hinting)
 {
+   evas_common_font_cache_lock();
    evas_common_font_hinting_set((RGBA_Font *) font, hinting);
+   evas_common_font_cache_unlock();
 }
 
 static int
@@ -3718,6 +3876,8 @@ init_gl(void)
 static int
 module_open(Evas_Module *em)
 {
+   const char *s;
+
    if (!em) return 0;
    _evas_soft_gen_log_dom = eina_log_domain_register
      ("evas-software_generic", EVAS_DEFAULT_LOG_COLOR);
@@ -3754,6 +3914,13 @@ module_open(Evas_Module *em)
 
    em->functions = (void *)(&func);
    cpunum = eina_cpu_count();
+
+   /* large smooth scales drawn from the main loop can be split across
+    * a pool of threads, off by default, the engines set it from their
+    * info's scale_threads */
+   s = getenv("EVAS_SCALE_THREADS");
+   if (s && (atoi(s) > 1)) evas_common_scale_smooth_threads_set(atoi(s));
+
    return 1;
 }
 
@@ -3766,6 +3933,7 @@ module_close(Evas_Module *em EINA_UNUSED)
    eina_mempool_del(_mp_command_image);
    eina_mempool_del(_mp_command_font);
    eina_mempool_del(_mp_command_map);
+   evas_common_scale_smooth_threads_set(1);
    eina_log_domain_unregister(_evas_soft_gen_log_dom);
 }
 
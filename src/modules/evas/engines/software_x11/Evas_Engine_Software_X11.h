@@ -47,6 +47,10 @@ struct _Evas_Engine_Info_Software_X11
 
    /* non-blocking or blocking mode */
    Evas_Engine_Render_Mode render_mode;
+
+   /* threads splitting the large smooth scales drawn from the main loop,
+    * 0 keeps the EVAS_SCALE_THREADS default */
+   int scale_threads;
 };
 
 #endif
@@ -626,6 +626,8 @@ eng_setup(Evas *eo_e, void *in)
      }
 
    re = e->engine.data.output;
+   if (info->scale_threads > 0)
+     evas_common_scale_smooth_threads_set(info->scale_threads);
 
    return 1;
 }
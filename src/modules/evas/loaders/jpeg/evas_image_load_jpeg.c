@@ -154,6 +154,341 @@ _evas_jpeg_membuf_src(j_decompress_ptr cinfo,
    return 0;
 }
 
+/* Large baseline files with restart markers can be decoded in horizontal
+ * bands at the same time. The entropy coded data is cut at the restart
+ * markers that fall at the start of an MCU row, and each band is given to
+ * its own decoder as a file of its own: the headers with the height of the
+ * band, then its part of the data with the markers renumbered from 0. The
+ * bands are then converted straight into their rows of the image. */
+#define JPEG_SPLIT_MIN_PIXELS (1024 * 1024)
+
+typedef struct _JPEG_Split_Band JPEG_Split_Band;
+struct _JPEG_Split_Band
+{
+   unsigned int first, last; /* restart intervals */
+   unsigned int src_h;
+   unsigned int y, h;
+   Eina_Bool ok;
+};
+
+typedef struct _JPEG_Split JPEG_Split;
+struct _JPEG_Split
+{
+   const unsigned char *map;
+   size_t *seg;
+   size_t header_len;
+   size_t height_pos;
+   J_COLOR_SPACE out_color_space;
+   unsigned int scale;
+   unsigned int w;
+   int components;
+   DATA32 *pixels;
+   JPEG_Split_Band *bands;
+};
+
+static void
+_evas_jpeg_split_band_decode(void *data, unsigned int part)
+{
+   JPEG_Split *split = data;
+   JPEG_Split_Band *band = &split->bands[part];
+   struct jpeg_decompress_struct cinfo;
+   struct _JPEG_error_mgr jerr;
+   unsigned char *buf, *p;
+   size_t len, size;
+   DATA8 *ptr, *line[16], *lines;
+   DATA32 *ptr2;
+   unsigned int x, y, l, i, scans;
+
+   len = (split->seg[band->last] - 2) - split->seg[band->first];
+   size = split->header_len + len + 2;
+   buf = malloc(size);
+   lines = malloc(split->w * 16 * split->components);
+   if ((!buf) || (!lines)) goto on_error;
+
+   memcpy(buf, split->map, split->header_len);
+   buf[split->height_pos] = band->src_h >> 8;
+   buf[split->height_pos + 1] = band->src_h & 0xff;
+   p = buf + split->header_len;
+   memcpy(p, split->map + split->seg[band->first], len);
+   for (i = band->first + 1; i < band->last; i++)
+     p[split->seg[i] - 1 - split->seg[band->first]] =
+       JPEG_RST0 + ((i - band->first - 1) & 7);
+   p[len] = 0xff;
+   p[len + 1] = JPEG_EOI;
+
+   memset(&cinfo, 0, sizeof(cinfo));
+   cinfo.err = jpeg_std_error(&(jerr.pub));
+   jerr.pub.error_exit = _JPEGFatalErrorHandler;
+   jerr.pub.emit_message = _JPEGErrorHandler2;
+   jerr.pub.output_message = _JPEGErrorHandler;
+   if (setjmp(jerr.setjmp_buffer))
+     {
+        jpeg_destroy_decompress(&cinfo);
+        _evas_jpeg_membuf_src_term(&cinfo);
+        goto on_error;
+     }
+   jpeg_create_decompress(&cinfo);
+   if (_evas_jpeg_membuf_src(&cinfo, buf, size))
+     {
+        jpeg_destroy_decompress(&cinfo);
+        goto on_error;
+     }
+
+   jpeg_read_header(&cinfo, TRUE);
+   cinfo.do_fancy_upsampling = FALSE;
+   cinfo.do_block_smoothing = FALSE;
+   cinfo.dct_method = JDCT_ISLOW;
+   cinfo.dither_mode = JDITHER_ORDERED;
+   cinfo.out_color_space = split->out_color_space;
+   if (split->scale > 1)
+     {
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = split->scale;
+     }
+   jpeg_calc_output_dimensions(&(cinfo));
+   jpeg_start_decompress(&cinfo);
+
+   if ((cinfo.output_width != split->w) ||
+       (cinfo.output_height != band->h) ||
+       (cinfo.output_components != split->components) ||
+       (cinfo.rec_outbuf_height > 16))
+     {
+        jpeg_destroy_decompress(&cinfo);
+        _evas_jpeg_membuf_src_term(&cinfo);
+        goto on_error;
+     }
+
+   for (i = 0; (int)i < cinfo.rec_outbuf_height; i++)
+     line[i] = lines + (i * split->w * split->components);
+   ptr2 = split->pixels + (band->y * split->w);
+   for (l = 0; l < band->h; l += cinfo.rec_outbuf_height)
+     {
+        jpeg_read_scanlines(&cinfo, line, cinfo.rec_outbuf_height);
+        scans = cinfo.rec_outbuf_height;
+        if ((band->h - l) < scans) scans = band->h - l;
+        ptr = lines;
+        if (split->components == 3)
+          {
+             for (y = 0; y < scans; y++)
+               for (x = 0; x < split->w; x++)
+                 {
+                    *ptr2 = ARGB_JOIN(0xff, ptr[0], ptr[1], ptr[2]);
+                    ptr += 3;
+                    ptr2++;
+                 }
+          }
+        else
+          {
+             for (y = 0; y < scans; y++)
+               for (x = 0; x < split->w; x++)
+                 {
+                    *ptr2 = ARGB_JOIN(0xff, ptr[0], ptr[0], ptr[0]);
+                    ptr++;
+                    ptr2++;
+                 }
+          }
+     }
+
+   jpeg_finish_decompress(&cinfo);
+   jpeg_destroy_decompress(&cinfo);
+   _evas_jpeg_membuf_src_term(&cinfo);
+   band->ok = EINA_TRUE;
+
+ on_error:
+   free(lines);
+   free(buf);
+}
+
+/* finds the height in the frame header, the end of the scan header and the
+ * start of every restart interval, returns EINA_FALSE if the file is not
+ * a single interleaved baseline scan with exactly n intervals */
+static Eina_Bool
+_evas_jpeg_split_parse(JPEG_Split *split, size_t length, unsigned int n)
+{
+   const unsigned char *map = split->map;
+   const unsigned char *p;
+   size_t pos = 2, seglen;
+   unsigned int count = 0;
+
+   split->height_pos = 0;
+   for (;;)
+     {
+        if (pos + 4 > length) return EINA_FALSE;
+        if (map[pos] != 0xff) return EINA_FALSE;
+        if (map[pos + 1] == 0xff)
+          {
+             pos++;
+             continue;
+          }
+        seglen = (map[pos + 2] << 8) | map[pos + 3];
+        if (seglen < 2) return EINA_FALSE;
+
+        switch (map[pos + 1])
+          {
+           case 0xc0: /* SOF0 */
+           case 0xc1: /* SOF1 */
+             if (seglen < 7) return EINA_FALSE;
+             split->height_pos = pos + 5;
+             break;
+           case 0xc4: /* DHT */
+           case 0xcc: /* DAC */
+             break;
+           case JPEG_EOI:
+           case 0x01: /* TEM */
+             return EINA_FALSE;
+           default:
+             /* other frame types and standalone markers */
+             if ((map[pos + 1] >= 0xc2) && (map[pos + 1] <= 0xcf))
+               return EINA_FALSE;
+             if ((map[pos + 1] >= JPEG_RST0) && (map[pos + 1] <= JPEG_RST0 + 7))
+               return EINA_FALSE;
+             break;
+          }
+        if (map[pos + 1] == 0xda) /* SOS */
+          {
+             split->header_len = pos + 2 + seglen;
+             break;
+          }
+        pos += 2 + seglen;
+     }
+   if ((!split->height_pos) || (split->header_len > length))
+     return EINA_FALSE;
+
+   split->seg[count++] = split->header_len;
+   pos = split->header_len;
+   for (;;)
+     {
+        p = memchr(map + pos, 0xff, length - pos);
+        if (!p) return EINA_FALSE;
+        pos = p - map;
+        if (pos + 1 >= length) return EINA_FALSE;
+        if (map[pos + 1] == 0x00)
+          {
+             pos += 2;
+             continue;
+          }
+        if (map[pos + 1] == 0xff)
+          {
+             pos++;
+             continue;
+          }
+        if ((map[pos + 1] >= JPEG_RST0) && (map[pos + 1] <= JPEG_RST0 + 7))
+          {
+             if (count >= n) return EINA_FALSE;
+             if (map[pos + 1] != JPEG_RST0 + ((count - 1) & 7))
+               return EINA_FALSE;
+             split->seg[count++] = pos + 2;
+             pos += 2;
+             continue;
+          }
+        if (map[pos + 1] != JPEG_EOI) return EINA_FALSE;
+        break;
+     }
+   if (count != n) return EINA_FALSE;
+   split->seg[n] = pos + 2;
+
+   return EINA_TRUE;
+}
+
+/* called once the output is set up, before any scanline is read. Returns
+ * EINA_FALSE, without touching cinfo, if the file can not be split or one
+ * of the bands failed, the caller then decodes it the usual way. */
+static Eina_Bool
+_evas_jpeg_split_decode(j_decompress_ptr cinfo,
+                        void *map, size_t length,
+                        unsigned int scale,
+                        DATA32 *pixels)
+{
+   JPEG_Split split;
+   unsigned int max, ri, mpr, rows, mcu_h, n, g, a, b;
+   unsigned int unit_rows, units, parts, part;
+   unsigned int r0, r1, src_y;
+   Eina_Bool ret = EINA_FALSE;
+
+   max = evas_module_task_split_max();
+   if (max < 2) return EINA_FALSE;
+   if (((unsigned long long)cinfo->image_width * cinfo->image_height) <
+       JPEG_SPLIT_MIN_PIXELS)
+     return EINA_FALSE;
+   if (scale < 1) scale = 1;
+   if ((scale != 1) && (scale != 2) && (scale != 4) && (scale != 8))
+     return EINA_FALSE;
+   if ((cinfo->restart_interval == 0) || (cinfo->progressive_mode) ||
+       (cinfo->comps_in_scan != cinfo->num_components))
+     return EINA_FALSE;
+
+   ri = cinfo->restart_interval;
+   mpr = cinfo->MCUs_per_row;
+   rows = cinfo->MCU_rows_in_scan;
+   if (cinfo->comps_in_scan == 1)
+     mcu_h = (DCTSIZE * cinfo->max_v_samp_factor) /
+       cinfo->cur_comp_info[0]->v_samp_factor;
+   else
+     mcu_h = DCTSIZE * cinfo->max_v_samp_factor;
+   if ((!mpr) || (!rows) || (mcu_h % scale)) return EINA_FALSE;
+
+   /* bands can only start on a row that is also the start of an interval */
+   a = ri;
+   b = mpr;
+   while (b)
+     {
+        g = a % b;
+        a = b;
+        b = g;
+     }
+   g = a;
+   unit_rows = ri / g;
+   units = (rows + unit_rows - 1) / unit_rows;
+   if (units < 2) return EINA_FALSE;
+   parts = (units < max) ? units : max;
+   n = ((mpr * rows) + ri - 1) / ri;
+
+   memset(&split, 0, sizeof(split));
+   split.map = map;
+   split.out_color_space = cinfo->out_color_space;
+   split.scale = scale;
+   split.w = cinfo->output_width;
+   split.components = cinfo->output_components;
+   split.pixels = pixels;
+   split.seg = malloc((n + 1) * sizeof(size_t));
+   split.bands = calloc(parts, sizeof(JPEG_Split_Band));
+   if ((!split.seg) || (!split.bands)) goto on_error;
+
+   if (!_evas_jpeg_split_parse(&split, length, n)) goto on_error;
+
+   for (part = 0; part < parts; part++)
+     {
+        JPEG_Split_Band *band = &split.bands[part];
+
+        r0 = ((part * units) / parts) * unit_rows;
+        r1 = (((part + 1) * units) / parts) * unit_rows;
+        if (r1 > rows) r1 = rows;
+        band->first = (r0 * mpr) / ri;
+        band->last = (r1 == rows) ? n : (r1 * mpr) / ri;
+        src_y = r0 * mcu_h;
+        if (r1 == rows)
+          band->src_h = cinfo->image_height - src_y;
+        else
+          band->src_h = (r1 * mcu_h) - src_y;
+        band->y = src_y / scale;
+        if (r1 == rows)
+          band->h = cinfo->output_height - band->y;
+        else
+          band->h = band->src_h / scale;
+     }
+
+   evas_module_task_split_run(_evas_jpeg_split_band_decode, &split, parts);
+
+   ret = EINA_TRUE;
+   for (part = 0; part < parts; part++)
+     if (!split.bands[part].ok) ret = EINA_FALSE;
+
+ on_error:
+   free(split.bands);
+   free(split.seg);
+   return ret;
+}
+
 /*! Magic number for EXIF header, App0, App1*/
 static const unsigned char ExifHeader[] = {0x45, 0x78, 0x69, 0x66, 0x00, 0x00};
 static const unsigned char JfifHeader[] = {0x4A, 0x46, 0x49, 0x46, 0x00};
@@ -613,6 +948,7 @@ evas_image_load_file_data_jpeg_internal(Evas_Image_Load_Opts *opts,
    volatile int degree = 0;
    volatile Eina_Bool change_wh = EINA_FALSE;
    Eina_Bool line_done = EINA_FALSE;
+   Eina_Bool split_done = EINA_FALSE;
 
    memset(&cinfo, 0, sizeof(cinfo));
    if (prop->rotated)
@@ -800,6 +1136,14 @@ evas_image_load_file_data_jpeg_internal(Evas_Image_Load_Opts *opts,
         return EINA_FALSE;
      }
 
+   /* large images may be decoded in bands by several threads */
+   if ((!region) && (cinfo.output_components != 4) &&
+       (_evas_jpeg_split_decode(&cinfo, map, size, prop->scale, ptr2)))
+     {
+        split_done = EINA_TRUE;
+        goto done;
+     }
+
    /* We handle first CMYK (4 components) */
    if (cinfo.output_components == 4)
      {
@@ -1153,6 +1497,13 @@ done:
         *error = EVAS_LOAD_ERROR_NONE;
         return EINA_FALSE;
      }
+   if (split_done)
+     {
+        jpeg_destroy_decompress(&cinfo);
+        _evas_jpeg_membuf_src_term(&cinfo);
+        *error = EVAS_LOAD_ERROR_NONE;
+        return EINA_TRUE;
+     }
    /* end data decoding */
    jpeg_finish_decompress(&cinfo);
    jpeg_destroy_decompress(&cinfo);
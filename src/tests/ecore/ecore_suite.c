@@ -20,12 +20,15 @@ struct _Ecore_Test_Case
 static const Ecore_Test_Case etc[] = {
   { "Ecore", ecore_test_ecore },
   { "Ecore_Con", ecore_test_ecore_con },
+  { "Ecore_Ipc", ecore_test_ecore_ipc },
   { "Ecore_X", ecore_test_ecore_x },
   { "Ecore_Imf", ecore_test_ecore_imf },
 #if HAVE_ECORE_AUDIO
   { "Ecore Audio", ecore_test_ecore_audio},
 #endif
   { "Ecore_Timers", ecore_test_timer },
+  { "Ecore_Thread", ecore_test_ecore_thread },
+  { "Ecore_Epoll", ecore_test_ecore_epoll },
   { "Ecore_Evas", ecore_test_ecore_evas },
   { "Ecore_Animators", ecore_test_animator },
   { NULL, NULL }
@@ -4,11 +4,14 @@
 #include <check.h>
 
 void ecore_test_ecore(TCase *tc);
+void ecore_test_ecore_epoll(TCase *tc);
 void ecore_test_ecore_con(TCase *tc);
+void ecore_test_ecore_ipc(TCase *tc);
 void ecore_test_ecore_x(TCase *tc);
 void ecore_test_ecore_imf(TCase *tc);
 void ecore_test_ecore_audio(TCase *tc);
 void ecore_test_timer(TCase *tc);
+void ecore_test_ecore_thread(TCase *tc);
 void ecore_test_ecore_evas(TCase *tc);
 void ecore_test_animator(TCase *tc);
 
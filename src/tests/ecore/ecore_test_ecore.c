@@ -3,7 +3,14 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <signal.h>
+#ifdef __linux__
+# include <spawn.h>
+# include <sys/wait.h>
+#endif
 
 #include <Eina.h>
 #include <Ecore.h>
@@ -675,6 +682,114 @@ START_TEST(ecore_test_ecore_main_loop_poller_add_del)
 }
 END_TEST
 
+static void *
+_signal_send_cb(void *data EINA_UNUSED, Eina_Thread t EINA_UNUSED)
+{
+   usleep(200000);
+   kill(getpid(), SIGUSR1);
+   return NULL;
+}
+
+static Eina_Bool
+_signal_user_cb(void *data, int type EINA_UNUSED, void *event)
+{
+   Ecore_Event_Signal_User *e = event;
+   int *number = data;
+
+   *number = e->number;
+   ecore_main_loop_quit();
+   return ECORE_CALLBACK_RENEW;
+}
+
+START_TEST(ecore_test_ecore_main_loop_signal)
+{
+   Ecore_Event_Handler *handler;
+   Ecore_Timer *timer;
+   Eina_Bool timeout = EINA_FALSE;
+   Eina_Thread thread;
+   double start;
+   int number = 0;
+   int ret;
+
+   /* started first, the thread keeps the signal mask the program had,
+    * the signal may well be delivered to it */
+   fail_if(!eina_thread_create(&thread, EINA_THREAD_NORMAL, -1,
+                               _signal_send_cb, NULL));
+
+   ret = ecore_init();
+   fail_if(ret < 1);
+
+   handler = ecore_event_handler_add(ECORE_EVENT_SIGNAL_USER,
+                                     _signal_user_cb, &number);
+   fail_if(handler == NULL);
+   /* only the signal can wake the loop before */
+   timer = ecore_timer_add(5.0, _quit_cb, &timeout);
+   fail_if(timer == NULL);
+
+   start = ecore_time_get();
+   ecore_main_loop_begin();
+
+   eina_thread_join(thread);
+   fail_if(timeout == EINA_TRUE);
+   fail_if(ecore_time_get() - start > 2.0);
+   fail_if(number != 1);
+
+   ecore_timer_del(timer);
+   ecore_event_handler_del(handler);
+   ret = ecore_shutdown();
+}
+END_TEST
+
+#ifdef __linux__
+extern char **environ;
+
+/* the signals blocked in a program started by posix_spawn(), which skips
+ * the fork handlers, like system() and popen() do */
+static void
+_signal_blocked_get(char *buf, int size)
+{
+   char *argv[] = { "grep", "SigBlk", "/proc/self/status", NULL };
+   posix_spawn_file_actions_t actions;
+   pid_t pid;
+   int fds[2], status, n;
+
+   fail_if(pipe(fds) != 0);
+   posix_spawn_file_actions_init(&actions);
+   posix_spawn_file_actions_adddup2(&actions, fds[1], 1);
+   posix_spawn_file_actions_addclose(&actions, fds[0]);
+   fail_if(posix_spawnp(&pid, "grep", &actions, NULL, argv, environ) != 0);
+   posix_spawn_file_actions_destroy(&actions);
+   close(fds[1]);
+   n = read(fds[0], buf, size - 1);
+   close(fds[0]);
+   waitpid(pid, &status, 0);
+   fail_if(n <= 0);
+   buf[n] = 0;
+}
+
+START_TEST(ecore_test_ecore_main_loop_signal_mask)
+{
+   char before[128], after[128];
+   Eina_Bool did = EINA_FALSE;
+   int ret;
+
+   /* whatever the main loop blocks, the programs it starts get blocked */
+   _signal_blocked_get(before, sizeof(before));
+
+   ret = ecore_init();
+   fail_if(ret < 1);
+
+   ecore_timer_add(0.0, _quit_cb, &did);
+   ecore_main_loop_begin();
+   fail_if(did == EINA_FALSE);
+   _signal_blocked_get(after, sizeof(after));
+   fail_if(strcmp(before, after) != 0);
+
+   ret = ecore_shutdown();
+}
+END_TEST
+#endif
+
 void ecore_test_ecore(TCase *tc)
 {
    tcase_add_test(tc, ecore_test_ecore_init);
@@ -690,4 +805,28 @@ void ecore_test_ecore(TCase *tc)
    tcase_add_test(tc, ecore_test_ecore_app);
    tcase_add_test(tc, ecore_test_ecore_main_loop_poller);
    tcase_add_test(tc, ecore_test_ecore_main_loop_poller_add_del);
+   tcase_add_test(tc, ecore_test_ecore_main_loop_signal);
+#ifdef __linux__
+   tcase_add_test(tc, ecore_test_ecore_main_loop_signal_mask);
+#endif
+}
+
+static void
+_epoll_setup(void)
+{
+   setenv("ECORE_MAIN_LOOP_EPOLL", "1", 1);
+}
+
+static void
+_epoll_teardown(void)
+{
+   unsetenv("ECORE_MAIN_LOOP_EPOLL");
+}
+
+/* the same main loop tests, sleeping in epoll_wait() alone */
+void ecore_test_ecore_epoll(TCase *tc)
+{
+   tcase_add_checked_fixture(tc, _epoll_setup, _epoll_teardown);
+   ecore_test_ecore(tc);
+   ecore_test_timer(tc);
 }
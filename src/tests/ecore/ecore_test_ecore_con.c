@@ -7,6 +7,8 @@
 #include "ecore_suite.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <Ecore.h>
 #include <Ecore_Con.h>
 
@@ -304,9 +306,313 @@ START_TEST(ecore_test_ecore_con_dns)
 }
 END_TEST
 
+/* A client sending through ecore_con_server_send_segment(), or a server
+ * through ecore_con_client_send_segment(), the other side checks it
+ * receives what was queued, in the same order. */
+typedef struct _Send_Test Send_Test;
+
+struct _Send_Test
+{
+   Ecore_Con_Server *svr;
+   Ecore_Con_Client *cl; /* set when the server sends */
+   Eina_Binbuf *expected;
+   Eina_Binbuf *received;
+   int segments;
+   int freed;
+   int requeue;
+   int serial;
+   Eina_Bool done;
+};
+
+/* data told apart from any other sent by its content */
+static unsigned char *
+_send_test_buf_new(Send_Test *t, int size)
+{
+   unsigned char *buf;
+   int i;
+
+   buf = malloc(size);
+   fail_if(buf == NULL);
+   for (i = 0; i < size; i++)
+     buf[i] = (i + (t->serial * 31)) ^ (i >> 8);
+   t->serial++;
+   eina_binbuf_append_length(t->expected, buf, size);
+   return buf;
+}
+
+static void
+_send_test_segment_free(void *data, const void *buf)
+{
+   Send_Test *t = data;
+
+   t->freed++;
+   free((void *)buf);
+}
+
+static void
+_send_test_segment(Send_Test *t, int size, Ecore_Con_Send_Free_Cb free_cb)
+{
+   unsigned char *buf = _send_test_buf_new(t, size);
+   int ret;
+
+   t->segments++;
+   if (t->cl)
+     ret = ecore_con_client_send_segment(t->cl, buf, size, free_cb, t);
+   else
+     ret = ecore_con_server_send_segment(t->svr, buf, size, free_cb, t);
+   fail_if(ret != size);
+}
+
+static void
+_send_test_copy(Send_Test *t, int size)
+{
+   unsigned char *buf = _send_test_buf_new(t, size);
+   int ret;
+
+   if (t->cl)
+     ret = ecore_con_client_send(t->cl, buf, size);
+   else
+     ret = ecore_con_server_send(t->svr, buf, size);
+   fail_if(ret != size);
+   free(buf);
+}
+
+static Eina_Bool
+_send_test_data(void *data, int type, void *ev)
+{
+   Send_Test *t = data;
+   size_t len;
+
+   if (type == ECORE_CON_EVENT_SERVER_DATA)
+     {
+        Ecore_Con_Event_Server_Data *event = ev;
+
+        eina_binbuf_append_length(t->received, event->data, event->size);
+     }
+   else
+     {
+        Ecore_Con_Event_Client_Data *event = ev;
+
+        eina_binbuf_append_length(t->received, event->data, event->size);
+     }
+   len = eina_binbuf_length_get(t->received);
+   fail_if(len > eina_binbuf_length_get(t->expected));
+   fail_if(memcmp(eina_binbuf_string_get(t->received),
+                  eina_binbuf_string_get(t->expected), len) != 0);
+   if ((t->done) && (len == eina_binbuf_length_get(t->expected)))
+     ecore_main_loop_quit();
+
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_send_test_timeout(void *data EINA_UNUSED)
+{
+   fail("Not all the data was received");
+
+   return ECORE_CALLBACK_CANCEL;
+}
+
+/* the connection the test sends on */
+static void
+_send_test_peer_set(Send_Test *t, int type, void *ev)
+{
+   if (type == ECORE_CON_EVENT_CLIENT_ADD)
+     t->cl = ((Ecore_Con_Event_Client_Add *)ev)->client;
+}
+
+static void
+_send_test_run(Send_Test *t, const char *name,
+               Ecore_Event_Handler_Cb add_cb,
+               Ecore_Event_Handler_Cb write_cb,
+               Eina_Bool from_server)
+{
+   Ecore_Con_Server *server;
+   Ecore_Event_Handler *handlers[3];
+   Ecore_Timer *timer;
+   int ret, i;
+
+   ret = eina_init();
+   fail_if(ret != 1);
+   ret = ecore_init();
+   fail_if(ret < 1);
+   ret = ecore_con_init();
+   fail_if(ret != 1);
+
+   t->expected = eina_binbuf_new();
+   t->received = eina_binbuf_new();
+
+   if (from_server)
+     {
+        handlers[0] = ecore_event_handler_add(ECORE_CON_EVENT_SERVER_DATA,
+                                              _send_test_data, t);
+        handlers[1] = ecore_event_handler_add(ECORE_CON_EVENT_CLIENT_ADD,
+                                              add_cb, t);
+        handlers[2] = ecore_event_handler_add(ECORE_CON_EVENT_CLIENT_WRITE,
+                                              write_cb, t);
+     }
+   else
+     {
+        handlers[0] = ecore_event_handler_add(ECORE_CON_EVENT_CLIENT_DATA,
+                                              _send_test_data, t);
+        handlers[1] = ecore_event_handler_add(ECORE_CON_EVENT_SERVER_ADD,
+                                              add_cb, t);
+        handlers[2] = ecore_event_handler_add(ECORE_CON_EVENT_SERVER_WRITE,
+                                              write_cb, t);
+     }
+
+   /* a local socket listens right away, the client can't be refused */
+   server = ecore_con_server_add(ECORE_CON_LOCAL_USER, name, 0, NULL);
+   fail_if(server == NULL);
+   t->svr = ecore_con_server_connect(ECORE_CON_LOCAL_USER, name, 0, NULL);
+   fail_if(t->svr == NULL);
+   timer = ecore_timer_add(10.0, _send_test_timeout, NULL);
+
+   ecore_main_loop_begin();
+
+   fail_if(eina_binbuf_length_get(t->received) !=
+           eina_binbuf_length_get(t->expected));
+   fail_if(t->freed != t->segments);
+
+   ecore_timer_del(timer);
+   ecore_con_server_del(t->svr);
+   ecore_con_server_del(server);
+   for (i = 0; i < 3; i++)
+     ecore_event_handler_del(handlers[i]);
+   eina_binbuf_free(t->expected);
+   eina_binbuf_free(t->received);
+
+   ret = ecore_con_shutdown();
+   fail_if(ret != 0);
+   ret = ecore_shutdown();
+   ret = eina_shutdown();
+}
+
+static Eina_Bool
+_send_order_add(void *data, int type, void *ev)
+{
+   Send_Test *t = data;
+   int i;
+
+   _send_test_peer_set(t, type, ev);
+   _send_test_copy(t, 100);
+   _send_test_segment(t, 65536, _send_test_segment_free);
+   _send_test_copy(t, 100);
+   fail_if(t->freed != 0);
+   /* this small is copied */
+   _send_test_segment(t, 100, _send_test_segment_free);
+   fail_if(t->freed != 1);
+   /* more segments than a single writev() takes */
+   for (i = 0; i < 100; i++)
+     _send_test_segment(t, 8192, _send_test_segment_free);
+   /* more than the socket takes at once */
+   _send_test_segment(t, 4 << 20, _send_test_segment_free);
+   _send_test_copy(t, 100);
+
+   return ECORE_CALLBACK_RENEW;
+}
+
+/* queues more while a segment is only partly written */
+static Eina_Bool
+_send_order_write(void *data, int type EINA_UNUSED, void *ev EINA_UNUSED)
+{
+   Send_Test *t = data;
+
+   if (t->done) return ECORE_CALLBACK_RENEW;
+   _send_test_copy(t, 100);
+   _send_test_segment(t, 65536, _send_test_segment_free);
+   _send_test_copy(t, 100);
+   t->done = EINA_TRUE;
+
+   return ECORE_CALLBACK_RENEW;
+}
+
+START_TEST(ecore_test_ecore_con_send_segment)
+{
+   Send_Test t;
+
+   memset(&t, 0, sizeof(t));
+   _send_test_run(&t, "ecore_con_test_send", _send_order_add, _send_order_write,
+                  EINA_FALSE);
+}
+END_TEST
+
+START_TEST(ecore_test_ecore_con_client_send_segment)
+{
+   Send_Test t;
+
+   memset(&t, 0, sizeof(t));
+   _send_test_run(&t, "ecore_con_test_client_send", _send_order_add,
+                  _send_order_write, EINA_TRUE);
+}
+END_TEST
+
+/* what is queued once all was written must be written too, nothing else
+ * wakes the connection up */
+static void
+_send_requeue_free(void *data, const void *buf)
+{
+   Send_Test *t = data;
+
+   _send_test_segment_free(data, buf);
+   if (t->requeue > 0)
+     {
+        t->requeue--;
+        _send_test_segment(t, 65536, _send_requeue_free);
+     }
+   else if (!t->done)
+     {
+        _send_test_copy(t, 100);
+        t->done = EINA_TRUE;
+     }
+}
+
+static Eina_Bool
+_send_requeue_add(void *data, int type, void *ev)
+{
+   Send_Test *t = data;
+
+   _send_test_peer_set(t, type, ev);
+   _send_test_segment(t, 65536, _send_requeue_free);
+
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_send_requeue_write(void *data EINA_UNUSED, int type EINA_UNUSED, void *ev EINA_UNUSED)
+{
+   return ECORE_CALLBACK_RENEW;
+}
+
+START_TEST(ecore_test_ecore_con_send_segment_requeue)
+{
+   Send_Test t;
+
+   memset(&t, 0, sizeof(t));
+   t.requeue = 8;
+   _send_test_run(&t, "ecore_con_test_requeue", _send_requeue_add,
+                  _send_requeue_write, EINA_FALSE);
+}
+END_TEST
+
+START_TEST(ecore_test_ecore_con_client_send_segment_requeue)
+{
+   Send_Test t;
+
+   memset(&t, 0, sizeof(t));
+   t.requeue = 8;
+   _send_test_run(&t, "ecore_con_test_client_requeue", _send_requeue_add,
+                  _send_requeue_write, EINA_TRUE);
+}
+END_TEST
+
 void ecore_test_ecore_con(TCase *tc)
 {
    tcase_add_test(tc, ecore_test_ecore_con_init);
    tcase_add_test(tc, ecore_test_ecore_con_server);
    tcase_add_test(tc, ecore_test_ecore_con_dns);
+   tcase_add_test(tc, ecore_test_ecore_con_send_segment);
+   tcase_add_test(tc, ecore_test_ecore_con_send_segment_requeue);
+   tcase_add_test(tc, ecore_test_ecore_con_client_send_segment);
+   tcase_add_test(tc, ecore_test_ecore_con_client_send_segment_requeue);
 }
@@ -0,0 +1,598 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <arpa/inet.h>
+
+#include <Ecore.h>
+#include <ecore_private.h>
+#include <Ecore_Con.h>
+#include <Ecore_Ipc.h>
+#include "ecore_ipc_private.h"
+
+#include "ecore_suite.h"
+
+/* Messages are encoded the way ecore_ipc sends them, and given to the
+ * reader in pieces as data events would. */
+typedef struct _Ipc_Msg Ipc_Msg;
+
+struct _Ipc_Msg
+{
+   Ecore_Ipc_Msg_Head head;
+   unsigned char *data;
+};
+
+#define MSG_MAX 256
+
+static int
+_ipc_value_put(unsigned char *p, int v, int prev, int *mode)
+{
+   unsigned short v16;
+   unsigned int v32;
+
+   if (v == 0)
+     {
+        *mode = DLT_ZERO;
+        return 0;
+     }
+   if ((v >= prev) && (v - prev < 0x100))
+     {
+        *mode = DLT_ADD8;
+        p[0] = v - prev;
+        return 1;
+     }
+   if ((v >= prev) && (v - prev < 0x10000))
+     {
+        *mode = DLT_ADD16;
+        v16 = htons(v - prev);
+        memcpy(p, &v16, 2);
+        return 2;
+     }
+   *mode = DLT_SET;
+   v32 = htonl(v);
+   memcpy(p, &v32, 4);
+   return 4;
+}
+
+static void
+_ipc_head_put(Eina_Binbuf *stream, Ecore_Ipc_Msg_Head *prev,
+              const Ecore_Ipc_Msg_Head *msg)
+{
+   unsigned char p[ECORE_IPC_HEAD_MAX];
+   unsigned int head = 0;
+   int in[6], out[6];
+   int s = 4, mode, i;
+
+   in[0] = prev->major;
+   in[1] = prev->minor;
+   in[2] = prev->ref;
+   in[3] = prev->ref_to;
+   in[4] = prev->response;
+   in[5] = prev->size;
+   out[0] = msg->major;
+   out[1] = msg->minor;
+   out[2] = msg->ref;
+   out[3] = msg->ref_to;
+   out[4] = msg->response;
+   out[5] = msg->size;
+   for (i = 0; i < 6; i++)
+     {
+        s += _ipc_value_put(p + s, out[i], in[i], &mode);
+        head |= mode << (4 * i);
+     }
+   head = htonl(head);
+   memcpy(p, &head, 4);
+   eina_binbuf_append_length(stream, p, s);
+   *prev = *msg;
+}
+
+/* appends the message to the stream, its data is made from its number */
+static void
+_ipc_msg_put(Eina_Binbuf *stream, Ecore_Ipc_Msg_Head *prev, Ipc_Msg *msg,
+             int num)
+{
+   int i;
+
+   _ipc_head_put(stream, prev, &msg->head);
+   msg->data = NULL;
+   if (msg->head.size <= 0) return;
+   msg->data = malloc(msg->head.size);
+   fail_if(msg->data == NULL);
+   for (i = 0; i < msg->head.size; i++)
+     msg->data[i] = (num * 13) + i;
+   eina_binbuf_append_length(stream, msg->data, msg->head.size);
+}
+
+static void
+_ipc_msg_set(Ipc_Msg *msg, int num, int size)
+{
+   msg->head.major = num;
+   msg->head.minor = num * 1000;
+   msg->head.ref = num * 100000;
+   msg->head.ref_to = -num;
+   msg->head.response = (num & 1) ? 0 : 7;
+   msg->head.size = size;
+}
+
+/* gives the reader the next size bytes, the messages it completes are
+ * added to got */
+static void
+_ipc_read(Ecore_Ipc_Reader *rd, Ecore_Ipc_Msg_Head *prev, int max,
+          const unsigned char *p, int size, Ipc_Msg *got, int *n)
+{
+   Ecore_Ipc_Msg_Head msg;
+   unsigned char *data;
+
+   while (_ecore_ipc_reader_next(rd, prev, max, &p, &size, &msg, &data))
+     {
+        fail_if(*n >= MSG_MAX);
+        got[*n].head = msg;
+        got[*n].data = data;
+        (*n)++;
+     }
+   fail_if(size != 0);
+}
+
+static void
+_ipc_check(Ipc_Msg *got, int n, Ipc_Msg *expected, int count)
+{
+   int i;
+
+   fail_if(n != count);
+   for (i = 0; i < n; i++)
+     {
+        fail_if(memcmp(&got[i].head, &expected[i].head,
+                       sizeof(Ecore_Ipc_Msg_Head)) != 0);
+        if (expected[i].head.size == 0)
+          fail_if(got[i].data != NULL);
+        else
+          fail_if(memcmp(got[i].data, expected[i].data,
+                         expected[i].head.size) != 0);
+        free(got[i].data);
+     }
+}
+
+static void
+_ipc_free(Ipc_Msg *msgs, int count)
+{
+   int i;
+
+   for (i = 0; i < count; i++)
+     free(msgs[i].data);
+}
+
+START_TEST(ecore_test_ecore_ipc_reader_split)
+{
+   static const int sizes[] = { 0, 1, 27, 300, 0, 3000, 5, 0 };
+   const int count = sizeof(sizes) / sizeof(sizes[0]);
+   Ipc_Msg expected[MSG_MAX], got[MSG_MAX];
+   Ecore_Ipc_Msg_Head prev;
+   Ecore_Ipc_Reader rd;
+   Eina_Binbuf *stream;
+   const unsigned char *p;
+   int len, n, i, k;
+
+   eina_init();
+
+   stream = eina_binbuf_new();
+   memset(&prev, 0, sizeof(prev));
+   for (i = 0; i < count; i++)
+     {
+        _ipc_msg_set(&expected[i], i, sizes[i]);
+        _ipc_msg_put(stream, &prev, &expected[i], i);
+     }
+   p = eina_binbuf_string_get(stream);
+   len = eina_binbuf_length_get(stream);
+
+   /* in two pieces, split at every offset */
+   for (k = 0; k <= len; k++)
+     {
+        memset(&rd, 0, sizeof(rd));
+        memset(&prev, 0, sizeof(prev));
+        n = 0;
+        _ipc_read(&rd, &prev, -1, p, k, got, &n);
+        _ipc_read(&rd, &prev, -1, p + k, len - k, got, &n);
+        _ipc_check(got, n, expected, count);
+     }
+
+   /* a byte at a time, every header is split everywhere at once */
+   memset(&rd, 0, sizeof(rd));
+   memset(&prev, 0, sizeof(prev));
+   n = 0;
+   for (k = 0; k < len; k++)
+     _ipc_read(&rd, &prev, -1, p + k, 1, got, &n);
+   _ipc_check(got, n, expected, count);
+
+   _ipc_free(expected, count);
+   eina_binbuf_free(stream);
+   eina_shutdown();
+}
+END_TEST
+
+START_TEST(ecore_test_ecore_ipc_reader_zero_size)
+{
+   Ipc_Msg expected[MSG_MAX], got[MSG_MAX];
+   Ecore_Ipc_Msg_Head prev;
+   Ecore_Ipc_Reader rd;
+   Eina_Binbuf *stream;
+   size_t done = 0;
+   int n = 0, i;
+
+   eina_init();
+
+   /* each message comes out as soon as its header is complete */
+   stream = eina_binbuf_new();
+   memset(&prev, 0, sizeof(prev));
+   memset(&rd, 0, sizeof(rd));
+   for (i = 0; i < 20; i++)
+     {
+        Ecore_Ipc_Msg_Head prev_read = prev;
+
+        _ipc_msg_set(&expected[i], i, 0);
+        _ipc_msg_put(stream, &prev, &expected[i], i);
+        _ipc_read(&rd, &prev_read, -1, eina_binbuf_string_get(stream) + done,
+                  eina_binbuf_length_get(stream) - done, got, &n);
+        done = eina_binbuf_length_get(stream);
+        fail_if(n != i + 1);
+        fail_if(memcmp(&prev_read, &prev, sizeof(prev)) != 0);
+     }
+   _ipc_check(got, n, expected, 20);
+
+   eina_binbuf_free(stream);
+   eina_shutdown();
+}
+END_TEST
+
+START_TEST(ecore_test_ecore_ipc_reader_skip)
+{
+   static const int sizes[] = { 10, 1000, 20, 0, 101, 100, 5000, 3 };
+   const int count = sizeof(sizes) / sizeof(sizes[0]);
+   Ipc_Msg sent[MSG_MAX], expected[MSG_MAX], got[MSG_MAX];
+   Ecore_Ipc_Msg_Head prev;
+   Ecore_Ipc_Reader rd;
+   Eina_Binbuf *stream;
+   const unsigned char *p;
+   int len, n, i, k, kept = 0;
+
+   eina_init();
+
+   /* the messages over the limit are dropped, those after them are still
+    * decoded from their header */
+   stream = eina_binbuf_new();
+   memset(&prev, 0, sizeof(prev));
+   for (i = 0; i < count; i++)
+     {
+        _ipc_msg_set(&sent[i], i, sizes[i]);
+        _ipc_msg_put(stream, &prev, &sent[i], i);
+        if (sizes[i] <= 100) expected[kept++] = sent[i];
+     }
+   p = eina_binbuf_string_get(stream);
+   len = eina_binbuf_length_get(stream);
+
+   for (k = 0; k <= len; k++)
+     {
+        memset(&rd, 0, sizeof(rd));
+        memset(&prev, 0, sizeof(prev));
+        n = 0;
+        _ipc_read(&rd, &prev, 100, p, k, got, &n);
+        _ipc_read(&rd, &prev, 100, p + k, len - k, got, &n);
+        _ipc_check(got, n, expected, kept);
+        fail_if(memcmp(&prev, &sent[count - 1].head, sizeof(prev)) != 0);
+     }
+
+   _ipc_free(sent, count);
+   eina_binbuf_free(stream);
+   eina_shutdown();
+}
+END_TEST
+
+START_TEST(ecore_test_ecore_ipc_reader_behind_large)
+{
+   Ipc_Msg expected[MSG_MAX], got[MSG_MAX];
+   Ecore_Ipc_Msg_Head prev;
+   Ecore_Ipc_Reader rd;
+   Eina_Binbuf *stream;
+   const unsigned char *p;
+   int len, n = 0, i;
+
+   eina_init();
+
+   stream = eina_binbuf_new();
+   memset(&prev, 0, sizeof(prev));
+   _ipc_msg_set(&expected[0], 0, 100000);
+   _ipc_msg_put(stream, &prev, &expected[0], 0);
+   for (i = 1; i < 200; i++)
+     {
+        _ipc_msg_set(&expected[i], i, 8);
+        _ipc_msg_put(stream, &prev, &expected[i], i);
+     }
+   p = eina_binbuf_string_get(stream);
+   len = eina_binbuf_length_get(stream);
+
+   /* the rest of the large one and all the small ones in one event */
+   memset(&rd, 0, sizeof(rd));
+   memset(&prev, 0, sizeof(prev));
+   _ipc_read(&rd, &prev, -1, p, 50000, got, &n);
+   fail_if(n != 0);
+   _ipc_read(&rd, &prev, -1, p + 50000, len - 50000, got, &n);
+   _ipc_check(got, n, expected, 200);
+
+   _ipc_free(expected, 200);
+   eina_binbuf_free(stream);
+   eina_shutdown();
+}
+END_TEST
+
+START_TEST(ecore_test_ecore_ipc_reader_huge)
+{
+   static unsigned char zeros[1 << 20];
+   Ipc_Msg big, expected[1], got[MSG_MAX];
+   Ecore_Ipc_Msg_Head prev, prev_read;
+   Ecore_Ipc_Reader rd;
+   Eina_Binbuf *stream;
+   int left, piece, n = 0;
+
+   eina_init();
+
+   /* a message as large as it can be announced is over the limit, its
+    * data is never allocated and is read through without losing track of
+    * the messages after it */
+   stream = eina_binbuf_new();
+   memset(&prev, 0, sizeof(prev));
+   _ipc_msg_set(&big, 1, INT_MAX);
+   _ipc_head_put(stream, &prev, &big.head);
+
+   memset(&rd, 0, sizeof(rd));
+   memset(&prev_read, 0, sizeof(prev_read));
+   _ipc_read(&rd, &prev_read, 100, eina_binbuf_string_get(stream),
+             eina_binbuf_length_get(stream), got, &n);
+   fail_if(rd.data != NULL);
+   fail_if(!rd.skip);
+   for (left = INT_MAX; left > 0; left -= piece)
+     {
+        piece = (left < (int)sizeof(zeros)) ? left : (int)sizeof(zeros);
+        _ipc_read(&rd, &prev_read, 100, zeros, piece, got, &n);
+        fail_if(rd.data != NULL);
+     }
+   fail_if(n != 0);
+
+   eina_binbuf_reset(stream);
+   _ipc_msg_set(&expected[0], 2, 100);
+   _ipc_msg_put(stream, &prev, &expected[0], 2);
+   _ipc_read(&rd, &prev_read, 100, eina_binbuf_string_get(stream),
+             eina_binbuf_length_get(stream), got, &n);
+   _ipc_check(got, n, expected, 1);
+
+   _ipc_free(expected, 1);
+   eina_binbuf_free(stream);
+   eina_shutdown();
+}
+END_TEST
+
+/* Messages sent with ecore_ipc_*_send_segment(), between copied ones, a
+ * local connection away: they all come out whole and in order, each
+ * header decoded against the one sent before it. Nothing is over the
+ * 32k both sides accept by default. */
+#define IPC_SEND_COUNT 12
+
+typedef struct _Ipc_Send_Test Ipc_Send_Test;
+
+struct _Ipc_Send_Test
+{
+   Ipc_Msg msgs[IPC_SEND_COUNT];
+   Eina_Bool released[IPC_SEND_COUNT];
+   Ecore_Ipc_Server *conn;
+   int received;
+   int freed;
+   Eina_Bool from_server;
+};
+
+/* each segment is released once, those sent whole right away */
+static void
+_ipc_send_free(void *data, const void *buf)
+{
+   Ipc_Send_Test *t = data;
+   int i;
+
+   for (i = 0; i < IPC_SEND_COUNT; i += 2)
+     if ((!t->released[i]) && (t->msgs[i].data == buf)) break;
+   fail_if(i >= IPC_SEND_COUNT);
+   t->released[i] = EINA_TRUE;
+   t->freed++;
+}
+
+/* every other message is a segment, the others are copied */
+static void
+_ipc_send_all(Ipc_Send_Test *t, Ecore_Ipc_Client *cl)
+{
+   Ecore_Ipc_Msg_Head *h;
+   Ipc_Msg *msg;
+   int i, ret;
+
+   for (i = 0; i < IPC_SEND_COUNT; i++)
+     {
+        msg = t->msgs + i;
+        h = &msg->head;
+        if ((i & 1) && (cl))
+          ret = ecore_ipc_client_send(cl, h->major, h->minor, h->ref,
+                                      h->ref_to, h->response, msg->data,
+                                      h->size);
+        else if (i & 1)
+          ret = ecore_ipc_server_send(t->conn, h->major, h->minor, h->ref,
+                                      h->ref_to, h->response, msg->data,
+                                      h->size);
+        else if (cl)
+          ret = ecore_ipc_client_send_segment(cl, h->major, h->minor, h->ref,
+                                              h->ref_to, h->response,
+                                              msg->data, h->size,
+                                              _ipc_send_free, t);
+        else
+          ret = ecore_ipc_server_send_segment(t->conn, h->major, h->minor,
+                                              h->ref, h->ref_to, h->response,
+                                              msg->data, h->size,
+                                              _ipc_send_free, t);
+        /* the header is counted too */
+        fail_if(ret <= h->size);
+     }
+}
+
+static void
+_ipc_send_received(Ipc_Send_Test *t, const Ecore_Ipc_Msg_Head *h,
+                   const void *data)
+{
+   Ipc_Msg *msg;
+
+   fail_if(t->received >= IPC_SEND_COUNT);
+   msg = t->msgs + t->received;
+   fail_if(memcmp(h, &msg->head, sizeof(Ecore_Ipc_Msg_Head)) != 0);
+   if (msg->head.size > 0)
+     fail_if(memcmp(data, msg->data, msg->head.size) != 0);
+   if (++t->received == IPC_SEND_COUNT) ecore_main_loop_quit();
+}
+
+static Eina_Bool
+_ipc_send_client_add(void *data, int type EINA_UNUSED, void *ev)
+{
+   Ecore_Ipc_Event_Client_Add *e = ev;
+   Ipc_Send_Test *t = data;
+
+   if (t->from_server) _ipc_send_all(t, e->client);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_ipc_send_server_add(void *data, int type EINA_UNUSED, void *ev EINA_UNUSED)
+{
+   Ipc_Send_Test *t = data;
+
+   if (!t->from_server) _ipc_send_all(t, NULL);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_ipc_send_client_data(void *data, int type EINA_UNUSED, void *ev)
+{
+   Ecore_Ipc_Event_Client_Data *e = ev;
+   Ecore_Ipc_Msg_Head h;
+
+   h.major = e->major;
+   h.minor = e->minor;
+   h.ref = e->ref;
+   h.ref_to = e->ref_to;
+   h.response = e->response;
+   h.size = e->size;
+   _ipc_send_received(data, &h, e->data);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_ipc_send_server_data(void *data, int type EINA_UNUSED, void *ev)
+{
+   Ecore_Ipc_Event_Server_Data *e = ev;
+   Ecore_Ipc_Msg_Head h;
+
+   h.major = e->major;
+   h.minor = e->minor;
+   h.ref = e->ref;
+   h.ref_to = e->ref_to;
+   h.response = e->response;
+   h.size = e->size;
+   _ipc_send_received(data, &h, e->data);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Eina_Bool
+_ipc_send_timeout(void *data EINA_UNUSED)
+{
+   fail("Not all the messages were received");
+   ecore_main_loop_quit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_ipc_send_run(Ipc_Send_Test *t, const char *name)
+{
+   static const int sizes[IPC_SEND_COUNT] =
+     { 0, 100, 8192, 5000, 0, 3, 32768, 4096, 100, 20000, 4095, 16384 };
+   Ecore_Event_Handler *handlers[4];
+   Ecore_Ipc_Server *server;
+   Ecore_Ipc_Msg_Head prev;
+   Ecore_Timer *timer;
+   Eina_Binbuf *scratch;
+   int i;
+
+   fail_if(ecore_ipc_init() < 1);
+
+   scratch = eina_binbuf_new();
+   memset(&prev, 0, sizeof(prev));
+   for (i = 0; i < IPC_SEND_COUNT; i++)
+     {
+        _ipc_msg_set(&t->msgs[i], i, sizes[i]);
+        _ipc_msg_put(scratch, &prev, &t->msgs[i], i);
+     }
+   eina_binbuf_free(scratch);
+
+   handlers[0] = ecore_event_handler_add(ECORE_IPC_EVENT_CLIENT_ADD,
+                                         _ipc_send_client_add, t);
+   handlers[1] = ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_ADD,
+                                         _ipc_send_server_add, t);
+   handlers[2] = ecore_event_handler_add(ECORE_IPC_EVENT_CLIENT_DATA,
+                                         _ipc_send_client_data, t);
+   handlers[3] = ecore_event_handler_add(ECORE_IPC_EVENT_SERVER_DATA,
+                                         _ipc_send_server_data, t);
+
+   server = ecore_ipc_server_add(ECORE_IPC_LOCAL_USER, name, 0, NULL);
+   fail_if(server == NULL);
+   t->conn = ecore_ipc_server_connect(ECORE_IPC_LOCAL_USER, (char *)name, 0,
+                                      NULL);
+   fail_if(t->conn == NULL);
+   timer = ecore_timer_add(10.0, _ipc_send_timeout, NULL);
+
+   ecore_main_loop_begin();
+
+   fail_if(t->received != IPC_SEND_COUNT);
+   fail_if(t->freed != IPC_SEND_COUNT / 2);
+
+   ecore_timer_del(timer);
+   ecore_ipc_server_del(t->conn);
+   ecore_ipc_server_del(server);
+   for (i = 0; i < 4; i++)
+     ecore_event_handler_del(handlers[i]);
+   _ipc_free(t->msgs, IPC_SEND_COUNT);
+
+   ecore_ipc_shutdown();
+}
+
+START_TEST(ecore_test_ecore_ipc_server_send_segment)
+{
+   Ipc_Send_Test t;
+
+   memset(&t, 0, sizeof(t));
+   _ipc_send_run(&t, "ecore_ipc_test_server_send");
+}
+END_TEST
+
+START_TEST(ecore_test_ecore_ipc_client_send_segment)
+{
+   Ipc_Send_Test t;
+
+   memset(&t, 0, sizeof(t));
+   t.from_server = EINA_TRUE;
+   _ipc_send_run(&t, "ecore_ipc_test_client_send");
+}
+END_TEST
+
+void ecore_test_ecore_ipc(TCase *tc)
+{
+   tcase_add_test(tc, ecore_test_ecore_ipc_reader_split);
+   tcase_add_test(tc, ecore_test_ecore_ipc_reader_zero_size);
+   tcase_add_test(tc, ecore_test_ecore_ipc_reader_skip);
+   tcase_add_test(tc, ecore_test_ecore_ipc_reader_behind_large);
+   tcase_add_test(tc, ecore_test_ecore_ipc_reader_huge);
+   tcase_add_test(tc, ecore_test_ecore_ipc_server_send_segment);
+   tcase_add_test(tc, ecore_test_ecore_ipc_client_send_segment);
+}
@@ -0,0 +1,152 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <Ecore.h>
+
+#include "ecore_suite.h"
+
+/* Jobs queued while a single worker runs, they all land in its queue.
+   The workers started for the last ones have to steal from it. */
+#define THREAD_JOBS 2000
+#define THREAD_JOBS_FLOOD 1500
+#define THREAD_WORKERS 4
+
+typedef struct _Thread_Job Thread_Job;
+
+struct _Thread_Job
+{
+   int runs;
+   int notified;
+   int ended;
+   int cancelled;
+   Eina_Bool cancel_asked : 1;
+};
+
+static Thread_Job _thread_jobs[THREAD_JOBS];
+static int _thread_jobs_reported = 0;
+
+/* every 11th job runs a second time through its worker's own queue */
+static int
+_thread_job_runs_expected(int id)
+{
+   return (id % 11) ? 1 : 2;
+}
+
+static void
+_thread_job_blocking(void *data, Ecore_Thread *thread)
+{
+   Thread_Job *job = _thread_jobs + (intptr_t)data;
+
+   job->runs++;
+   usleep(50);
+   if (job->runs < _thread_job_runs_expected((intptr_t)data))
+     ecore_thread_reschedule(thread);
+}
+
+static void
+_thread_job_heavy(void *data, Ecore_Thread *thread)
+{
+   _thread_job_blocking(data, thread);
+   if (_thread_jobs[(intptr_t)data].runs == 1)
+     ecore_thread_feedback(thread, data);
+}
+
+static void
+_thread_job_notify(void *data, Ecore_Thread *thread EINA_UNUSED,
+                   void *msg_data)
+{
+   fail_if(data != msg_data);
+   _thread_jobs[(intptr_t)data].notified++;
+}
+
+static void
+_thread_job_reported(void)
+{
+   if (++_thread_jobs_reported == THREAD_JOBS) ecore_main_loop_quit();
+}
+
+static void
+_thread_job_end(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   _thread_jobs[(intptr_t)data].ended++;
+   _thread_job_reported();
+}
+
+static void
+_thread_job_cancel(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   _thread_jobs[(intptr_t)data].cancelled++;
+   _thread_job_reported();
+}
+
+static Eina_Bool
+_thread_timeout(void *data EINA_UNUSED)
+{
+   fail("the thread jobs never all reported");
+   ecore_main_loop_quit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+START_TEST(ecore_test_ecore_thread_steal)
+{
+   Ecore_Thread *thread;
+   Ecore_Timer *timer;
+   intptr_t i;
+
+   fail_if(ecore_init() < 1);
+
+   ecore_thread_max_set(1);
+   for (i = 0; i < THREAD_JOBS; i++)
+     {
+        if (i == THREAD_JOBS_FLOOD)
+          ecore_thread_max_set(THREAD_WORKERS);
+
+        if (i & 1)
+          thread = ecore_thread_feedback_run(_thread_job_heavy,
+                                             _thread_job_notify,
+                                             _thread_job_end,
+                                             _thread_job_cancel,
+                                             (void *)i, EINA_FALSE);
+        else
+          thread = ecore_thread_run(_thread_job_blocking, _thread_job_end,
+                                    _thread_job_cancel, (void *)i);
+        fail_if(!thread);
+
+        /* the job may be queued, running or already done */
+        if ((i % 7) == 3)
+          {
+             _thread_jobs[i].cancel_asked = EINA_TRUE;
+             ecore_thread_cancel(thread);
+          }
+     }
+
+   timer = ecore_timer_add(30.0, _thread_timeout, NULL);
+   if (_thread_jobs_reported < THREAD_JOBS)
+     ecore_main_loop_begin();
+   ecore_timer_del(timer);
+
+   for (i = 0; i < THREAD_JOBS; i++)
+     {
+        Thread_Job *job = _thread_jobs + i;
+
+        fail_if(job->ended + job->cancelled != 1, "job %i", (int)i);
+        fail_if(job->runs > _thread_job_runs_expected(i), "job %i", (int)i);
+        if (job->cancel_asked) continue;
+
+        fail_if(!job->ended, "job %i", (int)i);
+        fail_if(job->runs != _thread_job_runs_expected(i), "job %i", (int)i);
+        fail_if(job->notified != (i & 1), "job %i", (int)i);
+     }
+
+   ecore_shutdown();
+}
+END_TEST
+
+void ecore_test_ecore_thread(TCase *tc)
+{
+   tcase_add_test(tc, ecore_test_ecore_thread_steal);
+}
@@ -151,6 +151,57 @@ START_TEST(edje_test_complex_layout)
 }
 END_TEST
 
+static void
+_signal_count_cb(void *data, Evas_Object *obj EINA_UNUSED,
+                 const char *emission EINA_UNUSED,
+                 const char *source EINA_UNUSED)
+{
+   int *count = data;
+
+   (*count)++;
+}
+
+START_TEST(edje_test_signal_callback_glob)
+{
+   Evas *evas = EDJE_TEST_INIT_EVAS();
+   Evas_Object *obj;
+   int counts[6] = { 0, 0, 0, 0, 0, 0 };
+   int i;
+
+   obj = edje_object_add(evas);
+   fail_unless(edje_object_file_set(obj, test_layout_get("test_layout.edj"), "test_group"));
+
+   edje_object_signal_callback_add(obj, "mouse,*", "*", _signal_count_cb, &counts[0]);
+   edje_object_signal_callback_add(obj, "*,clicked,?", "button", _signal_count_cb, &counts[1]);
+   edje_object_signal_callback_add(obj, "state,[a-c]*", "*", _signal_count_cb, &counts[2]);
+   edje_object_signal_callback_add(obj, "state,[!a-c]*", "*", _signal_count_cb, &counts[3]);
+   edje_object_signal_callback_add(obj, "\\*", "*", _signal_count_cb, &counts[4]);
+   edje_object_signal_callback_add(obj, "*", "bu*on", _signal_count_cb, &counts[5]);
+
+   /* twice, the second time goes through already known states */
+   for (i = 0; i < 2; i++)
+     {
+        edje_object_signal_emit(obj, "mouse,in", "");
+        edje_object_signal_emit(obj, "mouse,clicked,1", "button");
+        edje_object_signal_emit(obj, "mouse,clicked,12", "button");
+        edje_object_signal_emit(obj, "mouse,clicked,2", "other");
+        edje_object_signal_emit(obj, "state,alpha", "x");
+        edje_object_signal_emit(obj, "state,delta", "x");
+        edje_object_signal_emit(obj, "*", "x");
+        edje_message_signal_process();
+     }
+
+   fail_if(counts[0] != 8);
+   fail_if(counts[1] != 2);
+   fail_if(counts[2] != 2);
+   fail_if(counts[3] != 2);
+   fail_if(counts[4] != 2);
+   fail_if(counts[5] != 4);
+
+   EDJE_TEST_FREE_EVAS();
+}
+END_TEST
+
 void edje_test_edje(TCase *tc)
 {    
    tcase_add_test(tc, edje_test_edje_init);
@@ -158,4 +209,5 @@ void edje_test_edje(TCase *tc)
    tcase_add_test(tc, edje_test_edje_load);
    tcase_add_test(tc, edje_test_simple_layout_geometry);
    tcase_add_test(tc, edje_test_complex_layout);
+   tcase_add_test(tc, edje_test_signal_callback_glob);
 }
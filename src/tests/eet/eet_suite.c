@@ -1282,6 +1282,208 @@ START_TEST(eet_file_data_dump_test)
 } /* START_TEST */
 
 END_TEST
+typedef struct _Eet_Direct_Test Eet_Direct_Test;
+struct _Eet_Direct_Test
+{
+   const char *str;
+   const char *istr;
+   Eina_List  *slist;
+   int         sarray_count;
+   const char **sarray;
+};
+
+static const char *eet_direct_strings[] = { "a", "direct", "string" };
+
+START_TEST(eet_file_data_direct_test)
+{
+   Eet_Data_Descriptor_Class eddc;
+   Eet_Data_Descriptor *edd;
+   Eet_Direct_Test edt;
+   Eet_Direct_Test *result;
+   Eet_Direct_Test *again;
+   const char *raw;
+   Eet_File *ef;
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   int size;
+   int i;
+
+   eet_init();
+
+   EET_EINA_FILE_DATA_DESCRIPTOR_CLASS_SET(&eddc, Eet_Direct_Test);
+   edd = eet_data_descriptor_file_new(&eddc);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Direct_Test, "str", str, EET_T_STRING);
+   EET_DATA_DESCRIPTOR_ADD_BASIC(edd, Eet_Direct_Test, "istr", istr, EET_T_INLINED_STRING);
+   EET_DATA_DESCRIPTOR_ADD_LIST_STRING(edd, Eet_Direct_Test, "slist", slist);
+   EET_DATA_DESCRIPTOR_ADD_VAR_ARRAY_STRING(edd, Eet_Direct_Test, "sarray", sarray);
+
+   fail_if(eet_data_descriptor_direct_get(edd));
+   eet_data_descriptor_direct_set(edd, EINA_TRUE);
+   fail_if(!eet_data_descriptor_direct_get(edd));
+
+   memset(&edt, 0, sizeof (edt));
+   edt.str = "dictionary string";
+   edt.istr = "inlined string";
+   for (i = 0; i < 3; i++)
+     edt.slist = eina_list_append(edt.slist, eet_direct_strings[i]);
+   edt.sarray_count = 3;
+   edt.sarray = eet_direct_strings;
+
+   fail_if(!(file = tmpnam(file)));
+
+   ef = eet_open(file, EET_FILE_MODE_WRITE);
+   fail_if(!ef);
+   fail_if(!eet_data_write(ef, edd, "direct/raw", &edt, 0));
+   fail_if(!eet_data_write(ef, edd, "direct/comp", &edt, 1));
+   eet_close(ef);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   /* uncompressed, strings point straight into the mapped file */
+   result = eet_data_read(ef, edd, "direct/raw");
+   fail_if(!result);
+   raw = eet_read_direct(ef, "direct/raw", &size);
+   fail_if(!raw);
+   fail_if(strcmp(result->str, edt.str) != 0);
+   fail_if(!eet_dictionary_string_check(eet_dictionary_get(ef), result->str));
+   fail_if(strcmp(result->istr, edt.istr) != 0);
+   fail_if(result->istr < raw || result->istr >= raw + size);
+   fail_if(eina_list_count(result->slist) != 3);
+   fail_if(result->sarray_count != 3);
+   for (i = 0; i < 3; i++)
+     {
+        fail_if(strcmp(eina_list_nth(result->slist, i), eet_direct_strings[i]) != 0);
+        fail_if(strcmp(result->sarray[i], eet_direct_strings[i]) != 0);
+     }
+   eina_list_free(result->slist);
+   free(result->sarray);
+   free(result);
+
+   /* compressed, the uncompressed entry is kept by the Eet_File */
+   result = eet_data_read(ef, edd, "direct/comp");
+   fail_if(!result);
+   fail_if(strcmp(result->istr, edt.istr) != 0);
+   again = eet_data_read(ef, edd, "direct/comp");
+   fail_if(!again);
+   fail_if(again->istr != result->istr);
+   fail_if(eina_list_count(again->slist) != 3);
+   eina_list_free(result->slist);
+   free(result->sarray);
+   free(result);
+   eina_list_free(again->slist);
+   free(again->sarray);
+   free(again);
+
+   eet_close(ef);
+
+   /* not usable in read-write mode, strings are allocated as usual */
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   result = eet_data_read(ef, edd, "direct/comp");
+   fail_if(!result);
+   fail_if(strcmp(result->istr, edt.istr) != 0);
+   fail_if(result->istr != eina_stringshare_add(edt.istr));
+   eina_stringshare_del(result->istr);
+   eina_stringshare_del(result->istr);
+   eina_list_free(result->slist);
+   free(result->sarray);
+   free(result);
+   eet_close(ef);
+
+   fail_if(unlink(file) != 0);
+
+   eina_list_free(edt.slist);
+   eet_data_descriptor_free(edd);
+
+   eet_shutdown();
+}
+END_TEST
+
+START_TEST(eet_file_parallel_compression_test)
+{
+   const int comps[] = {
+      EET_COMPRESSION_DEFAULT,
+      EET_COMPRESSION_VERYFAST,
+      EET_COMPRESSION_SUPERFAST,
+      EET_COMPRESSION_NONE
+   };
+   char *file = strdup("/tmp/eet_suite_testXXXXXX");
+   char data[1024];
+   char name[64];
+   Eet_File *ef;
+   char *test;
+   int size;
+   int i, j;
+
+   eet_init();
+
+   fail_if(!(file = tmpnam(file)));
+
+   ef = eet_open(file, EET_FILE_MODE_READ_WRITE);
+   fail_if(!ef);
+   fail_if(eet_parallel_compression_get(ef));
+   eet_parallel_compression_set(ef, EINA_TRUE);
+   fail_if(!eet_parallel_compression_get(ef));
+
+   for (i = 0; i < 500; i++)
+     {
+        for (j = 0; j < (int)sizeof (data); j++)
+          data[j] = 'a' + ((i + j / 16) % 7);
+
+        snprintf(name, sizeof (name), "entry/%i", i);
+        fail_if(eet_write(ef, name, data, sizeof (data), comps[i % 4]) != sizeof (data));
+     }
+
+   /* not compressible, stored as is */
+   for (j = 0; j < (int)sizeof (data); j++)
+     data[j] = (j * 2654435761U) >> 24;
+   fail_if(!eet_write(ef, "random", data, sizeof (data), 1));
+
+   /* pending entries are readable before the flush */
+   test = eet_read(ef, "entry/1", &size);
+   fail_if(!test);
+   fail_if(size != sizeof (data));
+   fail_if(test[0] != 'b');
+   free(test);
+
+   fail_if(eet_close(ef) != EET_ERROR_NONE);
+
+   ef = eet_open(file, EET_FILE_MODE_READ);
+   fail_if(!ef);
+
+   for (i = 0; i < 500; i++)
+     {
+        for (j = 0; j < (int)sizeof (data); j++)
+          data[j] = 'a' + ((i + j / 16) % 7);
+
+        snprintf(name, sizeof (name), "entry/%i", i);
+        test = eet_read(ef, name, &size);
+        fail_if(!test);
+        fail_if(size != sizeof (data));
+        fail_if(memcmp(test, data, sizeof (data)) != 0);
+        free(test);
+
+        /* only uncompressed entries can be accessed directly */
+        fail_if((eet_read_direct(ef, name, &size) == NULL) !=
+                (comps[i % 4] != EET_COMPRESSION_NONE));
+     }
+
+   for (j = 0; j < (int)sizeof (data); j++)
+     data[j] = (j * 2654435761U) >> 24;
+   test = eet_read(ef, "random", &size);
+   fail_if(!test);
+   fail_if(size != sizeof (data));
+   fail_if(memcmp(test, data, sizeof (data)) != 0);
+   free(test);
+
+   eet_close(ef);
+
+   fail_if(unlink(file) != 0);
+
+   eet_shutdown();
+}
+END_TEST
+
 START_TEST(eet_image)
 {
    Eet_File *ef;
@@ -2775,6 +2977,8 @@ eet_suite(void)
    tcase_add_test(tc, eet_file_simple_write);
    tcase_add_test(tc, eet_file_data_test);
    tcase_add_test(tc, eet_file_data_dump_test);
+   tcase_add_test(tc, eet_file_data_direct_test);
+   tcase_add_test(tc, eet_file_parallel_compression_test);
    tcase_add_test(tc, eet_file_fp);
    suite_add_tcase(s, tc);
 
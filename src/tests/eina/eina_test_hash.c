@@ -324,6 +324,215 @@ START_TEST(eina_hash_string_fuzze)
 }
 END_TEST
 
+START_TEST(eina_hash_flat_simple)
+{
+   Eina_Hash *hash = NULL;
+   int *test;
+   int array[] = { 1, 42, 4, 5, 6 };
+   const char *long_key = "a key too long to be stored inline";
+
+   fail_if(eina_init() != 2);
+
+   hash = eina_hash_flat_string_new(NULL);
+   fail_if(hash == NULL);
+
+   fail_if(eina_hash_add(hash, "1", &array[0]) != EINA_TRUE);
+   fail_if(eina_hash_add(hash, "42", &array[1]) != EINA_TRUE);
+   fail_if(eina_hash_direct_add(hash, "4", &array[2]) != EINA_TRUE);
+   fail_if(eina_hash_direct_add(hash, "5", &array[3]) != EINA_TRUE);
+   fail_if(eina_hash_add(hash, "", "") != EINA_TRUE);
+   fail_if(eina_hash_add(hash, long_key, &array[4]) != EINA_TRUE);
+
+   test = eina_hash_find(hash, "4");
+   fail_if(!test);
+   fail_if(*test != 4);
+
+   test = eina_hash_find(hash, "42");
+   fail_if(!test);
+   fail_if(*test != 42);
+
+   test = eina_hash_find(hash, "a key too long to be stored inline");
+   fail_if(test != &array[4]);
+   fail_if(eina_hash_del(hash, long_key, NULL) != EINA_TRUE);
+
+   eina_hash_foreach(hash, eina_foreach_check, NULL);
+
+   test = eina_hash_modify(hash, "5", &array[4]);
+   fail_if(!test);
+   fail_if(*test != 5);
+
+   test = eina_hash_find(hash, "5");
+   fail_if(!test);
+   fail_if(*test != 6);
+
+   fail_if(eina_hash_population(hash) != 5);
+
+   fail_if(eina_hash_find(hash, "120") != NULL);
+
+   fail_if(eina_hash_del(hash, "5", NULL) != EINA_TRUE);
+   fail_if(eina_hash_find(hash, "5") != NULL);
+
+   fail_if(eina_hash_del(hash, NULL, &array[2]) != EINA_TRUE);
+   fail_if(eina_hash_find(hash, "4") != NULL);
+
+   fail_if(eina_hash_del(hash, NULL, &array[2]) != EINA_FALSE);
+
+   fail_if(eina_hash_set(hash, "1", NULL) != &array[0]);
+   fail_if(eina_hash_find(hash, "1") != NULL);
+   fail_if(eina_hash_set(hash, "1", &array[0]) != NULL);
+   fail_if(eina_hash_find(hash, "1") != &array[0]);
+
+   fail_if(eina_hash_move(hash, "42", "43") != EINA_TRUE);
+   fail_if(eina_hash_find(hash, "42") != NULL);
+   fail_if(eina_hash_find(hash, "43") != &array[1]);
+
+   fail_if(eina_hash_del(hash, "1", NULL) != EINA_TRUE);
+   fail_if(eina_hash_del(hash, "43", NULL) != EINA_TRUE);
+   fail_if(eina_hash_population(hash) != 1);
+
+   eina_hash_free(hash);
+
+   fail_if(eina_shutdown() != 1);
+}
+END_TEST
+
+START_TEST(eina_hash_flat_all_int)
+{
+   Eina_Hash *hash;
+   int64_t j[] = { 4321312301243122, 6, 7, 128 };
+   int i[] = { 42, 6, 7, 0 };
+   const char *s;
+   int64_t *test2;
+   int *test;
+   int it;
+
+   fail_if(eina_init() != 2);
+
+   hash = eina_hash_flat_int32_new(NULL);
+   fail_if(hash == NULL);
+
+   for (it = 0; it < 4; ++it)
+     fail_if(eina_hash_add(hash, &i[it], &i[it]) != EINA_TRUE);
+   fail_if(eina_hash_add(hash, &i[2], &i[1]) != EINA_TRUE);
+
+   fail_if(eina_hash_del(hash, &i[1], &i[1]) != EINA_TRUE);
+   fail_if(eina_hash_del(hash, &i[2], &i[1]) != EINA_TRUE);
+   test = eina_hash_find(hash, &i[2]);
+   fail_if(test != &i[2]);
+
+   test = eina_hash_find(hash, &i[3]);
+   fail_if(test != &i[3]);
+
+   eina_hash_free(hash);
+
+   hash = eina_hash_flat_int64_new(NULL);
+   fail_if(hash == NULL);
+
+   for (it = 0; it < 4; ++it)
+     fail_if(eina_hash_add(hash, &j[it], &j[it]) != EINA_TRUE);
+
+   fail_if(eina_hash_del(hash, &j[1], &j[1]) != EINA_TRUE);
+   test2 = eina_hash_find(hash, &j[0]);
+   fail_if(test2 != &j[0]);
+
+   eina_hash_free(hash);
+
+   hash = eina_hash_flat_pointer_new(NULL);
+   fail_if(hash == NULL);
+
+   test = &i[0];
+   fail_if(eina_hash_add(hash, &test, &i[1]) != EINA_TRUE);
+   test = &i[0];
+   fail_if(eina_hash_find(hash, &test) != &i[1]);
+
+   eina_hash_free(hash);
+
+   hash = eina_hash_flat_stringshared_new(NULL);
+   fail_if(hash == NULL);
+
+   s = eina_stringshare_add("flat");
+   fail_if(eina_hash_add(hash, s, &i[0]) != EINA_TRUE);
+   fail_if(eina_hash_find(hash, s) != &i[0]);
+   fail_if(eina_hash_del(hash, s, NULL) != EINA_TRUE);
+   fail_if(eina_hash_population(hash) != 0);
+   eina_stringshare_del(s);
+
+   eina_hash_free(hash);
+
+   fail_if(eina_shutdown() != 1);
+}
+END_TEST
+
+START_TEST(eina_hash_flat_fuzze)
+{
+   Eina_Hash *hash;
+   Eina_Iterator *it;
+   unsigned int *r;
+   unsigned int keys[4096];
+   Eina_Bool deleted[20][4096];
+   unsigned int key;
+   unsigned int count;
+   unsigned int i;
+   unsigned int j;
+   unsigned int k;
+
+   eina_init();
+
+   srand(time(NULL));
+
+   hash = eina_hash_flat_int32_new(free);
+   memset(deleted, 0, sizeof (deleted));
+
+   /* grow, churn through tombstones, and check nothing gets lost */
+   for (j = 0; j < 20; ++j)
+     {
+        for (i = 0; i < 4096; ++i)
+          {
+             keys[i] = (j << 16) | i;
+             r = malloc(sizeof (unsigned int));
+             *r = keys[i];
+             fail_if(eina_hash_add(hash, &keys[i], r) != EINA_TRUE);
+          }
+
+        for (i = 0; i < 4096; i += 1 + (rand() % 3))
+          {
+             fail_if(eina_hash_del_by_key(hash, &keys[i]) != EINA_TRUE);
+             deleted[j][i] = EINA_TRUE;
+          }
+
+        /* every key added so far, from this round and the previous ones */
+        for (k = 0; k <= j; ++k)
+          for (i = 0; i < 4096; ++i)
+            {
+               key = (k << 16) | i;
+               r = eina_hash_find(hash, &key);
+               if (deleted[k][i])
+                 fail_if(r != NULL);
+               else
+                 fail_if(r == NULL || *r != key);
+            }
+     }
+
+   count = 0;
+   it = eina_hash_iterator_data_new(hash);
+   EINA_ITERATOR_FOREACH(it, r)
+     {
+        fail_if(eina_hash_find(hash, r) != r);
+        count++;
+     }
+   eina_iterator_free(it);
+   fail_if(count != (unsigned int)eina_hash_population(hash));
+
+   eina_hash_free_buckets(hash);
+   fail_if(eina_hash_population(hash) != 0);
+   fail_if(eina_hash_find(hash, &keys[0]) != NULL);
+
+   eina_hash_free(hash);
+
+   eina_shutdown();
+}
+END_TEST
+
 START_TEST(eina_hash_seed)
 {
    eina_init();
@@ -343,4 +552,7 @@ void eina_test_hash(TCase *tc)
    tcase_add_test(tc, eina_hash_seed);
    tcase_add_test(tc, eina_hash_int32_fuzze);
    tcase_add_test(tc, eina_hash_string_fuzze);
+   tcase_add_test(tc, eina_hash_flat_simple);
+   tcase_add_test(tc, eina_hash_flat_all_int);
+   tcase_add_test(tc, eina_hash_flat_fuzze);
 }
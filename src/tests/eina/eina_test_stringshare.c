@@ -24,6 +24,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
+#include <unistd.h>
 
 #include "eina_suite.h"
 #include "Eina.h"
@@ -100,6 +102,57 @@ START_TEST(eina_stringshare_small)
 END_TEST
 
 
+static int _eina_stringshare_critical_count = 0;
+
+static void
+_eina_stringshare_critical_print_cb(const Eina_Log_Domain *d EINA_UNUSED,
+                                    Eina_Log_Level level,
+                                    const char *file EINA_UNUSED,
+                                    const char *fnc EINA_UNUSED,
+                                    int line EINA_UNUSED,
+                                    const char *fmt EINA_UNUSED,
+                                    void *data EINA_UNUSED,
+                                    va_list args EINA_UNUSED)
+{
+   if (level <= EINA_LOG_LEVEL_CRITICAL)
+     _eina_stringshare_critical_count++;
+}
+
+/* a small string shared more times than a 16-bit count can hold, as the
+ * "ps" format of every paragraph of a long textblock is */
+START_TEST(eina_stringshare_small_many_refs)
+{
+   const char *t0, *t1;
+   int i;
+
+   eina_init();
+
+   eina_log_print_cb_set(_eina_stringshare_critical_print_cb, NULL);
+   _eina_stringshare_critical_count = 0;
+
+   t0 = eina_stringshare_add("ps");
+   for (i = 1; i < 70000; i++)
+     {
+        t1 = eina_stringshare_add("ps");
+        fail_if(t0 != t1);
+     }
+
+   for (i = 1; i < 70000; i++)
+     eina_stringshare_del(t0);
+
+   t1 = eina_stringshare_add("ps");
+   fail_if(t0 != t1);
+   eina_stringshare_del(t1);
+   eina_stringshare_del(t0);
+
+   fail_if(_eina_stringshare_critical_count != 0);
+
+   eina_log_print_cb_set(eina_log_print_cb_stderr, NULL);
+
+   eina_shutdown();
+}
+END_TEST
+
 START_TEST(eina_stringshare_test_share)
 {
    const char *t0;
@@ -233,13 +286,218 @@ START_TEST(eina_stringshare_print)
 }
 END_TEST
 
+/* Strings that fall in the same chain, in the same bucket only, or
+ * anywhere, added and dropped from several threads at once. The writers
+ * keep a few references of their own, so nodes keep being freed and
+ * created again while the readers look them up. */
+#define SHARE_STRINGS 16
+#define SHARE_WRITERS 4
+#define SHARE_READERS 4
+#define SHARE_ROUNDS 400000
+#define SHARE_HELD 2
+
+static char _share_strings[SHARE_STRINGS][32];
+/* a reference kept by the main thread on every other string */
+static const char *_share_anchors[SHARE_STRINGS];
+
+static void
+_share_strings_build(void)
+{
+   unsigned int base, h;
+   int chain = 0, bucket = 0, other = 0;
+   int i, len;
+
+   base = eina_hash_superfast("thread/0", 8);
+   strcpy(_share_strings[0], "thread/0");
+   for (i = 1; chain + bucket + other < SHARE_STRINGS - 1; i++)
+     {
+        char buf[32];
+
+        len = sprintf(buf, "thread/%i", i);
+        h = eina_hash_superfast(buf, len);
+        if ((h & 0xffff) == (base & 0xffff))
+          {
+             if (chain >= SHARE_STRINGS / 2 - 1) continue;
+             chain++;
+          }
+        else if ((h & 0xff00) == (base & 0xff00))
+          {
+             if (bucket >= SHARE_STRINGS / 4) continue;
+             bucket++;
+          }
+        else
+          {
+             if (other >= SHARE_STRINGS / 4) continue;
+             other++;
+          }
+        strcpy(_share_strings[chain + bucket + other], buf);
+     }
+}
+
+/* a shared string that is not what was asked for, or a freed one */
+static Eina_Bool
+_share_string_bad(const char *s, int i)
+{
+   return !s || strcmp(s, _share_strings[i]) ||
+     (eina_stringshare_strlen(s) != (int)strlen(_share_strings[i]));
+}
+
+static void *
+_share_writer(void *data, Eina_Thread t EINA_UNUSED)
+{
+   const char *held[SHARE_STRINGS][SHARE_HELD];
+   int count[SHARE_STRINGS] = { 0 };
+   unsigned int seed = (uintptr_t)data;
+   intptr_t errors = 0;
+   int r, i, j;
+
+   for (r = 0; r < SHARE_ROUNDS; r++)
+     {
+        const char *s;
+
+        i = rand_r(&seed) % SHARE_STRINGS;
+        if ((count[i] < SHARE_HELD) && (rand_r(&seed) & 1))
+          {
+             if (count[i] && (rand_r(&seed) & 1))
+               s = eina_stringshare_ref(held[i][0]);
+             else
+               s = eina_stringshare_add(_share_strings[i]);
+             if (_share_string_bad(s, i)) errors++;
+             /* a node stays the same while we hold it */
+             if (count[i] && (s != held[i][0])) errors++;
+             if (_share_anchors[i] && (s != _share_anchors[i])) errors++;
+             held[i][count[i]++] = s;
+          }
+        else if (count[i])
+          {
+             eina_stringshare_del(held[i][--count[i]]);
+          }
+     }
+
+   for (i = 0; i < SHARE_STRINGS; i++)
+     for (j = 0; j < count[i]; j++)
+       eina_stringshare_del(held[i][j]);
+
+   return (void *)errors;
+}
+
+static void *
+_share_reader(void *data, Eina_Thread t EINA_UNUSED)
+{
+   unsigned int seed = (uintptr_t)data;
+   intptr_t errors = 0;
+   int r, i;
+
+   for (r = 0; r < SHARE_ROUNDS; r++)
+     {
+        const char *s, *s2;
+
+        i = rand_r(&seed) % SHARE_STRINGS;
+        s = eina_stringshare_add(_share_strings[i]);
+        s2 = eina_stringshare_add(_share_strings[i]);
+        if (_share_string_bad(s, i) || (s != s2)) errors++;
+        eina_stringshare_del(s2);
+        eina_stringshare_del(s);
+     }
+
+   return (void *)errors;
+}
+
+/* the references of each test string, as eina_stringshare_dump() prints
+ * them, -1 for a string that isn't shared anymore */
+static void
+_share_references_get(int *references)
+{
+   char line[256], str[64];
+   int out, len, ref, i;
+   FILE *f;
+
+   for (i = 0; i < SHARE_STRINGS; i++)
+     references[i] = -1;
+
+   f = tmpfile();
+   fail_if(!f);
+   fflush(stdout);
+   out = dup(STDOUT_FILENO);
+   dup2(fileno(f), STDOUT_FILENO);
+   eina_stringshare_dump();
+   fflush(stdout);
+   dup2(out, STDOUT_FILENO);
+   close(out);
+
+   rewind(f);
+   while (fgets(line, sizeof (line), f))
+     {
+        if (sscanf(line, "DDD: %i %i '%63[^']'", &len, &ref, str) != 3)
+          continue;
+        for (i = 0; i < SHARE_STRINGS; i++)
+          if (!strcmp(str, _share_strings[i]))
+            references[i] = ref;
+     }
+   fclose(f);
+}
+
+START_TEST(eina_stringshare_threads)
+{
+   Eina_Thread threads[SHARE_WRITERS + SHARE_READERS];
+   int references[SHARE_STRINGS];
+   int i;
+
+   eina_init();
+   eina_threads_init();
+
+   eina_log_print_cb_set(_eina_stringshare_critical_print_cb, NULL);
+   _eina_stringshare_critical_count = 0;
+
+   _share_strings_build();
+   for (i = 0; i < SHARE_STRINGS; i += 2)
+     _share_anchors[i] = eina_stringshare_add(_share_strings[i]);
+
+   for (i = 0; i < SHARE_WRITERS + SHARE_READERS; i++)
+     fail_if(!eina_thread_create(threads + i, EINA_THREAD_NORMAL, -1,
+                                 (i < SHARE_WRITERS) ?
+                                 _share_writer : _share_reader,
+                                 (void *)(uintptr_t)(i + 1)));
+   for (i = 0; i < SHARE_WRITERS + SHARE_READERS; i++)
+     fail_if(eina_thread_join(threads[i]) != NULL);
+
+   /* only the anchors are left */
+   _share_references_get(references);
+   for (i = 0; i < SHARE_STRINGS; i++)
+     {
+        fail_if(references[i] != ((i & 1) ? -1 : 1), "%s has %i references",
+                _share_strings[i], references[i]);
+        if (!(i & 1))
+          fail_if(eina_stringshare_add(_share_strings[i]) != _share_anchors[i]);
+     }
+
+   for (i = 0; i < SHARE_STRINGS; i += 2)
+     {
+        eina_stringshare_del(_share_anchors[i]);
+        eina_stringshare_del(_share_anchors[i]);
+     }
+   _share_references_get(references);
+   for (i = 0; i < SHARE_STRINGS; i++)
+     fail_if(references[i] != -1);
+
+   fail_if(_eina_stringshare_critical_count != 0);
+
+   eina_log_print_cb_set(eina_log_print_cb_stderr, NULL);
+
+   eina_threads_shutdown();
+   eina_shutdown();
+}
+END_TEST
+
 void
 eina_test_stringshare(TCase *tc)
 {
    tcase_add_test(tc, eina_stringshare_simple);
    tcase_add_test(tc, eina_stringshare_small);
+   tcase_add_test(tc, eina_stringshare_small_many_refs);
    tcase_add_test(tc, eina_stringshare_test_share);
    tcase_add_test(tc, eina_stringshare_collision);
    tcase_add_test(tc, eina_stringshare_putstuff);
    tcase_add_test(tc, eina_stringshare_print);
+   tcase_add_test(tc, eina_stringshare_threads);
 }
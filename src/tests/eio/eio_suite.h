@@ -0,0 +1,9 @@
+#ifndef _EIO_SUITE_H
+#define _EIO_SUITE_H
+
+#include <check.h>
+
+void eio_test_file(TCase *tc);
+void eio_test_file_uring(TCase *tc);
+
+#endif /* _EIO_SUITE_H */
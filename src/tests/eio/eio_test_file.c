@@ -0,0 +1,427 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <Eina.h>
+#include <Ecore.h>
+#include <Eio.h>
+
+#include "eio_suite.h"
+
+#define CONTENT "eio test file content\n"
+
+/* Counts the callbacks of the requests a test queued, the main loop stops
+ * once all of them reported. */
+typedef struct _Eio_Test Eio_Test;
+
+struct _Eio_Test
+{
+   int pending;
+   int done;
+   int error;
+   int last_error;
+   Eina_Stat st;
+};
+
+static Eina_Bool
+_eio_test_timeout(void *data EINA_UNUSED)
+{
+   fail("the eio requests never completed");
+   ecore_main_loop_quit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_eio_test_run(Eio_Test *t)
+{
+   Ecore_Timer *timer;
+
+   if (t->pending <= 0) return;
+   timer = ecore_timer_add(10.0, _eio_test_timeout, NULL);
+   ecore_main_loop_begin();
+   ecore_timer_del(timer);
+}
+
+static void
+_eio_test_reported(Eio_Test *t)
+{
+   if (--t->pending == 0) ecore_main_loop_quit();
+}
+
+static void
+_eio_test_done_cb(void *data, Eio_File *handler EINA_UNUSED)
+{
+   Eio_Test *t = data;
+
+   t->done++;
+   _eio_test_reported(t);
+}
+
+static void
+_eio_test_stat_cb(void *data, Eio_File *handler EINA_UNUSED,
+                  const Eina_Stat *st)
+{
+   Eio_Test *t = data;
+
+   t->st = *st;
+   t->done++;
+   _eio_test_reported(t);
+}
+
+static void
+_eio_test_cancelled_stat_cb(void *data EINA_UNUSED,
+                            Eio_File *handler EINA_UNUSED,
+                            const Eina_Stat *st EINA_UNUSED)
+{
+   fail("a cancelled request completed");
+}
+
+static void
+_eio_test_error_cb(void *data, Eio_File *handler EINA_UNUSED, int error)
+{
+   Eio_Test *t = data;
+
+   t->last_error = error;
+   t->error++;
+   _eio_test_reported(t);
+}
+
+static void
+_eio_test_progress_cb(void *data EINA_UNUSED, Eio_File *handler EINA_UNUSED,
+                      const Eio_Progress *info EINA_UNUSED)
+{
+}
+
+static char *
+_eio_test_path(const char *dir, const char *name)
+{
+   char *path;
+
+   path = malloc(strlen(dir) + strlen(name) + 2);
+   fail_if(!path);
+   sprintf(path, "%s/%s", dir, name);
+   return path;
+}
+
+static void
+_eio_test_file_write(const char *path)
+{
+   int fd;
+
+   fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+   fail_if(fd < 0);
+   fail_if(write(fd, CONTENT, strlen(CONTENT)) != (ssize_t)strlen(CONTENT));
+   close(fd);
+}
+
+static Eina_Bool
+_eio_test_file_check(const char *path)
+{
+   char buf[sizeof(CONTENT) + 1];
+   ssize_t r;
+   int fd;
+
+   fd = open(path, O_RDONLY);
+   if (fd < 0) return EINA_FALSE;
+   r = read(fd, buf, sizeof(buf));
+   close(fd);
+
+   return (r == (ssize_t)strlen(CONTENT)) && !memcmp(buf, CONTENT, r);
+}
+
+static Eina_Tmpstr *
+_eio_test_dir_new(const char *parent)
+{
+   Eina_Tmpstr *dir = NULL;
+   char *templatename;
+
+   if (!parent) return eina_file_mkdtemp("eio_test_XXXXXX", &dir) ? dir : NULL;
+
+   templatename = _eio_test_path(parent, "eio_test_XXXXXX");
+   if (mkdtemp(templatename)) dir = eina_tmpstr_add(templatename);
+   free(templatename);
+   return dir;
+}
+
+START_TEST(eio_test_file_stat)
+{
+   Eio_Test t = { 0 };
+   Eina_Tmpstr *dir;
+   char *file, *missing;
+
+   fail_if(eio_init() < 1);
+
+   dir = _eio_test_dir_new(NULL);
+   fail_if(!dir);
+   file = _eio_test_path(dir, "file");
+   missing = _eio_test_path(dir, "missing");
+   _eio_test_file_write(file);
+
+   t.pending = 1;
+   fail_if(!eio_file_direct_stat(file, _eio_test_stat_cb, _eio_test_error_cb,
+                                 &t));
+   _eio_test_run(&t);
+   fail_if(t.done != 1);
+   fail_if(t.st.size != strlen(CONTENT));
+   fail_if(!S_ISREG(t.st.mode));
+
+   t.pending = 1;
+   fail_if(!eio_file_direct_stat(dir, _eio_test_stat_cb, _eio_test_error_cb,
+                                 &t));
+   _eio_test_run(&t);
+   fail_if(t.done != 2);
+   fail_if(!S_ISDIR(t.st.mode));
+
+   t.pending = 1;
+   fail_if(!eio_file_direct_stat(missing, _eio_test_stat_cb,
+                                 _eio_test_error_cb, &t));
+   _eio_test_run(&t);
+   fail_if(t.done != 2);
+   fail_if(t.error != 1);
+   fail_if(t.last_error != ENOENT);
+
+   unlink(file);
+   rmdir(dir);
+   free(missing);
+   free(file);
+   eina_tmpstr_del(dir);
+
+   eio_shutdown();
+}
+END_TEST
+
+START_TEST(eio_test_file_mkdir_unlink)
+{
+   Eio_Test t = { 0 };
+   Eina_Tmpstr *dir;
+   char *sub, *file;
+   struct stat st;
+
+   fail_if(eio_init() < 1);
+
+   dir = _eio_test_dir_new(NULL);
+   fail_if(!dir);
+   sub = _eio_test_path(dir, "sub");
+   file = _eio_test_path(dir, "file");
+   _eio_test_file_write(file);
+
+   t.pending = 2;
+   fail_if(!eio_file_mkdir(sub, 0700, _eio_test_done_cb, _eio_test_error_cb,
+                           &t));
+   fail_if(!eio_file_unlink(file, _eio_test_done_cb, _eio_test_error_cb,
+                            &t));
+   _eio_test_run(&t);
+   fail_if(t.done != 2);
+   fail_if(stat(sub, &st) != 0);
+   fail_if(!S_ISDIR(st.st_mode));
+   fail_if((st.st_mode & 0777) != 0700);
+   fail_if(access(file, F_OK) == 0);
+
+   /* both fail the second time */
+   t.pending = 1;
+   fail_if(!eio_file_mkdir(sub, 0700, _eio_test_done_cb, _eio_test_error_cb,
+                           &t));
+   _eio_test_run(&t);
+   fail_if(t.error != 1);
+   fail_if(t.last_error != EEXIST);
+
+   t.pending = 1;
+   fail_if(!eio_file_unlink(file, _eio_test_done_cb, _eio_test_error_cb,
+                            &t));
+   _eio_test_run(&t);
+   fail_if(t.done != 2);
+   fail_if(t.error != 2);
+   fail_if(t.last_error != ENOENT);
+
+   rmdir(sub);
+   rmdir(dir);
+   free(file);
+   free(sub);
+   eina_tmpstr_del(dir);
+
+   eio_shutdown();
+}
+END_TEST
+
+START_TEST(eio_test_file_move)
+{
+   Eio_Test t = { 0 };
+   Eina_Tmpstr *dir;
+   char *src, *dst;
+
+   fail_if(eio_init() < 1);
+
+   dir = _eio_test_dir_new(NULL);
+   fail_if(!dir);
+   src = _eio_test_path(dir, "src");
+   dst = _eio_test_path(dir, "dst");
+   _eio_test_file_write(src);
+
+   t.pending = 1;
+   fail_if(!eio_file_move(src, dst, _eio_test_progress_cb, _eio_test_done_cb,
+                          _eio_test_error_cb, &t));
+   _eio_test_run(&t);
+   fail_if(t.done != 1);
+   fail_if(access(src, F_OK) == 0);
+   fail_if(!_eio_test_file_check(dst));
+
+   /* the source is gone now */
+   t.pending = 1;
+   fail_if(!eio_file_move(src, dst, _eio_test_progress_cb, _eio_test_done_cb,
+                          _eio_test_error_cb, &t));
+   _eio_test_run(&t);
+   fail_if(t.error != 1);
+   fail_if(t.last_error != ENOENT);
+   fail_if(!_eio_test_file_check(dst));
+
+   unlink(dst);
+   rmdir(dir);
+   free(dst);
+   free(src);
+   eina_tmpstr_del(dir);
+
+   eio_shutdown();
+}
+END_TEST
+
+START_TEST(eio_test_file_move_exdev)
+{
+   static const char *parents[] = { "/dev/shm", "/run/shm", "/var/tmp" };
+   Eio_Test t = { 0 };
+   Eina_Tmpstr *dir, *other = NULL;
+   struct stat st_dir, st_other;
+   char *src, *dst;
+   unsigned int i;
+
+   fail_if(eio_init() < 1);
+
+   dir = _eio_test_dir_new(NULL);
+   fail_if(!dir);
+   fail_if(stat(dir, &st_dir) != 0);
+
+   /* rename() fails with EXDEV to another file system, look for one */
+   for (i = 0; i < sizeof(parents) / sizeof(parents[0]); i++)
+     {
+        if ((stat(parents[i], &st_other) != 0) ||
+            (st_other.st_dev == st_dir.st_dev))
+          continue;
+        other = _eio_test_dir_new(parents[i]);
+        if (other) break;
+     }
+   if (!other)
+     {
+        fprintf(stderr, "no second file system, skipping the EXDEV move\n");
+        rmdir(dir);
+        eina_tmpstr_del(dir);
+        eio_shutdown();
+        return;
+     }
+
+   src = _eio_test_path(dir, "src");
+   dst = _eio_test_path(other, "dst");
+   _eio_test_file_write(src);
+
+   t.pending = 1;
+   fail_if(!eio_file_move(src, dst, _eio_test_progress_cb, _eio_test_done_cb,
+                          _eio_test_error_cb, &t));
+   _eio_test_run(&t);
+   fail_if(t.error != 0, "move failed with %i", t.last_error);
+   fail_if(t.done != 1);
+   fail_if(access(src, F_OK) == 0);
+   fail_if(!_eio_test_file_check(dst));
+
+   unlink(dst);
+   rmdir(other);
+   rmdir(dir);
+   free(dst);
+   free(src);
+   eina_tmpstr_del(other);
+   eina_tmpstr_del(dir);
+
+   eio_shutdown();
+}
+END_TEST
+
+START_TEST(eio_test_file_cancel)
+{
+   Eio_File *files[64];
+   Eio_Test t = { 0 };
+   Eina_Tmpstr *dir;
+   char *file;
+   int i;
+
+   fail_if(eio_init() < 1);
+
+   dir = _eio_test_dir_new(NULL);
+   fail_if(!dir);
+   file = _eio_test_path(dir, "file");
+   _eio_test_file_write(file);
+
+   /* every other request is cancelled before the main loop could report
+      it, only their error callback may run */
+   for (i = 0; i < 64; i++)
+     {
+        files[i] = eio_file_direct_stat(file,
+                                        (i & 1) ? _eio_test_stat_cb :
+                                        _eio_test_cancelled_stat_cb,
+                                        _eio_test_error_cb, &t);
+        fail_if(!files[i]);
+        t.pending++;
+     }
+   for (i = 0; i < 64; i += 2)
+     eio_file_cancel(files[i]);
+   _eio_test_run(&t);
+   fail_if(t.pending != 0);
+   fail_if(t.done != 32);
+   fail_if(t.error != 32);
+
+   /* nothing else comes after the loop ran dry */
+   ecore_main_loop_iterate();
+   fail_if(t.done != 32);
+   fail_if(t.error != 32);
+
+   unlink(file);
+   rmdir(dir);
+   free(file);
+   eina_tmpstr_del(dir);
+
+   eio_shutdown();
+}
+END_TEST
+
+void eio_test_file(TCase *tc)
+{
+   tcase_add_test(tc, eio_test_file_stat);
+   tcase_add_test(tc, eio_test_file_mkdir_unlink);
+   tcase_add_test(tc, eio_test_file_move);
+   tcase_add_test(tc, eio_test_file_move_exdev);
+   tcase_add_test(tc, eio_test_file_cancel);
+}
+
+static void
+_uring_setup(void)
+{
+   setenv("EIO_IO_URING", "1", 1);
+}
+
+static void
+_uring_teardown(void)
+{
+   unsetenv("EIO_IO_URING");
+}
+
+/* the same operations, queued on an io_uring when the kernel has one */
+void eio_test_file_uring(TCase *tc)
+{
+   tcase_add_checked_fixture(tc, _uring_setup, _uring_teardown);
+   eio_test_file(tc);
+}
@@ -124,7 +124,178 @@ START_TEST(eo_threaded_calls_test)
 }
 END_TEST
 
+/* More classes than a call site caches, each with its own data layout and
+ * function, called from several threads at the same time. */
+#define CACHE_TEST_THREADS 4
+#define CACHE_TEST_CALLS 20000
+
+#define CACHE_TEST_CLASS_DEFINE(N)                                          \
+typedef struct                                                              \
+{                                                                           \
+   char pad[N * 24];                                                        \
+   int v;                                                                   \
+} Cache_Test_##N##_Data;                                                    \
+                                                                            \
+static int                                                                  \
+_cache_test_##N##_v_get(Eo *obj EINA_UNUSED, void *class_data)              \
+{                                                                           \
+   Cache_Test_##N##_Data *pd = class_data;                                  \
+                                                                            \
+   return pd->v;                                                            \
+}                                                                           \
+                                                                            \
+const Eo_Class *cache_test_##N##_class_get(void);                           \
+                                                                            \
+static void                                                                 \
+_cache_test_##N##_constructor(Eo *obj, void *class_data, int v)             \
+{                                                                           \
+   Cache_Test_##N##_Data *pd = class_data;                                  \
+                                                                            \
+   eo_do_super(obj, cache_test_##N##_class_get(), thread_test_constructor(v)); \
+   pd->v = (N * 1000) + v;                                                  \
+}                                                                           \
+                                                                            \
+static Eo_Op_Description cache_test_##N##_op_descs[] = {                    \
+     EO_OP_FUNC_OVERRIDE(thread_test_constructor, _cache_test_##N##_constructor), \
+     EO_OP_FUNC_OVERRIDE(thread_test_v_get, _cache_test_##N##_v_get),       \
+     EO_OP_SENTINEL                                                         \
+};                                                                          \
+                                                                            \
+static const Eo_Class_Description cache_test_##N##_class_desc = {           \
+     EO_VERSION,                                                            \
+     "Cache Test " #N,                                                      \
+     EO_CLASS_TYPE_REGULAR,                                                 \
+     EO_CLASS_DESCRIPTION_OPS(cache_test_##N##_op_descs),                   \
+     NULL,                                                                  \
+     sizeof(Cache_Test_##N##_Data),                                         \
+     NULL,                                                                  \
+     NULL                                                                   \
+};                                                                          \
+                                                                            \
+EO_DEFINE_CLASS(cache_test_##N##_class_get, &cache_test_##N##_class_desc, THREAD_TEST_CLASS, NULL)
+
+CACHE_TEST_CLASS_DEFINE(1)
+CACHE_TEST_CLASS_DEFINE(2)
+CACHE_TEST_CLASS_DEFINE(3)
+CACHE_TEST_CLASS_DEFINE(4)
+CACHE_TEST_CLASS_DEFINE(5)
+
+static const Eo_Class *
+_cache_test_class_get(int n)
+{
+   switch (n)
+     {
+      case 1: return cache_test_1_class_get();
+      case 2: return cache_test_2_class_get();
+      case 3: return cache_test_3_class_get();
+      case 4: return cache_test_4_class_get();
+      case 5: return cache_test_5_class_get();
+      default: return THREAD_TEST_CLASS;
+     }
+}
+
+static void *
+_cache_thread_job(void *data, Eina_Thread t EINA_UNUSED)
+{
+   Eo *objs[6];
+   int id = (int) (uintptr_t) data;
+   int errors = 0;
+   int i, v;
+
+   /* objects are not shared, only the call sites are */
+   for (i = 0; i < 6; i++)
+     objs[i] = eo_add_custom(_cache_test_class_get(i), NULL,
+                             thread_test_constructor(id));
+
+   eina_barrier_wait(&barrier);
+
+   for (i = 0; i < CACHE_TEST_CALLS; i++)
+     {
+        int n = (i * 7 + id) % 6;
+
+        eo_do(objs[n], v = thread_test_v_get());
+        if (v != (n * 1000) + id) errors++;
+     }
+
+   for (i = 0; i < 6; i++)
+     eo_unref(objs[i]);
+
+   return (void *) (uintptr_t) errors;
+}
+
+START_TEST(eo_threaded_call_cache_test)
+{
+   Eina_Thread threads[CACHE_TEST_THREADS];
+   int i;
+
+   eo_init();
+
+   /* classes are created before the threads race on the call sites */
+   for (i = 0; i < 6; i++)
+     fail_if(!_cache_test_class_get(i));
+   fail_if(!eina_barrier_new(&barrier, CACHE_TEST_THREADS));
+
+   for (i = 0; i < CACHE_TEST_THREADS; i++)
+     fail_if(!eina_thread_create(&threads[i], EINA_THREAD_NORMAL, -1,
+                                 _cache_thread_job, (void *) (uintptr_t) i));
+
+   for (i = 0; i < CACHE_TEST_THREADS; i++)
+     fail_if(0 != (int) (uintptr_t) eina_thread_join(threads[i]));
+
+   eina_barrier_free(&barrier);
+
+   eo_shutdown();
+}
+END_TEST
+
+/* A thread filling its object magazines and outliving eo_shutdown(), its
+ * exit must neither leak them nor give them back to freed pools. */
+static void *
+_shutdown_thread_job(void *data EINA_UNUSED, Eina_Thread t EINA_UNUSED)
+{
+   Eo *objs[64];
+   int i, v = 0;
+
+   for (i = 0; i < 64; i++)
+     objs[i] = eo_add_custom(THREAD_TEST_CLASS, NULL, thread_test_constructor(i));
+   for (i = 0; i < 64; i++)
+     {
+        int r = 0;
+
+        eo_do(objs[i], r = thread_test_v_get());
+        v += r;
+        eo_unref(objs[i]);
+     }
+
+   /* eo gets shut down here */
+   eina_barrier_wait(&barrier);
+   eina_barrier_wait(&barrier);
+
+   return (void *) (uintptr_t) v;
+}
+
+START_TEST(eo_threaded_shutdown_test)
+{
+   Eina_Thread thread;
+
+   fail_if(!eina_barrier_new(&barrier, 2));
+   fail_if(!eina_thread_create(&thread, EINA_THREAD_NORMAL, 0, _shutdown_thread_job, NULL));
+
+   eina_barrier_wait(&barrier);
+   fail_if(!eo_shutdown()); /* one init by test suite */
+   eina_barrier_wait(&barrier);
+
+   fail_if((63 * 64 / 2) != (int)(uintptr_t)eina_thread_join(thread));
+
+   eina_barrier_free(&barrier);
+
+   fail_if(!eo_init());
+}
+END_TEST
+
 void eo_test_threaded_calls(TCase *tc)
 {
    tcase_add_test(tc, eo_threaded_calls_test);
+   tcase_add_test(tc, eo_threaded_call_cache_test);
+   tcase_add_test(tc, eo_threaded_shutdown_test);
 }
@@ -26,6 +26,10 @@ static const Evas_Test_Case etc[] = {
   { "Render Engines", evas_test_render_engines },
   { "Filters", evas_test_filters },
   { "Images", evas_test_image_object },
+  { "Blend Ops", evas_test_blend_ops },
+  { "Scale Cache", evas_test_scalecache },
+  { "Scale", evas_test_scale },
+  { "Glyph Draw", evas_test_glyph_draw },
   { NULL, NULL }
 };
 
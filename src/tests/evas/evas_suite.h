@@ -11,5 +11,9 @@ void evas_test_callbacks(TCase *tc);
 void evas_test_render_engines(TCase *tc);
 void evas_test_filters(TCase *tc);
 void evas_test_image_object(TCase *tc);
+void evas_test_blend_ops(TCase *tc);
+void evas_test_scalecache(TCase *tc);
+void evas_test_scale(TCase *tc);
+void evas_test_glyph_draw(TCase *tc);
 
 #endif /* _EVAS_SUITE_H */
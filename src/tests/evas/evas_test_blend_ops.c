@@ -0,0 +1,133 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "evas_suite.h"
+#include "evas_common_private.h"
+
+/* The longest span tried, and how many more pixels the buffers have to
+ * start it at every alignment of a ymm register. */
+#define LEN 80
+#define OFFSETS 8
+
+static const DATA32 _colors_sc[] = { 0xa0603018, 0x40201008, 0x01000100 };
+static const DATA32 _colors_an[] = { 0xff804020, 0xff00ff01, 0xffffff00 };
+static const DATA32 _colors_aa[] = { 0xa0a0a0a0, 0x01010101, 0xfefefefe };
+static const DATA32 _colors_n[] = { 0xffffffff };
+
+static DATA32
+_pixel_random(int a)
+{
+   DATA32 r = rand() % (a + 1), g = rand() % (a + 1), b = rand() % (a + 1);
+
+   return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+/* Any alpha, premultiplied, with some fully transparent or opaque runs */
+static int
+_alpha_random(int i)
+{
+   if ((i & 0x18) == 0x08) return 0;
+   if ((i & 0x18) == 0x10) return 0xff;
+   return rand() & 0xff;
+}
+
+START_TEST(evas_blend_ops_avx2)
+{
+   static const int ops[] = {
+      _EVAS_RENDER_BLEND, _EVAS_RENDER_COPY, _EVAS_RENDER_MUL
+   };
+   DATA32 src[SP_LAST][LEN + OFFSETS];
+   DATA32 dst[DP_LAST][LEN + OFFSETS];
+   DATA32 d1[LEN + OFFSETS], d2[LEN + OFFSETS];
+   DATA8 mask[LEN + OFFSETS];
+   unsigned int o;
+   int s, m, c, d, i;
+
+   evas_init();
+   evas_common_cpu_init();
+   evas_common_blend_init();
+
+   srand(42);
+   for (i = 0; i < LEN + OFFSETS; i++)
+     {
+        int a = _alpha_random(i);
+
+        src[SP_N][i] = 0;
+        src[SP][i] = _pixel_random(a);
+        src[SP_AN][i] = _pixel_random(0xff);
+        src[SP_AS][i] = _pixel_random((i & 0x7) ? ((i & 0x8) ? 0xff : 0) : a);
+        dst[DP][i] = _pixel_random(_alpha_random(i + 5));
+        dst[DP_AN][i] = _pixel_random(0xff);
+        mask[i] = _alpha_random(i + 3);
+     }
+
+   /* The AVX2 column is empty if the cpu can't run it, nothing to compare
+    * with then. */
+   for (o = 0; o < sizeof(ops) / sizeof(ops[0]); o++)
+     for (s = 0; s < SP_LAST; s++)
+       for (m = 0; m < SM_LAST; m++)
+         for (c = 0; c < SC_LAST; c++)
+           for (d = 0; d < DP_LAST; d++)
+             {
+                RGBA_Gfx_Func func_c, func_avx2;
+                const DATA32 *colors;
+                int ncolors, k, off, len;
+
+                func_c = evas_common_gfx_func_composite_span_cpu_get
+                  (ops[o], s, m, c, d, CPU_C);
+                func_avx2 = evas_common_gfx_func_composite_span_cpu_get
+                  (ops[o], s, m, c, d, CPU_AVX2);
+                if (!func_c || !func_avx2) continue;
+
+                switch (c)
+                  {
+                   case SC:
+                     colors = _colors_sc;
+                     ncolors = sizeof(_colors_sc) / sizeof(DATA32);
+                     break;
+                   case SC_AN:
+                     colors = _colors_an;
+                     ncolors = sizeof(_colors_an) / sizeof(DATA32);
+                     break;
+                   case SC_AA:
+                     colors = _colors_aa;
+                     ncolors = sizeof(_colors_aa) / sizeof(DATA32);
+                     break;
+                   default:
+                     colors = _colors_n;
+                     ncolors = 1;
+                     break;
+                  }
+
+                for (k = 0; k < ncolors; k++)
+                  for (off = 0; off < OFFSETS; off++)
+                    for (len = 0; len <= LEN; len++)
+                      {
+                         memcpy(d1, dst[d], sizeof(d1));
+                         memcpy(d2, dst[d], sizeof(d2));
+                         func_c((s != SP_N) ? src[s] + off : NULL,
+                                (m != SM_N) ? mask + off : NULL,
+                                colors[k], d1 + off, len);
+                         func_avx2((s != SP_N) ? src[s] + off : NULL,
+                                   (m != SM_N) ? mask + off : NULL,
+                                   colors[k], d2 + off, len);
+                         fail_if(memcmp(d1, d2, sizeof(d1)),
+                                 "op %i: s %i m %i c %i (%08x) d %i, "
+                                 "offset %i length %i",
+                                 ops[o], s, m, c, colors[k], d, off, len);
+                      }
+             }
+
+   evas_shutdown();
+}
+END_TEST
+
+void evas_test_blend_ops(TCase *tc)
+{
+   tcase_add_test(tc, evas_blend_ops_avx2);
+}
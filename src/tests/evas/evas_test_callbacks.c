@@ -6,7 +6,9 @@
 #include <stdio.h>
 
 #include "evas_suite.h"
-#include "Evas.h"
+#include "evas_common_private.h"
+#include "evas_private.h"
+#include "Ecore_Evas.h"
 #include "evas_tests_helpers.h"
 
 #define START_CALLBACK_TEST() \
@@ -128,8 +130,299 @@ START_TEST(evas_event_callbacks_priority)
 }
 END_TEST
 
+static void
+_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+   Evas_Object **hit = data;
+
+   (void) e;
+   (void) event_info;
+
+   *hit = obj;
+}
+
+static Evas_Object *
+_mouse_down_hit(Ecore_Evas *ee, Evas_Object **hit, int x, int y)
+{
+   Evas *evas = ecore_evas_get(ee);
+
+   *hit = NULL;
+   ecore_evas_manual_render(ee);
+   evas_event_feed_mouse_move(evas, x, y, 0, NULL);
+   evas_event_feed_mouse_down(evas, 1, EVAS_BUTTON_NONE, 0, NULL);
+   evas_event_feed_mouse_up(evas, 1, EVAS_BUTTON_NONE, 0, NULL);
+
+   return *hit;
+}
+
+START_TEST(evas_object_event_callbacks_many_objects)
+{
+   Ecore_Evas *ee;
+   Evas *evas;
+   Evas_Object *rects[100];
+   Evas_Object *hit = NULL;
+   int i;
+
+   evas_init();
+   ecore_evas_init();
+   ee = ecore_evas_buffer_new(500, 500);
+   ecore_evas_show(ee);
+   ecore_evas_manual_render_set(ee, EINA_TRUE);
+   evas = ecore_evas_get(ee);
+
+   /* enough objects for evas to index them */
+   for (i = 0; i < 100; i++)
+     {
+        rects[i] = evas_object_rectangle_add(evas);
+        evas_object_move(rects[i], (i % 10) * 40, (i / 10) * 40);
+        evas_object_resize(rects[i], 30, 30);
+        evas_object_show(rects[i]);
+        evas_object_event_callback_add(rects[i], EVAS_CALLBACK_MOUSE_DOWN,
+                                       _mouse_down_cb, &hit);
+     }
+   evas_event_feed_mouse_in(evas, 0, NULL);
+
+   fail_if(_mouse_down_hit(ee, &hit, 45, 45) != rects[11]);
+   fail_if(_mouse_down_hit(ee, &hit, 35, 35) != NULL);
+
+   /* moved and raised on top of another one */
+   evas_object_move(rects[0], 40, 40);
+   fail_if(_mouse_down_hit(ee, &hit, 45, 45) != rects[11]);
+   evas_object_raise(rects[0]);
+   fail_if(_mouse_down_hit(ee, &hit, 45, 45) != rects[0]);
+   fail_if(_mouse_down_hit(ee, &hit, 5, 5) != NULL);
+
+   evas_object_hide(rects[0]);
+   fail_if(_mouse_down_hit(ee, &hit, 45, 45) != rects[11]);
+
+   evas_object_del(rects[11]);
+   fail_if(_mouse_down_hit(ee, &hit, 45, 45) != NULL);
+
+   evas_object_resize(rects[99], 300, 300);
+   fail_if(_mouse_down_hit(ee, &hit, 480, 480) != rects[99]);
+
+   ecore_evas_free(ee);
+   ecore_evas_shutdown();
+   evas_shutdown();
+}
+END_TEST
+
+/* Random stacks of rectangles, some clipped, some smart members, several
+ * smart levels deep, changed between rounds of lookups. The index has to
+ * give what the walk of the whole stack gives. */
+#define INDEX_W 800
+#define INDEX_H 600
+#define INDEX_OBJECTS 1500
+#define INDEX_SMARTS 40
+#define INDEX_CLIPPERS 20
+
+EVAS_SMART_SUBCLASS_NEW("test_container", _test_container, Evas_Smart_Class,
+                        Evas_Smart_Class, evas_object_smart_clipped_class_get,
+                        NULL);
+
+static void
+_test_container_smart_set_user(Evas_Smart_Class *sc EINA_UNUSED)
+{
+}
+
+static Eina_Bool
+_objects_list_eq(Eina_List *a, Eina_List *b)
+{
+   for (; (a) && (b); a = a->next, b = b->next)
+     if (a->data != b->data) return EINA_FALSE;
+   return (!a) && (!b);
+}
+
+static void
+_objects_index_check(Evas *evas, int x, int y, int *hits)
+{
+   Eina_List *indexed, *walked;
+
+   evas_event_index_enabled_set(EINA_TRUE);
+   indexed = evas_tree_objects_at_xy_get(evas, NULL, x, y);
+   evas_event_index_enabled_set(EINA_FALSE);
+   walked = evas_tree_objects_at_xy_get(evas, NULL, x, y);
+   fail_if(!_objects_list_eq(indexed, walked),
+           "%i,%i: %u objects indexed, %u walked", x, y,
+           eina_list_count(indexed), eina_list_count(walked));
+   *hits += eina_list_count(indexed);
+   eina_list_free(indexed);
+   eina_list_free(walked);
+
+   /* not looked up through the index, nor changed by building it */
+   evas_event_index_enabled_set(EINA_TRUE);
+   indexed = evas_objects_at_xy_get(evas, x, y, EINA_TRUE, EINA_TRUE);
+   evas_event_index_enabled_set(EINA_FALSE);
+   walked = evas_objects_at_xy_get(evas, x, y, EINA_TRUE, EINA_TRUE);
+   fail_if(!_objects_list_eq(indexed, walked), "%i,%i", x, y);
+   eina_list_free(indexed);
+   eina_list_free(walked);
+}
+
+static void
+_objects_index_change(Evas *evas, Evas_Object **objs, Evas_Object **smarts,
+                      Evas_Object **clippers, int k)
+{
+   Evas_Object *o = objs[k], *other;
+   Evas_Map *m;
+
+   switch (rand() % 12)
+     {
+      case 0:
+        evas_object_move(o, rand() % INDEX_W, rand() % INDEX_H);
+        break;
+      case 1:
+        evas_object_resize(o, rand() % 100, rand() % 100);
+        break;
+      case 2:
+        if (rand() % 2) evas_object_raise(o);
+        else evas_object_lower(o);
+        break;
+      case 3:
+        /* only objects of a same smart object and layer stack together */
+        other = objs[rand() % INDEX_OBJECTS];
+        if ((other != o) && (evas_object_smart_parent_get(other) ==
+                             evas_object_smart_parent_get(o)) &&
+            (evas_object_layer_get(other) == evas_object_layer_get(o)))
+          evas_object_stack_above(o, other);
+        break;
+      case 4:
+        if (evas_object_visible_get(o)) evas_object_hide(o);
+        else evas_object_show(o);
+        break;
+      case 5:
+        evas_object_smart_member_add(o, smarts[rand() % INDEX_SMARTS]);
+        break;
+      case 6:
+        evas_object_move(smarts[rand() % INDEX_SMARTS],
+                         rand() % INDEX_W, rand() % INDEX_H);
+        break;
+      case 7:
+        if (rand() % 3) evas_object_clip_set(o, clippers[rand() % INDEX_CLIPPERS]);
+        else evas_object_clip_unset(o);
+        break;
+      case 8:
+        o = clippers[rand() % INDEX_CLIPPERS];
+        evas_object_move(o, rand() % INDEX_W, rand() % INDEX_H);
+        evas_object_resize(o, rand() % 400, rand() % 400);
+        break;
+      case 9:
+        m = evas_map_new(4);
+        evas_map_util_points_populate_from_object(m, o);
+        evas_map_util_rotate(m, 30, INDEX_W / 2, INDEX_H / 2);
+        evas_object_map_set(o, m);
+        evas_object_map_enable_set(o, rand() % 2);
+        evas_map_free(m);
+        break;
+      case 10:
+        evas_object_repeat_events_set(o, !evas_object_repeat_events_get(o));
+        break;
+      case 11:
+        if (rand() % 2)
+          evas_object_smart_member_del(o);
+        else
+          {
+             evas_object_del(o);
+             o = objs[k] = evas_object_rectangle_add(evas);
+             evas_object_move(o, rand() % INDEX_W, rand() % INDEX_H);
+             evas_object_resize(o, 40, 40);
+             evas_object_show(o);
+          }
+        break;
+     }
+}
+
+START_TEST(evas_event_index_objects_at_xy)
+{
+   Evas_Object *objs[INDEX_OBJECTS], *smarts[INDEX_SMARTS];
+   Evas_Object *clippers[INDEX_CLIPPERS];
+   Ecore_Evas *ee;
+   Evas *evas;
+   int i, round, hits = 0;
+
+   evas_init();
+   ecore_evas_init();
+   ee = ecore_evas_buffer_new(INDEX_W, INDEX_H);
+   ecore_evas_show(ee);
+   ecore_evas_manual_render_set(ee, EINA_TRUE);
+   evas = ecore_evas_get(ee);
+   srand(11);
+
+   /* half of the smart objects are members of the other half */
+   for (i = 0; i < INDEX_SMARTS; i++)
+     {
+        smarts[i] = evas_object_smart_add(evas, _test_container_smart_class_new());
+        evas_object_move(smarts[i], rand() % INDEX_W, rand() % INDEX_H);
+        evas_object_show(smarts[i]);
+        if (i >= INDEX_SMARTS / 2)
+          evas_object_smart_member_add(smarts[i],
+                                       smarts[rand() % (INDEX_SMARTS / 2)]);
+     }
+   for (i = 0; i < INDEX_CLIPPERS; i++)
+     {
+        clippers[i] = evas_object_rectangle_add(evas);
+        evas_object_move(clippers[i], rand() % INDEX_W, rand() % INDEX_H);
+        evas_object_resize(clippers[i], rand() % 400, rand() % 400);
+        evas_object_show(clippers[i]);
+     }
+   /* small ones over the whole canvas and a bit out of it, and some so
+    * large they are looked at for every point */
+   for (i = 0; i < INDEX_OBJECTS; i++)
+     {
+        Evas_Object *o = evas_object_rectangle_add(evas);
+
+        evas_object_move(o, (rand() % (INDEX_W + 200)) - 100,
+                         (rand() % (INDEX_H + 200)) - 100);
+        if (i % 50) evas_object_resize(o, rand() % 60, rand() % 60);
+        else evas_object_resize(o, rand() % 1500, rand() % 1200);
+        if (rand() % 10) evas_object_show(o);
+        if (!(rand() % 7)) evas_object_repeat_events_set(o, EINA_TRUE);
+        if (!(rand() % 13)) evas_object_pass_events_set(o, EINA_TRUE);
+        if (!(rand() % 5))
+          evas_object_clip_set(o, clippers[rand() % INDEX_CLIPPERS]);
+        if (!(rand() % 3))
+          evas_object_smart_member_add(o, smarts[rand() % INDEX_SMARTS]);
+        if (!(rand() % 50)) evas_object_layer_set(o, (rand() % 3) - 1);
+        objs[i] = o;
+     }
+
+   for (round = 0; round < 20; round++)
+     {
+        /* the clips are only known after a render */
+        ecore_evas_manual_render(ee);
+        for (i = 0; i < 500; i++)
+          _objects_index_check(evas, (rand() % (INDEX_W + 40)) - 20,
+                               (rand() % (INDEX_H + 40)) - 20, &hits);
+        /* right on the edges of objects and smart objects */
+        for (i = 0; i < 100; i++)
+          {
+             Evas_Object *o;
+             Evas_Coord x, y, w, h;
+
+             if (i % 2) o = smarts[rand() % INDEX_SMARTS];
+             else o = objs[rand() % INDEX_OBJECTS];
+             evas_object_geometry_get(o, &x, &y, &w, &h);
+             _objects_index_check(evas, x, y, &hits);
+             _objects_index_check(evas, x + w, y + h, &hits);
+             _objects_index_check(evas, x + w - 1, y + h + 1, &hits);
+          }
+        for (i = 0; i < 100; i++)
+          _objects_index_change(evas, objs, smarts, clippers,
+                                rand() % INDEX_OBJECTS);
+     }
+   fail_if(hits == 0);
+
+   evas_event_index_enabled_set(EINA_TRUE);
+   ecore_evas_free(ee);
+   ecore_evas_shutdown();
+   evas_shutdown();
+}
+END_TEST
+
 void evas_test_callbacks(TCase *tc)
 {
    tcase_add_test(tc, evas_object_event_callbacks_priority);
    tcase_add_test(tc, evas_event_callbacks_priority);
+   tcase_add_test(tc, evas_object_event_callbacks_many_objects);
+   tcase_add_test(tc, evas_event_index_objects_at_xy);
 }
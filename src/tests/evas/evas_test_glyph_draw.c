@@ -0,0 +1,179 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "evas_suite.h"
+#include "evas_common_private.h"
+#include "evas_font_private.h"
+
+/* The destination is larger than the glyphs so that they can be drawn at
+ * every alignment of a ymm register, and clipped on all sides. */
+#define DST_W 360
+#define DST_H 340
+
+typedef struct _Glyph_Test Glyph_Test;
+
+struct _Glyph_Test
+{
+   const char *name;
+   int w, h;
+   Eina_Bool noise;
+   int header; /* 0 bpp4, 1 to 3 rle4 with an 8, 16 or 32 bit jump table */
+};
+
+/* Small glyphs are packed 4 bits per pixel, larger ones are run length
+ * encoded, the size of the jump table depending on the size of the runs. */
+static const Glyph_Test _glyphs[] = {
+   { "bpp4 odd", 13, 17, EINA_FALSE, 0 },
+   { "bpp4 noise", 15, 15, EINA_TRUE, 0 },
+   { "rle4 8", 32, 16, EINA_FALSE, 1 },
+   { "rle4 16", 60, 40, EINA_FALSE, 2 },
+   { "rle4 16 noise", 200, 100, EINA_TRUE, 2 },
+   { "rle4 32 noise", 300, 300, EINA_TRUE, 3 }
+};
+
+static const DATA32 _colors[] = {
+   0xffffffff, 0xff804020, 0x80402010, 0x01000100
+};
+
+/* A ring, with solid and empty runs longer than 16 pixels and anti aliased
+ * edges, or noise where every pixel is a run of its own. */
+static DATA8 *
+_glyph_mask_new(const Glyph_Test *g)
+{
+   DATA8 *mask;
+   int x, y, cx = g->w / 2, cy = g->h / 2, r = (g->w < g->h ? g->w : g->h) / 2;
+
+   mask = malloc(g->w * g->h);
+   fail_if(!mask);
+   for (y = 0; y < g->h; y++)
+     for (x = 0; x < g->w; x++)
+       {
+          int d = (((x - cx) * (x - cx)) + ((y - cy) * (y - cy))) * 64;
+          int v;
+
+          if (g->noise) v = rand() & 0xff;
+          else if (d > (r * r * 64)) v = 0;
+          else if (d > ((r - 1) * (r - 1) * 64)) v = 0x97;
+          else if (d > ((r / 2) * (r / 2) * 64)) v = 0xff;
+          else v = (x * 16) & 0xff;
+          mask[(y * g->w) + x] = v;
+       }
+   return mask;
+}
+
+static void
+_glyph_dst_fill(DATA32 *dst)
+{
+   int i;
+
+   for (i = 0; i < DST_W * DST_H; i++)
+     {
+        DATA32 a = (i & 0x40) ? 0xff : (rand() & 0xff);
+
+        dst[i] = (a << 24) | ((rand() % (a + 1)) << 16) |
+          ((rand() % (a + 1)) << 8) | (rand() % (a + 1));
+     }
+}
+
+/* The SIMD expanders give the same pixels as the C one, for every kind of
+ * glyph, color, alignment and clip. */
+START_TEST(evas_glyph_draw_simd)
+{
+   static const int cpus[] = { CPU_MMX, CPU_SSE3, CPU_AVX2, CPU_NEON };
+   static const char *cpu_names[] = { "mmx", "sse3", "avx2", "neon" };
+   DATA32 *d0, *d1, *d2;
+   Evas_Glyph_Draw_Func draw_c;
+   unsigned int g, c, k;
+   int compared = 0;
+
+   evas_init();
+   evas_common_cpu_init();
+   evas_common_blend_init();
+
+   d0 = malloc(DST_W * DST_H * sizeof(DATA32));
+   d1 = malloc(DST_W * DST_H * sizeof(DATA32));
+   d2 = malloc(DST_W * DST_H * sizeof(DATA32));
+   fail_if(!d0 || !d1 || !d2);
+
+   draw_c = evas_common_font_glyph_draw_cpu_get(CPU_C);
+   fail_if(!draw_c);
+
+   srand(42);
+   _glyph_dst_fill(d0);
+   for (g = 0; g < sizeof(_glyphs) / sizeof(_glyphs[0]); g++)
+     {
+        const Glyph_Test *gt = _glyphs + g;
+        RGBA_Font_Glyph_Out fgo;
+        DATA8 *mask;
+        int size = 0;
+
+        mask = _glyph_mask_new(gt);
+        memset(&fgo, 0, sizeof(fgo));
+        fgo.rle = evas_common_font_glyph_compress(mask, 256,
+                                                  FT_PIXEL_MODE_GRAY, gt->w,
+                                                  gt->w, gt->h, &size);
+        fail_if(!fgo.rle);
+        fail_if(*(int *)fgo.rle != gt->header, "%s: header %i", gt->name,
+                *(int *)fgo.rle);
+        fgo.bitmap.width = gt->w;
+        fgo.bitmap.rows = gt->h;
+
+        for (k = 0; k < sizeof(cpus) / sizeof(cpus[0]); k++)
+          {
+             Evas_Glyph_Draw_Func draw;
+
+             draw = evas_common_font_glyph_draw_cpu_get(cpus[k]);
+             if (!draw) continue;
+             compared++;
+
+             for (c = 0; c < sizeof(_colors) / sizeof(_colors[0]); c++)
+               {
+                  Evas_Glyph_Color gc;
+                  int off, clip;
+
+                  evas_common_font_glyph_color_set(&gc, _colors[c]);
+                  for (off = 0; off < 8; off++)
+                    for (clip = 0; clip < 4; clip++)
+                      {
+                         int x = 20 + off, y = 20 + off;
+                         int x1 = 0, y1 = 0, x2 = gt->w, y2 = gt->h;
+
+                         /* cut into runs and packed pixel pairs */
+                         if (clip & 1) { x1 = 1 + off; x2 = gt->w - 3; }
+                         if (clip & 2) { y1 = 2; y2 = gt->h - 1 - off; }
+
+                         memcpy(d1, d0, DST_W * DST_H * sizeof(DATA32));
+                         memcpy(d2, d0, DST_W * DST_H * sizeof(DATA32));
+                         draw_c(&fgo, &gc, d1, DST_W, x, y, x1, y1, x2, y2);
+                         draw(&fgo, &gc, d2, DST_W, x, y, x1, y1, x2, y2);
+                         evas_common_cpu_end_opt();
+                         fail_if(memcmp(d1, d2, DST_W * DST_H * sizeof(DATA32)),
+                                 "%s %s: color %08x offset %i clip %i",
+                                 cpu_names[k], gt->name, _colors[c], off, clip);
+                      }
+               }
+          }
+
+        free(fgo.rle);
+        free(mask);
+     }
+
+   if (!compared)
+     fprintf(stderr, "no SIMD glyph expander, nothing to compare the C one with\n");
+
+   free(d2);
+   free(d1);
+   free(d0);
+   evas_shutdown();
+}
+END_TEST
+
+void evas_test_glyph_draw(TCase *tc)
+{
+   tcase_add_test(tc, evas_glyph_draw_simd);
+}
@@ -2,11 +2,21 @@
 # include "config.h"
 #endif
 
+#include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef BUILD_LOADER_JPEG
+# include <jpeglib.h>
+#endif
 
 #include "evas_suite.h"
-#include "Evas.h"
+#include "evas_common_private.h"
+#include "evas_private.h"
+#include "Evas_Engine_Buffer.h"
 #include "evas_tests_helpers.h"
 
 static const char *
@@ -47,7 +57,239 @@ START_TEST(evas_object_image_loader)
 }
 END_TEST
 
+START_TEST(evas_object_image_scale_cache_stats)
+{
+   Evas *e = _setup_evas();
+   Evas_Engine_Info_Buffer *einfo;
+   Evas_Image_Scale_Cache_Stats stats;
+   Evas_Object *o;
+   unsigned int *data;
+   int i;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(e);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = malloc(500 * 500 * 4);
+   einfo->info.dest_buffer_row_bytes = 500 * 4;
+   evas_engine_info_set(e, (Evas_Engine_Info *)einfo);
+
+   o = evas_object_image_filled_add(e);
+   evas_object_image_size_set(o, 200, 200);
+   data = evas_object_image_data_get(o, EINA_TRUE);
+   for (i = 0; i < 200 * 200; i++)
+     data[i] = 0xff000000 | (i * 7);
+   evas_object_image_data_set(o, data);
+   evas_object_image_smooth_scale_set(o, EINA_TRUE);
+   evas_object_resize(o, 150, 150);
+   evas_object_show(o);
+
+   evas_image_scale_cache_stats_reset();
+   for (i = 0; i < 10; i++)
+     {
+        evas_damage_rectangle_add(e, 0, 0, 500, 500);
+        evas_render(e);
+     }
+
+   fail_if(!evas_image_scale_cache_stats_get(&stats));
+   fail_if(stats.misses == 0);
+   fail_if(stats.populates != 1);
+   fail_if(stats.hits == 0);
+   fail_if(stats.hits + stats.misses != 9);
+   fail_if(stats.items != 1);
+   fail_if(stats.size != 150 * 150 * 4);
+   fail_if(stats.size > stats.max_size);
+
+   evas_image_scale_cache_stats_reset();
+   fail_if(!evas_image_scale_cache_stats_get(&stats));
+   fail_if(stats.hits || stats.misses || stats.populates || stats.evictions);
+   fail_if(stats.items != 1);
+
+   evas_image_scale_cache_adaptive_set(EINA_FALSE);
+   fail_if(evas_image_scale_cache_adaptive_get());
+   evas_image_scale_cache_adaptive_set(EINA_TRUE);
+   fail_if(!evas_image_scale_cache_adaptive_get());
+
+   free(einfo->info.dest_buffer);
+   evas_free(e);
+   evas_shutdown();
+}
+END_TEST
+
+#ifdef BUILD_LOADER_JPEG
+/* A file of a megapixel or more, with restart markers, the kind the jpeg
+ * loader decodes in bands across the preload threads. The pixels are not
+ * smooth, so that the bands hold a fair amount of data. */
+static void
+_jpeg_write(const char *file, int w, int h, int components,
+            int h_samp, int v_samp, unsigned int restart_interval)
+{
+   struct jpeg_compress_struct cinfo;
+   struct jpeg_error_mgr jerr;
+   JSAMPROW row;
+   FILE *f;
+   int x, y;
+
+   f = fopen(file, "wb");
+   fail_if(!f);
+   row = malloc(w * components);
+   fail_if(!row);
+
+   cinfo.err = jpeg_std_error(&jerr);
+   jpeg_create_compress(&cinfo);
+   jpeg_stdio_dest(&cinfo, f);
+   cinfo.image_width = w;
+   cinfo.image_height = h;
+   cinfo.input_components = components;
+   cinfo.in_color_space = (components == 3) ? JCS_RGB : JCS_GRAYSCALE;
+   jpeg_set_defaults(&cinfo);
+   jpeg_set_quality(&cinfo, 90, TRUE);
+   cinfo.restart_interval = restart_interval;
+   cinfo.comp_info[0].h_samp_factor = h_samp;
+   cinfo.comp_info[0].v_samp_factor = v_samp;
+   jpeg_start_compress(&cinfo, TRUE);
+
+   for (y = 0; y < h; y++)
+     {
+        for (x = 0; x < w * components; x++)
+          row[x] = ((x * 7) ^ (y * 13) ^ ((x * y) >> 6)) & 0xff;
+        jpeg_write_scanlines(&cinfo, &row, 1);
+     }
+
+   jpeg_finish_compress(&cinfo);
+   jpeg_destroy_compress(&cinfo);
+   free(row);
+   fclose(f);
+}
+
+/* The pixels of the file, decoded with that many preload threads, and
+ * the number of parts the decode was split in. The number of threads is
+ * read once per process, by evas_init(), so the decode is done by a child
+ * process that writes the result to a file. */
+static unsigned int *
+_jpeg_load(const char *file, const char *threads, int scale_down,
+           int *w, int *h, unsigned int *parts)
+{
+   Eina_Tmpstr *out;
+   unsigned int *pixels;
+   FILE *f;
+   pid_t pid;
+   int fd, status;
+
+   fd = eina_file_mkstemp("evas_test_image_XXXXXX", &out);
+   fail_if(fd < 0);
+   close(fd);
+
+   pid = fork();
+   fail_if(pid < 0);
+   if (pid == 0)
+     {
+        Evas *e;
+        Evas_Object *o;
+        void *data;
+
+        setenv("EVAS_PRELOAD_THREADS", threads, 1);
+        e = _setup_evas();
+        o = evas_object_image_add(e);
+        evas_object_image_load_scale_down_set(o, scale_down);
+        evas_object_image_file_set(o, file, NULL);
+        if (evas_object_image_load_error_get(o) != EVAS_LOAD_ERROR_NONE)
+          _exit(1);
+        evas_object_image_size_get(o, w, h);
+        data = evas_object_image_data_get(o, EINA_FALSE);
+        if ((!data) || (*w <= 0) || (*h <= 0)) _exit(1);
+        *parts = _evas_preload_split_parts_get();
+
+        f = fopen(out, "wb");
+        if (!f) _exit(1);
+        if ((fwrite(parts, sizeof (unsigned int), 1, f) != 1) ||
+            (fwrite(w, sizeof (int), 1, f) != 1) ||
+            (fwrite(h, sizeof (int), 1, f) != 1) ||
+            (fwrite(data, sizeof (unsigned int) * *w, *h, f) != (size_t)*h))
+          _exit(1);
+        fclose(f);
+        _exit(0);
+     }
+
+   fail_if(waitpid(pid, &status, 0) != pid);
+   fail_if((!WIFEXITED(status)) || (WEXITSTATUS(status) != 0));
+
+   f = fopen(out, "rb");
+   fail_if(!f);
+   fail_if(fread(parts, sizeof (unsigned int), 1, f) != 1);
+   fail_if(fread(w, sizeof (int), 1, f) != 1);
+   fail_if(fread(h, sizeof (int), 1, f) != 1);
+   pixels = malloc(*w * *h * sizeof (unsigned int));
+   fail_if(!pixels);
+   fail_if(fread(pixels, sizeof (unsigned int) * *w, *h, f) != (size_t)*h);
+   fclose(f);
+
+   unlink(out);
+   eina_tmpstr_del(out);
+
+   return pixels;
+}
+
+START_TEST(evas_object_image_jpeg_split)
+{
+   static const struct {
+      int components, h_samp, v_samp;
+      unsigned int restart_interval;
+   } files[] = {
+      /* 4:2:0, a marker at each MCU row, or cutting rows */
+      { 3, 2, 2, 80 },
+      { 3, 2, 2, 7 },
+      /* 4:2:2, 4:4:4 and grey */
+      { 3, 2, 1, 80 },
+      { 3, 1, 1, 160 },
+      { 1, 1, 1, 32 }
+   };
+   static const int scales[] = { 1, 2, 8 };
+   Eina_Tmpstr *file;
+   unsigned int i, j;
+   int fd;
+
+   fd = eina_file_mkstemp("evas_test_image_XXXXXX.jpg", &file);
+   fail_if(fd < 0);
+   close(fd);
+
+   for (i = 0; i < sizeof (files) / sizeof (files[0]); i++)
+     {
+        _jpeg_write(file, 1280, 832, files[i].components,
+                    files[i].h_samp, files[i].v_samp,
+                    files[i].restart_interval);
+
+        for (j = 0; j < sizeof (scales) / sizeof (scales[0]); j++)
+          {
+             unsigned int *split, *serial;
+             unsigned int parts1, parts2;
+             int w1, h1, w2, h2;
+
+             split = _jpeg_load(file, "4", scales[j], &w1, &h1, &parts1);
+             serial = _jpeg_load(file, "1", scales[j], &w2, &h2, &parts2);
+             /* decoded in bands, all of them run by the preload threads */
+             fail_if(parts1 < 2, "file %u scale %i: %u parts", i, scales[j],
+                     parts1);
+             fail_if(parts1 > 4);
+             fail_if(parts2 != 0);
+             fail_if((w1 != w2) || (h1 != h2));
+             fail_if((w1 != 1280 / scales[j]) || (h1 != 832 / scales[j]));
+             fail_if(memcmp(split, serial, w1 * h1 * sizeof (unsigned int)),
+                     "file %u scale %i", i, scales[j]);
+             free(split);
+             free(serial);
+          }
+     }
+
+   unlink(file);
+   eina_tmpstr_del(file);
+}
+END_TEST
+#endif
+
 void evas_test_image_object(TCase *tc)
 {
    tcase_add_test(tc, evas_object_image_loader);
+   tcase_add_test(tc, evas_object_image_scale_cache_stats);
+#ifdef BUILD_LOADER_JPEG
+   tcase_add_test(tc, evas_object_image_jpeg_split);
+#endif
 }
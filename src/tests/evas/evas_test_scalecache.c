@@ -0,0 +1,558 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "evas_suite.h"
+#include "evas_common_private.h"
+#include "evas_private.h"
+#include "evas_image_private.h"
+#include "Evas_Engine_Buffer.h"
+#include "evas_tests_helpers.h"
+
+/* The on-disk scale cache, driven through its entry points with an image
+ * entry that only has what the cache looks at: the description of a file. */
+
+static Eina_Tmpstr *_dir = NULL;
+
+/* The admission of the scaled copies, with images drawn at a given size
+ * for a number of frames. An image keeps track of 32 scales at most, so
+ * more are needed to go through many sizes. */
+
+#define IMAGES 2
+#define IMAGE_SCALES 32
+
+static Evas *_evas = NULL;
+static Evas_Object *_images[IMAGES];
+static void *_dest = NULL;
+
+static void
+_disk_setup(const char *size_kb)
+{
+   fail_if(!eina_file_mkdtemp("evas_scalecache_XXXXXX", &_dir));
+   setenv("EVAS_SCALECACHE_DISK_DIR", _dir, 1);
+   setenv("EVAS_SCALECACHE_DISK_SIZE", size_kb, 1);
+
+   evas_init();
+   evas_common_scalecache_disk_init();
+   fail_if(!evas_common_scalecache_disk_enabled());
+}
+
+static void
+_disk_teardown(void)
+{
+   Eina_Iterator *it;
+   const Eina_File_Direct_Info *info;
+
+   evas_common_scalecache_disk_shutdown();
+   evas_shutdown();
+
+   it = eina_file_direct_ls(_dir);
+   EINA_ITERATOR_FOREACH(it, info)
+     unlink(info->path);
+   eina_iterator_free(it);
+   rmdir(_dir);
+   eina_tmpstr_del(_dir);
+   _dir = NULL;
+
+   unsetenv("EVAS_SCALECACHE_DISK_DIR");
+   unsetenv("EVAS_SCALECACHE_DISK_SIZE");
+}
+
+/* The writes are done by the preload threads, a shutdown waits for them,
+ * and the next init scans the directory again. */
+static void
+_disk_flush(void)
+{
+   evas_common_scalecache_disk_shutdown();
+   evas_common_scalecache_disk_init();
+}
+
+static void
+_entry_init(Image_Entry *ie, const char *file)
+{
+   memset(ie, 0, sizeof (Image_Entry));
+   ie->file = file;
+   ie->cache_key = file;
+   ie->space = EVAS_COLORSPACE_ARGB8888;
+   ie->w = 640;
+   ie->h = 480;
+   ie->flags.alpha = 1;
+   ie->tstamp.mtime = 1234567890;
+   ie->tstamp.size = 4321;
+}
+
+static void
+_key_init(ScaleitemKey *key, unsigned int dst_w, unsigned int dst_h)
+{
+   memset(key, 0, sizeof (ScaleitemKey));
+   key->src_w = 640;
+   key->src_h = 480;
+   key->dst_w = dst_w;
+   key->dst_h = dst_h;
+   key->smooth = 1;
+}
+
+static RGBA_Image *
+_scaled_new(const ScaleitemKey *key, DATA32 seed)
+{
+   RGBA_Image *im;
+   unsigned int i;
+
+   im = evas_common_image_new(key->dst_w, key->dst_h, 1);
+   fail_if(!im);
+   for (i = 0; i < key->dst_w * key->dst_h; i++)
+     {
+        DATA8 a = (i * 13 + seed) & 0xff;
+
+        im->image.data[i] = (a << 24) | ((a / 2) << 16) | ((a / 3) << 8) |
+          ((i + seed) % (a + 1));
+     }
+   return im;
+}
+
+static void
+_save(Image_Entry *ie, const ScaleitemKey *key, DATA32 seed)
+{
+   RGBA_Image *im;
+
+   im = _scaled_new(key, seed);
+   evas_common_scalecache_disk_save(ie, key, im);
+   /* the pixels are copied, the scaled image can go right away */
+   evas_common_rgba_image_free(&im->cache_entry);
+}
+
+static Eina_Bool
+_load_check(Image_Entry *ie, const ScaleitemKey *key, DATA32 seed)
+{
+   RGBA_Image *im, *ref;
+   Eina_Bool ret;
+
+   im = evas_common_scalecache_disk_load(ie, key);
+   if (!im) return EINA_FALSE;
+
+   ref = _scaled_new(key, seed);
+   ret = ((im->cache_entry.w == key->dst_w) &&
+          (im->cache_entry.h == key->dst_h) &&
+          (im->cache_entry.flags.alpha) &&
+          (!memcmp(im->image.data, ref->image.data,
+                   key->dst_w * key->dst_h * sizeof (DATA32))));
+   evas_common_rgba_image_free(&ref->cache_entry);
+   evas_common_rgba_image_free(&im->cache_entry);
+   return ret;
+}
+
+static unsigned long long
+_dir_size_get(unsigned int *count)
+{
+   Eina_Iterator *it;
+   const Eina_File_Direct_Info *info;
+   unsigned long long total = 0;
+   struct stat st;
+
+   if (count) *count = 0;
+   it = eina_file_direct_ls(_dir);
+   EINA_ITERATOR_FOREACH(it, info)
+     {
+        if (stat(info->path, &st) < 0) continue;
+        total += st.st_size;
+        if (count) (*count)++;
+     }
+   eina_iterator_free(it);
+   return total;
+}
+
+/* the only file of the directory not in the other list */
+static char *
+_dir_new_file_get(const Eina_List *known)
+{
+   Eina_Iterator *it;
+   const Eina_File_Direct_Info *info;
+   const Eina_List *l;
+   const char *s;
+   char *ret = NULL;
+
+   it = eina_file_direct_ls(_dir);
+   EINA_ITERATOR_FOREACH(it, info)
+     {
+        Eina_Bool found = EINA_FALSE;
+
+        EINA_LIST_FOREACH(known, l, s)
+          if (!strcmp(s, info->path)) found = EINA_TRUE;
+        if (found) continue;
+        fail_if(ret != NULL);
+        ret = strdup(info->path);
+     }
+   eina_iterator_free(it);
+   fail_if(!ret);
+   return ret;
+}
+
+START_TEST(evas_scalecache_disk_save_load)
+{
+   Image_Entry ie;
+   ScaleitemKey key;
+   unsigned int count;
+
+   _disk_setup("1024");
+   _entry_init(&ie, "/tmp/evas_test_image.png");
+   _key_init(&key, 97, 61);
+
+   fail_if(evas_common_scalecache_disk_load(&ie, &key));
+
+   _save(&ie, &key, 7);
+   _disk_flush();
+   _dir_size_get(&count);
+   fail_if(count != 1);
+   fail_if(!_load_check(&ie, &key, 7));
+
+   /* and it is still there for the next run, that starts with a scan of
+    * the directory */
+   evas_common_scalecache_disk_shutdown();
+   evas_common_scalecache_disk_init();
+   fail_if(!_load_check(&ie, &key, 7));
+
+   /* an entry that is not cached by the image cache is not written */
+   ie.flags.dirty = 1;
+   _key_init(&key, 31, 17);
+   _save(&ie, &key, 3);
+   _disk_flush();
+   _dir_size_get(&count);
+   fail_if(count != 1);
+
+   _disk_teardown();
+}
+END_TEST
+
+START_TEST(evas_scalecache_disk_key_mismatch)
+{
+   Image_Entry ie;
+   ScaleitemKey key, key2;
+   Eina_List *files = NULL;
+   char *path, *path2, *path3;
+
+   _disk_setup("1024");
+   _entry_init(&ie, "/tmp/evas_test_image.png");
+   _key_init(&key, 97, 61);
+   _key_init(&key2, 61, 97);
+
+   _save(&ie, &key, 7);
+   _disk_flush();
+   path = _dir_new_file_get(NULL);
+   files = eina_list_append(files, path);
+
+   /* another scale, another source, or the source changed */
+   fail_if(evas_common_scalecache_disk_load(&ie, &key2));
+   key2 = key;
+   key2.src_x = 1;
+   fail_if(evas_common_scalecache_disk_load(&ie, &key2));
+   key2 = key;
+   key2.smooth = 0;
+   fail_if(evas_common_scalecache_disk_load(&ie, &key2));
+   ie.tstamp.mtime++;
+   fail_if(evas_common_scalecache_disk_load(&ie, &key));
+   ie.tstamp.mtime--;
+   ie.cache_key = "/tmp/evas_test_image.png//@/1/0/0/0/0";
+   fail_if(evas_common_scalecache_disk_load(&ie, &key));
+   ie.cache_key = ie.file;
+   fail_if(!_load_check(&ie, &key, 7));
+
+   /* a file found under the name of another entry, as with a collision of
+    * the hashes, is not taken for it */
+   _key_init(&key2, 61, 97);
+   _save(&ie, &key2, 5);
+   _disk_flush();
+   path2 = _dir_new_file_get(files);
+   fail_if(!_load_check(&ie, &key2, 5));
+   _key_init(&key2, 97, 61);
+   key2.src_y = 3;
+   _save(&ie, &key2, 9);
+   _disk_flush();
+   files = eina_list_append(files, path2);
+
+   fail_if(rename(path, path2) < 0);
+   _key_init(&key2, 61, 97);
+   fail_if(evas_common_scalecache_disk_load(&ie, &key2));
+   fail_if(evas_common_scalecache_disk_load(&ie, &key));
+   /* even with the same size */
+   path3 = _dir_new_file_get(files);
+   fail_if(rename(path3, path) < 0);
+   free(path3);
+   fail_if(evas_common_scalecache_disk_load(&ie, &key));
+
+   EINA_LIST_FREE(files, path)
+     free(path);
+
+   _disk_teardown();
+}
+END_TEST
+
+START_TEST(evas_scalecache_disk_evict)
+{
+   Image_Entry ie;
+   ScaleitemKey key;
+   Eina_Iterator *it;
+   const Eina_File_Direct_Info *info;
+   struct utimbuf old;
+   unsigned int count, i;
+
+   /* 64KB, entries of 4KB of pixels */
+   _disk_setup("64");
+   _entry_init(&ie, "/tmp/evas_test_image.png");
+
+   for (i = 0; i < 10; i++)
+     {
+        _key_init(&key, 32, 32);
+        key.src_x = i;
+        _save(&ie, &key, i);
+        _disk_flush();
+     }
+   fail_if(_dir_size_get(&count) > 64 * 1024);
+   fail_if(count != 10);
+
+   /* all used a while ago, but the first one used again */
+   old.actime = old.modtime = time(NULL) - 1000;
+   it = eina_file_direct_ls(_dir);
+   EINA_ITERATOR_FOREACH(it, info)
+     fail_if(utime(info->path, &old) < 0);
+   eina_iterator_free(it);
+   _key_init(&key, 32, 32);
+   fail_if(!_load_check(&ie, &key, 0));
+
+   /* a single pass of eviction, the entries written now are as recent as
+    * the one used */
+   for (i = 10; i < 20; i++)
+     {
+        _key_init(&key, 32, 32);
+        key.src_x = i;
+        _save(&ie, &key, i);
+        _disk_flush();
+        fail_if(_dir_size_get(NULL) > 64 * 1024);
+     }
+
+   /* the least recently used went first */
+   _key_init(&key, 32, 32);
+   fail_if(!_load_check(&ie, &key, 0));
+   for (i = 1, count = 0; i < 10; i++)
+     {
+        key.src_x = i;
+        if (_load_check(&ie, &key, i)) count++;
+     }
+   fail_if(count == 9);
+   for (i = 10; i < 20; i++)
+     {
+        key.src_x = i;
+        fail_if(!_load_check(&ie, &key, i));
+     }
+
+   /* an entry bigger than the limit is not written at all */
+   _key_init(&key, 200, 200);
+   _save(&ie, &key, 1);
+   _disk_flush();
+   fail_if(evas_common_scalecache_disk_load(&ie, &key));
+
+   _disk_teardown();
+}
+END_TEST
+
+static void
+_canvas_setup(void)
+{
+   Evas_Engine_Info_Buffer *einfo;
+   unsigned int *data;
+   int i, j;
+
+   _evas = _setup_evas();
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(_evas);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   _dest = malloc(500 * 500 * 4);
+   einfo->info.dest_buffer = _dest;
+   einfo->info.dest_buffer_row_bytes = 500 * 4;
+   evas_engine_info_set(_evas, (Evas_Engine_Info *)einfo);
+
+   for (j = 0; j < IMAGES; j++)
+     {
+        _images[j] = evas_object_image_filled_add(_evas);
+        evas_object_image_size_set(_images[j], 200, 200);
+        data = evas_object_image_data_get(_images[j], EINA_TRUE);
+        for (i = 0; i < 200 * 200; i++)
+          data[i] = 0xff000000 | (i * (7 + j));
+        evas_object_image_data_set(_images[j], data);
+        evas_object_image_smooth_scale_set(_images[j], EINA_TRUE);
+     }
+
+   /* the first frame sets the canvas up and draws nothing */
+   evas_render(_evas);
+   evas_image_scale_cache_stats_reset();
+}
+
+static void
+_canvas_teardown(void)
+{
+   evas_free(_evas);
+   free(_dest);
+   evas_shutdown();
+   _evas = NULL;
+   _dest = NULL;
+}
+
+/* the n-th scale, drawn from one of the images */
+static void
+_frames(int n, int size, int count)
+{
+   int i;
+
+   for (i = 0; i < IMAGES; i++)
+     evas_object_hide(_images[i]);
+   evas_object_resize(_images[n / IMAGE_SCALES], size, size);
+   evas_object_show(_images[n / IMAGE_SCALES]);
+   for (i = 0; i < count; i++)
+     {
+        evas_damage_rectangle_add(_evas, 0, 0, 500, 500);
+        evas_render(_evas);
+     }
+}
+
+static Evas_Image_Scale_Cache_Stats
+_stats_get(void)
+{
+   Evas_Image_Scale_Cache_Stats stats;
+
+   fail_if(!evas_image_scale_cache_stats_get(&stats));
+   return stats;
+}
+
+START_TEST(evas_scalecache_adapt_off)
+{
+   Evas_Image_Scale_Cache_Stats stats;
+   int i;
+
+   _canvas_setup();
+   fail_if(evas_image_scale_cache_adaptive_get());
+   evas_common_rgba_image_scalecache_size_set(120 * 1024);
+
+   /* copies that don't fit are refused, nothing learnt */
+   for (i = 0; i < IMAGES * IMAGE_SCALES; i++)
+     _frames(i, 60 + (i % IMAGE_SCALES), 6);
+   stats = _stats_get();
+   fail_if(stats.min_uses != 3);
+   fail_if(stats.evictions != 0);
+   fail_if(stats.populates == 0);
+   fail_if(stats.size > stats.max_size);
+
+   _canvas_teardown();
+}
+END_TEST
+
+START_TEST(evas_scalecache_adapt_wasted)
+{
+   Evas_Image_Scale_Cache_Stats stats;
+   int i;
+
+   _canvas_setup();
+   evas_image_scale_cache_adaptive_set(EINA_TRUE);
+   evas_common_rgba_image_scalecache_size_set(120 * 1024);
+
+   /* each scale is drawn 6 times, a copy is added on the 4th draw, it is
+    * pushed out by the next scales before it is drawn 4 times */
+   for (i = 0; i < IMAGES * IMAGE_SCALES; i++)
+     _frames(i, 60 + (i % IMAGE_SCALES), 6);
+   stats = _stats_get();
+   fail_if(stats.evictions < 32);
+   fail_if(stats.min_uses <= 3);
+   fail_if(stats.size > stats.max_size);
+
+   _canvas_teardown();
+}
+END_TEST
+
+START_TEST(evas_scalecache_adapt_useful)
+{
+   Evas_Image_Scale_Cache_Stats stats;
+   int i;
+
+   _canvas_setup();
+   evas_image_scale_cache_adaptive_set(EINA_TRUE);
+
+   /* each copy is drawn more than 4 times */
+   for (i = 0; i < IMAGES * IMAGE_SCALES; i++)
+     _frames(i, 60 + (i % IMAGE_SCALES), 10);
+   stats = _stats_get();
+   fail_if(stats.min_uses >= 3);
+   fail_if(stats.hits < IMAGES * IMAGE_SCALES * 4);
+
+   /* the copies dropped by a flush are no evictions */
+   fail_if(stats.items == 0);
+   fail_if(stats.evictions != 0);
+   evas_common_rgba_image_scalecache_flush();
+   stats = _stats_get();
+   fail_if(stats.items != 0);
+   fail_if(stats.evictions != 0);
+
+   _canvas_teardown();
+}
+END_TEST
+
+START_TEST(evas_scalecache_admit_lru)
+{
+   Evas_Image_Scale_Cache_Stats stats;
+   unsigned long long hits, misses;
+
+   _canvas_setup();
+   evas_image_scale_cache_adaptive_set(EINA_TRUE);
+   /* room for two copies of 100x100 */
+   evas_common_rgba_image_scalecache_size_set(2 * 100 * 100 * 4);
+
+   _frames(0, 100, 5);
+   _frames(1, 99, 5);
+   fail_if(_stats_get().items != 2);
+   /* 100 is used again, 99 is the least recently used now */
+   _frames(0, 100, 1);
+
+   /* a new copy makes room instead of being refused */
+   _frames(2, 98, 5);
+   stats = _stats_get();
+   fail_if(stats.items != 2);
+   fail_if(stats.evictions != 1);
+   fail_if(stats.size > stats.max_size);
+
+   /* 100 is still cached, 99 has to be scaled again */
+   hits = stats.hits;
+   misses = stats.misses;
+   _frames(0, 100, 1);
+   stats = _stats_get();
+   fail_if(stats.hits != hits + 1);
+   fail_if(stats.misses != misses);
+   _frames(1, 99, 1);
+   stats = _stats_get();
+   fail_if(stats.hits != hits + 1);
+   fail_if(stats.misses != misses + 1);
+
+   /* a smaller limit drops copies, but they are no evictions */
+   evas_common_rgba_image_scalecache_size_set(100 * 100 * 4);
+   stats = _stats_get();
+   fail_if(stats.items != 1);
+   fail_if(stats.evictions != 1);
+
+   _canvas_teardown();
+}
+END_TEST
+
+void evas_test_scalecache(TCase *tc)
+{
+   tcase_add_test(tc, evas_scalecache_disk_save_load);
+   tcase_add_test(tc, evas_scalecache_disk_key_mismatch);
+   tcase_add_test(tc, evas_scalecache_disk_evict);
+   tcase_add_test(tc, evas_scalecache_adapt_off);
+   tcase_add_test(tc, evas_scalecache_adapt_wasted);
+   tcase_add_test(tc, evas_scalecache_adapt_useful);
+   tcase_add_test(tc, evas_scalecache_admit_lru);
+}
@@ -6,7 +6,10 @@
 #include <stdio.h>
 
 #include "evas_suite.h"
-#include "Evas.h"
+#include "evas_common_private.h"
+#include "evas_private.h"
+#include "evas_font_private.h"
+#include "Evas_Engine_Buffer.h"
 #include "evas_tests_helpers.h"
 
 #define TEST_FONT_NAME "DejaVuSans,UnDotum"
@@ -569,6 +572,153 @@ START_TEST(evas_text_bidi)
 END_TEST
 #endif
 
+/* The glyph atlas with a budget of a single page. The glyphs are dropped
+ * least recently drawn first, never while drawn from, and the text looks
+ * the same once they are rendered again. */
+#define GLYPH_CACHE_TEXT "The quick brown fox jumps over the lazy dog 0123456789"
+#define GLYPH_CACHE_W 500
+#define GLYPH_CACHE_H 100
+
+static Evas_Object *
+_glyph_cache_text_add(Evas *evas, const char *text, Evas_Font_Size size)
+{
+   Evas_Object *to;
+
+   to = evas_object_text_add(evas);
+   evas_object_text_font_source_set(to, TEST_FONT_SOURCE);
+   evas_object_text_font_set(to, TEST_FONT_NAME, size);
+   evas_object_text_text_set(to, text);
+   evas_object_color_set(to, 0, 0, 0, 255);
+   evas_object_move(to, 5, 5);
+   evas_object_show(to);
+   return to;
+}
+
+static Evas_Glyph_Atlas_Stats
+_glyph_cache_render(Evas *evas)
+{
+   Evas_Glyph_Atlas_Stats stats;
+
+   evas_damage_rectangle_add(evas, 0, 0, GLYPH_CACHE_W, GLYPH_CACHE_H);
+   evas_render(evas);
+   evas_common_font_glyph_atlas_stats_get(&stats);
+   return stats;
+}
+
+START_TEST(evas_text_glyph_cache)
+{
+   static const char chars[] =
+     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+   Evas_Engine_Info_Buffer *einfo;
+   Evas_Glyph_Atlas_Stats st0, st1, st2;
+   Evas_Object *bg, *to, *other, *flood[16];
+   Evas *evas;
+   DATA32 *dest, *ref;
+   int i, n, older, dropped, to_glyphs, other_glyphs;
+
+   setenv("EVAS_GLYPH_CACHE_SIZE", "64", 1);
+   evas = EVAS_TEST_INIT_EVAS();
+   evas_font_hinting_set(evas, EVAS_FONT_HINTING_AUTO);
+   evas_output_size_set(evas, GLYPH_CACHE_W, GLYPH_CACHE_H);
+   evas_output_viewport_set(evas, 0, 0, GLYPH_CACHE_W, GLYPH_CACHE_H);
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   dest = calloc(GLYPH_CACHE_W * GLYPH_CACHE_H, sizeof(DATA32));
+   ref = calloc(GLYPH_CACHE_W * GLYPH_CACHE_H, sizeof(DATA32));
+   fail_if(!dest || !ref);
+   einfo->info.dest_buffer = dest;
+   einfo->info.dest_buffer_row_bytes = GLYPH_CACHE_W * sizeof(DATA32);
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   bg = evas_object_rectangle_add(evas);
+   evas_object_resize(bg, GLYPH_CACHE_W, GLYPH_CACHE_H);
+   evas_object_show(bg);
+
+   to = _glyph_cache_text_add(evas, GLYPH_CACHE_TEXT, 24);
+   st0 = _glyph_cache_render(evas);
+   memcpy(ref, dest, GLYPH_CACHE_W * GLYPH_CACHE_H * sizeof(DATA32));
+   fail_if(st0.size != 64 * 1024);
+   fail_if(st0.stores == 0);
+
+   /* Glyph arrays pin their glyphs: drawn all at once, these go well over
+    * budget in more pages and none of them are dropped. */
+   for (i = 0; i < 16; i++)
+     flood[i] = _glyph_cache_text_add(evas, GLYPH_CACHE_TEXT, 30 + (i * 6));
+   st1 = _glyph_cache_render(evas);
+   fail_if(st1.drops != 0);
+   fail_if(st1.pages_added < 2);
+   fail_if(st1.usage <= st1.size);
+
+   for (i = 0; i < 16; i++)
+     evas_object_del(flood[i]);
+   st2 = _glyph_cache_render(evas);
+   fail_if(st2.stores != st1.stores);
+   fail_if(memcmp(dest, ref, GLYPH_CACHE_W * GLYPH_CACHE_H * sizeof(DATA32)));
+
+   /* Once released they are dropped, and the pages they were in freed, as
+    * soon as another glyph needs room. The text shown keeps its glyphs. */
+   other = _glyph_cache_text_add(evas, GLYPH_CACHE_TEXT, 13);
+   evas_object_move(other, 5, 60);
+   st1 = _glyph_cache_render(evas);
+   other_glyphs = st1.stores - st2.stores;
+   fail_if(st1.drops == 0);
+   fail_if(st1.pages_freed == 0);
+   fail_if(st1.usage > st1.size + (64 * 1024), "%i bytes held", st1.usage);
+
+   /* Both texts released, the first one shown last. */
+   evas_object_del(other);
+   st1 = _glyph_cache_render(evas);
+   evas_object_del(to);
+   st2 = _glyph_cache_render(evas);
+   to_glyphs = st2.lru - st1.lru;
+   older = st1.lru;
+   fail_if(to_glyphs != st0.stores, "%i glyphs released, %i stored",
+           to_glyphs, st0.stores);
+
+   /* Draw more glyphs, one at a time, until all those released before the
+    * text are dropped, on pages whose rows get reused. Only then do the
+    * text's own go. */
+   st1 = st2;
+   for (n = 0; ((st2.drops - st1.drops) < older) && (n < 62 * 8); n++)
+     {
+        char buf[2] = { chars[n % 62], 0 };
+
+        other = _glyph_cache_text_add(evas, buf, 25 + (n / 62));
+        _glyph_cache_render(evas);
+        evas_object_del(other);
+        st2 = _glyph_cache_render(evas);
+     }
+   dropped = st2.drops - st1.drops;
+   fail_if(dropped < older, "%i of %i dropped", dropped, older);
+   fail_if(dropped >= older + to_glyphs);
+   fail_if(st2.rows_reused == 0);
+
+   /* Its glyphs still there are the oldest now, and may be dropped for
+    * room as the others are rendered again. */
+   to = _glyph_cache_text_add(evas, GLYPH_CACHE_TEXT, 24);
+   st1 = _glyph_cache_render(evas);
+   fail_if((st1.stores - st2.stores) < dropped - older,
+           "%i rendered again, %i dropped", st1.stores - st2.stores,
+           dropped - older);
+   fail_if((st1.stores - st2.stores) > to_glyphs);
+   fail_if(memcmp(dest, ref, GLYPH_CACHE_W * GLYPH_CACHE_H * sizeof(DATA32)));
+
+   other = _glyph_cache_text_add(evas, GLYPH_CACHE_TEXT, 13);
+   evas_object_move(other, 5, 60);
+   st2 = _glyph_cache_render(evas);
+   fail_if((st2.stores - st1.stores) != other_glyphs);
+
+   evas_object_del(other);
+   evas_object_del(to);
+   evas_object_del(bg);
+   evas_free(evas);
+   evas_shutdown();
+   free(ref);
+   free(dest);
+   unsetenv("EVAS_GLYPH_CACHE_SIZE");
+}
+END_TEST
+
 void evas_test_text(TCase *tc)
 {
    tcase_add_test(tc, evas_text_simple);
@@ -582,4 +732,5 @@ void evas_test_text(TCase *tc)
 #endif
 
    tcase_add_test(tc, evas_text_unrelated);
+   tcase_add_test(tc, evas_text_glyph_cache);
 }
@@ -8,11 +8,13 @@
 #endif
 
 #include <stdio.h>
+#include <unistd.h>
 
 #include <Eina.h>
 
 #include "evas_suite.h"
 #include "Evas.h"
+#include "Evas_Engine_Buffer.h"
 
 #include "evas_tests_helpers.h"
 
@@ -2696,6 +2698,37 @@ START_TEST(evas_textblock_style)
 END_TEST
 
 /* Various setters and getters */
+/* The style pads of a paragraph that is not relaid out follow the changes
+ * of the formats it inherits. */
+START_TEST(evas_textblock_style_relayout)
+{
+   Evas_Coord l, r, t, b;
+   const Evas_Object_Textblock_Node_Format *fnode;
+   START_TB_TEST();
+   evas_object_textblock_text_markup_set(tb,
+         "<style=glow>a<ps/><font_size=20>b</font_size><ps/>c");
+   evas_object_textblock_style_insets_get(tb, &l, &r, &t, &b);
+   fail_if((l != 2) || (r != 2) || (t != 2) || (b != 2));
+
+   /* Only the last paragraph changes, the others are kept. */
+   evas_textblock_cursor_paragraph_last(cur);
+   evas_textblock_cursor_paragraph_char_last(cur);
+   evas_textblock_cursor_text_append(cur, "d");
+   evas_object_textblock_style_insets_get(tb, &l, &r, &t, &b);
+   fail_if((l != 2) || (r != 2) || (t != 2) || (b != 2));
+
+   /* The second paragraph doesn't inherit the glow anymore. */
+   fnode = evas_textblock_node_format_first_get(tb);
+   fail_if(strcmp(evas_textblock_node_format_text_get(fnode), "+ style=glow"));
+   evas_textblock_node_format_remove_pair(tb,
+         (Evas_Object_Textblock_Node_Format *) fnode);
+   evas_object_textblock_style_insets_get(tb, &l, &r, &t, &b);
+   fail_if((l != 0) || (r != 0) || (t != 0) || (b != 0));
+
+   END_TB_TEST();
+}
+END_TEST
+
 START_TEST(evas_textblock_set_get)
 {
    START_TB_TEST();
@@ -2864,6 +2897,147 @@ START_TEST(evas_textblock_size)
 }
 END_TEST
 
+static Eina_Bool
+_textblock_layout_ready_cb(void *data, Eo *obj EINA_UNUSED,
+                           const Eo_Event_Description *desc EINA_UNUSED,
+                           void *event_info EINA_UNUSED)
+{
+   int *ready = data;
+
+   (*ready)++;
+   return EO_CALLBACK_CONTINUE;
+}
+
+/* Process the evas async events until the layout of tb is done. */
+static int
+_textblock_layout_ready_wait(int *ready)
+{
+   int tries;
+
+   for (tries = 0; !*ready && (tries < 1000); tries++)
+     {
+        usleep(10000);
+        evas_async_events_process();
+     }
+   return *ready;
+}
+
+/* Compares the lines of the layout of tb, without making it wait for
+ * anything, with the lines of a synchronous layout of tb2. */
+static void
+_textblock_layouts_compare(Evas_Object *tb, Evas_Object *tb2)
+{
+   Evas_Coord x, y, w, h, x2, y2, w2, h2;
+   int i;
+
+   evas_object_textblock_size_formatted_get(tb2, &w2, &h2);
+   for (i = 0; evas_object_textblock_line_number_geometry_get(tb2, i,
+            &x2, &y2, &w2, &h2); i++)
+     {
+        fail_if(!evas_object_textblock_line_number_geometry_get(tb, i,
+                 &x, &y, &w, &h));
+        ck_assert_int_eq(x, x2);
+        ck_assert_int_eq(y, y2);
+        ck_assert_int_eq(w, w2);
+        ck_assert_int_eq(h, h2);
+     }
+   fail_if(evas_object_textblock_line_number_geometry_get(tb, i,
+            &x, &y, &w, &h));
+   fail_if(i < 500);
+
+   evas_object_textblock_size_formatted_get(tb, &w, &h);
+   evas_object_textblock_size_formatted_get(tb2, &w2, &h2);
+   ck_assert_int_eq(w, w2);
+   ck_assert_int_eq(h, h2);
+   evas_object_textblock_size_native_get(tb, &w, &h);
+   evas_object_textblock_size_native_get(tb2, &w2, &h2);
+   ck_assert_int_eq(w, w2);
+   ck_assert_int_eq(h, h2);
+}
+
+START_TEST(evas_textblock_async_layout)
+{
+   START_TB_TEST();
+   Evas_Engine_Info_Buffer *einfo;
+   Evas_Object *tb2;
+   Eina_Strbuf *buf;
+   void *pixels;
+   int ready = 0;
+   int i;
+
+   /* The layout is only started by the render. */
+   pixels = malloc(500 * 500 * 4);
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(evas);
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = pixels;
+   einfo->info.dest_buffer_row_bytes = 500 * 4;
+   evas_engine_info_set(evas, (Evas_Engine_Info *)einfo);
+
+   buf = eina_strbuf_new();
+   eina_strbuf_append(buf, "<wrap=word>");
+   for (i = 0; i < 500; i++)
+     eina_strbuf_append_printf(buf, "Paragraph number %d, long enough to "
+                               "need to be wrapped.<ps/>", i);
+
+   /* The same text laid out in the render and right away. */
+   evas_object_textblock_text_markup_set(tb, eina_strbuf_string_get(buf));
+   evas_object_resize(tb, 200, 500);
+   evas_object_show(tb);
+   fail_if(evas_object_textblock_async_layout_get(tb));
+   evas_object_textblock_async_layout_set(tb, EINA_TRUE);
+   fail_if(!evas_object_textblock_async_layout_get(tb));
+   eo_do(tb, eo_event_callback_add(EVAS_TEXTBLOCK_EVENT_LAYOUT_READY,
+                                   _textblock_layout_ready_cb, &ready));
+
+   tb2 = evas_object_textblock_add(evas);
+   evas_object_textblock_legacy_newline_set(tb2, EINA_FALSE);
+   evas_object_textblock_style_set(tb2, st);
+   evas_object_textblock_text_markup_set(tb2, eina_strbuf_string_get(buf));
+   evas_object_resize(tb2, 200, 500);
+
+   /* The visible part is drawn without waiting for the rest */
+   memset(pixels, 0, 500 * 500 * 4);
+   evas_render(evas);
+   for (i = 0; i < 200 * 500; i++)
+     {
+        if (((unsigned int *)pixels)[((i / 200) * 500) + (i % 200)]) break;
+     }
+   fail_if(i == 200 * 500);
+   fail_if(!_textblock_layout_ready_wait(&ready));
+   ck_assert_int_eq(ready, 1);
+   _textblock_layouts_compare(tb, tb2);
+
+   /* A relayout for another width. */
+   ready = 0;
+   evas_object_resize(tb, 100, 500);
+   evas_object_resize(tb2, 100, 500);
+   evas_render(evas);
+   fail_if(!_textblock_layout_ready_wait(&ready));
+   _textblock_layouts_compare(tb, tb2);
+
+   /* Editing while the layout runs waits for it, the result is the same
+    * as editing after a synchronous layout. */
+   ready = 0;
+   evas_object_resize(tb, 150, 500);
+   evas_render(evas);
+   evas_object_resize(tb2, 150, 500);
+   evas_object_textblock_size_formatted_get(tb2, NULL, NULL);
+   evas_textblock_cursor_paragraph_first(cur);
+   evas_textblock_cursor_text_prepend(cur, "Some more text");
+   evas_textblock_cursor_paragraph_first(evas_object_textblock_cursor_get(tb2));
+   evas_textblock_cursor_text_prepend(evas_object_textblock_cursor_get(tb2),
+                                      "Some more text");
+   _textblock_layouts_compare(tb, tb2);
+   evas_async_events_process();
+
+   evas_object_textblock_async_layout_set(tb, EINA_FALSE);
+   evas_object_del(tb2);
+   eina_strbuf_free(buf);
+   END_TB_TEST();
+   free(pixels);
+}
+END_TEST
+
 void evas_test_textblock(TCase *tc)
 {
    tcase_add_test(tc, evas_textblock_simple);
@@ -2874,6 +3048,7 @@ void evas_test_textblock(TCase *tc)
    tcase_add_test(tc, evas_textblock_size);
    tcase_add_test(tc, evas_textblock_editing);
    tcase_add_test(tc, evas_textblock_style);
+   tcase_add_test(tc, evas_textblock_style_relayout);
    tcase_add_test(tc, evas_textblock_evas);
    tcase_add_test(tc, evas_textblock_text_getters);
    tcase_add_test(tc, evas_textblock_formats);
@@ -2884,5 +3059,6 @@ void evas_test_textblock(TCase *tc)
    tcase_add_test(tc, evas_textblock_various);
    tcase_add_test(tc, evas_textblock_wrapping);
    tcase_add_test(tc, evas_textblock_items);
+   tcase_add_test(tc, evas_textblock_async_layout);
 }
 